@@ -0,0 +1,229 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <utility>
+#include <cassert>
+
+// 資産ハンドル
+// スロット番号と世代の組。資産が削除されてスロットが再利用されると世代が変わり、古いハンドルは無効になる
+struct AssetHandle
+{
+	uint32_t index = UINT32_MAX; // スロット番号
+	uint32_t generation = 0; // スロットの世代
+
+	bool IsValid() const { return index != UINT32_MAX; }
+	bool operator==(const AssetHandle &other) const { return index == other.index && generation == other.generation; }
+	bool operator!=(const AssetHandle &other) const { return !(*this == other); }
+};
+
+// 資産の登録簿
+// ファイルパスのハッシュ（FNV-1a）をキーにしたオープンアドレス法のテーブルで、パスからの検索をO(1)で行う
+// 資産はスロット配列に置き、AssetHandleで直接参照する（ハンドルからの取得は配列アクセスと世代の比較のみ）
+template <class T>
+class AssetRegistry
+{
+public:
+
+	/// <summary>
+	/// ファイルパスのハッシュ値を求める（FNV-1a 64bit）
+	/// </summary>
+	static uint64_t HashPath(std::string_view path)
+	{
+		uint64_t hash = 14695981039346656037ull;
+		for (char c : path) {
+			hash ^= static_cast<uint8_t>(c);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// スロット数をあらかじめ確保する（資産への参照を保持したまま登録する場合用）
+	void Reserve(size_t capacity)
+	{
+		slots.reserve(capacity);
+		size_t tableSize = kMinTableSize;
+		while (tableSize < capacity * 2) {
+			tableSize <<= 1;
+		}
+		if (tableSize > table.size()) {
+			Rehash(tableSize);
+		}
+	}
+
+	/// <summary>
+	/// パスから資産を検索する
+	/// </summary>
+	/// <returns>見つからなければ無効なハンドル</returns>
+	AssetHandle Find(std::string_view path) const
+	{
+		if (table.empty()) {
+			return {};
+		}
+		uint64_t hash = HashPath(path);
+		const size_t mask = table.size() - 1;
+		for (size_t bucket = static_cast<size_t>(hash) & mask;; bucket = (bucket + 1) & mask) {
+			uint32_t slotIndex = table[bucket];
+			if (slotIndex == kEmpty) {
+				return {};
+			}
+			if (slotIndex == kDeleted) {
+				continue;
+			}
+			const Slot &slot = slots[slotIndex];
+			if (slot.hash == hash && slot.path == path) {
+				return { slotIndex, slot.generation };
+			}
+		}
+	}
+
+	/// <summary>
+	/// 資産を登録する（同じパスが登録済みなら何もしない）
+	/// </summary>
+	/// <returns>登録した（または登録済みの）資産のハンドル</returns>
+	AssetHandle Add(const std::string &path, T asset)
+	{
+		AssetHandle existing = Find(path);
+		if (existing.IsValid()) {
+			return existing;
+		}
+
+		// 使用率が半分を超えないようにテーブルを広げる
+		// 削除済みが多いだけなら同じサイズで作り直す
+		if ((usedBuckets + 1) * 2 > table.size()) {
+			size_t tableSize = kMinTableSize;
+			while (tableSize < (count + 1) * 4) {
+				tableSize <<= 1;
+			}
+			Rehash(tableSize);
+		}
+
+		// 空きスロットがあれば再利用する
+		uint32_t slotIndex = 0;
+		if (!freeSlots.empty()) {
+			slotIndex = freeSlots.back();
+			freeSlots.pop_back();
+		} else {
+			slotIndex = static_cast<uint32_t>(slots.size());
+			slots.emplace_back();
+		}
+		Slot &slot = slots[slotIndex];
+		slot.asset = std::move(asset);
+		slot.path = path;
+		slot.hash = HashPath(path);
+		slot.occupied = true;
+
+		Insert(slot.hash, slotIndex);
+		++count;
+		return { slotIndex, slot.generation };
+	}
+
+	/// <summary>
+	/// 資産を削除する（スロットの世代を進め、古いハンドルを無効にする）
+	/// </summary>
+	/// <returns>削除できたらtrue</returns>
+	bool Remove(AssetHandle handle)
+	{
+		if (!IsAlive(handle)) {
+			return false;
+		}
+		Slot &slot = slots[handle.index];
+		const size_t mask = table.size() - 1;
+		for (size_t bucket = static_cast<size_t>(slot.hash) & mask;; bucket = (bucket + 1) & mask) {
+			if (table[bucket] == handle.index) {
+				table[bucket] = kDeleted;
+				break;
+			}
+		}
+		slot.asset = T();
+		slot.path.clear();
+		slot.occupied = false;
+		++slot.generation;
+		freeSlots.push_back(handle.index);
+		--count;
+		return true;
+	}
+
+	// ハンドルが有効か
+	bool IsAlive(AssetHandle handle) const
+	{
+		return handle.index < slots.size() && slots[handle.index].occupied && slots[handle.index].generation == handle.generation;
+	}
+
+	// ハンドルから資産を取得する（無効ならnullptr）
+	T *Get(AssetHandle handle) { return IsAlive(handle) ? &slots[handle.index].asset : nullptr; }
+	const T *Get(AssetHandle handle) const { return IsAlive(handle) ? &slots[handle.index].asset : nullptr; }
+
+	// スロット番号から資産を取得する（世代を確認しない。スロット番号を外部の配列の番号として使う場合用）
+	T &GetByIndex(uint32_t index)
+	{
+		assert(index < slots.size() && slots[index].occupied);
+		return slots[index].asset;
+	}
+
+	// 登録されている資産の数
+	size_t GetCount() const { return count; }
+
+	// スロット数（削除済みを含む）
+	size_t GetSlotCount() const { return slots.size(); }
+
+	// 登録されている資産をすべて処理する
+	template <class Function>
+	void ForEach(Function function)
+	{
+		for (Slot &slot : slots) {
+			if (slot.occupied) {
+				function(slot.asset);
+			}
+		}
+	}
+
+private:
+
+	// テーブルのバケットの状態
+	static constexpr uint32_t kEmpty = UINT32_MAX;
+	static constexpr uint32_t kDeleted = UINT32_MAX - 1;
+	static constexpr size_t kMinTableSize = 16;
+
+	struct Slot
+	{
+		T asset {};
+		std::string path; // 衝突時の確認用
+		uint64_t hash = 0;
+		uint32_t generation = 0;
+		bool occupied = false;
+	};
+
+	// テーブルにスロット番号を入れる
+	void Insert(uint64_t hash, uint32_t slotIndex)
+	{
+		const size_t mask = table.size() - 1;
+		size_t bucket = static_cast<size_t>(hash) & mask;
+		while (table[bucket] != kEmpty && table[bucket] != kDeleted) {
+			bucket = (bucket + 1) & mask;
+		}
+		if (table[bucket] == kEmpty) {
+			++usedBuckets;
+		}
+		table[bucket] = slotIndex;
+	}
+
+	// テーブルを作り直す（削除済みのバケットもここで片付く）
+	void Rehash(size_t tableSize)
+	{
+		table.assign(tableSize, kEmpty);
+		usedBuckets = 0;
+		for (uint32_t i = 0; i < slots.size(); ++i) {
+			if (slots[i].occupied) {
+				Insert(slots[i].hash, i);
+			}
+		}
+	}
+
+	std::vector<Slot> slots;
+	std::vector<uint32_t> freeSlots;
+	std::vector<uint32_t> table; // バケットごとのスロット番号（サイズは2の累乗）
+	size_t usedBuckets = 0; // 空でないバケット数（削除済みを含む）
+	size_t count = 0;
+};
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "AtlasPacker.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+// imgui_draw.cppの実装はstaticなので、こちらでも実装を持つ
+#define STBRP_STATIC
+#define STB_RECT_PACK_IMPLEMENTATION
+#include "externals/imgui/imstb_rectpack.h"
+
+bool AtlasPacker::Pack(const std::vector<Extent> &sizes, const Settings &settings)
+{
+	placements.assign(sizes.size(), Placement {});
+	pages.clear();
+	statistics = {};
+
+	// ブロック単位で詰める（ブロックの左上はミップの最後の段でも1画素の境目に来る）
+	assert(settings.mipLevels >= 1);
+	const uint32_t blockSize = 1u << (settings.mipLevels - 1);
+	// 最後の段で画像の縁をバイリニアで読んでも、隣のブロックまで帯の中に収まる幅が要る
+	assert(settings.padding * 2 >= blockSize * 3 && "AtlasPacker padding must be at least 1.5 blocks");
+	assert(settings.pageWidth % blockSize == 0 && settings.pageHeight % blockSize == 0);
+	const int blockCountX = int(settings.pageWidth / blockSize);
+	const int blockCountY = int(settings.pageHeight / blockSize);
+
+	// パディング込みの大きさをブロック数にする
+	std::vector<stbrp_rect> rects(sizes.size());
+	for (size_t i = 0; i < sizes.size(); ++i) {
+		stbrp_rect &rect = rects[i];
+		rect.id = int(i);
+		rect.w = int((sizes[i].width + settings.padding * 2 + blockSize - 1) / blockSize);
+		rect.h = int((sizes[i].height + settings.padding * 2 + blockSize - 1) / blockSize);
+		if (rect.w > blockCountX || rect.h > blockCountY) {
+			return false;
+		}
+		statistics.imageArea += uint64_t(sizes[i].width) * sizes[i].height;
+	}
+
+	// 1ページずつ詰め、入らなかった分を次のページへ回す
+	std::vector<stbrp_node> nodes(blockCountX);
+	while (!rects.empty()) {
+		stbrp_context context;
+		stbrp_init_target(&context, blockCountX, blockCountY, nodes.data(), int(nodes.size()));
+		// 一番低い所に置く方（BL）がBFより速く、詰め具合も同じかわずかに良かった
+		stbrp_setup_heuristic(&context, STBRP_HEURISTIC_Skyline_BL_sortHeight);
+		stbrp_pack_rects(&context, rects.data(), int(rects.size()));
+
+		const uint32_t page = uint32_t(pages.size());
+		Extent used { 0, 0 };
+		size_t remaining = 0;
+		for (const stbrp_rect &rect : rects) {
+			if (!rect.was_packed) {
+				rects[remaining++] = rect;
+				continue;
+			}
+			placements[rect.id] = { page, uint32_t(rect.x) * blockSize + settings.padding, uint32_t(rect.y) * blockSize + settings.padding };
+			used.width = std::max(used.width, uint32_t(rect.x + rect.w) * blockSize);
+			used.height = std::max(used.height, uint32_t(rect.y + rect.h) * blockSize);
+		}
+		// 1枚も入らなければ先に大きさで弾いているはず
+		assert(remaining < rects.size());
+		rects.resize(remaining);
+
+		pages.push_back(used);
+		statistics.pageArea += uint64_t(used.width) * used.height;
+	}
+
+	statistics.pageCount = uint32_t(pages.size());
+	statistics.occupancy = statistics.pageArea > 0 ? double(statistics.imageArea) / double(statistics.pageArea) : 0.0;
+	return true;
+}
+
+void AtlasPacker::CopyWithPadding(const uint8_t *source, size_t sourceRowPitch, const Extent &extent,
+	uint8_t *destination, size_t destinationRowPitch, const Placement &placement, uint32_t padding)
+{
+	constexpr size_t kPixelSize = 4;
+	assert(extent.width > 0 && extent.height > 0);
+	assert(placement.x >= padding && placement.y >= padding);
+
+	const int32_t height = int32_t(extent.height);
+	const int32_t pad = int32_t(padding);
+	for (int32_t row = -pad; row < height + pad; ++row) {
+		// 上下の帯は一番端の行を繰り返す
+		const uint8_t *sourceRow = source + sourceRowPitch * size_t(std::clamp(row, 0, height - 1));
+		uint8_t *destinationRow = destination + destinationRowPitch * size_t(int32_t(placement.y) + row) + kPixelSize * (placement.x - padding);
+
+		// 左右の帯は一番端の画素を繰り返す
+		for (uint32_t i = 0; i < padding; ++i, destinationRow += kPixelSize) {
+			std::memcpy(destinationRow, sourceRow, kPixelSize);
+		}
+		std::memcpy(destinationRow, sourceRow, kPixelSize * extent.width);
+		destinationRow += kPixelSize * extent.width;
+		const uint8_t *lastPixel = sourceRow + kPixelSize * (extent.width - 1);
+		for (uint32_t i = 0; i < padding; ++i, destinationRow += kPixelSize) {
+			std::memcpy(destinationRow, lastPixel, kPixelSize);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// テクスチャアトラスの配置決め
+// たくさんの小さな画像を、imstb_rectpack（スカイライン法）で決まった大きさのページに詰める。入りきらなければページを増やす
+// 画像のまわりにはパディング（縁の画素を引き伸ばした帯）を取り、配置はミップの段数に合わせたブロック単位に揃える
+// （縮小しても1つのブロックに2枚の画像が混ざらないので、ミップマップやバイリニアで隣の画像がにじまない）
+class AtlasPacker
+{
+public:
+
+	// 詰め方の設定
+	struct Settings
+	{
+		uint32_t pageWidth = 2048; // ページの最大の大きさ（ブロックの大きさの倍数）
+		uint32_t pageHeight = 2048;
+		uint32_t padding = 6; // 画像のまわりの帯の幅（ピクセル。ブロックの大きさの1.5倍以上）
+		uint32_t mipLevels = 3; // ページに作るミップの段数（ブロックは2^(mipLevels-1)ピクセル四方）
+	};
+
+	// 幅と高さ（ピクセル）
+	struct Extent
+	{
+		uint32_t width;
+		uint32_t height;
+	};
+
+	// 画像1枚の配置
+	struct Placement
+	{
+		uint32_t page; // ページ番号
+		uint32_t x; // 画像の左上（パディングの内側。ピクセル）
+		uint32_t y;
+	};
+
+	// 詰めた結果
+	struct Statistics
+	{
+		uint32_t pageCount = 0;
+		uint64_t imageArea = 0; // 画像の面積の合計（パディングを含まない）
+		uint64_t pageArea = 0; // ページの面積の合計（切り詰めた後）
+		double occupancy = 0.0; // 画像の面積 / ページの面積
+	};
+
+	/// <summary>
+	/// 画像の大きさの一覧から配置を決める
+	/// </summary>
+	/// <param name="sizes">画像の大きさ（この順番でGetPlacementsに結果が入る）</param>
+	/// <param name="settings">詰め方の設定</param>
+	/// <returns>すべて配置できたらtrue（パディング込みでページより大きい画像があるとfalse）</returns>
+	bool Pack(const std::vector<Extent> &sizes, const Settings &settings);
+
+	// 画像ごとの配置（Packに渡した順）
+	const std::vector<Placement> &GetPlacements() const { return placements; }
+	// ページごとの大きさ（使っていない右側と下側はブロック単位で切り詰める）
+	const std::vector<Extent> &GetPages() const { return pages; }
+	// 詰めた結果
+	const Statistics &GetStatistics() const { return statistics; }
+
+	/// <summary>
+	/// 画像をページへ写し、まわりのパディングに縁の画素を引き伸ばす（1画素4byte）
+	/// </summary>
+	/// <param name="source">写す画像の先頭</param>
+	/// <param name="sourceRowPitch">写す画像の1行のバイト数</param>
+	/// <param name="extent">写す画像の大きさ</param>
+	/// <param name="destination">ページの先頭</param>
+	/// <param name="destinationRowPitch">ページの1行のバイト数</param>
+	/// <param name="placement">写す位置（pageは見ない）</param>
+	/// <param name="padding">引き伸ばす帯の幅</param>
+	static void CopyWithPadding(const uint8_t *source, size_t sourceRowPitch, const Extent &extent,
+		uint8_t *destination, size_t destinationRowPitch, const Placement &placement, uint32_t padding);
+
+private:
+
+	std::vector<Placement> placements;
+	std::vector<Extent> pages;
+	Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,259 @@
+#include "BoundingVolume.h"
+#include "MathFunctions.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if MATH_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace math {
+
+	namespace {
+
+		// 行ベクトルの射影行列のcolumn列目
+		inline Vector4 Column(const Matrix4x4 &matrix, int column)
+		{
+			return { matrix.m[0][column], matrix.m[1][column], matrix.m[2][column], matrix.m[3][column] };
+		}
+
+		// a + sign * b を平面にして正規化する
+		inline Plane MakeNormalizedPlane(const Vector4 &a, const Vector4 &b, float sign)
+		{
+			Vector4 plane = { a.x + sign * b.x, a.y + sign * b.y, a.z + sign * b.z, a.w + sign * b.w };
+			float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+			float inverseLength = length > 0.0f ? 1.0f / length : 0.0f;
+			return { { plane.x * inverseLength, plane.y * inverseLength, plane.z * inverseLength }, plane.w * inverseLength };
+		}
+
+		inline float SignedDistance(const Plane &plane, float x, float y, float z)
+		{
+			return plane.normal.x * x + plane.normal.y * y + plane.normal.z * z + plane.distance;
+		}
+	}
+
+	AABB MakeEmptyAABB()
+	{
+		return { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+	}
+
+	void Expand(AABB &aabb, const Vector3 &point)
+	{
+		aabb.min = { std::min(aabb.min.x, point.x), std::min(aabb.min.y, point.y), std::min(aabb.min.z, point.z) };
+		aabb.max = { std::max(aabb.max.x, point.x), std::max(aabb.max.y, point.y), std::max(aabb.max.z, point.z) };
+	}
+
+	Vector3 GetCenter(const AABB &aabb)
+	{
+		return { (aabb.min.x + aabb.max.x) * 0.5f, (aabb.min.y + aabb.max.y) * 0.5f, (aabb.min.z + aabb.max.z) * 0.5f };
+	}
+
+	AABB Union(const AABB &a, const AABB &b)
+	{
+		return {
+			{ std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z) },
+			{ std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z) }
+		};
+	}
+
+	float GetSurfaceArea(const AABB &aabb)
+	{
+		float x = aabb.max.x - aabb.min.x;
+		float y = aabb.max.y - aabb.min.y;
+		float z = aabb.max.z - aabb.min.z;
+		return 2.0f * (x * y + y * z + z * x);
+	}
+
+	bool Overlaps(const AABB &a, const AABB &b)
+	{
+		return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+			a.min.y <= b.max.y && b.min.y <= a.max.y &&
+			a.min.z <= b.max.z && b.min.z <= a.max.z;
+	}
+
+	AABB TransformAABB(const AABB &aabb, const Matrix4x4 &matrix)
+	{
+		// 平行移動から始めて、各軸の成分の寄与を小さい方・大きい方に振り分ける（8頂点を変換しなくてよい）
+		AABB result = { { matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] }, { matrix.m[3][0], matrix.m[3][1], matrix.m[3][2] } };
+		const float minimum[3] = { aabb.min.x, aabb.min.y, aabb.min.z };
+		const float maximum[3] = { aabb.max.x, aabb.max.y, aabb.max.z };
+		float *resultMin = &result.min.x;
+		float *resultMax = &result.max.x;
+		for (int row = 0; row < 3; ++row) {
+			for (int column = 0; column < 3; ++column) {
+				float a = matrix.m[row][column] * minimum[row];
+				float b = matrix.m[row][column] * maximum[row];
+				resultMin[column] += std::min(a, b);
+				resultMax[column] += std::max(a, b);
+			}
+		}
+		return result;
+	}
+
+	Sphere TransformSphere(const Sphere &sphere, const Matrix4x4 &matrix)
+	{
+		Vector3 center = ApplyTransform(sphere.center, matrix);
+
+		// 各軸の拡大率のうち最大のもの
+		float maxScaleSquared = 0.0f;
+		for (int row = 0; row < 3; ++row) {
+			float scaleSquared = matrix.m[row][0] * matrix.m[row][0] + matrix.m[row][1] * matrix.m[row][1] + matrix.m[row][2] * matrix.m[row][2];
+			maxScaleSquared = std::max(maxScaleSquared, scaleSquared);
+		}
+		return { center, sphere.radius * std::sqrt(maxScaleSquared) };
+	}
+
+	Frustum MakeFrustum(const Matrix4x4 &viewProjection)
+	{
+		// クリップ座標 (x, y, z, w) = (p, 1) * viewProjection が -w <= x <= w, -w <= y <= w, 0 <= z <= w を満たす範囲
+		Vector4 column0 = Column(viewProjection, 0);
+		Vector4 column1 = Column(viewProjection, 1);
+		Vector4 column2 = Column(viewProjection, 2);
+		Vector4 column3 = Column(viewProjection, 3);
+
+		Frustum frustum {};
+		frustum.planes[0] = MakeNormalizedPlane(column3, column0, 1.0f); // 左   : w + x >= 0
+		frustum.planes[1] = MakeNormalizedPlane(column3, column0, -1.0f); // 右   : w - x >= 0
+		frustum.planes[2] = MakeNormalizedPlane(column3, column1, 1.0f); // 下   : w + y >= 0
+		frustum.planes[3] = MakeNormalizedPlane(column3, column1, -1.0f); // 上   : w - y >= 0
+		frustum.planes[4] = MakeNormalizedPlane(column2, column2, 0.0f); // ニア : z >= 0
+		frustum.planes[5] = MakeNormalizedPlane(column3, column2, -1.0f); // ファー : w - z >= 0
+		return frustum;
+	}
+
+	bool IsVisible(const Frustum &frustum, const Sphere &sphere)
+	{
+		for (const Plane &plane : frustum.planes) {
+			if (SignedDistance(plane, sphere.center.x, sphere.center.y, sphere.center.z) < -sphere.radius) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool IsVisible(const Frustum &frustum, const AABB &aabb)
+	{
+		for (const Plane &plane : frustum.planes) {
+			// 平面の法線方向に最も進んだ頂点が裏側なら、全体が裏側
+			float x = plane.normal.x >= 0.0f ? aabb.max.x : aabb.min.x;
+			float y = plane.normal.y >= 0.0f ? aabb.max.y : aabb.min.y;
+			float z = plane.normal.z >= 0.0f ? aabb.max.z : aabb.min.z;
+			if (SignedDistance(plane, x, y, z) < 0.0f) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool IsInside(const Frustum &frustum, const AABB &aabb)
+	{
+		for (const Plane &plane : frustum.planes) {
+			// 平面の法線と逆方向に最も進んだ頂点が表側なら、この平面については全体が表側
+			float x = plane.normal.x >= 0.0f ? aabb.min.x : aabb.max.x;
+			float y = plane.normal.y >= 0.0f ? aabb.min.y : aabb.max.y;
+			float z = plane.normal.z >= 0.0f ? aabb.min.z : aabb.max.z;
+			if (SignedDistance(plane, x, y, z) < 0.0f) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	Vector3 MakeInverseDirection(const Vector3 &direction)
+	{
+		// 0で割るとinfになり、始点が面の上にあると0*infでNaNになるので大きな有限値にする
+		auto inverse = [](float value) { return value != 0.0f ? 1.0f / value : FLT_MAX; };
+		return { inverse(direction.x), inverse(direction.y), inverse(direction.z) };
+	}
+
+	bool IntersectRay(const Ray &ray, const Vector3 &inverseDirection, const AABB &aabb, float maxDistance, float &distance)
+	{
+		// 各軸のスラブに入る距離の最大と出る距離の最小
+		float t0 = (aabb.min.x - ray.origin.x) * inverseDirection.x;
+		float t1 = (aabb.max.x - ray.origin.x) * inverseDirection.x;
+		float enter = std::min(t0, t1);
+		float exit = std::max(t0, t1);
+
+		t0 = (aabb.min.y - ray.origin.y) * inverseDirection.y;
+		t1 = (aabb.max.y - ray.origin.y) * inverseDirection.y;
+		enter = std::max(enter, std::min(t0, t1));
+		exit = std::min(exit, std::max(t0, t1));
+
+		t0 = (aabb.min.z - ray.origin.z) * inverseDirection.z;
+		t1 = (aabb.max.z - ray.origin.z) * inverseDirection.z;
+		enter = std::max(enter, std::min(t0, t1));
+		exit = std::min(exit, std::max(t0, t1));
+
+		enter = std::max(enter, 0.0f);
+		if (enter > exit || enter > maxDistance) {
+			return false;
+		}
+		distance = enter;
+		return true;
+	}
+
+	void SphereStreams::Resize(size_t count)
+	{
+		centerX.resize(count);
+		centerY.resize(count);
+		centerZ.resize(count);
+		radius.resize(count);
+	}
+
+	void SphereStreams::Set(size_t index, const Sphere &sphere)
+	{
+		centerX[index] = sphere.center.x;
+		centerY[index] = sphere.center.y;
+		centerZ[index] = sphere.center.z;
+		radius[index] = sphere.radius;
+	}
+
+	size_t CullSpheres(const Frustum &frustum, const SphereStreams &spheres, uint8_t *visible)
+	{
+		const size_t count = spheres.GetCount();
+		size_t visibleCount = 0;
+		size_t i = 0;
+
+#if MATH_USE_SSE
+		// 平面ごとに4つの球をまとめて判定する
+		__m128 planeX[6], planeY[6], planeZ[6], planeDistance[6];
+		for (int p = 0; p < 6; ++p) {
+			planeX[p] = _mm_set1_ps(frustum.planes[p].normal.x);
+			planeY[p] = _mm_set1_ps(frustum.planes[p].normal.y);
+			planeZ[p] = _mm_set1_ps(frustum.planes[p].normal.z);
+			planeDistance[p] = _mm_set1_ps(frustum.planes[p].distance);
+		}
+
+		for (; i + 4 <= count; i += 4) {
+			__m128 x = _mm_loadu_ps(&spheres.centerX[i]);
+			__m128 y = _mm_loadu_ps(&spheres.centerY[i]);
+			__m128 z = _mm_loadu_ps(&spheres.centerZ[i]);
+			__m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(&spheres.radius[i]));
+
+			// すべての平面で 距離 >= -半径 なら見える
+			__m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+			for (int p = 0; p < 6; ++p) {
+				// スカラー版と同じ順で足す
+				__m128 distance = _mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y));
+				distance = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(planeZ[p], z)), planeDistance[p]);
+				inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+			}
+
+			int mask = _mm_movemask_ps(inside);
+			for (int lane = 0; lane < 4; ++lane) {
+				visible[i + lane] = static_cast<uint8_t>((mask >> lane) & 1);
+			}
+			visibleCount += static_cast<size_t>(((mask & 1) + ((mask >> 1) & 1)) + (((mask >> 2) & 1) + ((mask >> 3) & 1)));
+		}
+#endif
+
+		// 残り（SIMDが使えないときは全部）
+		for (; i < count; ++i) {
+			Sphere sphere = { { spheres.centerX[i], spheres.centerY[i], spheres.centerZ[i] }, spheres.radius[i] };
+			visible[i] = IsVisible(frustum, sphere) ? 1 : 0;
+			visibleCount += visible[i];
+		}
+		return visibleCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MathTypes.h"
+
+namespace math
+{
+    // ===== 境界ボックス・境界球 =====
+
+    // 何も含まないAABB（Expandで広げていく）
+    AABB MakeEmptyAABB();
+
+    // 点を含むようにAABBを広げる
+    void Expand(AABB &aabb, const Vector3 &point);
+
+    // AABBの中心
+    Vector3 GetCenter(const AABB &aabb);
+
+    // 2つのAABBを囲むAABB
+    AABB Union(const AABB &a, const AABB &b);
+
+    // AABBの表面積（SAHのコスト計算用）
+    float GetSurfaceArea(const AABB &aabb);
+
+    // 2つのAABBが重なっているか（接しているだけでも重なりとする）
+    bool Overlaps(const AABB &a, const AABB &b);
+
+    // ワールド行列で変換したAABBを囲むAABB
+    AABB TransformAABB(const AABB &aabb, const Matrix4x4 &matrix);
+
+    // ワールド行列で変換した球を囲む球（半径は最大の拡大率で広げる）
+    Sphere TransformSphere(const Sphere &sphere, const Matrix4x4 &matrix);
+
+    // ===== 視錐台 =====
+
+    /// <summary>
+    /// ビュー射影行列から視錐台の平面を取り出す（行ベクトル・深度0～1の射影）
+    /// </summary>
+    /// <param name="viewProjection">ビュー行列×射影行列</param>
+    /// <returns>法線を正規化した6枚の平面</returns>
+    Frustum MakeFrustum(const Matrix4x4 &viewProjection);
+
+    // 球が視錐台に少しでも入っているか（入っていなくてもtrueになることがある）
+    bool IsVisible(const Frustum &frustum, const Sphere &sphere);
+
+    // AABBが視錐台に少しでも入っているか（入っていなくてもtrueになることがある）
+    bool IsVisible(const Frustum &frustum, const AABB &aabb);
+
+    // AABBが視錐台に完全に入っているか
+    bool IsInside(const Frustum &frustum, const AABB &aabb);
+
+    // ===== レイ =====
+
+    // レイの方向の逆数（0の成分は大きな値にする。同じレイで何度も判定するときに使い回す）
+    Vector3 MakeInverseDirection(const Vector3 &direction);
+
+    /// <summary>
+    /// レイとAABBの交差判定（スラブ法）
+    /// </summary>
+    /// <param name="ray">レイ</param>
+    /// <param name="inverseDirection">MakeInverseDirection(ray.direction)</param>
+    /// <param name="aabb">AABB</param>
+    /// <param name="maxDistance">判定するレイの長さ（directionの長さ単位）</param>
+    /// <param name="distance">入った位置までの距離（始点が中なら0）</param>
+    /// <returns>0～maxDistanceの間で交差したらtrue</returns>
+    bool IntersectRay(const Ray &ray, const Vector3 &inverseDirection, const AABB &aabb, float maxDistance, float &distance);
+
+    // 大量の境界球を成分ごとの配列（SoA）で持つ。4つずつSIMDで視錐台と判定する
+    struct SphereStreams
+    {
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        std::vector<float> centerZ;
+        std::vector<float> radius;
+
+        // 球の数
+        size_t GetCount() const { return radius.size(); }
+
+        // 球の数を変える
+        void Resize(size_t count);
+
+        // 1つ分の書き込み
+        void Set(size_t index, const Sphere &sphere);
+    };
+
+    /// <summary>
+    /// 境界球をまとめて視錐台と判定する（IsVisible(frustum, sphere)と同じ結果）
+    /// </summary>
+    /// <param name="frustum">視錐台</param>
+    /// <param name="spheres">境界球</param>
+    /// <param name="visible">判定結果の書き込み先（球の数分。見えるなら1、見えないなら0）</param>
+    /// <returns>見える球の数</returns>
+    size_t CullSpheres(const Frustum &frustum, const SphereStreams &spheres, uint8_t *visible);
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "Camera.h"
+
+using namespace math;
+
+Camera::Camera(float screenWidth, float screenHeight)
+{
+	transform = {
+		{1.0f, 1.0f, 1.0f},   // scale
+		{0.3f, 0.0f, 0.0f},   // rotate
+		{0.0f, 4.0f, -10.0f}  // translate
+	};
+
+	this->screenWidth = screenWidth;
+	this->screenHeight = screenHeight;
+	aspectRatio = screenWidth / screenHeight;
+	orthographicWidth = screenWidth;
+	orthographicHeight = screenHeight;
+
+	Update();
+}
+
+void Camera::Update()
+{
+	if (!viewDirty && !projectionDirty) {
+		return;
+	}
+
+	// ===== ビュー行列 =====
+	if (viewDirty) {
+		worldMatrix = MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, transform.rotate, transform.translate);
+		viewMatrix = Inverse(worldMatrix);
+	}
+
+	// ===== 射影行列 =====
+	if (projectionDirty) {
+		if (projectionType == ProjectionType::kPerspective) {
+			projectionMatrix = MakePerspectiveFovMatrix(fovY, aspectRatio, nearClip, farClip);
+		} else {
+			float halfWidth = orthographicWidth * 0.5f;
+			float halfHeight = orthographicHeight * 0.5f;
+			projectionMatrix = MakeOrthographicMatrix(-halfWidth, halfHeight, halfWidth, -halfHeight, nearClip, farClip);
+		}
+	}
+
+	viewProjectionMatrix = viewMatrix * projectionMatrix;
+
+	viewDirty = false;
+	projectionDirty = false;
+	++version;
+}
+
+Camera::ViewData Camera::GetViewData() const
+{
+	ViewData viewData {};
+	viewData.view = viewMatrix;
+	viewData.projection = projectionMatrix;
+	viewData.viewProjection = viewProjectionMatrix;
+	viewData.worldPosition = transform.translate;
+	return viewData;
+}
+
+Ray Camera::ScreenPointToRay(const Vector2 &screenPosition) const
+{
+	// ピクセル座標 → 正規化デバイス座標（yは上向き）
+	float ndcX = screenPosition.x / screenWidth * 2.0f - 1.0f;
+	float ndcY = 1.0f - screenPosition.y / screenHeight * 2.0f;
+
+	// ニア面(z=0)とファー面(z=1)の点をワールド座標に戻す（正射影でも同じ式でよい）
+	Matrix4x4 inverseViewProjection = Inverse(viewProjectionMatrix);
+	Vector3 nearPoint = ApplyTransform({ ndcX, ndcY, 0.0f }, inverseViewProjection);
+	Vector3 farPoint = ApplyTransform({ ndcX, ndcY, 1.0f }, inverseViewProjection);
+
+	Ray ray;
+	ray.origin = nearPoint;
+	ray.direction = Normalize({ farPoint.x - nearPoint.x, farPoint.y - nearPoint.y, farPoint.z - nearPoint.z });
+	return ray;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+#include <cstdint>
+#include "MathFunctions.h"
+
+// カメラ
+// ビュー行列・射影行列・ビュー射影行列を持ち、値が変わったときだけ作り直す
+// Object3dCommonに登録すると、全Object3dで共有されフレームに1回だけGPUへ送られる
+class Camera
+{
+public:
+
+	// 射影の種類
+	enum class ProjectionType
+	{
+		kPerspective, // 透視投影
+		kOrthographic, // 正射影
+	};
+
+	// GPU用のビュー（カメラ）データ
+	struct ViewData
+	{
+		math::Matrix4x4 view;
+		math::Matrix4x4 projection;
+		math::Matrix4x4 viewProjection;
+		math::Vector3 worldPosition;
+		float padding;
+	};
+
+	/// <summary>
+	/// 初期化（画面のアスペクト比の透視投影。正射影で映す範囲も画面の大きさにする）
+	/// </summary>
+	/// <param name="screenWidth">画面（クライアント領域）の幅（ピクセル）</param>
+	/// <param name="screenHeight">画面（クライアント領域）の高さ（ピクセル）</param>
+	Camera(float screenWidth, float screenHeight);
+
+	// 更新（変更があった行列だけ作り直す）
+	void Update();
+
+	// ===== setter =====
+	void SetRotate(const math::Vector3 &rotate) { transform.rotate = rotate; viewDirty = true; }
+	void SetTranslate(const math::Vector3 &translate) { transform.translate = translate; viewDirty = true; }
+
+	void SetProjectionType(ProjectionType projectionType) { this->projectionType = projectionType; projectionDirty = true; }
+	void SetFovY(float fovY) { this->fovY = fovY; projectionDirty = true; }
+	void SetAspectRatio(float aspectRatio) { this->aspectRatio = aspectRatio; projectionDirty = true; }
+	void SetNearClip(float nearClip) { this->nearClip = nearClip; projectionDirty = true; }
+	void SetFarClip(float farClip) { this->farClip = farClip; projectionDirty = true; }
+	// 画面の大きさ（ScreenPointToRayでピクセル座標を変換するのに使う。アスペクト比は変えない）
+	void SetScreenSize(float width, float height) { screenWidth = width; screenHeight = height; }
+	// 正射影で映す範囲の幅と高さ（カメラ中心）
+	void SetOrthographicSize(float width, float height) { orthographicWidth = width; orthographicHeight = height; projectionDirty = true; }
+
+	// ===== getter =====
+	const math::Vector3 &GetRotate() const { return transform.rotate; }
+	const math::Vector3 &GetTranslate() const { return transform.translate; }
+	ProjectionType GetProjectionType() const { return projectionType; }
+	float GetFovY() const { return fovY; }
+	float GetAspectRatio() const { return aspectRatio; }
+	float GetNearClip() const { return nearClip; }
+	float GetFarClip() const { return farClip; }
+
+	// 行列（Updateの後に最新になる）
+	const math::Matrix4x4 &GetWorldMatrix() const { return worldMatrix; }
+	const math::Matrix4x4 &GetViewMatrix() const { return viewMatrix; }
+	const math::Matrix4x4 &GetProjectionMatrix() const { return projectionMatrix; }
+	const math::Matrix4x4 &GetViewProjectionMatrix() const { return viewProjectionMatrix; }
+
+	// 行列が作り直されるたびに増える番号（GPUへの再転送の判定用）
+	uint32_t GetVersion() const { return version; }
+
+	// GPU用のビューデータを作る
+	ViewData GetViewData() const;
+
+	/// <summary>
+	/// 画面上の点から奥へ向かうレイを作る（ピッキング用。Updateの後の行列を使う）
+	/// </summary>
+	/// <param name="screenPosition">クライアント領域の座標（左上が原点、ピクセル単位）</param>
+	/// <returns>ニアクリップ面の点から奥へ向かう、方向を正規化したレイ</returns>
+	math::Ray ScreenPointToRay(const math::Vector2 &screenPosition) const;
+
+private:
+
+	// カメラのTransform（scaleは使わない）
+	math::Transform transform;
+
+	// 射影
+	ProjectionType projectionType = ProjectionType::kPerspective;
+	float fovY = 0.45f;
+	float aspectRatio = 1.0f;
+	float nearClip = 0.1f;
+	float farClip = 100.0f;
+	float orthographicWidth = 0.0f;
+	float orthographicHeight = 0.0f;
+
+	// 画面の大きさ
+	float screenWidth = 1.0f;
+	float screenHeight = 1.0f;
+
+	// 行列
+	math::Matrix4x4 worldMatrix;
+	math::Matrix4x4 viewMatrix;
+	math::Matrix4x4 projectionMatrix;
+	math::Matrix4x4 viewProjectionMatrix;
+
+	// 作り直しが必要か
+	bool viewDirty = true;
+	bool projectionDirty = true;
+
+	uint32_t version = 0;
+};
\ No newline at end of file
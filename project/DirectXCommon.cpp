@@ -1,5 +1,7 @@
 #include "DirectXCommon.h"
 #include <cassert>
+#include <cstring>
+#include <format>
 #include <thread>
 
 #pragma comment(lib, "d3d12.lib")
@@ -13,13 +15,16 @@ extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg
 #endif
 
 #include "StringUtility.h"
+#include "Logger.h"
 
 using namespace StringUtility;
 using namespace Microsoft::WRL;
 
 const uint32_t DirectXCommon::kMaxSRVCount = 512;
+// 256byteの定数バッファで262144個分（100万個のパーティクルのインスタンス20MBと、SpriteBatchの10万枚分の頂点6.4MBも入る）
+const size_t DirectXCommon::kUploadRingSize = 64 * 1024 * 1024;
 
-void DirectXCommon::Initialize(WinApp *winApp)
+void DirectXCommon::Initialize(WinApp *winApp, uint32_t frameLatency)
 {
 	// FPS固定初期化
 	InitializeFixFPS();
@@ -38,6 +43,10 @@ void DirectXCommon::Initialize(WinApp *winApp)
 	InitializeRenderTargetView();
 	InitializeDepthStencilView();
 	CreateFence();
+	CreateUploadRing();
+	// 最初のフレームを開始（コマンドリストはコンテキスト0のアロケータで開いた状態）
+	frameScheduler.Initialize(frameLatency);
+	frameScheduler.BeginFrame(frameFence);
 	InitializeViewport();
 	InitializeScissorRect();
 	InitializeDXC();
@@ -171,11 +180,14 @@ void DirectXCommon::InitializeCommand()
 	* CommandListを生成する
 	**************************************************/
 
-	hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator));
-	// コマンドアロケータの生成がうまくいかなかったので起動できない
-	assert(SUCCEEDED(hr));
+	// フレームコンテキストごとにコマンドアロケータを作る
+	for (ComPtr<ID3D12CommandAllocator> &commandAllocator : commandAllocators) {
+		hr = device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT, IID_PPV_ARGS(&commandAllocator));
+		// コマンドアロケータの生成がうまくいかなかったので起動できない
+		assert(SUCCEEDED(hr));
+	}
 
-	hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocator.Get(), nullptr, IID_PPV_ARGS(&commandList));
+	hr = device->CreateCommandList(0, D3D12_COMMAND_LIST_TYPE_DIRECT, commandAllocators[0].Get(), nullptr, IID_PPV_ARGS(&commandList));
 	// コマンドリストの生成がうまくいかなかったので起動できない
 	assert(SUCCEEDED(hr));
 }
@@ -343,12 +355,17 @@ void DirectXCommon::CreateFence()
 {
 	HRESULT hr;
 
-	hr = device->CreateFence(fenceValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
+	hr = device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence));
 	assert(SUCCEEDED(hr));
 
 	// FenceのSignalを持つためのイベントを作成する
 	fenceEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
 	assert(fenceEvent != nullptr);
+
+	// FrameSchedulerから使えるようにする
+	frameFence.commandQueue = commandQueue.Get();
+	frameFence.fence = fence.Get();
+	frameFence.fenceEvent = fenceEvent;
 }
 
 void DirectXCommon::InitializeViewport()
@@ -393,8 +410,9 @@ void DirectXCommon::InitializeImGui()
 	ImGui::CreateContext();
 	ImGui::StyleColorsDark();
 	ImGui_ImplWin32_Init(winApp->GetHwnd());
+	// ImGuiの頂点バッファもフレームをまたいで使われるので、同時に処理する最大フレーム数分用意させる
 	ImGui_ImplDX12_Init(device.Get(),
-		swapChainDesc.BufferCount,
+		kMaxFramesInFlight,
 		rtvDesc.Format,
 		srvDescriptorHeap.Get(),
 		srvDescriptorHeap->GetCPUDescriptorHandleForHeapStart(),
@@ -485,33 +503,75 @@ void DirectXCommon::PostDraw()
 
 	//----GPUにSignalを送る----
 
-	// Fenceの値を更新
-	fenceValue++;
-	// GPUがここまでたどり着いたときに、Fenceの値を指定した値に代入するようにSignalを送る
-	commandQueue->Signal(fence.Get(), fenceValue);
+	// GPUがここまでたどり着いたときに、Fenceの値がこのフレームの値になるようにSignalを送る
+	uint64_t frameFenceValue = frameScheduler.EndFrame(frameFence);
+	// このフレームで使ったアップロード領域は、GPUがこのフェンス値に到達するまで使わない
+	uploadRing.FinishFrame(frameFenceValue);
+
+	// FPS固定
+	UpdateFixFPS();
 
 	//----待機処理----
 
-	// Fenceの値が指定したSignal値にたどり着いているか確認する
-	// GetCompletedValueの初期値はFence作成時に渡した初期値
-	if (fence->GetCompletedValue() < fenceValue)
-	{
-		// 指定したSignalにたどりついていないので、たどり着くまで待つようにイベントを設定する
-		fence->SetEventOnCompletion(fenceValue, fenceEvent);
-		// イベント待つ
-		WaitForSingleObject(fenceEvent, INFINITE);
-	}
+	// 次のフレームで使うコンテキストを前に使ったフレームが終わるまでだけ待つ
+	// （直前のフレームはGPUで処理中のままCPUは次のフレームの記録に進む）
+	uint32_t frameIndex = frameScheduler.BeginFrame(frameFence);
 
-	// FPS固定
-	UpdateFixFPS();
+	// GPUが使い終わったアップロード領域とリソースを解放
+	uint64_t completedFenceValue = fence->GetCompletedValue();
+	uploadRing.Retire(completedFenceValue);
+	ReleaseCompletedResources(completedFenceValue);
 
 	// 次のフレーム用のコマンドリストを準備
-	hr = commandAllocator->Reset();
+	hr = commandAllocators[frameIndex]->Reset();
 	assert(SUCCEEDED(hr));
-	hr = commandList->Reset(commandAllocator.Get(), nullptr);
+	hr = commandList->Reset(commandAllocators[frameIndex].Get(), nullptr);
 	assert(SUCCEEDED(hr));
 }
 
+void DirectXCommon::WaitForGPU()
+{
+	frameScheduler.WaitForIdle(frameFence);
+
+	uint64_t completedFenceValue = fence->GetCompletedValue();
+	uploadRing.Retire(completedFenceValue);
+	ReleaseCompletedResources(completedFenceValue);
+}
+
+void DirectXCommon::DeferRelease(ComPtr<ID3D12Resource> resource)
+{
+	if (!resource) {
+		return;
+	}
+	// 今記録しているコマンドが使っているかもしれないので、このフレームが終わるまで保持する
+	deferredReleases.push_back({ std::move(resource), frameScheduler.GetCurrentFrameFenceValue() });
+}
+
+void DirectXCommon::ReleaseCompletedResources(uint64_t completedFenceValue)
+{
+	std::erase_if(deferredReleases, [completedFenceValue](const DeferredRelease &deferredRelease) {
+		return deferredRelease.fenceValue <= completedFenceValue;
+		});
+}
+
+void DirectXCommon::D3D12FrameFence::Signal(uint64_t value)
+{
+	commandQueue->Signal(fence, value);
+}
+
+uint64_t DirectXCommon::D3D12FrameFence::GetCompletedValue()
+{
+	return fence->GetCompletedValue();
+}
+
+void DirectXCommon::D3D12FrameFence::Wait(uint64_t value)
+{
+	// 指定したSignalにたどりついていないので、たどり着くまで待つようにイベントを設定する
+	fence->SetEventOnCompletion(value, fenceEvent);
+	// イベント待つ
+	WaitForSingleObject(fenceEvent, INFINITE);
+}
+
 Microsoft::WRL::ComPtr<IDxcBlob> DirectXCommon::CompileShader(const std::wstring &filePath, const wchar_t *profile)
 {
 	//----hlslファイルを読み込む----
@@ -604,6 +664,58 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateBufferResource(size_
 	return vertexResource;
 }
 
+void DirectXCommon::CreateUploadRing()
+{
+	// 大きなアップロードバッファを1つ作り、Mapしたままにする
+	uploadRingResource = CreateBufferResource(kUploadRingSize);
+	uploadRingResource->Map(0, nullptr, reinterpret_cast<void **>(&uploadRingCPUAddress));
+	uploadRingGPUAddress = uploadRingResource->GetGPUVirtualAddress();
+
+	uploadRing.Reset(kUploadRingSize);
+}
+
+DirectXCommon::UploadAllocation DirectXCommon::AllocateUpload(size_t sizeInBytes, size_t alignment)
+{
+	size_t offset = RingAllocator::kInvalidOffset;
+	// リングバッファより大きいものは待っても入らない
+	if (sizeInBytes + alignment <= kUploadRingSize) {
+		offset = uploadRing.Allocate(sizeInBytes, alignment);
+		if (offset == RingAllocator::kInvalidOffset) {
+			// 空きがなければ、処理中の前のフレームが終わるのを待って解放し、もう一度試す
+			frameScheduler.WaitForIdle(frameFence);
+			uploadRing.Retire(fence->GetCompletedValue());
+			offset = uploadRing.Allocate(sizeInBytes, alignment);
+		}
+	}
+
+	UploadAllocation allocation {};
+	if (offset != RingAllocator::kInvalidOffset) {
+		allocation.cpuAddress = uploadRingCPUAddress + offset;
+		allocation.gpuAddress = uploadRingGPUAddress + offset;
+		allocation.resource = uploadRingResource.Get();
+		allocation.offset = offset;
+		return allocation;
+	}
+
+	// 1フレームでリングバッファを使い切った: このフレームだけのアップロードバッファを別に作り、GPUが使い終わったら解放する
+	// （バッファの先頭は64KB境界なので、アライメントはそのまま満たす）
+	Logger::Log(std::format("DirectXCommon: upload ring ({} bytes) exhausted, allocating a dedicated {} byte upload buffer\n",
+		kUploadRingSize, sizeInBytes));
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource = CreateBufferResource(sizeInBytes);
+	uint8_t *cpuAddress = nullptr;
+	if (!resource || FAILED(resource->Map(0, nullptr, reinterpret_cast<void **>(&cpuAddress))) || !cpuAddress) {
+		// 作れなければ書き込み先を返さない（呼び出し側で確かめる）
+		Logger::Log(std::format("DirectXCommon: failed to create a {} byte upload buffer\n", sizeInBytes));
+		return allocation;
+	}
+	allocation.cpuAddress = cpuAddress;
+	allocation.gpuAddress = resource->GetGPUVirtualAddress();
+	allocation.resource = resource.Get();
+	allocation.offset = 0;
+	DeferRelease(std::move(resource));
+	return allocation;
+}
+
 Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::CreateTextureResource(const DirectX::TexMetadata &metadata)
 {
 	// metadataを基にResourceの設定
@@ -652,6 +764,51 @@ Microsoft::WRL::ComPtr<ID3D12Resource> DirectXCommon::UploadTextureData(const Mi
 	return intermediateResource;
 }
 
+void DirectXCommon::UploadTextureRegion(ID3D12Resource *texture, const uint8_t *pixels, size_t rowPitch,
+	uint32_t left, uint32_t top, uint32_t width, uint32_t height, DXGI_FORMAT format, uint32_t bytesPerPixel)
+{
+	// コピー元の1行は256byte境界に揃える
+	const uint32_t alignedRowPitch = (width * bytesPerPixel + D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1) & ~(D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - 1);
+	UploadAllocation allocation = AllocateUpload(size_t(alignedRowPitch) * height, D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+	if (!allocation.cpuAddress) {
+		return;
+	}
+	uint8_t *destination = static_cast<uint8_t *>(allocation.cpuAddress);
+	for (uint32_t row = 0; row < height; ++row) {
+		std::memcpy(destination + size_t(alignedRowPitch) * row, pixels + rowPitch * row, size_t(width) * bytesPerPixel);
+	}
+
+	// 割り当てた領域（ふつうはリングバッファの中）をコピー元にする
+	D3D12_TEXTURE_COPY_LOCATION source {};
+	source.pResource = allocation.resource;
+	source.Type = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT;
+	source.PlacedFootprint.Offset = allocation.offset;
+	source.PlacedFootprint.Footprint.Format = format;
+	source.PlacedFootprint.Footprint.Width = width;
+	source.PlacedFootprint.Footprint.Height = height;
+	source.PlacedFootprint.Footprint.Depth = 1;
+	source.PlacedFootprint.Footprint.RowPitch = alignedRowPitch;
+
+	D3D12_TEXTURE_COPY_LOCATION destinationLocation {};
+	destinationLocation.pResource = texture;
+	destinationLocation.Type = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX;
+	destinationLocation.SubresourceIndex = 0;
+
+	D3D12_RESOURCE_BARRIER copyBarrier {};
+	copyBarrier.Type = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION;
+	copyBarrier.Transition.pResource = texture;
+	copyBarrier.Transition.Subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES;
+	copyBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_GENERIC_READ;
+	copyBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_COPY_DEST;
+	commandList->ResourceBarrier(1, &copyBarrier);
+
+	commandList->CopyTextureRegion(&destinationLocation, left, top, 0, &source, nullptr);
+
+	copyBarrier.Transition.StateBefore = D3D12_RESOURCE_STATE_COPY_DEST;
+	copyBarrier.Transition.StateAfter = D3D12_RESOURCE_STATE_GENERIC_READ;
+	commandList->ResourceBarrier(1, &copyBarrier);
+}
+
 D3D12_CPU_DESCRIPTOR_HANDLE DirectXCommon::GetCPUDescriptorHandle(const Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> &descriptorHeap, uint32_t descriptorSize, uint32_t index)
 {
 	D3D12_CPU_DESCRIPTOR_HANDLE handleCPU = descriptorHeap->GetCPUDescriptorHandleForHeapStart();
@@ -6,7 +6,11 @@
 #include <dxcapi.h>
 #include <string>
 #include <chrono>
+#include <cstring>
+#include <vector>
 #include "WinApp.h"
+#include "RingAllocator.h"
+#include "FrameScheduler.h"
 
 #include "externals/DirectXTex/DirectXTex.h"
 #include "externals/DirectXTex/d3dx12.h"
@@ -15,8 +19,12 @@
 class DirectXCommon
 {
 public: // メンバ関数
-	// 初期化
-	void Initialize(WinApp *winApp);
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="winApp">WindowsAPI</param>
+	/// <param name="frameLatency">同時に処理するフレーム数（1～kMaxFramesInFlight）</param>
+	void Initialize(WinApp *winApp, uint32_t frameLatency = kDefaultFrameLatency);
 
 	// デバイスの初期化
 	void InitializeDevice();
@@ -89,14 +97,28 @@ public: // メンバ関数
 	// ImGuiの初期化
 	void InitializeImGui();
 
+	// フレームごとのアップロード用リングバッファの生成
+	void CreateUploadRing();
+
 	// 描画前処理
 	void PreDraw();
 	// 描画後処理
 	void PostDraw();
 
+	// GPUがすべてのコマンドを処理し終わるまで待つ（リソースの解放前に呼ぶ）
+	void WaitForGPU();
+
+	/// <summary>
+	/// リソースをGPUが使い終わってから解放する（今記録しているコマンドが終わるまで保持する）
+	/// </summary>
+	void DeferRelease(Microsoft::WRL::ComPtr<ID3D12Resource> resource);
+
 	// getter
 	ID3D12Device *GetDevice() const { return device.Get(); }
 	ID3D12GraphicsCommandList *GetCommandList() const { return commandList.Get(); }
+	uint32_t GetFrameLatency() const { return frameScheduler.GetFrameLatency(); }
+	// 前のフレームのCPUの記録時間と、GPUを待った時間
+	const FrameScheduler::Timings &GetFrameTimings() const { return frameScheduler.GetTimings(); }
 
 	// シェーダーのコンパイル
 	Microsoft::WRL::ComPtr<IDxcBlob> CompileShader(const std::wstring &filePath, const wchar_t *profile);
@@ -116,8 +138,63 @@ public: // メンバ関数
 	/// </summary>
 	[[nodiscard]] Microsoft::WRL::ComPtr<ID3D12Resource> UploadTextureData(const Microsoft::WRL::ComPtr<ID3D12Resource> &texture, const DirectX::ScratchImage &mipImages);
 
+	/// <summary>
+	/// テクスチャの一部を書き換える（このフレームのアップロード領域を経由してコピーする。ミップ0のみ）
+	/// テクスチャは普段GENERIC_READで、コピーの間だけCOPY_DESTにする
+	/// </summary>
+	/// <param name="texture">書き換えるテクスチャ</param>
+	/// <param name="pixels">書き込む範囲の左上の画素</param>
+	/// <param name="rowPitch">pixelsの1行のバイト数</param>
+	/// <param name="left">書き込む範囲の左端（ピクセル）</param>
+	/// <param name="top">書き込む範囲の上端（ピクセル）</param>
+	/// <param name="width">書き込む範囲の幅（ピクセル）</param>
+	/// <param name="height">書き込む範囲の高さ（ピクセル）</param>
+	/// <param name="format">テクスチャの形式</param>
+	/// <param name="bytesPerPixel">1画素のバイト数</param>
+	void UploadTextureRegion(ID3D12Resource *texture, const uint8_t *pixels, size_t rowPitch,
+		uint32_t left, uint32_t top, uint32_t width, uint32_t height, DXGI_FORMAT format, uint32_t bytesPerPixel);
+
+	// アップロード用リングバッファから割り当てた領域
+	struct UploadAllocation
+	{
+		void *cpuAddress; // 書き込み先（割り当てられなければnullptr）
+		D3D12_GPU_VIRTUAL_ADDRESS gpuAddress; // ルートパラメータに渡すアドレス
+		ID3D12Resource *resource; // 領域を持つバッファ（コピー元にするとき用）
+		uint64_t offset; // resourceの先頭からの位置
+	};
+
+	/// <summary>
+	/// このフレームで使う一時的なアップロード領域を割り当てる（GPUが使い終わるまで上書きされない）
+	/// リングバッファに入らなければ、このフレームだけのアップロードバッファを別に作る
+	/// </summary>
+	/// <param name="sizeInBytes">サイズ（byte）</param>
+	/// <param name="alignment">アライメント（定数バッファは256byte）</param>
+	/// <returns>割り当てた領域（バッファを作れなかったときはcpuAddressがnullptr）</returns>
+	UploadAllocation AllocateUpload(size_t sizeInBytes, size_t alignment = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+
+	/// <summary>
+	/// 定数バッファのデータをこのフレーム用の領域にコピーする
+	/// </summary>
+	/// <returns>SetGraphicsRootConstantBufferViewに渡すアドレス</returns>
+	template <class T>
+	D3D12_GPU_VIRTUAL_ADDRESS UploadConstantBuffer(const T &data)
+	{
+		UploadAllocation allocation = AllocateUpload(sizeof(T));
+		if (!allocation.cpuAddress) {
+			return 0;
+		}
+		std::memcpy(allocation.cpuAddress, &data, sizeof(T));
+		return allocation.gpuAddress;
+	}
+
 	// 最大SRV数（最大テクスチャ枚数)
 	static const uint32_t kMaxSRVCount;
+	// アップロード用リングバッファのサイズ
+	static const size_t kUploadRingSize;
+	// 同時に処理できる最大のフレーム数
+	static const uint32_t kMaxFramesInFlight = FrameScheduler::kMaxFrameLatency;
+	// 同時に処理するフレーム数の既定値
+	static const uint32_t kDefaultFrameLatency = 2;
 
 private:
 	// DirectX12デバイス
@@ -126,8 +203,8 @@ private:
 	Microsoft::WRL::ComPtr<IDXGIFactory7> dxgiFactory = nullptr;
 	// コマンドキューを生成する
 	Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue = nullptr;
-	// コマンドアロケータを生成する
-	Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator = nullptr;
+	// コマンドアロケータを生成する（フレームコンテキストごとに1つ。GPUが使い終わるまでResetできないため）
+	std::array<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>, kMaxFramesInFlight> commandAllocators;
 	// コマンドリストを生成する
 	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> commandList = nullptr;
 	// スワップチェーンを生成する
@@ -163,9 +240,33 @@ private:
 
 	// 初期値0でFenceを作る
 	Microsoft::WRL::ComPtr<ID3D12Fence> fence = nullptr;
-	// フェンス値
-	uint64_t fenceValue = 0;
 	HANDLE fenceEvent;
+
+	// ID3D12FenceをFrameSchedulerから使うためのラッパー
+	class D3D12FrameFence : public FrameFence
+	{
+	public:
+		void Signal(uint64_t value) override;
+		uint64_t GetCompletedValue() override;
+		void Wait(uint64_t value) override;
+
+		ID3D12CommandQueue *commandQueue = nullptr;
+		ID3D12Fence *fence = nullptr;
+		HANDLE fenceEvent = nullptr;
+	};
+	D3D12FrameFence frameFence;
+	// フレームコンテキストの切り替えと待機
+	FrameScheduler frameScheduler;
+
+	// GPUが使い終わるのを待っているリソース
+	struct DeferredRelease
+	{
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+		uint64_t fenceValue; // このフェンス値に到達したら解放する
+	};
+	std::vector<DeferredRelease> deferredReleases;
+	// GPUが到達したフェンス値までの解放待ちリソースを解放する
+	void ReleaseCompletedResources(uint64_t completedFenceValue);
 	// ビューポート
 	D3D12_VIEWPORT viewport {};
 	// シザー矩形
@@ -178,6 +279,14 @@ private:
 	// TransitionBarrierの設定
 	D3D12_RESOURCE_BARRIER barrier {};
 
+	// ===== アップロード用リングバッファ =====
+	// 定数バッファなどの毎フレーム書き換える小さなデータをまとめて置く（Mapしたまま使う）
+	Microsoft::WRL::ComPtr<ID3D12Resource> uploadRingResource = nullptr;
+	uint8_t *uploadRingCPUAddress = nullptr;
+	D3D12_GPU_VIRTUAL_ADDRESS uploadRingGPUAddress = 0;
+	// 割り当て位置の管理（フレームのフェンス値で解放する）
+	RingAllocator uploadRing;
+
 private: // メンバ関数
 	// FPS固定初期化
 	void InitializeFixFPS();
@@ -0,0 +1,76 @@
+#include "FrameScheduler.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+namespace
+{
+	int64_t NowTicks()
+	{
+		return std::chrono::steady_clock::now().time_since_epoch().count();
+	}
+
+	double TicksToMilliseconds(int64_t ticks)
+	{
+		using Duration = std::chrono::steady_clock::duration;
+		return std::chrono::duration<double, std::milli>(Duration(ticks)).count();
+	}
+}
+
+void FrameScheduler::Initialize(uint32_t frameLatency)
+{
+	assert(frameLatency >= 1);
+	this->frameLatency = std::clamp(frameLatency, 1u, kMaxFrameLatency);
+	frameIndex = 0;
+	contextFenceValues.fill(0);
+	lastSignaledValue = 0;
+	frameOpen = false;
+	timings = {};
+}
+
+uint32_t FrameScheduler::BeginFrame(FrameFence &fence)
+{
+	assert(!frameOpen);
+
+	// このコンテキストを前に使ったフレームが終わっていなければ待つ
+	// （それより新しいフレームはGPUで処理中のままでよい）
+	currentGpuWait = WaitForValue(fence, contextFenceValues[frameIndex]);
+
+	frameOpen = true;
+	frameBeginTicks = NowTicks();
+	return frameIndex;
+}
+
+uint64_t FrameScheduler::EndFrame(FrameFence &fence)
+{
+	assert(frameOpen);
+
+	// このフレームのコマンドの完了を表すフェンス値をSignalし、コンテキストに記録
+	lastSignaledValue++;
+	fence.Signal(lastSignaledValue);
+	contextFenceValues[frameIndex] = lastSignaledValue;
+
+	timings.cpuFrame = TicksToMilliseconds(NowTicks() - frameBeginTicks);
+	timings.gpuWait = currentGpuWait;
+
+	// 次のコンテキストへ
+	frameIndex = (frameIndex + 1) % frameLatency;
+	frameOpen = false;
+	return lastSignaledValue;
+}
+
+void FrameScheduler::WaitForIdle(FrameFence &fence)
+{
+	WaitForValue(fence, lastSignaledValue);
+}
+
+double FrameScheduler::WaitForValue(FrameFence &fence, uint64_t value)
+{
+	if (value == 0 || fence.GetCompletedValue() >= value) {
+		return 0.0;
+	}
+
+	int64_t begin = NowTicks();
+	fence.Wait(value);
+	return TicksToMilliseconds(NowTicks() - begin);
+}
\ No newline at end of file
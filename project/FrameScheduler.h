@@ -0,0 +1,84 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// フレームの完了を待つためのフェンス（D3D12のフェンスと、テスト用の偽物を差し替えられるようにする）
+class FrameFence
+{
+public:
+	virtual ~FrameFence() = default;
+
+	// キューに積んだコマンドが終わったら、フェンスの値をvalueにする
+	virtual void Signal(uint64_t value) = 0;
+	// GPUが到達したフェンス値
+	virtual uint64_t GetCompletedValue() = 0;
+	// フェンスの値がvalueに到達するまでCPUを止める
+	virtual void Wait(uint64_t value) = 0;
+};
+
+// 複数フレームを同時に処理させるためのフレームコンテキストの管理
+// CPUはGPUより最大でフレームレイテンシ分だけ先のフレームを記録できる
+// 次に使うコンテキストの前回のフレームが終わるまでだけ待ち、毎フレームGPUの完了は待たない
+class FrameScheduler
+{
+public:
+
+	// 同時に処理できる最大のフレーム数
+	static constexpr uint32_t kMaxFrameLatency = 3;
+
+	// 1フレームの時間の計測結果（ミリ秒）
+	struct Timings
+	{
+		double cpuFrame = 0.0; // BeginFrameからEndFrameまで（CPUの記録時間）
+		double gpuWait = 0.0; // BeginFrameでGPUを待った時間
+	};
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="frameLatency">同時に処理するフレーム数（1でフレームごとにGPUの完了を待つ）</param>
+	void Initialize(uint32_t frameLatency);
+
+	/// <summary>
+	/// フレームの開始。これから使うコンテキストの前回のフレームが終わるまで待つ
+	/// </summary>
+	/// <returns>このフレームで使うコンテキストの番号</returns>
+	uint32_t BeginFrame(FrameFence &fence);
+
+	/// <summary>
+	/// フレームの終了。コマンドを投げた後に呼び、このフレームのフェンス値をSignalする
+	/// </summary>
+	/// <returns>このフレームの完了を表すフェンス値</returns>
+	uint64_t EndFrame(FrameFence &fence);
+
+	// Signal済みのすべてのフレームが終わるまで待つ（リソースの解放前など）
+	void WaitForIdle(FrameFence &fence);
+
+	// ===== getter =====
+	uint32_t GetFrameLatency() const { return frameLatency; }
+	// 現在のコンテキストの番号
+	uint32_t GetFrameIndex() const { return frameIndex; }
+	// 最後にSignalしたフェンス値
+	uint64_t GetLastSignaledValue() const { return lastSignaledValue; }
+	// 今記録しているフレームの完了を表すフェンス値（EndFrameでSignalされる値）
+	uint64_t GetCurrentFrameFenceValue() const { return lastSignaledValue + 1; }
+	// 前のフレームの計測結果
+	const Timings &GetTimings() const { return timings; }
+
+private:
+
+	// 待ちが必要なら待って、待った時間（ミリ秒）を返す
+	static double WaitForValue(FrameFence &fence, uint64_t value);
+
+	uint32_t frameLatency = 2;
+	uint32_t frameIndex = 0;
+	// 各コンテキストが最後に使われたフレームのフェンス値（0は未使用）
+	std::array<uint64_t, kMaxFrameLatency> contextFenceValues {};
+	uint64_t lastSignaledValue = 0;
+	bool frameOpen = false;
+
+	// 計測
+	int64_t frameBeginTicks = 0;
+	double currentGpuWait = 0.0;
+	Timings timings;
+};
\ No newline at end of file
@@ -0,0 +1,311 @@
+#include "GlyphCache.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+
+// imgui_draw.cppの実装はstaticなので、こちらでも実装を持つ
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "externals/imgui/imstb_truetype.h"
+
+// 読み込んだフォント
+struct GlyphCache::Font
+{
+	std::vector<uint8_t> data; // フォントファイルの中身（infoが指し続ける）
+	stbtt_fontinfo info;
+	int ascent; // 行の寸法（フォントの単位）
+	int descent;
+	int lineGap;
+
+	// 文字の高さ（ピクセル）にする拡大率（stbtt_ScaleForPixelHeightと同じ計算）
+	float GetScale(uint32_t pixelHeight) const { return float(pixelHeight) / float(ascent - descent); }
+};
+
+namespace {
+
+	// キーをハッシュ値にする（64bitの乗算で上位に混ぜる）
+	inline size_t HashKey(uint64_t key)
+	{
+		key ^= key >> 29;
+		key *= 0x9E3779B97F4A7C15ull;
+		return static_cast<size_t>(key ^ (key >> 32));
+	}
+}
+
+GlyphCache::GlyphCache() = default;
+GlyphCache::~GlyphCache() = default;
+
+void GlyphCache::Initialize(uint32_t atlasWidth, uint32_t atlasHeight)
+{
+	assert(atlasWidth % kMaxCellSize == 0 && atlasHeight <= UINT16_MAX && atlasWidth <= UINT16_MAX);
+	width = atlasWidth;
+	height = atlasHeight;
+	pixels.assign(size_t(width) * height, 0);
+	ClearDirtyRect();
+
+	// 一番小さいセルで埋め尽くしてもセルの番号が変わらないように確保しておく
+	const size_t maxCellCount = size_t(width / kMinCellSize) * (height / kMinCellSize);
+	cells.clear();
+	cells.reserve(maxCellCount);
+	for (CellClass &cellClass : cellClasses) {
+		cellClass = CellClass {};
+	}
+	nextShelfY = 0;
+
+	// 埋まり具合が半分以下になる大きさにする
+	size_t bucketCount = 16;
+	while (bucketCount < maxCellCount * 2) {
+		bucketCount <<= 1;
+	}
+	buckets.assign(bucketCount, Bucket { kEmptyKey, kNone });
+	kerningCache.assign(kKerningCacheSize, KerningEntry { kEmptyKey, 0 });
+
+	residentCount = 0;
+	statistics = {};
+}
+
+int32_t GlyphCache::LoadFont(const std::string &filePath, int32_t fontIndex)
+{
+	//----ファイルを丸ごと読み込む----
+	std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+	if (!file.is_open()) {
+		return -1;
+	}
+	std::unique_ptr<Font> font = std::make_unique<Font>();
+	font->data.resize(size_t(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char *>(font->data.data()), std::streamsize(font->data.size()));
+
+	//----フォントの表を解析する----
+	int offset = stbtt_GetFontOffsetForIndex(font->data.data(), fontIndex);
+	if (offset < 0 || !stbtt_InitFont(&font->info, font->data.data(), offset)) {
+		return -1;
+	}
+	stbtt_GetFontVMetrics(&font->info, &font->ascent, &font->descent, &font->lineGap);
+
+	// キーに入るのは16bitまで
+	assert(fonts.size() < UINT16_MAX);
+	fonts.push_back(std::move(font));
+	return int32_t(fonts.size() - 1);
+}
+
+const GlyphCache::Glyph &GlyphCache::GetGlyph(uint32_t font, uint32_t codepoint, uint32_t pixelHeight)
+{
+	assert(font < fonts.size());
+	assert(pixelHeight > 0 && pixelHeight <= UINT16_MAX);
+
+	//----キャッシュにあれば最近使った方へ移して返す----
+	const uint64_t key = MakeKey(font, codepoint, pixelHeight);
+	uint32_t cellIndex = FindCell(key);
+	if (cellIndex != kNone) {
+		Cell &cell = cells[cellIndex];
+		cell.lastUsedFrame = frame;
+		CellClass &cellClass = cellClasses[cell.classIndex];
+		if (cellClass.head != cellIndex) {
+			Unlink(cellClass, cellIndex);
+			PushFront(cellClass, cellIndex);
+		}
+		statistics.hits++;
+		return cell.glyph;
+	}
+
+	//----寸法を求める----
+	const Font &fontData = *fonts[font];
+	const float scale = fontData.GetScale(pixelHeight);
+	const int glyphIndex = stbtt_FindGlyphIndex(&fontData.info, int(codepoint));
+	int advance = 0, leftSideBearing = 0;
+	stbtt_GetGlyphHMetrics(&fontData.info, glyphIndex, &advance, &leftSideBearing);
+	int x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+	stbtt_GetGlyphBitmapBox(&fontData.info, glyphIndex, scale, scale, &x0, &y0, &x1, &y1);
+
+	Glyph glyph {};
+	glyph.width = uint16_t(std::max(x1 - x0, 0));
+	glyph.height = uint16_t(std::max(y1 - y0, 0));
+	glyph.offsetX = int16_t(x0);
+	glyph.offsetY = int16_t(y0);
+	glyph.advance = float(advance) * scale;
+	glyph.glyphIndex = uint32_t(glyphIndex);
+
+	//----入るセルの種類を決めて、セルを用意する----
+	const uint32_t cellSizeNeeded = uint32_t(std::max(glyph.width, glyph.height)) + kPadding * 2;
+	uint32_t classIndex = 0;
+	while (classIndex < kCellClassCount && (kMinCellSize << classIndex) < cellSizeNeeded) {
+		classIndex++;
+	}
+	cellIndex = classIndex < kCellClassCount ? AllocateCell(classIndex) : kNone;
+	if (cellIndex == kNone) {
+		// 寸法だけ返す（送り幅は正しいので、後ろの文字の位置はずれない）
+		statistics.overflows++;
+		overflowGlyph = glyph;
+		overflowGlyph.width = 0;
+		overflowGlyph.height = 0;
+		return overflowGlyph;
+	}
+
+	//----セルを空にしてからラスタライズする----
+	Cell &cell = cells[cellIndex];
+	const uint32_t cellSize = kMinCellSize << classIndex;
+	for (uint32_t row = 0; row < cellSize; ++row) {
+		std::memset(&pixels[size_t(cell.y + row) * width + cell.x], 0, cellSize);
+	}
+	glyph.x = uint16_t(cell.x + kPadding);
+	glyph.y = uint16_t(cell.y + kPadding);
+	if (glyph.width > 0 && glyph.height > 0) {
+		stbtt_MakeGlyphBitmap(&fontData.info, &pixels[size_t(glyph.y) * width + glyph.x], glyph.width, glyph.height, int(width), scale, scale, glyphIndex);
+	}
+	dirtyRect.left = std::min<uint32_t>(dirtyRect.left, cell.x);
+	dirtyRect.top = std::min<uint32_t>(dirtyRect.top, cell.y);
+	dirtyRect.right = std::max<uint32_t>(dirtyRect.right, cell.x + cellSize);
+	dirtyRect.bottom = std::max<uint32_t>(dirtyRect.bottom, cell.y + cellSize);
+
+	cell.key = key;
+	cell.glyph = glyph;
+	cell.lastUsedFrame = frame;
+	InsertCell(key, cellIndex);
+	PushFront(cellClasses[classIndex], cellIndex);
+	residentCount++;
+	statistics.rasterized++;
+	return cell.glyph;
+}
+
+float GlyphCache::GetKerning(uint32_t font, uint32_t pixelHeight, uint32_t leftGlyphIndex, uint32_t rightGlyphIndex)
+{
+	assert(font < fonts.size());
+	const Font &fontData = *fonts[font];
+	// kern表もGPOSもなければ表を引かない
+	if (!fontData.info.kern && !fontData.info.gpos) {
+		return 0.0f;
+	}
+
+	// GPOSを引くのは重いので、組ごとの値（フォントの単位）を覚えておく（同じ場所に来た別の組は上書きする）
+	const uint64_t key = (uint64_t(font) << 40) | (uint64_t(leftGlyphIndex) << 20) | rightGlyphIndex;
+	KerningEntry &entry = kerningCache[HashKey(key) & (kKerningCacheSize - 1)];
+	if (entry.key != key) {
+		entry.key = key;
+		entry.kerning = stbtt_GetGlyphKernAdvance(&fontData.info, int(leftGlyphIndex), int(rightGlyphIndex));
+	}
+	return entry.kerning == 0 ? 0.0f : float(entry.kerning) * fontData.GetScale(pixelHeight);
+}
+
+GlyphCache::LineMetrics GlyphCache::GetLineMetrics(uint32_t font, uint32_t pixelHeight) const
+{
+	assert(font < fonts.size());
+	const Font &fontData = *fonts[font];
+	const float scale = fontData.GetScale(pixelHeight);
+	return { float(fontData.ascent) * scale, float(fontData.descent) * scale, float(fontData.lineGap) * scale };
+}
+
+uint32_t GlyphCache::FindCell(uint64_t key) const
+{
+	const size_t mask = buckets.size() - 1;
+	for (size_t bucket = HashKey(key) & mask;; bucket = (bucket + 1) & mask) {
+		if (buckets[bucket].key == key) {
+			return buckets[bucket].cell;
+		}
+		if (buckets[bucket].key == kEmptyKey) {
+			return kNone;
+		}
+	}
+}
+
+void GlyphCache::InsertCell(uint64_t key, uint32_t cell)
+{
+	const size_t mask = buckets.size() - 1;
+	size_t bucket = HashKey(key) & mask;
+	while (buckets[bucket].key != kEmptyKey) {
+		bucket = (bucket + 1) & mask;
+	}
+	buckets[bucket] = { key, cell };
+}
+
+void GlyphCache::EraseCell(uint64_t key)
+{
+	// 消した所を詰める（後ろの要素のうち、本来の位置から見て空いた所を越えているものを前へ戻す）
+	const size_t mask = buckets.size() - 1;
+	size_t hole = HashKey(key) & mask;
+	while (buckets[hole].key != key) {
+		assert(buckets[hole].key != kEmptyKey);
+		hole = (hole + 1) & mask;
+	}
+	for (size_t bucket = (hole + 1) & mask; buckets[bucket].key != kEmptyKey; bucket = (bucket + 1) & mask) {
+		size_t home = HashKey(buckets[bucket].key) & mask;
+		// homeがholeとbucketの間（巡回して）になければholeへ移せる
+		bool between = hole <= bucket ? (hole < home && home <= bucket) : (hole < home || home <= bucket);
+		if (!between) {
+			buckets[hole] = buckets[bucket];
+			hole = bucket;
+		}
+	}
+	buckets[hole] = { kEmptyKey, kNone };
+}
+
+void GlyphCache::Unlink(CellClass &cellClass, uint32_t cell)
+{
+	Cell &target = cells[cell];
+	if (target.previous != kNone) {
+		cells[target.previous].next = target.next;
+	} else {
+		cellClass.head = target.next;
+	}
+	if (target.next != kNone) {
+		cells[target.next].previous = target.previous;
+	} else {
+		cellClass.tail = target.previous;
+	}
+	target.previous = kNone;
+	target.next = kNone;
+}
+
+void GlyphCache::PushFront(CellClass &cellClass, uint32_t cell)
+{
+	Cell &target = cells[cell];
+	target.previous = kNone;
+	target.next = cellClass.head;
+	if (cellClass.head != kNone) {
+		cells[cellClass.head].previous = cell;
+	} else {
+		cellClass.tail = cell;
+	}
+	cellClass.head = cell;
+}
+
+uint32_t GlyphCache::AllocateCell(uint32_t classIndex)
+{
+	CellClass &cellClass = cellClasses[classIndex];
+	const uint32_t cellSize = kMinCellSize << classIndex;
+
+	//----空いているセルがなければ、新しいシェルフをこの種類のセルで区切る----
+	if (cellClass.freeCells.empty() && nextShelfY + cellSize <= height) {
+		// 後ろから取り出すので、右から積んで左から使う
+		for (uint32_t x = width; x >= cellSize; x -= cellSize) {
+			Cell cell {};
+			cell.key = kEmptyKey;
+			cell.previous = kNone;
+			cell.next = kNone;
+			cell.x = uint16_t(x - cellSize);
+			cell.y = uint16_t(nextShelfY);
+			cell.classIndex = uint16_t(classIndex);
+			cellClass.freeCells.push_back(uint32_t(cells.size()));
+			cells.push_back(cell);
+		}
+		nextShelfY += cellSize;
+	}
+	if (!cellClass.freeCells.empty()) {
+		uint32_t cell = cellClass.freeCells.back();
+		cellClass.freeCells.pop_back();
+		return cell;
+	}
+
+	//----一番長く使っていないグリフを追い出す（このフレームで使ったものしかなければ置けない）----
+	uint32_t victim = cellClass.tail;
+	if (victim == kNone || cells[victim].lastUsedFrame == frame) {
+		return kNone;
+	}
+	Unlink(cellClass, victim);
+	EraseCell(cells[victim].key);
+	cells[victim].key = kEmptyKey;
+	residentCount--;
+	statistics.evictions++;
+	return victim;
+}
\ No newline at end of file
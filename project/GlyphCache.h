@@ -0,0 +1,197 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// グリフキャッシュ
+// TrueTypeフォントの文字を、初めて使われたときにimstb_truetypeでラスタライズして1枚のアトラス（1画素1byteの覆い率）に置く
+// アトラスは8～128ピクセルの正方形のセルに分け、行（シェルフ）単位でセルの大きさの種類に割り当てる
+// 空きがなければ、同じ大きさのセルで一番長く使われていないグリフ（LRU）を追い出して使い回す
+// GPUには触らない（書き換えた範囲をGetDirtyRectで受け取り、描画側が転送する）
+class GlyphCache
+{
+public:
+
+	// アトラスに置いたグリフ
+	struct Glyph
+	{
+		uint16_t x; // アトラス上の左上（ピクセル）
+		uint16_t y;
+		uint16_t width; // 大きさ（0なら描く物がない。空白や、アトラスに置けなかった文字）
+		uint16_t height;
+		int16_t offsetX; // ペン位置（ベースライン上）からビットマップの左上までのずれ
+		int16_t offsetY;
+		float advance; // 次の文字までの送り幅（ピクセル）
+		uint32_t glyphIndex; // フォント内のグリフ番号（カーニング用）
+	};
+
+	// 行の寸法（ピクセル。descentは負）
+	struct LineMetrics
+	{
+		float ascent;
+		float descent;
+		float lineGap;
+	};
+
+	// アトラス上の範囲（right・bottomは含まない）
+	struct Rect
+	{
+		uint32_t left;
+		uint32_t top;
+		uint32_t right;
+		uint32_t bottom;
+	};
+
+	// 使われ方の集計
+	struct Statistics
+	{
+		uint64_t hits = 0; // キャッシュにあった回数
+		uint64_t rasterized = 0; // ラスタライズした回数
+		uint64_t evictions = 0; // 追い出した回数
+		uint64_t overflows = 0; // このフレームで使ったグリフばかりで置けなかった回数（その文字は描かれない）
+	};
+
+	GlyphCache();
+	~GlyphCache();
+
+	/// <summary>
+	/// 初期化（アトラスを確保する）
+	/// </summary>
+	/// <param name="atlasWidth">アトラスの幅（最大のセルの大きさの倍数）</param>
+	/// <param name="atlasHeight">アトラスの高さ</param>
+	void Initialize(uint32_t atlasWidth, uint32_t atlasHeight);
+
+	/// <summary>
+	/// フォントファイルを読み込む
+	/// </summary>
+	/// <param name="filePath">.ttf/.ttc/.otf（TrueTypeアウトライン）のパス</param>
+	/// <param name="fontIndex">.ttcの中の何番目のフォントか</param>
+	/// <returns>フォント番号（読み込めなければ-1）</returns>
+	int32_t LoadFont(const std::string &filePath, int32_t fontIndex = 0);
+
+	/// <summary>
+	/// グリフを取得する（なければラスタライズしてアトラスに置く）
+	/// 返した参照は次に呼ぶまで有効。このフレームで使ったグリフはNextFrameまで追い出さない
+	/// </summary>
+	/// <param name="font">フォント番号</param>
+	/// <param name="codepoint">Unicodeのコードポイント</param>
+	/// <param name="pixelHeight">文字の高さ（ピクセル。ascent - descent がこの高さになる）</param>
+	const Glyph &GetGlyph(uint32_t font, uint32_t codepoint, uint32_t pixelHeight);
+
+	// 2つのグリフの間のカーニング（ピクセル）
+	float GetKerning(uint32_t font, uint32_t pixelHeight, uint32_t leftGlyphIndex, uint32_t rightGlyphIndex);
+
+	// 行の寸法
+	LineMetrics GetLineMetrics(uint32_t font, uint32_t pixelHeight) const;
+
+	// フレームを進める（前のフレームまでに使ったグリフを追い出せるようにする）
+	void NextFrame() { frame++; }
+
+	// アトラス（1画素1byte、1行はGetWidth() byte）
+	const uint8_t *GetPixels() const { return pixels.data(); }
+	uint32_t GetWidth() const { return width; }
+	uint32_t GetHeight() const { return height; }
+
+	// 前回ClearDirtyRectしてから書き換えた範囲
+	bool IsDirty() const { return dirtyRect.right > dirtyRect.left; }
+	const Rect &GetDirtyRect() const { return dirtyRect; }
+	void ClearDirtyRect() { dirtyRect = { width, height, 0, 0 }; }
+
+	// 使われ方の集計
+	const Statistics &GetStatistics() const { return statistics; }
+	// アトラスに置いているグリフの数
+	uint32_t GetResidentCount() const { return residentCount; }
+
+	// セルの大きさ（最小はこれ、種類ごとに2倍）と種類の数
+	static constexpr uint32_t kMinCellSize = 8;
+	static constexpr uint32_t kCellClassCount = 5;
+	static constexpr uint32_t kMaxCellSize = kMinCellSize << (kCellClassCount - 1);
+	// グリフのまわりに空ける幅（バイリニアで隣のセルを拾わない）
+	static constexpr uint32_t kPadding = 1;
+
+private:
+
+	// 読み込んだフォント（imstb_truetypeの型はcppの中だけで使う）
+	struct Font;
+
+	// セル1つ分（キャッシュの1要素）
+	struct Cell
+	{
+		uint64_t key; // 置いているグリフのキー（空ならkEmptyKey）
+		Glyph glyph;
+		uint32_t lastUsedFrame;
+		uint32_t previous; // LRUの前後（前ほど最近使った）
+		uint32_t next;
+		uint16_t x; // セルの左上
+		uint16_t y;
+		uint16_t classIndex; // セルの大きさの種類
+	};
+
+	// セルの大きさの種類ごとのLRU
+	struct CellClass
+	{
+		uint32_t head = kNone; // 一番最近使ったセル
+		uint32_t tail = kNone; // 一番長く使っていないセル
+		std::vector<uint32_t> freeCells; // 何も置いていないセル
+	};
+
+	// キーからセルを引くハッシュテーブル（オープンアドレス法）の要素
+	struct Bucket
+	{
+		uint64_t key;
+		uint32_t cell;
+	};
+
+	// カーニングを覚えておく要素（大きさによらないのでフォントの単位で持つ）
+	struct KerningEntry
+	{
+		uint64_t key;
+		int32_t kerning;
+	};
+
+	static constexpr uint32_t kNone = UINT32_MAX;
+	static constexpr size_t kKerningCacheSize = 4096;
+	static constexpr uint64_t kEmptyKey = UINT64_MAX;
+
+	// キャッシュのキー（フォント・大きさ・コードポイント）
+	static uint64_t MakeKey(uint32_t font, uint32_t codepoint, uint32_t pixelHeight)
+	{
+		return (uint64_t(font) << 48) | (uint64_t(pixelHeight) << 32) | codepoint;
+	}
+
+	// ハッシュテーブルの操作
+	uint32_t FindCell(uint64_t key) const;
+	void InsertCell(uint64_t key, uint32_t cell);
+	void EraseCell(uint64_t key);
+
+	// LRUの操作
+	void Unlink(CellClass &cellClass, uint32_t cell);
+	void PushFront(CellClass &cellClass, uint32_t cell);
+
+	// 種類のセルを1つ用意する（空き→新しいシェルフ→LRUの追い出しの順。なければkNone）
+	uint32_t AllocateCell(uint32_t classIndex);
+
+	std::vector<std::unique_ptr<Font>> fonts;
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	std::vector<uint8_t> pixels;
+	Rect dirtyRect {};
+
+	std::vector<Cell> cells;
+	CellClass cellClasses[kCellClassCount];
+	// 次のシェルフを置く高さ
+	uint32_t nextShelfY = 0;
+
+	std::vector<Bucket> buckets;
+	std::vector<KerningEntry> kerningCache;
+
+	uint32_t frame = 1;
+	uint32_t residentCount = 0;
+	// アトラスに置けなかったグリフ（寸法だけ返す）
+	Glyph overflowGlyph {};
+
+	Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,55 @@
+#include "InstanceBatcher.h"
+#include <algorithm>
+
+void InstanceBatcher::Clear()
+{
+	keys.clear();
+	worlds.clear();
+	groups.clear();
+	instances.clear();
+}
+
+uint32_t InstanceBatcher::Add(uint32_t key, const math::Matrix4x4 &world)
+{
+	uint32_t item = static_cast<uint32_t>(keys.size());
+	keys.push_back(key);
+	worlds.push_back(world);
+	return item;
+}
+
+void InstanceBatcher::Build()
+{
+	groups.clear();
+	instances.resize(worlds.size());
+	if (keys.empty()) {
+		return;
+	}
+
+	// キーは小さい連番なので計数ソートで並べる（比較ソートより速く、同じキー内の順番も保たれる）
+	uint32_t maxKey = *std::max_element(keys.begin(), keys.end());
+	keyOffsets.assign(size_t(maxKey) + 1, 0);
+	keyFirstItems.assign(size_t(maxKey) + 1, UINT32_MAX);
+	for (uint32_t item = 0; item < keys.size(); ++item) {
+		uint32_t key = keys[item];
+		if (keyOffsets[key]++ == 0) {
+			keyFirstItems[key] = item;
+		}
+	}
+
+	// 数をグループの開始位置に変える
+	uint32_t offset = 0;
+	for (uint32_t key = 0; key <= maxKey; ++key) {
+		uint32_t count = keyOffsets[key];
+		if (count == 0) {
+			continue;
+		}
+		groups.push_back({ key, offset, count, keyFirstItems[key] });
+		keyOffsets[key] = offset;
+		offset += count;
+	}
+
+	// 行列を詰め直す
+	for (uint32_t item = 0; item < keys.size(); ++item) {
+		instances[keyOffsets[keys[item]]++] = worlds[item];
+	}
+}
\ No newline at end of file
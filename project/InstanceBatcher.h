@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MathTypes.h"
+
+// インスタンス描画用のまとめ役
+// 同じキー（モデル）のオブジェクトを集めて、ワールド行列をグループごとに連続した配列に詰め直す
+// 詰めた配列はそのままStructuredBufferとしてGPUへ送り、グループごとに1回のDrawで描ける
+class InstanceBatcher
+{
+public:
+
+	// 同じキーのインスタンスのまとまり
+	struct Group
+	{
+		uint32_t key; // モデルのキー
+		uint32_t firstInstance; // GetInstances()の何番目から始まるか
+		uint32_t instanceCount; // インスタンス数
+		uint32_t firstItem; // このグループで最初に追加された要素の番号（Addの戻り値）
+	};
+
+	// 追加した要素をすべて破棄する（確保した領域は残す）
+	void Clear();
+
+	/// <summary>
+	/// インスタンスを追加する
+	/// </summary>
+	/// <param name="key">まとめる単位のキー（AssetHandleのスロット番号のような小さい連番）</param>
+	/// <param name="world">ワールド行列</param>
+	/// <returns>追加した要素の番号（0からの連番）</returns>
+	uint32_t Add(uint32_t key, const math::Matrix4x4 &world);
+
+	/// <summary>
+	/// キーごとにまとめて、ワールド行列を詰め直す
+	/// グループはキーの小さい順、グループ内は追加した順になる
+	/// </summary>
+	void Build();
+
+	// 追加した要素の数
+	size_t GetItemCount() const { return keys.size(); }
+	// Buildの結果
+	const std::vector<Group> &GetGroups() const { return groups; }
+	// グループ順に詰めたワールド行列
+	const std::vector<math::Matrix4x4> &GetInstances() const { return instances; }
+
+private:
+
+	// 追加した順
+	std::vector<uint32_t> keys;
+	std::vector<math::Matrix4x4> worlds;
+
+	// Buildの結果
+	std::vector<uint32_t> keyOffsets; // キーごとの書き込み位置（計数ソート用）
+	std::vector<uint32_t> keyFirstItems; // キーごとに最初に追加された要素
+	std::vector<Group> groups;
+	std::vector<math::Matrix4x4> instances;
+};
\ No newline at end of file
@@ -1,10 +1,23 @@
 #include "Logger.h"
 #include <iostream>
+#ifdef _WIN32
 #include <Windows.h>
+#else
+#include <cstdio>
+
+namespace {
+	// Windows以外（テスト）ではデバッグ出力の代わりに標準エラーへ出す
+	void OutputDebugStringA(const char *message) { std::fputs(message, stderr); }
+}
+#endif
 
 namespace Logger {
 	void Log(std::ostream &os, const std::string &message) {
 		os << message << std::endl;
 		OutputDebugStringA(message.c_str());
 	}
+
+	void Log(const std::string &message) {
+		OutputDebugStringA(message.c_str());
+	}
 }
\ No newline at end of file
@@ -5,4 +5,7 @@
 namespace Logger
 {
 	void Log(std::ostream &os, const std::string &message);
+
+	// デバッグ出力のみに書き出す（ログファイルのストリームを持たない場所用）
+	void Log(const std::string &message);
 }
\ No newline at end of file
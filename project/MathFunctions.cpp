@@ -2,8 +2,43 @@
 #include <cmath>
 #include <cassert>
 
+#if MATH_USE_SSE
+#include <emmintrin.h>
+#endif
+
 namespace math {
 
+#if MATH_USE_SSE
+	namespace {
+
+		// 行の読み書き（Matrix4x4は16byte境界に置かれている）
+		inline __m128 LoadRow(const Matrix4x4 &m, int row) { return _mm_load_ps(m.m[row]); }
+		inline void StoreRow(Matrix4x4 &m, int row, __m128 v) { _mm_store_ps(m.m[row], v); }
+
+		// 4要素の並べ替え
+		template <int x, int y, int z, int w>
+		inline __m128 Swizzle(__m128 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(w, z, y, x)); }
+		template <int x, int y, int z, int w>
+		inline __m128 Shuffle(__m128 a, __m128 b) { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x)); }
+
+		// 2x2行列（[a b c d] = |a b; c d|）の積 A*B
+		inline __m128 Mat2Mul(__m128 a, __m128 b)
+		{
+			return _mm_add_ps(_mm_mul_ps(a, Swizzle<0, 3, 0, 3>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+		// 2x2行列の余因子行列との積 adj(A)*B
+		inline __m128 Mat2AdjMul(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(Swizzle<3, 3, 0, 0>(a), b), _mm_mul_ps(Swizzle<1, 1, 2, 2>(a), Swizzle<2, 3, 0, 1>(b)));
+		}
+		// 2x2行列と余因子行列との積 A*adj(B)
+		inline __m128 Mat2MulAdj(__m128 a, __m128 b)
+		{
+			return _mm_sub_ps(_mm_mul_ps(a, Swizzle<3, 0, 3, 0>(b)), _mm_mul_ps(Swizzle<1, 0, 3, 2>(a), Swizzle<2, 1, 2, 1>(b)));
+		}
+	}
+#endif
+
 	Matrix4x4 MakeIdentity4x4()
 	{
 		Matrix4x4 result {};
@@ -150,183 +185,117 @@ namespace math {
 
 	Matrix4x4 Multiply(const Matrix4x4 &m1, const Matrix4x4 &m2)
 	{
+#if MATH_USE_SSE
 		Matrix4x4 result {};
 
+		// 結果の各行 = m1の行の各要素 × m2の各行 の和（スカラー版と同じ順で足す）
+		__m128 row0 = LoadRow(m2, 0);
+		__m128 row1 = LoadRow(m2, 1);
+		__m128 row2 = LoadRow(m2, 2);
+		__m128 row3 = LoadRow(m2, 3);
 		for (int row = 0; row < 4; ++row) {
-			for (int col = 0; col < 4; ++col) {
-				result.m[row][col] = 0.0f;
-				for (int k = 0; k < 4; ++k) {
-					result.m[row][col] += m1.m[row][k] * m2.m[k][col];
-				}
-			}
+			__m128 sum = _mm_mul_ps(_mm_set1_ps(m1.m[row][0]), row0);
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(m1.m[row][1]), row1));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(m1.m[row][2]), row2));
+			sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(m1.m[row][3]), row3));
+			StoreRow(result, row, sum);
 		}
 
 		return result;
+#else
+		return scalar::Multiply(m1, m2);
+#endif
 	}
 
 	Matrix4x4 MakeAffineMatrix(const Vector3 &scale, const Vector3 &rotate, const Vector3 &translate)
 	{
 		Matrix4x4 result {};
 
-		Matrix4x4 scaleMatrix = MakeScaleMatrix(scale);
+		// S * (Rx * Ry * Rz) * T を展開した形で直接組み立てる
+		float sinX = std::sin(rotate.x);
+		float cosX = std::cos(rotate.x);
+		float sinY = std::sin(rotate.y);
+		float cosY = std::cos(rotate.y);
+		float sinZ = std::sin(rotate.z);
+		float cosZ = std::cos(rotate.z);
+
+		result.m[0][0] = scale.x * (cosY * cosZ);
+		result.m[0][1] = scale.x * (cosY * sinZ);
+		result.m[0][2] = scale.x * (-sinY);
+		result.m[0][3] = 0.0f;
 
-		Matrix4x4 rotateXMatrix = MakeRotateXMatrix(rotate.x);
-		Matrix4x4 rotateYMatrix = MakeRotateYMatrix(rotate.y);
-		Matrix4x4 rotateZMatrix = MakeRotateZMatrix(rotate.z);
-		Matrix4x4 rotateXYZMatrix =
-			Multiply(rotateXMatrix, Multiply(rotateYMatrix, rotateZMatrix));
+		result.m[1][0] = scale.y * (sinX * sinY * cosZ - cosX * sinZ);
+		result.m[1][1] = scale.y * (sinX * sinY * sinZ + cosX * cosZ);
+		result.m[1][2] = scale.y * (sinX * cosY);
+		result.m[1][3] = 0.0f;
 
-		Matrix4x4 translateMatrix = MakeTranslateMatrix(translate);
+		result.m[2][0] = scale.z * (cosX * sinY * cosZ + sinX * sinZ);
+		result.m[2][1] = scale.z * (cosX * sinY * sinZ - sinX * cosZ);
+		result.m[2][2] = scale.z * (cosX * cosY);
+		result.m[2][3] = 0.0f;
 
-		result = Multiply(Multiply(scaleMatrix, rotateXYZMatrix), translateMatrix);
+		result.m[3][0] = translate.x;
+		result.m[3][1] = translate.y;
+		result.m[3][2] = translate.z;
+		result.m[3][3] = 1.0f;
 
 		return result;
 	}
 
 	Matrix4x4 Inverse(const Matrix4x4 &m)
 	{
+#if MATH_USE_SSE
 		Matrix4x4 result {};
 
-		float determinant = (m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3]) +
-			(m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1]) +
-			(m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2]) -
-
-			(m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1]) -
-			(m.m[0][0] * m.m[1][2] * m.m[2][1] * m.m[3][3]) -
-			(m.m[0][0] * m.m[1][1] * m.m[2][3] * m.m[3][2]) -
-
-			(m.m[0][1] * m.m[1][0] * m.m[2][2] * m.m[3][3]) -
-			(m.m[0][2] * m.m[1][0] * m.m[2][3] * m.m[3][1]) -
-			(m.m[0][3] * m.m[1][0] * m.m[2][1] * m.m[3][2]) +
-
-			(m.m[0][3] * m.m[1][0] * m.m[2][2] * m.m[3][1]) +
-			(m.m[0][2] * m.m[1][0] * m.m[2][1] * m.m[3][3]) +
-			(m.m[0][1] * m.m[1][0] * m.m[2][3] * m.m[3][2]) +
-
-			(m.m[0][1] * m.m[1][2] * m.m[2][0] * m.m[3][3]) +
-			(m.m[0][2] * m.m[1][3] * m.m[2][0] * m.m[3][1]) +
-			(m.m[0][3] * m.m[1][1] * m.m[2][0] * m.m[3][2]) -
-
-			(m.m[0][3] * m.m[1][2] * m.m[2][0] * m.m[3][1]) -
-			(m.m[0][2] * m.m[1][1] * m.m[2][0] * m.m[3][3]) -
-			(m.m[0][1] * m.m[1][3] * m.m[2][0] * m.m[3][2]) -
-
-			(m.m[0][1] * m.m[1][2] * m.m[2][3] * m.m[3][0]) -
-			(m.m[0][2] * m.m[1][3] * m.m[2][1] * m.m[3][0]) -
-			(m.m[0][3] * m.m[1][1] * m.m[2][2] * m.m[3][0]) +
-
-			(m.m[0][3] * m.m[1][2] * m.m[2][1] * m.m[3][0]) +
-			(m.m[0][2] * m.m[1][1] * m.m[2][3] * m.m[3][0]) +
-			(m.m[0][1] * m.m[1][3] * m.m[2][2] * m.m[3][0]);
-
-		assert(determinant != 0);
-		float determinantRecp = 1.0f / determinant;
-
-		result.m[0][0] =
-			determinantRecp *
-			(m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[1][2] * m.m[2][3] * m.m[3][1] +
-				m.m[1][3] * m.m[2][1] * m.m[3][2] - m.m[1][3] * m.m[2][2] * m.m[3][1] -
-				m.m[1][2] * m.m[2][1] * m.m[3][3] - m.m[1][1] * m.m[2][3] * m.m[3][2]);
-
-		result.m[0][1] =
-			determinantRecp *
-			(-(m.m[0][1] * m.m[2][2] * m.m[3][3]) -
-				m.m[0][2] * m.m[2][3] * m.m[3][1] - m.m[0][3] * m.m[2][1] * m.m[3][2] +
-				m.m[0][3] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[2][1] * m.m[3][3] +
-				m.m[0][1] * m.m[2][3] * m.m[3][2]);
-
-		result.m[0][2] =
-			determinantRecp *
-			(m.m[0][1] * m.m[1][2] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[3][1] +
-				m.m[0][3] * m.m[1][1] * m.m[3][2] - m.m[0][3] * m.m[1][2] * m.m[3][1] -
-				m.m[0][2] * m.m[1][1] * m.m[3][3] - m.m[0][1] * m.m[1][3] * m.m[3][2]);
-
-		result.m[0][3] =
-			determinantRecp *
-			(-(m.m[0][1] * m.m[1][2] * m.m[2][3]) -
-				m.m[0][2] * m.m[1][3] * m.m[2][1] - m.m[0][3] * m.m[1][1] * m.m[2][2] +
-				m.m[0][3] * m.m[1][2] * m.m[2][1] + m.m[0][2] * m.m[1][1] * m.m[2][3] +
-				m.m[0][1] * m.m[1][3] * m.m[2][2]);
-
-		result.m[1][0] =
-			determinantRecp *
-			(-(m.m[1][0] * m.m[2][2] * m.m[3][3]) -
-				m.m[1][2] * m.m[2][3] * m.m[3][0] - m.m[1][3] * m.m[2][0] * m.m[3][2] +
-				m.m[1][3] * m.m[2][2] * m.m[3][0] + m.m[1][2] * m.m[2][0] * m.m[3][3] +
-				m.m[1][0] * m.m[2][3] * m.m[3][2]);
-
-		result.m[1][1] =
-			determinantRecp *
-			(m.m[0][0] * m.m[2][2] * m.m[3][3] + m.m[0][2] * m.m[2][3] * m.m[3][0] +
-				m.m[0][3] * m.m[2][0] * m.m[3][2] - m.m[0][3] * m.m[2][2] * m.m[3][0] -
-				m.m[0][2] * m.m[2][0] * m.m[3][3] - m.m[0][0] * m.m[2][3] * m.m[3][2]);
-
-		result.m[1][2] =
-			determinantRecp *
-			(-(m.m[0][0] * m.m[1][2] * m.m[3][3]) -
-				m.m[0][2] * m.m[1][3] * m.m[3][0] - m.m[0][3] * m.m[1][0] * m.m[3][2] +
-				m.m[0][3] * m.m[1][2] * m.m[3][0] + m.m[0][2] * m.m[1][0] * m.m[3][3] +
-				m.m[0][0] * m.m[1][3] * m.m[3][2]);
-
-		result.m[1][3] =
-			determinantRecp *
-			(m.m[0][0] * m.m[1][2] * m.m[2][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] +
-				m.m[0][3] * m.m[1][0] * m.m[2][2] - m.m[0][3] * m.m[1][2] * m.m[2][0] -
-				m.m[0][2] * m.m[1][0] * m.m[2][3] - m.m[0][0] * m.m[1][3] * m.m[2][2]);
-
-		result.m[2][0] =
-			determinantRecp *
-			(m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[1][1] * m.m[2][3] * m.m[3][0] +
-				m.m[1][3] * m.m[2][0] * m.m[3][1] - m.m[1][3] * m.m[2][1] * m.m[3][0] -
-				m.m[1][1] * m.m[2][0] * m.m[3][3] - m.m[1][0] * m.m[2][3] * m.m[3][1]);
-
-		result.m[2][1] =
-			determinantRecp *
-			(-(m.m[0][0] * m.m[2][1] * m.m[3][3]) -
-				m.m[0][1] * m.m[2][3] * m.m[3][0] - m.m[0][3] * m.m[2][0] * m.m[3][1] +
-				m.m[0][3] * m.m[2][1] * m.m[3][0] + m.m[0][1] * m.m[2][0] * m.m[3][3] +
-				m.m[0][0] * m.m[2][3] * m.m[3][1]);
-
-		result.m[2][2] =
-			determinantRecp *
-			(m.m[0][0] * m.m[1][1] * m.m[3][3] + m.m[0][1] * m.m[1][3] * m.m[3][0] +
-				m.m[0][3] * m.m[1][0] * m.m[3][1] - m.m[0][3] * m.m[1][1] * m.m[3][0] -
-				m.m[0][1] * m.m[1][0] * m.m[3][3] - m.m[0][0] * m.m[1][3] * m.m[3][1]);
-
-		result.m[2][3] =
-			determinantRecp *
-			(-(m.m[0][0] * m.m[1][1] * m.m[2][3]) -
-				m.m[0][1] * m.m[1][3] * m.m[2][0] - m.m[0][3] * m.m[1][0] * m.m[2][1] +
-				m.m[0][3] * m.m[1][1] * m.m[2][0] + m.m[0][1] * m.m[1][0] * m.m[2][3] +
-				m.m[0][0] * m.m[1][3] * m.m[2][1]);
-
-		result.m[3][0] =
-			determinantRecp *
-			(-(m.m[1][0] * m.m[2][1] * m.m[3][2]) -
-				m.m[1][1] * m.m[2][2] * m.m[3][0] - m.m[1][2] * m.m[2][0] * m.m[3][1] +
-				m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[1][1] * m.m[2][0] * m.m[3][2] +
-				m.m[1][0] * m.m[2][2] * m.m[3][1]);
-
-		result.m[3][1] =
-			determinantRecp *
-			(m.m[0][0] * m.m[2][1] * m.m[3][2] + m.m[0][1] * m.m[2][2] * m.m[3][0] +
-				m.m[0][2] * m.m[2][0] * m.m[3][1] - m.m[0][2] * m.m[2][1] * m.m[3][0] -
-				m.m[0][1] * m.m[2][0] * m.m[3][2] - m.m[0][0] * m.m[2][2] * m.m[3][1]);
-
-		result.m[3][2] =
-			determinantRecp *
-			(-(m.m[0][0] * m.m[1][1] * m.m[3][2]) -
-				m.m[0][1] * m.m[1][2] * m.m[3][0] - m.m[0][2] * m.m[1][0] * m.m[3][1] +
-				m.m[0][2] * m.m[1][1] * m.m[3][0] + m.m[0][1] * m.m[1][0] * m.m[3][2] +
-				m.m[0][0] * m.m[1][2] * m.m[3][1]);
-
-		result.m[3][3] =
-			determinantRecp *
-			(m.m[0][0] * m.m[1][1] * m.m[2][2] + m.m[0][1] * m.m[1][2] * m.m[2][0] +
-				m.m[0][2] * m.m[1][0] * m.m[2][1] - m.m[0][2] * m.m[1][1] * m.m[2][0] -
-				m.m[0][1] * m.m[1][0] * m.m[2][2] - m.m[0][0] * m.m[1][2] * m.m[2][1]);
+		// 2x2のブロック A B / C D に分けて余因子を求める
+		__m128 row0 = LoadRow(m, 0);
+		__m128 row1 = LoadRow(m, 1);
+		__m128 row2 = LoadRow(m, 2);
+		__m128 row3 = LoadRow(m, 3);
+
+		__m128 a = _mm_movelh_ps(row0, row1);
+		__m128 b = _mm_movehl_ps(row1, row0);
+		__m128 c = _mm_movelh_ps(row2, row3);
+		__m128 d = _mm_movehl_ps(row3, row2);
+
+		// 各ブロックの行列式 [|A| |B| |C| |D|]
+		__m128 detSub = _mm_sub_ps(
+			_mm_mul_ps(Shuffle<0, 2, 0, 2>(row0, row2), Shuffle<1, 3, 1, 3>(row1, row3)),
+			_mm_mul_ps(Shuffle<1, 3, 1, 3>(row0, row2), Shuffle<0, 2, 0, 2>(row1, row3)));
+		__m128 detA = Swizzle<0, 0, 0, 0>(detSub);
+		__m128 detB = Swizzle<1, 1, 1, 1>(detSub);
+		__m128 detC = Swizzle<2, 2, 2, 2>(detSub);
+		__m128 detD = Swizzle<3, 3, 3, 3>(detSub);
+
+		__m128 dc = Mat2AdjMul(d, c);
+		__m128 ab = Mat2AdjMul(a, b);
+		__m128 x = _mm_sub_ps(_mm_mul_ps(detD, a), Mat2Mul(b, dc));
+		__m128 w = _mm_sub_ps(_mm_mul_ps(detA, d), Mat2Mul(c, ab));
+		__m128 y = _mm_sub_ps(_mm_mul_ps(detB, c), Mat2MulAdj(d, ab));
+		__m128 z = _mm_sub_ps(_mm_mul_ps(detC, b), Mat2MulAdj(a, dc));
+
+		// |M| = |A||D| + |B||C| - tr(adj(A)B adj(D)C)
+		__m128 trace = _mm_mul_ps(ab, Swizzle<0, 2, 1, 3>(dc));
+		trace = _mm_add_ps(trace, Swizzle<1, 0, 3, 2>(trace));
+		trace = _mm_add_ps(trace, Swizzle<2, 3, 0, 1>(trace));
+		__m128 determinant = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(detA, detD), _mm_mul_ps(detB, detC)), trace);
+		assert(_mm_cvtss_f32(determinant) != 0.0f);
+
+		__m128 determinantRecp = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), determinant);
+		x = _mm_mul_ps(x, determinantRecp);
+		y = _mm_mul_ps(y, determinantRecp);
+		z = _mm_mul_ps(z, determinantRecp);
+		w = _mm_mul_ps(w, determinantRecp);
+
+		StoreRow(result, 0, Shuffle<3, 1, 3, 1>(x, y));
+		StoreRow(result, 1, Shuffle<2, 0, 2, 0>(x, y));
+		StoreRow(result, 2, Shuffle<3, 1, 3, 1>(z, w));
+		StoreRow(result, 3, Shuffle<2, 0, 2, 0>(z, w));
 
 		return result;
+#else
+		return scalar::Inverse(m);
+#endif
 	}
 
 	Matrix4x4 MakePerspectiveFovMatrix(float fovY, float aspectRatio, float nearClip, float farClip)
@@ -385,17 +354,33 @@ namespace math {
 
 	Vector3 ApplyTransform(const Vector3 &vector, const Matrix4x4 &matrix)
 	{
+#if MATH_USE_SSE
 		Vector3 result {};
-		result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
-		result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
-		result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
-		float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
-		assert(w != 0.0f);
-		result.x /= w;
-		result.y /= w;
-		result.z /= w;
-
+		// x*row0 + y*row1 + z*row2 + row3 を1回で求めてwで割る
+		__m128 sum = _mm_mul_ps(_mm_set1_ps(vector.x), LoadRow(matrix, 0));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vector.y), LoadRow(matrix, 1)));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(vector.z), LoadRow(matrix, 2)));
+		sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(1.0f), LoadRow(matrix, 3)));
+		__m128 w = Swizzle<3, 3, 3, 3>(sum);
+		assert(_mm_cvtss_f32(w) != 0.0f);
+		alignas(16) float values[4];
+		_mm_store_ps(values, _mm_div_ps(sum, w));
+		result.x = values[0];
+		result.y = values[1];
+		result.z = values[2];
 		return result;
+#else
+		return scalar::ApplyTransform(vector, matrix);
+#endif
+	}
+
+	Vector3 TransformNormal(const Vector3 &vector, const Matrix4x4 &matrix)
+	{
+		return {
+			vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0],
+			vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1],
+			vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2],
+		};
 	}
 
 	Vector3 Normalize(const Vector3 &v) {
@@ -413,4 +398,193 @@ namespace math {
 		lhs.y += rhs.y;
 		return lhs;
 	}
+
+	// ===== スカラー版（SIMD版の検証用。SIMDを使わない環境では上の関数がこれを呼ぶ） =====
+	namespace scalar {
+
+		Matrix4x4 Multiply(const Matrix4x4 &m1, const Matrix4x4 &m2)
+		{
+			Matrix4x4 result {};
+
+			for (int row = 0; row < 4; ++row) {
+				for (int col = 0; col < 4; ++col) {
+					result.m[row][col] = 0.0f;
+					for (int k = 0; k < 4; ++k) {
+						result.m[row][col] += m1.m[row][k] * m2.m[k][col];
+					}
+				}
+			}
+
+			return result;
+		}
+
+		Matrix4x4 MakeAffineMatrix(const Vector3 &scale, const Vector3 &rotate, const Vector3 &translate)
+		{
+			// S * (Rx * Ry * Rz) * T を行列の積で求める（引数の型からmath::Multiplyも候補になるので名前空間を付ける）
+			Matrix4x4 rotateXYZMatrix =
+				scalar::Multiply(MakeRotateXMatrix(rotate.x), scalar::Multiply(MakeRotateYMatrix(rotate.y), MakeRotateZMatrix(rotate.z)));
+			return scalar::Multiply(scalar::Multiply(MakeScaleMatrix(scale), rotateXYZMatrix), MakeTranslateMatrix(translate));
+		}
+
+		Matrix4x4 Inverse(const Matrix4x4 &m)
+		{
+			Matrix4x4 result {};
+
+			float determinant = (m.m[0][0] * m.m[1][1] * m.m[2][2] * m.m[3][3]) +
+				(m.m[0][0] * m.m[1][2] * m.m[2][3] * m.m[3][1]) +
+				(m.m[0][0] * m.m[1][3] * m.m[2][1] * m.m[3][2]) -
+
+				(m.m[0][0] * m.m[1][3] * m.m[2][2] * m.m[3][1]) -
+				(m.m[0][0] * m.m[1][2] * m.m[2][1] * m.m[3][3]) -
+				(m.m[0][0] * m.m[1][1] * m.m[2][3] * m.m[3][2]) -
+
+				(m.m[0][1] * m.m[1][0] * m.m[2][2] * m.m[3][3]) -
+				(m.m[0][2] * m.m[1][0] * m.m[2][3] * m.m[3][1]) -
+				(m.m[0][3] * m.m[1][0] * m.m[2][1] * m.m[3][2]) +
+
+				(m.m[0][3] * m.m[1][0] * m.m[2][2] * m.m[3][1]) +
+				(m.m[0][2] * m.m[1][0] * m.m[2][1] * m.m[3][3]) +
+				(m.m[0][1] * m.m[1][0] * m.m[2][3] * m.m[3][2]) +
+
+				(m.m[0][1] * m.m[1][2] * m.m[2][0] * m.m[3][3]) +
+				(m.m[0][2] * m.m[1][3] * m.m[2][0] * m.m[3][1]) +
+				(m.m[0][3] * m.m[1][1] * m.m[2][0] * m.m[3][2]) -
+
+				(m.m[0][3] * m.m[1][2] * m.m[2][0] * m.m[3][1]) -
+				(m.m[0][2] * m.m[1][1] * m.m[2][0] * m.m[3][3]) -
+				(m.m[0][1] * m.m[1][3] * m.m[2][0] * m.m[3][2]) -
+
+				(m.m[0][1] * m.m[1][2] * m.m[2][3] * m.m[3][0]) -
+				(m.m[0][2] * m.m[1][3] * m.m[2][1] * m.m[3][0]) -
+				(m.m[0][3] * m.m[1][1] * m.m[2][2] * m.m[3][0]) +
+
+				(m.m[0][3] * m.m[1][2] * m.m[2][1] * m.m[3][0]) +
+				(m.m[0][2] * m.m[1][1] * m.m[2][3] * m.m[3][0]) +
+				(m.m[0][1] * m.m[1][3] * m.m[2][2] * m.m[3][0]);
+
+			assert(determinant != 0);
+			float determinantRecp = 1.0f / determinant;
+
+			result.m[0][0] =
+				determinantRecp *
+				(m.m[1][1] * m.m[2][2] * m.m[3][3] + m.m[1][2] * m.m[2][3] * m.m[3][1] +
+					m.m[1][3] * m.m[2][1] * m.m[3][2] - m.m[1][3] * m.m[2][2] * m.m[3][1] -
+					m.m[1][2] * m.m[2][1] * m.m[3][3] - m.m[1][1] * m.m[2][3] * m.m[3][2]);
+
+			result.m[0][1] =
+				determinantRecp *
+				(-(m.m[0][1] * m.m[2][2] * m.m[3][3]) -
+					m.m[0][2] * m.m[2][3] * m.m[3][1] - m.m[0][3] * m.m[2][1] * m.m[3][2] +
+					m.m[0][3] * m.m[2][2] * m.m[3][1] + m.m[0][2] * m.m[2][1] * m.m[3][3] +
+					m.m[0][1] * m.m[2][3] * m.m[3][2]);
+
+			result.m[0][2] =
+				determinantRecp *
+				(m.m[0][1] * m.m[1][2] * m.m[3][3] + m.m[0][2] * m.m[1][3] * m.m[3][1] +
+					m.m[0][3] * m.m[1][1] * m.m[3][2] - m.m[0][3] * m.m[1][2] * m.m[3][1] -
+					m.m[0][2] * m.m[1][1] * m.m[3][3] - m.m[0][1] * m.m[1][3] * m.m[3][2]);
+
+			result.m[0][3] =
+				determinantRecp *
+				(-(m.m[0][1] * m.m[1][2] * m.m[2][3]) -
+					m.m[0][2] * m.m[1][3] * m.m[2][1] - m.m[0][3] * m.m[1][1] * m.m[2][2] +
+					m.m[0][3] * m.m[1][2] * m.m[2][1] + m.m[0][2] * m.m[1][1] * m.m[2][3] +
+					m.m[0][1] * m.m[1][3] * m.m[2][2]);
+
+			result.m[1][0] =
+				determinantRecp *
+				(-(m.m[1][0] * m.m[2][2] * m.m[3][3]) -
+					m.m[1][2] * m.m[2][3] * m.m[3][0] - m.m[1][3] * m.m[2][0] * m.m[3][2] +
+					m.m[1][3] * m.m[2][2] * m.m[3][0] + m.m[1][2] * m.m[2][0] * m.m[3][3] +
+					m.m[1][0] * m.m[2][3] * m.m[3][2]);
+
+			result.m[1][1] =
+				determinantRecp *
+				(m.m[0][0] * m.m[2][2] * m.m[3][3] + m.m[0][2] * m.m[2][3] * m.m[3][0] +
+					m.m[0][3] * m.m[2][0] * m.m[3][2] - m.m[0][3] * m.m[2][2] * m.m[3][0] -
+					m.m[0][2] * m.m[2][0] * m.m[3][3] - m.m[0][0] * m.m[2][3] * m.m[3][2]);
+
+			result.m[1][2] =
+				determinantRecp *
+				(-(m.m[0][0] * m.m[1][2] * m.m[3][3]) -
+					m.m[0][2] * m.m[1][3] * m.m[3][0] - m.m[0][3] * m.m[1][0] * m.m[3][2] +
+					m.m[0][3] * m.m[1][2] * m.m[3][0] + m.m[0][2] * m.m[1][0] * m.m[3][3] +
+					m.m[0][0] * m.m[1][3] * m.m[3][2]);
+
+			result.m[1][3] =
+				determinantRecp *
+				(m.m[0][0] * m.m[1][2] * m.m[2][3] + m.m[0][2] * m.m[1][3] * m.m[2][0] +
+					m.m[0][3] * m.m[1][0] * m.m[2][2] - m.m[0][3] * m.m[1][2] * m.m[2][0] -
+					m.m[0][2] * m.m[1][0] * m.m[2][3] - m.m[0][0] * m.m[1][3] * m.m[2][2]);
+
+			result.m[2][0] =
+				determinantRecp *
+				(m.m[1][0] * m.m[2][1] * m.m[3][3] + m.m[1][1] * m.m[2][3] * m.m[3][0] +
+					m.m[1][3] * m.m[2][0] * m.m[3][1] - m.m[1][3] * m.m[2][1] * m.m[3][0] -
+					m.m[1][1] * m.m[2][0] * m.m[3][3] - m.m[1][0] * m.m[2][3] * m.m[3][1]);
+
+			result.m[2][1] =
+				determinantRecp *
+				(-(m.m[0][0] * m.m[2][1] * m.m[3][3]) -
+					m.m[0][1] * m.m[2][3] * m.m[3][0] - m.m[0][3] * m.m[2][0] * m.m[3][1] +
+					m.m[0][3] * m.m[2][1] * m.m[3][0] + m.m[0][1] * m.m[2][0] * m.m[3][3] +
+					m.m[0][0] * m.m[2][3] * m.m[3][1]);
+
+			result.m[2][2] =
+				determinantRecp *
+				(m.m[0][0] * m.m[1][1] * m.m[3][3] + m.m[0][1] * m.m[1][3] * m.m[3][0] +
+					m.m[0][3] * m.m[1][0] * m.m[3][1] - m.m[0][3] * m.m[1][1] * m.m[3][0] -
+					m.m[0][1] * m.m[1][0] * m.m[3][3] - m.m[0][0] * m.m[1][3] * m.m[3][1]);
+
+			result.m[2][3] =
+				determinantRecp *
+				(-(m.m[0][0] * m.m[1][1] * m.m[2][3]) -
+					m.m[0][1] * m.m[1][3] * m.m[2][0] - m.m[0][3] * m.m[1][0] * m.m[2][1] +
+					m.m[0][3] * m.m[1][1] * m.m[2][0] + m.m[0][1] * m.m[1][0] * m.m[2][3] +
+					m.m[0][0] * m.m[1][3] * m.m[2][1]);
+
+			result.m[3][0] =
+				determinantRecp *
+				(-(m.m[1][0] * m.m[2][1] * m.m[3][2]) -
+					m.m[1][1] * m.m[2][2] * m.m[3][0] - m.m[1][2] * m.m[2][0] * m.m[3][1] +
+					m.m[1][2] * m.m[2][1] * m.m[3][0] + m.m[1][1] * m.m[2][0] * m.m[3][2] +
+					m.m[1][0] * m.m[2][2] * m.m[3][1]);
+
+			result.m[3][1] =
+				determinantRecp *
+				(m.m[0][0] * m.m[2][1] * m.m[3][2] + m.m[0][1] * m.m[2][2] * m.m[3][0] +
+					m.m[0][2] * m.m[2][0] * m.m[3][1] - m.m[0][2] * m.m[2][1] * m.m[3][0] -
+					m.m[0][1] * m.m[2][0] * m.m[3][2] - m.m[0][0] * m.m[2][2] * m.m[3][1]);
+
+			result.m[3][2] =
+				determinantRecp *
+				(-(m.m[0][0] * m.m[1][1] * m.m[3][2]) -
+					m.m[0][1] * m.m[1][2] * m.m[3][0] - m.m[0][2] * m.m[1][0] * m.m[3][1] +
+					m.m[0][2] * m.m[1][1] * m.m[3][0] + m.m[0][1] * m.m[1][0] * m.m[3][2] +
+					m.m[0][0] * m.m[1][2] * m.m[3][1]);
+
+			result.m[3][3] =
+				determinantRecp *
+				(m.m[0][0] * m.m[1][1] * m.m[2][2] + m.m[0][1] * m.m[1][2] * m.m[2][0] +
+					m.m[0][2] * m.m[1][0] * m.m[2][1] - m.m[0][2] * m.m[1][1] * m.m[2][0] -
+					m.m[0][1] * m.m[1][0] * m.m[2][2] - m.m[0][0] * m.m[1][2] * m.m[2][1]);
+
+			return result;
+		}
+
+		Vector3 ApplyTransform(const Vector3 &vector, const Matrix4x4 &matrix)
+		{
+			Vector3 result {};
+			result.x = vector.x * matrix.m[0][0] + vector.y * matrix.m[1][0] + vector.z * matrix.m[2][0] + 1.0f * matrix.m[3][0];
+			result.y = vector.x * matrix.m[0][1] + vector.y * matrix.m[1][1] + vector.z * matrix.m[2][1] + 1.0f * matrix.m[3][1];
+			result.z = vector.x * matrix.m[0][2] + vector.y * matrix.m[1][2] + vector.z * matrix.m[2][2] + 1.0f * matrix.m[3][2];
+			float w = vector.x * matrix.m[0][3] + vector.y * matrix.m[1][3] + vector.z * matrix.m[2][3] + 1.0f * matrix.m[3][3];
+			assert(w != 0.0f);
+			result.x /= w;
+			result.y /= w;
+			result.z /= w;
+
+			return result;
+		}
+	}
 }
\ No newline at end of file
@@ -1,6 +1,17 @@
 #pragma once
 #include "MathTypes.h"
 
+// SSE2が使える環境ではMultiply・Inverse・ApplyTransformをSIMDで計算する（MATH_DISABLE_SIMDを定義するとスカラー版）
+// スカラー版との差
+//   Multiply・ApplyTransform : 演算順が同じなので一致する
+//   Inverse : 2x2ブロックの余因子で求めるため、最大要素に対して相対1e-5以内でずれる（条件数が大きい行列ではさらに大きくなる）
+// MakeAffineMatrixは行列を掛け合わせず直接組み立てるので、掛け合わせた場合と相対1e-6以内でずれる
+#if !defined(MATH_DISABLE_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+#define MATH_USE_SSE 1
+#else
+#define MATH_USE_SSE 0
+#endif
+
 namespace math
 {
     // 単位行列
@@ -39,10 +50,29 @@ namespace math
     // 座標変換
     Vector3 ApplyTransform(const Vector3 &vector, const Matrix4x4 &matrix);
 
+    // 方向ベクトルの変換（平行移動しない）
+    Vector3 TransformNormal(const Vector3 &vector, const Matrix4x4 &matrix);
+
     // 正規化
     Vector3 Normalize(const Vector3 &v);
 
     // 行列の掛け算演算子
     Matrix4x4 operator*(const Matrix4x4 &m1, const Matrix4x4 &m2);
     Vector2 &operator+=(Vector2 &lhs, const Vector2 &rhs);
+
+    // スカラー版（SIMD版の結果を確かめるテスト用。MATH_USE_SSEが0のときは上の関数もこれを使う）
+    namespace scalar
+    {
+        // 行列の掛け算
+        Matrix4x4 Multiply(const Matrix4x4 &m1, const Matrix4x4 &m2);
+
+        // 3次元アフィン変換行列（拡大縮小・回転・平行移動の行列を掛け合わせて求める）
+        Matrix4x4 MakeAffineMatrix(const Vector3 &scale, const Vector3 &rotate, const Vector3 &translate);
+
+        // 逆行列（余因子展開）
+        Matrix4x4 Inverse(const Matrix4x4 &m);
+
+        // 座標変換
+        Vector3 ApplyTransform(const Vector3 &vector, const Matrix4x4 &matrix);
+    }
 }
\ No newline at end of file
@@ -28,7 +28,9 @@ namespace math
         float m[3][3];
     };
 
-    struct Matrix4x4
+    // SIMDで行単位に読み書きできるよう16byte境界に置く
+    // （定数バッファ内でも16byte単位に配置されるので、GPU側のレイアウトは変わらない）
+    struct alignas(16) Matrix4x4
     {
         float m[4][4];
     };
@@ -39,4 +41,38 @@ namespace math
         Vector3 rotate;
         Vector3 translate;
     };
+
+    // 軸に平行な境界ボックス
+    struct AABB
+    {
+        Vector3 min;
+        Vector3 max;
+    };
+
+    // 境界球
+    struct Sphere
+    {
+        Vector3 center;
+        float radius;
+    };
+
+    // 平面（dot(normal, p) + distance >= 0 が表側）
+    struct Plane
+    {
+        Vector3 normal;
+        float distance;
+    };
+
+    // 視錐台（6枚の平面の内側が見える範囲。法線は内向き）
+    struct Frustum
+    {
+        Plane planes[6]; // 左・右・下・上・ニア・ファー
+    };
+
+    // 半直線（origin + direction * t, t >= 0）
+    struct Ray
+    {
+        Vector3 origin;
+        Vector3 direction;
+    };
 }
\ No newline at end of file
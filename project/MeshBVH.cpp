@@ -0,0 +1,433 @@
+#include "MeshBVH.h"
+#include "MathFunctions.h"
+#include "BoundingVolume.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#if MATH_USE_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace math;
+
+namespace {
+
+	// SAHで分け方を探すときのビンの数
+	constexpr int kBinCount = 16;
+	// この深さより下はSAHではなく中央で分ける（探索のスタックが溢れない深さに収める）
+	constexpr uint32_t kMaxSAHDepth = 40;
+	// 探索のスタックの大きさ（kMaxSAHDepth + 中央で分けた段数より大きくする）
+	constexpr int kStackSize = 96;
+	// SAHのコスト（ノード1つをたどるコストと、三角形ブロック1つ(4つ)を判定するコスト）
+	constexpr float kTraversalCost = 1.0f;
+	constexpr float kBlockCost = 1.0f;
+	// これより行列式が小さい三角形は、レイと平行か面積0とみなして当てない
+	constexpr float kDeterminantEpsilon = 1e-12f;
+
+	inline float GetAxis(const Vector3 &v, int axis) { return (&v.x)[axis]; }
+
+	// 三角形の数を判定するブロックの数にする
+	inline uint32_t GetBlockCount(size_t triangleCount) { return uint32_t((triangleCount + 3) / 4); }
+
+	// ノードの箱とレイの交差判定（入る距離を返す）
+	inline bool IntersectNode(const float *minimum, const float *maximum, const Ray &ray, const Vector3 &inverseDirection, float maxDistance, float &distance)
+	{
+		AABB aabb = { { minimum[0], minimum[1], minimum[2] }, { maximum[0], maximum[1], maximum[2] } };
+		return IntersectRay(ray, inverseDirection, aabb, maxDistance, distance);
+	}
+}
+
+void MeshBVH::Build(const std::vector<Vector3> &positions, const std::vector<uint32_t> &indices)
+{
+	Clear();
+	triangleCount = indices.size() / 3;
+	if (triangleCount == 0) {
+		return;
+	}
+
+	// 三角形ごとの箱と中心
+	struct BuildTriangle
+	{
+		AABB aabb;
+		Vector3 centroid;
+	};
+	std::vector<BuildTriangle> triangles(triangleCount);
+	std::vector<uint32_t> order(triangleCount);
+	for (uint32_t i = 0; i < triangleCount; ++i) {
+		assert(indices[i * 3] < positions.size() && indices[i * 3 + 1] < positions.size() && indices[i * 3 + 2] < positions.size());
+		AABB aabb = MakeEmptyAABB();
+		Expand(aabb, positions[indices[i * 3]]);
+		Expand(aabb, positions[indices[i * 3 + 1]]);
+		Expand(aabb, positions[indices[i * 3 + 2]]);
+		triangles[i] = { aabb, GetCenter(aabb) };
+		order[i] = i;
+	}
+
+	// 葉を三角形ブロックにする
+	auto makeLeaf = [&](Node &node, size_t begin, size_t end) {
+		node.leftFirst = uint32_t(blocks.size());
+		node.count = uint32_t(end - begin);
+		for (size_t first = begin; first < end; first += 4) {
+			TriangleBlock block {};
+			for (size_t lane = 0; lane < 4; ++lane) {
+				if (first + lane >= end) {
+					block.triangle[lane] = UINT32_MAX;
+					continue;
+				}
+				uint32_t triangle = order[first + lane];
+				const Vector3 &p0 = positions[indices[triangle * 3]];
+				const Vector3 &p1 = positions[indices[triangle * 3 + 1]];
+				const Vector3 &p2 = positions[indices[triangle * 3 + 2]];
+				for (int axis = 0; axis < 3; ++axis) {
+					block.vertex0[axis][lane] = GetAxis(p0, axis);
+					block.edge1[axis][lane] = GetAxis(p1, axis) - GetAxis(p0, axis);
+					block.edge2[axis][lane] = GetAxis(p2, axis) - GetAxis(p0, axis);
+				}
+				block.triangle[lane] = triangle;
+			}
+			blocks.push_back(block);
+		}
+		};
+
+	// 葉に三角形が1つ以上あれば、ノードは最大で 2 * 三角形数 - 1 個（先に確保して参照が無効にならないようにする）
+	nodes.reserve(triangleCount * 2 - 1);
+	blocks.reserve(GetBlockCount(triangleCount));
+	nodes.emplace_back();
+
+	struct Task
+	{
+		uint32_t node;
+		size_t begin;
+		size_t end;
+		uint32_t depth;
+	};
+	std::vector<Task> tasks;
+	tasks.push_back({ 0, 0, triangleCount, 0 });
+	while (!tasks.empty()) {
+		Task task = tasks.back();
+		tasks.pop_back();
+		const size_t count = task.end - task.begin;
+
+		// 範囲の箱と、中心の範囲
+		AABB bounds = MakeEmptyAABB();
+		AABB centroidBounds = MakeEmptyAABB();
+		for (size_t i = task.begin; i < task.end; ++i) {
+			bounds = Union(bounds, triangles[order[i]].aabb);
+			Expand(centroidBounds, triangles[order[i]].centroid);
+		}
+		Node &node = nodes[task.node];
+		node.min[0] = bounds.min.x; node.min[1] = bounds.min.y; node.min[2] = bounds.min.z;
+		node.max[0] = bounds.max.x; node.max[1] = bounds.max.y; node.max[2] = bounds.max.z;
+
+		// ブロック1つに収まるならそれ以上分けない
+		if (count <= 4) {
+			makeLeaf(node, task.begin, task.end);
+			continue;
+		}
+
+		// 中心を3軸それぞれビンに分け、SAHのコストが最小の分け目を探す
+		int bestAxis = -1;
+		int bestSplit = 0;
+		float bestCost = FLT_MAX;
+		const int binCount = int(std::min<size_t>(kBinCount, count));
+		float minimums[3];
+		float scales[3];
+		if (task.depth < kMaxSAHDepth) {
+			struct Bin
+			{
+				AABB aabb;
+				size_t count;
+			};
+			Bin bins[3][kBinCount];
+			for (int axis = 0; axis < 3; ++axis) {
+				minimums[axis] = GetAxis(centroidBounds.min, axis);
+				float extent = GetAxis(centroidBounds.max, axis) - minimums[axis];
+				scales[axis] = extent > 0.0f ? binCount / extent : 0.0f;
+				for (int bin = 0; bin < binCount; ++bin) {
+					bins[axis][bin] = { MakeEmptyAABB(), 0 };
+				}
+			}
+			for (size_t i = task.begin; i < task.end; ++i) {
+				const BuildTriangle &triangle = triangles[order[i]];
+				for (int axis = 0; axis < 3; ++axis) {
+					int bin = std::min(int((GetAxis(triangle.centroid, axis) - minimums[axis]) * scales[axis]), binCount - 1);
+					bins[axis][bin].aabb = Union(bins[axis][bin].aabb, triangle.aabb);
+					++bins[axis][bin].count;
+				}
+			}
+
+			for (int axis = 0; axis < 3; ++axis) {
+				if (scales[axis] <= 0.0f) {
+					continue;
+				}
+
+				// 右側（bin番目から後ろ）の表面積と数
+				float rightAreas[kBinCount] = {};
+				size_t rightCounts[kBinCount] = {};
+				AABB right = MakeEmptyAABB();
+				size_t rightCount = 0;
+				for (int bin = binCount - 1; bin > 0; --bin) {
+					right = Union(right, bins[axis][bin].aabb);
+					rightCount += bins[axis][bin].count;
+					rightAreas[bin] = rightCount ? GetSurfaceArea(right) : 0.0f;
+					rightCounts[bin] = rightCount;
+				}
+
+				AABB left = MakeEmptyAABB();
+				size_t leftCount = 0;
+				for (int bin = 0; bin < binCount - 1; ++bin) {
+					left = Union(left, bins[axis][bin].aabb);
+					leftCount += bins[axis][bin].count;
+					if (leftCount == 0 || rightCounts[bin + 1] == 0) {
+						continue;
+					}
+					float cost = GetSurfaceArea(left) * GetBlockCount(leftCount) + rightAreas[bin + 1] * GetBlockCount(rightCounts[bin + 1]);
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = bin;
+					}
+				}
+			}
+
+			// 分けても速くならず、葉に収まるなら葉にする
+			float area = GetSurfaceArea(bounds);
+			float leafCost = kBlockCost * GetBlockCount(count);
+			float splitCost = area > 0.0f ? kTraversalCost + kBlockCost * bestCost / area : FLT_MAX;
+			if (count <= kMaxLeafTriangles && (bestAxis < 0 || splitCost >= leafCost)) {
+				makeLeaf(node, task.begin, task.end);
+				continue;
+			}
+		}
+
+		size_t middle = task.begin;
+		if (bestAxis >= 0) {
+			float minimum = minimums[bestAxis];
+			float scale = scales[bestAxis];
+			auto it = std::partition(order.begin() + task.begin, order.begin() + task.end, [&](uint32_t triangle) {
+				return std::min(int((GetAxis(triangles[triangle].centroid, bestAxis) - minimum) * scale), binCount - 1) <= bestSplit;
+				});
+			middle = size_t(it - order.begin());
+		}
+		if (middle == task.begin || middle == task.end) {
+			// 深すぎる、または中心がすべて同じ位置で分けられないときは、中心の範囲が最も広い軸の中央で半分ずつにする
+			int axis = 0;
+			Vector3 extent = { centroidBounds.max.x - centroidBounds.min.x, centroidBounds.max.y - centroidBounds.min.y, centroidBounds.max.z - centroidBounds.min.z };
+			if (extent.y > GetAxis(extent, axis)) { axis = 1; }
+			if (extent.z > GetAxis(extent, axis)) { axis = 2; }
+			middle = task.begin + count / 2;
+			std::nth_element(order.begin() + task.begin, order.begin() + middle, order.begin() + task.end, [&](uint32_t a, uint32_t b) {
+				return GetAxis(triangles[a].centroid, axis) < GetAxis(triangles[b].centroid, axis);
+				});
+		}
+
+		// 子は隣り合わせに置く
+		uint32_t leftChild = uint32_t(nodes.size());
+		nodes.emplace_back();
+		nodes.emplace_back();
+		nodes[task.node].leftFirst = leftChild;
+		nodes[task.node].count = 0;
+		tasks.push_back({ leftChild + 1, middle, task.end, task.depth + 1 });
+		tasks.push_back({ leftChild, task.begin, middle, task.depth + 1 });
+	}
+}
+
+void MeshBVH::Clear()
+{
+	nodes.clear();
+	blocks.clear();
+	triangleCount = 0;
+}
+
+bool MeshBVH::RayCast(const Ray &ray, float maxDistance, Hit &hit) const
+{
+	return Traverse(ray, maxDistance, hit, false);
+}
+
+bool MeshBVH::AnyHit(const Ray &ray, float maxDistance) const
+{
+	Hit hit;
+	return Traverse(ray, maxDistance, hit, true);
+}
+
+bool MeshBVH::Traverse(const Ray &ray, float maxDistance, Hit &hit, bool anyHit) const
+{
+	if (nodes.empty()) {
+		return false;
+	}
+
+	Vector3 inverseDirection = MakeInverseDirection(ray.direction);
+	float rootDistance = 0.0f;
+	if (!IntersectNode(nodes[0].min, nodes[0].max, ray, inverseDirection, maxDistance, rootDistance)) {
+		return false;
+	}
+
+#if MATH_USE_SSE
+	// レイを4レーンに広げておく
+	const __m128 originX = _mm_set1_ps(ray.origin.x);
+	const __m128 originY = _mm_set1_ps(ray.origin.y);
+	const __m128 originZ = _mm_set1_ps(ray.origin.z);
+	const __m128 directionX = _mm_set1_ps(ray.direction.x);
+	const __m128 directionY = _mm_set1_ps(ray.direction.y);
+	const __m128 directionZ = _mm_set1_ps(ray.direction.z);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 epsilon = _mm_set1_ps(kDeterminantEpsilon);
+	const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+#endif
+
+	float closest = maxDistance;
+	bool found = false;
+
+	// 三角形ブロックを判定し、closestより近い当たりがあれば更新する
+	auto testBlock = [&](const TriangleBlock &block) {
+		alignas(16) float distances[4];
+		alignas(16) float us[4];
+		alignas(16) float vs[4];
+		int mask = 0;
+#if MATH_USE_SSE
+		__m128 edge1X = _mm_load_ps(block.edge1[0]);
+		__m128 edge1Y = _mm_load_ps(block.edge1[1]);
+		__m128 edge1Z = _mm_load_ps(block.edge1[2]);
+		__m128 edge2X = _mm_load_ps(block.edge2[0]);
+		__m128 edge2Y = _mm_load_ps(block.edge2[1]);
+		__m128 edge2Z = _mm_load_ps(block.edge2[2]);
+
+		// p = direction × edge2, det = edge1・p
+		__m128 pX = _mm_sub_ps(_mm_mul_ps(directionY, edge2Z), _mm_mul_ps(directionZ, edge2Y));
+		__m128 pY = _mm_sub_ps(_mm_mul_ps(directionZ, edge2X), _mm_mul_ps(directionX, edge2Z));
+		__m128 pZ = _mm_sub_ps(_mm_mul_ps(directionX, edge2Y), _mm_mul_ps(directionY, edge2X));
+		__m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge1X, pX), _mm_mul_ps(edge1Y, pY)), _mm_mul_ps(edge1Z, pZ));
+		__m128 inverseDet = _mm_div_ps(one, det);
+
+		// u = (origin - vertex0)・p / det
+		__m128 tX = _mm_sub_ps(originX, _mm_load_ps(block.vertex0[0]));
+		__m128 tY = _mm_sub_ps(originY, _mm_load_ps(block.vertex0[1]));
+		__m128 tZ = _mm_sub_ps(originZ, _mm_load_ps(block.vertex0[2]));
+		__m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(tX, pX), _mm_mul_ps(tY, pY)), _mm_mul_ps(tZ, pZ)), inverseDet);
+
+		// q = (origin - vertex0) × edge1, v = direction・q / det, 距離 = edge2・q / det
+		__m128 qX = _mm_sub_ps(_mm_mul_ps(tY, edge1Z), _mm_mul_ps(tZ, edge1Y));
+		__m128 qY = _mm_sub_ps(_mm_mul_ps(tZ, edge1X), _mm_mul_ps(tX, edge1Z));
+		__m128 qZ = _mm_sub_ps(_mm_mul_ps(tX, edge1Y), _mm_mul_ps(tY, edge1X));
+		__m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(directionX, qX), _mm_mul_ps(directionY, qY)), _mm_mul_ps(directionZ, qZ)), inverseDet);
+		__m128 distance = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(edge2X, qX), _mm_mul_ps(edge2Y, qY)), _mm_mul_ps(edge2Z, qZ)), inverseDet);
+
+		__m128 valid = _mm_cmpgt_ps(_mm_and_ps(det, absMask), epsilon);
+		valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+		valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+		valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+		valid = _mm_and_ps(valid, _mm_cmpge_ps(distance, zero));
+		valid = _mm_and_ps(valid, _mm_cmple_ps(distance, _mm_set1_ps(closest)));
+		mask = _mm_movemask_ps(valid);
+		if (mask == 0) {
+			return;
+		}
+		_mm_store_ps(distances, distance);
+		_mm_store_ps(us, u);
+		_mm_store_ps(vs, v);
+#else
+		// SSE版と同じ順で計算する
+		const Vector3 &origin = ray.origin;
+		const Vector3 &direction = ray.direction;
+		for (int lane = 0; lane < 4; ++lane) {
+			float edge1X = block.edge1[0][lane], edge1Y = block.edge1[1][lane], edge1Z = block.edge1[2][lane];
+			float edge2X = block.edge2[0][lane], edge2Y = block.edge2[1][lane], edge2Z = block.edge2[2][lane];
+			float pX = direction.y * edge2Z - direction.z * edge2Y;
+			float pY = direction.z * edge2X - direction.x * edge2Z;
+			float pZ = direction.x * edge2Y - direction.y * edge2X;
+			float det = edge1X * pX + edge1Y * pY + edge1Z * pZ;
+			float inverseDet = 1.0f / det;
+			float tX = origin.x - block.vertex0[0][lane];
+			float tY = origin.y - block.vertex0[1][lane];
+			float tZ = origin.z - block.vertex0[2][lane];
+			float u = (tX * pX + tY * pY + tZ * pZ) * inverseDet;
+			float qX = tY * edge1Z - tZ * edge1Y;
+			float qY = tZ * edge1X - tX * edge1Z;
+			float qZ = tX * edge1Y - tY * edge1X;
+			float v = (direction.x * qX + direction.y * qY + direction.z * qZ) * inverseDet;
+			float distance = (edge2X * qX + edge2Y * qY + edge2Z * qZ) * inverseDet;
+			if (std::fabs(det) > kDeterminantEpsilon && u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance >= 0.0f && distance <= closest) {
+				mask |= 1 << lane;
+			}
+			distances[lane] = distance;
+			us[lane] = u;
+			vs[lane] = v;
+		}
+		if (mask == 0) {
+			return;
+		}
+#endif
+		for (int lane = 0; lane < 4; ++lane) {
+			if ((mask & (1 << lane)) && distances[lane] <= closest) {
+				closest = distances[lane];
+				hit = { distances[lane], block.triangle[lane], us[lane], vs[lane] };
+				found = true;
+			}
+		}
+		};
+
+	// 近い子から調べ、遠い子は入る距離と一緒に積む（見つかった当たりより遠ければ開かない）
+	struct StackEntry
+	{
+		uint32_t node;
+		float distance;
+	};
+	StackEntry stack[kStackSize];
+	int stackSize = 0;
+	uint32_t index = 0;
+	while (true) {
+		const Node &node = nodes[index];
+		if (node.IsLeaf()) {
+			uint32_t blockEnd = node.leftFirst + GetBlockCount(node.count);
+			for (uint32_t block = node.leftFirst; block < blockEnd; ++block) {
+				testBlock(blocks[block]);
+				if (anyHit && found) {
+					return true;
+				}
+			}
+		} else {
+			uint32_t leftChild = node.leftFirst;
+			uint32_t rightChild = node.leftFirst + 1;
+			float leftDistance = 0.0f;
+			float rightDistance = 0.0f;
+			bool leftHit = IntersectNode(nodes[leftChild].min, nodes[leftChild].max, ray, inverseDirection, closest, leftDistance);
+			bool rightHit = IntersectNode(nodes[rightChild].min, nodes[rightChild].max, ray, inverseDirection, closest, rightDistance);
+			if (leftHit && rightHit) {
+				if (rightDistance < leftDistance) {
+					std::swap(leftChild, rightChild);
+					std::swap(leftDistance, rightDistance);
+				}
+				assert(stackSize < kStackSize);
+				stack[stackSize++] = { rightChild, rightDistance };
+				index = leftChild;
+				continue;
+			}
+			if (leftHit) {
+				index = leftChild;
+				continue;
+			}
+			if (rightHit) {
+				index = rightChild;
+				continue;
+			}
+		}
+
+		// 積んだノードを取り出す（当たりより遠いものは捨てる）
+		bool popped = false;
+		while (stackSize > 0) {
+			StackEntry entry = stack[--stackSize];
+			if (entry.distance <= closest) {
+				index = entry.node;
+				popped = true;
+				break;
+			}
+		}
+		if (!popped) {
+			break;
+		}
+	}
+	return found;
+}
\ No newline at end of file
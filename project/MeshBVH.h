@@ -0,0 +1,84 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MathTypes.h"
+
+// 三角形メッシュのBVH（モデルのローカル座標。レイとメッシュの当たり判定を速くする）
+// ノードは32byteに詰め、2つの子は隣り合わせに置いて左の子の番号だけを持つ
+// 葉の三角形は4つずつ成分ごとの配列（SoA）に並べ替えて持ち、SSEで4つまとめてMöller–Trumboreの判定をする
+class MeshBVH
+{
+public:
+
+	// レイの当たり
+	struct Hit
+	{
+		float distance = 0.0f; // directionの長さ単位
+		uint32_t triangle = UINT32_MAX; // 何番目の三角形か（インデックスの3つ組の番号）
+		float u = 0.0f; // 重心座標（2番目の頂点の重み）
+		float v = 0.0f; // 重心座標（3番目の頂点の重み）
+	};
+
+	/// <summary>
+	/// 三角形リストからBVHを作る（ビンに分けたSAHで分け、三角形が少なくなったら葉にする）
+	/// </summary>
+	/// <param name="positions">頂点座標</param>
+	/// <param name="indices">三角形リストのインデックス</param>
+	void Build(const std::vector<math::Vector3> &positions, const std::vector<uint32_t> &indices);
+
+	// 空にする
+	void Clear();
+
+	/// <summary>
+	/// レイに最も近くで当たる三角形を探す（両面とも当たる）
+	/// </summary>
+	/// <param name="ray">レイ（directionは正規化しなくてよい）</param>
+	/// <param name="maxDistance">調べるレイの長さ</param>
+	/// <param name="hit">最も近い当たり</param>
+	/// <returns>当たったらtrue</returns>
+	bool RayCast(const math::Ray &ray, float maxDistance, Hit &hit) const;
+
+	// レイが maxDistance までにどれかの三角形に当たるか（見通しの判定用。最初の当たりで打ち切る）
+	bool AnyHit(const math::Ray &ray, float maxDistance) const;
+
+	// ===== getter =====
+	bool IsEmpty() const { return nodes.empty(); }
+	size_t GetTriangleCount() const { return triangleCount; }
+	size_t GetNodeCount() const { return nodes.size(); }
+	// ノードと三角形に使っているメモリ
+	size_t GetMemorySize() const { return nodes.size() * sizeof(Node) + blocks.size() * sizeof(TriangleBlock); }
+
+private:
+
+	// ノード（32byte）
+	struct Node
+	{
+		float min[3];
+		uint32_t leftFirst; // 内部ノードなら左の子の番号（右の子は+1）、葉なら最初の三角形ブロックの番号
+		float max[3];
+		uint32_t count; // 葉の三角形の数（0なら内部ノード）
+
+		bool IsLeaf() const { return count > 0; }
+	};
+	static_assert(sizeof(Node) == 32, "MeshBVH::Node must stay 32 bytes");
+
+	// 4つの三角形を成分ごとに並べたもの（余りは辺の長さ0の三角形で埋め、当たらないようにする）
+	struct alignas(16) TriangleBlock
+	{
+		float vertex0[3][4]; // 1番目の頂点 [x,y,z][三角形]
+		float edge1[3][4]; // 1番目→2番目の頂点
+		float edge2[3][4]; // 1番目→3番目の頂点
+		uint32_t triangle[4]; // 元の三角形の番号
+	};
+
+	// 葉に入れる三角形の数の上限（ブロック2つ分）
+	static constexpr uint32_t kMaxLeafTriangles = 8;
+
+	// 探索をまとめたもの（anyHitなら最初の当たりで返る）
+	bool Traverse(const math::Ray &ray, float maxDistance, Hit &hit, bool anyHit) const;
+
+	std::vector<Node> nodes;
+	std::vector<TriangleBlock> blocks;
+	size_t triangleCount = 0;
+};
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "MeshCache.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+
+namespace {
+
+	// キャッシュファイルの識別子とバージョン（形式を変えたらバージョンを上げる）
+	constexpr char kMagic[4] = { 'M', 'S', 'H', 'C' };
+	constexpr uint32_t kVersion = 3; // 2: 最適化済みの並びで保存 3: 複数マテリアルとサブメッシュ
+
+	// キャッシュファイルの拡張子
+	const char *const kExtension = ".meshcache";
+
+	// 元ファイルの状態（更新判定用）
+	struct SourceStamp
+	{
+		uint64_t size = 0;
+		int64_t writeTime = 0;
+
+		bool operator==(const SourceStamp &other) const { return size == other.size && writeTime == other.writeTime; }
+	};
+
+	// キャッシュファイルのヘッダ
+	struct Header
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t vertexStride; // VertexDataの構造が変わったら無効にする
+		uint32_t vertexCount;
+		uint32_t indexCount;
+		uint32_t materialCount;
+		uint32_t subMeshCount;
+		uint32_t padding;
+		SourceStamp source; // objファイル
+		SourceStamp materialLibrary; // mtlファイル
+		uint64_t vertexOffset; // 頂点データの位置
+		uint64_t indexOffset; // インデックスデータの位置
+		uint64_t subMeshOffset; // サブメッシュの位置
+		uint64_t stringOffset; // 文字列テーブル（mtlパス、マテリアル名とテクスチャパス）の位置
+		uint64_t fileSize;
+	};
+
+	// 頂点データの配置境界
+	constexpr uint64_t kDataAlignment = 16;
+
+	uint64_t AlignUp(uint64_t value, uint64_t alignment)
+	{
+		return (value + alignment - 1) & ~(alignment - 1);
+	}
+
+	// 元ファイルのサイズと更新日時を取得する（ファイルが無ければサイズ0）
+	SourceStamp GetSourceStamp(const std::string &filePath)
+	{
+		SourceStamp stamp;
+		if (filePath.empty()) {
+			return stamp;
+		}
+		std::error_code ec;
+		std::filesystem::path path(filePath);
+		uint64_t size = std::filesystem::file_size(path, ec);
+		if (ec) {
+			return stamp;
+		}
+		std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path, ec);
+		if (ec) {
+			return stamp;
+		}
+		stamp.size = size;
+		stamp.writeTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+		return stamp;
+	}
+
+	// 読み込み専用のメモリマップドファイル（Windows以外はテスト用にPOSIXのmmapを使う）
+	class MappedFile
+	{
+	public:
+#ifdef _WIN32
+		explicit MappedFile(const std::string &filePath)
+		{
+			file_ = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+			if (file_ == INVALID_HANDLE_VALUE) {
+				return;
+			}
+			LARGE_INTEGER fileSize {};
+			if (!GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) {
+				return;
+			}
+			mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mapping_ == nullptr) {
+				return;
+			}
+			data_ = static_cast<const uint8_t *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+			if (data_) {
+				size_ = static_cast<uint64_t>(fileSize.QuadPart);
+			}
+		}
+
+		~MappedFile()
+		{
+			if (data_) { UnmapViewOfFile(data_); }
+			if (mapping_) { CloseHandle(mapping_); }
+			if (file_ != INVALID_HANDLE_VALUE) { CloseHandle(file_); }
+		}
+#else
+		explicit MappedFile(const std::string &filePath)
+		{
+			int file = open(filePath.c_str(), O_RDONLY);
+			if (file < 0) {
+				return;
+			}
+			struct stat status {};
+			if (fstat(file, &status) == 0 && status.st_size > 0) {
+				void *data = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+				if (data != MAP_FAILED) {
+					data_ = static_cast<const uint8_t *>(data);
+					size_ = static_cast<uint64_t>(status.st_size);
+				}
+			}
+			// マップした後はファイルを閉じてよい
+			close(file);
+		}
+
+		~MappedFile()
+		{
+			if (data_) { munmap(const_cast<uint8_t *>(data_), static_cast<size_t>(size_)); }
+		}
+#endif
+
+		MappedFile(const MappedFile &) = delete;
+		MappedFile &operator=(const MappedFile &) = delete;
+
+		const uint8_t *GetData() const { return data_; }
+		uint64_t GetSize() const { return size_; }
+
+	private:
+#ifdef _WIN32
+		HANDLE file_ = INVALID_HANDLE_VALUE;
+		HANDLE mapping_ = nullptr;
+#endif
+		const uint8_t *data_ = nullptr;
+		uint64_t size_ = 0;
+	};
+
+	// 文字列テーブルから文字列を1つ読む
+	bool ReadString(const uint8_t *&cursor, const uint8_t *end, std::string &out)
+	{
+		uint32_t length = 0;
+		if (end - cursor < static_cast<ptrdiff_t>(sizeof(length))) {
+			return false;
+		}
+		std::memcpy(&length, cursor, sizeof(length));
+		cursor += sizeof(length);
+		if (end - cursor < static_cast<ptrdiff_t>(length)) {
+			return false;
+		}
+		out.assign(reinterpret_cast<const char *>(cursor), length);
+		cursor += length;
+		return true;
+	}
+
+	// 文字列テーブルに文字列を1つ書く
+	void WriteString(std::ofstream &file, const std::string &value)
+	{
+		uint32_t length = static_cast<uint32_t>(value.size());
+		file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+		file.write(value.data(), length);
+	}
+
+	// 現在位置を指定の境界までゼロで埋める
+	void WritePadding(std::ofstream &file, uint64_t alignment)
+	{
+		static const char kZeros[kDataAlignment] = {};
+		uint64_t position = static_cast<uint64_t>(file.tellp());
+		uint64_t padding = AlignUp(position, alignment) - position;
+		file.write(kZeros, static_cast<std::streamsize>(padding));
+	}
+}
+
+namespace MeshCache {
+
+	std::string GetCacheFilePath(const std::string &sourceFilePath)
+	{
+		return sourceFilePath + kExtension;
+	}
+
+	bool Load(const std::string &sourceFilePath, Model::ModelData &modelData)
+	{
+		//----キャッシュファイルをメモリマップする----
+		MappedFile mappedFile(GetCacheFilePath(sourceFilePath));
+		if (mappedFile.GetData() == nullptr || mappedFile.GetSize() < sizeof(Header)) {
+			return false;
+		}
+		const uint8_t *data = mappedFile.GetData();
+		const uint8_t *end = data + mappedFile.GetSize();
+
+		//----ヘッダを検証する----
+		Header header {};
+		std::memcpy(&header, data, sizeof(Header));
+		if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+			header.version != kVersion ||
+			header.vertexStride != sizeof(Model::VertexData) ||
+			header.fileSize != mappedFile.GetSize()) {
+			return false;
+		}
+		uint64_t vertexBytes = uint64_t(header.vertexCount) * sizeof(Model::VertexData);
+		uint64_t indexBytes = uint64_t(header.indexCount) * sizeof(uint32_t);
+		uint64_t subMeshBytes = uint64_t(header.subMeshCount) * sizeof(Model::SubMesh);
+		if (header.vertexOffset + vertexBytes > header.fileSize ||
+			header.indexOffset + indexBytes > header.fileSize ||
+			header.subMeshOffset + subMeshBytes > header.fileSize ||
+			header.stringOffset > header.fileSize) {
+			return false;
+		}
+
+		//----元ファイルが更新されていないか確認する----
+		const uint8_t *cursor = data + header.stringOffset;
+		std::string materialLibraryPath;
+		if (!ReadString(cursor, end, materialLibraryPath)) {
+			return false;
+		}
+		if (!(GetSourceStamp(sourceFilePath) == header.source) ||
+			!(GetSourceStamp(materialLibraryPath) == header.materialLibrary)) {
+			return false;
+		}
+
+		//----マテリアルを読む----
+		modelData.materials.resize(header.materialCount);
+		for (Model::MaterialData &material : modelData.materials) {
+			if (!ReadString(cursor, end, material.name) || !ReadString(cursor, end, material.textureFilePath)) {
+				return false;
+			}
+		}
+		modelData.materialLibraryPath = materialLibraryPath;
+
+		//----サブメッシュを読む----
+		modelData.subMeshes.resize(header.subMeshCount);
+		std::memcpy(modelData.subMeshes.data(), data + header.subMeshOffset, static_cast<size_t>(subMeshBytes));
+		for (const Model::SubMesh &subMesh : modelData.subMeshes) {
+			if (subMesh.materialIndex >= header.materialCount ||
+				uint64_t(subMesh.indexStart) + subMesh.indexCount > header.indexCount) {
+				return false;
+			}
+		}
+
+		//----頂点・インデックスをコピーする----
+		modelData.vertices.resize(header.vertexCount);
+		std::memcpy(modelData.vertices.data(), data + header.vertexOffset, static_cast<size_t>(vertexBytes));
+		modelData.indices.resize(header.indexCount);
+		std::memcpy(modelData.indices.data(), data + header.indexOffset, static_cast<size_t>(indexBytes));
+		// 壊れたキャッシュで頂点配列の範囲外を読まないよう、インデックスも確かめる
+		for (uint32_t index : modelData.indices) {
+			if (index >= header.vertexCount) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Save(const std::string &sourceFilePath, const Model::ModelData &modelData)
+	{
+		//----ヘッダを作る----
+		Header header {};
+		std::memcpy(header.magic, kMagic, sizeof(kMagic));
+		header.version = kVersion;
+		header.vertexStride = sizeof(Model::VertexData);
+		header.vertexCount = static_cast<uint32_t>(modelData.vertices.size());
+		header.indexCount = static_cast<uint32_t>(modelData.indices.size());
+		header.materialCount = static_cast<uint32_t>(modelData.materials.size());
+		header.subMeshCount = static_cast<uint32_t>(modelData.subMeshes.size());
+		header.source = GetSourceStamp(sourceFilePath);
+		header.materialLibrary = GetSourceStamp(modelData.materialLibraryPath);
+
+		uint64_t vertexBytes = uint64_t(header.vertexCount) * sizeof(Model::VertexData);
+		uint64_t indexBytes = uint64_t(header.indexCount) * sizeof(uint32_t);
+		uint64_t subMeshBytes = uint64_t(header.subMeshCount) * sizeof(Model::SubMesh);
+		header.vertexOffset = AlignUp(sizeof(Header), kDataAlignment);
+		header.indexOffset = AlignUp(header.vertexOffset + vertexBytes, kDataAlignment);
+		header.subMeshOffset = header.indexOffset + indexBytes;
+		header.stringOffset = header.subMeshOffset + subMeshBytes;
+		header.fileSize = header.stringOffset + sizeof(uint32_t) + modelData.materialLibraryPath.size();
+		for (const Model::MaterialData &material : modelData.materials) {
+			header.fileSize += sizeof(uint32_t) + material.name.size() + sizeof(uint32_t) + material.textureFilePath.size();
+		}
+
+		//----一時ファイルに書き出す----
+		std::string cacheFilePath = GetCacheFilePath(sourceFilePath);
+		std::string temporaryFilePath = cacheFilePath + ".tmp";
+		{
+			std::ofstream file(temporaryFilePath, std::ios::binary | std::ios::trunc);
+			if (!file.is_open()) {
+				return false;
+			}
+			file.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+			WritePadding(file, kDataAlignment);
+			file.write(reinterpret_cast<const char *>(modelData.vertices.data()), static_cast<std::streamsize>(vertexBytes));
+			WritePadding(file, kDataAlignment);
+			file.write(reinterpret_cast<const char *>(modelData.indices.data()), static_cast<std::streamsize>(indexBytes));
+			file.write(reinterpret_cast<const char *>(modelData.subMeshes.data()), static_cast<std::streamsize>(subMeshBytes));
+			WriteString(file, modelData.materialLibraryPath);
+			for (const Model::MaterialData &material : modelData.materials) {
+				WriteString(file, material.name);
+				WriteString(file, material.textureFilePath);
+			}
+			if (!file.good()) {
+				return false;
+			}
+		}
+
+		//----書き終えてから置き換える（途中で落ちても壊れたキャッシュを残さない）----
+		std::error_code ec;
+		std::filesystem::rename(temporaryFilePath, cacheFilePath, ec);
+		if (ec) {
+			std::filesystem::remove(temporaryFilePath, ec);
+			return false;
+		}
+		return true;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include "Model.h"
+
+// メッシュのバイナリキャッシュ
+// objの解析結果（頂点・インデックス・マテリアル・サブメッシュ）をバイナリで保存し、次回起動時はメモリマップで読み込む
+// 元ファイル（obj/mtl）のサイズと更新日時が変わっていたらキャッシュは無効とみなす
+namespace MeshCache
+{
+	/// <summary>
+	/// キャッシュファイルのパスを取得する
+	/// </summary>
+	/// <param name="sourceFilePath">objファイルのパス</param>
+	std::string GetCacheFilePath(const std::string &sourceFilePath);
+
+	/// <summary>
+	/// キャッシュから読み込む
+	/// </summary>
+	/// <param name="sourceFilePath">objファイルのパス</param>
+	/// <param name="modelData">読み込み先</param>
+	/// <returns>有効なキャッシュから読み込めたらtrue</returns>
+	bool Load(const std::string &sourceFilePath, Model::ModelData &modelData);
+
+	/// <summary>
+	/// キャッシュに書き出す
+	/// </summary>
+	/// <param name="sourceFilePath">objファイルのパス</param>
+	/// <param name="modelData">書き出すモデルデータ</param>
+	/// <returns>書き出せたらtrue</returns>
+	bool Save(const std::string &sourceFilePath, const Model::ModelData &modelData);
+}
\ No newline at end of file
@@ -0,0 +1,379 @@
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cassert>
+
+namespace {
+
+	// ===== Forsythの頂点キャッシュ最適化のパラメータ =====
+	// スコア計算で想定するキャッシュのエントリ数
+	constexpr uint32_t kCacheSize = 32;
+	// スコアテーブルを持つ残り三角形数の上限（それ以上は同じスコア）
+	constexpr uint32_t kMaxValence = 32;
+	// 直前の三角形の頂点のスコア（同じ三角形の繰り返しを避けるため少し低め）
+	constexpr float kLastTriangleScore = 0.75f;
+	// キャッシュ内の位置によるスコアの減衰
+	constexpr float kCacheDecayPower = 1.5f;
+	// 残り三角形が少ない頂点を優先する度合い（孤立した頂点を早く片付ける）
+	constexpr float kValenceBoostScale = 2.0f;
+	constexpr float kValenceBoostPower = 0.5f;
+
+	// ===== 頂点フェッチの計測用パラメータ =====
+	// キャッシュラインのバイト数
+	constexpr uint32_t kCacheLineSize = 64;
+	// 模擬するキャッシュのライン数（ダイレクトマップ16KB）
+	constexpr uint32_t kCacheLineCount = 256;
+
+	// キャッシュに入っていない
+	constexpr int32_t kNotInCache = -1;
+
+	// 頂点のスコアを引くテーブル
+	struct ScoreTable
+	{
+		float cache[kCacheSize + 3] = {};
+		float valence[kMaxValence + 1] = {};
+
+		ScoreTable()
+		{
+			for (uint32_t i = 0; i < kCacheSize + 3; ++i) {
+				if (i < 3) {
+					cache[i] = kLastTriangleScore;
+				} else if (i < kCacheSize) {
+					float scale = 1.0f / static_cast<float>(kCacheSize - 3);
+					cache[i] = std::pow(1.0f - static_cast<float>(i - 3) * scale, kCacheDecayPower);
+				}
+			}
+			for (uint32_t i = 1; i <= kMaxValence; ++i) {
+				valence[i] = kValenceBoostScale * std::pow(static_cast<float>(i), -kValenceBoostPower);
+			}
+		}
+	};
+
+	// 頂点のスコアを求める
+	float VertexScore(const ScoreTable &table, int32_t cachePosition, uint32_t liveTriangles)
+	{
+		// もう使う三角形がない頂点は選ばない
+		if (liveTriangles == 0) {
+			return -1.0f;
+		}
+		float score = cachePosition == kNotInCache ? 0.0f : table.cache[cachePosition];
+		score += table.valence[(std::min)(liveTriangles, kMaxValence)];
+		return score;
+	}
+}
+
+namespace MeshOptimizer {
+
+	VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize)
+	{
+		VertexCacheStatistics result;
+		if (indices.empty() || vertexCount == 0) {
+			return result;
+		}
+
+		// 各頂点がキャッシュに入った時刻（FIFOの位置を時刻の差で判定する）
+		std::vector<uint32_t> cacheTimestamps(vertexCount, 0);
+		uint32_t timestamp = cacheSize + 1;
+
+		for (uint32_t index : indices) {
+			assert(index < vertexCount);
+			if (timestamp - cacheTimestamps[index] > cacheSize) {
+				// キャッシュミス：頂点シェーダーが実行され、キャッシュの末尾に入る
+				cacheTimestamps[index] = timestamp++;
+				++result.vertexTransforms;
+			}
+		}
+
+		result.acmr = static_cast<float>(result.vertexTransforms) / static_cast<float>(indices.size() / 3);
+		result.atvr = static_cast<float>(result.vertexTransforms) / static_cast<float>(vertexCount);
+		return result;
+	}
+
+	VertexFetchStatistics AnalyzeVertexFetch(const std::vector<uint32_t> &indices, size_t vertexCount, size_t vertexSize)
+	{
+		VertexFetchStatistics result;
+		if (indices.empty() || vertexCount == 0) {
+			return result;
+		}
+
+		// ダイレクトマップのキャッシュ（各ラインが保持しているアドレスのタグ）
+		std::vector<uint64_t> cacheTags(kCacheLineCount, UINT64_MAX);
+
+		for (uint32_t index : indices) {
+			assert(index < vertexCount);
+			uint64_t beginLine = uint64_t(index) * vertexSize / kCacheLineSize;
+			uint64_t endLine = (uint64_t(index) * vertexSize + vertexSize - 1) / kCacheLineSize;
+			for (uint64_t line = beginLine; line <= endLine; ++line) {
+				uint64_t &tag = cacheTags[line % kCacheLineCount];
+				if (tag != line) {
+					tag = line;
+					result.bytesFetched += kCacheLineSize;
+				}
+			}
+		}
+
+		result.overfetch = static_cast<float>(result.bytesFetched) / static_cast<float>(vertexCount * vertexSize);
+		return result;
+	}
+
+	void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0 || vertexCount == 0) {
+			return;
+		}
+		static const ScoreTable table;
+
+		//----頂点ごとに、それを使う三角形の一覧を作る----
+		std::vector<uint32_t> liveTriangles(vertexCount, 0);
+		for (uint32_t index : indices) {
+			++liveTriangles[index];
+		}
+		std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+		for (size_t i = 0; i < vertexCount; ++i) {
+			adjacencyOffsets[i + 1] = adjacencyOffsets[i] + liveTriangles[i];
+		}
+		std::vector<uint32_t> adjacency(indices.size());
+		{
+			std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < indices.size(); ++i) {
+				adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+			}
+		}
+
+		//----初期スコア----
+		std::vector<int32_t> cachePositions(vertexCount, kNotInCache);
+		std::vector<float> vertexScores(vertexCount);
+		for (size_t i = 0; i < vertexCount; ++i) {
+			vertexScores[i] = VertexScore(table, kNotInCache, liveTriangles[i]);
+		}
+		std::vector<float> triangleScores(triangleCount);
+		for (size_t t = 0; t < triangleCount; ++t) {
+			triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+		}
+		std::vector<bool> emitted(triangleCount, false);
+
+		//----スコアの高い三角形から順に出力する----
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		uint32_t cache[kCacheSize + 3];
+		uint32_t cacheCount = 0;
+		size_t scanCursor = 0; // 候補が尽きたときに未出力の三角形を探す位置
+
+		// 最初の三角形はスコアの最も高いもの
+		size_t bestTriangle = std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin();
+
+		while (bestTriangle != SIZE_MAX) {
+			emitted[bestTriangle] = true;
+			const uint32_t *corner = &indices[bestTriangle * 3];
+			result.insert(result.end(), corner, corner + 3);
+
+			//----出力した三角形を頂点の一覧から外す----
+			for (uint32_t k = 0; k < 3; ++k) {
+				uint32_t vertex = corner[k];
+				uint32_t *begin = &adjacency[adjacencyOffsets[vertex]];
+				uint32_t *end = begin + liveTriangles[vertex];
+				uint32_t *found = std::find(begin, end, static_cast<uint32_t>(bestTriangle));
+				if (found != end) {
+					*found = *(end - 1);
+					--liveTriangles[vertex];
+				}
+			}
+
+			//----キャッシュを更新する（出力した頂点を先頭へ）----
+			uint32_t newCache[kCacheSize + 3];
+			uint32_t newCount = 0;
+			for (uint32_t k = 0; k < 3; ++k) {
+				if (std::find(newCache, newCache + newCount, corner[k]) == newCache + newCount) {
+					newCache[newCount++] = corner[k];
+				}
+			}
+			for (uint32_t i = 0; i < cacheCount; ++i) {
+				uint32_t vertex = cache[i];
+				if (std::find(newCache, newCache + newCount, vertex) == newCache + newCount) {
+					newCache[newCount++] = vertex;
+				}
+			}
+
+			//----キャッシュ内の頂点と、それを使う三角形のスコアを更新する----
+			for (uint32_t i = 0; i < newCount; ++i) {
+				uint32_t vertex = newCache[i];
+				cachePositions[vertex] = i < kCacheSize ? static_cast<int32_t>(i) : kNotInCache;
+				vertexScores[vertex] = VertexScore(table, cachePositions[vertex], liveTriangles[vertex]);
+			}
+			cacheCount = (std::min)(newCount, kCacheSize);
+			std::copy(newCache, newCache + cacheCount, cache);
+
+			bestTriangle = SIZE_MAX;
+			float bestScore = -1.0f;
+			for (uint32_t i = 0; i < newCount; ++i) {
+				uint32_t vertex = newCache[i];
+				const uint32_t *begin = &adjacency[adjacencyOffsets[vertex]];
+				for (uint32_t j = 0; j < liveTriangles[vertex]; ++j) {
+					uint32_t triangle = begin[j];
+					const uint32_t *c = &indices[triangle * 3];
+					float score = vertexScores[c[0]] + vertexScores[c[1]] + vertexScores[c[2]];
+					triangleScores[triangle] = score;
+					if (score > bestScore) {
+						bestScore = score;
+						bestTriangle = triangle;
+					}
+				}
+			}
+
+			//----キャッシュ内に候補がなければ、未出力の三角形から続ける----
+			if (bestTriangle == SIZE_MAX) {
+				while (scanCursor < triangleCount && emitted[scanCursor]) {
+					++scanCursor;
+				}
+				if (scanCursor < triangleCount) {
+					bestTriangle = scanCursor;
+				}
+			}
+		}
+
+		indices.swap(result);
+	}
+
+	void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Model::VertexData> &vertices)
+	{
+		size_t triangleCount = indices.size() / 3;
+		if (triangleCount == 0) {
+			return;
+		}
+
+		//----キャッシュが完全にミスする三角形でクラスタを区切る----
+		// 区切り位置ではもともと頂点の再利用がないので、クラスタを並べ替えてもACMRはほぼ変わらない
+		constexpr uint32_t kMinClusterTriangles = 16;
+		std::vector<uint32_t> clusterStarts;
+		{
+			std::vector<uint32_t> cacheTimestamps(vertices.size(), 0);
+			uint32_t timestamp = kCacheSize + 1;
+			uint32_t lastStart = 0;
+			for (size_t t = 0; t < triangleCount; ++t) {
+				uint32_t misses = 0;
+				for (uint32_t k = 0; k < 3; ++k) {
+					uint32_t index = indices[t * 3 + k];
+					if (timestamp - cacheTimestamps[index] > kCacheSize) {
+						cacheTimestamps[index] = timestamp++;
+						++misses;
+					}
+				}
+				if (t == 0 || (misses == 3 && t - lastStart >= kMinClusterTriangles)) {
+					clusterStarts.push_back(static_cast<uint32_t>(t));
+					lastStart = static_cast<uint32_t>(t);
+				}
+			}
+		}
+		size_t clusterCount = clusterStarts.size();
+		if (clusterCount <= 1) {
+			return;
+		}
+		clusterStarts.push_back(static_cast<uint32_t>(triangleCount));
+
+		//----メッシュ全体の中心----
+		math::Vector3 meshCenter {};
+		for (const Model::VertexData &vertex : vertices) {
+			meshCenter.x += vertex.position.x;
+			meshCenter.y += vertex.position.y;
+			meshCenter.z += vertex.position.z;
+		}
+		float inverseCount = 1.0f / static_cast<float>(vertices.size());
+		meshCenter = { meshCenter.x * inverseCount, meshCenter.y * inverseCount, meshCenter.z * inverseCount };
+
+		//----クラスタごとに外向き度合い（中心からの向きと面の向きの内積）を求める----
+		// 外を向いたクラスタほど手前の面になりやすいので先に描く
+		std::vector<float> clusterSortKeys(clusterCount);
+		for (size_t c = 0; c < clusterCount; ++c) {
+			math::Vector3 centroid {};
+			math::Vector3 normal {};
+			float totalArea = 0.0f;
+			for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+				const math::Vector4 &a = vertices[indices[t * 3]].position;
+				const math::Vector4 &b = vertices[indices[t * 3 + 1]].position;
+				const math::Vector4 &p = vertices[indices[t * 3 + 2]].position;
+				// 読み込み時に巻き順を反転しているので、外向きの法線は(c - a) x (b - a)
+				math::Vector3 ac = { p.x - a.x, p.y - a.y, p.z - a.z };
+				math::Vector3 ab = { b.x - a.x, b.y - a.y, b.z - a.z };
+				math::Vector3 n = { ac.y * ab.z - ac.z * ab.y, ac.z * ab.x - ac.x * ab.z, ac.x * ab.y - ac.y * ab.x };
+				float area = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+				centroid.x += (a.x + b.x + p.x) * area;
+				centroid.y += (a.y + b.y + p.y) * area;
+				centroid.z += (a.z + b.z + p.z) * area;
+				normal.x += n.x;
+				normal.y += n.y;
+				normal.z += n.z;
+				totalArea += area;
+			}
+			if (totalArea <= 0.0f) {
+				clusterSortKeys[c] = 0.0f;
+				continue;
+			}
+			float inverseArea = 1.0f / (totalArea * 3.0f);
+			math::Vector3 toCluster = {
+				centroid.x * inverseArea - meshCenter.x,
+				centroid.y * inverseArea - meshCenter.y,
+				centroid.z * inverseArea - meshCenter.z };
+			float normalLength = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			clusterSortKeys[c] = normalLength > 0.0f ?
+				(toCluster.x * normal.x + toCluster.y * normal.y + toCluster.z * normal.z) / normalLength : 0.0f;
+		}
+
+		//----外向きの度合いが大きいクラスタから並べる----
+		std::vector<uint32_t> clusterOrder(clusterCount);
+		for (uint32_t c = 0; c < clusterCount; ++c) {
+			clusterOrder[c] = c;
+		}
+		std::stable_sort(clusterOrder.begin(), clusterOrder.end(), [&](uint32_t lhs, uint32_t rhs) {
+			return clusterSortKeys[lhs] > clusterSortKeys[rhs];
+			});
+
+		std::vector<uint32_t> result;
+		result.reserve(indices.size());
+		for (uint32_t c : clusterOrder) {
+			result.insert(result.end(), indices.begin() + size_t(clusterStarts[c]) * 3, indices.begin() + size_t(clusterStarts[c + 1]) * 3);
+		}
+		indices.swap(result);
+	}
+
+	void OptimizeVertexFetch(std::vector<Model::VertexData> &vertices, std::vector<uint32_t> &indices)
+	{
+		//----インデックスで最初に参照された順に新しい番号を振る----
+		std::vector<uint32_t> remap(vertices.size(), UINT32_MAX);
+		std::vector<Model::VertexData> result;
+		result.reserve(vertices.size());
+		for (uint32_t &index : indices) {
+			if (remap[index] == UINT32_MAX) {
+				remap[index] = static_cast<uint32_t>(result.size());
+				result.push_back(vertices[index]);
+			}
+			index = remap[index];
+		}
+		vertices.swap(result);
+	}
+
+	Report Optimize(Model::ModelData &modelData, bool optimizeOverdraw)
+	{
+		Report report;
+		report.cacheBefore = AnalyzeVertexCache(modelData.indices, modelData.vertices.size());
+		report.fetchBefore = AnalyzeVertexFetch(modelData.indices, modelData.vertices.size(), sizeof(Model::VertexData));
+
+		// 三角形の並べ替えはサブメッシュの範囲内で行う（範囲をまたぐとマテリアルが変わってしまう）
+		std::vector<uint32_t> subMeshIndices;
+		for (const Model::SubMesh &subMesh : modelData.subMeshes) {
+			auto begin = modelData.indices.begin() + subMesh.indexStart;
+			auto end = begin + subMesh.indexCount;
+			subMeshIndices.assign(begin, end);
+			OptimizeVertexCache(subMeshIndices, modelData.vertices.size());
+			if (optimizeOverdraw) {
+				OptimizeOverdraw(subMeshIndices, modelData.vertices);
+			}
+			std::copy(subMeshIndices.begin(), subMeshIndices.end(), begin);
+		}
+		OptimizeVertexFetch(modelData.vertices, modelData.indices);
+
+		report.cacheAfter = AnalyzeVertexCache(modelData.indices, modelData.vertices.size());
+		report.fetchAfter = AnalyzeVertexFetch(modelData.indices, modelData.vertices.size(), sizeof(Model::VertexData));
+		return report;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,82 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Model.h"
+
+// メッシュの最適化
+// 読み込んだ三角形リストの並びを、GPUの頂点キャッシュ・頂点フェッチ・早期Zが効きやすい順に並べ替える
+// ・OptimizeVertexCache : 頂点キャッシュで再利用されやすい三角形順にする（Forsythの方式）
+// ・OptimizeOverdraw    : キャッシュの切れ目で区切ったクラスタを外向きのものから描く順にする
+// ・OptimizeVertexFetch : 頂点をインデックスで最初に参照される順に並べ直す
+// どれもCPUのみで完結し、描画結果（三角形の集合）は変えない
+namespace MeshOptimizer
+{
+	// 頂点キャッシュの計測結果
+	struct VertexCacheStatistics
+	{
+		uint32_t vertexTransforms = 0; // 頂点シェーダーが実行される回数
+		float acmr = 0.0f; // 三角形あたりの頂点変換数（0.5～3.0、低いほど良い）
+		float atvr = 0.0f; // 頂点あたりの頂点変換数（1.0が最良）
+	};
+
+	// 頂点フェッチの計測結果
+	struct VertexFetchStatistics
+	{
+		uint64_t bytesFetched = 0; // メモリから読み込まれたバイト数
+		float overfetch = 0.0f; // 頂点バッファサイズに対する読み込み量の比（1.0が最良）
+	};
+
+	// 最適化前後の計測結果
+	struct Report
+	{
+		VertexCacheStatistics cacheBefore;
+		VertexCacheStatistics cacheAfter;
+		VertexFetchStatistics fetchBefore;
+		VertexFetchStatistics fetchAfter;
+	};
+
+	/// <summary>
+	/// FIFOの頂点キャッシュを模擬してACMR/ATVRを計測する
+	/// </summary>
+	/// <param name="indices">三角形リストのインデックス</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="cacheSize">模擬するキャッシュのエントリ数</param>
+	VertexCacheStatistics AnalyzeVertexCache(const std::vector<uint32_t> &indices, size_t vertexCount, uint32_t cacheSize = 16);
+
+	/// <summary>
+	/// キャッシュラインを模擬して頂点フェッチの読み込み量を計測する
+	/// </summary>
+	/// <param name="indices">三角形リストのインデックス</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="vertexSize">1頂点のバイト数</param>
+	VertexFetchStatistics AnalyzeVertexFetch(const std::vector<uint32_t> &indices, size_t vertexCount, size_t vertexSize);
+
+	/// <summary>
+	/// 頂点キャッシュで再利用されやすいように三角形を並べ替える
+	/// </summary>
+	/// <param name="indices">三角形リストのインデックス（書き換える）</param>
+	/// <param name="vertexCount">頂点数</param>
+	void OptimizeVertexCache(std::vector<uint32_t> &indices, size_t vertexCount);
+
+	/// <summary>
+	/// オーバードローが減るようにクラスタ単位で三角形を並べ替える（OptimizeVertexCacheの後に使う）
+	/// </summary>
+	/// <param name="indices">三角形リストのインデックス（書き換える）</param>
+	/// <param name="vertices">頂点</param>
+	void OptimizeOverdraw(std::vector<uint32_t> &indices, const std::vector<Model::VertexData> &vertices);
+
+	/// <summary>
+	/// 頂点をインデックスで最初に参照される順に並べ直す（使われない頂点は取り除く）
+	/// </summary>
+	/// <param name="vertices">頂点（書き換える）</param>
+	/// <param name="indices">三角形リストのインデックス（書き換える）</param>
+	void OptimizeVertexFetch(std::vector<Model::VertexData> &vertices, std::vector<uint32_t> &indices);
+
+	/// <summary>
+	/// モデルデータにすべての最適化を順にかける（三角形の並べ替えはサブメッシュごと）
+	/// </summary>
+	/// <param name="modelData">モデルデータ（書き換える）</param>
+	/// <param name="optimizeOverdraw">オーバードローの最適化も行うか</param>
+	/// <returns>最適化前後の計測結果</returns>
+	Report Optimize(Model::ModelData &modelData, bool optimizeOverdraw = true);
+}
\ No newline at end of file
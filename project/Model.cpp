@@ -2,144 +2,167 @@
 #include "ModelCommon.h"
 #include "TextureManager.h"
 #include "DirectXCommon.h"
-#include <fstream>
-#include <sstream>
+#include "ObjLoader.h"
+#include "VertexQuantization.h"
+#include "Logger.h"
+#include "RenderQueue.h"
+#include "BoundingVolume.h"
 #include <cassert>
+#include <format>
+#include <algorithm>
+#include <cmath>
 
 void Model::Initialize(ModelCommon *modelCommon, const std::string &directorypath, const std::string &filename)
+{
+	// ===== モデル読み込み =====
+	Initialize(modelCommon, LoadObjFile(directorypath, filename));
+}
+
+void Model::Initialize(ModelCommon *modelCommon, ModelData modelData, bool quantizeVertices)
 {
 	// ===== 共通部の保持 =====
 	this->modelCommon_ = modelCommon;
 
-	// ===== モデル読み込み =====
-	modelData_ = LoadObjFile(directorypath, filename);
+	// ===== モデルデータの保持 =====
+	modelData_ = std::move(modelData);
 
-	CreateVertexBuffer(modelData_.vertices);
-	CreateMaterialResource();
+	// ===== 境界ボリューム =====
+	ComputeBounds();
 
-	// ===== テクスチャ読み込み =====
-	TextureManager::GetInstance()->LoadTexture(modelData_.material.textureFilePath);
-	modelData_.material.textureIndex =
-		TextureManager::GetInstance()->GetTextureIndexByFilePath(
-			modelData_.material.textureFilePath);
-}
+	if (quantizeVertices) {
+		CreateQuantizedVertexBuffer(modelData_.vertices);
+	} else {
+		CreateVertexBuffer(modelData_.vertices);
+	}
+	CreateIndexBuffer(modelData_.indices, modelData_.vertices.size());
+	InitializeMaterial();
 
-void Model::Draw() {
+	// ===== メモリ削減量の報告 =====
+	// インデックス化しない場合（三角形の頂点をすべて展開した場合）との比較
+	size_t expandedBytes = sizeof(VertexData) * modelData_.indices.size();
+	size_t indexedBytes = vertexBufferView.SizeInBytes + indexBufferView.SizeInBytes;
+	Logger::Log(std::format("Model: vertices={} indices={} subMeshes={} stride={} bytes {} -> {} (saved {})\n",
+		modelData_.vertices.size(), modelData_.indices.size(), modelData_.subMeshes.size(), vertexBufferView.StrideInBytes,
+		expandedBytes, indexedBytes, static_cast<int64_t>(expandedBytes) - static_cast<int64_t>(indexedBytes)));
 
-	// ===== 頂点バッファ設定 =====
-	modelCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+	// ===== テクスチャ読み込み =====
+	for (MaterialData &material : modelData_.materials) {
+		// 読み込みで返るハンドルのスロット番号をそのままテクスチャ番号にする
+		material.textureIndex =
+			TextureManager::GetInstance()->LoadTexture(material.textureFilePath).index;
+	}
 
-	// ===== 定数バッファ設定 =====
-	modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	ready_ = true;
+}
 
-	// ===== テクスチャ（SRV）設定 =====
-	modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(modelData_.material.textureIndex));
+void Model::Draw(uint32_t instanceCount, RenderStateCache *stateCache) {
+
+	// 直前に同じモデルを描いていれば、バッファとマテリアルはセット済み
+	if (!stateCache || stateCache->SetMesh(reinterpret_cast<uintptr_t>(this))) {
+		// ===== 頂点・インデックスバッファ設定 =====
+		modelCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView);
+		modelCommon_->GetDxCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView);
+
+		// ===== 定数バッファ設定 =====
+		// このフレーム用の領域にコピーして設定する
+		DirectXCommon *dxCommon = modelCommon_->GetDxCommon();
+		dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(0, dxCommon->UploadConstantBuffer(materialData));
+		if (quantized_) {
+			// 量子化した頂点の展開用パラメータ
+			dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(4, dxCommon->UploadConstantBuffer(vertexDecodeData));
+		}
+	}
 
-	// ===== 描画 =====
-	modelCommon_->GetDxCommon()->GetCommandList()->DrawInstanced(UINT(modelData_.vertices.size()), 1, 0, 0);
+	// ===== サブメッシュごとに描画 =====
+	// サブメッシュはテクスチャ順に並んでいるので、テクスチャが変わるときだけSRVを設定し直す
+	uint32_t boundTextureIndex = UINT32_MAX;
+	for (const SubMesh &subMesh : modelData_.subMeshes) {
+		uint32_t textureIndex = modelData_.materials[subMesh.materialIndex].textureIndex;
+		bool bindTexture = stateCache ? stateCache->SetTexture(textureIndex) : textureIndex != boundTextureIndex;
+		if (bindTexture) {
+			modelCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
+			boundTextureIndex = textureIndex;
+		}
+		modelCommon_->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(subMesh.indexCount, instanceCount, subMesh.indexStart, 0, 0);
+	}
 }
 
-Model::MaterialData Model::LoadMaterialTemplateFile(const std::string &directoryPath, const std::string &filename)
+void Model::ComputeBounds()
 {
-	//----中で必要となる変数の宣言----
-	MaterialData materialData; // 構築するMaterialData
-	std::string line; // ファイルから読んだ1行を格納するもの
-
-	//----ファイルを開く----
-	std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
-	assert(file.is_open()); // とりあえず開かなかったら止める
-
-	//----ファイルを読み込んで、MaterialDataを構築する----
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier;
-
-		// identiffierに応じた処理
-		if (identifier == "map_Kd") {
-			std::string textureFilename;
-			s >> textureFilename;
-			// 連結してファイルパスにする
-			materialData.textureFilePath = directoryPath + "/" + textureFilename;
+	// 点の集まりからAABBと、AABBの中心を中心にした球を作る
+	auto makeBounds = [this](auto forEachPosition) {
+		Bounds result { math::MakeEmptyAABB(), {} };
+		forEachPosition([&result](const math::Vector3 &position) { math::Expand(result.aabb, position); });
+
+		result.sphere.center = math::GetCenter(result.aabb);
+		float radiusSquared = 0.0f;
+		forEachPosition([&result, &radiusSquared](const math::Vector3 &position) {
+			math::Vector3 offset = { position.x - result.sphere.center.x, position.y - result.sphere.center.y, position.z - result.sphere.center.z };
+			radiusSquared = std::max(radiusSquared, offset.x * offset.x + offset.y * offset.y + offset.z * offset.z);
+			});
+		result.sphere.radius = std::sqrt(radiusSquared);
+		return result;
+		};
+
+	const std::vector<VertexData> &vertices = modelData_.vertices;
+	if (vertices.empty()) {
+		bounds_ = {};
+		subMeshBounds_.clear();
+		return;
+	}
+
+	// モデル全体
+	bounds_ = makeBounds([&vertices](auto function) {
+		for (const VertexData &vertex : vertices) {
+			function(math::Vector3 { vertex.position.x, vertex.position.y, vertex.position.z });
 		}
+		});
+
+	// サブメッシュごと（インデックスが指す頂点）
+	subMeshBounds_.clear();
+	subMeshBounds_.reserve(modelData_.subMeshes.size());
+	for (const SubMesh &subMesh : modelData_.subMeshes) {
+		const uint32_t *indices = modelData_.indices.data() + subMesh.indexStart;
+		subMeshBounds_.push_back(makeBounds([&vertices, indices, &subMesh](auto function) {
+			for (uint32_t i = 0; i < subMesh.indexCount; ++i) {
+				const math::Vector4 &position = vertices[indices[i]].position;
+				function(math::Vector3 { position.x, position.y, position.z });
+			}
+			}));
+	}
+}
+
+MeshBVH Model::BuildTriangleBVH(const ModelData &modelData)
+{
+	std::vector<math::Vector3> positions;
+	positions.reserve(modelData.vertices.size());
+	for (const VertexData &vertex : modelData.vertices) {
+		positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
 	}
 
-	//----MaterialDataを返す----
-	return materialData;
+	MeshBVH triangleBVH;
+	triangleBVH.Build(positions, modelData.indices);
+	return triangleBVH;
 }
 
-Model::ModelData Model::LoadObjFile(const std::string &directoryPath, const std::string &filename)
+uint32_t Model::GetFirstTextureIndex() const
 {
-	//----必要な変数宣言----
-	ModelData modelData; // 構築するModelData
-	std::vector<math::Vector4> positions; // 位置
-	std::vector<math::Vector3> normals; // 法線
-	std::vector<math::Vector2> texcoords; // テクスチャ座標
-	std::string line; // ファイルから読んだ1行を格納するもの
-
-	//----ファイルを開く----
-	std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
-	assert(file.is_open()); // とりあえず開けなかったら止める
-
-	//----ファイルを読み込んで、ModelDataを構築していく----
-	while (std::getline(file, line)) {
-		std::string identifier;
-		std::istringstream s(line);
-		s >> identifier; // 先頭の識別子を読む
-
-		// identifierに応じた処理
-		if (identifier == "v") {
-			math::Vector4 position;
-			s >> position.x >> position.y >> position.z;
-			position.x *= 1.0f;
-			position.w = 1.0f;
-			positions.push_back(position);
-		} else if (identifier == "vt") {
-			math::Vector2 texcoord;
-			s >> texcoord.x >> texcoord.y;
-			texcoord.y = 1.0f - texcoord.y;
-			texcoords.push_back(texcoord);
-		} else if (identifier == "vn") {
-			math::Vector3 normal;
-			s >> normal.x >> normal.y >> normal.z;
-			normal.x *= -1.0f;
-			normals.push_back(normal);
-		} else if (identifier == "f") {
-
-			VertexData triangle[3];
-			// 面は三角形限定。その他は未対応
-			for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
-				std::string vertexDefinition;
-				s >> vertexDefinition;
-				// 頂点の要素へのIndexは「位置/UV/法線」で格納されているので、分解してIndexを取得する
-				std::istringstream v(vertexDefinition);
-				uint32_t elementIndices[3];
-				for (int32_t element = 0; element < 3; ++element) {
-					std::string index;
-					std::getline(v, index, '/'); // /区切りでインデックスを読んでいく
-					elementIndices[element] = std::stoi(index);
-				}
-				// 要素へのIndexから、実際の要素の値を取得して、頂点を構築する
-				math::Vector4 position = positions[elementIndices[0] - 1];
-				math::Vector2 texcoord = texcoords[elementIndices[1] - 1];
-				math::Vector3 normal = normals[elementIndices[2] - 1];
-				triangle[faceVertex] = { position,texcoord,normal };
-			}
-			// 頂点を逆順で登録することで、回り順を逆にする
-			modelData.vertices.push_back(triangle[2]);
-			modelData.vertices.push_back(triangle[1]);
-			modelData.vertices.push_back(triangle[0]);
-		} else if (identifier == "mtllib") {
-			// materialTemplateLibraryファイルの名前を取得する
-			std::string materialFilename;
-			s >> materialFilename;
-			// 基本的にobjファイルと同一階層にmtlは存在させるので、ディレクトリ名とファイル名を渡す
-			modelData.material = LoadMaterialTemplateFile(directoryPath, materialFilename);
-		}
+	if (modelData_.subMeshes.empty()) {
+		return 0;
 	}
+	return modelData_.materials[modelData_.subMeshes.front().materialIndex].textureIndex;
+}
 
-	//----ModelDataを返す----
-	return modelData;
+std::vector<Model::MaterialData> Model::LoadMaterialTemplateFile(const std::string &directoryPath, const std::string &filename)
+{
+	// 解析はObjLoaderに任せる（objの解析から呼ばれるので同じ場所に置く）
+	return ObjLoader::LoadMaterialTemplateFile(directoryPath, filename);
+}
+
+Model::ModelData Model::LoadObjFile(const std::string &directoryPath, const std::string &filename)
+{
+	// 解析はObjLoaderに任せる（ファイルを一括で読み込み、バッファ上で直接解析する）
+	return ObjLoader::Load(directoryPath, filename);
 }
 
 void Model::CreateVertexBuffer(const std::vector<VertexData> &vertices)
@@ -157,16 +180,60 @@ void Model::CreateVertexBuffer(const std::vector<VertexData> &vertices)
 	std::memcpy(vertexData, vertices.data(), sizeof(VertexData) * vertices.size());
 }
 
-void Model::CreateMaterialResource()
+void Model::CreateQuantizedVertexBuffer(const std::vector<VertexData> &vertices)
 {
-	// マテリアル用バッファ作成
-	materialResource = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(Material));
+	quantized_ = true;
 
-	// 書き込みアドレス取得
-	materialResource->Map(0, nullptr, reinterpret_cast<void **>(&materialData));
+	// 量子化（位置はAABB基準、法線は八面体エンコード、UVは16bit浮動小数点）
+	std::vector<QuantizedVertexData> quantizedVertices = VertexQuantization::EncodeVertices(vertices, vertexDecodeData);
+
+	// 頂点バッファ作成
+	vertexResource = modelCommon_->GetDxCommon()->CreateBufferResource(sizeof(QuantizedVertexData) * quantizedVertices.size());
 
+	// VBV設定
+	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
+	vertexBufferView.SizeInBytes = UINT(sizeof(QuantizedVertexData) * quantizedVertices.size());
+	vertexBufferView.StrideInBytes = sizeof(QuantizedVertexData);
+
+	// 頂点データ転送（量子化した頂点は書き換えないので転送後にUnmapする）
+	void *mappedVertices = nullptr;
+	vertexResource->Map(0, nullptr, &mappedVertices);
+	std::memcpy(mappedVertices, quantizedVertices.data(), sizeof(QuantizedVertexData) * quantizedVertices.size());
+	vertexResource->Unmap(0, nullptr);
+}
+
+void Model::CreateIndexBuffer(const std::vector<uint32_t> &indices, size_t vertexCount)
+{
+	// 頂点数が16bitに収まるならインデックスも16bitにする
+	size_t indexSize = GetIndexSize(vertexCount);
+	bool use16bit = indexSize == sizeof(uint16_t);
+
+	// インデックスバッファ作成
+	indexResource = modelCommon_->GetDxCommon()->CreateBufferResource(indexSize * indices.size());
+
+	// IBV設定
+	indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
+	indexBufferView.SizeInBytes = UINT(indexSize * indices.size());
+	indexBufferView.Format = use16bit ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+
+	// インデックスデータ転送
+	void *indexData = nullptr;
+	indexResource->Map(0, nullptr, &indexData);
+	if (use16bit) {
+		uint16_t *indexData16 = static_cast<uint16_t *>(indexData);
+		for (size_t i = 0; i < indices.size(); ++i) {
+			indexData16[i] = static_cast<uint16_t>(indices[i]);
+		}
+	} else {
+		std::memcpy(indexData, indices.data(), sizeof(uint32_t) * indices.size());
+	}
+	indexResource->Unmap(0, nullptr);
+}
+
+void Model::InitializeMaterial()
+{
 	// 初期値設定
-	materialData->color = math::Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-	materialData->enableLighting = true;
-	materialData->uvTransform = math::MakeIdentity4x4();
+	materialData.color = math::Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	materialData.enableLighting = true;
+	materialData.uvTransform = math::MakeIdentity4x4();
 }
\ No newline at end of file
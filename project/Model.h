@@ -5,8 +5,10 @@
 #include <wrl.h>
 #include <d3d12.h>
 #include "MathFunctions.h"
+#include "MeshBVH.h"
 
 class ModelCommon;
+class RenderStateCache;
 
 // 3Dモデル
 class Model
@@ -21,18 +23,47 @@ public:
 		math::Vector3 normal;
 	};
 
+	// 量子化した頂点データ（16byte。展開はObject3dQuantized.VS.hlslで行う）
+	struct QuantizedVertexData
+	{
+		uint16_t position[4]; // AABBを基準にしたUNORM16（wは常に1）
+		uint16_t texcoord[2]; // 16bit浮動小数点
+		int16_t normal[2]; // 八面体エンコードしたSNORM16
+	};
+
+	// 量子化した頂点の展開用パラメータ（VS用定数バッファ）
+	struct VertexDecode
+	{
+		math::Vector3 positionScale; // AABBの大きさ
+		float padding0;
+		math::Vector3 positionOffset; // AABBの最小値
+		float padding1;
+	};
+
 	// マテリアル読み込み用
 	struct MaterialData
 	{
+		std::string name; // newmtlで付けられた名前
 		std::string textureFilePath;
 		uint32_t textureIndex = 0;
 	};
 
+	// 同じマテリアルで描く連続したインデックスの範囲
+	struct SubMesh
+	{
+		uint32_t indexStart; // インデックスの開始位置
+		uint32_t indexCount; // インデックス数
+		uint32_t materialIndex; // materialsの何番目を使うか
+	};
+
 	// モデルデータ
 	struct ModelData
 	{
-		std::vector<VertexData> vertices;
-		MaterialData material;
+		std::vector<VertexData> vertices; // 重複を除いた頂点
+		std::vector<uint32_t> indices; // 三角形リストのインデックス（サブメッシュごとに連続）
+		std::vector<MaterialData> materials; // mtlファイルのマテリアル（newmtlの順）
+		std::vector<SubMesh> subMeshes; // テクスチャが同じものが隣り合うように並べる
+		std::string materialLibraryPath; // 参照しているmtlファイルのパス（キャッシュの更新判定用）
 	};
 
 	// GPU用マテリアル
@@ -44,26 +75,84 @@ public:
 		math::Matrix4x4 uvTransform;
 	};
 
+	// 境界ボリューム（モデルのローカル座標。視錐台カリングに使う）
+	struct Bounds
+	{
+		math::AABB aabb;
+		math::Sphere sphere; // 中心はAABBの中心
+	};
+
 public: // メンバ関数
 	// 初期化
 	void Initialize(ModelCommon *modelCommon, const std::string &directorypath, const std::string &filename);
 
-	// 描画
-	void Draw();
+	// 初期化（読み込み済みのモデルデータから。quantizeVerticesがtrueなら頂点を量子化してGPUに置く）
+	void Initialize(ModelCommon *modelCommon, ModelData modelData, bool quantizeVertices = false);
+
+	/// <summary>
+	/// 描画
+	/// </summary>
+	/// <param name="instanceCount">2以上ならインスタンス描画（行列はObject3dCommonがStructuredBufferで渡す）</param>
+	/// <param name="stateCache">描画キューから描くとき、セット済みのバッファとテクスチャを省くのに使う</param>
+	void Draw(uint32_t instanceCount = 1, RenderStateCache *stateCache = nullptr);
+
+	// 初期化が終わって描画できるか（非同期読み込み中はfalse）
+	bool IsReady() const { return ready_; }
+
+	// 量子化した頂点を使っているか（Object3dCommonのPSOの切り替えに使う）
+	bool IsQuantized() const { return quantized_; }
+
+	// インデックス1つのバイト数（頂点数が16bitに収まるなら2、そうでなければ4）
+	static uint32_t GetIndexSize(size_t vertexCount) { return vertexCount <= UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+	// 最初に描くサブメッシュのテクスチャ番号（描画キューのソートキー用）
+	uint32_t GetFirstTextureIndex() const;
+
+	// モデル全体の境界ボリューム
+	const Bounds &GetBounds() const { return bounds_; }
+	// サブメッシュごとの境界ボリューム（modelData.subMeshesと同じ順）
+	const std::vector<Bounds> &GetSubMeshBounds() const { return subMeshBounds_; }
+
+	// 読み込んだモデルデータ（CPU側に残している頂点とインデックス。オクルーダーとして描くのに使う）
+	const ModelData &GetModelData() const { return modelData_; }
+
+	// ===== 三角形のBVH（ピッキングや見通しの判定用。読み込み時に作るよう指定したモデルだけが持つ） =====
+	// モデルデータから三角形のBVHを作る（どのスレッドからでも呼べる）
+	static MeshBVH BuildTriangleBVH(const ModelData &modelData);
+	// 作ったBVHを持たせる
+	void SetTriangleBVH(MeshBVH triangleBVH) { triangleBVH_ = std::move(triangleBVH); }
+	bool HasTriangleBVH() const { return !triangleBVH_.IsEmpty(); }
+	const MeshBVH &GetTriangleBVH() const { return triangleBVH_; }
+
+	/// <summary>
+	/// ローカル座標のレイと三角形の当たり判定（三角形のBVHがなければ当たらない）
+	/// </summary>
+	/// <param name="localRay">モデルのローカル座標のレイ</param>
+	/// <param name="maxDistance">調べるレイの長さ</param>
+	/// <param name="hit">最も近い当たり</param>
+	/// <returns>当たったらtrue</returns>
+	bool RayCast(const math::Ray &localRay, float maxDistance, MeshBVH::Hit &hit) const { return triangleBVH_.RayCast(localRay, maxDistance, hit); }
 
 	// ===== モデル読み込み =====
-	static MaterialData LoadMaterialTemplateFile(const std::string &directoryPath, const std::string &filename);
+	static std::vector<MaterialData> LoadMaterialTemplateFile(const std::string &directoryPath, const std::string &filename);
 
 	static ModelData LoadObjFile(const std::string &directoryPath, const std::string &filename);
 
 private:
 
 	void CreateVertexBuffer(const std::vector<VertexData> &vertices);
-	void CreateMaterialResource();
+	void CreateQuantizedVertexBuffer(const std::vector<VertexData> &vertices);
+	void CreateIndexBuffer(const std::vector<uint32_t> &indices, size_t vertexCount);
+	void InitializeMaterial();
+	// 頂点から境界ボリュームを求める
+	void ComputeBounds();
 
 private:
 
-	ModelCommon *modelCommon_;
+	ModelCommon *modelCommon_ = nullptr;
+
+	// 初期化が終わったか
+	bool ready_ = false;
 
 	// ===== モデルデータ =====
 	// objファイルから読み込んだモデル情報
@@ -76,11 +165,28 @@ private:
 	VertexData *vertexData = nullptr;
 	// 頂点バッファビュー
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView {};
+	// 量子化した頂点を使っているか
+	bool quantized_ = false;
+	// 量子化した頂点の展開用パラメータ（描画時にアップロード用リングバッファへコピーする）
+	VertexDecode vertexDecodeData {};
+
+
+	// ===== インデックスバッファ =====
+	// インデックスバッファリソース
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource = nullptr;
+	// インデックスバッファビュー（頂点数に応じて16bit/32bitを選ぶ）
+	D3D12_INDEX_BUFFER_VIEW indexBufferView {};
 
 
 	// ===== マテリアル =====
-	// マテリアル用バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource = nullptr;
-	// マテリアルデータ書き込み用ポインタ
-	Material *materialData = nullptr;
+	// マテリアルデータ（描画時にアップロード用リングバッファへコピーする）
+	Material materialData {};
+
+
+	// ===== 境界ボリューム =====
+	Bounds bounds_ {};
+	std::vector<Bounds> subMeshBounds_;
+
+	// ===== 三角形のBVH =====
+	MeshBVH triangleBVH_;
 };
\ No newline at end of file
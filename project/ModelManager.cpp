@@ -1,15 +1,82 @@
 #include "ModelManager.h"
 #include "ModelCommon.h"
-#include "DirectXCommon.h"
 #include <filesystem>
+#include <chrono>
+#include <format>
 #include "Model.h"
+#include "MeshCache.h"
+#include "MeshOptimizer.h"
+#include "ThreadPool.h"
+#include "Logger.h"
+
+namespace {
+
+	// 読み込み中のモデルの代わりに描く箱のテクスチャ
+	const char *const kPlaceholderTexturePath = "resources/textures/checkerBoard.png";
+
+	// 読み込み中のモデルの代わりに描く箱（一辺1）のモデルデータを作る
+	Model::ModelData CreatePlaceholderModelData()
+	{
+		// 各面の法線と、面上の2軸
+		struct Face
+		{
+			math::Vector3 normal;
+			math::Vector3 u;
+			math::Vector3 v;
+		};
+		const Face faces[6] = {
+			{ {  1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f, 0.0f } },
+			{ { -1.0f,  0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f, 0.0f } },
+			{ {  0.0f,  1.0f,  0.0f }, { 1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f } },
+			{ {  0.0f, -1.0f,  0.0f }, { 1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f } },
+			{ {  0.0f,  0.0f,  1.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } },
+			{ {  0.0f,  0.0f, -1.0f }, { 1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f, 0.0f } },
+		};
+		const float corners[4][2] = { { -0.5f, -0.5f }, { -0.5f, 0.5f }, { 0.5f, 0.5f }, { 0.5f, -0.5f } };
+
+		Model::ModelData modelData;
+		for (const Face &face : faces) {
+			uint32_t base = static_cast<uint32_t>(modelData.vertices.size());
+			for (const auto &corner : corners) {
+				Model::VertexData vertex {};
+				vertex.position = {
+					face.normal.x * 0.5f + face.u.x * corner[0] + face.v.x * corner[1],
+					face.normal.y * 0.5f + face.u.y * corner[0] + face.v.y * corner[1],
+					face.normal.z * 0.5f + face.u.z * corner[0] + face.v.z * corner[1],
+					1.0f };
+				vertex.texcoord = { corner[0] + 0.5f, 0.5f - corner[1] };
+				vertex.normal = face.normal;
+				modelData.vertices.push_back(vertex);
+			}
+			const uint32_t quad[6] = { 0, 1, 2, 0, 2, 3 };
+			for (uint32_t index : quad) {
+				modelData.indices.push_back(base + index);
+			}
+		}
+
+		Model::MaterialData material;
+		material.textureFilePath = kPlaceholderTexturePath;
+		modelData.materials.push_back(material);
+		modelData.subMeshes.push_back({ 0, static_cast<uint32_t>(modelData.indices.size()), 0 });
+		return modelData;
+	}
+}
 
 ModelManager *ModelManager::instance = nullptr;
 
+ModelManager::~ModelManager() = default;
+
 void ModelManager::Initialize(DirectXCommon *dxCommon) {
 
 	modelCommon = new ModelCommon;
 	modelCommon->Initialize(dxCommon);
+
+	// 読み込み用のワーカースレッド
+	threadPool = std::make_unique<ThreadPool>();
+
+	// 読み込み中に代わりに描くモデル
+	placeholderModel = std::make_unique<Model>();
+	placeholderModel->Initialize(modelCommon, CreatePlaceholderModelData());
 }
 
 ModelManager *ModelManager::GetInstance() {
@@ -25,31 +92,166 @@ void ModelManager::Finalize()
 	instance = nullptr;
 }
 
-void ModelManager::LoadModel(const std::string &filePath)
+void ModelManager::Update(double budgetMilliseconds)
 {
-	if (models.contains(filePath)) {
-		return;
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	while (true) {
+		// 読み込み終わったものを1つ取り出す
+		CompletedLoad load;
+		{
+			std::lock_guard<std::mutex> lock(completedMutex);
+			if (completedLoads.empty()) {
+				break;
+			}
+			load = std::move(completedLoads.front());
+			completedLoads.pop_front();
+		}
+
+		// GPUリソースを作る
+		FinalizeLoad(load);
+
+		// 予算を使い切ったら残りは次のフレームに回す
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+		if (elapsed.count() >= budgetMilliseconds) {
+			break;
+		}
 	}
+}
 
-	std::filesystem::path fullPath(filePath);
+AssetHandle ModelManager::LoadModel(const std::string &filePath, bool quantizeVertices, bool buildTriangleBVH)
+{
+	AssetHandle handle = models.Find(filePath);
+	if (handle.IsValid()) {
+		WarnIfOptionsDiffer(filePath, *models.Get(handle), quantizeVertices, buildTriangleBVH);
 
-	std::string directoryPath = fullPath.parent_path().string();
-	std::string fileName = fullPath.filename().string();
+		// 非同期読み込み中なら、終わるまで待ってこの場で初期化する
+		Model *pending = models.Get(handle)->model.get();
+		while (!pending->IsReady()) {
+			CompletedLoad load;
+			{
+				std::unique_lock<std::mutex> lock(completedMutex);
+				completedCondition.wait(lock, [this] { return !completedLoads.empty(); });
+				load = std::move(completedLoads.front());
+				completedLoads.pop_front();
+			}
+			FinalizeLoad(load);
+		}
+		return handle;
+	}
 
 	std::unique_ptr<Model> model = std::make_unique<Model>();
-	model->Initialize(modelCommon, directoryPath, fileName);
+	Model::ModelData modelData = LoadModelData(filePath);
+	if (buildTriangleBVH) {
+		model->SetTriangleBVH(Model::BuildTriangleBVH(modelData));
+	}
+	model->Initialize(modelCommon, std::move(modelData), quantizeVertices);
+
+	return models.Add(filePath, { std::move(model), quantizeVertices, buildTriangleBVH });
+}
+
+AssetHandle ModelManager::LoadModelAsync(const std::string &filePath, bool quantizeVertices, bool buildTriangleBVH)
+{
+	AssetHandle handle = models.Find(filePath);
+	if (handle.IsValid()) {
+		WarnIfOptionsDiffer(filePath, *models.Get(handle), quantizeVertices, buildTriangleBVH);
+		return handle;
+	}
+
+	// 先に空のモデルを登録しておく（ポインタは読み込み後も変わらない）
+	handle = models.Add(filePath, { std::make_unique<Model>(), quantizeVertices, buildTriangleBVH });
+	Model *model = models.Get(handle)->model.get();
+
+	// ファイル読み込みと解析はワーカースレッドで行い、結果を描画スレッドへ渡す
+	threadPool->Enqueue([this, model, filePath, quantizeVertices, buildTriangleBVH]() {
+		CompletedLoad load { model, filePath, LoadModelData(filePath), quantizeVertices, {} };
+		if (buildTriangleBVH) {
+			load.triangleBVH = Model::BuildTriangleBVH(load.modelData);
+		}
+		{
+			std::lock_guard<std::mutex> lock(completedMutex);
+			completedLoads.push_back(std::move(load));
+		}
+		completedCondition.notify_all();
+		});
 
-	models.insert(std::make_pair(filePath, std::move(model)));
+	return handle;
 }
 
 Model *ModelManager::FindModel(const std::string &filePath)
 {
 	// 読み込み済みモデルを検索
-	if (models.contains(filePath)) {
-		// 読み込みモデルを戻り値としてreturn
-		return models.at(filePath).get();
+	return GetModel(models.Find(filePath));
+}
+
+Model *ModelManager::GetModel(AssetHandle handle)
+{
+	ModelEntry *entry = models.Get(handle);
+	return entry ? entry->model.get() : nullptr;
+}
+
+ModelManager::ModelState ModelManager::GetModelState(const std::string &filePath)
+{
+	return GetModelState(models.Find(filePath));
+}
+
+ModelManager::ModelState ModelManager::GetModelState(AssetHandle handle)
+{
+	Model *model = GetModel(handle);
+	if (!model) {
+		return ModelState::kNotFound;
+	}
+	return model->IsReady() ? ModelState::kReady : ModelState::kPending;
+}
+
+void ModelManager::WarnIfOptionsDiffer(const std::string &filePath, const ModelEntry &entry, bool quantizeVertices, bool buildTriangleBVH)
+{
+	// 同じパスのモデルは1つだけなので、後から違う指定をしても作り直さない（BVHが無ければRayCastはAABBで判定する）
+	if (entry.quantizeVertices == quantizeVertices && entry.buildTriangleBVH == buildTriangleBVH) {
+		return;
 	}
+	Logger::Log(std::format("ModelManager: {} is already loaded with quantizeVertices={} buildTriangleBVH={}, ignoring quantizeVertices={} buildTriangleBVH={}\n",
+		filePath, entry.quantizeVertices, entry.buildTriangleBVH, quantizeVertices, buildTriangleBVH));
+}
+
+Model::ModelData ModelManager::LoadModelData(const std::string &filePath)
+{
+	std::filesystem::path fullPath(filePath);
+
+	std::string directoryPath = fullPath.parent_path().string();
+	std::string fileName = fullPath.filename().string();
 
-	// ファイル名一致なし
-	return nullptr;
+	// キャッシュが有効ならバイナリから、無効ならobjを解析してキャッシュを作り直す
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	Model::ModelData modelData;
+	bool cacheHit = MeshCache::Load(filePath, modelData);
+	if (!cacheHit) {
+		modelData = Model::LoadObjFile(directoryPath, fileName);
+		if (modelData.vertices.empty()) {
+			// 読み込めなかった（面が無い）ものは、読み込み中と同じ箱を描く。キャッシュも作らない
+			Logger::Log(std::format("ModelManager: {} has no faces or could not be read, using the placeholder model\n", filePath));
+			return CreatePlaceholderModelData();
+		}
+
+		// 頂点キャッシュ・オーバードロー・頂点フェッチ向けに並べ替えてからキャッシュに保存する
+		MeshOptimizer::Report report = MeshOptimizer::Optimize(modelData);
+		Logger::Log(std::format("MeshOptimizer: {} ACMR {:.3f} -> {:.3f} ATVR {:.3f} -> {:.3f} overfetch {:.3f} -> {:.3f}\n",
+			filePath, report.cacheBefore.acmr, report.cacheAfter.acmr, report.cacheBefore.atvr, report.cacheAfter.atvr,
+			report.fetchBefore.overfetch, report.fetchAfter.overfetch));
+
+		MeshCache::Save(filePath, modelData);
+	}
+	std::chrono::duration<double, std::milli> loadTime = std::chrono::steady_clock::now() - startTime;
+	Logger::Log(std::format("ModelManager: {} {} {:.3f}ms\n", filePath, cacheHit ? "cache hit" : "cache miss (obj)", loadTime.count()));
+
+	return modelData;
+}
+
+void ModelManager::FinalizeLoad(CompletedLoad &load)
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	load.model->SetTriangleBVH(std::move(load.triangleBVH));
+	load.model->Initialize(modelCommon, std::move(load.modelData), load.quantizeVertices);
+	std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - startTime;
+	Logger::Log(std::format("ModelManager: {} ready (GPU upload {:.3f}ms)\n", load.filePath, elapsed.count()));
 }
\ No newline at end of file
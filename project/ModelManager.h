@@ -1,17 +1,29 @@
 #pragma once
-#include <map>
 #include <string>
 #include <memory>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include "Model.h"
+#include "AssetRegistry.h"
 
-class Model;
 class ModelCommon;
 class DirectXCommon;
+class ThreadPool;
 
 // テクスチャマネージャー
 class ModelManager
 {
 public:
 
+	// モデルの読み込み状態
+	enum class ModelState
+	{
+		kNotFound, // 読み込みを依頼していない
+		kPending, // ワーカースレッドで読み込み中、または描画スレッドでの初期化待ち
+		kReady, // 描画できる
+	};
+
 	// 初期化
 	void Initialize(DirectXCommon *dxCommon);
 	// シングルトンインスタンスの取得
@@ -19,29 +31,107 @@ public:
 	// 終了
 	void Finalize();
 
+	/// <summary>
+	/// 非同期読み込みが終わったモデルのGPUリソースを作る（毎フレーム描画スレッドで呼ぶ）
+	/// </summary>
+	/// <param name="budgetMilliseconds">1フレームで使ってよい時間。最低1つは処理する</param>
+	void Update(double budgetMilliseconds = 2.0);
+
 	/// <summary>
 	/// モデルファイルの読み込み
+	/// 読み込み済みのパスは同じハンドルを返す（量子化・BVHの指定が最初の読み込みと違えばログに出し、最初の指定のまま）
 	/// </summary>
 	/// <param name="filePath">モデルファイルのパス</param>
-	void LoadModel(const std::string &filePath);
+	/// <param name="quantizeVertices">頂点を量子化してGPUに置くか（36byte→16byte）</param>
+	/// <param name="buildTriangleBVH">レイとの当たり判定用に三角形のBVHを作るか</param>
+	/// <returns>モデルのハンドル</returns>
+	AssetHandle LoadModel(const std::string &filePath, bool quantizeVertices = false, bool buildTriangleBVH = false);
+
+	/// <summary>
+	/// モデルファイルの非同期読み込み（ファイル読み込みと解析はワーカースレッドで行う）
+	/// 読み込み済み・読み込み中のパスはLoadModelと同じく同じハンドルを返す
+	/// </summary>
+	/// <param name="filePath">モデルファイルのパス</param>
+	/// <param name="quantizeVertices">頂点を量子化してGPUに置くか（36byte→16byte）</param>
+	/// <param name="buildTriangleBVH">レイとの当たり判定用に三角形のBVHを作るか（ワーカースレッドで作る）</param>
+	/// <returns>モデルのハンドル。Updateで初期化されるまではモデルのIsReadyがfalse</returns>
+	AssetHandle LoadModelAsync(const std::string &filePath, bool quantizeVertices = false, bool buildTriangleBVH = false);
 
 	/// <summary>
 	/// モデルの検索
 	/// </summary>
 	/// <param name="filePath">モデルファイルのパス</param>
-	/// <returns>モデル</returns>
+	/// <returns>モデル（読み込み中でも返す。状態はGetModelStateで確認する）</returns>
 	Model* FindModel(const std::string &filePath);
 
+	/// <summary>
+	/// モデルのハンドルの検索（毎フレーム使う場合はハンドルを保持してGetModelで取得する）
+	/// </summary>
+	/// <param name="filePath">モデルファイルのパス</param>
+	/// <returns>モデルのハンドル。見つからなければ無効なハンドル</returns>
+	AssetHandle FindModelHandle(const std::string &filePath) const { return models.Find(filePath); }
+
+	// ハンドルからモデルを取得（無効なハンドルならnullptr）
+	Model *GetModel(AssetHandle handle);
+
+	/// <summary>
+	/// モデルの読み込み状態を取得
+	/// </summary>
+	/// <param name="filePath">モデルファイルのパス</param>
+	ModelState GetModelState(const std::string &filePath);
+	ModelState GetModelState(AssetHandle handle);
+
+	// 読み込み中のモデルの代わりに描くモデル
+	Model *GetPlaceholderModel() const { return placeholderModel.get(); }
+
 private:
 	static ModelManager *instance;
 
 	ModelManager() = default;
-	~ModelManager() = default;
+	~ModelManager();
 	ModelManager(const ModelManager &) = delete;
 	ModelManager &operator=(const ModelManager &) = delete;
 
-	// モデルデータ
-	std::map<std::string, std::unique_ptr<Model>> models;
+	// ワーカースレッドで読み込み終わったモデルデータ
+	struct CompletedLoad
+	{
+		Model *model;
+		std::string filePath;
+		Model::ModelData modelData;
+		bool quantizeVertices;
+		MeshBVH triangleBVH; // 作らなければ空
+	};
+
+	// 登録したモデルと、最初に読み込んだときの指定
+	struct ModelEntry
+	{
+		std::unique_ptr<Model> model;
+		bool quantizeVertices;
+		bool buildTriangleBVH;
+	};
+
+	// 読み込み済みのモデルを別の指定で読み込もうとしたらログに出す
+	static void WarnIfOptionsDiffer(const std::string &filePath, const ModelEntry &entry, bool quantizeVertices, bool buildTriangleBVH);
+
+	// キャッシュかobjからモデルデータを読み込む（どのスレッドからでも呼べる）
+	static Model::ModelData LoadModelData(const std::string &filePath);
+
+	// 読み込み終わったモデルデータからGPUリソースを作る
+	void FinalizeLoad(CompletedLoad &load);
+
+	// モデルデータ（Modelはunique_ptrで持つので、登録が増えてもポインタは変わらない）
+	AssetRegistry<ModelEntry> models;
 
 	ModelCommon *modelCommon = nullptr;
+
+	// 読み込み中のモデルの代わりに描くモデル
+	std::unique_ptr<Model> placeholderModel;
+
+	// ワーカースレッドから描画スレッドへ渡す読み込み結果
+	std::deque<CompletedLoad> completedLoads;
+	std::mutex completedMutex;
+	std::condition_variable completedCondition;
+
+	// 読み込み用のワーカースレッド（結果の受け渡し先より先に破棄されるよう最後に置く）
+	std::unique_ptr<ThreadPool> threadPool;
 };
\ No newline at end of file
@@ -0,0 +1,712 @@
+#include "ObjLoader.h"
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <format>
+#include "Logger.h"
+
+namespace {
+
+	// 10の累乗（doubleで誤差なく表現できる範囲）
+	constexpr double kPow10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+	};
+
+	// 仮数部として保持する最大桁数（uint64_tに収まる桁数）
+	constexpr int32_t kMaxMantissaDigits = 19;
+
+	inline bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+	inline bool IsSpace(char c) { return c == ' ' || c == '\t'; }
+	inline bool IsLineEnd(char c) { return c == '\n' || c == '\r'; }
+
+	// 空白を読み飛ばす
+	inline const char *SkipSpace(const char *p, const char *end)
+	{
+		while (p < end && IsSpace(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	// 次の行の先頭まで読み飛ばす
+	inline const char *SkipLine(const char *p, const char *end)
+	{
+		const void *newline = std::memchr(p, '\n', static_cast<size_t>(end - p));
+		return newline ? static_cast<const char *>(newline) + 1 : end;
+	}
+
+	// 浮動小数点数を読む。数値が無ければ0になる
+	const char *ParseFloat(const char *p, const char *end, float &out)
+	{
+		p = SkipSpace(p, end);
+
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = (*p == '-');
+			++p;
+		}
+
+		uint64_t mantissa = 0;
+		int32_t digits = 0;
+		int32_t exponent = 0;
+
+		// 整数部
+		for (; p < end && IsDigit(*p); ++p) {
+			if (digits < kMaxMantissaDigits) {
+				mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+				if (mantissa != 0) { ++digits; }
+			} else {
+				++exponent;
+			}
+		}
+		// 小数部
+		if (p < end && *p == '.') {
+			for (++p; p < end && IsDigit(*p); ++p) {
+				if (digits < kMaxMantissaDigits) {
+					mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+					if (mantissa != 0) { ++digits; }
+					--exponent;
+				}
+			}
+		}
+		// 指数部
+		if (p < end && (*p == 'e' || *p == 'E')) {
+			++p;
+			bool negativeExponent = false;
+			if (p < end && (*p == '-' || *p == '+')) {
+				negativeExponent = (*p == '-');
+				++p;
+			}
+			int32_t e = 0;
+			for (; p < end && IsDigit(*p); ++p) {
+				if (e < 10000) { e = e * 10 + (*p - '0'); }
+			}
+			exponent += negativeExponent ? -e : e;
+		}
+
+		double value = static_cast<double>(mantissa);
+		if (exponent < 0) {
+			value = (-exponent <= 22) ? value / kPow10[-exponent] : value * std::pow(10.0, exponent);
+		} else if (exponent > 0) {
+			value = (exponent <= 22) ? value * kPow10[exponent] : value * std::pow(10.0, exponent);
+		}
+		out = static_cast<float>(negative ? -value : value);
+		return p;
+	}
+
+	// 整数を読む。数値が無ければfoundがfalseになる
+	inline const char *ParseInt(const char *p, const char *end, int32_t &out, bool &found)
+	{
+		bool negative = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negative = (*p == '-');
+			++p;
+		}
+		int32_t value = 0;
+		found = false;
+		for (; p < end && IsDigit(*p); ++p) {
+			// 桁が多すぎる値は範囲外のインデックスとして扱えるよう、あふれる前に止める
+			value = (value < INT32_MAX / 10) ? value * 10 + (*p - '0') : INT32_MAX;
+			found = true;
+		}
+		out = negative ? -value : value;
+		return p;
+	}
+
+	// 空白区切りのトークンを1つ読む
+	inline const char *ParseToken(const char *p, const char *end, std::string &out)
+	{
+		p = SkipSpace(p, end);
+		const char *tokenBegin = p;
+		while (p < end && !IsSpace(*p) && !IsLineEnd(*p)) {
+			++p;
+		}
+		out.assign(tokenBegin, p);
+		return p;
+	}
+
+	// インデックスが無いことを表す値
+	constexpr int32_t kMissingIndex = INT32_MIN;
+
+	// 1スレッドあたりの最小チャンクサイズ（これより小さいファイルは分割しない）
+	constexpr size_t kMinChunkBytes = 256 * 1024;
+
+	// 面の1頂点分（位置/UV/法線のインデックス）。解析直後の値
+	struct RawCorner
+	{
+		int32_t index[3]; // 0始まりのインデックス。無ければkMissingIndex
+		uint32_t relativeMask; // ビットiが立っていればindex[i]はチャンク先頭からの相対値
+	};
+
+	// usemtlでマテリアルが切り替わった位置
+	struct MaterialRun
+	{
+		size_t firstTriangle; // チャンク内での三角形番号
+		std::string name; // マテリアル名
+	};
+
+	// チャンク1つ分の解析結果
+	struct ChunkResult
+	{
+		std::vector<math::Vector4> positions; // 位置
+		std::vector<math::Vector2> texcoords; // テクスチャ座標
+		std::vector<math::Vector3> normals; // 法線
+		std::vector<RawCorner> corners; // 3つで1三角形（回り順は反転済み）
+		std::string materialFilename; // チャンク内で最後に現れたmtllib
+		std::vector<MaterialRun> materialRuns; // チャンク内のusemtl（現れた順）
+	};
+
+	// チャンクの要素がファイル全体で何番目から始まるか
+	struct ChunkOffset
+	{
+		size_t position = 0;
+		size_t texcoord = 0;
+		size_t normal = 0;
+		size_t triangle = 0;
+	};
+
+	// "v", "v/vt", "v//vn", "v/vt/vn" の形式を読む
+	// 負数（末尾からの相対）はチャンク内の要素数を基準にした相対値として記録する
+	const char *ParseFaceCorner(const char *p, const char *end, RawCorner &corner, const size_t localCounts[3])
+	{
+		corner.index[0] = corner.index[1] = corner.index[2] = kMissingIndex;
+		corner.relativeMask = 0;
+
+		for (uint32_t element = 0; element < 3; ++element) {
+			if (element > 0) {
+				// 区切りが無ければ残りの要素は省略されている
+				if (p >= end || *p != '/') { break; }
+				++p;
+			}
+			int32_t value = 0;
+			bool found = false;
+			p = ParseInt(p, end, value, found);
+			if (!found || value == 0) {
+				continue;
+			}
+			if (value > 0) {
+				corner.index[element] = value - 1;
+			} else {
+				corner.index[element] = static_cast<int32_t>(localCounts[element]) + value;
+				corner.relativeMask |= 1u << element;
+			}
+		}
+		// 想定外の文字はトークン末尾まで読み飛ばす
+		while (p < end && !IsSpace(*p) && !IsLineEnd(*p)) {
+			++p;
+		}
+		return p;
+	}
+
+	// チャンク（行単位で区切られたテキスト）を解析する
+	void ParseChunk(const char *begin, const char *end, ChunkResult &result)
+	{
+		//----要素数を数えて領域を確保しておく----
+		size_t positionCount = 0, texcoordCount = 0, normalCount = 0, faceCount = 0;
+		for (const char *p = begin; p < end; p = SkipLine(p, end)) {
+			const char *q = SkipSpace(p, end);
+			if (end - q < 2) { continue; }
+			if (q[0] == 'v') {
+				if (IsSpace(q[1])) { ++positionCount; }
+				else if (q[1] == 't') { ++texcoordCount; }
+				else if (q[1] == 'n') { ++normalCount; }
+			} else if (q[0] == 'f' && IsSpace(q[1])) {
+				++faceCount;
+			}
+		}
+		result.positions.reserve(positionCount);
+		result.texcoords.reserve(texcoordCount);
+		result.normals.reserve(normalCount);
+		result.corners.reserve(faceCount * 3);
+
+		//----1行ずつ解析していく----
+		std::vector<RawCorner> polygon; // 面を構成する頂点（多角形にも対応）
+		for (const char *p = begin; p < end; p = SkipLine(p, end)) {
+			const char *q = SkipSpace(p, end);
+			if (end - q < 2) { continue; }
+
+			if (q[0] == 'v' && IsSpace(q[1])) {
+				math::Vector4 position {};
+				q = ParseFloat(q + 1, end, position.x);
+				q = ParseFloat(q, end, position.y);
+				q = ParseFloat(q, end, position.z);
+				position.w = 1.0f;
+				result.positions.push_back(position);
+			} else if (q[0] == 'v' && q[1] == 't') {
+				math::Vector2 texcoord {};
+				q = ParseFloat(q + 2, end, texcoord.x);
+				q = ParseFloat(q, end, texcoord.y);
+				texcoord.y = 1.0f - texcoord.y;
+				result.texcoords.push_back(texcoord);
+			} else if (q[0] == 'v' && q[1] == 'n') {
+				math::Vector3 normal {};
+				q = ParseFloat(q + 2, end, normal.x);
+				q = ParseFloat(q, end, normal.y);
+				q = ParseFloat(q, end, normal.z);
+				normal.x *= -1.0f;
+				result.normals.push_back(normal);
+			} else if (q[0] == 'f' && IsSpace(q[1])) {
+				// 面を構成する頂点を行末まで読む
+				const size_t localCounts[3] = { result.positions.size(), result.texcoords.size(), result.normals.size() };
+				polygon.clear();
+				q = SkipSpace(q + 1, end);
+				while (q < end && !IsLineEnd(*q)) {
+					RawCorner corner;
+					q = ParseFaceCorner(q, end, corner, localCounts);
+					polygon.push_back(corner);
+					q = SkipSpace(q, end);
+				}
+
+				// 三角形の扇で分割し、頂点を逆順で登録することで回り順を逆にする
+				for (size_t i = 1; i + 1 < polygon.size(); ++i) {
+					result.corners.push_back(polygon[i + 1]);
+					result.corners.push_back(polygon[i]);
+					result.corners.push_back(polygon[0]);
+				}
+			} else if (end - q > 6 && std::strncmp(q, "mtllib", 6) == 0 && IsSpace(q[6])) {
+				// materialTemplateLibraryファイルの名前を取得する
+				ParseToken(q + 6, end, result.materialFilename);
+			} else if (end - q > 6 && std::strncmp(q, "usemtl", 6) == 0 && IsSpace(q[6])) {
+				// 以降の面で使うマテリアルを切り替える
+				MaterialRun run { result.corners.size() / 3, std::string() };
+				ParseToken(q + 6, end, run.name);
+				result.materialRuns.push_back(std::move(run));
+			}
+		}
+	}
+
+	// 解析したインデックスをファイル全体でのインデックスに変換する。無効なら-1
+	inline int64_t ResolveIndex(const RawCorner &corner, uint32_t element, size_t base, size_t count)
+	{
+		if (corner.index[element] == kMissingIndex) {
+			return -1;
+		}
+		int64_t index = corner.index[element];
+		if (corner.relativeMask & (1u << element)) {
+			index += static_cast<int64_t>(base);
+		}
+		return (index >= 0 && index < static_cast<int64_t>(count)) ? index : -1;
+	}
+
+	// 面法線（法線の無いobj用）。objの座標系で計算し、読み込み時と同じくxを反転する
+	math::Vector3 ComputeFaceNormal(const math::Vector4 &p0, const math::Vector4 &p1, const math::Vector4 &p2)
+	{
+		math::Vector3 e1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+		math::Vector3 e2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+		// 登録順は反転済みなので、objでの回り順に戻すため外積の向きを逆にする
+		math::Vector3 n = {
+			e2.y * e1.z - e2.z * e1.y,
+			e2.z * e1.x - e2.x * e1.z,
+			e2.x * e1.y - e2.y * e1.x,
+		};
+		float length = std::sqrt(n.x * n.x + n.y * n.y + n.z * n.z);
+		if (length == 0.0f) {
+			return { 0.0f, 1.0f, 0.0f };
+		}
+		return { -n.x / length, n.y / length, n.z / length };
+	}
+
+	// 頂点の重複判定に使うキー（位置/UV/法線のファイル全体でのインデックス）
+	struct VertexKey
+	{
+		int32_t position;
+		int32_t texcoord; // 無ければ-1
+		int32_t normal; // 無ければ-1（面法線を使うので共有しない）
+
+		bool operator==(const VertexKey &other) const
+		{
+			return position == other.position && texcoord == other.texcoord && normal == other.normal;
+		}
+	};
+
+	inline uint32_t HashVertexKey(const VertexKey &key)
+	{
+		uint32_t h = static_cast<uint32_t>(key.position) * 0x9E3779B1u;
+		h ^= static_cast<uint32_t>(key.texcoord) * 0x85EBCA77u;
+		h ^= static_cast<uint32_t>(key.normal) * 0xC2B2AE3Du;
+		h ^= h >> 15;
+		h *= 0x2C1B3C6Du;
+		h ^= h >> 13;
+		return h;
+	}
+
+	// 三角形の範囲 [firstTriangle, lastTriangle) の頂点キーを求める
+	// 位置のインデックスが無い・範囲外の頂点はpositionが-1になる（その三角形はGroupTrianglesByMaterialで読み飛ばす）
+	void ResolveTriangles(const std::vector<ChunkResult> &chunks, const std::vector<ChunkOffset> &offsets,
+		size_t positionCount, size_t texcoordCount, size_t normalCount,
+		size_t firstTriangle, size_t lastTriangle, VertexKey *keys)
+	{
+		// 範囲の先頭を含むチャンクを探す
+		size_t chunkIndex = 0;
+		while (chunkIndex + 1 < chunks.size() && offsets[chunkIndex + 1].triangle <= firstTriangle) {
+			++chunkIndex;
+		}
+
+		for (size_t triangle = firstTriangle; triangle < lastTriangle; ++triangle) {
+			while (triangle >= offsets[chunkIndex].triangle + chunks[chunkIndex].corners.size() / 3) {
+				++chunkIndex;
+			}
+			const ChunkOffset &offset = offsets[chunkIndex];
+			const RawCorner *corners = &chunks[chunkIndex].corners[(triangle - offset.triangle) * 3];
+			VertexKey *out = &keys[triangle * 3];
+
+			for (uint32_t i = 0; i < 3; ++i) {
+				out[i].position = static_cast<int32_t>(ResolveIndex(corners[i], 0, offset.position, positionCount));
+				out[i].texcoord = static_cast<int32_t>(ResolveIndex(corners[i], 1, offset.texcoord, texcoordCount));
+				out[i].normal = static_cast<int32_t>(ResolveIndex(corners[i], 2, offset.normal, normalCount));
+			}
+		}
+	}
+
+	// 頂点キーの重複を取り除き、頂点配列とインデックス配列を構築する
+	void BuildIndexedVertices(const std::vector<VertexKey> &keys,
+		const std::vector<math::Vector4> &positions, const std::vector<math::Vector2> &texcoords, const std::vector<math::Vector3> &normals,
+		Model::ModelData &modelData)
+	{
+		// オープンアドレス法のハッシュテーブル（頂点番号を格納）
+		size_t capacity = 16;
+		while (capacity < keys.size() * 2) {
+			capacity <<= 1;
+		}
+		const size_t mask = capacity - 1;
+		constexpr uint32_t kEmpty = UINT32_MAX;
+		std::vector<uint32_t> table(capacity, kEmpty);
+		std::vector<VertexKey> uniqueKeys;
+		uniqueKeys.reserve(keys.size());
+
+		modelData.indices.resize(keys.size());
+		modelData.vertices.clear();
+		modelData.vertices.reserve(keys.size());
+
+		for (size_t corner = 0; corner < keys.size(); ++corner) {
+			const VertexKey &key = keys[corner];
+
+			// 法線が無い頂点は面ごとに法線が異なるので共有しない
+			uint32_t vertexIndex = kEmpty;
+			size_t slot = 0;
+			bool shareable = (key.normal >= 0);
+			if (shareable) {
+				slot = HashVertexKey(key) & mask;
+				while (table[slot] != kEmpty) {
+					if (uniqueKeys[table[slot]] == key) {
+						vertexIndex = table[slot];
+						break;
+					}
+					slot = (slot + 1) & mask;
+				}
+			}
+
+			if (vertexIndex == kEmpty) {
+				// 新しい頂点を登録する
+				vertexIndex = static_cast<uint32_t>(modelData.vertices.size());
+				Model::VertexData vertex {};
+				vertex.position = positions[key.position];
+				vertex.texcoord = (key.texcoord >= 0) ? texcoords[key.texcoord] : math::Vector2 { 0.0f, 0.0f };
+				if (shareable) {
+					vertex.normal = normals[key.normal];
+					table[slot] = vertexIndex;
+				} else {
+					const VertexKey *triangle = &keys[corner - corner % 3];
+					vertex.normal = ComputeFaceNormal(positions[triangle[0].position],
+						positions[triangle[1].position], positions[triangle[2].position]);
+				}
+				modelData.vertices.push_back(vertex);
+				uniqueKeys.push_back(key);
+			}
+			modelData.indices[corner] = vertexIndex;
+		}
+		modelData.vertices.shrink_to_fit();
+	}
+
+	// 三角形の3頂点とも位置のインデックスが有効か
+	inline bool IsValidTriangle(const VertexKey *corners)
+	{
+		return corners[0].position >= 0 && corners[1].position >= 0 && corners[2].position >= 0;
+	}
+
+	// 名前からマテリアルの番号を探す。見つからなければ先頭のマテリアルを使う
+	uint32_t FindMaterialIndex(const std::vector<Model::MaterialData> &materials, const std::string &name)
+	{
+		for (size_t i = 0; i < materials.size(); ++i) {
+			if (materials[i].name == name) {
+				return static_cast<uint32_t>(i);
+			}
+		}
+		return 0;
+	}
+
+	// 三角形をマテリアルごとにまとめ、サブメッシュの範囲を求める
+	// マテリアルはテクスチャのパス順に並べ、同じテクスチャのサブメッシュが隣り合うようにする
+	// 位置のインデックスが無効な頂点を含む三角形はここで取り除く
+	// 戻り値は取り除いた三角形の数
+	size_t GroupTrianglesByMaterial(const std::vector<ChunkResult> &chunks, const std::vector<ChunkOffset> &offsets,
+		const std::vector<Model::MaterialData> &materials, std::vector<VertexKey> &keys, std::vector<Model::SubMesh> &subMeshes)
+	{
+		const size_t triangleCount = keys.size() / 3;
+		// 取り除く三角形に付けるマテリアル番号
+		constexpr uint32_t kSkippedTriangle = UINT32_MAX;
+
+		//----三角形ごとのマテリアルを求める（usemtlの前の面は先頭のマテリアル）----
+		std::vector<uint32_t> triangleMaterials(triangleCount, 0);
+		uint32_t currentMaterial = 0;
+		for (size_t i = 0; i < chunks.size(); ++i) {
+			size_t cursor = offsets[i].triangle;
+			for (const MaterialRun &run : chunks[i].materialRuns) {
+				size_t runStart = offsets[i].triangle + run.firstTriangle;
+				std::fill(triangleMaterials.begin() + cursor, triangleMaterials.begin() + runStart, currentMaterial);
+				cursor = runStart;
+				currentMaterial = FindMaterialIndex(materials, run.name);
+			}
+			std::fill(triangleMaterials.begin() + cursor, triangleMaterials.begin() + offsets[i + 1].triangle, currentMaterial);
+		}
+
+		//----壊れた面（位置の無い頂点・範囲外のインデックス）を除外する----
+		size_t skippedCount = 0;
+		for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+			if (!IsValidTriangle(&keys[triangle * 3])) {
+				triangleMaterials[triangle] = kSkippedTriangle;
+				++skippedCount;
+			}
+		}
+
+		//----マテリアルの描画順を決める----
+		std::vector<uint32_t> materialOrder(materials.size());
+		for (uint32_t i = 0; i < materialOrder.size(); ++i) {
+			materialOrder[i] = i;
+		}
+		std::stable_sort(materialOrder.begin(), materialOrder.end(), [&](uint32_t lhs, uint32_t rhs) {
+			return materials[lhs].textureFilePath < materials[rhs].textureFilePath;
+			});
+
+		//----マテリアルごとの三角形数から、サブメッシュの開始位置を求める----
+		std::vector<size_t> counts(materials.size(), 0);
+		for (uint32_t material : triangleMaterials) {
+			if (material != kSkippedTriangle) {
+				++counts[material];
+			}
+		}
+		std::vector<size_t> starts(materials.size(), 0);
+		size_t start = 0;
+		subMeshes.clear();
+		for (uint32_t material : materialOrder) {
+			starts[material] = start;
+			if (counts[material] > 0) {
+				subMeshes.push_back({ static_cast<uint32_t>(start * 3), static_cast<uint32_t>(counts[material] * 3), material });
+			}
+			start += counts[material];
+		}
+
+		//----三角形を並べ替える（マテリアルが1つしか使われておらず、取り除く三角形も無ければそのまま）----
+		if (subMeshes.size() <= 1 && skippedCount == 0) {
+			return 0;
+		}
+		std::vector<VertexKey> groupedKeys((triangleCount - skippedCount) * 3);
+		for (size_t triangle = 0; triangle < triangleCount; ++triangle) {
+			if (triangleMaterials[triangle] == kSkippedTriangle) {
+				continue;
+			}
+			size_t destination = starts[triangleMaterials[triangle]]++;
+			std::memcpy(&groupedKeys[destination * 3], &keys[triangle * 3], sizeof(VertexKey) * 3);
+		}
+		keys.swap(groupedKeys);
+		return skippedCount;
+	}
+
+	// count個の処理を並列に実行する（0番目は呼び出しスレッドで実行）
+	template <class Function>
+	void RunParallel(uint32_t count, Function function)
+	{
+		std::vector<std::thread> threads;
+		threads.reserve(count > 0 ? count - 1 : 0);
+		for (uint32_t i = 1; i < count; ++i) {
+			threads.emplace_back(function, i);
+		}
+		if (count > 0) {
+			function(0u);
+		}
+		for (std::thread &thread : threads) {
+			thread.join();
+		}
+	}
+
+	// 要素配列を連結先の指定位置へコピーする
+	template <class T>
+	void CopyTo(const std::vector<T> &source, std::vector<T> &destination, size_t offset)
+	{
+		if (!source.empty()) {
+			std::memcpy(destination.data() + offset, source.data(), sizeof(T) * source.size());
+		}
+	}
+}
+
+namespace ObjLoader {
+
+	Model::ModelData Load(const std::string &directoryPath, const std::string &filename, uint32_t threadCount, LoadStats *stats)
+	{
+		//----ファイルを一括で読み込む----
+		// 開けない・大きさが分からないときは空のモデルにする（呼び出し側で代わりのモデルを使う）
+		const std::string filePath = directoryPath + "/" + filename;
+		std::ifstream file(filePath, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) {
+			Logger::Log(std::format("ObjLoader: failed to open {}\n", filePath));
+			return {};
+		}
+
+		std::streamsize size = file.tellg();
+		if (size < 0) {
+			Logger::Log(std::format("ObjLoader: failed to read {}\n", filePath));
+			return {};
+		}
+		file.seekg(0, std::ios::beg);
+
+		std::string buffer;
+		buffer.resize(static_cast<size_t>(size));
+		file.read(buffer.data(), size);
+
+		//----バッファを解析する----
+		return Parse(buffer.data(), buffer.data() + buffer.size(), directoryPath, threadCount, stats);
+	}
+
+	Model::ModelData Parse(const char *begin, const char *end, const std::string &directoryPath, uint32_t threadCount, LoadStats *stats)
+	{
+		using Clock = std::chrono::steady_clock;
+		Clock::time_point startTime = Clock::now();
+
+		//----スレッド数を決める----
+		const size_t size = static_cast<size_t>(end - begin);
+		if (threadCount == 0) {
+			threadCount = (std::max)(1u, std::thread::hardware_concurrency());
+		}
+		const size_t maxChunks = (std::max)(size_t(1), size / kMinChunkBytes);
+		const uint32_t chunkCount = static_cast<uint32_t>((std::min)(static_cast<size_t>(threadCount), maxChunks));
+
+		//----改行位置でチャンクに分割する----
+		std::vector<const char *> boundaries(chunkCount + 1);
+		boundaries[0] = begin;
+		for (uint32_t i = 1; i < chunkCount; ++i) {
+			const char *split = begin + size * i / chunkCount;
+			split = (std::max)(split, boundaries[i - 1]);
+			boundaries[i] = SkipLine(split, end);
+		}
+		boundaries[chunkCount] = end;
+
+		//----チャンクごとに並列で解析する----
+		std::vector<ChunkResult> chunks(chunkCount);
+		RunParallel(chunkCount, [&](uint32_t i) {
+			ParseChunk(boundaries[i], boundaries[i + 1], chunks[i]);
+			});
+		Clock::time_point parseEndTime = Clock::now();
+
+		//----要素数の累積和から各チャンクの開始位置を求める----
+		std::vector<ChunkOffset> offsets(chunkCount + 1);
+		for (uint32_t i = 0; i < chunkCount; ++i) {
+			offsets[i + 1].position = offsets[i].position + chunks[i].positions.size();
+			offsets[i + 1].texcoord = offsets[i].texcoord + chunks[i].texcoords.size();
+			offsets[i + 1].normal = offsets[i].normal + chunks[i].normals.size();
+			offsets[i + 1].triangle = offsets[i].triangle + chunks[i].corners.size() / 3;
+		}
+		const ChunkOffset &total = offsets[chunkCount];
+
+		//----要素配列を連結する----
+		std::vector<math::Vector4> positions(total.position);
+		std::vector<math::Vector2> texcoords(total.texcoord);
+		std::vector<math::Vector3> normals(total.normal);
+		RunParallel(chunkCount, [&](uint32_t i) {
+			CopyTo(chunks[i].positions, positions, offsets[i].position);
+			CopyTo(chunks[i].texcoords, texcoords, offsets[i].texcoord);
+			CopyTo(chunks[i].normals, normals, offsets[i].normal);
+			});
+
+		//----面を並列で頂点キーに変換する（三角形数で均等に分ける）----
+		std::vector<VertexKey> keys(total.triangle * 3);
+		const uint32_t resolveCount = static_cast<uint32_t>((std::min)(static_cast<size_t>(chunkCount), (std::max)(total.triangle, size_t(1))));
+		RunParallel(resolveCount, [&](uint32_t i) {
+			size_t firstTriangle = total.triangle * i / resolveCount;
+			size_t lastTriangle = total.triangle * (i + 1) / resolveCount;
+			ResolveTriangles(chunks, offsets, total.position, total.texcoord, total.normal, firstTriangle, lastTriangle, keys.data());
+			});
+
+		//----マテリアルを読み込む（最後に現れたmtllibを使う）----
+		Model::ModelData modelData;
+		for (auto it = chunks.rbegin(); it != chunks.rend(); ++it) {
+			if (!it->materialFilename.empty()) {
+				// 基本的にobjファイルと同一階層にmtlは存在させるので、ディレクトリ名とファイル名を渡す
+				modelData.materials = LoadMaterialTemplateFile(directoryPath, it->materialFilename);
+				modelData.materialLibraryPath = directoryPath + "/" + it->materialFilename;
+				break;
+			}
+		}
+		// マテリアルが無くても描画できるように1つは用意しておく
+		if (modelData.materials.empty()) {
+			modelData.materials.emplace_back();
+		}
+
+		//----三角形をマテリアルごとにまとめる----
+		size_t skippedTriangles = GroupTrianglesByMaterial(chunks, offsets, modelData.materials, keys, modelData.subMeshes);
+
+		//----重複した頂点をまとめてインデックス化する----
+		BuildIndexedVertices(keys, positions, texcoords, normals, modelData);
+		Clock::time_point resolveEndTime = Clock::now();
+
+		//----計測結果を記録する----
+		if (stats) {
+			stats->bytes = size;
+			stats->triangles = keys.size() / 3;
+			stats->skippedTriangles = skippedTriangles;
+			stats->vertices = modelData.vertices.size();
+			stats->threadCount = chunkCount;
+			stats->parseSeconds = std::chrono::duration<double>(parseEndTime - startTime).count();
+			stats->resolveSeconds = std::chrono::duration<double>(resolveEndTime - parseEndTime).count();
+		}
+
+		//----ModelDataを返す----
+		return modelData;
+	}
+
+	std::vector<Model::MaterialData> LoadMaterialTemplateFile(const std::string &directoryPath, const std::string &filename)
+	{
+		//----中で必要となる変数の宣言----
+		std::vector<Model::MaterialData> materials; // 構築するMaterialData（newmtlごとに1つ）
+		std::string line; // ファイルから読んだ1行を格納するもの
+
+		//----ファイルを開く----
+		std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
+		if (!file.is_open()) {
+			// 開けなければマテリアルなし（呼び出し側で既定のマテリアルを1つ用意する）
+			Logger::Log(std::format("ObjLoader: failed to open {}/{}\n", directoryPath, filename));
+			return materials;
+		}
+
+		//----ファイルを読み込んで、MaterialDataを構築する----
+		while (std::getline(file, line)) {
+			std::string identifier;
+			std::istringstream s(line);
+			s >> identifier;
+
+			// identiffierに応じた処理
+			if (identifier == "newmtl") {
+				// 新しいマテリアルの開始
+				materials.emplace_back();
+				s >> materials.back().name;
+			} else if (identifier == "map_Kd") {
+				std::string textureFilename;
+				s >> textureFilename;
+				// newmtlより前に書かれていたら名前なしのマテリアルとして扱う
+				if (materials.empty()) {
+					materials.emplace_back();
+				}
+				// 連結してファイルパスにする
+				materials.back().textureFilePath = directoryPath + "/" + textureFilename;
+			}
+		}
+
+		//----MaterialDataを返す----
+		return materials;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <string>
+#include <cstdint>
+#include "Model.h"
+
+// OBJファイル読み込み
+// ファイルを一括で読み込み、バッファ上で直接トークンを解析する（行ごとのstring生成をしない）
+// 大きいファイルは改行位置でチャンクに分割し、解析と面の変換を複数スレッドで行う
+// 位置/UV/法線のインデックスの組が同じ頂点は1つにまとめ、インデックス付きのデータを出力する
+// 面はusemtlで指定されたマテリアルごとにまとめ、連続したインデックスの範囲（サブメッシュ）にする
+// 位置のインデックスが無い・範囲外の頂点を含む面は読み飛ばす（壊れたファイルでも範囲外を読まない）
+namespace ObjLoader
+{
+	// 読み込みの計測結果
+	struct LoadStats
+	{
+		size_t bytes = 0; // 解析したバイト数
+		size_t triangles = 0; // 三角形数
+		size_t skippedTriangles = 0; // 位置のインデックスが無い・範囲外だったので読み飛ばした三角形数
+		size_t vertices = 0; // 重複を除いた頂点数
+		uint32_t threadCount = 0; // 実際に使ったスレッド数
+		double parseSeconds = 0.0; // テキスト解析にかかった時間
+		double resolveSeconds = 0.0; // 配列の連結と面の変換、頂点の重複除去にかかった時間
+	};
+
+	/// <summary>
+	/// objファイルを読み込んでModelDataを構築する
+	/// </summary>
+	/// <param name="directoryPath">objファイルのあるディレクトリ</param>
+	/// <param name="filename">objファイル名</param>
+	/// <param name="threadCount">使用するスレッド数。0ならハードウェアのスレッド数</param>
+	/// <param name="stats">計測結果の出力先（不要ならnullptr）</param>
+	Model::ModelData Load(const std::string &directoryPath, const std::string &filename, uint32_t threadCount = 0, LoadStats *stats = nullptr);
+
+	/// <summary>
+	/// メモリ上のobjテキストを解析してModelDataを構築する
+	/// </summary>
+	/// <param name="begin">テキストの先頭</param>
+	/// <param name="end">テキストの終端</param>
+	/// <param name="directoryPath">mtlファイルを探すディレクトリ</param>
+	/// <param name="threadCount">使用するスレッド数。0ならハードウェアのスレッド数</param>
+	/// <param name="stats">計測結果の出力先（不要ならnullptr）</param>
+	Model::ModelData Parse(const char *begin, const char *end, const std::string &directoryPath, uint32_t threadCount = 0, LoadStats *stats = nullptr);
+
+	/// <summary>
+	/// mtlファイルを読み込む
+	/// </summary>
+	/// <param name="directoryPath">mtlファイルのあるディレクトリ（テクスチャのパスもここからの相対で解決する）</param>
+	/// <param name="filename">mtlファイル名</param>
+	/// <returns>newmtlごとのマテリアル（書かれた順）</returns>
+	std::vector<Model::MaterialData> LoadMaterialTemplateFile(const std::string &directoryPath, const std::string &filename);
+}
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "TextureManager.h"
 #include "Model.h"
 #include "ModelManager.h"
+#include "RenderQueue.h"
+#include "BoundingVolume.h"
+#include "OcclusionBuffer.h"
 
 using namespace math;
 
@@ -11,9 +14,9 @@ void Object3d::Initialize(Object3dCommon *object3dCommon)
 {
 	this->object3dCommon = object3dCommon;
 
-	// ===== GPUリソース生成 =====
-	CreateTransformationMatrixResource();
-	CreateDirectionalLight();
+	// ===== 定数バッファのデータ初期化 =====
+	InitializeTransformationMatrix();
+	InitializeDirectionalLight();
 
 	// ===== Transform初期化 =====
 	transform = {
@@ -21,71 +24,146 @@ void Object3d::Initialize(Object3dCommon *object3dCommon)
 		{0.0f, 0.0f, 0.0f},   // rotate
 		{0.0f, 0.0f, 0.0f}    // translate
 	};
-
-	cameraTransform = {
-		{1.0f, 1.0f, 1.0f},   // scale
-		{0.3f, 0.0f, 0.0f},   // rotate
-		{0.0f, 4.0f, -10.0f}  // translate
-	};
 }
 
 void Object3d::Update()
 {
 	// ===== ワールド行列 =====
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-
-	// ===== ビュー行列（カメラ） =====
-	Matrix4x4 cameraMatrix = MakeAffineMatrix(cameraTransform.scale, cameraTransform.rotate, cameraTransform.translate);
-	Matrix4x4 viewMatrix = Inverse(cameraMatrix);
-
-	// ===== 射影行列 =====
-	Matrix4x4 projectionMatrix = MakePerspectiveFovMatrix(0.45f, float(WinApp::kClientWidth) / float(WinApp::kClientHeight), 0.1f, 100.0f);
-
-	// ===== 定数バッファへ反映 =====
-	transformationMatrixData->WVP = worldMatrix * viewMatrix * projectionMatrix;
-	transformationMatrixData->World = worldMatrix;
+	// ビュー射影行列はカメラ側でフレームに1回だけ作り、シェーダーで掛ける
+	transformationMatrixData.World = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+
+	// ===== ワールド座標の境界ボリューム =====
+	if (Model *drawModel = GetDrawModel()) {
+		AABB previousAABB = worldBounds.aabb;
+		worldBounds.aabb = TransformAABB(drawModel->GetBounds().aabb, transformationMatrixData.World);
+		worldBounds.sphere = TransformSphere(drawModel->GetBounds().sphere, transformationMatrixData.World);
+
+		// シーンのBVHに登録されていれば、箱が変わったときだけ知らせる（止まっているものは付け直さない）
+		bool moved = previousAABB.min.x != worldBounds.aabb.min.x || previousAABB.min.y != worldBounds.aabb.min.y || previousAABB.min.z != worldBounds.aabb.min.z ||
+			previousAABB.max.x != worldBounds.aabb.max.x || previousAABB.max.y != worldBounds.aabb.max.y || previousAABB.max.z != worldBounds.aabb.max.z;
+		if (moved && sceneProxy != SceneBVH::kNullProxy) {
+			object3dCommon->GetSceneBVH().MoveProxy(sceneProxy, worldBounds.aabb);
+		}
+	}
 }
 
 void Object3d::Draw()
 {
-	object3dCommon->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
-	object3dCommon->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(3, directionalLightResource->GetGPUVirtualAddress());
+	// 視錐台の外か、オクルーダーに隠れていれば描かない
+	if (!visible) {
+		return;
+	}
+
+	// インスタンス描画ならモデルごとにまとめてObject3dCommon::DrawInstancesで描く
+	if (object3dCommon->IsInstancingEnabled()) {
+		if (modelHandle.IsValid()) {
+			object3dCommon->AddInstance(this, transformationMatrixData.World);
+		}
+		return;
+	}
 
 	// 3Dモデルが割り当てられていれば描画する
-	if (model) {
-		model->Draw();
+	Model *drawModel = GetDrawModel();
+	if (!drawModel) {
+		return;
+	}
+
+	// 描画キューがあれば、パイプライン→テクスチャ→モデル→手前から の順に並ぶキーでパケットを積む
+	if (RenderQueue *renderQueue = object3dCommon->GetRenderQueue()) {
+		uint32_t depth = 0;
+		if (const Camera *camera = object3dCommon->GetDefaultCamera()) {
+			// ビュー空間のzをニアからファーまでで0～1にする
+			const Matrix4x4 &world = transformationMatrixData.World;
+			const Matrix4x4 &view = camera->GetViewMatrix();
+			float viewZ = world.m[3][0] * view.m[0][2] + world.m[3][1] * view.m[1][2] + world.m[3][2] * view.m[2][2] + view.m[3][2];
+			depth = RenderQueue::QuantizeDepth((viewZ - camera->GetNearClip()) / (camera->GetFarClip() - camera->GetNearClip()));
+		}
+		uint64_t sortKey = RenderQueue::MakeSortKey(RenderPass::kObject3d, drawModel->IsQuantized() ? 1 : 0,
+			drawModel->GetFirstTextureIndex(), modelHandle.index, depth);
+		renderQueue->Submit(sortKey, [](const void *object, RenderStateCache &stateCache) {
+			const Object3d *object3d = static_cast<const Object3d *>(object);
+			if (Model *model = object3d->GetDrawModel()) {
+				object3d->Render(model, &stateCache);
+			}
+			}, this);
+		return;
 	}
+
+	Render(drawModel, nullptr);
 }
 
-void Object3d::CreateTransformationMatrixResource()
+bool Object3d::RayCast(const Ray &ray, float maxDistance, float &distance) const
 {
-	// 座標変換行列用リソース作成
-	transformationMatrixResource = object3dCommon->GetDxCommon()->CreateBufferResource(sizeof(TransformationMatrix));
+	Model *drawModel = GetDrawModel();
+	if (!drawModel || !drawModel->HasTriangleBVH()) {
+		return IntersectRay(ray, MakeInverseDirection(ray.direction), worldBounds.aabb, maxDistance, distance);
+	}
 
-	// 書き込み用アドレス取得
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void **>(&transformationMatrixData));
+	// レイをローカル座標に移す（方向は正規化しないので、距離はワールド座標のレイと同じになる）
+	Matrix4x4 inverseWorld = Inverse(transformationMatrixData.World);
+	Ray localRay = { ApplyTransform(ray.origin, inverseWorld), TransformNormal(ray.direction, inverseWorld) };
 
-	// 単位行列で初期化
-	transformationMatrixData->WVP = math::MakeIdentity4x4();
-	transformationMatrixData->World = math::MakeIdentity4x4();
+	MeshBVH::Hit hit;
+	if (!drawModel->RayCast(localRay, maxDistance, hit)) {
+		return false;
+	}
+	distance = hit.distance;
+	return true;
 }
 
-void Object3d::CreateDirectionalLight()
+void Object3d::RenderOccluder(OcclusionBuffer &occlusionBuffer) const
 {
-	// 平行光源用バッファ作成
-	directionalLightResource = object3dCommon->GetDxCommon()->CreateBufferResource(sizeof(DirectionalLight));
+	// 代わりのモデルで隠すと見えている物を消してしまうので、読み込みが終わったモデルだけ描く
+	Model *model = ModelManager::GetInstance()->GetModel(modelHandle);
+	if (!model || !model->IsReady()) {
+		return;
+	}
+	const Model::ModelData &modelData = model->GetModelData();
+	if (modelData.vertices.empty()) {
+		return;
+	}
+	occlusionBuffer.RenderOccluder(&modelData.vertices[0].position.x, sizeof(Model::VertexData), modelData.vertices.size(),
+		modelData.indices.data(), modelData.indices.size(), transformationMatrixData.World);
+}
 
-	// 書き込みアドレス取得
-	directionalLightResource->Map(0, nullptr, reinterpret_cast<void **>(&directionalLightData));
+Model *Object3d::GetDrawModel() const
+{
+	// 読み込み中なら代わりのモデルを描く
+	Model *drawModel = ModelManager::GetInstance()->GetModel(modelHandle);
+	if (drawModel && !drawModel->IsReady()) {
+		drawModel = ModelManager::GetInstance()->GetPlaceholderModel();
+	}
+	return drawModel;
+}
 
+void Object3d::Render(Model *drawModel, RenderStateCache *stateCache) const
+{
+	// 定数バッファはこのフレーム用の領域にコピーして設定する
+	DirectXCommon *dxCommon = object3dCommon->GetDxCommon();
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(1, dxCommon->UploadConstantBuffer(transformationMatrixData));
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(3, dxCommon->UploadConstantBuffer(directionalLightData));
+
+	// 量子化した頂点のモデルは専用のPSOで描く
+	object3dCommon->SetVertexPipeline(drawModel->IsQuantized(), false, stateCache);
+	drawModel->Draw(1, stateCache);
+}
+
+void Object3d::InitializeTransformationMatrix()
+{
+	// 単位行列で初期化
+	transformationMatrixData.World = math::MakeIdentity4x4();
+}
+
+void Object3d::InitializeDirectionalLight()
+{
 	// 初期値設定
-	directionalLightData->color = { 1.0f, 1.0f, 1.0f, 1.0f };
-	directionalLightData->direction = { 0.0f, -1.0f, 0.0f };
-	directionalLightData->intensity = 1.0f;
+	directionalLightData.color = { 1.0f, 1.0f, 1.0f, 1.0f };
+	directionalLightData.direction = { 0.0f, -1.0f, 0.0f };
+	directionalLightData.intensity = 1.0f;
 }
 
 void Object3d::SetModel(const std::string &filePath)
 {
-	// モデルを検索してセットする
-	model = ModelManager::GetInstance()->FindModel(filePath);
+	// モデルを検索してハンドルをセットする
+	modelHandle = ModelManager::GetInstance()->FindModelHandle(filePath);
 }
\ No newline at end of file
@@ -4,10 +4,14 @@
 #include <wrl.h>
 #include <d3d12.h>
 #include "MathFunctions.h"
+#include "AssetRegistry.h"
+#include "Model.h"
+#include "SceneBVH.h"
 
 class Object3dCommon;
 class DirectXCommon;
-class Model;
+class RenderStateCache;
+class OcclusionBuffer;
 
 // 3Dオブジェクト
 class Object3d
@@ -45,10 +49,9 @@ public:
 		math::Matrix4x4 uvTransform;
 	};
 
-	// 座標変換行列
+	// 座標変換行列（ビュー射影はObject3dCommonのカメラ用定数バッファで共有する）
 	struct TransformationMatrix
 	{
-		math::Matrix4x4 WVP;
 		math::Matrix4x4 World;
 	};
 
@@ -68,15 +71,44 @@ public: // メンバ関数
 	// 更新
 	void Update();
 
-	// 描画
+	// 描画（Object3dCommonに描画キューがあればパケットを積み、後でまとめて描かれる）
 	void Draw();
 
-	// ===== リソース生成 =====
-	void CreateTransformationMatrixResource();
-	void CreateDirectionalLight();
+	// ===== 定数バッファのデータ初期化（GPUへは描画時にフレームごとの領域へ送る） =====
+	void InitializeTransformationMatrix();
+	void InitializeDirectionalLight();
 
-	// setter
-	void SetModel(Model *model) { this->model = model; }
+	// ワールド座標の境界ボリューム（Updateで更新）
+	const Model::Bounds &GetWorldBounds() const { return worldBounds; }
+
+	// カリングの結果（Object3dCommon::CullObjects・CullSceneが設定する。falseならDrawで積まない）
+	void SetVisible(bool visible) { this->visible = visible; }
+	bool IsVisible() const { return visible; }
+
+	/// <summary>
+	/// ワールド座標のレイとの当たり判定（モデルに三角形のBVHがあれば三角形で、なければワールド座標のAABBで判定する）
+	/// </summary>
+	/// <param name="ray">ワールド座標のレイ</param>
+	/// <param name="maxDistance">調べるレイの長さ</param>
+	/// <param name="distance">当たった距離（rayのdirectionの長さ単位）</param>
+	/// <returns>当たったらtrue</returns>
+	bool RayCast(const math::Ray &ray, float maxDistance, float &distance) const;
+
+	// オクルーダー（他のオブジェクトを隠す物）にするか（Object3dCommonのオクルージョンカリングでモデルの三角形を深度バッファに描く）
+	// 壁や建物・地形のような大きくて中身の詰まったモデルに使う
+	void SetOccluder(bool occluder) { this->occluder = occluder; }
+	bool IsOccluder() const { return occluder; }
+
+	// モデルの三角形をワールド行列でオクルージョンカリング用の深度バッファに描く（読み込み中なら何もしない）
+	void RenderOccluder(OcclusionBuffer &occlusionBuffer) const;
+
+	// シーンのBVHの登録番号（Object3dCommon::AddSceneObjectが設定する。登録されていればUpdateでBVHの箱を更新する）
+	void SetSceneProxy(SceneBVH::ProxyId sceneProxy) { this->sceneProxy = sceneProxy; }
+	SceneBVH::ProxyId GetSceneProxy() const { return sceneProxy; }
+
+	// setter（ModelManagerのハンドル）
+	void SetModel(AssetHandle modelHandle) { this->modelHandle = modelHandle; }
+	AssetHandle GetModelHandle() const { return modelHandle; }
 
 	// setter
 	void SetScale(const math::Vector3 &scale) { transform.scale = scale; }
@@ -89,41 +121,53 @@ public: // メンバ関数
 	const math::Vector3 &GetTranslate() const { return transform.translate; }
 
 	// DirectionalLightのgetter
-	const math::Vector3 &GetLightDirection() const { return directionalLightData->direction; }
-	float GetLightIntensity() const { return directionalLightData->intensity; }
-	const math::Vector4 &GetLightColor() const { return directionalLightData->color; }
+	const DirectionalLight &GetDirectionalLight() const { return directionalLightData; }
+	const math::Vector3 &GetLightDirection() const { return directionalLightData.direction; }
+	float GetLightIntensity() const { return directionalLightData.intensity; }
+	const math::Vector4 &GetLightColor() const { return directionalLightData.color; }
 
-	void SetLightDirection(const math::Vector3 &dir) { directionalLightData->direction = dir; }
-	void SetLightIntensity(float intensity) { directionalLightData->intensity = intensity; }
-	void SetLightColor(const math::Vector4 &color) { directionalLightData->color = color; }
+	void SetLightDirection(const math::Vector3 &dir) { directionalLightData.direction = dir; }
+	void SetLightIntensity(float intensity) { directionalLightData.intensity = intensity; }
+	void SetLightColor(const math::Vector4 &color) { directionalLightData.color = color; }
 
 	void SetModel(const std::string &filePath);
 
 private:
 
+	// 描画するモデル（読み込み中なら代わりのモデル）
+	Model *GetDrawModel() const;
+	// コマンドを積む（stateCacheがあればセット済みのステートを省く）
+	void Render(Model *drawModel, RenderStateCache *stateCache) const;
+
 	// ===== 共通オブジェクト =====
 	Object3dCommon *object3dCommon = nullptr;
 
 
 	// ===== 変換行列 =====
-	// 変換行列用バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource = nullptr;
-	// 変換行列データ書き込み用ポインタ
-	TransformationMatrix *transformationMatrixData = nullptr;
+	// 変換行列データ（描画時にDirectXCommonのアップロード用リングバッファへコピーする）
+	TransformationMatrix transformationMatrixData {};
 
 
 	// ===== 平行光源 =====
-	// 平行光源用バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> directionalLightResource = nullptr;
-	// 平行光源データ書き込み用ポインタ
-	DirectionalLight *directionalLightData = nullptr;
+	// 平行光源データ（描画時にDirectXCommonのアップロード用リングバッファへコピーする）
+	DirectionalLight directionalLightData {};
 
 
 	// ===== Transform =====
 	// オブジェクトのTransform
 	math::Transform transform;
-	// カメラのTransform
-	math::Transform cameraTransform;
 
-	Model *model = nullptr;
+	// モデルのハンドル（描画時にModelManagerから取得する）
+	AssetHandle modelHandle;
+
+	// ===== 視錐台カリング =====
+	// モデルの境界ボリュームをワールド行列で変換したもの
+	Model::Bounds worldBounds {};
+	bool visible = true;
+
+	// ===== シーンのBVH =====
+	SceneBVH::ProxyId sceneProxy = SceneBVH::kNullProxy;
+
+	// ===== オクルージョンカリング =====
+	bool occluder = false;
 };
\ No newline at end of file
@@ -1,5 +1,12 @@
 #include "Object3dCommon.h"
 #include "DirectXCommon.h"
+#include "Object3d.h"
+#include "Model.h"
+#include "ModelManager.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
 
 void Object3dCommon::Initialize(DirectXCommon *dxCommon) {
 
@@ -7,6 +14,10 @@ void Object3dCommon::Initialize(DirectXCommon *dxCommon) {
 	this->dxCommon_ = dxCommon;
 
 	CreateGraphicsPipelineState();
+	InitializeViewData();
+
+	// オクルージョンカリング用の深度バッファ（画面と同じ縦横比の低解像度）
+	occlusionBuffer.Initialize(256, 144);
 }
 
 void Object3dCommon::SetCommonRenderSetting()
@@ -16,9 +27,257 @@ void Object3dCommon::SetCommonRenderSetting()
 
 	// 2. パイプラインステートオブジェクトをセット
 	dxCommon_->GetCommandList()->SetPipelineState(graphicsPipelineState.Get());
+	boundPipelineState = graphicsPipelineState.Get();
 
 	// 3. プリミティブトポロジーをセット（三角形リストが一般的）
 	dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	// 4. カメラのビューデータを送る（フレームに1回。カメラが変わっていなければ作り直さない）
+	if (defaultCamera) {
+		defaultCamera->Update();
+		if (defaultCamera != viewDataCamera || defaultCamera->GetVersion() != viewDataCameraVersion) {
+			viewData = defaultCamera->GetViewData();
+			viewDataCamera = defaultCamera;
+			viewDataCameraVersion = defaultCamera->GetVersion();
+		}
+	}
+	dxCommon_->GetCommandList()->SetGraphicsRootConstantBufferView(5, dxCommon_->UploadConstantBuffer(viewData));
+}
+
+void Object3dCommon::SetVertexPipeline(bool quantized, bool instanced, RenderStateCache *stateCache)
+{
+	ID3D12PipelineState *pipelineState = nullptr;
+	if (instanced) {
+		pipelineState = quantized ? quantizedInstancedGraphicsPipelineState.Get() : instancedGraphicsPipelineState.Get();
+	} else {
+		pipelineState = quantized ? quantizedGraphicsPipelineState.Get() : graphicsPipelineState.Get();
+	}
+	bool changed = stateCache ? stateCache->SetPipeline(reinterpret_cast<uintptr_t>(pipelineState)) : pipelineState != boundPipelineState;
+	if (!changed) {
+		return;
+	}
+	dxCommon_->GetCommandList()->SetPipelineState(pipelineState);
+	boundPipelineState = pipelineState;
+}
+
+void Object3dCommon::SetParticlePipeline(RenderStateCache *stateCache)
+{
+	ID3D12PipelineState *pipelineState = particleGraphicsPipelineState.Get();
+	bool changed = stateCache ? stateCache->SetPipeline(reinterpret_cast<uintptr_t>(pipelineState)) : pipelineState != boundPipelineState;
+	if (!changed) {
+		return;
+	}
+	dxCommon_->GetCommandList()->SetPipelineState(pipelineState);
+	boundPipelineState = pipelineState;
+}
+
+size_t Object3dCommon::CullObjects(Object3d *const *objects, size_t count)
+{
+	cullTestedCount = count;
+	cullVisibleCount = count;
+	if (!defaultCamera) {
+		// カメラがなければ判定できないので全部描く
+		for (size_t i = 0; i < count; ++i) {
+			objects[i]->SetVisible(true);
+		}
+		return count;
+	}
+
+	defaultCamera->Update();
+	math::Frustum frustum = math::MakeFrustum(defaultCamera->GetViewProjectionMatrix());
+
+	// 境界球を成分ごとの配列に集めて、4つずつまとめて判定する
+	cullSpheres.Resize(count);
+	cullResults.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		cullSpheres.Set(i, objects[i]->GetWorldBounds().sphere);
+	}
+	math::CullSpheres(frustum, cullSpheres, cullResults.data());
+
+	// 球で残ったものだけAABBで絞り込む（球は細長いモデルだと大きすぎる）
+	cullVisibleCount = 0;
+	for (size_t i = 0; i < count; ++i) {
+		bool visible = cullResults[i] != 0 && math::IsVisible(frustum, objects[i]->GetWorldBounds().aabb);
+		objects[i]->SetVisible(visible);
+		cullVisibleCount += visible ? 1 : 0;
+	}
+	return cullVisibleCount;
+}
+
+void Object3dCommon::AddSceneObject(Object3d *object)
+{
+	assert(object->GetSceneProxy() == SceneBVH::kNullProxy);
+	object->SetSceneProxy(sceneBVH.CreateProxy(object->GetWorldBounds().aabb, object));
+	sceneObjects.push_back(object);
+}
+
+void Object3dCommon::RemoveSceneObject(Object3d *object)
+{
+	auto it = std::find(sceneObjects.begin(), sceneObjects.end(), object);
+	if (it == sceneObjects.end()) {
+		return;
+	}
+	sceneBVH.DestroyProxy(object->GetSceneProxy());
+	object->SetSceneProxy(SceneBVH::kNullProxy);
+	*it = sceneObjects.back();
+	sceneObjects.pop_back();
+}
+
+size_t Object3dCommon::CullScene()
+{
+	// 動いたオブジェクトの箱を付け直す（時々木を作り直す）
+	sceneBVH.Update();
+
+	cullTestedCount = sceneObjects.size();
+	cullVisibleCount = sceneObjects.size();
+	occludedCount = 0;
+	if (!defaultCamera) {
+		for (Object3d *object : sceneObjects) {
+			object->SetVisible(true);
+		}
+		return cullVisibleCount;
+	}
+
+	defaultCamera->Update();
+	math::Frustum frustum = math::MakeFrustum(defaultCamera->GetViewProjectionMatrix());
+
+	// 全部を見えないことにしてから、BVHで見つかったものだけ見えることにする
+	for (Object3d *object : sceneObjects) {
+		object->SetVisible(false);
+	}
+	sceneBVH.QueryFrustum(frustum, sceneQueryResults);
+	for (SceneBVH::ProxyId proxy : sceneQueryResults) {
+		static_cast<Object3d *>(sceneBVH.GetUserData(proxy))->SetVisible(true);
+	}
+	cullVisibleCount = sceneQueryResults.size();
+
+	// 視錐台に入ったもののうち、オクルーダーに隠れたものを除く
+	if (occlusionCullingEnabled) {
+		CullOccluded(defaultCamera->GetViewProjectionMatrix());
+		cullVisibleCount -= occludedCount;
+	}
+	return cullVisibleCount;
+}
+
+void Object3dCommon::CullOccluded(const math::Matrix4x4 &viewProjection)
+{
+	// 視錐台に入ったオクルーダーを描く
+	occlusionBuffer.BeginFrame(viewProjection);
+	for (SceneBVH::ProxyId proxy : sceneQueryResults) {
+		const Object3d *object = static_cast<const Object3d *>(sceneBVH.GetUserData(proxy));
+		if (object->IsOccluder()) {
+			object->RenderOccluder(occlusionBuffer);
+		}
+	}
+	occlusionBuffer.EndFrame();
+
+	// オクルーダー以外のAABBを深度バッファと比べる（オクルーダー自身は自分の深度で隠れてしまうので調べない）
+	for (SceneBVH::ProxyId proxy : sceneQueryResults) {
+		Object3d *object = static_cast<Object3d *>(sceneBVH.GetUserData(proxy));
+		if (!object->IsOccluder() && occlusionBuffer.IsOccluded(object->GetWorldBounds().aabb)) {
+			object->SetVisible(false);
+			++occludedCount;
+		}
+	}
+}
+
+Object3d *Object3dCommon::PickObject(const math::Ray &ray, float *distance)
+{
+	// CullSceneより後に動いたものがあっても当たるように付け直しておく
+	sceneBVH.Refit();
+
+	// 箱に当たったオブジェクトだけ、モデルの三角形で確かめる
+	SceneBVH::RayHit hit;
+	bool found = sceneBVH.RayCast(ray, FLT_MAX, hit, [this](SceneBVH::ProxyId proxy, const math::Ray &proxyRay, float maxDistance, float &hitDistance) {
+		return static_cast<const Object3d *>(sceneBVH.GetUserData(proxy))->RayCast(proxyRay, maxDistance, hitDistance);
+		});
+	if (!found) {
+		return nullptr;
+	}
+	if (distance) {
+		*distance = hit.distance;
+	}
+	return static_cast<Object3d *>(sceneBVH.GetUserData(hit.proxy));
+}
+
+void Object3dCommon::SetRenderQueue(RenderQueue *renderQueue)
+{
+	this->renderQueue = renderQueue;
+	if (renderQueue) {
+		renderQueue->SetPassSetup(RenderPass::kObject3d, [this](RenderStateCache &stateCache) {
+			SetCommonRenderSetting();
+			stateCache.SetPipeline(reinterpret_cast<uintptr_t>(boundPipelineState));
+			});
+		// パーティクルも同じルートシグネチャとカメラを使う
+		renderQueue->SetPassSetup(RenderPass::kParticle, [this](RenderStateCache &stateCache) {
+			SetCommonRenderSetting();
+			stateCache.SetPipeline(reinterpret_cast<uintptr_t>(boundPipelineState));
+			});
+	}
+}
+
+void Object3dCommon::AddInstance(const Object3d *object, const math::Matrix4x4 &world)
+{
+	// モデルのスロット番号でまとめる
+	instanceBatcher.Add(object->GetModelHandle().index, world);
+	instanceObjects.push_back(object);
+}
+
+void Object3dCommon::DrawInstances()
+{
+	if (instanceObjects.empty()) {
+		return;
+	}
+
+	// 描画キューがあれば、3Dオブジェクトのパスの最後に描く
+	if (renderQueue) {
+		uint64_t sortKey = RenderQueue::MakeSortKey(RenderPass::kObject3d, UINT32_MAX, UINT32_MAX, UINT32_MAX, UINT32_MAX);
+		renderQueue->Submit(sortKey, [](const void *object, RenderStateCache &stateCache) {
+			const_cast<Object3dCommon *>(static_cast<const Object3dCommon *>(object))->ExecuteInstances(&stateCache);
+			}, this);
+		return;
+	}
+	ExecuteInstances(nullptr);
+}
+
+void Object3dCommon::ExecuteInstances(RenderStateCache *stateCache)
+{
+	// モデルごとにまとめて、ワールド行列をグループ順に詰める
+	instanceBatcher.Build();
+
+	// 全グループの行列を1回でこのフレーム用の領域へコピーする
+	const std::vector<math::Matrix4x4> &instances = instanceBatcher.GetInstances();
+	DirectXCommon::UploadAllocation allocation = dxCommon_->AllocateUpload(sizeof(math::Matrix4x4) * instances.size(), sizeof(math::Matrix4x4));
+	if (!allocation.cpuAddress) {
+		// 書き込み先がなければこのフレームは描かない
+		instanceBatcher.Clear();
+		instanceObjects.clear();
+		return;
+	}
+	std::memcpy(allocation.cpuAddress, instances.data(), sizeof(math::Matrix4x4) * instances.size());
+
+	ID3D12GraphicsCommandList *commandList = dxCommon_->GetCommandList();
+	for (const InstanceBatcher::Group &group : instanceBatcher.GetGroups()) {
+		const Object3d *object = instanceObjects[group.firstItem];
+
+		// 読み込み中なら代わりのモデルを描く
+		Model *drawModel = ModelManager::GetInstance()->GetModel(object->GetModelHandle());
+		if (drawModel && !drawModel->IsReady()) {
+			drawModel = ModelManager::GetInstance()->GetPlaceholderModel();
+		}
+		if (!drawModel) {
+			continue;
+		}
+
+		// グループの行列をStructuredBufferとして渡し、インスタンス数分を1回で描く
+		SetVertexPipeline(drawModel->IsQuantized(), true, stateCache);
+		commandList->SetGraphicsRootShaderResourceView(6, allocation.gpuAddress + sizeof(math::Matrix4x4) * group.firstInstance);
+		commandList->SetGraphicsRootConstantBufferView(3, dxCommon_->UploadConstantBuffer(object->GetDirectionalLight()));
+		drawModel->Draw(group.instanceCount, stateCache);
+	}
+
+	instanceBatcher.Clear();
+	instanceObjects.clear();
 }
 
 void Object3dCommon::CreateRootSignature(){
@@ -42,7 +301,7 @@ void Object3dCommon::CreateRootSignature(){
 	//----RootParameter----
 
 	// RootParameter作成。PixelShaderのMaterialとVertexShaderのTransform
-	D3D12_ROOT_PARAMETER rootParameters[4] = {};
+	D3D12_ROOT_PARAMETER rootParameters[7] = {};
 	rootParameters[0].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV; // CBVを使う
 	rootParameters[0].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL; // PixelShaderで使う
 	rootParameters[0].Descriptor.ShaderRegister = 0; // レジスタ番号0とバインド
@@ -60,6 +319,18 @@ void Object3dCommon::CreateRootSignature(){
 	rootParameters[3].ShaderVisibility = D3D12_SHADER_VISIBILITY_PIXEL; // PixelShaderで使う
 	rootParameters[3].Descriptor.ShaderRegister = 1; // レジスタ番号1を使う
 
+	rootParameters[4].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV; // CBVを使う
+	rootParameters[4].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX; // VertexShaderで使う（量子化した頂点の展開用）
+	rootParameters[4].Descriptor.ShaderRegister = 1; // レジスタ番号1を使う
+
+	rootParameters[5].ParameterType = D3D12_ROOT_PARAMETER_TYPE_CBV; // CBVを使う
+	rootParameters[5].ShaderVisibility = D3D12_SHADER_VISIBILITY_ALL; // 全シェーダーで使う（カメラ）
+	rootParameters[5].Descriptor.ShaderRegister = 2; // レジスタ番号2を使う
+
+	rootParameters[6].ParameterType = D3D12_ROOT_PARAMETER_TYPE_SRV; // SRVを使う（テーブルを使わずアドレスを直接渡す）
+	rootParameters[6].ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX; // VertexShaderで使う（インスタンスの行列）
+	rootParameters[6].Descriptor.ShaderRegister = 1; // レジスタ番号1を使う
+
 	descriptionRootSignature.pParameters = rootParameters; // ルートパラメータ配列へのポインタ
 	descriptionRootSignature.NumParameters = _countof(rootParameters); // 配列の長さ
 
@@ -208,4 +479,90 @@ void Object3dCommon::CreateGraphicsPipelineState() {
 	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
 		IID_PPV_ARGS(&graphicsPipelineState));
 	assert(SUCCEEDED(hr));
+
+	//----量子化した頂点用のPSOを生成する----
+
+	// 位置はUNORM16×4、UVはFLOAT16×2、法線は八面体エンコードのSNORM16×2
+	D3D12_INPUT_ELEMENT_DESC quantizedInputElementDescs[3] = {};
+	quantizedInputElementDescs[0].SemanticName = "POSITION";
+	quantizedInputElementDescs[0].SemanticIndex = 0;
+	quantizedInputElementDescs[0].Format = DXGI_FORMAT_R16G16B16A16_UNORM;
+	quantizedInputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	quantizedInputElementDescs[1].SemanticName = "TEXCOORD";
+	quantizedInputElementDescs[1].SemanticIndex = 0;
+	quantizedInputElementDescs[1].Format = DXGI_FORMAT_R16G16_FLOAT;
+	quantizedInputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	quantizedInputElementDescs[2].SemanticName = "NORMAL";
+	quantizedInputElementDescs[2].SemanticIndex = 0;
+	quantizedInputElementDescs[2].Format = DXGI_FORMAT_R16G16_SNORM;
+	quantizedInputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	Microsoft::WRL::ComPtr<IDxcBlob> quantizedVertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3dQuantized.VS.hlsl", L"vs_6_0");
+	assert(quantizedVertexShaderBlob != nullptr);
+
+	graphicsPipelineStateDesc.InputLayout.pInputElementDescs = quantizedInputElementDescs;
+	graphicsPipelineStateDesc.InputLayout.NumElements = _countof(quantizedInputElementDescs);
+	graphicsPipelineStateDesc.VS = { quantizedVertexShaderBlob->GetBufferPointer(),
+	quantizedVertexShaderBlob->GetBufferSize() };
+
+	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
+		IID_PPV_ARGS(&quantizedGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
+
+	//----インスタンス描画用のPSOを生成する----
+
+	// 量子化した頂点用
+	Microsoft::WRL::ComPtr<IDxcBlob> quantizedInstancedVertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3dQuantizedInstanced.VS.hlsl", L"vs_6_0");
+	assert(quantizedInstancedVertexShaderBlob != nullptr);
+
+	graphicsPipelineStateDesc.VS = { quantizedInstancedVertexShaderBlob->GetBufferPointer(),
+	quantizedInstancedVertexShaderBlob->GetBufferSize() };
+
+	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
+		IID_PPV_ARGS(&quantizedInstancedGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
+
+	// 通常の頂点用
+	Microsoft::WRL::ComPtr<IDxcBlob> instancedVertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3dInstanced.VS.hlsl", L"vs_6_0");
+	assert(instancedVertexShaderBlob != nullptr);
+
+	graphicsPipelineStateDesc.InputLayout = inputLayoutDesc;
+	graphicsPipelineStateDesc.VS = { instancedVertexShaderBlob->GetBufferPointer(),
+	instancedVertexShaderBlob->GetBufferSize() };
+
+	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
+		IID_PPV_ARGS(&instancedGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
+
+	//----パーティクル用のPSOを生成する----
+
+	// 頂点バッファは使わず、SV_VertexIDで四角形の角、SV_InstanceIDでパーティクルを決める
+	Microsoft::WRL::ComPtr<IDxcBlob> particleVertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Particle.VS.hlsl", L"vs_6_0");
+	assert(particleVertexShaderBlob != nullptr);
+
+	Microsoft::WRL::ComPtr<IDxcBlob> particlePixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Particle.PS.hlsl", L"ps_6_0");
+	assert(particlePixelShaderBlob != nullptr);
+
+	graphicsPipelineStateDesc.InputLayout = {};
+	graphicsPipelineStateDesc.VS = { particleVertexShaderBlob->GetBufferPointer(),
+	particleVertexShaderBlob->GetBufferSize() };
+	graphicsPipelineStateDesc.PS = { particlePixelShaderBlob->GetBufferPointer(),
+	particlePixelShaderBlob->GetBufferSize() };
+	// 半透明で重なり合うので、深度は比べるだけで書かない
+	graphicsPipelineStateDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+
+	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
+		IID_PPV_ARGS(&particleGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
+}
+
+void Object3dCommon::InitializeViewData()
+{
+	// カメラが登録されるまでは単位行列
+	viewData.view = math::MakeIdentity4x4();
+	viewData.projection = math::MakeIdentity4x4();
+	viewData.viewProjection = math::MakeIdentity4x4();
+	viewData.worldPosition = { 0.0f, 0.0f, 0.0f };
 }
\ No newline at end of file
@@ -1,8 +1,17 @@
 #pragma once
 #include <wrl.h>
 #include <d3d12.h>
+#include <vector>
+#include "Camera.h"
+#include "InstanceBatcher.h"
+#include "BoundingVolume.h"
+#include "SceneBVH.h"
+#include "OcclusionBuffer.h"
 
 class DirectXCommon;
+class Object3d;
+class RenderQueue;
+class RenderStateCache;
 
 // 3Dオブジェクト共通部
 class Object3dCommon 
@@ -15,14 +24,138 @@ public: // メンバ関数
 
 	void SetCommonRenderSetting();
 
+	// 頂点形式と描き方に合わせてPSOを切り替える（同じPSOが続く間は何もしない）
+	void SetVertexPipeline(bool quantized, bool instanced = false, RenderStateCache *stateCache = nullptr);
+
+	// パーティクル（ビルボードのインスタンス描画）のPSOに切り替える
+	void SetParticlePipeline(RenderStateCache *stateCache = nullptr);
+
+	// ===== 視錐台カリング =====
+	/// <summary>
+	/// デフォルトカメラの視錐台でオブジェクトをまとめて判定し、見えないものはDrawで積まれないようにする
+	/// 境界球を4つずつSIMDで判定し、残ったものをAABBで絞り込む（Object3d::Updateの後、Drawの前に呼ぶ）
+	/// </summary>
+	/// <param name="objects">判定するオブジェクト</param>
+	/// <param name="count">オブジェクト数</param>
+	/// <returns>見えるオブジェクト数</returns>
+	size_t CullObjects(Object3d *const *objects, size_t count);
+
+	// ===== シーンのBVH =====
+	// 登録したオブジェクトはUpdateで箱が変わるたびにBVHへ知らせ、CullScene・PickObjectでBVHをたどって調べる
+	void AddSceneObject(Object3d *object);
+	void RemoveSceneObject(Object3d *object);
+
+	/// <summary>
+	/// 登録したオブジェクトをBVHでまとめて視錐台と判定する（BVHの付け直しもここで行う。Object3d::Updateの後、Drawの前に呼ぶ）
+	/// </summary>
+	/// <returns>見えるオブジェクト数</returns>
+	size_t CullScene();
+
+	/// <summary>
+	/// レイに最も近くで当たる登録オブジェクトを探す（BVHで絞り込み、Object3d::RayCastで三角形かAABBと判定する）
+	/// </summary>
+	/// <param name="ray">レイ（Camera::ScreenPointToRayなど）</param>
+	/// <param name="distance">当たった距離の書き込み先（nullptr可）</param>
+	/// <returns>当たったオブジェクト。なければnullptr</returns>
+	Object3d *PickObject(const math::Ray &ray, float *distance = nullptr);
+
+	SceneBVH &GetSceneBVH() { return sceneBVH; }
+
+	// 直前のCullObjects・CullSceneで判定した数と見えた数
+	size_t GetCullTestedCount() const { return cullTestedCount; }
+	size_t GetCullVisibleCount() const { return cullVisibleCount; }
+
+	// ===== オクルージョンカリング =====
+	// 有効にすると、CullSceneで視錐台に入ったオクルーダー（Object3d::SetOccluder）をCPUで低解像度の深度バッファに描き、
+	// それに完全に隠れたオブジェクトも見えないことにする
+	void SetOcclusionCullingEnabled(bool enabled) { occlusionCullingEnabled = enabled; }
+	bool IsOcclusionCullingEnabled() const { return occlusionCullingEnabled; }
+	// 直前のCullSceneで隠れていた数
+	size_t GetOccludedCount() const { return occludedCount; }
+	const OcclusionBuffer &GetOcclusionBuffer() const { return occlusionBuffer; }
+
+	// ===== 描画キュー =====
+	// 登録すると、Object3d::Drawはその場で描かずに描画キューへパケットを積む
+	// 3Dオブジェクトとパーティクルのパスの最初にSetCommonRenderSettingが呼ばれるようにする
+	void SetRenderQueue(RenderQueue *renderQueue);
+	RenderQueue *GetRenderQueue() const { return renderQueue; }
+
+	// ===== インスタンス描画 =====
+	// 有効にすると、Object3d::Drawはその場で描かずにモデルごとにまとめ、DrawInstancesで1モデル1回のDrawで描く
+	void SetInstancingEnabled(bool enabled) { instancingEnabled = enabled; }
+	bool IsInstancingEnabled() const { return instancingEnabled; }
+
+	/// <summary>
+	/// インスタンス描画するオブジェクトを追加する（Object3d::Drawから呼ばれる）
+	/// </summary>
+	/// <param name="object">オブジェクト（平行光源とモデルはグループで最初に追加したものを使う）</param>
+	/// <param name="world">ワールド行列</param>
+	void AddInstance(const Object3d *object, const math::Matrix4x4 &world);
+
+	// 追加したオブジェクトをモデルごとにまとめて描画する（Object3dを描画した後に呼ぶ。描画キューがあればパケットを積む）
+	void DrawInstances();
+
+	// 全Object3dで使うカメラ（SetCommonRenderSettingでフレームに1回ビューデータをGPUへ送る）
+	void SetDefaultCamera(Camera *camera) { defaultCamera = camera; }
+	Camera *GetDefaultCamera() const { return defaultCamera; }
+
 private:
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState = nullptr;
+	// 量子化した頂点用のPSO（入力レイアウトとVSだけが異なる）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> quantizedGraphicsPipelineState = nullptr;
+	// インスタンス描画用のPSO（VSだけが異なる）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> instancedGraphicsPipelineState = nullptr;
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> quantizedInstancedGraphicsPipelineState = nullptr;
+	// パーティクル用のPSO（頂点バッファを使わず、αブレンドして深度は書かない）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> particleGraphicsPipelineState = nullptr;
+	// 現在セットしているPSO
+	ID3D12PipelineState *boundPipelineState = nullptr;
 
 	// ルードシグネチャの作成
 	void CreateRootSignature();
 	// グラフィックスパイプラインの生成
 	void CreateGraphicsPipelineState();
+	// ビュー（カメラ）データの初期化
+	void InitializeViewData();
+
+	// ===== カメラ =====
+	Camera *defaultCamera = nullptr;
+	// ビューデータ（全Object3dで共有し、フレームごとにアップロード用リングバッファへコピーする）
+	Camera::ViewData viewData {};
+	// 最後に取り込んだカメラとその版（変わっていなければ作り直さない）
+	const Camera *viewDataCamera = nullptr;
+	uint32_t viewDataCameraVersion = 0;
+
+	// ===== インスタンス描画 =====
+	bool instancingEnabled = false;
+	// モデルごとにまとめてワールド行列を詰める
+	InstanceBatcher instanceBatcher;
+	// 追加したオブジェクト（InstanceBatcherの要素番号順）
+	std::vector<const Object3d *> instanceObjects;
+	// まとめたインスタンスを描く
+	void ExecuteInstances(RenderStateCache *stateCache);
+
+	// ===== 描画キュー =====
+	RenderQueue *renderQueue = nullptr;
+
+	// ===== 視錐台カリング =====
+	math::SphereStreams cullSpheres;
+	std::vector<uint8_t> cullResults;
+	size_t cullTestedCount = 0;
+	size_t cullVisibleCount = 0;
+
+	// ===== シーンのBVH =====
+	SceneBVH sceneBVH;
+	std::vector<Object3d *> sceneObjects;
+	std::vector<SceneBVH::ProxyId> sceneQueryResults;
+
+	// ===== オクルージョンカリング =====
+	OcclusionBuffer occlusionBuffer;
+	bool occlusionCullingEnabled = false;
+	size_t occludedCount = 0;
+	// sceneQueryResultsのオクルーダーを描き、隠れたオブジェクトを見えないことにする
+	void CullOccluded(const math::Matrix4x4 &viewProjection);
 
 	DirectXCommon *dxCommon_ = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "OcclusionBuffer.h"
+#include "MathFunctions.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+#include <cmath>
+
+#if MATH_USE_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace math;
+
+namespace {
+
+	// これより面積が小さい三角形は描かない（辺の外積の値。ピクセル単位で面積の2倍）
+	constexpr float kMinTriangleArea = 1e-8f;
+	// 辺の上のピクセルの中心がどちらの三角形にも入らず隙間になるのを防ぐため、辺を外へずらす量（ピクセル）
+	constexpr float kEdgeBias = 1.0f / 64.0f;
+
+	// 点とクリップ座標の行列の積（wで割らない）
+	inline Vector4 TransformToClip(float x, float y, float z, const Matrix4x4 &m)
+	{
+		return {
+			x * m.m[0][0] + y * m.m[1][0] + z * m.m[2][0] + m.m[3][0],
+			x * m.m[0][1] + y * m.m[1][1] + z * m.m[2][1] + m.m[3][1],
+			x * m.m[0][2] + y * m.m[1][2] + z * m.m[2][2] + m.m[3][2],
+			x * m.m[0][3] + y * m.m[1][3] + z * m.m[2][3] + m.m[3][3],
+		};
+	}
+
+	// ニア面(z = 0)で切った点
+	inline Vector4 LerpClip(const Vector4 &a, const Vector4 &b)
+	{
+		float t = a.z / (a.z - b.z);
+		return { a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, 0.0f, a.w + (b.w - a.w) * t };
+	}
+
+	// 辺の式 E(p) = a * x + b * y + c（三角形の内側で正になる向き）
+	struct EdgeFunction
+	{
+		float a;
+		float b;
+		float c;
+	};
+
+	inline EdgeFunction MakeEdge(const Vector3 &from, const Vector3 &to)
+	{
+		float a = from.y - to.y;
+		float b = to.x - from.x;
+		return { a, b, -a * from.x - b * from.y + kEdgeBias * (std::fabs(a) + std::fabs(b)) };
+	}
+}
+
+void OcclusionBuffer::Initialize(uint32_t newWidth, uint32_t newHeight)
+{
+	assert(newWidth > 0 && newHeight > 0);
+	// 4ピクセルずつSIMDで描くのと、タイルで割り切れるように切り上げる
+	width = (newWidth + kTileSize - 1) / kTileSize * kTileSize;
+	height = (newHeight + kTileSize - 1) / kTileSize * kTileSize;
+	tileCountX = width / kTileSize;
+	tileCountY = height / kTileSize;
+	depthBuffer.assign(size_t(width) * height, FLT_MAX);
+	tileMaxDepth.assign(size_t(tileCountX) * tileCountY, FLT_MAX);
+}
+
+void OcclusionBuffer::BeginFrame(const Matrix4x4 &newViewProjection)
+{
+	assert(width > 0 && "OcclusionBuffer::Initialize must be called first");
+	viewProjection = newViewProjection;
+	std::fill(depthBuffer.begin(), depthBuffer.end(), FLT_MAX);
+	std::fill(tileMaxDepth.begin(), tileMaxDepth.end(), FLT_MAX);
+	statistics = {};
+}
+
+void OcclusionBuffer::RenderOccluder(const float *positions, size_t positionStride, size_t vertexCount, const uint32_t *indices, size_t indexCount, const Matrix4x4 &world)
+{
+	if (vertexCount == 0 || indexCount < 3) {
+		return;
+	}
+
+	// 頂点は1回だけクリップ座標にする
+	Matrix4x4 worldViewProjection = Multiply(world, viewProjection);
+	clipVertices.resize(vertexCount);
+	const uint8_t *source = reinterpret_cast<const uint8_t *>(positions);
+	for (size_t i = 0; i < vertexCount; ++i) {
+		const float *position = reinterpret_cast<const float *>(source + i * positionStride);
+		clipVertices[i] = TransformToClip(position[0], position[1], position[2], worldViewProjection);
+	}
+
+	size_t triangleCount = indexCount / 3;
+	statistics.occluderTriangles += uint32_t(triangleCount);
+	for (size_t i = 0; i < triangleCount; ++i) {
+		assert(indices[i * 3] < vertexCount && indices[i * 3 + 1] < vertexCount && indices[i * 3 + 2] < vertexCount);
+		RasterizeClipTriangle(clipVertices[indices[i * 3]], clipVertices[indices[i * 3 + 1]], clipVertices[indices[i * 3 + 2]]);
+	}
+}
+
+void OcclusionBuffer::EndFrame()
+{
+	// タイルごとに最も奥の深度をまとめる
+	for (uint32_t tileY = 0; tileY < tileCountY; ++tileY) {
+		for (uint32_t tileX = 0; tileX < tileCountX; ++tileX) {
+			const float *row = &depthBuffer[size_t(tileY) * kTileSize * width + tileX * kTileSize];
+#if MATH_USE_SSE
+			__m128 maximum = _mm_set1_ps(-FLT_MAX);
+			for (uint32_t y = 0; y < kTileSize; ++y, row += width) {
+				for (uint32_t x = 0; x < kTileSize; x += 4) {
+					maximum = _mm_max_ps(maximum, _mm_loadu_ps(row + x));
+				}
+			}
+			maximum = _mm_max_ps(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+			maximum = _mm_max_ps(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+			tileMaxDepth[tileY * tileCountX + tileX] = _mm_cvtss_f32(maximum);
+#else
+			float maximum = -FLT_MAX;
+			for (uint32_t y = 0; y < kTileSize; ++y, row += width) {
+				for (uint32_t x = 0; x < kTileSize; ++x) {
+					maximum = std::max(maximum, row[x]);
+				}
+			}
+			tileMaxDepth[tileY * tileCountX + tileX] = maximum;
+#endif
+		}
+	}
+}
+
+bool OcclusionBuffer::IsOccluded(const AABB &aabb)
+{
+	++statistics.testedObjects;
+
+	// 8つの角を画面に写し、画面上の範囲と最も手前の深度を求める
+	float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+	float nearestDepth = FLT_MAX;
+	for (int i = 0; i < 8; ++i) {
+		Vector4 clip = TransformToClip(
+			(i & 1) ? aabb.max.x : aabb.min.x,
+			(i & 2) ? aabb.max.y : aabb.min.y,
+			(i & 4) ? aabb.max.z : aabb.min.z,
+			viewProjection);
+		// ニア面より手前に角があれば、画面の範囲を決められないので見えているとする
+		if (clip.z < 0.0f || clip.w <= 0.0f) {
+			return false;
+		}
+		Vector3 screen = ToScreen(clip);
+		minX = std::min(minX, screen.x);
+		minY = std::min(minY, screen.y);
+		maxX = std::max(maxX, screen.x);
+		maxY = std::max(maxY, screen.y);
+		nearestDepth = std::min(nearestDepth, screen.z);
+	}
+
+	// 画面外のものは視錐台カリングに任せる
+	if (maxX < 0.0f || maxY < 0.0f || minX >= float(width) || minY >= float(height)) {
+		return false;
+	}
+
+	// 掛かるピクセルを1ピクセル広げて調べる（ピクセルの中心で覆うかを決めたオクルーダーの縁の誤差を吸収する）
+	int x0 = std::max(int(std::floor(minX)) - 1, 0);
+	int y0 = std::max(int(std::floor(minY)) - 1, 0);
+	int x1 = std::min(int(std::floor(maxX)) + 1, int(width) - 1);
+	int y1 = std::min(int(std::floor(maxY)) + 1, int(height) - 1);
+
+	for (int tileY = y0 / int(kTileSize); tileY <= y1 / int(kTileSize); ++tileY) {
+		for (int tileX = x0 / int(kTileSize); tileX <= x1 / int(kTileSize); ++tileX) {
+			// タイルの全ピクセルがオブジェクトより手前なら、ピクセルを見なくてよい
+			if (tileMaxDepth[tileY * tileCountX + tileX] < nearestDepth) {
+				continue;
+			}
+			// 重なっているピクセルのどれかがオブジェクトより奥なら見えている
+			int pixelX0 = std::max(x0, tileX * int(kTileSize));
+			int pixelX1 = std::min(x1, tileX * int(kTileSize) + int(kTileSize) - 1);
+			int pixelY0 = std::max(y0, tileY * int(kTileSize));
+			int pixelY1 = std::min(y1, tileY * int(kTileSize) + int(kTileSize) - 1);
+			for (int y = pixelY0; y <= pixelY1; ++y) {
+				const float *row = &depthBuffer[size_t(y) * width];
+				for (int x = pixelX0; x <= pixelX1; ++x) {
+					if (row[x] >= nearestDepth) {
+						return false;
+					}
+				}
+			}
+		}
+	}
+
+	++statistics.occludedObjects;
+	return true;
+}
+
+void OcclusionBuffer::RasterizeClipTriangle(const Vector4 &v0, const Vector4 &v1, const Vector4 &v2)
+{
+	// 3つとも同じ面の外にあれば描かない
+	if ((v0.x > v0.w && v1.x > v1.w && v2.x > v2.w) || (v0.x < -v0.w && v1.x < -v1.w && v2.x < -v2.w) ||
+		(v0.y > v0.w && v1.y > v1.w && v2.y > v2.w) || (v0.y < -v0.w && v1.y < -v1.w && v2.y < -v2.w) ||
+		(v0.z < 0.0f && v1.z < 0.0f && v2.z < 0.0f)) {
+		return;
+	}
+
+	// ニア面をまたいでいなければそのまま描く
+	if (v0.z >= 0.0f && v1.z >= 0.0f && v2.z >= 0.0f) {
+		RasterizeScreenTriangle(ToScreen(v0), ToScreen(v1), ToScreen(v2));
+		return;
+	}
+
+	// ニア面で切る（三角形は最大で四角形になる）
+	const Vector4 input[3] = { v0, v1, v2 };
+	Vector4 polygon[4];
+	int count = 0;
+	for (int i = 0; i < 3; ++i) {
+		const Vector4 &current = input[i];
+		const Vector4 &next = input[(i + 1) % 3];
+		if (current.z >= 0.0f) {
+			polygon[count++] = current;
+		}
+		if ((current.z >= 0.0f) != (next.z >= 0.0f)) {
+			polygon[count++] = LerpClip(current, next);
+		}
+	}
+
+	Vector3 screen[4];
+	for (int i = 0; i < count; ++i) {
+		screen[i] = ToScreen(polygon[i]);
+	}
+	for (int i = 1; i + 1 < count; ++i) {
+		RasterizeScreenTriangle(screen[0], screen[i], screen[i + 1]);
+	}
+}
+
+void OcclusionBuffer::RasterizeScreenTriangle(const Vector3 &v0, const Vector3 &v1, const Vector3 &v2)
+{
+	// 向きをそろえる（辺の式が内側で正になるように）
+	float area = (v1.x - v0.x) * (v2.y - v0.y) - (v1.y - v0.y) * (v2.x - v0.x);
+	if (std::fabs(area) < kMinTriangleArea) {
+		return;
+	}
+	const Vector3 &a = v0;
+	const Vector3 &b = area > 0.0f ? v1 : v2;
+	const Vector3 &c = area > 0.0f ? v2 : v1;
+	area = std::fabs(area);
+
+	// 中心が三角形の外接矩形に入るピクセルの範囲
+	float minX = std::min({ a.x, b.x, c.x });
+	float maxX = std::max({ a.x, b.x, c.x });
+	float minY = std::min({ a.y, b.y, c.y });
+	float maxY = std::max({ a.y, b.y, c.y });
+	int x0 = std::max(int(std::ceil(std::max(minX - 0.5f, -1.0f))), 0);
+	int x1 = std::min(int(std::floor(std::min(maxX - 0.5f, float(width)))), int(width) - 1);
+	int y0 = std::max(int(std::ceil(std::max(minY - 0.5f, -1.0f))), 0);
+	int y1 = std::min(int(std::floor(std::min(maxY - 0.5f, float(height)))), int(height) - 1);
+	if (x0 > x1 || y0 > y1) {
+		return;
+	}
+	++statistics.rasterizedTriangles;
+
+	// 辺の式（点の向かいの辺の式がその点の重み）
+	EdgeFunction edge0 = MakeEdge(b, c);
+	EdgeFunction edge1 = MakeEdge(c, a);
+	EdgeFunction edge2 = MakeEdge(a, b);
+
+	// 深度の平面の式 z = depthA * x + depthB * y + depthC（画面上でz/wは線形）
+	float inverseArea = 1.0f / area;
+	float depthA = (edge0.a * a.z + edge1.a * b.z + edge2.a * c.z) * inverseArea;
+	float depthB = (edge0.b * a.z + edge1.b * b.z + edge2.b * c.z) * inverseArea;
+	float depthC = a.z - depthA * a.x - depthB * a.y;
+	// ピクセルの範囲で最も奥になる値を書く（中心から縦横0.5ずれたところまで）
+	depthC += 0.5f * (std::fabs(depthA) + std::fabs(depthB));
+
+	// 4ピクセルずつ描くので左端を4の倍数にそろえる（幅は8の倍数なので右端ははみ出さない）
+	x0 &= ~3;
+
+#if MATH_USE_SSE
+	const __m128 laneOffset = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 edge0A = _mm_set1_ps(edge0.a), edge1A = _mm_set1_ps(edge1.a), edge2A = _mm_set1_ps(edge2.a);
+	const __m128 depthAV = _mm_set1_ps(depthA);
+	for (int y = y0; y <= y1; ++y) {
+		float centerY = float(y) + 0.5f;
+		const __m128 edge0Row = _mm_set1_ps(edge0.b * centerY + edge0.c);
+		const __m128 edge1Row = _mm_set1_ps(edge1.b * centerY + edge1.c);
+		const __m128 edge2Row = _mm_set1_ps(edge2.b * centerY + edge2.c);
+		const __m128 depthRow = _mm_set1_ps(depthB * centerY + depthC);
+		float *row = &depthBuffer[size_t(y) * width];
+		for (int x = x0; x <= x1; x += 4) {
+			__m128 centerX = _mm_add_ps(_mm_set1_ps(float(x)), laneOffset);
+			__m128 weight0 = _mm_add_ps(_mm_mul_ps(edge0A, centerX), edge0Row);
+			__m128 weight1 = _mm_add_ps(_mm_mul_ps(edge1A, centerX), edge1Row);
+			__m128 weight2 = _mm_add_ps(_mm_mul_ps(edge2A, centerX), edge2Row);
+			__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(weight0, zero), _mm_cmpge_ps(weight1, zero)), _mm_cmpge_ps(weight2, zero));
+			if (_mm_movemask_ps(inside) == 0) {
+				continue;
+			}
+			__m128 depth = _mm_add_ps(_mm_mul_ps(depthAV, centerX), depthRow);
+			__m128 current = _mm_loadu_ps(row + x);
+			__m128 written = _mm_min_ps(current, depth);
+			_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, written), _mm_andnot_ps(inside, current)));
+		}
+	}
+#else
+	for (int y = y0; y <= y1; ++y) {
+		float centerY = float(y) + 0.5f;
+		float edge0Row = edge0.b * centerY + edge0.c;
+		float edge1Row = edge1.b * centerY + edge1.c;
+		float edge2Row = edge2.b * centerY + edge2.c;
+		float depthRow = depthB * centerY + depthC;
+		float *row = &depthBuffer[size_t(y) * width];
+		for (int x = x0; x <= x1; ++x) {
+			float centerX = float(x) + 0.5f;
+			if (edge0.a * centerX + edge0Row >= 0.0f && edge1.a * centerX + edge1Row >= 0.0f && edge2.a * centerX + edge2Row >= 0.0f) {
+				row[x] = std::min(row[x], depthA * centerX + depthRow);
+			}
+		}
+	}
+#endif
+}
+
+Vector3 OcclusionBuffer::ToScreen(const Vector4 &clip) const
+{
+	float inverseW = 1.0f / clip.w;
+	return {
+		(clip.x * inverseW * 0.5f + 0.5f) * float(width),
+		(0.5f - clip.y * inverseW * 0.5f) * float(height),
+		clip.z * inverseW,
+	};
+}
\ No newline at end of file
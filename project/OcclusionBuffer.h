@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MathTypes.h"
+
+// CPUで描く低解像度の深度バッファ（ソフトウェアオクルージョンカリング用）
+// 壁や地形などの大きな物（オクルーダー）の三角形を毎フレーム描き、8x8ピクセルのタイルごとに最も奥の深度をまとめておく
+// オブジェクトのAABBを画面に写した範囲がすべてオクルーダーより奥なら、隠れているので描かなくてよい
+// ・深度はD3Dと同じく手前0、奥1
+// ・オクルーダーの深度はピクセルの範囲で最も奥の値を書き、判定するAABBの範囲は1ピクセル広げる（見えている物を消さない側に倒す）
+// ・ピクセルの中心で覆うかを決めるので、1ピクセルより細いオクルーダーは何も隠さず、オクルーダー同士の1ピクセルより狭い隙間は塞がる
+class OcclusionBuffer
+{
+public:
+
+	// 直前のフレームの統計
+	struct Statistics
+	{
+		uint32_t occluderTriangles = 0; // 描こうとしたオクルーダーの三角形数
+		uint32_t rasterizedTriangles = 0; // ニア面で切ったり画面外を捨てたりした後、実際に描いた三角形数
+		uint32_t testedObjects = 0; // IsOccludedで調べたオブジェクト数
+		uint32_t occludedObjects = 0; // 隠れていたオブジェクト数
+	};
+
+	// 初期化（幅と高さはタイルの大きさの倍数に切り上げる）
+	void Initialize(uint32_t width = 256, uint32_t height = 144);
+
+	// フレームの開始（深度を一番奥にし、描くときのビュー射影行列を決める）
+	void BeginFrame(const math::Matrix4x4 &viewProjection);
+
+	/// <summary>
+	/// オクルーダーの三角形を描く
+	/// </summary>
+	/// <param name="positions">最初の頂点のx座標（x,y,zが並んでいること）</param>
+	/// <param name="positionStride">頂点の間隔（バイト数）</param>
+	/// <param name="vertexCount">頂点数</param>
+	/// <param name="indices">三角形リストのインデックス</param>
+	/// <param name="indexCount">インデックス数</param>
+	/// <param name="world">ワールド行列</param>
+	void RenderOccluder(const float *positions, size_t positionStride, size_t vertexCount, const uint32_t *indices, size_t indexCount, const math::Matrix4x4 &world);
+
+	// オクルーダーを描き終えたら呼ぶ（タイルごとの最も奥の深度を作る）
+	void EndFrame();
+
+	/// <summary>
+	/// ワールド座標のAABBがオクルーダーに完全に隠れているか（EndFrameの後に呼ぶ）
+	/// </summary>
+	/// <param name="aabb">ワールド座標のAABB</param>
+	/// <returns>隠れていればtrue。ニア面をまたぐものや画面外のものはfalse</returns>
+	bool IsOccluded(const math::AABB &aabb);
+
+	// ===== getter =====
+	uint32_t GetWidth() const { return width; }
+	uint32_t GetHeight() const { return height; }
+	// ピクセルの深度（何も描かれていなければFLT_MAX）
+	float GetDepth(uint32_t x, uint32_t y) const { return depthBuffer[y * width + x]; }
+	const Statistics &GetStatistics() const { return statistics; }
+
+private:
+
+	// タイルの大きさ（ピクセル）
+	static constexpr uint32_t kTileSize = 8;
+
+	// クリップ座標の三角形をニア面で切って描く
+	void RasterizeClipTriangle(const math::Vector4 &v0, const math::Vector4 &v1, const math::Vector4 &v2);
+	// 画面座標（x,yはピクセル、zは深度）の三角形を描く
+	void RasterizeScreenTriangle(const math::Vector3 &v0, const math::Vector3 &v1, const math::Vector3 &v2);
+	// クリップ座標を画面座標にする
+	math::Vector3 ToScreen(const math::Vector4 &clip) const;
+
+	uint32_t width = 0;
+	uint32_t height = 0;
+	uint32_t tileCountX = 0;
+	uint32_t tileCountY = 0;
+
+	// ピクセルごとの深度と、タイルごとの最も奥の深度
+	std::vector<float> depthBuffer;
+	std::vector<float> tileMaxDepth;
+
+	math::Matrix4x4 viewProjection {};
+
+	// オクルーダーの頂点をクリップ座標にしたもの（作業用）
+	std::vector<math::Vector4> clipVertices;
+
+	Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,71 @@
+#include "ParticleRenderer.h"
+#include "Object3dCommon.h"
+#include "DirectXCommon.h"
+#include "TextureManager.h"
+#include "RenderQueue.h"
+#include <cassert>
+
+void ParticleRenderer::Initialize(Object3dCommon *object3dCommon, ThreadPool *threadPool)
+{
+	// 引数で受け取ってメンバ変数に記録する
+	object3dCommon_ = object3dCommon;
+	threadPool_ = threadPool;
+}
+
+void ParticleRenderer::Draw(const ParticleSystem *particleSystem, AssetHandle textureHandle)
+{
+	assert(particleSystem && textureHandle.IsValid());
+	drawItems.push_back({ particleSystem, textureHandle });
+}
+
+void ParticleRenderer::Flush()
+{
+	// 描画キューがあればパケットを積む（パーティクルのパスは3Dオブジェクトの後に描かれる）
+	if (RenderQueue *renderQueue = object3dCommon_->GetRenderQueue()) {
+		if (submitted) {
+			return;
+		}
+		submitted = true;
+		uint64_t sortKey = RenderQueue::MakeSortKey(RenderPass::kParticle, 0, 0, 0, static_cast<uint32_t>(renderQueue->GetPacketCount()));
+		renderQueue->Submit(sortKey, [](const void *object, RenderStateCache &stateCache) {
+			const_cast<ParticleRenderer *>(static_cast<const ParticleRenderer *>(object))->Render(&stateCache);
+			}, this);
+		return;
+	}
+
+	Render(nullptr);
+}
+
+void ParticleRenderer::Render(RenderStateCache *stateCache)
+{
+	submitted = false;
+	statistics = {};
+
+	DirectXCommon *dxCommon = object3dCommon_->GetDxCommon();
+	ID3D12GraphicsCommandList *commandList = dxCommon->GetCommandList();
+	for (const DrawItem &item : drawItems) {
+		const uint32_t particleCount = item.particleSystem->GetAliveCount();
+		if (particleCount == 0) {
+			continue;
+		}
+
+		// 生きているパーティクルをこのフレーム用の領域へ直接書き出す
+		DirectXCommon::UploadAllocation allocation = dxCommon->AllocateUpload(sizeof(ParticleSystem::Instance) * particleCount, 16);
+		if (!allocation.cpuAddress) {
+			continue;
+		}
+		item.particleSystem->WriteInstances(static_cast<ParticleSystem::Instance *>(allocation.cpuAddress), threadPool_);
+
+		object3dCommon_->SetParticlePipeline(stateCache);
+		if (!stateCache || stateCache->SetTexture(item.textureHandle.index)) {
+			commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(item.textureHandle));
+		}
+		commandList->SetGraphicsRootShaderResourceView(6, allocation.gpuAddress);
+		commandList->DrawInstanced(6, particleCount, 0, 0);
+
+		statistics.particleCount += particleCount;
+		statistics.drawCount++;
+	}
+
+	drawItems.clear();
+}
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "AssetRegistry.h"
+#include "ParticleSystem.h"
+
+class Object3dCommon;
+class RenderStateCache;
+class ThreadPool;
+
+// パーティクルの描画
+// ParticleSystemが詰めて書き出したInstanceをこのフレーム用のアップロード領域にそのまま置き、StructuredBufferとして
+// 1システム1回のインスタンス描画（6頂点×パーティクル数）でカメラを向いた四角形を描く
+// ルートシグネチャとカメラはObject3dCommonのものを使う
+class ParticleRenderer
+{
+public:
+
+	// 直前に描いた結果
+	struct Statistics
+	{
+		uint32_t particleCount = 0; // 描いたパーティクル数
+		uint32_t drawCount = 0; // Drawの回数
+	};
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="object3dCommon">3Dオブジェクト共通部（PSOと描画キュー）</param>
+	/// <param name="threadPool">指定するとInstanceの書き出しをエミッターごとに並列に行う</param>
+	void Initialize(Object3dCommon *object3dCommon, ThreadPool *threadPool = nullptr);
+
+	/// <summary>
+	/// パーティクルシステムを積む（ParticleSystem::Updateの後に呼ぶ。Flushまで破棄しない）
+	/// </summary>
+	/// <param name="particleSystem">描くパーティクルシステム</param>
+	/// <param name="textureHandle">テクスチャ（TextureManagerで読み込み済みのもの）</param>
+	void Draw(const ParticleSystem *particleSystem, AssetHandle textureHandle);
+
+	// 積んだパーティクルシステムを描く（描画キューがあればパーティクルのパスにパケットを積み、キューの実行時に描く）
+	// フレームに1回、積み終えてから呼ぶ
+	void Flush();
+
+	// 直前に描いた結果
+	const Statistics &GetStatistics() const { return statistics; }
+
+private:
+
+	// 積んだパーティクルシステム1つ分
+	struct DrawItem
+	{
+		const ParticleSystem *particleSystem;
+		AssetHandle textureHandle;
+	};
+
+	// Instanceを書き出して描く（stateCacheがあればセット済みのステートを省く）
+	void Render(RenderStateCache *stateCache);
+
+	Object3dCommon *object3dCommon_ = nullptr;
+	ThreadPool *threadPool_ = nullptr;
+
+	std::vector<DrawItem> drawItems;
+	// 描画キューにパケットを積んだか（同じフレームで2回積まない）
+	bool submitted = false;
+
+	Statistics statistics;
+};
\ No newline at end of file
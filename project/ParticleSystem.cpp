@@ -0,0 +1,309 @@
+#include "ParticleSystem.h"
+#include "MathFunctions.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+
+#if MATH_USE_SSE
+#include <emmintrin.h>
+#endif
+
+using namespace math;
+
+namespace {
+
+	// 端数のレーンも含めて処理できるよう、配列の長さを4の倍数にする
+	inline uint32_t RoundUpToLanes(uint32_t count)
+	{
+		return (count + 3) & ~3u;
+	}
+
+	// xorshift32で[0, 1)の乱数
+	inline float NextRandom(uint32_t &state)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		return float(state >> 8) * (1.0f / 16777216.0f);
+	}
+
+	inline float RandomRange(uint32_t &state, float minimum, float maximum)
+	{
+		return minimum + (maximum - minimum) * NextRandom(state);
+	}
+}
+
+static_assert(sizeof(ParticleSystem::Instance) == 20 && offsetof(ParticleSystem::Instance, size) == 12,
+	"Instance must match ParticleInstance in Particle.VS.hlsl");
+
+uint32_t ParticleSystem::AddEmitter(const EmitterSettings &settings)
+{
+	assert(settings.capacity > 0);
+	Pool pool;
+	pool.settings = settings;
+	pool.capacity = settings.capacity;
+	const size_t length = RoundUpToLanes(settings.capacity);
+	for (std::vector<float> *stream : { &pool.positionX, &pool.positionY, &pool.positionZ,
+		&pool.velocityX, &pool.velocityY, &pool.velocityZ, &pool.life, &pool.inverseLifetime }) {
+		stream->assign(length, 0.0f);
+	}
+	// エミッターごとに違う乱数の列にする（0は使えない）
+	pool.randomState = 0x9E3779B9u * uint32_t(pools.size() + 1);
+
+	pools.push_back(std::move(pool));
+	return uint32_t(pools.size() - 1);
+}
+
+ParticleSystem::EmitterSettings &ParticleSystem::GetEmitterSettings(uint32_t emitter)
+{
+	assert(emitter < pools.size());
+	return pools[emitter].settings;
+}
+
+void ParticleSystem::Burst(uint32_t emitter, uint32_t count)
+{
+	assert(emitter < pools.size());
+	pools[emitter].pendingBurst += count;
+}
+
+void ParticleSystem::Clear()
+{
+	for (Pool &pool : pools) {
+		pool.count = 0;
+		pool.spawnAccumulator = 0.0f;
+		pool.pendingBurst = 0;
+	}
+	statistics = {};
+}
+
+void ParticleSystem::Update(float deltaTime, ThreadPool *threadPool)
+{
+	if (threadPool) {
+		threadPool->ParallelFor(pools.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				UpdatePool(pools[i], deltaTime);
+			}
+			});
+	} else {
+		for (Pool &pool : pools) {
+			UpdatePool(pool, deltaTime);
+		}
+	}
+
+	// 書き出す位置を決めて、数を集計する
+	statistics = {};
+	for (Pool &pool : pools) {
+		pool.instanceOffset = statistics.aliveCount;
+		statistics.aliveCount += pool.count;
+		statistics.spawnedCount += pool.spawnedCount;
+		statistics.diedCount += pool.diedCount;
+	}
+}
+
+void ParticleSystem::WriteInstances(Instance *instances, ThreadPool *threadPool) const
+{
+	if (threadPool) {
+		threadPool->ParallelFor(pools.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				WritePool(pools[i], instances + pools[i].instanceOffset);
+			}
+			});
+	} else {
+		for (const Pool &pool : pools) {
+			WritePool(pool, instances + pool.instanceOffset);
+		}
+	}
+}
+
+void ParticleSystem::UpdatePool(Pool &pool, float deltaTime)
+{
+	// 今いるものを進めて、寿命が尽きたものを詰めてから、空いた分に発生させる
+	Integrate(pool, deltaTime);
+	Compact(pool);
+
+	pool.spawnAccumulator += pool.settings.rate * deltaTime;
+	uint32_t spawnCount = uint32_t(pool.spawnAccumulator);
+	pool.spawnAccumulator -= float(spawnCount);
+	spawnCount += pool.pendingBurst;
+	pool.pendingBurst = 0;
+	Spawn(pool, spawnCount);
+}
+
+void ParticleSystem::Integrate(Pool &pool, float deltaTime)
+{
+	const EmitterSettings &settings = pool.settings;
+	// 速度の減衰は1フレーム分の係数にしておく
+	const float damping = std::max(0.0f, 1.0f - settings.drag * deltaTime);
+	const uint32_t length = RoundUpToLanes(pool.count);
+
+#if MATH_USE_SSE
+	const __m128 dt = _mm_set1_ps(deltaTime);
+	const __m128 damp = _mm_set1_ps(damping);
+	const __m128 accelerationX = _mm_set1_ps(settings.acceleration.x * deltaTime);
+	const __m128 accelerationY = _mm_set1_ps(settings.acceleration.y * deltaTime);
+	const __m128 accelerationZ = _mm_set1_ps(settings.acceleration.z * deltaTime);
+	float *positionX = pool.positionX.data();
+	float *positionY = pool.positionY.data();
+	float *positionZ = pool.positionZ.data();
+	float *velocityX = pool.velocityX.data();
+	float *velocityY = pool.velocityY.data();
+	float *velocityZ = pool.velocityZ.data();
+	float *life = pool.life.data();
+	// 端数のレーンは死んでいる要素なので、一緒に進めても結果に影響しない
+	for (uint32_t i = 0; i < length; i += 4) {
+		__m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityX + i), accelerationX), damp);
+		__m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityY + i), accelerationY), damp);
+		__m128 vz = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(velocityZ + i), accelerationZ), damp);
+		_mm_storeu_ps(velocityX + i, vx);
+		_mm_storeu_ps(velocityY + i, vy);
+		_mm_storeu_ps(velocityZ + i, vz);
+		_mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(vx, dt)));
+		_mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(vy, dt)));
+		_mm_storeu_ps(positionZ + i, _mm_add_ps(_mm_loadu_ps(positionZ + i), _mm_mul_ps(vz, dt)));
+		_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), dt));
+	}
+#else
+	const Vector3 acceleration = { settings.acceleration.x * deltaTime, settings.acceleration.y * deltaTime, settings.acceleration.z * deltaTime };
+	for (uint32_t i = 0; i < length; ++i) {
+		pool.velocityX[i] = (pool.velocityX[i] + acceleration.x) * damping;
+		pool.velocityY[i] = (pool.velocityY[i] + acceleration.y) * damping;
+		pool.velocityZ[i] = (pool.velocityZ[i] + acceleration.z) * damping;
+		pool.positionX[i] += pool.velocityX[i] * deltaTime;
+		pool.positionY[i] += pool.velocityY[i] * deltaTime;
+		pool.positionZ[i] += pool.velocityZ[i] * deltaTime;
+		pool.life[i] -= deltaTime;
+	}
+#endif
+}
+
+void ParticleSystem::Compact(Pool &pool)
+{
+	float *life = pool.life.data();
+	uint32_t count = pool.count;
+	uint32_t i = 0;
+	while (i < count) {
+#if MATH_USE_SSE
+		// 4つとも生きていれば飛ばす（ほとんどのパーティクルは生きている）
+		if (i + 4 <= count && _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(life + i), _mm_setzero_ps())) == 0) {
+			i += 4;
+			continue;
+		}
+#endif
+		if (life[i] > 0.0f) {
+			i++;
+			continue;
+		}
+		// 末尾の要素で穴を埋める（末尾も死んでいれば、次の周回で同じ位置をもう一度調べる）
+		count--;
+		pool.positionX[i] = pool.positionX[count];
+		pool.positionY[i] = pool.positionY[count];
+		pool.positionZ[i] = pool.positionZ[count];
+		pool.velocityX[i] = pool.velocityX[count];
+		pool.velocityY[i] = pool.velocityY[count];
+		pool.velocityZ[i] = pool.velocityZ[count];
+		pool.life[i] = pool.life[count];
+		pool.inverseLifetime[i] = pool.inverseLifetime[count];
+	}
+	pool.diedCount = pool.count - count;
+	pool.count = count;
+}
+
+void ParticleSystem::Spawn(Pool &pool, uint32_t count)
+{
+	const EmitterSettings &settings = pool.settings;
+	count = std::min(count, pool.capacity - pool.count);
+	uint32_t &random = pool.randomState;
+	for (uint32_t n = 0; n < count; ++n) {
+		const uint32_t i = pool.count + n;
+		pool.positionX[i] = settings.position.x + RandomRange(random, -settings.spawnExtent.x, settings.spawnExtent.x);
+		pool.positionY[i] = settings.position.y + RandomRange(random, -settings.spawnExtent.y, settings.spawnExtent.y);
+		pool.positionZ[i] = settings.position.z + RandomRange(random, -settings.spawnExtent.z, settings.spawnExtent.z);
+		pool.velocityX[i] = RandomRange(random, settings.velocityMin.x, settings.velocityMax.x);
+		pool.velocityY[i] = RandomRange(random, settings.velocityMin.y, settings.velocityMax.y);
+		pool.velocityZ[i] = RandomRange(random, settings.velocityMin.z, settings.velocityMax.z);
+		const float lifetime = std::max(RandomRange(random, settings.lifetimeMin, settings.lifetimeMax), 1e-3f);
+		pool.life[i] = lifetime;
+		pool.inverseLifetime[i] = 1.0f / lifetime;
+	}
+	pool.count += count;
+	pool.spawnedCount = count;
+}
+
+void ParticleSystem::WritePool(const Pool &pool, Instance *instances)
+{
+	const EmitterSettings &settings = pool.settings;
+	const uint32_t count = pool.count;
+	uint32_t i = 0;
+
+	// 大きさと色は寿命の経過の割合で線形に変える
+	// 色は0～255にしておき、0.5を足して切り捨てる（四捨五入）と8bitになる
+	const float startColors[4] = { settings.startColor.x, settings.startColor.y, settings.startColor.z, settings.startColor.w };
+	const float endColors[4] = { settings.endColor.x, settings.endColor.y, settings.endColor.z, settings.endColor.w };
+	float startColor255[4];
+	float deltaColor255[4];
+	for (int channel = 0; channel < 4; ++channel) {
+		const float start = std::clamp(startColors[channel], 0.0f, 1.0f) * 255.0f;
+		const float end = std::clamp(endColors[channel], 0.0f, 1.0f) * 255.0f;
+		startColor255[channel] = start + 0.5f;
+		deltaColor255[channel] = end - start;
+	}
+
+#if MATH_USE_SSE
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 startSize = _mm_set1_ps(settings.startSize);
+	const __m128 deltaSize = _mm_set1_ps(settings.endSize - settings.startSize);
+	__m128 startColor[4];
+	__m128 deltaColor[4];
+	for (int channel = 0; channel < 4; ++channel) {
+		startColor[channel] = _mm_set1_ps(startColor255[channel]);
+		deltaColor[channel] = _mm_set1_ps(deltaColor255[channel]);
+	}
+	for (; i + 4 <= count; i += 4) {
+		// 経過の割合（0～1）
+		__m128 t = _mm_sub_ps(one, _mm_mul_ps(_mm_loadu_ps(&pool.life[i]), _mm_loadu_ps(&pool.inverseLifetime[i])));
+		t = _mm_min_ps(_mm_max_ps(t, _mm_setzero_ps()), one);
+
+		__m128 x = _mm_loadu_ps(&pool.positionX[i]);
+		__m128 y = _mm_loadu_ps(&pool.positionY[i]);
+		__m128 z = _mm_loadu_ps(&pool.positionZ[i]);
+		__m128 size = _mm_add_ps(startSize, _mm_mul_ps(deltaSize, t));
+
+		// 各成分を8bitにして、1つの32bitに詰める
+		__m128i color = _mm_setzero_si128();
+		for (int channel = 0; channel < 4; ++channel) {
+			__m128i value = _mm_cvttps_epi32(_mm_add_ps(startColor[channel], _mm_mul_ps(deltaColor[channel], t)));
+			color = _mm_or_si128(color, _mm_slli_epi32(value, channel * 8));
+		}
+		const __m128 colors = _mm_castsi128_ps(color);
+
+		// 成分ごとの並びから、パーティクルごとの(x, y, z, size)へ転置する
+		_MM_TRANSPOSE4_PS(x, y, z, size);
+
+		// 4パーティクル分（80byte = 5レーン×4）を隙間なく並べて書く
+		// [x0 y0 z0 s0] [c0 x1 y1 z1] [s1 c1 x2 y2] [z2 s2 c2 x3] [y3 z3 s3 c3]
+		const __m128 out1 = _mm_move_ss(_mm_shuffle_ps(y, y, _MM_SHUFFLE(2, 1, 0, 0)), colors);
+		const __m128 out2 = _mm_shuffle_ps(_mm_shuffle_ps(y, colors, _MM_SHUFFLE(1, 1, 3, 3)), z, _MM_SHUFFLE(1, 0, 2, 0));
+		const __m128 out3 = _mm_shuffle_ps(z, _mm_shuffle_ps(colors, size, _MM_SHUFFLE(0, 0, 2, 2)), _MM_SHUFFLE(2, 0, 3, 2));
+		const __m128 out4 = _mm_shuffle_ps(size, _mm_shuffle_ps(size, colors, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 1));
+		float *destination = &instances[i].position.x;
+		_mm_storeu_ps(destination, x);
+		_mm_storeu_ps(destination + 4, out1);
+		_mm_storeu_ps(destination + 8, out2);
+		_mm_storeu_ps(destination + 12, out3);
+		_mm_storeu_ps(destination + 16, out4);
+	}
+#endif
+
+	// 端数（SSEが使えなければすべて）
+	for (; i < count; ++i) {
+		const float t = std::clamp(1.0f - pool.life[i] * pool.inverseLifetime[i], 0.0f, 1.0f);
+		Instance &instance = instances[i];
+		instance.position = { pool.positionX[i], pool.positionY[i], pool.positionZ[i] };
+		instance.size = settings.startSize + (settings.endSize - settings.startSize) * t;
+		instance.color = 0;
+		for (int channel = 0; channel < 4; ++channel) {
+			instance.color |= uint32_t(startColor255[channel] + deltaColor255[channel] * t) << (channel * 8);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MathTypes.h"
+
+class ThreadPool;
+
+// パーティクルシステム
+// パーティクルをエミッターごとのプールに成分ごとの配列（SoA）で持ち、位置・速度・寿命を4つずつSIMDで進める
+// 寿命が尽きたパーティクルは末尾の要素で穴を埋めて詰める（並び順は保たない）
+// エミッター同士は独立しているので、ThreadPoolを渡すとエミッターごとに並列に更新する
+// 描画用には、生きているパーティクルをWriteInstancesでInstanceの配列（インスタンス描画のStructuredBuffer）に詰めて書き出す
+// GPUには触らない（描くのはParticleRenderer）
+class ParticleSystem
+{
+public:
+
+	// 描画に使う1パーティクル分（Particle.VS.hlslのParticleInstanceと同じ並び）
+	struct Instance
+	{
+		math::Vector3 position;
+		float size; // ビルボードの一辺（ワールド座標）
+		uint32_t color; // RGBA8（Rが最下位のバイト）
+	};
+
+	// エミッターの設定（AddEmitterの後もGetEmitterSettingsで書き換えられる。capacityは変えられない）
+	struct EmitterSettings
+	{
+		math::Vector3 position = { 0.0f, 0.0f, 0.0f }; // 発生位置の中心
+		math::Vector3 spawnExtent = { 0.0f, 0.0f, 0.0f }; // 発生位置のばらつき（中心からの各軸の最大のずれ）
+		float rate = 100.0f; // 1秒あたりに発生させる数
+		uint32_t capacity = 1024; // 同時に存在できる数（超える分は発生させない）
+		math::Vector3 velocityMin = { -1.0f, 2.0f, -1.0f }; // 初速の範囲（各軸で一様に選ぶ）
+		math::Vector3 velocityMax = { 1.0f, 4.0f, 1.0f };
+		math::Vector3 acceleration = { 0.0f, -9.8f, 0.0f }; // 重力などの加速度
+		float drag = 0.0f; // 空気抵抗（1秒あたりに失う速度の割合）
+		float lifetimeMin = 1.0f; // 寿命の範囲（秒）
+		float lifetimeMax = 2.0f;
+		float startSize = 0.2f; // 大きさ（寿命の始めから終わりへ線形に変える）
+		float endSize = 0.0f;
+		math::Vector4 startColor = { 1.0f, 1.0f, 1.0f, 1.0f }; // 色（同じく線形に変える）
+		math::Vector4 endColor = { 1.0f, 1.0f, 1.0f, 0.0f };
+	};
+
+	// 直前のUpdateの結果
+	struct Statistics
+	{
+		uint32_t aliveCount = 0; // 生きている数
+		uint32_t spawnedCount = 0; // 発生させた数
+		uint32_t diedCount = 0; // 寿命が尽きて消えた数
+	};
+
+	/// <summary>
+	/// エミッターを追加する（プールはcapacity分をここで確保する）
+	/// </summary>
+	/// <param name="settings">エミッターの設定</param>
+	/// <returns>エミッターの番号</returns>
+	uint32_t AddEmitter(const EmitterSettings &settings);
+
+	// エミッターの設定
+	EmitterSettings &GetEmitterSettings(uint32_t emitter);
+	size_t GetEmitterCount() const { return pools.size(); }
+
+	// 次のUpdateでまとめて発生させる（爆発のような一度きりの演出用）
+	void Burst(uint32_t emitter, uint32_t count);
+
+	// すべてのパーティクルを消す
+	void Clear();
+
+	/// <summary>
+	/// パーティクルを進め、寿命が尽きたものを詰めてから新しく発生させる
+	/// </summary>
+	/// <param name="deltaTime">経過時間（秒）</param>
+	/// <param name="threadPool">指定するとエミッターごとに並列に処理する</param>
+	void Update(float deltaTime, ThreadPool *threadPool = nullptr);
+
+	/// <summary>
+	/// 生きているパーティクルを描画用に詰めて書き出す（Updateの後に呼ぶ）
+	/// エミッターの番号順に、GetAliveCount()個を隙間なく書く
+	/// </summary>
+	/// <param name="instances">書き込み先（GetAliveCount()個分。アップロード用の領域へ直接書いてよい）</param>
+	/// <param name="threadPool">指定するとエミッターごとに並列に処理する</param>
+	void WriteInstances(Instance *instances, ThreadPool *threadPool = nullptr) const;
+
+	// 生きているパーティクルの数（直前のUpdateの時点）
+	uint32_t GetAliveCount() const { return statistics.aliveCount; }
+	const Statistics &GetStatistics() const { return statistics; }
+
+private:
+
+	// エミッター1つ分のプール
+	// 各配列はcapacityを4の倍数に切り上げた長さで、SIMDは端数のレーンも含めてまとめて処理する
+	struct Pool
+	{
+		EmitterSettings settings;
+		std::vector<float> positionX;
+		std::vector<float> positionY;
+		std::vector<float> positionZ;
+		std::vector<float> velocityX;
+		std::vector<float> velocityY;
+		std::vector<float> velocityZ;
+		std::vector<float> life; // 残りの寿命（秒。0以下で消える）
+		std::vector<float> inverseLifetime; // 1 / 寿命（経過の割合を求める用）
+		uint32_t count = 0; // 生きている数（先頭からcount個）
+		uint32_t capacity = 0;
+		float spawnAccumulator = 0.0f; // 発生させきれなかった端数
+		uint32_t pendingBurst = 0;
+		uint32_t randomState = 1; // xorshiftの状態（エミッターごとに持つので並列でも決定的）
+		uint32_t spawnedCount = 0;
+		uint32_t diedCount = 0;
+		uint32_t instanceOffset = 0; // WriteInstancesでの書き込み位置
+	};
+
+	// 1つのプールを進める
+	static void UpdatePool(Pool &pool, float deltaTime);
+	// 速度と位置を積分し、寿命を減らす
+	static void Integrate(Pool &pool, float deltaTime);
+	// 寿命が尽きたものを詰める
+	static void Compact(Pool &pool);
+	// 新しく発生させる
+	static void Spawn(Pool &pool, uint32_t count);
+	// 1つのプールのパーティクルを書き出す
+	static void WritePool(const Pool &pool, Instance *instances);
+
+	std::vector<Pool> pools;
+	Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cassert>
+
+void RenderStateCache::Reset()
+{
+	boundPipeline = kUnbound;
+	boundTexture = kUnbound;
+	boundMesh = kUnbound;
+}
+
+void RenderStateCache::ResetCounters()
+{
+	issuedCount = 0;
+	avoidedCount = 0;
+}
+
+uint64_t RenderQueue::MakeSortKey(RenderPass pass, uint32_t pipeline, uint32_t texture, uint32_t mesh, uint32_t depth)
+{
+	auto field = [](uint32_t value, uint32_t bits) { return uint64_t(value) & ((uint64_t(1) << bits) - 1); };
+
+	uint64_t key = field(static_cast<uint32_t>(pass), kPassBits);
+	key = (key << kPipelineBits) | field(pipeline, kPipelineBits);
+	key = (key << kTextureBits) | field(texture, kTextureBits);
+	key = (key << kMeshBits) | field(mesh, kMeshBits);
+	key = (key << kDepthBits) | field(depth, kDepthBits);
+	return key;
+}
+
+uint32_t RenderQueue::QuantizeDepth(float depth01)
+{
+	constexpr float kMaxDepth = float((1u << kDepthBits) - 1);
+	return static_cast<uint32_t>(std::clamp(depth01, 0.0f, 1.0f) * kMaxDepth);
+}
+
+void RenderQueue::SetPassSetup(RenderPass pass, PassSetup passSetup)
+{
+	assert(pass < RenderPass::kCount);
+	passSetups[static_cast<size_t>(pass)] = std::move(passSetup);
+}
+
+void RenderQueue::Submit(uint64_t sortKey, DrawFunction draw, const void *object)
+{
+	assert(draw);
+	packets.push_back({ sortKey, draw, object });
+}
+
+void RenderQueue::Sort()
+{
+	const size_t count = packets.size();
+	sortEntries.resize(count);
+	sortScratch.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		sortEntries[i] = { packets[i].sortKey, static_cast<uint32_t>(i) };
+	}
+	if (count < 2) {
+		return;
+	}
+
+	// 下位から8bitずつの基数ソート（各桁は安定なので、同じキーは積んだ順のまま）
+	// 8桁分のヒストグラムは最初に1回の走査でまとめて数える
+	constexpr uint32_t kRadixBits = 8;
+	constexpr uint32_t kRadix = 1u << kRadixBits;
+	constexpr uint32_t kDigitCount = 64 / kRadixBits;
+	std::array<std::array<uint32_t, kRadix>, kDigitCount> histograms {};
+	for (const SortEntry &entry : sortEntries) {
+		for (uint32_t digit = 0; digit < kDigitCount; ++digit) {
+			histograms[digit][(entry.key >> (digit * kRadixBits)) & (kRadix - 1)]++;
+		}
+	}
+
+	for (uint32_t digit = 0; digit < kDigitCount; ++digit) {
+		std::array<uint32_t, kRadix> &histogram = histograms[digit];
+		const uint32_t shift = digit * kRadixBits;
+
+		// 全キーでこの桁が同じなら並びは変わらないので飛ばす（未使用のビットや、パスなどの値が少ない桁）
+		if (histogram[(sortEntries[0].key >> shift) & (kRadix - 1)] == count) {
+			continue;
+		}
+
+		// 数を書き込み位置に変える
+		uint32_t offset = 0;
+		for (uint32_t &bucket : histogram) {
+			uint32_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
+		}
+
+		for (const SortEntry &entry : sortEntries) {
+			sortScratch[histogram[(entry.key >> shift) & (kRadix - 1)]++] = entry;
+		}
+		sortEntries.swap(sortScratch);
+	}
+}
+
+void RenderQueue::Execute()
+{
+	Sort();
+
+	statistics = {};
+	stateCache.ResetCounters();
+
+	uint32_t currentPass = UINT32_MAX;
+	for (const SortEntry &entry : sortEntries) {
+		const DrawPacket &packet = packets[entry.index];
+
+		// パスが変わったら共通設定をし直す（ルートシグネチャが変わるのでバインドも忘れる）
+		uint32_t pass = static_cast<uint32_t>(GetPass(packet.sortKey));
+		if (pass != currentPass) {
+			currentPass = pass;
+			stateCache.Reset();
+			if (pass < passSetups.size() && passSetups[pass]) {
+				passSetups[pass](stateCache);
+			}
+			statistics.passChangeCount++;
+		}
+
+		packet.draw(packet.object, stateCache);
+	}
+
+	statistics.packetCount = static_cast<uint32_t>(packets.size());
+	statistics.stateChangesIssued = stateCache.GetIssuedCount();
+	statistics.stateChangesAvoided = stateCache.GetAvoidedCount();
+
+	Clear();
+}
+
+void RenderQueue::Clear()
+{
+	packets.clear();
+	sortEntries.clear();
+}
\ No newline at end of file
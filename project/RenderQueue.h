@@ -0,0 +1,151 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// 描画中にセットしているステートの記録（同じものを続けてセットしないようにする）
+// ルートシグネチャが変わるとバインドは無効になるので、パスの切り替えでResetする
+class RenderStateCache
+{
+public:
+
+	// セットしているステートを忘れる（次のSetは必ずtrueを返す）
+	void Reset();
+	// 数えたステート変更の回数を0にする
+	void ResetCounters();
+
+	// ===== ステートをセットする前に呼ぶ。trueならセットが必要、falseならセット済み =====
+	bool SetPipeline(uintptr_t pipeline) { return Set(boundPipeline, pipeline); }
+	bool SetTexture(uint32_t texture) { return Set(boundTexture, texture); }
+	bool SetMesh(uintptr_t mesh) { return Set(boundMesh, mesh); }
+
+	// セットした回数と、セット済みだったので省いた回数
+	uint64_t GetIssuedCount() const { return issuedCount; }
+	uint64_t GetAvoidedCount() const { return avoidedCount; }
+
+private:
+
+	static constexpr uintptr_t kUnbound = UINTPTR_MAX;
+
+	bool Set(uintptr_t &bound, uintptr_t value)
+	{
+		if (bound == value) {
+			avoidedCount++;
+			return false;
+		}
+		bound = value;
+		issuedCount++;
+		return true;
+	}
+
+	uintptr_t boundPipeline = kUnbound;
+	uintptr_t boundTexture = kUnbound;
+	uintptr_t boundMesh = kUnbound;
+
+	uint64_t issuedCount = 0;
+	uint64_t avoidedCount = 0;
+};
+
+// 描画パス（ソートキーの最上位。この順に描かれる）
+enum class RenderPass : uint32_t
+{
+	kObject3d, // 3Dオブジェクト
+	kParticle, // パーティクル（半透明なので3Dオブジェクトの後）
+	kSprite, // スプライト
+
+	kCount,
+};
+
+// 描画キュー
+// Object3dやSpriteは描画時にその場で描かずに、ソートキー付きの描画パケットを積む
+// 積んだパケットはフレームの最後に基数ソートし、パス→パイプライン→テクスチャ→メッシュ→深度の順に並べて描く
+// 並べた後は同じステートが続くので、RenderStateCacheでセットし直しを省ける
+class RenderQueue
+{
+public:
+
+	// パケットを描く関数（objectはSubmitで渡したもの）
+	using DrawFunction = void (*)(const void *object, RenderStateCache &stateCache);
+	// パスの最初に呼ぶ共通設定（ルートシグネチャやPSOのセット。セットしたPSOはstateCacheに記録する）
+	using PassSetup = std::function<void(RenderStateCache &stateCache)>;
+
+	// 描画パケット
+	struct DrawPacket
+	{
+		uint64_t sortKey;
+		DrawFunction draw;
+		const void *object;
+	};
+
+	// 直前のExecuteの統計
+	struct Statistics
+	{
+		uint32_t packetCount = 0; // 描いたパケット数
+		uint32_t passChangeCount = 0; // パスの切り替え回数
+		uint64_t stateChangesIssued = 0; // セットしたステートの数
+		uint64_t stateChangesAvoided = 0; // セット済みだったので省いたステートの数
+	};
+
+	// ===== ソートキーのビット配置（上位から） =====
+	static constexpr uint32_t kPassBits = 4;
+	static constexpr uint32_t kPipelineBits = 4;
+	static constexpr uint32_t kTextureBits = 16;
+	static constexpr uint32_t kMeshBits = 16;
+	static constexpr uint32_t kDepthBits = 24;
+
+	/// <summary>
+	/// ソートキーを作る（各値はビット数に収まらない分が切り捨てられる）
+	/// </summary>
+	/// <param name="pass">描画パス</param>
+	/// <param name="pipeline">パイプラインの番号</param>
+	/// <param name="texture">テクスチャの番号</param>
+	/// <param name="mesh">メッシュの番号</param>
+	/// <param name="depth">深度（QuantizeDepthの結果や描画順）。小さいほど先に描かれる</param>
+	static uint64_t MakeSortKey(RenderPass pass, uint32_t pipeline, uint32_t texture, uint32_t mesh, uint32_t depth);
+
+	// 0～1の深度をソートキー用の整数にする（範囲外は丸める）
+	static uint32_t QuantizeDepth(float depth01);
+
+	// ソートキーからパスを取り出す
+	static RenderPass GetPass(uint64_t sortKey) { return static_cast<RenderPass>(sortKey >> (64 - kPassBits)); }
+
+	// パスの共通設定を登録する
+	void SetPassSetup(RenderPass pass, PassSetup passSetup);
+
+	// パケットを積む
+	void Submit(uint64_t sortKey, DrawFunction draw, const void *object);
+
+	// 積んだパケットをソートキーの順に並べる（同じキーは積んだ順）
+	void Sort();
+
+	// ソートして描き、キューを空にする
+	void Execute();
+
+	// 積んだパケットを破棄する
+	void Clear();
+
+	// ===== getter =====
+	size_t GetPacketCount() const { return packets.size(); }
+	// Sortの結果の順にi番目のパケット
+	const DrawPacket &GetSortedPacket(size_t i) const { return packets[sortEntries[i].index]; }
+	const Statistics &GetStatistics() const { return statistics; }
+
+private:
+
+	// ソートするのはキーとパケットの番号だけにする（パケットそのものは動かさない）
+	struct SortEntry
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	std::vector<DrawPacket> packets;
+	std::vector<SortEntry> sortEntries;
+	std::vector<SortEntry> sortScratch;
+
+	std::array<PassSetup, static_cast<size_t>(RenderPass::kCount)> passSetups;
+	RenderStateCache stateCache;
+	Statistics statistics;
+};
\ No newline at end of file
@@ -0,0 +1,74 @@
+#include "RingAllocator.h"
+#include <cassert>
+
+void RingAllocator::Reset(size_t capacity)
+{
+	this->capacity = capacity;
+	head = 0;
+	tail = 0;
+	usedSize = 0;
+	currentFrameSize = 0;
+	frames.clear();
+}
+
+size_t RingAllocator::Allocate(size_t size, size_t alignment)
+{
+	assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+	if (size == 0 || size > capacity) {
+		return kInvalidOffset;
+	}
+
+	// 空なら先頭からやり直す（折り返しで飛ばす領域を減らす）
+	if (usedSize == 0) {
+		head = 0;
+		tail = 0;
+	}
+
+	size_t offset = (head + alignment - 1) & ~(alignment - 1);
+	size_t consumed = 0;
+	if (usedSize == 0 || head > tail) {
+		// 空き領域は [head, capacity) と [0, tail)
+		if (offset + size <= capacity) {
+			consumed = offset + size - head;
+		} else if (size <= tail) {
+			// 末尾の残りは飛ばして先頭に戻る
+			consumed = capacity - head + size;
+			offset = 0;
+		} else {
+			return kInvalidOffset;
+		}
+	} else if (head < tail) {
+		// 空き領域は [head, tail)
+		if (offset + size <= tail) {
+			consumed = offset + size - head;
+		} else {
+			return kInvalidOffset;
+		}
+	} else {
+		// head == tail で使用中なら満杯
+		return kInvalidOffset;
+	}
+
+	head = offset + size;
+	usedSize += consumed;
+	currentFrameSize += consumed;
+	return offset;
+}
+
+void RingAllocator::FinishFrame(uint64_t fenceValue)
+{
+	if (currentFrameSize == 0) {
+		return;
+	}
+	frames.push_back({ fenceValue, head, currentFrameSize });
+	currentFrameSize = 0;
+}
+
+void RingAllocator::Retire(uint64_t completedFenceValue)
+{
+	while (!frames.empty() && frames.front().fenceValue <= completedFenceValue) {
+		tail = frames.front().end;
+		usedSize -= frames.front().size;
+		frames.pop_front();
+	}
+}
\ No newline at end of file
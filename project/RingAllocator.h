@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+// リングアロケータ（オフセットの管理のみ。GPUメモリには触らない）
+// フレームごとの割り当てをフェンス値で区切り、GPUがそのフェンス値に到達したら領域を返す
+// 先頭から詰めて割り当て、末尾に収まらなければ先頭に戻る
+class RingAllocator
+{
+public:
+
+	// 割り当てに失敗したときのオフセット
+	static constexpr size_t kInvalidOffset = SIZE_MAX;
+
+	RingAllocator() = default;
+	explicit RingAllocator(size_t capacity) { Reset(capacity); }
+
+	// 容量を設定し、すべての割り当てを破棄する
+	void Reset(size_t capacity);
+
+	/// <summary>
+	/// 領域を割り当てる
+	/// </summary>
+	/// <param name="size">サイズ（byte）</param>
+	/// <param name="alignment">アライメント（2の累乗）</param>
+	/// <returns>オフセット。空きがなければkInvalidOffset</returns>
+	size_t Allocate(size_t size, size_t alignment);
+
+	/// <summary>
+	/// 現在のフレームの割り当てを締める（コマンドを投げてSignalした後に呼ぶ）
+	/// </summary>
+	/// <param name="fenceValue">このフレームのコマンドの完了を表すフェンス値</param>
+	void FinishFrame(uint64_t fenceValue);
+
+	/// <summary>
+	/// GPUが使い終わったフレームの領域を解放する
+	/// </summary>
+	/// <param name="completedFenceValue">GPUが到達したフェンス値</param>
+	void Retire(uint64_t completedFenceValue);
+
+	// 容量
+	size_t GetCapacity() const { return capacity; }
+	// 使用中のサイズ（アライメントや折り返しで飛ばした分を含む）
+	size_t GetUsedSize() const { return usedSize; }
+	// 締めたがまだ解放されていないフレーム数
+	size_t GetPendingFrameCount() const { return frames.size(); }
+
+private:
+
+	// 締めたフレーム
+	struct Frame
+	{
+		uint64_t fenceValue; // 完了を表すフェンス値
+		size_t end; // このフレームの最後の割り当ての終わり
+		size_t size; // このフレームで使ったサイズ
+	};
+
+	size_t capacity = 0;
+	size_t head = 0; // 次に割り当てる位置
+	size_t tail = 0; // 使用中の領域の先頭
+	size_t usedSize = 0;
+	size_t currentFrameSize = 0; // まだ締めていないフレームで使ったサイズ
+	std::deque<Frame> frames;
+};
\ No newline at end of file
@@ -0,0 +1,566 @@
+#include "SceneBVH.h"
+#include <algorithm>
+#include <cassert>
+#include <cfloat>
+
+using namespace math;
+
+namespace {
+
+	// SAHで分け方を探すときのビンの数
+	constexpr int kBinCount = 16;
+
+	inline float GetAxis(const Vector3 &v, int axis) { return (&v.x)[axis]; }
+}
+
+SceneBVH::ProxyId SceneBVH::CreateProxy(const AABB &aabb, void *userData)
+{
+	NodeIndex leaf = AllocateNode();
+	nodes[leaf].aabb = aabb;
+	nodes[leaf].userData = userData;
+	InsertLeaf(leaf);
+	++proxyCount;
+	return leaf;
+}
+
+void SceneBVH::DestroyProxy(ProxyId proxy)
+{
+	assert(proxy >= 0 && size_t(proxy) < nodes.size() && nodes[proxy].IsLeaf());
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--proxyCount;
+}
+
+void SceneBVH::MoveProxy(ProxyId proxy, const AABB &aabb)
+{
+	assert(proxy >= 0 && size_t(proxy) < nodes.size() && nodes[proxy].IsLeaf());
+	nodes[proxy].aabb = aabb;
+
+	// 祖先に印を付ける（既に付いていればその先も付いている）
+	for (NodeIndex index = nodes[proxy].parent; index != kNullNode && !nodes[index].dirty; index = nodes[index].parent) {
+		nodes[index].dirty = true;
+	}
+}
+
+void SceneBVH::Update()
+{
+	Refit();
+
+	// リフィットだけだと箱が大きく重なっていくので、一定間隔で質を確かめて作り直す
+	if (++updatesSinceCheck < rebuildCheckInterval) {
+		return;
+	}
+	updatesSinceCheck = 0;
+	if (proxyCount <= 2) {
+		return;
+	}
+	if (rebuiltCost <= 0.0f || ComputeCost() > rebuiltCost * rebuildThreshold) {
+		Rebuild();
+	}
+}
+
+void SceneBVH::Refit()
+{
+	if (root == kNullNode || !nodes[root].dirty) {
+		return;
+	}
+
+	// 印の付いたノードだけを帰りがけ順でたどる（子を付け直してから親）
+	std::vector<std::pair<NodeIndex, bool>> stack;
+	stack.push_back({ root, false });
+	while (!stack.empty()) {
+		auto [index, childrenDone] = stack.back();
+		stack.pop_back();
+
+		Node &node = nodes[index];
+		if (childrenDone) {
+			node.aabb = Union(nodes[node.children[0]].aabb, nodes[node.children[1]].aabb);
+			node.dirty = false;
+			continue;
+		}
+
+		stack.push_back({ index, true });
+		for (NodeIndex child : node.children) {
+			if (nodes[child].dirty) {
+				stack.push_back({ child, false });
+			}
+		}
+	}
+}
+
+void SceneBVH::Rebuild()
+{
+	// 葉を集め、内部ノードはすべて捨てる
+	buildItems.clear();
+	buildItems.reserve(proxyCount);
+	if (root != kNullNode) {
+		std::vector<NodeIndex> stack;
+		stack.push_back(root);
+		while (!stack.empty()) {
+			NodeIndex index = stack.back();
+			stack.pop_back();
+
+			if (nodes[index].IsLeaf()) {
+				const AABB &aabb = nodes[index].aabb;
+				buildItems.push_back({ aabb, GetCenter(aabb), index });
+				continue;
+			}
+			stack.push_back(nodes[index].children[0]);
+			stack.push_back(nodes[index].children[1]);
+			FreeNode(index);
+		}
+	}
+
+	root = buildItems.empty() ? kNullNode : BuildRange(0, buildItems.size());
+
+	rebuiltCost = ComputeCost();
+	updatesSinceCheck = 0;
+	++rebuildCount;
+}
+
+void SceneBVH::Clear()
+{
+	nodes.clear();
+	freeNodes.clear();
+	root = kNullNode;
+	proxyCount = 0;
+	updatesSinceCheck = 0;
+	rebuiltCost = 0.0f;
+}
+
+void SceneBVH::QueryFrustum(const Frustum &frustum, std::vector<ProxyId> &results) const
+{
+	results.clear();
+	if (root == kNullNode) {
+		return;
+	}
+
+	// 親の箱が完全に表側だった平面は子で調べない（全平面で表側なら部分木をまるごと入れる）
+	constexpr uint32_t kAllPlanes = (1u << 6) - 1;
+	std::vector<std::pair<NodeIndex, uint32_t>> stack;
+	stack.push_back({ root, kAllPlanes });
+	while (!stack.empty()) {
+		auto [index, planeMask] = stack.back();
+		stack.pop_back();
+
+		const Node &node = nodes[index];
+		bool outside = false;
+		for (uint32_t p = 0; p < 6 && !outside; ++p) {
+			if (!(planeMask & (1u << p))) {
+				continue;
+			}
+			const Plane &plane = frustum.planes[p];
+			const Vector3 &normal = plane.normal;
+
+			// 法線方向に最も進んだ頂点が裏側なら外
+			float farDistance = normal.x * (normal.x >= 0.0f ? node.aabb.max.x : node.aabb.min.x) +
+				normal.y * (normal.y >= 0.0f ? node.aabb.max.y : node.aabb.min.y) +
+				normal.z * (normal.z >= 0.0f ? node.aabb.max.z : node.aabb.min.z) + plane.distance;
+			if (farDistance < 0.0f) {
+				outside = true;
+				break;
+			}
+			// 最も遅れた頂点も表側なら、この平面は子で調べなくてよい
+			float nearDistance = normal.x * (normal.x >= 0.0f ? node.aabb.min.x : node.aabb.max.x) +
+				normal.y * (normal.y >= 0.0f ? node.aabb.min.y : node.aabb.max.y) +
+				normal.z * (normal.z >= 0.0f ? node.aabb.min.z : node.aabb.max.z) + plane.distance;
+			if (nearDistance >= 0.0f) {
+				planeMask &= ~(1u << p);
+			}
+		}
+		if (outside) {
+			continue;
+		}
+
+		if (planeMask == 0) {
+			CollectLeaves(index, results);
+		} else if (node.IsLeaf()) {
+			results.push_back(index);
+		} else {
+			stack.push_back({ node.children[0], planeMask });
+			stack.push_back({ node.children[1], planeMask });
+		}
+	}
+}
+
+void SceneBVH::QueryOverlap(const AABB &aabb, std::vector<ProxyId> &results) const
+{
+	results.clear();
+	if (root == kNullNode) {
+		return;
+	}
+
+	std::vector<NodeIndex> stack;
+	stack.push_back(root);
+	while (!stack.empty()) {
+		NodeIndex index = stack.back();
+		stack.pop_back();
+
+		const Node &node = nodes[index];
+		if (!Overlaps(node.aabb, aabb)) {
+			continue;
+		}
+		if (node.IsLeaf()) {
+			results.push_back(index);
+		} else {
+			stack.push_back(node.children[0]);
+			stack.push_back(node.children[1]);
+		}
+	}
+}
+
+bool SceneBVH::RayCast(const Ray &ray, float maxDistance, RayHit &hit, const RayTest &rayTest) const
+{
+	if (root == kNullNode) {
+		return false;
+	}
+
+	Vector3 inverseDirection = MakeInverseDirection(ray.direction);
+	float rootDistance = 0.0f;
+	if (!IntersectRay(ray, inverseDirection, nodes[root].aabb, maxDistance, rootDistance)) {
+		return false;
+	}
+
+	// 箱に入る距離と一緒に積み、見つかった当たりより遠い箱は開かない
+	float closest = maxDistance;
+	bool found = false;
+	std::vector<std::pair<NodeIndex, float>> stack;
+	stack.push_back({ root, rootDistance });
+	while (!stack.empty()) {
+		auto [index, enterDistance] = stack.back();
+		stack.pop_back();
+		if (enterDistance > closest) {
+			continue;
+		}
+
+		const Node &node = nodes[index];
+		if (node.IsLeaf()) {
+			float distance = enterDistance;
+			if (rayTest && !rayTest(index, ray, closest, distance)) {
+				continue;
+			}
+			if (distance <= closest) {
+				closest = distance;
+				hit = { index, distance };
+				found = true;
+			}
+			continue;
+		}
+
+		// 近い方の子を後に積んで先に調べる
+		float distances[2] = { FLT_MAX, FLT_MAX };
+		bool hits[2] = {
+			IntersectRay(ray, inverseDirection, nodes[node.children[0]].aabb, closest, distances[0]),
+			IntersectRay(ray, inverseDirection, nodes[node.children[1]].aabb, closest, distances[1]),
+		};
+		int nearChild = distances[0] <= distances[1] ? 0 : 1;
+		int farChild = 1 - nearChild;
+		if (hits[farChild]) {
+			stack.push_back({ node.children[farChild], distances[farChild] });
+		}
+		if (hits[nearChild]) {
+			stack.push_back({ node.children[nearChild], distances[nearChild] });
+		}
+	}
+	return found;
+}
+
+float SceneBVH::ComputeCost() const
+{
+	if (root == kNullNode || nodes[root].IsLeaf()) {
+		return 0.0f;
+	}
+
+	float rootArea = GetSurfaceArea(nodes[root].aabb);
+	if (rootArea <= 0.0f) {
+		return 0.0f;
+	}
+
+	float area = 0.0f;
+	std::vector<NodeIndex> stack;
+	stack.push_back(root);
+	while (!stack.empty()) {
+		NodeIndex index = stack.back();
+		stack.pop_back();
+
+		const Node &node = nodes[index];
+		if (node.IsLeaf()) {
+			continue;
+		}
+		area += GetSurfaceArea(node.aabb);
+		stack.push_back(node.children[0]);
+		stack.push_back(node.children[1]);
+	}
+	return area / rootArea;
+}
+
+uint32_t SceneBVH::ComputeHeight() const
+{
+	if (root == kNullNode) {
+		return 0;
+	}
+
+	uint32_t height = 0;
+	std::vector<std::pair<NodeIndex, uint32_t>> stack;
+	stack.push_back({ root, 1 });
+	while (!stack.empty()) {
+		auto [index, depth] = stack.back();
+		stack.pop_back();
+
+		height = std::max(height, depth);
+		if (!nodes[index].IsLeaf()) {
+			stack.push_back({ nodes[index].children[0], depth + 1 });
+			stack.push_back({ nodes[index].children[1], depth + 1 });
+		}
+	}
+	return height;
+}
+
+SceneBVH::NodeIndex SceneBVH::AllocateNode()
+{
+	if (!freeNodes.empty()) {
+		NodeIndex index = freeNodes.back();
+		freeNodes.pop_back();
+		return index;
+	}
+	nodes.emplace_back();
+	return NodeIndex(nodes.size() - 1);
+}
+
+void SceneBVH::FreeNode(NodeIndex index)
+{
+	nodes[index] = Node {};
+	freeNodes.push_back(index);
+}
+
+void SceneBVH::InsertLeaf(NodeIndex leaf)
+{
+	if (root == kNullNode) {
+		root = leaf;
+		nodes[leaf].parent = kNullNode;
+		return;
+	}
+
+	// 兄弟にするノードを探す（ここに入れるコストと、子へ下りたときのコストを比べる）
+	const AABB leafAABB = nodes[leaf].aabb;
+	NodeIndex index = root;
+	while (!nodes[index].IsLeaf()) {
+		const Node &node = nodes[index];
+		float area = GetSurfaceArea(node.aabb);
+		float combinedArea = GetSurfaceArea(Union(node.aabb, leafAABB));
+
+		// ここに新しい親を作るコストと、下りた場合に祖先が広がる分
+		float cost = 2.0f * combinedArea;
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		float childCosts[2];
+		for (int i = 0; i < 2; ++i) {
+			const Node &child = nodes[node.children[i]];
+			float unionArea = GetSurfaceArea(Union(child.aabb, leafAABB));
+			childCosts[i] = (child.IsLeaf() ? unionArea : unionArea - GetSurfaceArea(child.aabb)) + inheritanceCost;
+		}
+
+		if (cost < childCosts[0] && cost < childCosts[1]) {
+			break;
+		}
+		index = childCosts[0] <= childCosts[1] ? node.children[0] : node.children[1];
+	}
+
+	// 兄弟と新しい葉をまとめる親を作る
+	NodeIndex sibling = index;
+	NodeIndex oldParent = nodes[sibling].parent;
+	NodeIndex newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].aabb = Union(leafAABB, nodes[sibling].aabb);
+	nodes[newParent].children[0] = sibling;
+	nodes[newParent].children[1] = leaf;
+	nodes[newParent].dirty = nodes[sibling].dirty;
+
+	if (oldParent == kNullNode) {
+		root = newParent;
+	} else {
+		Node &parent = nodes[oldParent];
+		parent.children[parent.children[0] == sibling ? 0 : 1] = newParent;
+	}
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	RefitAncestors(oldParent);
+}
+
+void SceneBVH::RemoveLeaf(NodeIndex leaf)
+{
+	if (leaf == root) {
+		root = kNullNode;
+		return;
+	}
+
+	NodeIndex parent = nodes[leaf].parent;
+	NodeIndex grandParent = nodes[parent].parent;
+	NodeIndex sibling = nodes[parent].children[0] == leaf ? nodes[parent].children[1] : nodes[parent].children[0];
+
+	if (grandParent == kNullNode) {
+		root = sibling;
+		nodes[sibling].parent = kNullNode;
+	} else {
+		Node &grand = nodes[grandParent];
+		grand.children[grand.children[0] == parent ? 0 : 1] = sibling;
+		nodes[sibling].parent = grandParent;
+	}
+	FreeNode(parent);
+	nodes[leaf].parent = kNullNode;
+
+	RefitAncestors(grandParent);
+}
+
+void SceneBVH::RefitAncestors(NodeIndex index)
+{
+	for (; index != kNullNode; index = nodes[index].parent) {
+		Node &node = nodes[index];
+		node.aabb = Union(nodes[node.children[0]].aabb, nodes[node.children[1]].aabb);
+	}
+}
+
+SceneBVH::NodeIndex SceneBVH::BuildRange(size_t begin, size_t end)
+{
+	// 偏った分かれ方でも深い再帰にならないよう、作業を積んで処理する
+	struct Task
+	{
+		size_t begin;
+		size_t end;
+		NodeIndex parent;
+		int childSlot;
+	};
+
+	NodeIndex result = kNullNode;
+	std::vector<Task> tasks;
+	tasks.push_back({ begin, end, kNullNode, 0 });
+	while (!tasks.empty()) {
+		Task task = tasks.back();
+		tasks.pop_back();
+
+		NodeIndex index = kNullNode;
+		if (task.end - task.begin == 1) {
+			index = buildItems[task.begin].node;
+		} else {
+			// 範囲の箱と、中心の範囲
+			AABB bounds = MakeEmptyAABB();
+			AABB centroidBounds = MakeEmptyAABB();
+			for (size_t i = task.begin; i < task.end; ++i) {
+				bounds = Union(bounds, buildItems[i].aabb);
+				Expand(centroidBounds, buildItems[i].centroid);
+			}
+
+			// 3軸それぞれ中心をビンに分ける（葉を1回たどるだけで3軸分まとめて入れる）
+			// 葉が少ない範囲はビンも減らす（ビンの準備と集計が葉の数より重くならないように）
+			const int binCount = int(std::min<size_t>(kBinCount, task.end - task.begin));
+			struct Bin
+			{
+				AABB aabb;
+				size_t count;
+			};
+			Bin bins[3][kBinCount];
+			float minimums[3];
+			float scales[3];
+			for (int axis = 0; axis < 3; ++axis) {
+				minimums[axis] = GetAxis(centroidBounds.min, axis);
+				float extent = GetAxis(centroidBounds.max, axis) - minimums[axis];
+				scales[axis] = extent > 0.0f ? binCount / extent : 0.0f;
+				for (int bin = 0; bin < binCount; ++bin) {
+					bins[axis][bin] = { MakeEmptyAABB(), 0 };
+				}
+			}
+			for (size_t i = task.begin; i < task.end; ++i) {
+				const BuildItem &item = buildItems[i];
+				for (int axis = 0; axis < 3; ++axis) {
+					int bin = std::min(int((GetAxis(item.centroid, axis) - minimums[axis]) * scales[axis]), binCount - 1);
+					bins[axis][bin].aabb = Union(bins[axis][bin].aabb, item.aabb);
+					++bins[axis][bin].count;
+				}
+			}
+
+			// 左右の 数×表面積 の和が最小の分け目を探す
+			float bestCost = FLT_MAX;
+			int bestAxis = -1;
+			int bestSplit = 0;
+			for (int axis = 0; axis < 3; ++axis) {
+				if (scales[axis] <= 0.0f) {
+					continue;
+				}
+
+				// 右側（bin番目から後ろ）の表面積と数
+				float rightAreas[kBinCount] = {};
+				size_t rightCounts[kBinCount] = {};
+				AABB right = MakeEmptyAABB();
+				size_t rightCount = 0;
+				for (int bin = binCount - 1; bin > 0; --bin) {
+					right = Union(right, bins[axis][bin].aabb);
+					rightCount += bins[axis][bin].count;
+					rightAreas[bin] = rightCount ? GetSurfaceArea(right) : 0.0f;
+					rightCounts[bin] = rightCount;
+				}
+
+				AABB left = MakeEmptyAABB();
+				size_t leftCount = 0;
+				for (int bin = 0; bin < binCount - 1; ++bin) {
+					left = Union(left, bins[axis][bin].aabb);
+					leftCount += bins[axis][bin].count;
+					if (leftCount == 0 || rightCounts[bin + 1] == 0) {
+						continue;
+					}
+					float cost = float(leftCount) * GetSurfaceArea(left) + float(rightCounts[bin + 1]) * rightAreas[bin + 1];
+					if (cost < bestCost) {
+						bestCost = cost;
+						bestAxis = axis;
+						bestSplit = bin;
+					}
+				}
+			}
+
+			size_t middle = task.begin;
+			if (bestAxis >= 0) {
+				float minimum = minimums[bestAxis];
+				float scale = scales[bestAxis];
+				auto it = std::partition(buildItems.begin() + task.begin, buildItems.begin() + task.end, [&](const BuildItem &item) {
+					return std::min(int((GetAxis(item.centroid, bestAxis) - minimum) * scale), binCount - 1) <= bestSplit;
+					});
+				middle = size_t(it - buildItems.begin());
+			}
+			if (middle == task.begin || middle == task.end) {
+				// 中心がすべて同じ位置など、分けられないときは半分ずつにする
+				middle = task.begin + (task.end - task.begin) / 2;
+			}
+
+			index = AllocateNode();
+			nodes[index].aabb = bounds;
+			tasks.push_back({ middle, task.end, index, 1 });
+			tasks.push_back({ task.begin, middle, index, 0 });
+		}
+
+		nodes[index].parent = task.parent;
+		if (task.parent == kNullNode) {
+			result = index;
+		} else {
+			nodes[task.parent].children[task.childSlot] = index;
+		}
+	}
+	return result;
+}
+
+void SceneBVH::CollectLeaves(NodeIndex index, std::vector<ProxyId> &results) const
+{
+	std::vector<NodeIndex> stack;
+	stack.push_back(index);
+	while (!stack.empty()) {
+		NodeIndex current = stack.back();
+		stack.pop_back();
+
+		const Node &node = nodes[current];
+		if (node.IsLeaf()) {
+			results.push_back(current);
+		} else {
+			stack.push_back(node.children[0]);
+			stack.push_back(node.children[1]);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "BoundingVolume.h"
+
+// シーンのオブジェクトのワールド座標のAABBに張る動的なBVH（境界ボリューム階層）
+// 葉1つにオブジェクト1つを持つ。動いたオブジェクトは葉の箱を書き換えて親に印を付け、Updateで印の付いた親だけ箱を付け直す（リフィット）
+// 付け直しを続けて木の質（SAHコスト）が一定以上落ちたら、SAHで木を作り直す
+// 視錐台・レイ・AABBとの重なりの問い合わせを、全オブジェクトを調べずに行う
+class SceneBVH
+{
+public:
+
+	// 登録したオブジェクトの番号（作り直しても変わらない）
+	using ProxyId = int32_t;
+	static constexpr ProxyId kNullProxy = -1;
+
+	// レイの当たり
+	struct RayHit
+	{
+		ProxyId proxy = kNullProxy;
+		float distance = 0.0f; // directionの長さ単位
+	};
+
+	// 葉でのレイの詳しい判定（当たったらdistanceに距離を入れてtrueを返す）
+	// 指定しなければ葉のAABBに当たったところを当たりにする
+	using RayTest = std::function<bool(ProxyId proxy, const math::Ray &ray, float maxDistance, float &distance)>;
+
+	/// <summary>
+	/// オブジェクトを登録する
+	/// </summary>
+	/// <param name="aabb">ワールド座標のAABB</param>
+	/// <param name="userData">問い合わせの結果から引けるデータ</param>
+	/// <returns>登録番号</returns>
+	ProxyId CreateProxy(const math::AABB &aabb, void *userData);
+
+	// 登録を外す
+	void DestroyProxy(ProxyId proxy);
+
+	// オブジェクトのAABBを変える（親の箱はUpdateかRefitで付け直す）
+	void MoveProxy(ProxyId proxy, const math::AABB &aabb);
+
+	// フレームに1回、問い合わせの前に呼ぶ（付け直しと、一定間隔での木の質の確認・作り直し）
+	void Update();
+
+	// 箱が変わった葉の祖先だけ箱を付け直す
+	void Refit();
+
+	// 全部の葉からSAHで木を作り直す
+	void Rebuild();
+
+	// 全部の登録を外す
+	void Clear();
+
+	// ===== 問い合わせ（resultsは空にしてから書き込む） =====
+
+	// 視錐台に少しでも入っているオブジェクト
+	void QueryFrustum(const math::Frustum &frustum, std::vector<ProxyId> &results) const;
+
+	// AABBと重なっているオブジェクト
+	void QueryOverlap(const math::AABB &aabb, std::vector<ProxyId> &results) const;
+
+	/// <summary>
+	/// レイに最も近くで当たるオブジェクトを探す（近い箱から調べ、見つかった当たりより遠い箱は調べない）
+	/// </summary>
+	/// <param name="ray">レイ</param>
+	/// <param name="maxDistance">調べるレイの長さ</param>
+	/// <param name="hit">最も近い当たり</param>
+	/// <param name="rayTest">葉での詳しい判定（nullptrなら葉のAABB）</param>
+	/// <returns>当たったらtrue</returns>
+	bool RayCast(const math::Ray &ray, float maxDistance, RayHit &hit, const RayTest &rayTest = nullptr) const;
+
+	// ===== 木の質 =====
+
+	// 内部ノードの表面積の合計を根の表面積で割ったもの（小さいほど問い合わせが速い）
+	float ComputeCost() const;
+
+	// Updateで木の質を確認する間隔（Updateの回数）
+	void SetRebuildCheckInterval(uint32_t interval) { rebuildCheckInterval = interval; }
+	// 作り直した直後のコストの何倍になったら作り直すか
+	void SetRebuildThreshold(float threshold) { rebuildThreshold = threshold; }
+
+	// ===== getter =====
+	void *GetUserData(ProxyId proxy) const { return nodes[proxy].userData; }
+	const math::AABB &GetAABB(ProxyId proxy) const { return nodes[proxy].aabb; }
+	size_t GetProxyCount() const { return proxyCount; }
+	uint32_t GetRebuildCount() const { return rebuildCount; }
+	// 根から最も深い葉までの段数
+	uint32_t ComputeHeight() const;
+
+private:
+
+	using NodeIndex = int32_t;
+	static constexpr NodeIndex kNullNode = -1;
+
+	// ノード（葉の番号がそのままProxyIdになる）
+	struct Node
+	{
+		math::AABB aabb;
+		NodeIndex parent = kNullNode;
+		NodeIndex children[2] = { kNullNode, kNullNode };
+		void *userData = nullptr;
+		// 子孫の箱が変わったので付け直しが必要（印が付いていれば祖先にも必ず付いている）
+		bool dirty = false;
+
+		bool IsLeaf() const { return children[0] == kNullNode; }
+	};
+
+	// 作り直しで並べ替える葉
+	struct BuildItem
+	{
+		math::AABB aabb;
+		math::Vector3 centroid;
+		NodeIndex node;
+	};
+
+	NodeIndex AllocateNode();
+	void FreeNode(NodeIndex index);
+
+	// 葉を木に入れる（表面積の増え方が最も小さい場所に兄弟として入れる）
+	void InsertLeaf(NodeIndex leaf);
+	// 葉を木から外す（兄弟を親の位置に上げる）
+	void RemoveLeaf(NodeIndex leaf);
+	// indexから根まで子の箱から付け直す
+	void RefitAncestors(NodeIndex index);
+
+	// items[begin, end)の部分木を作り、その根を返す
+	NodeIndex BuildRange(size_t begin, size_t end);
+
+	// 部分木の葉をすべてresultsに入れる
+	void CollectLeaves(NodeIndex index, std::vector<ProxyId> &results) const;
+
+	std::vector<Node> nodes;
+	std::vector<NodeIndex> freeNodes;
+	NodeIndex root = kNullNode;
+	size_t proxyCount = 0;
+
+	// 作り直し用の作業領域
+	std::vector<BuildItem> buildItems;
+
+	// 木の質の確認
+	uint32_t rebuildCheckInterval = 30;
+	float rebuildThreshold = 1.5f;
+	uint32_t updatesSinceCheck = 0;
+	float rebuiltCost = 0.0f;
+	uint32_t rebuildCount = 0;
+};
\ No newline at end of file
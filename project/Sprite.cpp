@@ -2,6 +2,9 @@
 #include "SpriteCommon.h"
 #include "DirectXCommon.h"
 #include "TextureManager.h"
+#include "TextureAtlas.h"
+#include "RenderQueue.h"
+#include <cassert>
 
 using namespace math;
 
@@ -10,112 +13,110 @@ void Sprite::Initialize(SpriteCommon *spriteCommon, std::string textureFilePath)
 	// 引数で受け取ってメンバ変数に記録する
 	this->spriteCommon_ = spriteCommon;
 
-	TextureManager::GetInstance()->LoadTexture(textureFilePath);
+	// 読み込んだテクスチャのハンドルを保存
+	SetTextureHandle(TextureManager::GetInstance()->LoadTexture(textureFilePath));
 
 	InitializeBuffers();
 	InitializeMaterial();
-	InitializeTransformationMatrixResource();
-
-	// 単位行列を書き込んでおく
-	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
+	InitializeTransformationMatrix();
 
 	AdjustTextureSize();
 }
 
 void Sprite::ChangeTexture(std::string textureFilePath)
 {
-	// 読み込んだテクスチャのインデックスを取得してメンバ変数に保存
-	textureIndex = TextureManager::GetInstance()->GetTextureIndexByFilePath(textureFilePath);
+	// 読み込んだテクスチャのハンドルを取得してメンバ変数に保存
+	AssetHandle handle = TextureManager::GetInstance()->GetTextureHandle(textureFilePath);
+	assert(handle.IsValid()); // 読み込んでいないテクスチャ
+	SetTextureHandle(handle);
+}
+
+void Sprite::ChangeTexture(const TextureAtlas &atlas, const std::string &regionName)
+{
+	// 名前から切り出し範囲を引く
+	const TextureAtlas::Region *region = atlas.FindRegion(regionName);
+	assert(region); // アトラスにない名前
+
+	SetTextureHandle(region->texture);
+	geometry.SetTextureLeftTop(region->leftTop);
+	geometry.SetTextureSize(region->size);
+}
+
+void Sprite::SetTextureHandle(AssetHandle handle)
+{
+	textureHandle = handle;
+	const DirectX::TexMetadata &metadata = TextureManager::GetInstance()->GetMetaData(textureHandle);
+	geometry.SetTextureDimensions({ float(metadata.width), float(metadata.height) });
 }
 
 void Sprite::Update()
 {
-	float left = 0.0f - anchorPoint.x;
-	float right = 1.0f - anchorPoint.x;
-	float top = 0.0f - anchorPoint.y;
-	float bottom = 1.0f - anchorPoint.y;
-
-	// 左右反転
-	if (isFlipX_) {
-		left = -left;
-		right = -right;
+	// 変わっていなければ前回の頂点と行列をそのまま使う
+	SpriteGeometry::UpdateResult result = geometry.Update(spriteCommon_->GetProjectionMatrix());
+	spriteCommon_->CountUpdate(result);
+
+	if (result.transformUpdated) {
+		transformationMatrixData.WVP = geometry.GetWVPMatrix();
+		transformationMatrixData.World = geometry.GetWorldMatrix();
 	}
-	// 上下反転
-	if (isFlipY_) {
-		top = -top;
-		bottom = -bottom;
+}
+
+void Sprite::Draw()
+{
+	// 描画キューがあればパケットを積む
+	// スプライトは重なり順が変わらないよう、積んだ順をキーにする
+	if (RenderQueue *renderQueue = spriteCommon_->GetRenderQueue()) {
+		uint64_t sortKey = RenderQueue::MakeSortKey(RenderPass::kSprite, 0, 0, 0, static_cast<uint32_t>(renderQueue->GetPacketCount()));
+		renderQueue->Submit(sortKey, [](const void *object, RenderStateCache &stateCache) {
+			static_cast<const Sprite *>(object)->Render(&stateCache);
+			}, this);
+		return;
 	}
 
-	const DirectX::TexMetadata &metadata =
-		TextureManager::GetInstance()->GetMetaData(textureIndex);
-	float tex_left = textureLeftTop.x / metadata.width;
-	float tex_right = (textureLeftTop.x + textureSize.x) / metadata.width;
-	float tex_top = textureLeftTop.y / metadata.height;
-	float tex_bottom = (textureLeftTop.y + textureSize.y) / metadata.height;
-
-	// 頂点リソースにデータを書き込む
-	// 左下
-	vertexData[0].position = { left,bottom,0.0f,1.0f };
-	vertexData[0].texcoord = { tex_left,tex_bottom };
-	vertexData[0].normal = { 0.0f,0.0f,-1.0f };
-	//左上
-	vertexData[1].position = { left,top,0.0f,1.0f };
-	vertexData[1].texcoord = { tex_left,tex_top };
-	vertexData[1].normal = { 0.0f,0.0f,-1.0f };
-	// 右下
-	vertexData[2].position = { right,bottom,0.0f,1.0f };
-	vertexData[2].texcoord = { tex_right,tex_bottom };
-	vertexData[2].normal = { 0.0f,0.0f,-1.0f };
-	// 右上
-	vertexData[3].position = { right,top,0.0f,1.0f };
-	vertexData[3].texcoord = { tex_right,tex_top };
-	vertexData[3].normal = { 0.0f,0.0f,-1.0f };
-
-	//size_.x += 0.1f;
-	//size_.y += 0.1f;
-	// 角度を変化させるテスト
-	//rotation_ += 0.01f;
-	// 座標を変更する
-	//position_ += Vector2 { 0.1f,0.1f };
-	//materialData->color.x += 0.01f;
-	//if (materialData->color.x > 1.0f) {
-	//	materialData->color.x -= 1.0f;
-	//}
-
-	transform.scale = { size_.x,size_.y,1.0f };
-	transform.rotate = { 0.0f,0.0f,rotation_ };
-	transform.translate = { position_.x,position_.y,0.0f };
-
-	Matrix4x4 worldMatrix = MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
-	Matrix4x4 viewMatrix = MakeIdentity4x4();
-	Matrix4x4 projectionMatrix = MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
-	transformationMatrixData->WVP = Multiply(worldMatrix, Multiply(viewMatrix, projectionMatrix));
-	transformationMatrixData->World = worldMatrix;
+	Render(nullptr);
 }
 
-void Sprite::Draw()
+void Sprite::Render(RenderStateCache *stateCache) const
 {
-	spriteCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &vertexBufferView); // VBVを設定
-	spriteCommon_->GetDxCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView); // IBVを設定
+	// 直前にSpriteBatchが描いていれば、Sprite用のPSOに戻す
+	spriteCommon_->SetPipeline(SpriteCommon::PipelineType::kSprite, stateCache);
+
+	// 頂点データはこのフレーム用の領域にコピーして、そこを頂点バッファにする
+	const size_t vertexDataSize = sizeof(VertexData) * 4;
+	DirectXCommon::UploadAllocation vertexAllocation = spriteCommon_->GetDxCommon()->AllocateUpload(vertexDataSize, alignof(VertexData));
+	if (!vertexAllocation.cpuAddress) {
+		return;
+	}
+	std::memcpy(vertexAllocation.cpuAddress, geometry.GetVertices(), vertexDataSize);
+	D3D12_VERTEX_BUFFER_VIEW frameVertexBufferView = vertexBufferView;
+	frameVertexBufferView.BufferLocation = vertexAllocation.gpuAddress;
+	spriteCommon_->GetDxCommon()->GetCommandList()->IASetVertexBuffers(0, 1, &frameVertexBufferView); // VBVを設定
+	if (!stateCache || stateCache->SetMesh(reinterpret_cast<uintptr_t>(indexResource.Get()))) {
+		spriteCommon_->GetDxCommon()->GetCommandList()->IASetIndexBuffer(&indexBufferView); // IBVを設定
+	}
 
-	spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(0, materialResource->GetGPUVirtualAddress());
+	// 定数バッファはこのフレーム用の領域にコピーして設定する
+	DirectXCommon *dxCommon = spriteCommon_->GetDxCommon();
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(0, dxCommon->UploadConstantBuffer(materialData));
 	// TransformationMatrixCBufferの場所を設定
-	spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootConstantBufferView(1, transformationMatrixResource->GetGPUVirtualAddress());
+	dxCommon->GetCommandList()->SetGraphicsRootConstantBufferView(1, dxCommon->UploadConstantBuffer(transformationMatrixData));
 
-	spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureIndex));
+	// 直前のスプライトと同じテクスチャならセット済み
+	if (!stateCache || stateCache->SetTexture(textureHandle.index)) {
+		spriteCommon_->GetDxCommon()->GetCommandList()->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(textureHandle));
+	}
 	//描画!(DrawCall/ドローコール)6個のインデックスを使用し1つのインスタンスを描画。その他は当面0で良い
 	spriteCommon_->GetDxCommon()->GetCommandList()->DrawIndexedInstanced(6, 1, 0, 0, 0);
 }
 
 void Sprite::InitializeBuffers()
 {
-	// 頂点・インデックス用リソースを作成
-	vertexResource = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(VertexData) * 4);
+	// インデックス用リソースを作成（頂点は描画時にアップロード用リングバッファへ置く）
 	indexResource = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(uint32_t) * 6);
 
 	// 頂点バッファビューの設定
-	// リソースの先頭のアドレスから使う
-	vertexBufferView.BufferLocation = vertexResource->GetGPUVirtualAddress();
+	// 場所は描画時に決まる
+	vertexBufferView.BufferLocation = 0;
 	// 使用するリソースのサイズは頂点6つ分のサイズ
 	vertexBufferView.SizeInBytes = sizeof(VertexData) * 4;
 	// 1頂点あたりのサイズ
@@ -129,24 +130,6 @@ void Sprite::InitializeBuffers()
 	// インデックスはuint32_tとする
 	indexBufferView.Format = DXGI_FORMAT_R32_UINT;
 
-	// 頂点データをマップして書き込み
-	vertexResource->Map(0, nullptr, reinterpret_cast<void **>(&vertexData));
-	vertexData[0].position = { 0.0f,360.0f,0.0f,1.0f };
-	vertexData[0].texcoord = { 0.0f,1.0f };
-	vertexData[0].normal = { 0.0f,0.0f,-1.0f };
-
-	vertexData[1].position = { 0.0f,0.0f,0.0f,1.0f };
-	vertexData[1].texcoord = { 0.0f,0.0f };
-	vertexData[1].normal = { 0.0f,0.0f,-1.0f };
-
-	vertexData[2].position = { 640.0f,360.0f,0.0f,1.0f };
-	vertexData[2].texcoord = { 1.0f,1.0f };
-	vertexData[2].normal = { 0.0f,0.0f,-1.0f };
-
-	vertexData[3].position = { 640.0f,0.0f,0.0f,1.0f };
-	vertexData[3].texcoord = { 1.0f,0.0f };
-	vertexData[3].normal = { 0.0f,0.0f,-1.0f };
-
 	// インデックスデータをマップして書き込み
 	indexResource->Map(0, nullptr, reinterpret_cast<void **>(&indexData));
 	indexData[0] = 0;
@@ -159,37 +142,23 @@ void Sprite::InitializeBuffers()
 
 void Sprite::InitializeMaterial()
 {
-	// マテリアルリソースを作成
-	materialResource = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(Material));
-
-	// バッファをCPUアクセス用にマップしてポインタ取得
-	materialResource->Map(0, nullptr, reinterpret_cast<void **>(&materialData));
-
 	// マテリアルデータの初期値を書き込む
-	materialData->color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
-	materialData->enableLighting = false;
-	materialData->uvTransform = MakeIdentity4x4();
+	materialData.color = Vector4(1.0f, 1.0f, 1.0f, 1.0f);
+	materialData.enableLighting = false;
+	materialData.uvTransform = MakeIdentity4x4();
 }
 
-void Sprite::InitializeTransformationMatrixResource()
+void Sprite::InitializeTransformationMatrix()
 {
-	// 座標変換行列リソースを作成
-	transformationMatrixResource = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(TransformationMatrix));
-
-	// 書き込むためのアドレスを取得
-	transformationMatrixResource->Map(0, nullptr, reinterpret_cast<void **>(&transformationMatrixData));
 	// 単位行列を書きこんでおく
-	transformationMatrixData->WVP = MakeIdentity4x4();
-	transformationMatrixData->World = MakeIdentity4x4();
+	transformationMatrixData.WVP = MakeIdentity4x4();
+	transformationMatrixData.World = MakeIdentity4x4();
 }
 
 void Sprite::AdjustTextureSize()
 {
-	// テクスチャメタデータを取得
-	const DirectX::TexMetadata &metadata = TextureManager::GetInstance()->GetMetaData(textureIndex);
-
-	textureSize.x = static_cast<float>(metadata.width);
-	textureSize.y = static_cast<float>(metadata.height);
+	// テクスチャの幅と高さはSetTextureHandleで取得済み
+	geometry.SetTextureSize(geometry.GetTextureDimensions());
 	// 画像サイズをテクスチャサイズに合わせる
-	size_ = textureSize;
+	geometry.SetSize(geometry.GetTextureDimensions());
 }
\ No newline at end of file
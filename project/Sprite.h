@@ -4,20 +4,19 @@
 #include <d3d12.h>
 #include <string>
 #include "MathFunctions.h"
+#include "AssetRegistry.h"
+#include "SpriteGeometry.h"
 
 class SpriteCommon;
+class RenderStateCache;
+class TextureAtlas;
 
 // スプライト
 class Sprite
 {
 public:
 	// 頂点データ
-	struct VertexData
-	{
-		math::Vector4 position;
-		math::Vector2 texcoord;
-		math::Vector3 normal;
-	};
+	using VertexData = SpriteGeometry::Vertex;
 
 	// マテリアルデータ
 	struct Material
@@ -41,92 +40,80 @@ public: // メンバ関数
 
 	// テクスチャ差し替え
 	void ChangeTexture(std::string textureFilePath);
+	// テクスチャアトラスの切り出し範囲に差し替え（ページのテクスチャと、切り出す左上・大きさをまとめて設定する）
+	void ChangeTexture(const TextureAtlas &atlas, const std::string &regionName);
 
-	// 更新
+	// 更新（前回から変わったものだけ作り直す。頂点はアンカーポイント・反転・切り出し範囲・テクスチャ、行列は位置・回転・大きさ）
 	void Update();
 
-	// 描画
+	// 描画（SpriteCommonに描画キューがあればパケットを積み、後でまとめて描かれる）
 	void Draw();
 
 	// getter
-	const math::Vector2 &GetPosition() { return position_; }
+	const math::Vector2 &GetPosition() { return geometry.GetPosition(); }
 	// setter
-	void SetPosition(const math::Vector2 &position) { this->position_ = position; }
+	void SetPosition(const math::Vector2 &position) { geometry.SetPosition(position); }
 
-	float GetRotation() const { return rotation_; }
-	void SetRotation(float rotation) { this->rotation_ = rotation; }
+	float GetRotation() const { return geometry.GetRotation(); }
+	void SetRotation(float rotation) { geometry.SetRotation(rotation); }
 
-	const math::Vector4 &GetColor() const { return materialData->color; }
-	void SetColor(const math::Vector4 &color) { materialData->color = color; }
+	const math::Vector4 &GetColor() const { return materialData.color; }
+	void SetColor(const math::Vector4 &color) { materialData.color = color; }
 
-	const math::Vector2 &GetSize() const { return size_; }
-	void SetSize(const math::Vector2 &size) { this->size_ = size; }
+	const math::Vector2 &GetSize() const { return geometry.GetSize(); }
+	void SetSize(const math::Vector2 &size) { geometry.SetSize(size); }
 
 	// getter
-	const math::Vector2 &GetAnchoPoint() const { return anchorPoint; }
+	const math::Vector2 &GetAnchoPoint() const { return geometry.GetAnchorPoint(); }
 	// setter
-	void SetAnchorPoint(const math::Vector2 &anchorPoint) { this->anchorPoint = anchorPoint; }
+	void SetAnchorPoint(const math::Vector2 &anchorPoint) { geometry.SetAnchorPoint(anchorPoint); }
 
-	void SetIsFlipX(bool isFlipX) { isFlipX_ = isFlipX; }
-	void SetIsFlipY(bool isFlipY) { isFlipY_ = isFlipY; }
+	void SetIsFlipX(bool isFlipX) { geometry.SetIsFlipX(isFlipX); }
+	void SetIsFlipY(bool isFlipY) { geometry.SetIsFlipY(isFlipY); }
 
-	bool GetIsFlipX() const { return isFlipX_; }
-	bool GetIsFlipY() const { return isFlipY_; }
+	bool GetIsFlipX() const { return geometry.GetIsFlipX(); }
+	bool GetIsFlipY() const { return geometry.GetIsFlipY(); }
 
-	void SetTextureLeftTop(math::Vector2 leftTop) { textureLeftTop = leftTop; }
-	void SetTextureSize(math::Vector2 size) { textureSize = size; }
+	void SetTextureLeftTop(math::Vector2 leftTop) { geometry.SetTextureLeftTop(leftTop); }
+	void SetTextureSize(math::Vector2 size) { geometry.SetTextureSize(size); }
 
-	math::Vector2 GetTextureLeftTop() const { return textureLeftTop; }
-	math::Vector2 GetTextureSize() const { return textureSize; }
+	math::Vector2 GetTextureLeftTop() const { return geometry.GetTextureLeftTop(); }
+	math::Vector2 GetTextureSize() const { return geometry.GetTextureSize(); }
 
 private:
 	SpriteCommon *spriteCommon_ = nullptr;
 
+	// コマンドを積む（stateCacheがあればセット済みのステートを省く）
+	void Render(RenderStateCache *stateCache) const;
+
 	// バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertexResource;
 	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
+	// 頂点データと行列（変わったときだけ作り直す。頂点は描画時にアップロード用リングバッファへコピーする）
+	SpriteGeometry geometry;
 	// バッファリソース内のデータを指すポインタ
-	VertexData *vertexData = nullptr;
 	uint32_t *indexData = nullptr;
 	// バッファリソースの使い道を補足するバッファビュー
 	D3D12_VERTEX_BUFFER_VIEW vertexBufferView;
 	D3D12_INDEX_BUFFER_VIEW indexBufferView;
 	void InitializeBuffers();
 
-	// バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> materialResource;
-	// バッファリソース内のデータを指すポインタ
-	Material *materialData = nullptr;
+	// マテリアルデータ（描画時にDirectXCommonのアップロード用リングバッファへコピーする）
+	Material materialData {};
 
 	void InitializeMaterial();
 
-	// バッファリソース
-	Microsoft::WRL::ComPtr<ID3D12Resource> transformationMatrixResource;
-	// バッファリソース内のデータを指すポインタ
-	TransformationMatrix *transformationMatrixData = nullptr;
-	void InitializeTransformationMatrixResource();
-
-	math::Transform transform;
+	// 座標変換行列データ（描画時にDirectXCommonのアップロード用リングバッファへコピーする）
+	TransformationMatrix transformationMatrixData {};
+	void InitializeTransformationMatrix();
 
 	D3D12_CPU_DESCRIPTOR_HANDLE textureSrvHandleCPU {};
 	D3D12_GPU_DESCRIPTOR_HANDLE textureSrvHandleGPU {};
 
-	math::Vector2 position_ = { 0.0f,0.0f };
-	float rotation_ = 0.0f;
-	math::Vector2 size_ = { 128.0f,128.0f };
-	// テクスチャ番号
-	uint32_t textureIndex = 0;
-	math::Vector2 anchorPoint = { 0.0f,0.0f };
-
-	// 左右フリップ
-	bool isFlipX_ = false;
-	// 上下フリップ
-	bool isFlipY_ = false;
-
-	// テクスチャ左上座標
-	math::Vector2 textureLeftTop = { 0.0f,0.0f };
-	// テクスチャ切り出しサイズ
-	math::Vector2 textureSize = { 512.0f,512.0f };
+	// テクスチャのハンドル
+	AssetHandle textureHandle;
+
+	// テクスチャを変えたときに幅と高さを取り直す
+	void SetTextureHandle(AssetHandle handle);
 
 	// テクスチャサイズをイメージに合わせる
 	void AdjustTextureSize();
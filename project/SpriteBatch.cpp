@@ -0,0 +1,116 @@
+#include "SpriteBatch.h"
+#include "SpriteCommon.h"
+#include "DirectXCommon.h"
+#include "TextureManager.h"
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace math;
+
+void SpriteBatch::Initialize(SpriteCommon *spriteCommon, SpriteCommon::PipelineType pipelineType)
+{
+	// 引数で受け取ってメンバ変数に記録する
+	spriteCommon_ = spriteCommon;
+	this->pipelineType = pipelineType;
+
+	// インデックスは四角形ごとに同じ並びなので、最初に1回だけ書き込む
+	const size_t indexCount = size_t(kMaxQuadsPerDraw) * 6;
+	indexResource = spriteCommon_->GetDxCommon()->CreateBufferResource(sizeof(uint16_t) * indexCount);
+	uint16_t *indexData = nullptr;
+	indexResource->Map(0, nullptr, reinterpret_cast<void **>(&indexData));
+	for (uint32_t quad = 0; quad < kMaxQuadsPerDraw; ++quad) {
+		for (uint32_t i = 0; i < 6; ++i) {
+			indexData[quad * 6 + i] = static_cast<uint16_t>(quad * 4 + SpriteBatcher::kQuadIndices[i]);
+		}
+	}
+	indexResource->Unmap(0, nullptr);
+
+	indexBufferView.BufferLocation = indexResource->GetGPUVirtualAddress();
+	indexBufferView.SizeInBytes = UINT(sizeof(uint16_t) * indexCount);
+	indexBufferView.Format = DXGI_FORMAT_R16_UINT;
+}
+
+void SpriteBatch::Draw(AssetHandle textureHandle, const SpriteBatcher::Quad &quad, int32_t layer)
+{
+	assert(textureHandle.IsValid());
+	const DirectX::TexMetadata &metadata = TextureManager::GetInstance()->GetMetaData(textureHandle);
+	batcher.Add(textureHandle.index, { float(metadata.width), float(metadata.height) }, layer, quad);
+}
+
+void SpriteBatch::Draw(const TextureAtlas::Region &region, const SpriteBatcher::Quad &quad, int32_t layer)
+{
+	SpriteBatcher::Quad regionQuad = quad;
+	regionQuad.textureLeftTop = region.leftTop;
+	regionQuad.textureSize = region.size;
+	Draw(region.texture, regionQuad, layer);
+}
+
+void SpriteBatch::Flush()
+{
+	// 描画キューがあればパケットを積む（積んだ順をキーにして、Spriteとの重なり順を保つ）
+	if (RenderQueue *renderQueue = spriteCommon_->GetRenderQueue()) {
+		if (submitted) {
+			return;
+		}
+		submitted = true;
+		uint64_t sortKey = RenderQueue::MakeSortKey(RenderPass::kSprite, 0, 0, 0, static_cast<uint32_t>(renderQueue->GetPacketCount()));
+		renderQueue->Submit(sortKey, [](const void *object, RenderStateCache &stateCache) {
+			const_cast<SpriteBatch *>(static_cast<const SpriteBatch *>(object))->Render(&stateCache);
+			}, this);
+		return;
+	}
+
+	Render(nullptr);
+}
+
+void SpriteBatch::Render(RenderStateCache *stateCache)
+{
+	submitted = false;
+	statistics = {};
+	const size_t quadCount = batcher.GetQuadCount();
+	if (quadCount == 0) {
+		return;
+	}
+	statistics.spriteCount = static_cast<uint32_t>(quadCount);
+
+	// 全スプライトの頂点をこのフレーム用の領域へ直接書き出す
+	DirectXCommon *dxCommon = spriteCommon_->GetDxCommon();
+	const size_t vertexBytes = sizeof(SpriteBatcher::Vertex) * 4 * quadCount;
+	DirectXCommon::UploadAllocation vertexAllocation = dxCommon->AllocateUpload(vertexBytes, sizeof(SpriteBatcher::Vertex));
+	if (!vertexAllocation.cpuAddress) {
+		// 書き込み先がなければこのフレームは描かない
+		batcher.Clear();
+		return;
+	}
+	batcher.Build(static_cast<SpriteBatcher::Vertex *>(vertexAllocation.cpuAddress));
+
+	ID3D12GraphicsCommandList *commandList = dxCommon->GetCommandList();
+	spriteCommon_->SetPipeline(pipelineType, stateCache);
+
+	D3D12_VERTEX_BUFFER_VIEW vertexBufferView {};
+	vertexBufferView.BufferLocation = vertexAllocation.gpuAddress;
+	vertexBufferView.SizeInBytes = UINT(vertexBytes);
+	vertexBufferView.StrideInBytes = sizeof(SpriteBatcher::Vertex);
+	commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
+	// 頂点バッファはフレームごとに変わるので、セット済みの記録はインデックスだけにしておく
+	if (!stateCache || stateCache->SetMesh(reinterpret_cast<uintptr_t>(indexResource.Get()))) {
+		commandList->IASetIndexBuffer(&indexBufferView);
+	}
+	// Spriteと同じ正射影（頂点はCPUでスクリーン座標まで作るので、ワールド行列はない）
+	commandList->SetGraphicsRootConstantBufferView(1, dxCommon->UploadConstantBuffer(spriteCommon_->GetProjectionMatrix()));
+
+	// 同じテクスチャが続く範囲ごとに1回で描く
+	for (const SpriteBatcher::Run &run : batcher.GetRuns()) {
+		if (!stateCache || stateCache->SetTexture(run.texture)) {
+			commandList->SetGraphicsRootDescriptorTable(2, TextureManager::GetInstance()->GetSrvHandleGPU(run.texture));
+		}
+		for (uint32_t first = 0; first < run.quadCount; first += kMaxQuadsPerDraw) {
+			uint32_t count = std::min(run.quadCount - first, kMaxQuadsPerDraw);
+			commandList->DrawIndexedInstanced(count * 6, 1, 0, INT((run.firstQuad + first) * 4), 0);
+			statistics.drawCount++;
+		}
+	}
+
+	batcher.Clear();
+}
\ No newline at end of file
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include <wrl.h>
+#include <d3d12.h>
+#include "MathFunctions.h"
+#include "AssetRegistry.h"
+#include "SpriteBatcher.h"
+#include "TextureAtlas.h"
+#include "SpriteCommon.h"
+
+class RenderStateCache;
+
+// スプライトをまとめて描く仕組み
+// Drawで積んだスプライトをSpriteBatcherでレイヤー→テクスチャの順に並べ、全部の頂点をフレームに1本の頂点バッファ（アップロード用リングバッファ）に書き出す
+// 同じテクスチャが続く範囲を1回のDrawで描くので、HUDや2Dエフェクトのような大量の四角形もテクスチャの数程度のDrawで済む
+// Spriteと違い、1枚ごとの頂点バッファや定数バッファは持たない
+class SpriteBatch
+{
+public:
+
+	// 直前に描いた結果
+	struct Statistics
+	{
+		uint32_t spriteCount = 0; // 描いたスプライト数
+		uint32_t drawCount = 0; // Drawの回数
+	};
+
+	/// <summary>
+	/// 初期化
+	/// </summary>
+	/// <param name="spriteCommon">スプライト共通部</param>
+	/// <param name="pipelineType">描くときのPSO（kBatchかkText）</param>
+	void Initialize(SpriteCommon *spriteCommon, SpriteCommon::PipelineType pipelineType = SpriteCommon::PipelineType::kBatch);
+
+	/// <summary>
+	/// スプライトを積む
+	/// </summary>
+	/// <param name="textureHandle">テクスチャ（TextureManagerで読み込み済みのもの）</param>
+	/// <param name="quad">位置・大きさ・回転・アンカーポイント・切り出し範囲・色・反転</param>
+	/// <param name="layer">重なり順（小さいほど先に描く。同じレイヤーの中では積んだ順）</param>
+	void Draw(AssetHandle textureHandle, const SpriteBatcher::Quad &quad, int32_t layer = 0);
+
+	/// <summary>
+	/// テクスチャアトラスの切り出し範囲でスプライトを積む（同じページの範囲は1回のDrawにまとまる）
+	/// </summary>
+	/// <param name="region">切り出し範囲（quadの切り出し範囲の代わりに使う）</param>
+	/// <param name="quad">位置・大きさ・回転・アンカーポイント・色・反転</param>
+	/// <param name="layer">重なり順</param>
+	void Draw(const TextureAtlas::Region &region, const SpriteBatcher::Quad &quad, int32_t layer = 0);
+
+	// 積んだスプライトを描く（SpriteCommonに描画キューがあればパケットを積み、キューの実行時に描く）
+	// フレームに1回、スプライトを積み終えてから呼ぶ
+	void Flush();
+
+	// 直前に描いた結果
+	const Statistics &GetStatistics() const { return statistics; }
+
+	// 1回のDrawで描ける四角形の数（16bitのインデックスで届く数。これより長いランは分けて描く）
+	static constexpr uint32_t kMaxQuadsPerDraw = 65536 / 4;
+
+private:
+
+	// 並べ替えて頂点を書き出し、ランごとに描く（stateCacheがあればセット済みのステートを省く）
+	void Render(RenderStateCache *stateCache);
+
+	SpriteCommon *spriteCommon_ = nullptr;
+	SpriteCommon::PipelineType pipelineType = SpriteCommon::PipelineType::kBatch;
+
+	// 積んだスプライトの並べ替えと頂点作り
+	SpriteBatcher batcher;
+	// 描画キューにパケットを積んだか（同じフレームで2回積まない）
+	bool submitted = false;
+
+	// 四角形kMaxQuadsPerDraw個分のインデックス（ランの頂点の開始位置はBaseVertexLocationでずらす）
+	Microsoft::WRL::ComPtr<ID3D12Resource> indexResource;
+	D3D12_INDEX_BUFFER_VIEW indexBufferView {};
+
+	Statistics statistics;
+};
\ No newline at end of file
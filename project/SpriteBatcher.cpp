@@ -0,0 +1,157 @@
+#include "SpriteBatcher.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+
+using namespace math;
+
+namespace {
+
+	// 0～1をUNORM16にする
+	inline uint16_t ToUnorm16(float value)
+	{
+		return static_cast<uint16_t>(std::clamp(value, 0.0f, 1.0f) * 65535.0f + 0.5f);
+	}
+
+	// 0～1をUNORM8にする
+	inline uint32_t ToUnorm8(float value)
+	{
+		return static_cast<uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+	}
+}
+
+void SpriteBatcher::Clear()
+{
+	items.clear();
+	sortEntries.clear();
+	runs.clear();
+}
+
+void SpriteBatcher::Add(uint32_t texture, const Vector2 &textureSize, int32_t layer, const Quad &quad)
+{
+	assert(texture <= UINT16_MAX && "SpriteBatcher texture keys must fit in 16 bits");
+	assert(textureSize.x > 0.0f && textureSize.y > 0.0f);
+
+	// 切り出し範囲をUVにする（大きさが0ならテクスチャ全体）
+	Vector2 clipSize = quad.textureSize;
+	if (clipSize.x <= 0.0f || clipSize.y <= 0.0f) {
+		clipSize = textureSize;
+	}
+
+	Item item {};
+	item.position = quad.position;
+	item.size = quad.size;
+	item.rotation = quad.rotation;
+	item.anchorPoint = quad.anchorPoint;
+	item.texcoordLeftTop[0] = ToUnorm16(quad.textureLeftTop.x / textureSize.x);
+	item.texcoordLeftTop[1] = ToUnorm16(quad.textureLeftTop.y / textureSize.y);
+	item.texcoordRightBottom[0] = ToUnorm16((quad.textureLeftTop.x + clipSize.x) / textureSize.x);
+	item.texcoordRightBottom[1] = ToUnorm16((quad.textureLeftTop.y + clipSize.y) / textureSize.y);
+	item.color = ToUnorm8(quad.color.x) | (ToUnorm8(quad.color.y) << 8) | (ToUnorm8(quad.color.z) << 16) | (ToUnorm8(quad.color.w) << 24);
+	item.texture = texture;
+	item.isFlipX = quad.isFlipX;
+	item.isFlipY = quad.isFlipY;
+	items.push_back(item);
+
+	// レイヤーは16bitに収めてからずらし、負の値が先に並ぶようにする
+	uint32_t layerKey = static_cast<uint32_t>(std::clamp(layer, int32_t(INT16_MIN), int32_t(INT16_MAX)) - INT16_MIN);
+	sortEntries.push_back({ (layerKey << 16) | texture, static_cast<uint32_t>(items.size() - 1) });
+}
+
+void SpriteBatcher::Build(Vertex *vertices)
+{
+	const size_t count = items.size();
+	runs.clear();
+	if (count == 0) {
+		return;
+	}
+
+	// 下位から8bitずつの基数ソート（各桁は安定なので、同じレイヤー・テクスチャの中では追加した順のまま）
+	constexpr uint32_t kRadixBits = 8;
+	constexpr uint32_t kRadix = 1u << kRadixBits;
+	constexpr uint32_t kDigitCount = 32 / kRadixBits;
+	std::array<std::array<uint32_t, kRadix>, kDigitCount> histograms {};
+	for (const SortEntry &entry : sortEntries) {
+		for (uint32_t digit = 0; digit < kDigitCount; ++digit) {
+			histograms[digit][(entry.key >> (digit * kRadixBits)) & (kRadix - 1)]++;
+		}
+	}
+	sortScratch.resize(count);
+	for (uint32_t digit = 0; digit < kDigitCount; ++digit) {
+		std::array<uint32_t, kRadix> &histogram = histograms[digit];
+		const uint32_t shift = digit * kRadixBits;
+
+		// 全キーでこの桁が同じなら並びは変わらないので飛ばす（レイヤーを使っていないときの上位の桁など）
+		if (histogram[(sortEntries[0].key >> shift) & (kRadix - 1)] == count) {
+			continue;
+		}
+
+		uint32_t offset = 0;
+		for (uint32_t &bucket : histogram) {
+			uint32_t bucketCount = bucket;
+			bucket = offset;
+			offset += bucketCount;
+		}
+		for (const SortEntry &entry : sortEntries) {
+			sortScratch[histogram[(entry.key >> shift) & (kRadix - 1)]++] = entry;
+		}
+		sortEntries.swap(sortScratch);
+	}
+
+	// 並べた順に頂点を先頭から書き出し、同じテクスチャが続く範囲をまとめる（書き込み先がアップロードヒープでも順に埋まる）
+	// レイヤーが変わると同じテクスチャでも別のランにする（重なり順を保つ）
+	// 要素は値でコピーしておく（書き込み先と別物だとコンパイラに分かり、書き込むたびに読み直さなくなる）
+	Vertex *vertex = vertices;
+	uint32_t previousKey = sortEntries[0].key;
+	uint32_t runStart = 0;
+	for (uint32_t quadIndex = 0; quadIndex < count; ++quadIndex, vertex += 4) {
+		const SortEntry entry = sortEntries[quadIndex];
+		const Item item = items[entry.item];
+		if (entry.key != previousKey) {
+			runs.push_back({ items[sortEntries[runStart].item].texture, runStart, quadIndex - runStart });
+			runStart = quadIndex;
+			previousKey = entry.key;
+		}
+
+		// アンカーポイントを原点にした四角形（反転はアンカーポイントを軸に裏返す）
+		float left = (0.0f - item.anchorPoint.x) * item.size.x;
+		float right = (1.0f - item.anchorPoint.x) * item.size.x;
+		float top = (0.0f - item.anchorPoint.y) * item.size.y;
+		float bottom = (1.0f - item.anchorPoint.y) * item.size.y;
+		if (item.isFlipX) {
+			left = -left;
+			right = -right;
+		}
+		if (item.isFlipY) {
+			top = -top;
+			bottom = -bottom;
+		}
+
+		// 回転して移動する（回転していなければ三角関数を省く）
+		const float x = item.position.x;
+		const float y = item.position.y;
+		if (item.rotation == 0.0f) {
+			vertex[0].position = { left + x, bottom + y };
+			vertex[1].position = { left + x, top + y };
+			vertex[2].position = { right + x, bottom + y };
+			vertex[3].position = { right + x, top + y };
+		} else {
+			const float cosine = std::cos(item.rotation);
+			const float sine = std::sin(item.rotation);
+			vertex[0].position = { left * cosine - bottom * sine + x, left * sine + bottom * cosine + y };
+			vertex[1].position = { left * cosine - top * sine + x, left * sine + top * cosine + y };
+			vertex[2].position = { right * cosine - bottom * sine + x, right * sine + bottom * cosine + y };
+			vertex[3].position = { right * cosine - top * sine + x, right * sine + top * cosine + y };
+		}
+
+		const uint16_t u0 = item.texcoordLeftTop[0], v0 = item.texcoordLeftTop[1];
+		const uint16_t u1 = item.texcoordRightBottom[0], v1 = item.texcoordRightBottom[1];
+		vertex[0].texcoord[0] = u0; vertex[0].texcoord[1] = v1;
+		vertex[1].texcoord[0] = u0; vertex[1].texcoord[1] = v0;
+		vertex[2].texcoord[0] = u1; vertex[2].texcoord[1] = v1;
+		vertex[3].texcoord[0] = u1; vertex[3].texcoord[1] = v0;
+		vertex[0].color = vertex[1].color = vertex[2].color = vertex[3].color = item.color;
+	}
+	runs.push_back({ items[sortEntries[runStart].item].texture, runStart, uint32_t(count) - runStart });
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "MathTypes.h"
+
+// スプライトをまとめて描くための頂点作り
+// 1枚ごとの位置・大きさ・回転・アンカーポイント・切り出し範囲・色・反転を集め、レイヤー→テクスチャの順に並べ替えてから
+// 全部の四角形の頂点を1本の配列（アップロード用の領域）へ直接書き出す。同じテクスチャが続く範囲（ラン）は1回のDrawで描ける
+// 頂点の位置はSpriteと同じ（アンカーポイントを原点に拡縮→回転→移動し、反転はアンカーポイントを軸に裏返す）
+class SpriteBatcher
+{
+public:
+
+	// 頂点（16byte。位置はスクリーン座標のピクセル）
+	struct Vertex
+	{
+		math::Vector2 position;
+		uint16_t texcoord[2]; // UNORM16（切り出し範囲はテクスチャの内側に収める）
+		uint32_t color; // R8G8B8A8_UNORM
+	};
+
+	// 1枚分の指定
+	struct Quad
+	{
+		math::Vector2 position = { 0.0f, 0.0f }; // アンカーポイントを置くスクリーン座標
+		math::Vector2 size = { 128.0f, 128.0f };
+		float rotation = 0.0f;
+		math::Vector2 anchorPoint = { 0.0f, 0.0f };
+		math::Vector2 textureLeftTop = { 0.0f, 0.0f }; // 切り出す左上（テクスチャのピクセル）
+		math::Vector2 textureSize = { 0.0f, 0.0f }; // 切り出す大きさ（0ならテクスチャ全体）
+		math::Vector4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
+		bool isFlipX = false;
+		bool isFlipY = false;
+	};
+
+	// 同じテクスチャが続く四角形の範囲
+	struct Run
+	{
+		uint32_t texture; // テクスチャのキー
+		uint32_t firstQuad; // 何番目の四角形から始まるか（頂点はその4倍から）
+		uint32_t quadCount; // 四角形の数
+	};
+
+	// 追加したスプライトをすべて破棄する（確保した領域は残す）
+	void Clear();
+
+	/// <summary>
+	/// スプライトを追加する
+	/// </summary>
+	/// <param name="texture">テクスチャのキー（AssetHandleのスロット番号のような16bitに収まる番号）</param>
+	/// <param name="textureSize">テクスチャの大きさ（ピクセル。切り出し範囲をUVにするのに使う）</param>
+	/// <param name="layer">重なり順（小さいほど先に描く。同じレイヤーの中では追加した順）</param>
+	/// <param name="quad">スプライトの指定</param>
+	void Add(uint32_t texture, const math::Vector2 &textureSize, int32_t layer, const Quad &quad);
+
+	/// <summary>
+	/// レイヤー→テクスチャ→追加した順に並べ替えて、頂点を書き出しランを作る
+	/// </summary>
+	/// <param name="vertices">書き込み先（GetQuadCount() * 4頂点。四角形ごとに 左下・左上・右下・右上 の順）</param>
+	void Build(Vertex *vertices);
+
+	// 追加したスプライトの数
+	size_t GetQuadCount() const { return items.size(); }
+	// Buildの結果
+	const std::vector<Run> &GetRuns() const { return runs; }
+
+	// 四角形1つ分のインデックス（頂点の番号に四角形の番号×4を足して使う）
+	static constexpr uint16_t kQuadIndices[6] = { 0, 1, 2, 1, 3, 2 };
+
+private:
+
+	// 追加時に整えた1枚分
+	struct Item
+	{
+		math::Vector2 position;
+		math::Vector2 size;
+		float rotation;
+		math::Vector2 anchorPoint;
+		uint16_t texcoordLeftTop[2];
+		uint16_t texcoordRightBottom[2];
+		uint32_t color;
+		uint32_t texture;
+		bool isFlipX;
+		bool isFlipY;
+	};
+
+	// 並べ替えのキー（上位16bitがレイヤー、下位16bitがテクスチャ）と要素の番号
+	struct SortEntry
+	{
+		uint32_t key;
+		uint32_t item;
+	};
+
+	std::vector<Item> items;
+	std::vector<SortEntry> sortEntries;
+	std::vector<SortEntry> sortScratch;
+
+	// Buildの結果
+	std::vector<Run> runs;
+};
\ No newline at end of file
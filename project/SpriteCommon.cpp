@@ -1,5 +1,8 @@
 #include "SpriteCommon.h"
 #include "DirectXCommon.h"
+#include "RenderQueue.h"
+#include "MathFunctions.h"
+#include "WinApp.h"
 
 void SpriteCommon::Initialize(DirectXCommon *dxCommon)
 {
@@ -7,6 +10,9 @@ void SpriteCommon::Initialize(DirectXCommon *dxCommon)
 	dxCommon_ = dxCommon;
 
 	CreateGraphicsPipelineState();
+
+	// 画面の大きさは変わらないので、正射影は最初に1回だけ作る
+	projectionMatrix = math::MakeOrthographicMatrix(0.0f, 0.0f, float(WinApp::kClientWidth), float(WinApp::kClientHeight), 0.0f, 100.0f);
 }
 
 void SpriteCommon::SetupCommonDrawing()
@@ -17,11 +23,39 @@ void SpriteCommon::SetupCommonDrawing()
 
     // 2. パイプラインステートオブジェクトをセット
 	dxCommon_->GetCommandList()->SetPipelineState(graphicsPipelineState.Get());
+	boundPipelineState = graphicsPipelineState.Get();
 
     // 3. プリミティブトポロジーをセット（三角形リストが一般的）
 	dxCommon_->GetCommandList()->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
+void SpriteCommon::SetPipeline(PipelineType pipelineType, RenderStateCache *stateCache)
+{
+	ID3D12PipelineState *pipelineState = graphicsPipelineState.Get();
+	if (pipelineType == PipelineType::kBatch) {
+		pipelineState = batchGraphicsPipelineState.Get();
+	} else if (pipelineType == PipelineType::kText) {
+		pipelineState = textGraphicsPipelineState.Get();
+	}
+	bool changed = stateCache ? stateCache->SetPipeline(reinterpret_cast<uintptr_t>(pipelineState)) : pipelineState != boundPipelineState;
+	if (!changed) {
+		return;
+	}
+	dxCommon_->GetCommandList()->SetPipelineState(pipelineState);
+	boundPipelineState = pipelineState;
+}
+
+void SpriteCommon::SetRenderQueue(RenderQueue *renderQueue)
+{
+	this->renderQueue = renderQueue;
+	if (renderQueue) {
+		renderQueue->SetPassSetup(RenderPass::kSprite, [this](RenderStateCache &stateCache) {
+			SetupCommonDrawing();
+			stateCache.SetPipeline(reinterpret_cast<uintptr_t>(graphicsPipelineState.Get()));
+			});
+	}
+}
+
 void SpriteCommon::CreateRootSignature()
 {
 	HRESULT hr;
@@ -163,7 +197,7 @@ void SpriteCommon::CreateGraphicsPipelineState()
 	//----ShaderをCompileする----
 
 	// Shaderをコンパイルする
-	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3D.VS.hlsl", L"vs_6_0");
+	Microsoft::WRL::ComPtr<IDxcBlob> vertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Sprite.VS.hlsl", L"vs_6_0");
 	assert(vertexShaderBlob != nullptr);
 
 	Microsoft::WRL::ComPtr<IDxcBlob> pixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/Object3D.PS.hlsl", L"ps_6_0");
@@ -208,4 +242,59 @@ void SpriteCommon::CreateGraphicsPipelineState()
 	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
 		IID_PPV_ARGS(&graphicsPipelineState));
 	assert(SUCCEEDED(hr));
+
+	//----SpriteBatch用のPSOを生成する----
+
+	// 位置はスクリーン座標のFLOAT×2、UVはUNORM16×2、色はUNORM8×4（SpriteBatcher::Vertex）
+	D3D12_INPUT_ELEMENT_DESC batchInputElementDescs[3] = {};
+	batchInputElementDescs[0].SemanticName = "POSITION";
+	batchInputElementDescs[0].SemanticIndex = 0;
+	batchInputElementDescs[0].Format = DXGI_FORMAT_R32G32_FLOAT;
+	batchInputElementDescs[0].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	batchInputElementDescs[1].SemanticName = "TEXCOORD";
+	batchInputElementDescs[1].SemanticIndex = 0;
+	batchInputElementDescs[1].Format = DXGI_FORMAT_R16G16_UNORM;
+	batchInputElementDescs[1].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	batchInputElementDescs[2].SemanticName = "COLOR";
+	batchInputElementDescs[2].SemanticIndex = 0;
+	batchInputElementDescs[2].Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	batchInputElementDescs[2].AlignedByteOffset = D3D12_APPEND_ALIGNED_ELEMENT;
+
+	Microsoft::WRL::ComPtr<IDxcBlob> batchVertexShaderBlob = dxCommon_->CompileShader(L"resources/shaders/SpriteBatch.VS.hlsl", L"vs_6_0");
+	assert(batchVertexShaderBlob != nullptr);
+
+	Microsoft::WRL::ComPtr<IDxcBlob> batchPixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/SpriteBatch.PS.hlsl", L"ps_6_0");
+	assert(batchPixelShaderBlob != nullptr);
+
+	graphicsPipelineStateDesc.InputLayout.pInputElementDescs = batchInputElementDescs;
+	graphicsPipelineStateDesc.InputLayout.NumElements = _countof(batchInputElementDescs);
+	graphicsPipelineStateDesc.VS = { batchVertexShaderBlob->GetBufferPointer(),
+	batchVertexShaderBlob->GetBufferSize() };
+	graphicsPipelineStateDesc.PS = { batchPixelShaderBlob->GetBufferPointer(),
+	batchPixelShaderBlob->GetBufferSize() };
+
+	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
+		IID_PPV_ARGS(&batchGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
+
+	//----文字用のPSOを生成する----
+
+	// 文字の縁は覆い率で半透明になるので、通常のαブレンドで背景と混ぜる
+	Microsoft::WRL::ComPtr<IDxcBlob> textPixelShaderBlob = dxCommon_->CompileShader(L"resources/shaders/SpriteText.PS.hlsl", L"ps_6_0");
+	assert(textPixelShaderBlob != nullptr);
+
+	graphicsPipelineStateDesc.PS = { textPixelShaderBlob->GetBufferPointer(),
+	textPixelShaderBlob->GetBufferSize() };
+	graphicsPipelineStateDesc.BlendState.RenderTarget[0].BlendEnable = true;
+	graphicsPipelineStateDesc.BlendState.RenderTarget[0].SrcBlend = D3D12_BLEND_SRC_ALPHA;
+	graphicsPipelineStateDesc.BlendState.RenderTarget[0].DestBlend = D3D12_BLEND_INV_SRC_ALPHA;
+	graphicsPipelineStateDesc.BlendState.RenderTarget[0].BlendOp = D3D12_BLEND_OP_ADD;
+	// 半透明なので深度は書かない（重なった文字の縁が欠けないように）
+	graphicsPipelineStateDesc.DepthStencilState.DepthWriteMask = D3D12_DEPTH_WRITE_MASK_ZERO;
+
+	hr = dxCommon_->GetDevice()->CreateGraphicsPipelineState(&graphicsPipelineStateDesc,
+		IID_PPV_ARGS(&textGraphicsPipelineState));
+	assert(SUCCEEDED(hr));
 }
\ No newline at end of file
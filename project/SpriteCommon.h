@@ -1,8 +1,13 @@
 #pragma once
+#include <cstdint>
 #include <wrl.h>
 #include <d3d12.h>
+#include "MathTypes.h"
+#include "SpriteGeometry.h"
 
 class DirectXCommon;
+class RenderQueue;
+class RenderStateCache;
 
 // スプライト共通部
 class SpriteCommon
@@ -13,12 +18,45 @@ public: // メンバ関数
 
 	DirectXCommon *GetDxCommon() const { return dxCommon_; }
 
+	// スクリーン座標（ピクセル）からクリップ座標への正射影（全スプライトで共有し、Initializeで1回だけ作る）
+	const math::Matrix4x4 &GetProjectionMatrix() const { return projectionMatrix; }
+
+	// Sprite::Updateで作り直した数と、変更がなかったので省いた数
+	using UpdateStatistics = SpriteGeometry::UpdateStatistics;
+	const UpdateStatistics &GetUpdateStatistics() const { return updateStatistics; }
+	// フレームの最初に呼ぶ
+	void ResetUpdateStatistics() { updateStatistics = {}; }
+	// Sprite::Updateから数える
+	void CountUpdate(const SpriteGeometry::UpdateResult &result) { updateStatistics.Count(result); }
+
+	// PSOの種類（ルートシグネチャは共通）
+	enum class PipelineType
+	{
+		kSprite, // Sprite（1枚ずつ定数バッファで変換する）
+		kBatch, // SpriteBatch（頂点にスクリーン座標・UV・色を持つ）
+		kText, // 文字（SpriteBatchの頂点で、テクスチャの赤を覆い率にしてαブレンドする）
+	};
+
 	// 共通描画設定
 	void SetupCommonDrawing();
 
+	// PSOを切り替える（同じPSOが続く間は何もしない）
+	void SetPipeline(PipelineType pipelineType, RenderStateCache *stateCache = nullptr);
+
+	// 登録すると、Sprite::Drawはその場で描かずに描画キューへパケットを積む
+	// スプライトのパスの最初にSetupCommonDrawingが呼ばれるようにする
+	void SetRenderQueue(RenderQueue *renderQueue);
+	RenderQueue *GetRenderQueue() const { return renderQueue; }
+
 private:
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> rootSignature = nullptr;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> graphicsPipelineState = nullptr;
+	// SpriteBatch用のPSO（入力レイアウトとシェーダーが異なる）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> batchGraphicsPipelineState = nullptr;
+	// 文字用のPSO（SpriteBatchと同じ入力レイアウトで、αブレンドして深度は書かない）
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> textGraphicsPipelineState = nullptr;
+	// 現在セットしているPSO
+	ID3D12PipelineState *boundPipelineState = nullptr;
 
 	// ルードシグネチャの作成
 	void CreateRootSignature();
@@ -26,4 +64,9 @@ private:
 	void CreateGraphicsPipelineState();
 
 	DirectXCommon *dxCommon_;
+
+	RenderQueue *renderQueue = nullptr;
+
+	math::Matrix4x4 projectionMatrix {};
+	UpdateStatistics updateStatistics;
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include "SpriteGeometry.h"
+#include "MathFunctions.h"
+
+using namespace math;
+
+SpriteGeometry::UpdateResult SpriteGeometry::Update(const Matrix4x4 &projectionMatrix)
+{
+	// 変わっていなければ前回の頂点と行列をそのまま使う
+	UpdateResult result;
+	result.vertexUpdated = isVertexDirty;
+	result.transformUpdated = isTransformDirty;
+
+	if (isVertexDirty) {
+		isVertexDirty = false;
+
+		float left = 0.0f - anchorPoint.x;
+		float right = 1.0f - anchorPoint.x;
+		float top = 0.0f - anchorPoint.y;
+		float bottom = 1.0f - anchorPoint.y;
+
+		// 左右反転
+		if (isFlipX) {
+			left = -left;
+			right = -right;
+		}
+		// 上下反転
+		if (isFlipY) {
+			top = -top;
+			bottom = -bottom;
+		}
+
+		float tex_left = textureLeftTop.x / textureDimensions.x;
+		float tex_right = (textureLeftTop.x + textureSize.x) / textureDimensions.x;
+		float tex_top = textureLeftTop.y / textureDimensions.y;
+		float tex_bottom = (textureLeftTop.y + textureSize.y) / textureDimensions.y;
+
+		// 左下
+		vertices[0].position = { left,bottom,0.0f,1.0f };
+		vertices[0].texcoord = { tex_left,tex_bottom };
+		vertices[0].normal = { 0.0f,0.0f,-1.0f };
+		//左上
+		vertices[1].position = { left,top,0.0f,1.0f };
+		vertices[1].texcoord = { tex_left,tex_top };
+		vertices[1].normal = { 0.0f,0.0f,-1.0f };
+		// 右下
+		vertices[2].position = { right,bottom,0.0f,1.0f };
+		vertices[2].texcoord = { tex_right,tex_bottom };
+		vertices[2].normal = { 0.0f,0.0f,-1.0f };
+		// 右上
+		vertices[3].position = { right,top,0.0f,1.0f };
+		vertices[3].texcoord = { tex_right,tex_top };
+		vertices[3].normal = { 0.0f,0.0f,-1.0f };
+	}
+
+	if (isTransformDirty) {
+		isTransformDirty = false;
+
+		// ビュー行列は単位行列なので、共有の正射影を掛けるだけ
+		worldMatrix = MakeAffineMatrix({ size.x,size.y,1.0f }, { 0.0f,0.0f,rotation }, { position.x,position.y,0.0f });
+		wvpMatrix = Multiply(worldMatrix, projectionMatrix);
+	}
+
+	return result;
+}
\ No newline at end of file
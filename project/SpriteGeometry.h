@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include "MathTypes.h"
+
+// スプライト1枚の頂点と行列（GPUに依存しない部分。Spriteが1つ持つ）
+// setterで変わったものに印を付け、Updateでは印の付いたものだけ作り直す
+// 頂点はアンカーポイント・反転・切り出し範囲・テクスチャの大きさ、行列は位置・回転・大きさで決まる
+class SpriteGeometry
+{
+public:
+
+	// 頂点データ（Spriteの頂点バッファと同じ並び）
+	struct Vertex
+	{
+		math::Vector4 position;
+		math::Vector2 texcoord;
+		math::Vector3 normal;
+	};
+
+	// Updateで作り直したもの
+	struct UpdateResult
+	{
+		bool vertexUpdated = false;
+		bool transformUpdated = false;
+	};
+
+	// Updateで作り直した数と、変更がなかったので省いた数
+	struct UpdateStatistics
+	{
+		uint32_t vertexUpdates = 0; // 頂点（アンカーポイント・反転・切り出し範囲・テクスチャ）を作り直した数
+		uint32_t transformUpdates = 0; // 行列（位置・回転・大きさ）を作り直した数
+		uint32_t skippedUpdates = 0; // どちらも変わっていなかった数
+
+		void Count(const UpdateResult &result)
+		{
+			vertexUpdates += result.vertexUpdated;
+			transformUpdates += result.transformUpdated;
+			skippedUpdates += !result.vertexUpdated && !result.transformUpdated;
+		}
+	};
+
+	/// <summary>
+	/// 変わったものだけ頂点と行列を作り直す
+	/// </summary>
+	/// <param name="projectionMatrix">スクリーン座標からクリップ座標への正射影（ビュー行列は単位行列）</param>
+	/// <returns>作り直したもの</returns>
+	UpdateResult Update(const math::Matrix4x4 &projectionMatrix);
+
+	// Updateの結果（左下・左上・右下・右上の順）
+	const Vertex *GetVertices() const { return vertices; }
+	const math::Matrix4x4 &GetWorldMatrix() const { return worldMatrix; }
+	const math::Matrix4x4 &GetWVPMatrix() const { return wvpMatrix; }
+
+	const math::Vector2 &GetPosition() const { return position; }
+	void SetPosition(const math::Vector2 &position) { this->position = position; isTransformDirty = true; }
+
+	float GetRotation() const { return rotation; }
+	void SetRotation(float rotation) { this->rotation = rotation; isTransformDirty = true; }
+
+	const math::Vector2 &GetSize() const { return size; }
+	void SetSize(const math::Vector2 &size) { this->size = size; isTransformDirty = true; }
+
+	const math::Vector2 &GetAnchorPoint() const { return anchorPoint; }
+	void SetAnchorPoint(const math::Vector2 &anchorPoint) { this->anchorPoint = anchorPoint; isVertexDirty = true; }
+
+	bool GetIsFlipX() const { return isFlipX; }
+	bool GetIsFlipY() const { return isFlipY; }
+	void SetIsFlipX(bool isFlipX) { this->isFlipX = isFlipX; isVertexDirty = true; }
+	void SetIsFlipY(bool isFlipY) { this->isFlipY = isFlipY; isVertexDirty = true; }
+
+	const math::Vector2 &GetTextureLeftTop() const { return textureLeftTop; }
+	const math::Vector2 &GetTextureSize() const { return textureSize; }
+	void SetTextureLeftTop(const math::Vector2 &leftTop) { textureLeftTop = leftTop; isVertexDirty = true; }
+	void SetTextureSize(const math::Vector2 &size) { textureSize = size; isVertexDirty = true; }
+
+	// テクスチャの幅と高さ（UVの計算用。テクスチャを変えたときだけ設定する）
+	const math::Vector2 &GetTextureDimensions() const { return textureDimensions; }
+	void SetTextureDimensions(const math::Vector2 &dimensions) { textureDimensions = dimensions; isVertexDirty = true; }
+
+private:
+
+	math::Vector2 position = { 0.0f,0.0f };
+	float rotation = 0.0f;
+	math::Vector2 size = { 128.0f,128.0f };
+	math::Vector2 anchorPoint = { 0.0f,0.0f };
+
+	// 左右フリップ
+	bool isFlipX = false;
+	// 上下フリップ
+	bool isFlipY = false;
+
+	// テクスチャ左上座標
+	math::Vector2 textureLeftTop = { 0.0f,0.0f };
+	// テクスチャ切り出しサイズ
+	math::Vector2 textureSize = { 512.0f,512.0f };
+	math::Vector2 textureDimensions = { 1.0f,1.0f };
+
+	// 次のUpdateで作り直すもの
+	bool isVertexDirty = true;
+	bool isTransformDirty = true;
+
+	Vertex vertices[4] {};
+	math::Matrix4x4 worldMatrix {};
+	math::Matrix4x4 wvpMatrix {};
+};
\ No newline at end of file
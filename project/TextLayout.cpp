@@ -0,0 +1,159 @@
+#include "TextLayout.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace math;
+
+namespace {
+
+	// 不正なバイト列の代わりにする文字
+	constexpr uint32_t kReplacementCharacter = 0xFFFD;
+
+	// 前の文字がない
+	constexpr uint32_t kNoGlyph = UINT32_MAX;
+
+	// 後ろで折り返せる文字（全角の空白も含む）
+	inline bool IsBreakableSpace(uint32_t codepoint)
+	{
+		return codepoint == ' ' || codepoint == '\t' || codepoint == 0x3000;
+	}
+}
+
+uint32_t TextLayout::DecodeUtf8(std::string_view text, size_t &offset)
+{
+	const uint8_t lead = static_cast<uint8_t>(text[offset]);
+	if (lead < 0x80) {
+		offset++;
+		return lead;
+	}
+
+	// 先頭のバイトから長さを決める
+	size_t length = 0;
+	uint32_t codepoint = 0;
+	uint32_t minimum = 0;
+	if ((lead & 0xE0) == 0xC0) {
+		length = 2;
+		codepoint = lead & 0x1F;
+		minimum = 0x80;
+	} else if ((lead & 0xF0) == 0xE0) {
+		length = 3;
+		codepoint = lead & 0x0F;
+		minimum = 0x800;
+	} else if ((lead & 0xF8) == 0xF0) {
+		length = 4;
+		codepoint = lead & 0x07;
+		minimum = 0x10000;
+	} else {
+		offset++;
+		return kReplacementCharacter;
+	}
+
+	// 続きのバイトが足りない・形が違うときは先頭の1byteだけ捨てる
+	if (offset + length > text.size()) {
+		offset++;
+		return kReplacementCharacter;
+	}
+	for (size_t i = 1; i < length; ++i) {
+		const uint8_t continuation = static_cast<uint8_t>(text[offset + i]);
+		if ((continuation & 0xC0) != 0x80) {
+			offset++;
+			return kReplacementCharacter;
+		}
+		codepoint = (codepoint << 6) | (continuation & 0x3F);
+	}
+	offset += length;
+
+	// 冗長な表現・サロゲート・範囲外は1文字の不正として扱う
+	if (codepoint < minimum || codepoint > 0x10FFFF || (codepoint >= 0xD800 && codepoint <= 0xDFFF)) {
+		return kReplacementCharacter;
+	}
+	return codepoint;
+}
+
+TextLayout::Result TextLayout::Layout(GlyphCache &glyphCache, std::string_view text, const Vector2 &position, const Style &style, std::vector<SpriteBatcher::Quad> &quads)
+{
+	const GlyphCache::LineMetrics metrics = glyphCache.GetLineMetrics(style.font, style.pixelHeight);
+	const float lineHeight = std::round((metrics.ascent - metrics.descent + metrics.lineGap) * style.lineSpacing);
+	const size_t firstQuad = quads.size();
+
+	SpriteBatcher::Quad quad;
+	quad.color = style.color;
+
+	// ペンは行頭からの距離、ベースラインは1行目の上端からの距離
+	float penX = 0.0f;
+	float baseline = metrics.ascent;
+	uint32_t lineCount = 1;
+	uint32_t previousGlyph = kNoGlyph;
+	// 直前の空白の後ろ（ここから後の四角形を次の行へ送れる）
+	size_t breakQuad = SIZE_MAX;
+	float breakX = 0.0f;
+
+	for (size_t offset = 0; offset < text.size();) {
+		const uint32_t codepoint = DecodeUtf8(text, offset);
+		if (codepoint == '\r') {
+			continue;
+		}
+		if (codepoint == '\n') {
+			penX = 0.0f;
+			baseline += lineHeight;
+			lineCount++;
+			previousGlyph = kNoGlyph;
+			breakQuad = SIZE_MAX;
+			continue;
+		}
+
+		// 参照は次のGetGlyphで書き換わることがあるので値で持つ
+		const GlyphCache::Glyph glyph = glyphCache.GetGlyph(style.font, codepoint, style.pixelHeight);
+		if (previousGlyph != kNoGlyph) {
+			penX += glyphCache.GetKerning(style.font, style.pixelHeight, previousGlyph, glyph.glyphIndex);
+		}
+		previousGlyph = glyph.glyphIndex;
+
+		if (IsBreakableSpace(codepoint)) {
+			penX += glyph.advance;
+			breakQuad = quads.size();
+			breakX = penX;
+			continue;
+		}
+
+		// 幅を超えたら折り返す（行頭の文字は幅を超えても置く）
+		if (style.maxWidth > 0.0f && penX > 0.0f && penX + glyph.offsetX + glyph.width > style.maxWidth) {
+			if (breakQuad != SIZE_MAX) {
+				// 空白より後ろの四角形ごと次の行へ送る
+				for (size_t i = breakQuad; i < quads.size(); ++i) {
+					quads[i].position.x -= breakX;
+					quads[i].position.y += lineHeight;
+				}
+				penX -= breakX;
+			} else {
+				// 1語が幅を超えるので、この文字の前で折り返す
+				penX = 0.0f;
+			}
+			baseline += lineHeight;
+			lineCount++;
+			breakQuad = SIZE_MAX;
+		}
+
+		if (glyph.width > 0 && glyph.height > 0) {
+			quad.position = { penX + glyph.offsetX, baseline + glyph.offsetY };
+			quad.size = { float(glyph.width), float(glyph.height) };
+			quad.textureLeftTop = { float(glyph.x), float(glyph.y) };
+			quad.textureSize = quad.size;
+			quads.push_back(quad);
+		}
+		penX += glyph.advance;
+	}
+
+	// 左上へ移して整数ピクセルにそろえ、大きさを測る
+	Result result {};
+	result.lineCount = lineCount;
+	result.quadCount = uint32_t(quads.size() - firstQuad);
+	result.size.y = lineHeight * float(lineCount);
+	for (size_t i = firstQuad; i < quads.size(); ++i) {
+		Vector2 &quadPosition = quads[i].position;
+		result.size.x = std::max(result.size.x, quadPosition.x + quads[i].size.x);
+		quadPosition.x = std::round(position.x + quadPosition.x);
+		quadPosition.y = std::round(position.y + quadPosition.y);
+	}
+	return result;
+}
\ No newline at end of file
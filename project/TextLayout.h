@@ -0,0 +1,50 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "MathTypes.h"
+#include "GlyphCache.h"
+#include "SpriteBatcher.h"
+
+// 文字列の配置
+// UTF-8の文字列をコードポイントに分けてGlyphCacheのグリフにし、カーニングと改行を行ってSpriteBatcher::Quadの並びにする
+// 改行は\nのほか、幅を超えたら空白の後ろで折り返す（1語が幅を超えるときは文字の間で折り返す）
+// 位置は整数ピクセルにそろえる（グリフのビットマップをそのままの大きさで描くので、にじまない）
+namespace TextLayout
+{
+	// 文字の見た目と折り返し
+	struct Style
+	{
+		uint32_t font = 0; // GlyphCacheのフォント番号
+		uint32_t pixelHeight = 32; // 文字の高さ（ピクセル）
+		math::Vector4 color = { 1.0f, 1.0f, 1.0f, 1.0f };
+		float maxWidth = 0.0f; // 折り返す幅（0なら\nでだけ改行する）
+		float lineSpacing = 1.0f; // 行送りの倍率
+	};
+
+	// 配置した結果
+	struct Result
+	{
+		math::Vector2 size; // 文字が占める大きさ（幅は一番長い行、高さは行数×行送り）
+		uint32_t lineCount; // 行数
+		uint32_t quadCount; // 追加した四角形の数（空白は含まない）
+	};
+
+	/// <summary>
+	/// UTF-8の1文字を読む（不正なバイト列はU+FFFDにして1byte進む）
+	/// </summary>
+	/// <param name="text">文字列</param>
+	/// <param name="offset">読む位置（読んだ分進める）</param>
+	/// <returns>コードポイント</returns>
+	uint32_t DecodeUtf8(std::string_view text, size_t &offset);
+
+	/// <summary>
+	/// 文字列を配置して四角形を追加する
+	/// </summary>
+	/// <param name="glyphCache">グリフを取得するキャッシュ（足りないグリフはここでラスタライズされる）</param>
+	/// <param name="text">UTF-8の文字列</param>
+	/// <param name="position">1行目の左上（スクリーン座標のピクセル）</param>
+	/// <param name="style">文字の見た目と折り返し</param>
+	/// <param name="quads">四角形の追加先（切り出し範囲はアトラスのピクセル）</param>
+	Result Layout(GlyphCache &glyphCache, std::string_view text, const math::Vector2 &position, const Style &style, std::vector<SpriteBatcher::Quad> &quads);
+}
\ No newline at end of file
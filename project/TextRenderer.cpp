@@ -0,0 +1,57 @@
+#include "TextRenderer.h"
+#include "SpriteCommon.h"
+#include "DirectXCommon.h"
+#include "TextureManager.h"
+#include <cassert>
+#include <cstring>
+
+using namespace math;
+
+void TextRenderer::Initialize(SpriteCommon *spriteCommon, uint32_t atlasSize)
+{
+	// 引数で受け取ってメンバ変数に記録する
+	spriteCommon_ = spriteCommon;
+
+	glyphCache.Initialize(atlasSize, atlasSize);
+	spriteBatch.Initialize(spriteCommon_, SpriteCommon::PipelineType::kText);
+
+	// 空のアトラスでテクスチャを作る（グリフは置いたときに範囲だけ転送する）
+	DirectX::ScratchImage atlasImage;
+	HRESULT hr = atlasImage.Initialize2D(DXGI_FORMAT_R8_UNORM, atlasSize, atlasSize, 1, 1);
+	assert(SUCCEEDED(hr));
+	memset(atlasImage.GetPixels(), 0, atlasImage.GetPixelsSize());
+	atlasTexture = TextureManager::GetInstance()->RegisterTexture("text glyph atlas", atlasImage);
+}
+
+int32_t TextRenderer::LoadFont(const std::string &filePath, int32_t fontIndex)
+{
+	return glyphCache.LoadFont(filePath, fontIndex);
+}
+
+TextLayout::Result TextRenderer::DrawString(std::string_view text, const Vector2 &position, const TextLayout::Style &style, int32_t layer)
+{
+	quads.clear();
+	TextLayout::Result result = TextLayout::Layout(glyphCache, text, position, style, quads);
+	for (const SpriteBatcher::Quad &quad : quads) {
+		spriteBatch.Draw(atlasTexture, quad, layer);
+	}
+	return result;
+}
+
+void TextRenderer::Flush()
+{
+	// このフレームでラスタライズしたグリフを、描く前にアトラスへ転送する
+	if (glyphCache.IsDirty()) {
+		const GlyphCache::Rect &dirtyRect = glyphCache.GetDirtyRect();
+		const uint8_t *pixels = glyphCache.GetPixels() + size_t(dirtyRect.top) * glyphCache.GetWidth() + dirtyRect.left;
+		spriteCommon_->GetDxCommon()->UploadTextureRegion(TextureManager::GetInstance()->GetResource(atlasTexture),
+			pixels, glyphCache.GetWidth(), dirtyRect.left, dirtyRect.top,
+			dirtyRect.right - dirtyRect.left, dirtyRect.bottom - dirtyRect.top, DXGI_FORMAT_R8_UNORM, 1);
+		glyphCache.ClearDirtyRect();
+	}
+
+	spriteBatch.Flush();
+
+	// 次のフレームでは、このフレームに使ったグリフも追い出せる
+	glyphCache.NextFrame();
+}
\ No newline at end of file
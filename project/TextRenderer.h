@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AssetRegistry.h"
+#include "GlyphCache.h"
+#include "TextLayout.h"
+#include "SpriteBatch.h"
+
+class SpriteCommon;
+
+// 文字の描画
+// GlyphCacheのアトラスを1枚のテクスチャ（R8_UNORM）にし、TextLayoutで並べた文字をSpriteBatch（文字用のPSO）でまとめて描く
+// アトラスはFlushのときに書き換えた範囲だけ転送するので、同じ文字を描き続ける間は転送もラスタライズもない
+class TextRenderer
+{
+public:
+
+	/// <summary>
+	/// 初期化（グリフのアトラスのテクスチャを作る）
+	/// </summary>
+	/// <param name="spriteCommon">スプライト共通部</param>
+	/// <param name="atlasSize">アトラスの幅と高さ（ピクセル）</param>
+	void Initialize(SpriteCommon *spriteCommon, uint32_t atlasSize = 1024);
+
+	/// <summary>
+	/// フォントファイルを読み込む
+	/// </summary>
+	/// <param name="filePath">.ttf/.ttc/.otfのパス</param>
+	/// <param name="fontIndex">.ttcの中の何番目のフォントか</param>
+	/// <returns>フォント番号（読み込めなければ-1）</returns>
+	int32_t LoadFont(const std::string &filePath, int32_t fontIndex = 0);
+
+	/// <summary>
+	/// 文字列を積む
+	/// </summary>
+	/// <param name="text">UTF-8の文字列</param>
+	/// <param name="position">1行目の左上（スクリーン座標のピクセル）</param>
+	/// <param name="style">フォント・大きさ・色・折り返し</param>
+	/// <param name="layer">重なり順</param>
+	/// <returns>配置した結果（大きさと行数）</returns>
+	TextLayout::Result DrawString(std::string_view text, const math::Vector2 &position, const TextLayout::Style &style, int32_t layer = 0);
+
+	// アトラスの書き換えた範囲を転送し、積んだ文字を描く
+	// フレームに1回、文字を積み終えてから呼ぶ
+	void Flush();
+
+	// 直前に描いた結果
+	const SpriteBatch::Statistics &GetStatistics() const { return spriteBatch.GetStatistics(); }
+	const GlyphCache &GetGlyphCache() const { return glyphCache; }
+
+private:
+
+	SpriteCommon *spriteCommon_ = nullptr;
+
+	GlyphCache glyphCache;
+	SpriteBatch spriteBatch;
+	// アトラスのテクスチャ
+	AssetHandle atlasTexture;
+	// 並べた四角形（使い回す）
+	std::vector<SpriteBatcher::Quad> quads;
+};
\ No newline at end of file
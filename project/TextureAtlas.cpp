@@ -0,0 +1,147 @@
+#include "TextureAtlas.h"
+#include "TextureManager.h"
+#include "StringUtility.h"
+#include "Logger.h"
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <sstream>
+
+using namespace StringUtility;
+
+namespace {
+
+	// ページの形式（TextureManagerと同じくsRGBとして読む）
+	constexpr DXGI_FORMAT kPageFormat = DXGI_FORMAT_R8G8B8A8_UNORM_SRGB;
+}
+
+bool TextureAtlas::Bake(const std::vector<std::string> &filePaths, const std::string &atlasFilePath, const AtlasPacker::Settings &settings)
+{
+	std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	//----画像を読み込み、1画素4byteの形式にそろえる----
+	std::vector<DirectX::ScratchImage> images(filePaths.size());
+	std::vector<AtlasPacker::Extent> sizes(filePaths.size());
+	for (size_t i = 0; i < filePaths.size(); ++i) {
+		DirectX::ScratchImage loaded {};
+		HRESULT hr = DirectX::LoadFromWICFile(ConvertString(filePaths[i]).c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, loaded);
+		if (FAILED(hr)) {
+			return false;
+		}
+		if (loaded.GetMetadata().format == kPageFormat) {
+			images[i] = std::move(loaded);
+		} else {
+			hr = DirectX::Convert(*loaded.GetImage(0, 0, 0), kPageFormat, DirectX::TEX_FILTER_DEFAULT, DirectX::TEX_THRESHOLD_DEFAULT, images[i]);
+			if (FAILED(hr)) {
+				return false;
+			}
+		}
+		sizes[i] = { uint32_t(images[i].GetMetadata().width), uint32_t(images[i].GetMetadata().height) };
+	}
+
+	//----配置を決める----
+	AtlasPacker packer;
+	if (!packer.Pack(sizes, settings)) {
+		return false;
+	}
+	const std::vector<AtlasPacker::Placement> &placements = packer.GetPlacements();
+	const std::vector<AtlasPacker::Extent> &pageSizes = packer.GetPages();
+
+	//----ページごとに画像を写し、ミップマップを作ってDDSで書き出す----
+	std::string atlasFileName = std::filesystem::path(atlasFilePath).filename().string();
+	std::ofstream file(atlasFilePath);
+	if (!file.is_open()) {
+		return false;
+	}
+	for (uint32_t page = 0; page < pageSizes.size(); ++page) {
+		DirectX::ScratchImage pageImage {};
+		HRESULT hr = pageImage.Initialize2D(kPageFormat, pageSizes[page].width, pageSizes[page].height, 1, 1);
+		if (FAILED(hr)) {
+			return false;
+		}
+		// 何も置かない所は透明にする
+		std::memset(pageImage.GetPixels(), 0, pageImage.GetPixelsSize());
+
+		const DirectX::Image *destination = pageImage.GetImage(0, 0, 0);
+		for (size_t i = 0; i < placements.size(); ++i) {
+			if (placements[i].page != page) {
+				continue;
+			}
+			const DirectX::Image *source = images[i].GetImage(0, 0, 0);
+			AtlasPacker::CopyWithPadding(source->pixels, source->rowPitch, sizes[i], destination->pixels, destination->rowPitch, placements[i], settings.padding);
+		}
+
+		// 配置はミップの最後の段のブロックに揃えてあるので、ボックスフィルタなら縮小しても隣の画像と混ざらない
+		DirectX::ScratchImage mipImages {};
+		hr = DirectX::GenerateMipMaps(*destination, DirectX::TEX_FILTER_BOX | DirectX::TEX_FILTER_SRGB, settings.mipLevels, mipImages);
+		if (FAILED(hr)) {
+			return false;
+		}
+
+		std::string pageFileName = std::format("{}.{}.dds", atlasFileName, page);
+		hr = DirectX::SaveToDDSFile(mipImages.GetImages(), mipImages.GetImageCount(), mipImages.GetMetadata(), DirectX::DDS_FLAGS_NONE,
+			ConvertString(std::filesystem::path(atlasFilePath).parent_path().string() + "/" + pageFileName).c_str());
+		if (FAILED(hr)) {
+			return false;
+		}
+		file << "page " << pageFileName << "\n";
+	}
+
+	//----切り出し範囲の一覧を書き出す（名前 ページ 左上x 左上y 幅 高さ）----
+	for (size_t i = 0; i < placements.size(); ++i) {
+		file << "region " << std::filesystem::path(filePaths[i]).stem().string() << " " << placements[i].page << " "
+			<< placements[i].x << " " << placements[i].y << " " << sizes[i].width << " " << sizes[i].height << "\n";
+	}
+
+	std::chrono::duration<double, std::milli> bakeTime = std::chrono::steady_clock::now() - startTime;
+	const AtlasPacker::Statistics &statistics = packer.GetStatistics();
+	Logger::Log(std::format("TextureAtlas: {} {} images -> {} pages occupancy {:.3f} {:.3f}ms\n",
+		atlasFilePath, filePaths.size(), statistics.pageCount, statistics.occupancy, bakeTime.count()));
+	return true;
+}
+
+bool TextureAtlas::Load(const std::string &atlasFilePath)
+{
+	//----ファイルを開く----
+	std::ifstream file(atlasFilePath);
+	if (!file.is_open()) {
+		return false;
+	}
+	std::string directoryPath = std::filesystem::path(atlasFilePath).parent_path().string();
+
+	//----1行ずつ読んで、ページの登録と切り出し範囲の追加を行う----
+	std::string line;
+	while (std::getline(file, line)) {
+		std::string identifier;
+		std::istringstream s(line);
+		s >> identifier;
+
+		if (identifier == "page") {
+			std::string pageFileName;
+			s >> pageFileName;
+			std::string pageFilePath = directoryPath + "/" + pageFileName;
+
+			// ミップマップはベイク時に作ってあるのでそのまま登録する
+			DirectX::ScratchImage mipImages {};
+			HRESULT hr = DirectX::LoadFromDDSFile(ConvertString(pageFilePath).c_str(), DirectX::DDS_FLAGS_NONE, nullptr, mipImages);
+			if (FAILED(hr)) {
+				return false;
+			}
+			pages.push_back(TextureManager::GetInstance()->RegisterTexture(pageFilePath, mipImages));
+		} else if (identifier == "region") {
+			std::string name;
+			uint32_t page = 0;
+			Region region {};
+			s >> name >> page >> region.leftTop.x >> region.leftTop.y >> region.size.x >> region.size.y;
+			assert(page < pages.size()); // ページより前に書かれた範囲
+			assert(!regions.Find(name).IsValid()); // 同じ名前の画像が2つある
+			region.texture = pages[page];
+			regions.Add(name, region);
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
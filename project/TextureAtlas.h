@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "MathTypes.h"
+#include "AssetRegistry.h"
+#include "AtlasPacker.h"
+
+// テクスチャアトラス
+// 小さな画像を詰めた大きなページ（テクスチャ）と、名前で引ける切り出し範囲の組
+// Bakeで画像ファイルを詰めてページ（ミップマップ込みのDDS）と一覧ファイル（.atlas）を書き出し、Loadで読み込んでTextureManagerに登録する
+// 同じページの画像は同じテクスチャなので、SpriteBatchでは1回のDrawでまとめて描ける
+class TextureAtlas
+{
+public:
+
+	// 名前で引ける切り出し範囲
+	struct Region
+	{
+		AssetHandle texture; // ページのテクスチャ
+		math::Vector2 leftTop; // 切り出す左上（ピクセル）
+		math::Vector2 size; // 切り出す大きさ（ピクセル）
+	};
+
+	/// <summary>
+	/// 画像ファイルを詰めてページと一覧ファイルを書き出す
+	/// </summary>
+	/// <param name="filePaths">詰める画像ファイルのパス（拡張子を除いたファイル名が切り出し範囲の名前になる）</param>
+	/// <param name="atlasFilePath">一覧ファイルのパス（ページは「一覧ファイルのパス.ページ番号.dds」に書き出す）</param>
+	/// <param name="settings">詰め方の設定</param>
+	/// <returns>書き出せたらtrue</returns>
+	static bool Bake(const std::vector<std::string> &filePaths, const std::string &atlasFilePath, const AtlasPacker::Settings &settings = {});
+
+	/// <summary>
+	/// 一覧ファイルとページを読み込み、ページをTextureManagerに登録する
+	/// </summary>
+	/// <param name="atlasFilePath">Bakeで書き出した一覧ファイルのパス</param>
+	/// <returns>読み込めたらtrue</returns>
+	bool Load(const std::string &atlasFilePath);
+
+	// 名前から切り出し範囲を取得（なければnullptr）
+	const Region *FindRegion(const std::string &name) const { return regions.Get(regions.Find(name)); }
+
+	// ページのテクスチャ
+	const std::vector<AssetHandle> &GetPages() const { return pages; }
+
+	// 切り出し範囲の数
+	size_t GetRegionCount() const { return regions.GetCount(); }
+
+private:
+
+	// 名前から引く切り出し範囲
+	AssetRegistry<Region> regions;
+	std::vector<AssetHandle> pages;
+};
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "TextureManager.h"
 #include "DirectXCommon.h"
 #include "StringUtility.h"
+#include "Logger.h"
 #include <cassert>
+#include <cstring>
+#include <format>
 
 using namespace StringUtility;
 
@@ -9,6 +12,11 @@ TextureManager *TextureManager::instance = nullptr;
 // ImGuiで0番を使用するために、1番から使用
 uint32_t TextureManager::kSRVIndexTop = 1;
 
+namespace {
+	// 読み込めなかったテクスチャの代わりに使う白いテクスチャの登録名（ファイルパスと重ならない名前）
+	const char *const kDefaultTextureName = "<default:white>";
+}
+
 TextureManager *TextureManager::GetInstance()
 {
 	if (instance == nullptr) {
@@ -24,42 +32,61 @@ void TextureManager::Finalize() {
 
 void TextureManager::Initialize() {
 	// SRVの数と個数
-	textureDatas.reserve(DirectXCommon::kMaxSRVCount);
+	textures.Reserve(DirectXCommon::kMaxSRVCount);
 }
 
-void TextureManager::LoadTexture(const std::string &filePath) {
+AssetHandle TextureManager::LoadTexture(const std::string &filePath) {
 
 	// 読み込み済みテクスチャを検索
-	auto it = std::find_if(
-		textureDatas.begin(),
-		textureDatas.end(),
-		[&](TextureData &textureData) { return textureData.filePath == filePath; }
-	);
-	if (it != textureDatas.end()) {
+	AssetHandle existing = textures.Find(filePath);
+	if (existing.IsValid()) {
 		// 読み込み済みなら早期return
-		return;
+		return existing;
 	}
 
 	// テクスチャ枚数上限チェック
-	assert(textureDatas.size() + kSRVIndexTop < dxCommon_->kMaxSRVCount);
+	assert(textures.GetSlotCount() + kSRVIndexTop < dxCommon_->kMaxSRVCount);
+
+	// mtlにmap_Kdが無い場合はパスが空になる
+	if (filePath.empty()) {
+		return LoadDefaultTexture();
+	}
 
 	// テクスチャファイルを読んでプログラムで扱えるようにする
 	DirectX::ScratchImage image {};
 	std::wstring filePathW = ConvertString(filePath);
 	HRESULT hr = DirectX::LoadFromWICFile(filePathW.c_str(), DirectX::WIC_FLAGS_FORCE_SRGB, nullptr, image);
-	assert(SUCCEEDED(hr));
+	if (FAILED(hr)) {
+		// ファイルが無い・読めない場合は止めずに白いテクスチャで代用する（mtlが参照する画像の置き忘れなど）
+		Logger::Log(std::format("TextureManager: failed to load {} (hr=0x{:08X}), using the default texture\n", filePath, static_cast<uint32_t>(hr)));
+		return LoadDefaultTexture();
+	}
 
 	// ミップマップの作成
 	DirectX::ScratchImage mipImages {};
 	hr = DirectX::GenerateMipMaps(image.GetImages(), image.GetImageCount(), image.GetMetadata(), DirectX::TEX_FILTER_SRGB, 0, mipImages);
 	assert(SUCCEEDED(hr));
 
+	return RegisterTexture(filePath, mipImages);
+}
+
+AssetHandle TextureManager::RegisterTexture(const std::string &name, const DirectX::ScratchImage &mipImages)
+{
+	// 登録済みなら早期return
+	AssetHandle existing = textures.Find(name);
+	if (existing.IsValid()) {
+		return existing;
+	}
+
+	// テクスチャ枚数上限チェック
+	assert(textures.GetSlotCount() + kSRVIndexTop < dxCommon_->kMaxSRVCount);
+
 	// テクスチャデータを追加
-	textureDatas.resize(textureDatas.size() + 1);
+	AssetHandle handle = textures.Add(name, TextureData {});
 	// 追加したテクスチャデータの参照を取得する
-	TextureData &textureData = textureDatas.back();
+	TextureData &textureData = *textures.Get(handle);
 
-	textureData.filePath = filePath;
+	textureData.filePath = name;
 	textureData.metadata = mipImages.GetMetadata();
 	textureData.resource = dxCommon_->CreateTextureResource(mipImages.GetMetadata());
 
@@ -67,7 +94,7 @@ void TextureManager::LoadTexture(const std::string &filePath) {
 	textureData.intermediateResource = dxCommon_->UploadTextureData(textureData.resource.Get(), mipImages);
 
 	// テクスチャデータの要素数番号からSRVのインデックスを計算する
-	uint32_t srvIndex = static_cast<uint32_t>(textureDatas.size() - 1) + kSRVIndexTop;
+	uint32_t srvIndex = handle.index + kSRVIndexTop;
 
 	textureData.srvHandleCPU = dxCommon_->GetSRVCPUDescriptorHandle(srvIndex);
 	textureData.srvHandleGPU = dxCommon_->GetSRVGPUDescriptorHandle(srvIndex);
@@ -78,27 +105,42 @@ void TextureManager::LoadTexture(const std::string &filePath) {
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	srvDesc.Texture2D.MipLevels = UINT(textureData.metadata.mipLevels);
 	dxCommon_->GetDevice()->CreateShaderResourceView(textureData.resource.Get(), &srvDesc, textureData.srvHandleCPU);
+
+	return handle;
 }
 
-void TextureManager::ReleaseIntermediateResources()
+AssetHandle TextureManager::LoadDefaultTexture()
 {
-	for (size_t i = 0; i < textureDatas.size(); ++i) {
-		textureDatas[i].intermediateResource.Reset();
+	// 作成済みならそのハンドル
+	AssetHandle existing = textures.Find(kDefaultTextureName);
+	if (existing.IsValid()) {
+		return existing;
 	}
+
+	// 1x1の白（ミップマップは不要）
+	DirectX::ScratchImage image {};
+	HRESULT hr = image.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, 1, 1, 1, 1);
+	assert(SUCCEEDED(hr));
+	std::memset(image.GetPixels(), 0xFF, image.GetPixelsSize());
+
+	return RegisterTexture(kDefaultTextureName, image);
+}
+
+void TextureManager::ReleaseIntermediateResources()
+{
+	// 転送コマンドを積んだフレームがGPUで処理中かもしれないので、終わってから解放させる
+	textures.ForEach([this](TextureData &textureData) {
+		dxCommon_->DeferRelease(std::move(textureData.intermediateResource));
+		});
 }
 
 uint32_t TextureManager::GetTextureIndexByFilePath(const std::string &filePath)
 {
 	// 読み込む済みテクスチャデータを検索
-	auto it = std::find_if(
-		textureDatas.begin(),
-		textureDatas.end(),
-		[&](TextureData &textureData) { return textureData.filePath == filePath; }
-	);
-	if (it != textureDatas.end()) {
-		// 読み込み済みなら要素番号を返す
-		uint32_t textureIndex = static_cast<uint32_t>(std::distance(textureDatas.begin(), it));
-		return textureIndex;
+	AssetHandle handle = textures.Find(filePath);
+	if (handle.IsValid()) {
+		// 読み込み済みならスロット番号を返す
+		return handle.index;
 	}
 
 	assert(0);
@@ -108,12 +150,30 @@ uint32_t TextureManager::GetTextureIndexByFilePath(const std::string &filePath)
 D3D12_GPU_DESCRIPTOR_HANDLE TextureManager::GetSrvHandleGPU(uint32_t textureIndex)
 {
 	// 範囲外指定違反チェック
-	assert(textureIndex < textureDatas.size());
+	assert(textureIndex < textures.GetSlotCount());
 
-	TextureData &textureData = textureDatas[textureIndex];
+	TextureData &textureData = textures.GetByIndex(textureIndex);
 	return textureData.srvHandleGPU;
 }
 
+D3D12_GPU_DESCRIPTOR_HANDLE TextureManager::GetSrvHandleGPU(AssetHandle textureHandle)
+{
+	// 無効なハンドル違反チェック
+	TextureData *textureData = textures.Get(textureHandle);
+	assert(textureData);
+
+	return textureData->srvHandleGPU;
+}
+
+ID3D12Resource *TextureManager::GetResource(AssetHandle textureHandle)
+{
+	// 無効なハンドル違反チェック
+	TextureData *textureData = textures.Get(textureHandle);
+	assert(textureData);
+
+	return textureData->resource.Get();
+}
+
 void TextureManager::SetDirectXCommon(DirectXCommon *dxCommon) {
 	dxCommon_ = dxCommon;
 }
@@ -121,8 +181,17 @@ void TextureManager::SetDirectXCommon(DirectXCommon *dxCommon) {
 const DirectX::TexMetadata &TextureManager::GetMetaData(uint32_t textureIndex)
 {
 	// 範囲外指定違反チェック
-	assert(textureIndex < textureDatas.size());
+	assert(textureIndex < textures.GetSlotCount());
 
-	TextureData &textureData = textureDatas[textureIndex];
+	TextureData &textureData = textures.GetByIndex(textureIndex);
 	return textureData.metadata;
+}
+
+const DirectX::TexMetadata &TextureManager::GetMetaData(AssetHandle textureHandle)
+{
+	// 無効なハンドル違反チェック
+	TextureData *textureData = textures.Get(textureHandle);
+	assert(textureData);
+
+	return textureData->metadata;
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <string>
 #include "externals/DirectXTex/DirectXTex.h"
 #include "externals/DirectXTex/d3dx12.h"
+#include "AssetRegistry.h"
 
 class DirectXCommon;
 
@@ -21,20 +22,38 @@ public:
 	/// テクスチャファイルの読み込み
 	/// </summary>
 	/// <param name="filePath">テクスチャファイルのパス</param>
-	void LoadTexture(const std::string &filePath);
+	/// <returns>テクスチャのハンドル（読み込み済みならそのハンドル。パスが空・読み込めない場合は白いテクスチャ）</returns>
+	AssetHandle LoadTexture(const std::string &filePath);
+
+	/// <summary>
+	/// メモリ上で作った画像をテクスチャとして登録する（アトラスのページなど）
+	/// </summary>
+	/// <param name="name">登録名（ファイルパスと同じくGetTextureHandleで引ける）</param>
+	/// <param name="mipImages">ミップマップまで作った画像</param>
+	/// <returns>テクスチャのハンドル（登録済みならそのハンドル）</returns>
+	AssetHandle RegisterTexture(const std::string &name, const DirectX::ScratchImage &mipImages);
 
 	void ReleaseIntermediateResources();
 
 	// SRVインデックスの開始番号
 	uint32_t GetTextureIndexByFilePath(const std::string &filePath);
 
+	// ファイルパスからテクスチャのハンドルを取得（読み込んでいなければ無効なハンドル）
+	AssetHandle GetTextureHandle(const std::string &filePath) const { return textures.Find(filePath); }
+
 	// テクスチャ番号からGPUハンドルを取得
 	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(uint32_t textureIndex);
+	// テクスチャのハンドルからGPUハンドルを取得
+	D3D12_GPU_DESCRIPTOR_HANDLE GetSrvHandleGPU(AssetHandle textureHandle);
 
 	void SetDirectXCommon(DirectXCommon *dxCommon);
 
+	// テクスチャのハンドルからリソースを取得（内容を書き換える場合用）
+	ID3D12Resource *GetResource(AssetHandle textureHandle);
+
 	// メタデータを取得
 	const DirectX::TexMetadata &GetMetaData(uint32_t textureIndex);
+	const DirectX::TexMetadata &GetMetaData(AssetHandle textureHandle);
 
 private:
 	static TextureManager *instance;
@@ -44,6 +63,9 @@ private:
 	TextureManager(TextureManager &) = delete;
 	TextureManager &operator=(TextureManager &) = delete;
 
+	// 読み込めなかった場合に代わりに使う1x1の白いテクスチャを取得（初回に作成する）
+	AssetHandle LoadDefaultTexture();
+
 private:
 	// テクスチャ1枚分のデータ
 	struct TextureData {
@@ -55,8 +77,8 @@ private:
 		D3D12_GPU_DESCRIPTOR_HANDLE srvHandleGPU;
 	};
 
-	// テクスチャデータ
-	std::vector<TextureData> textureDatas;
+	// テクスチャデータ（スロット番号がテクスチャ番号。SRVのインデックスはkSRVIndexTopからの連番）
+	AssetRegistry<TextureData> textures;
 
 	DirectXCommon *dxCommon_ = nullptr;
 
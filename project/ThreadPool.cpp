@@ -0,0 +1,108 @@
+#include "ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+	if (threadCount == 0) {
+		// メインスレッドの分を1つ空けておく
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1u;
+	}
+
+	workers.reserve(threadCount);
+	for (uint32_t i = 0; i < threadCount; ++i) {
+		workers.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	condition.notify_all();
+	for (std::thread &worker : workers) {
+		worker.join();
+	}
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	condition.notify_one();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)> &function)
+{
+	chunkSize = std::max<size_t>(chunkSize, 1);
+	size_t chunkCount = (count + chunkSize - 1) / chunkSize;
+
+	// 分ける意味がない場合と、ワーカースレッドから呼ばれた場合（待つと詰まる）はその場で処理する
+	if (chunkCount <= 1 || workers.empty() || IsWorkerThread()) {
+		if (count > 0) {
+			function(0, count);
+		}
+		return;
+	}
+
+	// 各スレッドが次のチャンク番号を取り合って処理する
+	struct Progress
+	{
+		std::atomic<size_t> nextChunk { 0 };
+		std::atomic<size_t> doneChunks { 0 };
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+	std::shared_ptr<Progress> progress = std::make_shared<Progress>();
+
+	// functionは呼び出し元が待っている間しか参照しない（遅れて始まったタスクはチャンクが残っていないので触らない）
+	auto run = [progress, chunkCount, chunkSize, count, &function]() {
+		for (size_t chunk = progress->nextChunk.fetch_add(1); chunk < chunkCount; chunk = progress->nextChunk.fetch_add(1)) {
+			size_t begin = chunk * chunkSize;
+			function(begin, std::min(begin + chunkSize, count));
+			if (progress->doneChunks.fetch_add(1) + 1 == chunkCount) {
+				std::lock_guard<std::mutex> lock(progress->mutex);
+				progress->condition.notify_all();
+			}
+		}
+		};
+
+	size_t helperCount = std::min(chunkCount - 1, workers.size());
+	for (size_t i = 0; i < helperCount; ++i) {
+		Enqueue(run);
+	}
+	run();
+
+	std::unique_lock<std::mutex> lock(progress->mutex);
+	progress->condition.wait(lock, [&] { return progress->doneChunks.load() == chunkCount; });
+}
+
+bool ThreadPool::IsWorkerThread() const
+{
+	std::thread::id id = std::this_thread::get_id();
+	return std::any_of(workers.begin(), workers.end(), [&](const std::thread &worker) { return worker.get_id() == id; });
+}
+
+void ThreadPool::WorkerMain()
+{
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+			// 終了指示が出ていても、残っている処理は片付けてから抜ける
+			if (tasks.empty()) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
\ No newline at end of file
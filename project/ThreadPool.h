@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+// スレッドプール
+// 登録した処理を固定数のワーカースレッドで順に実行する（ファイル読み込みなどの重い処理をメインループから外す用）
+class ThreadPool
+{
+public:
+
+	/// <summary>
+	/// ワーカースレッドを起動する
+	/// </summary>
+	/// <param name="threadCount">スレッド数。0ならハードウェアのスレッド数-1（最低1）</param>
+	explicit ThreadPool(uint32_t threadCount = 0);
+
+	// 登録済みの処理をすべて終えてからスレッドを終了する
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool &) = delete;
+	ThreadPool &operator=(const ThreadPool &) = delete;
+
+	/// <summary>
+	/// 処理を登録する（登録順に取り出される）
+	/// </summary>
+	/// <param name="task">ワーカースレッドで実行する処理</param>
+	void Enqueue(std::function<void()> task);
+
+	/// <summary>
+	/// [0, count)をchunkSizeごとに分けて並列に処理し、すべて終わるまで待つ（呼び出し元のスレッドも処理する）
+	/// </summary>
+	/// <param name="count">要素数</param>
+	/// <param name="chunkSize">1回に処理する要素数</param>
+	/// <param name="function">[begin, end)を処理する関数</param>
+	void ParallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)> &function);
+
+	// ワーカースレッド数を取得
+	uint32_t GetThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+	// 呼び出し元がこのプールのワーカースレッドか
+	bool IsWorkerThread() const;
+
+private:
+
+	// ワーカースレッドの処理
+	void WorkerMain();
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping = false;
+};
\ No newline at end of file
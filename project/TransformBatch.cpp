@@ -0,0 +1,248 @@
+#include "TransformBatch.h"
+#include "MathFunctions.h"
+#include "ThreadPool.h"
+#include <cmath>
+#include <cassert>
+#include <cstdint>
+#include <algorithm>
+
+#if MATH_USE_SSE
+#include <emmintrin.h>
+#endif
+
+namespace math {
+
+	namespace {
+
+		// 書き込み先のindex番目の行列
+		inline Matrix4x4 &ElementAt(Matrix4x4 *base, size_t stride, size_t index)
+		{
+			return *reinterpret_cast<Matrix4x4 *>(reinterpret_cast<uint8_t *>(base) + stride * index);
+		}
+
+#if MATH_USE_SSE
+		inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+		{
+			return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+		}
+
+		// 4つの角度のsinとcosを同時に求める
+		// [-π/2, π/2]に折り返してからテイラー展開する（std::sin・std::cosとの差は2e-7程度）
+		void SinCos(__m128 x, __m128 &sinX, __m128 &cosX)
+		{
+			const float kPi = 3.14159265358979f;
+
+			// [-π, π]へ（2πを2つに分けて引き、桁落ちを抑える）
+			__m128 quotient = _mm_cvtepi32_ps(_mm_cvtps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.0f / (2.0f * kPi)))));
+			x = _mm_sub_ps(x, _mm_mul_ps(quotient, _mm_set1_ps(6.28125f)));
+			x = _mm_sub_ps(x, _mm_mul_ps(quotient, _mm_set1_ps(1.9353071795864769253e-3f)));
+
+			// [-π/2, π/2]へ折り返す（sinはそのまま、cosは符号が反転する）
+			__m128 upper = _mm_cmpgt_ps(x, _mm_set1_ps(kPi * 0.5f));
+			__m128 lower = _mm_cmplt_ps(x, _mm_set1_ps(-kPi * 0.5f));
+			x = Select(upper, _mm_sub_ps(_mm_set1_ps(kPi), x), Select(lower, _mm_sub_ps(_mm_set1_ps(-kPi), x), x));
+			__m128 cosSign = Select(_mm_or_ps(upper, lower), _mm_set1_ps(-1.0f), _mm_set1_ps(1.0f));
+
+			__m128 x2 = _mm_mul_ps(x, x);
+			__m128 s = _mm_set1_ps(-1.0f / 39916800.0f);
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f / 362880.0f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.0f / 5040.0f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f / 120.0f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(-1.0f / 6.0f));
+			s = _mm_add_ps(_mm_mul_ps(s, x2), _mm_set1_ps(1.0f));
+			sinX = _mm_mul_ps(s, x);
+
+			__m128 c = _mm_set1_ps(1.0f / 479001600.0f);
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.0f / 3628800.0f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f / 40320.0f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.0f / 720.0f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f / 24.0f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(-1.0f / 2.0f));
+			c = _mm_add_ps(_mm_mul_ps(c, x2), _mm_set1_ps(1.0f));
+			cosX = _mm_mul_ps(c, cosSign);
+		}
+
+		// 4オブジェクト分の成分を読む（端数はfillで埋める）
+		inline __m128 LoadLanes(const std::vector<float> &stream, size_t first, size_t lanes, float fill)
+		{
+			if (lanes == 4) {
+				return _mm_loadu_ps(&stream[first]);
+			}
+			alignas(16) float values[4] = { fill, fill, fill, fill };
+			for (size_t lane = 0; lane < lanes; ++lane) {
+				values[lane] = stream[first + lane];
+			}
+			return _mm_load_ps(values);
+		}
+
+		// 4オブジェクト分の行列（要素ごとに4レーン）を転置して各オブジェクトの行列に書き込む
+		void StoreLanes(const __m128 (&matrices)[4][4], Matrix4x4 *base, size_t stride, size_t first, size_t lanes)
+		{
+			for (int row = 0; row < 4; ++row) {
+				__m128 rows[4] = { matrices[row][0], matrices[row][1], matrices[row][2], matrices[row][3] };
+				_MM_TRANSPOSE4_PS(rows[0], rows[1], rows[2], rows[3]);
+				for (size_t lane = 0; lane < lanes; ++lane) {
+					_mm_store_ps(ElementAt(base, stride, first + lane).m[row], rows[lane]);
+				}
+			}
+		}
+#endif
+
+		// [begin, end)のオブジェクトの行列を作る（viewProjectionがnullptrならワールド行列のみ）
+		void MakeMatricesRange(const TransformStreams &transforms, const Matrix4x4 *viewProjection,
+			Matrix4x4 *worldMatrices, Matrix4x4 *wvpMatrices, size_t stride, size_t begin, size_t end)
+		{
+#if MATH_USE_SSE
+			// ビュー射影行列の各要素を4レーンに広げておく
+			__m128 vp[4][4] {};
+			if (viewProjection) {
+				for (int row = 0; row < 4; ++row) {
+					for (int col = 0; col < 4; ++col) {
+						vp[row][col] = _mm_set1_ps(viewProjection->m[row][col]);
+					}
+				}
+			}
+
+			const __m128 zero = _mm_setzero_ps();
+			const __m128 one = _mm_set1_ps(1.0f);
+
+			// 4オブジェクトずつ、MakeAffineMatrixと同じ式をレーンごとに計算する
+			for (size_t first = begin; first < end; first += 4) {
+				size_t lanes = std::min<size_t>(4, end - first);
+
+				__m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+				SinCos(LoadLanes(transforms.rotateX, first, lanes, 0.0f), sinX, cosX);
+				SinCos(LoadLanes(transforms.rotateY, first, lanes, 0.0f), sinY, cosY);
+				SinCos(LoadLanes(transforms.rotateZ, first, lanes, 0.0f), sinZ, cosZ);
+				__m128 scaleX = LoadLanes(transforms.scaleX, first, lanes, 1.0f);
+				__m128 scaleY = LoadLanes(transforms.scaleY, first, lanes, 1.0f);
+				__m128 scaleZ = LoadLanes(transforms.scaleZ, first, lanes, 1.0f);
+
+				__m128 sinXsinY = _mm_mul_ps(sinX, sinY);
+				__m128 cosXsinY = _mm_mul_ps(cosX, sinY);
+
+				__m128 world[4][4];
+				world[0][0] = _mm_mul_ps(scaleX, _mm_mul_ps(cosY, cosZ));
+				world[0][1] = _mm_mul_ps(scaleX, _mm_mul_ps(cosY, sinZ));
+				world[0][2] = _mm_mul_ps(scaleX, _mm_sub_ps(zero, sinY));
+				world[0][3] = zero;
+
+				world[1][0] = _mm_mul_ps(scaleY, _mm_sub_ps(_mm_mul_ps(sinXsinY, cosZ), _mm_mul_ps(cosX, sinZ)));
+				world[1][1] = _mm_mul_ps(scaleY, _mm_add_ps(_mm_mul_ps(sinXsinY, sinZ), _mm_mul_ps(cosX, cosZ)));
+				world[1][2] = _mm_mul_ps(scaleY, _mm_mul_ps(sinX, cosY));
+				world[1][3] = zero;
+
+				world[2][0] = _mm_mul_ps(scaleZ, _mm_add_ps(_mm_mul_ps(cosXsinY, cosZ), _mm_mul_ps(sinX, sinZ)));
+				world[2][1] = _mm_mul_ps(scaleZ, _mm_sub_ps(_mm_mul_ps(cosXsinY, sinZ), _mm_mul_ps(sinX, cosZ)));
+				world[2][2] = _mm_mul_ps(scaleZ, _mm_mul_ps(cosX, cosY));
+				world[2][3] = zero;
+
+				world[3][0] = LoadLanes(transforms.translateX, first, lanes, 0.0f);
+				world[3][1] = LoadLanes(transforms.translateY, first, lanes, 0.0f);
+				world[3][2] = LoadLanes(transforms.translateZ, first, lanes, 0.0f);
+				world[3][3] = one;
+
+				StoreLanes(world, worldMatrices, stride, first, lanes);
+
+				if (viewProjection) {
+					// world * viewProjection（4列目は0,0,0,1なので、その項は3行目のみ）
+					__m128 wvp[4][4];
+					for (int row = 0; row < 4; ++row) {
+						for (int col = 0; col < 4; ++col) {
+							__m128 sum = _mm_mul_ps(world[row][0], vp[0][col]);
+							sum = _mm_add_ps(sum, _mm_mul_ps(world[row][1], vp[1][col]));
+							sum = _mm_add_ps(sum, _mm_mul_ps(world[row][2], vp[2][col]));
+							if (row == 3) {
+								sum = _mm_add_ps(sum, vp[3][col]);
+							}
+							wvp[row][col] = sum;
+						}
+					}
+					StoreLanes(wvp, wvpMatrices, stride, first, lanes);
+				}
+			}
+#else
+			for (size_t i = begin; i < end; ++i) {
+				Matrix4x4 world = MakeAffineMatrix(
+					{ transforms.scaleX[i], transforms.scaleY[i], transforms.scaleZ[i] },
+					{ transforms.rotateX[i], transforms.rotateY[i], transforms.rotateZ[i] },
+					{ transforms.translateX[i], transforms.translateY[i], transforms.translateZ[i] });
+				ElementAt(worldMatrices, stride, i) = world;
+				if (viewProjection) {
+					ElementAt(wvpMatrices, stride, i) = Multiply(world, *viewProjection);
+				}
+			}
+#endif
+		}
+
+		// チャンクに分けて（threadPoolがあれば並列に）処理する
+		void MakeMatrices(const TransformStreams &transforms, const Matrix4x4 *viewProjection,
+			Matrix4x4 *worldMatrices, Matrix4x4 *wvpMatrices, size_t stride, ThreadPool *threadPool)
+		{
+			assert(stride % alignof(Matrix4x4) == 0);
+
+			size_t count = transforms.GetCount();
+			auto makeRange = [&](size_t begin, size_t end) {
+				MakeMatricesRange(transforms, viewProjection, worldMatrices, wvpMatrices, stride, begin, end);
+				};
+
+			if (threadPool) {
+				threadPool->ParallelFor(count, kTransformBatchChunkSize, makeRange);
+			} else {
+				makeRange(0, count);
+			}
+		}
+	}
+
+	void TransformStreams::Resize(size_t count)
+	{
+		scaleX.resize(count, 1.0f);
+		scaleY.resize(count, 1.0f);
+		scaleZ.resize(count, 1.0f);
+		rotateX.resize(count, 0.0f);
+		rotateY.resize(count, 0.0f);
+		rotateZ.resize(count, 0.0f);
+		translateX.resize(count, 0.0f);
+		translateY.resize(count, 0.0f);
+		translateZ.resize(count, 0.0f);
+	}
+
+	void TransformStreams::PushBack(const Transform &transform)
+	{
+		Resize(GetCount() + 1);
+		Set(GetCount() - 1, transform);
+	}
+
+	void TransformStreams::Set(size_t index, const Transform &transform)
+	{
+		scaleX[index] = transform.scale.x;
+		scaleY[index] = transform.scale.y;
+		scaleZ[index] = transform.scale.z;
+		rotateX[index] = transform.rotate.x;
+		rotateY[index] = transform.rotate.y;
+		rotateZ[index] = transform.rotate.z;
+		translateX[index] = transform.translate.x;
+		translateY[index] = transform.translate.y;
+		translateZ[index] = transform.translate.z;
+	}
+
+	Transform TransformStreams::Get(size_t index) const
+	{
+		return {
+			{ scaleX[index], scaleY[index], scaleZ[index] },
+			{ rotateX[index], rotateY[index], rotateZ[index] },
+			{ translateX[index], translateY[index], translateZ[index] },
+		};
+	}
+
+	void MakeAffineMatrices(const TransformStreams &transforms, Matrix4x4 *worldMatrices, size_t stride, ThreadPool *threadPool)
+	{
+		MakeMatrices(transforms, nullptr, worldMatrices, nullptr, stride, threadPool);
+	}
+
+	void MakeWorldViewProjectionMatrices(const TransformStreams &transforms, const Matrix4x4 &viewProjection,
+		Matrix4x4 *worldMatrices, Matrix4x4 *wvpMatrices, size_t stride, ThreadPool *threadPool)
+	{
+		MakeMatrices(transforms, &viewProjection, worldMatrices, wvpMatrices, stride, threadPool);
+	}
+}
\ No newline at end of file
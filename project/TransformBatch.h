@@ -0,0 +1,62 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "MathTypes.h"
+
+class ThreadPool;
+
+namespace math
+{
+    // 大量のオブジェクトのTransformを成分ごとの配列（SoA）で持つ
+    // 4オブジェクト分の同じ成分を1回で読めるので、行列をまとめて作るときにSIMDで計算できる
+    struct TransformStreams
+    {
+        std::vector<float> scaleX;
+        std::vector<float> scaleY;
+        std::vector<float> scaleZ;
+        std::vector<float> rotateX;
+        std::vector<float> rotateY;
+        std::vector<float> rotateZ;
+        std::vector<float> translateX;
+        std::vector<float> translateY;
+        std::vector<float> translateZ;
+
+        // オブジェクト数
+        size_t GetCount() const { return scaleX.size(); }
+
+        // オブジェクト数を変える（増えた分は scale 1, rotate 0, translate 0）
+        void Resize(size_t count);
+
+        // 末尾に追加
+        void PushBack(const Transform &transform);
+
+        // 1オブジェクト分の読み書き
+        void Set(size_t index, const Transform &transform);
+        Transform Get(size_t index) const;
+    };
+
+    // 行列をまとめて作るときに1回で処理するオブジェクト数（並列化するときの単位）
+    constexpr size_t kTransformBatchChunkSize = 1024;
+
+    /// <summary>
+    /// ワールド行列をまとめて作る（各オブジェクトでMakeAffineMatrixを呼ぶのと同じ）
+    /// </summary>
+    /// <param name="transforms">オブジェクトのTransform</param>
+    /// <param name="worldMatrices">ワールド行列の書き込み先</param>
+    /// <param name="stride">書き込み先の要素の間隔（byte、16の倍数）。構造体の配列のメンバへ直接書くとき用</param>
+    /// <param name="threadPool">指定するとチャンクごとに並列に処理する</param>
+    void MakeAffineMatrices(const TransformStreams &transforms, Matrix4x4 *worldMatrices,
+        size_t stride = sizeof(Matrix4x4), ThreadPool *threadPool = nullptr);
+
+    /// <summary>
+    /// ワールド行列とWVP行列をまとめて作る
+    /// </summary>
+    /// <param name="transforms">オブジェクトのTransform</param>
+    /// <param name="viewProjection">ビュー行列×射影行列</param>
+    /// <param name="worldMatrices">ワールド行列の書き込み先</param>
+    /// <param name="wvpMatrices">WVP行列の書き込み先</param>
+    /// <param name="stride">書き込み先の要素の間隔（byte、16の倍数）</param>
+    /// <param name="threadPool">指定するとチャンクごとに並列に処理する</param>
+    void MakeWorldViewProjectionMatrices(const TransformStreams &transforms, const Matrix4x4 &viewProjection,
+        Matrix4x4 *worldMatrices, Matrix4x4 *wvpMatrices, size_t stride = sizeof(Matrix4x4), ThreadPool *threadPool = nullptr);
+}
\ No newline at end of file
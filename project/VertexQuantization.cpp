@@ -0,0 +1,217 @@
+#include "VertexQuantization.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+	// UNORM16/SNORM16の最大値
+	constexpr float kUnorm16Max = 65535.0f;
+	constexpr float kSnorm16Max = 32767.0f;
+
+	uint16_t QuantizeUnorm16(float value)
+	{
+		float clamped = std::clamp(value, 0.0f, 1.0f);
+		return static_cast<uint16_t>(clamped * kUnorm16Max + 0.5f);
+	}
+
+	int16_t QuantizeSnorm16(float value)
+	{
+		float clamped = std::clamp(value, -1.0f, 1.0f);
+		return static_cast<int16_t>(std::lround(clamped * kSnorm16Max));
+	}
+
+	// GPUのSNORM→floatの変換と同じ（-32768は-1にする）
+	float DequantizeSnorm16(int16_t value)
+	{
+		return (std::max)(static_cast<float>(value) / kSnorm16Max, -1.0f);
+	}
+
+	// 符号（0は正として扱う）
+	float SignNotZero(float value)
+	{
+		return value >= 0.0f ? 1.0f : -1.0f;
+	}
+}
+
+namespace VertexQuantization {
+
+	uint16_t FloatToHalf(float value)
+	{
+		uint32_t bits = 0;
+		std::memcpy(&bits, &value, sizeof(bits));
+
+		uint32_t sign = (bits >> 16) & 0x8000u;
+		uint32_t exponent = (bits >> 23) & 0xFFu;
+		uint32_t mantissa = bits & 0x7FFFFFu;
+
+		// NaN / 無限大
+		if (exponent == 0xFFu) {
+			return static_cast<uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+		}
+
+		int32_t halfExponent = static_cast<int32_t>(exponent) - 127 + 15;
+
+		// 範囲外は無限大
+		if (halfExponent >= 0x1F) {
+			return static_cast<uint16_t>(sign | 0x7C00u);
+		}
+
+		// 非正規化数（または0）
+		if (halfExponent <= 0) {
+			if (halfExponent < -10) {
+				return static_cast<uint16_t>(sign);
+			}
+			mantissa |= 0x800000u;
+			uint32_t shift = static_cast<uint32_t>(14 - halfExponent);
+			uint32_t halfMantissa = mantissa >> shift;
+			// 最近接偶数丸め
+			uint32_t remainder = mantissa & ((1u << shift) - 1u);
+			uint32_t halfway = 1u << (shift - 1);
+			if (remainder > halfway || (remainder == halfway && (halfMantissa & 1u))) {
+				++halfMantissa;
+			}
+			return static_cast<uint16_t>(sign | halfMantissa);
+		}
+
+		// 正規化数（最近接偶数丸め。繰り上がりは指数部へそのまま伝わる）
+		uint32_t half = sign | (static_cast<uint32_t>(halfExponent) << 10) | (mantissa >> 13);
+		uint32_t remainder = mantissa & 0x1FFFu;
+		if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+			++half;
+		}
+		return static_cast<uint16_t>(half);
+	}
+
+	float HalfToFloat(uint16_t value)
+	{
+		uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+		uint32_t exponent = (value >> 10) & 0x1Fu;
+		uint32_t mantissa = value & 0x3FFu;
+
+		uint32_t bits = 0;
+		if (exponent == 0x1Fu) {
+			// NaN / 無限大
+			bits = sign | 0x7F800000u | (mantissa << 13);
+		} else if (exponent == 0) {
+			if (mantissa == 0) {
+				bits = sign;
+			} else {
+				// 非正規化数は正規化し直す
+				int32_t shift = 0;
+				while ((mantissa & 0x400u) == 0) {
+					mantissa <<= 1;
+					++shift;
+				}
+				mantissa &= 0x3FFu;
+				bits = sign | (static_cast<uint32_t>(127 - 15 + 1 - shift) << 23) | (mantissa << 13);
+			}
+		} else {
+			bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+		}
+
+		float result = 0.0f;
+		std::memcpy(&result, &bits, sizeof(result));
+		return result;
+	}
+
+	math::Vector2 EncodeOctahedral(const math::Vector3 &normal)
+	{
+		float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (length <= 0.0f) {
+			return { 0.0f, 0.0f };
+		}
+		math::Vector2 encoded = { normal.x / length, normal.y / length };
+		// 下半球は対角線で折り返す
+		if (normal.z < 0.0f) {
+			encoded = {
+				(1.0f - std::abs(encoded.y)) * SignNotZero(encoded.x),
+				(1.0f - std::abs(encoded.x)) * SignNotZero(encoded.y) };
+		}
+		return encoded;
+	}
+
+	math::Vector3 DecodeOctahedral(const math::Vector2 &encoded)
+	{
+		math::Vector3 normal = { encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y) };
+		float t = (std::max)(-normal.z, 0.0f);
+		normal.x += normal.x >= 0.0f ? -t : t;
+		normal.y += normal.y >= 0.0f ? -t : t;
+		float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+		return { normal.x / length, normal.y / length, normal.z / length };
+	}
+
+	Model::VertexDecode ComputeVertexDecode(const std::vector<Model::VertexData> &vertices)
+	{
+		Model::VertexDecode decode {};
+		if (vertices.empty()) {
+			return decode;
+		}
+
+		math::Vector3 min = { vertices[0].position.x, vertices[0].position.y, vertices[0].position.z };
+		math::Vector3 max = min;
+		for (const Model::VertexData &vertex : vertices) {
+			min.x = (std::min)(min.x, vertex.position.x);
+			min.y = (std::min)(min.y, vertex.position.y);
+			min.z = (std::min)(min.z, vertex.position.z);
+			max.x = (std::max)(max.x, vertex.position.x);
+			max.y = (std::max)(max.y, vertex.position.y);
+			max.z = (std::max)(max.z, vertex.position.z);
+		}
+
+		// UNORMは0～1で読まれるので、AABBの大きさを掛けて最小値を足せば元の位置になる
+		decode.positionScale = { max.x - min.x, max.y - min.y, max.z - min.z };
+		decode.positionOffset = min;
+		return decode;
+	}
+
+	Model::QuantizedVertexData Encode(const Model::VertexData &vertex, const Model::VertexDecode &decode)
+	{
+		Model::QuantizedVertexData result {};
+
+		//----位置----
+		const float position[3] = { vertex.position.x, vertex.position.y, vertex.position.z };
+		const float scale[3] = { decode.positionScale.x, decode.positionScale.y, decode.positionScale.z };
+		const float offset[3] = { decode.positionOffset.x, decode.positionOffset.y, decode.positionOffset.z };
+		for (uint32_t i = 0; i < 3; ++i) {
+			result.position[i] = scale[i] > 0.0f ? QuantizeUnorm16((position[i] - offset[i]) / scale[i]) : 0;
+		}
+		result.position[3] = UINT16_MAX; // w = 1.0
+
+		//----UV----
+		result.texcoord[0] = FloatToHalf(vertex.texcoord.x);
+		result.texcoord[1] = FloatToHalf(vertex.texcoord.y);
+
+		//----法線----
+		math::Vector2 encoded = EncodeOctahedral(vertex.normal);
+		result.normal[0] = QuantizeSnorm16(encoded.x);
+		result.normal[1] = QuantizeSnorm16(encoded.y);
+
+		return result;
+	}
+
+	Model::VertexData Decode(const Model::QuantizedVertexData &vertex, const Model::VertexDecode &decode)
+	{
+		Model::VertexData result {};
+
+		result.position = {
+			static_cast<float>(vertex.position[0]) / kUnorm16Max * decode.positionScale.x + decode.positionOffset.x,
+			static_cast<float>(vertex.position[1]) / kUnorm16Max * decode.positionScale.y + decode.positionOffset.y,
+			static_cast<float>(vertex.position[2]) / kUnorm16Max * decode.positionScale.z + decode.positionOffset.z,
+			1.0f };
+		result.texcoord = { HalfToFloat(vertex.texcoord[0]), HalfToFloat(vertex.texcoord[1]) };
+		result.normal = DecodeOctahedral({ DequantizeSnorm16(vertex.normal[0]), DequantizeSnorm16(vertex.normal[1]) });
+
+		return result;
+	}
+
+	std::vector<Model::QuantizedVertexData> EncodeVertices(const std::vector<Model::VertexData> &vertices, Model::VertexDecode &decode)
+	{
+		decode = ComputeVertexDecode(vertices);
+		std::vector<Model::QuantizedVertexData> result(vertices.size());
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			result[i] = Encode(vertices[i], decode);
+		}
+		return result;
+	}
+}
\ No newline at end of file
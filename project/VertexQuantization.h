@@ -0,0 +1,59 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include "Model.h"
+
+// 頂点の量子化
+// Model::VertexData(36byte)をModel::QuantizedVertexData(16byte)に圧縮する
+// ・位置   : メッシュのAABBを基準にした16bit UNORM（展開はVSでscale/offsetを掛ける）
+// ・法線   : 八面体エンコードした16bit SNORM×2
+// ・UV     : 16bit浮動小数点×2
+namespace VertexQuantization
+{
+	/// <summary>
+	/// floatを16bit浮動小数点に変換する（最近接丸め）
+	/// </summary>
+	uint16_t FloatToHalf(float value);
+
+	/// <summary>
+	/// 16bit浮動小数点をfloatに変換する
+	/// </summary>
+	float HalfToFloat(uint16_t value);
+
+	/// <summary>
+	/// 単位ベクトルを八面体エンコードする（各要素-1～1）
+	/// </summary>
+	math::Vector2 EncodeOctahedral(const math::Vector3 &normal);
+
+	/// <summary>
+	/// 八面体エンコードされたベクトルを単位ベクトルに戻す
+	/// </summary>
+	math::Vector3 DecodeOctahedral(const math::Vector2 &encoded);
+
+	/// <summary>
+	/// 頂点の位置から展開用のパラメータ（AABB）を求める
+	/// </summary>
+	/// <param name="vertices">頂点</param>
+	Model::VertexDecode ComputeVertexDecode(const std::vector<Model::VertexData> &vertices);
+
+	/// <summary>
+	/// 頂点を量子化する
+	/// </summary>
+	/// <param name="vertex">頂点</param>
+	/// <param name="decode">ComputeVertexDecodeで求めた展開用パラメータ</param>
+	Model::QuantizedVertexData Encode(const Model::VertexData &vertex, const Model::VertexDecode &decode);
+
+	/// <summary>
+	/// 量子化した頂点を元に戻す（VSでの展開と同じ計算）
+	/// </summary>
+	/// <param name="vertex">量子化した頂点</param>
+	/// <param name="decode">展開用パラメータ</param>
+	Model::VertexData Decode(const Model::QuantizedVertexData &vertex, const Model::VertexDecode &decode);
+
+	/// <summary>
+	/// 頂点配列をまとめて量子化する
+	/// </summary>
+	/// <param name="vertices">頂点</param>
+	/// <param name="decode">展開用パラメータの出力先</param>
+	std::vector<Model::QuantizedVertexData> EncodeVertices(const std::vector<Model::VertexData> &vertices, Model::VertexDecode &decode);
+}
\ No newline at end of file
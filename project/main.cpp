@@ -5,6 +5,8 @@
 #include <fstream>
 #include <chrono>
 #include <numbers>
+#include <algorithm>
+#include <cmath>
 
 #include <strsafe.h>
 #include <DbgHelp.h>
@@ -15,6 +17,12 @@
 #include "D3DResourceLeakChecker.h"
 #include "SpriteCommon.h"
 #include "Sprite.h"
+#include "SpriteBatch.h"
+#include "TextureAtlas.h"
+#include "TextRenderer.h"
+#include "ParticleSystem.h"
+#include "ParticleRenderer.h"
+#include "ThreadPool.h"
 #include "MathFunctions.h"
 #include "TextureManager.h"
 #include "Object3dCommon.h"
@@ -22,6 +30,8 @@
 #include "Model.h"
 #include "ModelCommon.h"
 #include "ModelManager.h"
+#include "Camera.h"
+#include "RenderQueue.h"
 
 #pragma comment(lib,"dxguid.lib")
 #pragma comment(lib,"dxcompiler.lib")
@@ -279,6 +289,12 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	SpriteCommon *spriteCommon = new SpriteCommon();
 	spriteCommon->Initialize(dxCommon);
 
+	// ===== 描画キュー =====
+	// Object3dとSpriteの描画をまとめてソートし、ステートの切り替えを減らす
+	RenderQueue *renderQueue = new RenderQueue();
+	object3dCommon->SetRenderQueue(renderQueue);
+	spriteCommon->SetRenderQueue(renderQueue);
+
 	// ===== オーディオ（XAudio2）初期化 =====
 	Microsoft::WRL::ComPtr<IXAudio2> xAudio2;
 	IXAudio2MasteringVoice *masterVoice = nullptr;
@@ -303,7 +319,15 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// ===== モデルのロード =====
 	// ModelManager::GetInstance()->LoadModel("resources/models/fence/plane.obj"); 
 	// ModelManager::GetInstance()->LoadModel("resources/models/bunny/bunny.obj");
-	ModelManager::GetInstance()->LoadModel("resources/models/fence/fence.obj");
+	// ピッキングで三角形と判定できるよう、三角形のBVHも作る
+	ModelManager::GetInstance()->LoadModel("resources/models/fence/fence.obj", false, true);
+
+	// ===== カメラ =====
+	// 全Object3dで共有する（ビュー射影行列はフレームに1回だけ作る）
+	Camera *camera = new Camera(float(WinApp::kClientWidth), float(WinApp::kClientHeight));
+	camera->SetRotate({ 0.3f, 0.0f, 0.0f });
+	camera->SetTranslate({ 0.0f, 4.0f, -10.0f });
+	object3dCommon->SetDefaultCamera(camera);
 
 	// ===== Object3d インスタンス生成・初期化 =====
 	// Object3d *planeObject = new Object3d();
@@ -335,6 +359,13 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	fenceObject->SetRotate({ 0.0f, 0.0f, 0.0f });
 	fenceObject->SetScale({ 1.0f, 1.0f, 1.0f });
 
+	// シーンのBVHに登録する（カリングとピッキングで使う）
+	object3dCommon->AddSceneObject(fenceObject);
+
+	// ImGuiのクリックで選んだオブジェクト
+	Object3d *pickedObject = nullptr;
+	float pickedDistance = 0.0f;
+
 	// ===== スプライトの生成と初期化 =====
 	Sprite *uvCheckerSprite = new Sprite();
 	uvCheckerSprite->Initialize(spriteCommon, "resources/textures/uvChecker.png");
@@ -354,6 +385,86 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	// アンカーポイントは中央
 	uvCheckerSprite->SetAnchorPoint({ 0.5f, 0.5f });
 
+	// ===== スプライトバッチ（小さなスプライトをまとめて描く） =====
+	SpriteBatch *spriteBatch = new SpriteBatch();
+	spriteBatch->Initialize(spriteCommon);
+	AssetHandle uvCheckerTexture = TextureManager::GetInstance()->GetTextureHandle("resources/textures/uvChecker.png");
+	// 画面に敷き詰める数
+	int batchedSpriteCount = 0;
+	float batchedSpriteRotation = 0.0f;
+
+	// ===== テクスチャアトラス（画像を大きなページに詰め、名前で切り出す） =====
+	const std::string atlasFilePath = "resources/textures/sprites.atlas";
+	TextureAtlas *textureAtlas = new TextureAtlas();
+	if (!textureAtlas->Load(atlasFilePath)) {
+		// まだベイクしていなければページと一覧を書き出してから読み込む
+		bool baked = TextureAtlas::Bake({ "resources/textures/uvChecker.png", "resources/textures/monsterBall.png", "resources/textures/checkerBoard.png" }, atlasFilePath);
+		assert(baked);
+		baked = textureAtlas->Load(atlasFilePath);
+		assert(baked);
+	}
+	// アトラスの画像を並べるか
+	bool drawAtlasSprites = true;
+
+	// ===== 文字描画（使った文字だけをラスタライズしてアトラスに置く） =====
+	TextRenderer *textRenderer = new TextRenderer();
+	textRenderer->Initialize(spriteCommon);
+	// 日本語も描けるフォントを優先し、なければ英数字だけのフォントにする
+	int32_t font = textRenderer->LoadFont("C:/Windows/Fonts/meiryo.ttc");
+	if (font < 0) {
+		font = textRenderer->LoadFont("C:/Windows/Fonts/arial.ttf");
+	}
+	// ダメージ表示のように毎フレーム変わる数字を並べる数
+	int damageNumberCount = 0;
+	uint32_t textFrameCount = 0;
+
+	// ===== パーティクル（エミッターごとのプールで進め、1システム1回のDrawで描く） =====
+	// エミッターの更新と描画用の書き出しを並列に行う
+	ThreadPool *particleThreadPool = new ThreadPool();
+	ParticleSystem *particleSystem = new ParticleSystem();
+	ParticleRenderer *particleRenderer = new ParticleRenderer();
+	particleRenderer->Initialize(object3dCommon, particleThreadPool);
+
+	// 縁に向かって透明になる白い円（色はパーティクルごとに掛ける）
+	DirectX::ScratchImage particleImage;
+	particleImage.Initialize2D(DXGI_FORMAT_R8G8B8A8_UNORM, 64, 64, 1, 1);
+	for (size_t y = 0; y < 64; ++y) {
+		uint8_t *row = particleImage.GetImage(0, 0, 0)->pixels + particleImage.GetImage(0, 0, 0)->rowPitch * y;
+		for (size_t x = 0; x < 64; ++x) {
+			float dx = (float(x) + 0.5f) / 32.0f - 1.0f;
+			float dy = (float(y) + 0.5f) / 32.0f - 1.0f;
+			float alpha = std::clamp(1.0f - std::sqrt(dx * dx + dy * dy), 0.0f, 1.0f);
+			row[x * 4 + 0] = 255;
+			row[x * 4 + 1] = 255;
+			row[x * 4 + 2] = 255;
+			row[x * 4 + 3] = static_cast<uint8_t>(alpha * 255.0f);
+		}
+	}
+	AssetHandle particleTexture = TextureManager::GetInstance()->RegisterTexture("particle circle", particleImage);
+
+	// 噴水を円状に並べる（1つ65536個まで、合わせて約100万個）
+	const uint32_t kParticleEmitterCount = 16;
+	for (uint32_t i = 0; i < kParticleEmitterCount; ++i) {
+		float angle = float(i) / float(kParticleEmitterCount) * 2.0f * std::numbers::pi_v<float>;
+		ParticleSystem::EmitterSettings emitterSettings;
+		emitterSettings.position = { std::cos(angle) * 4.0f, 0.0f, std::sin(angle) * 4.0f };
+		emitterSettings.spawnExtent = { 0.1f, 0.0f, 0.1f };
+		emitterSettings.rate = 0.0f;
+		emitterSettings.capacity = 65536;
+		emitterSettings.velocityMin = { -0.6f, 4.0f, -0.6f };
+		emitterSettings.velocityMax = { 0.6f, 6.0f, 0.6f };
+		emitterSettings.drag = 0.3f;
+		emitterSettings.lifetimeMin = 1.0f;
+		emitterSettings.lifetimeMax = 2.0f;
+		emitterSettings.startSize = 0.08f;
+		emitterSettings.endSize = 0.02f;
+		emitterSettings.startColor = { 1.0f, 0.6f + 0.4f * float(i % 2), 0.2f, 1.0f };
+		emitterSettings.endColor = { 0.2f, 0.3f, 1.0f, 0.0f };
+		particleSystem->AddEmitter(emitterSettings);
+	}
+	// 1エミッターが1秒に発生させる数
+	float particleRate = 0.0f;
+
 #pragma endregion
 
 	D3DResourceLeakChecker leakCheck;
@@ -424,11 +535,28 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 			fenceObject->SetRotate(fenceRot);
 		}
 
+		// 非同期読み込みが終わったモデルのGPUリソースを作る
+		ModelManager::GetInstance()->Update();
+
+		// カメラ更新
+		camera->Update();
+
 		// 3Dオブジェクト更新
 		fenceObject->Update();
 		fenceObject->Update();
 
-		// スプライト更新
+		// 視錐台カリング（シーンのBVHをたどり、カメラに映らないオブジェクトは描画キューに積まない。有効ならオクルーダーに隠れたものも除く）
+		object3dCommon->CullScene();
+
+		// パーティクル更新（エミッターごとに並列に進める）
+		for (uint32_t i = 0; i < kParticleEmitterCount; ++i)
+		{
+			particleSystem->GetEmitterSettings(i).rate = particleRate;
+		}
+		particleSystem->Update(1.0f / 60.0f, particleThreadPool);
+
+		// スプライト更新（変わっていないスプライトは作り直しを省く）
+		spriteCommon->ResetUpdateStatistics();
 		uvCheckerSprite->Update();
 
 	#pragma endregion
@@ -441,8 +569,80 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		ImGui_ImplWin32_NewFrame();
 		ImGui::NewFrame();
 
+		// ImGuiのウィンドウ以外をクリックしたら、その位置のオブジェクトを選ぶ
+		ImGuiIO &imguiIO = ImGui::GetIO();
+		if (ImGui::IsMouseClicked(ImGuiMouseButton_Left) && !imguiIO.WantCaptureMouse)
+		{
+			math::Ray pickRay = camera->ScreenPointToRay({ imguiIO.MousePos.x, imguiIO.MousePos.y });
+			pickedObject = object3dCommon->PickObject(pickRay, &pickedDistance);
+		}
+
 		ImGui::Begin("Control Panel");
 
+		if (ImGui::CollapsingHeader("Frame"))
+		{
+			// CPUの記録時間とGPUを待った時間（待ちが小さいほどCPUとGPUが重なって動いている）
+			const FrameScheduler::Timings &frameTimings = dxCommon->GetFrameTimings();
+			ImGui::Text("Frames In Flight: %u", dxCommon->GetFrameLatency());
+			ImGui::Text("CPU Frame: %.3f ms", frameTimings.cpuFrame);
+			ImGui::Text("GPU Wait: %.3f ms", frameTimings.gpuWait);
+
+			// 描画キュー（前のフレーム）
+			const RenderQueue::Statistics &renderStatistics = renderQueue->GetStatistics();
+			ImGui::Text("Draw Packets: %u", renderStatistics.packetCount);
+			ImGui::Text("Visible Objects: %zu / %zu", object3dCommon->GetCullVisibleCount(), object3dCommon->GetCullTestedCount());
+			ImGui::Text("Scene BVH: height %u, rebuilds %u", object3dCommon->GetSceneBVH().ComputeHeight(), object3dCommon->GetSceneBVH().GetRebuildCount());
+			ImGui::Text("Picked: %s (%.2f)", pickedObject == fenceObject ? "fence" : "none", pickedObject ? pickedDistance : 0.0f);
+			ImGui::Text("State Changes: %llu (avoided %llu)", renderStatistics.stateChangesIssued, renderStatistics.stateChangesAvoided);
+
+			// 同じモデルのObject3dをまとめて描く
+			bool instancing = object3dCommon->IsInstancingEnabled();
+			if (ImGui::Checkbox("Instancing", &instancing))
+			{
+				object3dCommon->SetInstancingEnabled(instancing);
+			}
+
+			// オクルーダー（Object3d::SetOccluder）に隠れたオブジェクトを描かない
+			bool occlusionCulling = object3dCommon->IsOcclusionCullingEnabled();
+			if (ImGui::Checkbox("Occlusion Culling", &occlusionCulling))
+			{
+				object3dCommon->SetOcclusionCullingEnabled(occlusionCulling);
+			}
+			const OcclusionBuffer::Statistics &occlusionStatistics = object3dCommon->GetOcclusionBuffer().GetStatistics();
+			ImGui::Text("Occluded: %zu (occluder triangles %u, rasterized %u)", object3dCommon->GetOccludedCount(),
+				occlusionStatistics.occluderTriangles, occlusionStatistics.rasterizedTriangles);
+
+			// SpriteBatchで画面に敷き詰めるスプライトの数
+			ImGui::SliderInt("Batched Sprites", &batchedSpriteCount, 0, 100000);
+			ImGui::Checkbox("Atlas Sprites", &drawAtlasSprites);
+			const SpriteBatch::Statistics &spriteBatchStatistics = spriteBatch->GetStatistics();
+			ImGui::Text("Sprite Batch: %u sprites, %u draws", spriteBatchStatistics.spriteCount, spriteBatchStatistics.drawCount);
+			const SpriteCommon::UpdateStatistics &spriteUpdateStatistics = spriteCommon->GetUpdateStatistics();
+			ImGui::Text("Sprite Updates: %u vertex, %u transform, %u skipped", spriteUpdateStatistics.vertexUpdates,
+				spriteUpdateStatistics.transformUpdates, spriteUpdateStatistics.skippedUpdates);
+
+			// TextRendererで描く数字の数とグリフキャッシュの状態
+			ImGui::SliderInt("Damage Numbers", &damageNumberCount, 0, 10000);
+			const GlyphCache &glyphCache = textRenderer->GetGlyphCache();
+			const GlyphCache::Statistics &glyphStatistics = glyphCache.GetStatistics();
+			ImGui::Text("Glyph Cache: %u resident, %llu hits, %llu rasterized, %llu evictions, %llu overflows", glyphCache.GetResidentCount(),
+				glyphStatistics.hits, glyphStatistics.rasterized, glyphStatistics.evictions, glyphStatistics.overflows);
+			ImGui::Text("Text: %u glyphs, %u draws", textRenderer->GetStatistics().spriteCount, textRenderer->GetStatistics().drawCount);
+
+			// 平均の寿命が1.5秒なので、生きている数はおよそ 発生数×1.5×エミッター数
+			ImGui::SliderFloat("Particle Rate", &particleRate, 0.0f, 43000.0f);
+			if (ImGui::Button("Particle Burst"))
+			{
+				for (uint32_t i = 0; i < kParticleEmitterCount; ++i)
+				{
+					particleSystem->Burst(i, 2000);
+				}
+			}
+			const ParticleSystem::Statistics &particleStatistics = particleSystem->GetStatistics();
+			ImGui::Text("Particles: %u alive (+%u / -%u), %u draws", particleStatistics.aliveCount,
+				particleStatistics.spawnedCount, particleStatistics.diedCount, particleRenderer->GetStatistics().drawCount);
+		}
+
 		//if (ImGui::CollapsingHeader("Plane Object"))
 		//{
 		//	// 位置
@@ -541,6 +741,37 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		//	}
 		//}
 
+		if (ImGui::CollapsingHeader("Camera"))
+		{
+			// 位置
+			math::Vector3 translate = camera->GetTranslate();
+			if (ImGui::DragFloat3("Translate##Camera", &translate.x, 0.1f))
+			{
+				camera->SetTranslate(translate);
+			}
+
+			// 回転
+			math::Vector3 rotate = camera->GetRotate();
+			if (ImGui::DragFloat3("Rotate##Camera", &rotate.x, 0.01f))
+			{
+				camera->SetRotate(rotate);
+			}
+
+			// 射影
+			bool orthographic = camera->GetProjectionType() == Camera::ProjectionType::kOrthographic;
+			if (ImGui::Checkbox("Orthographic##Camera", &orthographic))
+			{
+				camera->SetProjectionType(orthographic ? Camera::ProjectionType::kOrthographic : Camera::ProjectionType::kPerspective);
+				camera->SetOrthographicSize(16.0f, 9.0f);
+			}
+
+			float fovY = camera->GetFovY();
+			if (ImGui::DragFloat("FovY##Camera", &fovY, 0.01f, 0.1f, 3.0f))
+			{
+				camera->SetFovY(fovY);
+			}
+		}
+
 		if (ImGui::CollapsingHeader("fence Object"))
 		{
 			// 位置
@@ -673,20 +904,73 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 		// DirectX描画準備
 		dxCommon->PreDraw();
 
-		// 3Dオブジェクト描画準備
-		object3dCommon->SetCommonRenderSetting();
-
-		// 3Dオブジェクト描画
+		// 3Dオブジェクト描画（描画キューに積む。共通設定はパスの最初に描画キューが行う）
 		// planeObject->Draw();
 		// bunnyObject->Draw();
 		fenceObject->Draw();
 
-		// スプライト描画準備
-		spriteCommon->SetupCommonDrawing();
+		// インスタンス描画が有効ならここでモデルごとにまとめる
+		object3dCommon->DrawInstances();
+
+		// パーティクル描画（3Dオブジェクトの後に描かれる）
+		particleRenderer->Draw(particleSystem, particleTexture);
+		particleRenderer->Flush();
 
-		// スプライト描画
+		// スプライト描画（描画キューに積む）
 		uvCheckerSprite->Draw();
 
+		// 敷き詰めたスプライトを回しながらまとめて描く（uvCheckerSpriteより手前）
+		batchedSpriteRotation += 0.02f;
+		for (int i = 0; i < batchedSpriteCount; ++i)
+		{
+			SpriteBatcher::Quad quad;
+			quad.position = { float(i % 128) * 10.0f + 5.0f, float(i / 128 % 72) * 10.0f + 5.0f };
+			quad.size = { 8.0f, 8.0f };
+			quad.rotation = batchedSpriteRotation + float(i) * 0.01f;
+			quad.anchorPoint = { 0.5f, 0.5f };
+			spriteBatch->Draw(uvCheckerTexture, quad);
+		}
+
+		// アトラスの画像を並べる（同じページなので、何枚あっても1回のDrawで描ける）
+		if (drawAtlasSprites)
+		{
+			const char *regionNames[] = { "uvChecker", "monsterBall", "checkerBoard" };
+			for (int i = 0; i < 3; ++i)
+			{
+				SpriteBatcher::Quad quad;
+				quad.position = { 800.0f + float(i) * 150.0f, 560.0f };
+				quad.size = { 128.0f, 128.0f };
+				spriteBatch->Draw(*textureAtlas->FindRegion(regionNames[i]), quad, 1);
+			}
+		}
+		spriteBatch->Flush();
+
+		// 文字を描く（スプライトより手前）
+		if (font >= 0)
+		{
+			textFrameCount++;
+			TextLayout::Style labelStyle;
+			labelStyle.font = uint32_t(font);
+			labelStyle.pixelHeight = 28;
+			labelStyle.maxWidth = 400.0f;
+			textRenderer->DrawString(std::format("テキスト描画 Text Rendering\nFrame {}", textFrameCount), { 16.0f, 16.0f }, labelStyle);
+
+			// 数字は同じグリフを使い回すので、数が多くてもラスタライズは最初の1回だけ
+			TextLayout::Style damageStyle;
+			damageStyle.font = uint32_t(font);
+			damageStyle.pixelHeight = 20;
+			damageStyle.color = { 1.0f, 0.8f, 0.2f, 1.0f };
+			for (int i = 0; i < damageNumberCount; ++i)
+			{
+				uint32_t damage = (uint32_t(i) * 2654435761u + textFrameCount) % 10000;
+				textRenderer->DrawString(std::to_string(damage), { float(i % 24) * 52.0f + 8.0f, float(i / 24 % 30) * 22.0f + 80.0f }, damageStyle);
+			}
+		}
+		textRenderer->Flush();
+
+		// 描画キューをソートして描く
+		renderQueue->Execute();
+
 	#ifdef USE_IMGUI
 		// ImGui描画コマンドを積む
 		ImGui_ImplDX12_RenderDrawData(ImGui::GetDrawData(), dxCommon->GetCommandList());
@@ -705,7 +989,11 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 
 #pragma region 解放処理
 
+	// 処理中のフレームが使っているリソースを解放しないよう、GPUの完了を待つ
+	dxCommon->WaitForGPU();
+
 	// 3Dオブジェクト解放
+	object3dCommon->RemoveSceneObject(fenceObject);
 	delete fenceObject;
 	fenceObject = nullptr;
 
@@ -715,21 +1003,37 @@ int WINAPI WinMain(HINSTANCE, HINSTANCE, LPSTR, int) {
 	delete planeObject;
 	planeObject = nullptr;*/
 
+	// カメラ解放
+	delete camera;
+	camera = nullptr;
+
 	// 3Dモデルマネージャー終了
 	ModelManager::GetInstance()->Finalize();
 
 	delete modelCommon;
 	modelCommon = nullptr;
 
+	// パーティクル解放（描画がObject3dCommonを使うので先に）
+	delete particleRenderer;
+	delete particleSystem;
+	delete particleThreadPool;
+
 	delete object3dCommon;
 	object3dCommon = nullptr;
 
 	// スプライト解放
 	delete uvCheckerSprite;
+	delete spriteBatch;
+	delete textureAtlas;
+	delete textRenderer;
 
 	delete spriteCommon;
 	spriteCommon = nullptr;
 
+	// 描画キュー解放
+	delete renderQueue;
+	renderQueue = nullptr;
+
 	// テクスチャ管理終了
 	TextureManager::GetInstance()->Finalize();
 
@@ -2,7 +2,6 @@
 
 struct TransformationMatrix
 {
-    float32_t4x4 WVP;
     float32_t4x4 World;
 };
 
@@ -18,7 +17,7 @@ struct VertexShaderInput
 VertexShaderOutput main(VertexShaderInput input)
 {
     VertexShaderOutput output;
-    output.position = mul(input.positon, gTransformationMatrix.WVP);
+    output.position = mul(mul(input.positon, gTransformationMatrix.World), gCamera.viewProjection);
     output.texcoord = input.texcoord;
     output.normal = normalize(mul(input.normal, (float32_t3x3) gTransformationMatrix.World));
     return output;
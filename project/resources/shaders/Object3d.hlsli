@@ -3,4 +3,15 @@ struct VertexShaderOutput
     float32_t4 position : SV_POSITION;
     float32_t2 texcoord : TEXCOORD0;
     float32_t3 normal : NORMAL0;
-};
\ No newline at end of file
+};
+
+// カメラ（全オブジェクトで共有し、フレームに1回だけ更新される）
+struct Camera
+{
+    float32_t4x4 view;
+    float32_t4x4 projection;
+    float32_t4x4 viewProjection;
+    float32_t3 worldPosition;
+};
+
+ConstantBuffer<Camera> gCamera : register(b2);
\ No newline at end of file
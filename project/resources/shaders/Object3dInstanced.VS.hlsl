@@ -0,0 +1,27 @@
+#include "object3d.hlsli"
+
+// インスタンスごとの座標変換行列（同じモデルのオブジェクトをまとめて1回のDrawで描く）
+struct InstanceData
+{
+    float32_t4x4 World;
+};
+
+StructuredBuffer<InstanceData> gInstances : register(t1);
+
+struct VertexShaderInput
+{
+    float32_t4 positon : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t3 normal : NORMAL0;
+};
+
+VertexShaderOutput main(VertexShaderInput input, uint32_t instanceId : SV_InstanceID)
+{
+    float32_t4x4 world = gInstances[instanceId].World;
+
+    VertexShaderOutput output;
+    output.position = mul(mul(input.positon, world), gCamera.viewProjection);
+    output.texcoord = input.texcoord;
+    output.normal = normalize(mul(input.normal, (float32_t3x3) world));
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "object3d.hlsli"
+
+struct TransformationMatrix
+{
+    float32_t4x4 World;
+};
+
+// 量子化した頂点の展開用パラメータ
+struct VertexDecode
+{
+    float32_t3 positionScale; //!< AABBの大きさ
+    float32_t3 positionOffset; //!< AABBの最小値
+};
+
+ConstantBuffer<TransformationMatrix> gTransformationMatrix : register(b0);
+ConstantBuffer<VertexDecode> gVertexDecode : register(b1);
+
+struct VertexShaderInput
+{
+    float32_t4 position : POSITION0; // UNORM16（0～1）
+    float32_t2 texcoord : TEXCOORD0; // FLOAT16
+    float32_t2 normal : NORMAL0; // 八面体エンコードしたSNORM16（-1～1）
+};
+
+// 八面体エンコードされた法線を元に戻す
+float32_t3 DecodeOctahedral(float32_t2 encoded)
+{
+    float32_t3 normal = float32_t3(encoded.x, encoded.y, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float t = saturate(-normal.z);
+    normal.x += normal.x >= 0.0f ? -t : t;
+    normal.y += normal.y >= 0.0f ? -t : t;
+    return normalize(normal);
+}
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    float32_t4 position = float32_t4(input.position.xyz * gVertexDecode.positionScale + gVertexDecode.positionOffset, 1.0f);
+    output.position = mul(mul(position, gTransformationMatrix.World), gCamera.viewProjection);
+    output.texcoord = input.texcoord;
+    output.normal = normalize(mul(DecodeOctahedral(input.normal), (float32_t3x3) gTransformationMatrix.World));
+    return output;
+}
\ No newline at end of file
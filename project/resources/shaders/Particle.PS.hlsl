@@ -0,0 +1,22 @@
+#include "Particle.hlsli"
+
+Texture2D<float32_t4> gTexture : register(t0);
+SamplerState gSampler : register(s0);
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_TARGET0;
+};
+
+PixelShaderOutput main(ParticleVertexShaderOutput input)
+{
+    PixelShaderOutput output;
+    output.color = gTexture.Sample(gSampler, input.texcoord) * input.color;
+
+    // 見えないピクセルは描かない
+    if (output.color.a == 0.0)
+    {
+        discard;
+    }
+    return output;
+}
\ No newline at end of file
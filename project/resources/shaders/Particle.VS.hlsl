@@ -0,0 +1,39 @@
+#include "object3d.hlsli"
+#include "Particle.hlsli"
+
+// パーティクル1つ分（ParticleSystem::Instanceと同じ並び）
+struct ParticleInstance
+{
+    float32_t3 position;
+    float32_t size;
+    uint32_t color; // RGBA8（Rが最下位のバイト）
+};
+
+StructuredBuffer<ParticleInstance> gParticles : register(t1);
+
+// 四角形の2枚の三角形の角（頂点バッファは使わない）
+static const float32_t2 kCorners[6] =
+{
+    float32_t2(-0.5f, 0.5f), float32_t2(0.5f, 0.5f), float32_t2(-0.5f, -0.5f),
+    float32_t2(-0.5f, -0.5f), float32_t2(0.5f, 0.5f), float32_t2(0.5f, -0.5f),
+};
+
+ParticleVertexShaderOutput main(uint32_t vertexId : SV_VertexID, uint32_t instanceId : SV_InstanceID)
+{
+    ParticleInstance particle = gParticles[instanceId];
+    float32_t2 corner = kCorners[vertexId];
+
+    // ビュー空間で角を広げると、常にカメラを向く（ビルボード）
+    float32_t4 viewPosition = mul(float32_t4(particle.position, 1.0f), gCamera.view);
+    viewPosition.xy += corner * particle.size;
+
+    ParticleVertexShaderOutput output;
+    output.position = mul(viewPosition, gCamera.projection);
+    output.texcoord = float32_t2(corner.x + 0.5f, 0.5f - corner.y);
+    output.color = float32_t4(
+        (particle.color & 0xFF),
+        (particle.color >> 8) & 0xFF,
+        (particle.color >> 16) & 0xFF,
+        (particle.color >> 24) & 0xFF) / 255.0f;
+    return output;
+}
\ No newline at end of file
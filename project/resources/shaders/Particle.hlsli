@@ -0,0 +1,6 @@
+struct ParticleVertexShaderOutput
+{
+    float32_t4 position : SV_POSITION;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
+};
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "SpriteBatch.hlsli"
+
+Texture2D<float32_t4> gTexture : register(t0);
+SamplerState gSampler : register(s0);
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_TARGET0;
+};
+
+PixelShaderOutput main(VertexShaderOutput input)
+{
+    PixelShaderOutput output;
+    float32_t4 textureColor = gTexture.Sample(gSampler, input.texcoord);
+
+    // Spriteと同じく、textureのα値が0.5以下のときにPixelを棄却
+    if (textureColor.a <= 0.5)
+    {
+        discard;
+    }
+
+    // 色は頂点ごと（マテリアルの定数バッファは使わない）
+    output.color = input.color * textureColor;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,25 @@
+#include "SpriteBatch.hlsli"
+
+// 頂点はCPUでスクリーン座標（ピクセル）まで作ってあるので、正射影だけを掛ける
+struct Projection
+{
+    float32_t4x4 projection;
+};
+
+ConstantBuffer<Projection> gProjection : register(b0);
+
+struct VertexShaderInput
+{
+    float32_t2 position : POSITION0;
+    float32_t2 texcoord : TEXCOORD0;
+    float32_t4 color : COLOR0;
+};
+
+VertexShaderOutput main(VertexShaderInput input)
+{
+    VertexShaderOutput output;
+    output.position = mul(float32_t4(input.position, 0.0f, 1.0f), gProjection.projection);
+    output.texcoord = input.texcoord;
+    output.color = input.color;
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "SpriteBatch.hlsli"
+
+// グリフキャッシュのアトラス（R8_UNORM。赤が覆い率）
+Texture2D<float32_t4> gTexture : register(t0);
+SamplerState gSampler : register(s0);
+
+struct PixelShaderOutput
+{
+    float32_t4 color : SV_TARGET0;
+};
+
+PixelShaderOutput main(VertexShaderOutput input)
+{
+    PixelShaderOutput output;
+    float32_t coverage = gTexture.Sample(gSampler, input.texcoord).r;
+
+    // 覆っていないピクセルは描かない（深度テストとブレンドを省く）
+    if (coverage <= 0.0)
+    {
+        discard;
+    }
+
+    // 縁は覆い率をαにして背景と混ぜる
+    output.color = float32_t4(input.color.rgb, input.color.a * coverage);
+    return output;
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+#include "AssetRegistry.h"
+
+// 資産の検索: 1万件のパスから引く場合の、AssetRegistry（ハッシュ）と書き換える前の方式の比較
+// ・BM_VectorFindIf   : 書き換える前のTextureManager（vectorを先頭から比べる）
+// ・BM_MapFind        : 書き換える前のModelManager（std::map）
+// ・BM_RegistryFind   : パスからのハッシュ検索
+// ・BM_RegistryGet    : ハンドルからの取得（毎フレームの描画はこちら）
+namespace {
+
+	constexpr uint32_t kAssetCount = 10000;
+
+	// 検索するパスの順（毎回同じ乱数列）
+	struct Fixture
+	{
+		std::vector<std::string> paths;
+		std::vector<uint32_t> lookupOrder;
+
+		Fixture()
+		{
+			for (uint32_t i = 0; i < kAssetCount; ++i) {
+				paths.push_back("resources/textures/texture" + std::to_string(i) + ".png");
+			}
+			lookupOrder.resize(4096);
+			std::mt19937 random(1);
+			std::uniform_int_distribution<uint32_t> distribution(0, kAssetCount - 1);
+			for (uint32_t &index : lookupOrder) {
+				index = distribution(random);
+			}
+		}
+	};
+
+	const Fixture &GetFixture()
+	{
+		static const Fixture fixture;
+		return fixture;
+	}
+
+	struct Asset
+	{
+		std::string filePath;
+		uint32_t value;
+	};
+
+	void BM_VectorFindIf(benchmark::State &state)
+	{
+		const Fixture &fixture = GetFixture();
+		std::vector<Asset> assets;
+		for (uint32_t i = 0; i < kAssetCount; ++i) {
+			assets.push_back({ fixture.paths[i], i });
+		}
+		size_t next = 0;
+		for (auto _ : state) {
+			const std::string &path = fixture.paths[fixture.lookupOrder[next++ & 4095]];
+			auto it = std::find_if(assets.begin(), assets.end(), [&path](const Asset &asset) { return asset.filePath == path; });
+			benchmark::DoNotOptimize(it);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_MapFind(benchmark::State &state)
+	{
+		const Fixture &fixture = GetFixture();
+		std::map<std::string, uint32_t> assets;
+		for (uint32_t i = 0; i < kAssetCount; ++i) {
+			assets.emplace(fixture.paths[i], i);
+		}
+		size_t next = 0;
+		for (auto _ : state) {
+			auto it = assets.find(fixture.paths[fixture.lookupOrder[next++ & 4095]]);
+			benchmark::DoNotOptimize(it);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_RegistryFind(benchmark::State &state)
+	{
+		const Fixture &fixture = GetFixture();
+		AssetRegistry<uint32_t> assets;
+		for (uint32_t i = 0; i < kAssetCount; ++i) {
+			assets.Add(fixture.paths[i], i);
+		}
+		size_t next = 0;
+		for (auto _ : state) {
+			AssetHandle handle = assets.Find(fixture.paths[fixture.lookupOrder[next++ & 4095]]);
+			benchmark::DoNotOptimize(handle);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_RegistryGet(benchmark::State &state)
+	{
+		const Fixture &fixture = GetFixture();
+		AssetRegistry<uint32_t> assets;
+		std::vector<AssetHandle> handles;
+		for (uint32_t i = 0; i < kAssetCount; ++i) {
+			handles.push_back(assets.Add(fixture.paths[i], i));
+		}
+		size_t next = 0;
+		for (auto _ : state) {
+			uint32_t *asset = assets.Get(handles[fixture.lookupOrder[next++ & 4095]]);
+			benchmark::DoNotOptimize(asset);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+BENCHMARK(BM_VectorFindIf);
+BENCHMARK(BM_MapFind);
+BENCHMARK(BM_RegistryFind);
+BENCHMARK(BM_RegistryGet);
\ No newline at end of file
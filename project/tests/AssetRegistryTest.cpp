@@ -0,0 +1,179 @@
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include "AssetRegistry.h"
+
+namespace {
+
+	std::string TexturePath(uint32_t i)
+	{
+		return "resources/textures/texture" + std::to_string(i) + ".png";
+	}
+}
+
+// FNV-1a 64bitの既知の値
+TEST(AssetRegistry, HashPathIsFnv1a)
+{
+	EXPECT_EQ(AssetRegistry<int>::HashPath(""), 14695981039346656037ull);
+	EXPECT_EQ(AssetRegistry<int>::HashPath("a"), 0xaf63dc4c8601ec8cull);
+	EXPECT_EQ(AssetRegistry<int>::HashPath("foobar"), 0x85944171f73967e8ull);
+}
+
+// 登録していないパスは見つからない
+TEST(AssetRegistry, EmptyRegistryFindsNothing)
+{
+	AssetRegistry<int> registry;
+	EXPECT_FALSE(registry.Find("missing.png").IsValid());
+	EXPECT_EQ(registry.Get(AssetHandle {}), nullptr);
+	EXPECT_EQ(registry.GetCount(), 0u);
+}
+
+// 登録した資産はパスとハンドルの両方から引け、同じパスの2回目の登録は上書きしない
+TEST(AssetRegistry, AddFindAndGet)
+{
+	AssetRegistry<int> registry;
+	AssetHandle a = registry.Add("a.png", 1);
+	AssetHandle b = registry.Add("b.png", 2);
+	ASSERT_TRUE(a.IsValid());
+	ASSERT_TRUE(b.IsValid());
+	EXPECT_NE(a, b);
+
+	EXPECT_EQ(registry.Find("a.png"), a);
+	EXPECT_EQ(registry.Find("b.png"), b);
+	EXPECT_EQ(*registry.Get(a), 1);
+	EXPECT_EQ(*registry.Get(b), 2);
+
+	EXPECT_EQ(registry.Add("a.png", 100), a);
+	EXPECT_EQ(*registry.Get(a), 1);
+	EXPECT_EQ(registry.GetCount(), 2u);
+}
+
+// 削除すると古いハンドルは無効になり、スロットは世代を進めて再利用される
+TEST(AssetRegistry, RemoveInvalidatesStaleHandles)
+{
+	AssetRegistry<int> registry;
+	AssetHandle old = registry.Add("a.png", 1);
+	ASSERT_TRUE(registry.Remove(old));
+	EXPECT_FALSE(registry.Remove(old));
+	EXPECT_FALSE(registry.IsAlive(old));
+	EXPECT_EQ(registry.Get(old), nullptr);
+	EXPECT_FALSE(registry.Find("a.png").IsValid());
+
+	AssetHandle reused = registry.Add("c.png", 3);
+	EXPECT_EQ(reused.index, old.index);
+	EXPECT_NE(reused.generation, old.generation);
+	EXPECT_EQ(registry.Get(old), nullptr);
+	EXPECT_EQ(*registry.Get(reused), 3);
+	EXPECT_EQ(registry.GetSlotCount(), 1u);
+}
+
+// 同じバケットに落ちるパスどうし（線形探査の衝突）でも、削除を挟んで正しく引ける
+TEST(AssetRegistry, CollidingPathsProbeCorrectly)
+{
+	// 最小のテーブル（16バケット）で同じバケットになるパスを集める
+	std::vector<std::string> colliding;
+	const uint64_t targetBucket = AssetRegistry<int>::HashPath(TexturePath(0)) & 15;
+	for (uint32_t i = 0; colliding.size() < 6; ++i) {
+		if ((AssetRegistry<int>::HashPath(TexturePath(i)) & 15) == targetBucket) {
+			colliding.push_back(TexturePath(i));
+		}
+	}
+
+	AssetRegistry<int> registry;
+	std::vector<AssetHandle> handles;
+	for (size_t i = 0; i < colliding.size(); ++i) {
+		handles.push_back(registry.Add(colliding[i], static_cast<int>(i)));
+	}
+	// 探査の途中にあるものを消しても、その先のものは見つかる
+	ASSERT_TRUE(registry.Remove(handles[1]));
+	ASSERT_TRUE(registry.Remove(handles[3]));
+	for (size_t i = 0; i < colliding.size(); ++i) {
+		AssetHandle found = registry.Find(colliding[i]);
+		if (i == 1 || i == 3) {
+			EXPECT_FALSE(found.IsValid()) << colliding[i];
+		} else {
+			ASSERT_EQ(found, handles[i]) << colliding[i];
+			EXPECT_EQ(*registry.Get(found), static_cast<int>(i));
+		}
+	}
+	// 消した場所を再び使って登録できる
+	AssetHandle again = registry.Add(colliding[3], 30);
+	EXPECT_EQ(registry.Find(colliding[3]), again);
+	EXPECT_EQ(registry.Find(colliding[5]), handles[5]);
+}
+
+// 乱数で登録・削除・検索を繰り返し、std::unordered_mapと同じ結果になる（削除済みバケットの作り直しを含む）
+TEST(AssetRegistry, MatchesReferenceUnderChurn)
+{
+	AssetRegistry<uint32_t> registry;
+	std::unordered_map<std::string, std::pair<AssetHandle, uint32_t>> reference;
+	std::mt19937 random(2024);
+	std::uniform_int_distribution<uint32_t> pathDistribution(0, 499);
+	std::uniform_int_distribution<uint32_t> operationDistribution(0, 2);
+
+	for (uint32_t step = 0; step < 50000; ++step) {
+		std::string path = TexturePath(pathDistribution(random));
+		switch (operationDistribution(random)) {
+		case 0: {
+			AssetHandle handle = registry.Add(path, step);
+			auto [it, inserted] = reference.try_emplace(path, handle, step);
+			ASSERT_EQ(handle, it->second.first) << "step " << step;
+			break;
+		}
+		case 1: {
+			auto it = reference.find(path);
+			AssetHandle handle = it != reference.end() ? it->second.first : registry.Find(path);
+			ASSERT_EQ(registry.Remove(handle), it != reference.end()) << "step " << step;
+			if (it != reference.end()) {
+				reference.erase(it);
+			}
+			break;
+		}
+		default: {
+			AssetHandle handle = registry.Find(path);
+			auto it = reference.find(path);
+			ASSERT_EQ(handle.IsValid(), it != reference.end()) << "step " << step;
+			if (handle.IsValid()) {
+				ASSERT_EQ(handle, it->second.first);
+				ASSERT_EQ(*registry.Get(handle), it->second.second);
+			}
+			break;
+		}
+		}
+		ASSERT_EQ(registry.GetCount(), reference.size());
+	}
+	// 再利用されるので、スロットは同時に存在した数を超えない
+	EXPECT_LE(registry.GetSlotCount(), 500u);
+}
+
+// Reserveした数までは登録しても資産のアドレスが変わらない
+TEST(AssetRegistry, ReserveKeepsAssetAddressesStable)
+{
+	AssetRegistry<std::unique_ptr<int>> registry;
+	registry.Reserve(1000);
+	AssetHandle first = registry.Add(TexturePath(0), std::make_unique<int>(7));
+	std::unique_ptr<int> *firstAsset = registry.Get(first);
+	for (uint32_t i = 1; i < 1000; ++i) {
+		registry.Add(TexturePath(i), std::make_unique<int>(static_cast<int>(i)));
+	}
+	EXPECT_EQ(registry.Get(first), firstAsset);
+	EXPECT_EQ(**firstAsset, 7);
+	for (uint32_t i = 0; i < 1000; ++i) {
+		ASSERT_TRUE(registry.Find(TexturePath(i)).IsValid()) << i;
+	}
+}
+
+// ForEachは登録されているものだけを回る
+TEST(AssetRegistry, ForEachVisitsLiveAssets)
+{
+	AssetRegistry<int> registry;
+	AssetHandle a = registry.Add("a.png", 1);
+	registry.Add("b.png", 2);
+	registry.Add("c.png", 4);
+	registry.Remove(a);
+	int sum = 0;
+	registry.ForEach([&sum](int &value) { sum += value; });
+	EXPECT_EQ(sum, 6);
+}
\ No newline at end of file
@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "AtlasPacker.h"
+
+// テクスチャアトラスの配置決め（2048四方のページ、UIのアイコンや文字くらいの8～128ピクセルの画像）
+// ミップの段数を増やすとブロックとパディングが大きくなるので、詰め具合と時間がどう変わるかも見る
+// occupancy_percentは画像の面積 / ページの面積、padded_percentはパディングとブロックへの切り上げを含めた面積 / ページの面積
+namespace {
+
+	std::vector<AtlasPacker::Extent> MakeSizes(size_t count)
+	{
+		std::mt19937 random(1);
+		std::vector<AtlasPacker::Extent> sizes(count);
+		for (AtlasPacker::Extent &size : sizes) {
+			switch (random() % 4) {
+			case 0: size = { 8 + uint32_t(random() % 24), 8 + uint32_t(random() % 24) }; break;
+			case 1: size = { 16 + uint32_t(random() % 48), 16 + uint32_t(random() % 48) }; break;
+			case 2: size = { 32 + uint32_t(random() % 96), 32 + uint32_t(random() % 96) }; break;
+			default: size = { 64 + uint32_t(random() % 64), 8 + uint32_t(random() % 32) }; break;
+			}
+		}
+		return sizes;
+	}
+
+	// 引数: 画像の数、ミップの段数（パディングは最小の1.5ブロック）
+	void BM_AtlasPack(benchmark::State &state)
+	{
+		std::vector<AtlasPacker::Extent> sizes = MakeSizes(static_cast<size_t>(state.range(0)));
+		AtlasPacker::Settings settings;
+		settings.mipLevels = static_cast<uint32_t>(state.range(1));
+		const uint32_t blockSize = 1u << (settings.mipLevels - 1);
+		settings.padding = (blockSize * 3 + 1) / 2;
+
+		AtlasPacker packer;
+		for (auto _ : state) {
+			if (!packer.Pack(sizes, settings)) {
+				state.SkipWithError("Pack failed");
+				return;
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+
+		uint64_t paddedArea = 0;
+		for (const AtlasPacker::Extent &size : sizes) {
+			uint64_t width = (size.width + settings.padding * 2 + blockSize - 1) / blockSize * blockSize;
+			uint64_t height = (size.height + settings.padding * 2 + blockSize - 1) / blockSize * blockSize;
+			paddedArea += width * height;
+		}
+		const AtlasPacker::Statistics &statistics = packer.GetStatistics();
+		state.counters["pages"] = static_cast<double>(statistics.pageCount);
+		state.counters["occupancy_percent"] = statistics.occupancy * 100.0;
+		state.counters["padded_percent"] = 100.0 * static_cast<double>(paddedArea) / static_cast<double>(statistics.pageArea);
+	}
+
+	// ページへ写してパディングを引き伸ばす（1画素4byte）
+	void BM_AtlasCopyWithPadding(benchmark::State &state)
+	{
+		std::vector<AtlasPacker::Extent> sizes = MakeSizes(static_cast<size_t>(state.range(0)));
+		AtlasPacker::Settings settings;
+		AtlasPacker packer;
+		packer.Pack(sizes, settings);
+		std::vector<std::vector<uint8_t>> pages;
+		for (const AtlasPacker::Extent &page : packer.GetPages()) {
+			pages.emplace_back(size_t(page.width) * page.height * 4);
+		}
+		std::vector<uint8_t> source(128 * 128 * 4, 0x80);
+
+		uint64_t pixels = 0;
+		for (auto _ : state) {
+			for (size_t i = 0; i < sizes.size(); ++i) {
+				const AtlasPacker::Placement &placement = packer.GetPlacements()[i];
+				AtlasPacker::CopyWithPadding(source.data(), 128 * 4, sizes[i], pages[placement.page].data(), size_t(packer.GetPages()[placement.page].width) * 4, placement, settings.padding);
+				pixels += uint64_t(sizes[i].width + settings.padding * 2) * (sizes[i].height + settings.padding * 2);
+			}
+			benchmark::DoNotOptimize(pages.data());
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(pixels * 4));
+	}
+
+}
+
+BENCHMARK(BM_AtlasPack)->ArgNames({ "images", "mips" })
+	->Args({ 1000, 3 })->Args({ 5000, 3 })->Args({ 10000, 3 })
+	->Args({ 5000, 1 })->Args({ 5000, 5 })
+	->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AtlasCopyWithPadding)->ArgName("images")->Arg(5000)->Unit(benchmark::kMillisecond);
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "AtlasPacker.h"
+
+// テクスチャアトラスの配置決めとパディングの書き込み
+// 画像（パディング込み）が重ならずページに収まること、ミップのどの段でも1つのブロックに別の画像が混ざらないことを確かめる
+namespace {
+
+	// UIのアイコンや文字くらいの大きさが混ざった一覧
+	std::vector<AtlasPacker::Extent> MakeSizes(size_t count, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::vector<AtlasPacker::Extent> sizes(count);
+		for (AtlasPacker::Extent &size : sizes) {
+			switch (random() % 4) {
+			case 0: size = { 8 + uint32_t(random() % 24), 8 + uint32_t(random() % 24) }; break;
+			case 1: size = { 16 + uint32_t(random() % 48), 16 + uint32_t(random() % 48) }; break;
+			case 2: size = { 32 + uint32_t(random() % 96), 32 + uint32_t(random() % 96) }; break;
+			default: size = { 64 + uint32_t(random() % 64), 8 + uint32_t(random() % 32) }; break;
+			}
+		}
+		return sizes;
+	}
+
+	// ページごとに、各ピクセルがどの画像（パディングを含む）のものかを塗る。-1は空き
+	std::vector<std::vector<int>> PaintOwners(const AtlasPacker &packer, const std::vector<AtlasPacker::Extent> &sizes, uint32_t padding)
+	{
+		const std::vector<AtlasPacker::Extent> &pages = packer.GetPages();
+		std::vector<std::vector<int>> owners(pages.size());
+		for (size_t page = 0; page < pages.size(); ++page) {
+			owners[page].assign(size_t(pages[page].width) * pages[page].height, -1);
+		}
+		for (size_t i = 0; i < sizes.size(); ++i) {
+			const AtlasPacker::Placement &placement = packer.GetPlacements()[i];
+			const AtlasPacker::Extent &page = pages[placement.page];
+			EXPECT_GE(placement.x, padding);
+			EXPECT_GE(placement.y, padding);
+			EXPECT_LE(placement.x + sizes[i].width + padding, page.width) << "image " << i;
+			EXPECT_LE(placement.y + sizes[i].height + padding, page.height) << "image " << i;
+			for (uint32_t y = placement.y - padding; y < placement.y + sizes[i].height + padding && y < page.height; ++y) {
+				for (uint32_t x = placement.x - padding; x < placement.x + sizes[i].width + padding && x < page.width; ++x) {
+					int &owner = owners[placement.page][size_t(y) * page.width + x];
+					EXPECT_EQ(owner, -1) << "images " << owner << " and " << i << " overlap at (" << x << ", " << y << ")";
+					owner = int(i);
+				}
+			}
+		}
+		return owners;
+	}
+
+}
+
+TEST(AtlasPacker, EmptyInputHasNoPages)
+{
+	AtlasPacker packer;
+	EXPECT_TRUE(packer.Pack({}, {}));
+	EXPECT_TRUE(packer.GetPages().empty());
+	EXPECT_TRUE(packer.GetPlacements().empty());
+	EXPECT_EQ(packer.GetStatistics().pageCount, 0u);
+	EXPECT_EQ(packer.GetStatistics().occupancy, 0.0);
+}
+
+TEST(AtlasPacker, ImageLargerThanPageFails)
+{
+	AtlasPacker::Settings settings;
+	settings.pageWidth = 256;
+	settings.pageHeight = 256;
+	AtlasPacker packer;
+	// パディング込みでページを超える
+	EXPECT_FALSE(packer.Pack({ { 16, 16 }, { 250, 10 } }, settings));
+	EXPECT_TRUE(packer.Pack({ { 16, 16 }, { 256 - settings.padding * 2, 10 } }, settings));
+}
+
+TEST(AtlasPacker, SingleImageTrimsPageToBlocks)
+{
+	AtlasPacker::Settings settings; // パディング6、ブロック4
+	AtlasPacker packer;
+	ASSERT_TRUE(packer.Pack({ { 13, 7 } }, settings));
+	ASSERT_EQ(packer.GetPages().size(), 1u);
+	// 13+12=25→28、7+12=19→20
+	EXPECT_EQ(packer.GetPages()[0].width, 28u);
+	EXPECT_EQ(packer.GetPages()[0].height, 20u);
+	EXPECT_EQ(packer.GetPlacements()[0].page, 0u);
+	EXPECT_EQ(packer.GetPlacements()[0].x, 6u);
+	EXPECT_EQ(packer.GetPlacements()[0].y, 6u);
+	EXPECT_EQ(packer.GetStatistics().imageArea, 13u * 7u);
+	EXPECT_EQ(packer.GetStatistics().pageArea, 28u * 20u);
+}
+
+TEST(AtlasPacker, PlacementsNeverOverlapAndAlignToBlocks)
+{
+	AtlasPacker::Settings settings;
+	const uint32_t blockSize = 1u << (settings.mipLevels - 1);
+	std::vector<AtlasPacker::Extent> sizes = MakeSizes(3000, 1);
+	AtlasPacker packer;
+	ASSERT_TRUE(packer.Pack(sizes, settings));
+	ASSERT_EQ(packer.GetPlacements().size(), sizes.size());
+	for (const AtlasPacker::Extent &page : packer.GetPages()) {
+		EXPECT_LE(page.width, settings.pageWidth);
+		EXPECT_LE(page.height, settings.pageHeight);
+		EXPECT_EQ(page.width % blockSize, 0u);
+		EXPECT_EQ(page.height % blockSize, 0u);
+	}
+	for (const AtlasPacker::Placement &placement : packer.GetPlacements()) {
+		EXPECT_LT(placement.page, packer.GetPages().size());
+		EXPECT_EQ((placement.x - settings.padding) % blockSize, 0u);
+		EXPECT_EQ((placement.y - settings.padding) % blockSize, 0u);
+	}
+	PaintOwners(packer, sizes, settings.padding);
+}
+
+TEST(AtlasPacker, OverflowAddsPages)
+{
+	AtlasPacker::Settings settings;
+	settings.pageWidth = 512;
+	settings.pageHeight = 512;
+	// パディング込みで136x136なので1ページに3x3=9枚しか入らない
+	std::vector<AtlasPacker::Extent> sizes(40, AtlasPacker::Extent { 124, 124 });
+	AtlasPacker packer;
+	ASSERT_TRUE(packer.Pack(sizes, settings));
+	EXPECT_EQ(packer.GetStatistics().pageCount, 5u);
+	EXPECT_EQ(packer.GetPages().size(), 5u);
+	std::vector<int> perPage(5, 0);
+	for (const AtlasPacker::Placement &placement : packer.GetPlacements()) {
+		++perPage[placement.page];
+	}
+	EXPECT_EQ(perPage, (std::vector<int> { 9, 9, 9, 9, 4 }));
+	PaintOwners(packer, sizes, settings.padding);
+}
+
+TEST(AtlasPacker, StatisticsAddUp)
+{
+	std::vector<AtlasPacker::Extent> sizes = MakeSizes(500, 2);
+	AtlasPacker packer;
+	ASSERT_TRUE(packer.Pack(sizes, {}));
+	uint64_t imageArea = 0;
+	for (const AtlasPacker::Extent &size : sizes) {
+		imageArea += uint64_t(size.width) * size.height;
+	}
+	uint64_t pageArea = 0;
+	for (const AtlasPacker::Extent &page : packer.GetPages()) {
+		pageArea += uint64_t(page.width) * page.height;
+	}
+	const AtlasPacker::Statistics &statistics = packer.GetStatistics();
+	EXPECT_EQ(statistics.imageArea, imageArea);
+	EXPECT_EQ(statistics.pageArea, pageArea);
+	EXPECT_DOUBLE_EQ(statistics.occupancy, double(imageArea) / double(pageArea));
+	EXPECT_GT(statistics.occupancy, 0.5);
+}
+
+TEST(AtlasPacker, MipBlocksNeverMixImages)
+{
+	// 最後の段までブロックごとに持ち主を調べ、画像の範囲とバイリニアで読む範囲に別の画像や空きが入らないこと
+	AtlasPacker::Settings settings;
+	settings.pageWidth = 512;
+	settings.pageHeight = 512;
+	std::vector<AtlasPacker::Extent> sizes = MakeSizes(400, 3);
+	AtlasPacker packer;
+	ASSERT_TRUE(packer.Pack(sizes, settings));
+	std::vector<std::vector<int>> owners = PaintOwners(packer, sizes, settings.padding);
+
+	for (uint32_t level = 1; level < settings.mipLevels; ++level) {
+		const uint32_t scale = 1u << level;
+		for (size_t i = 0; i < sizes.size(); ++i) {
+			const AtlasPacker::Placement &placement = packer.GetPlacements()[i];
+			const AtlasPacker::Extent &page = packer.GetPages()[placement.page];
+			// 画像の縁ちょうどのUVでバイリニアが重みを持つテクセル
+			auto lowest = [&](uint32_t edge) { return int(std::floor(double(edge) / scale - 0.5)); };
+			auto highest = [&](uint32_t edge) { return int(std::ceil(double(edge) / scale - 0.5)); };
+			int texelX0 = lowest(placement.x);
+			int texelX1 = highest(placement.x + sizes[i].width);
+			int texelY0 = lowest(placement.y);
+			int texelY1 = highest(placement.y + sizes[i].height);
+			for (int texelY = texelY0; texelY <= texelY1; ++texelY) {
+				for (int texelX = texelX0; texelX <= texelX1; ++texelX) {
+					if (texelX < 0 || texelY < 0 || uint32_t(texelX) >= page.width / scale || uint32_t(texelY) >= page.height / scale) {
+						continue;
+					}
+					// このテクセルに縮めたピクセルはすべてこの画像（パディングを含む）のもの
+					for (uint32_t y = uint32_t(texelY) * scale; y < uint32_t(texelY + 1) * scale; ++y) {
+						for (uint32_t x = uint32_t(texelX) * scale; x < uint32_t(texelX + 1) * scale; ++x) {
+							ASSERT_EQ(owners[placement.page][size_t(y) * page.width + x], int(i)) << "level " << level << " texel (" << texelX << ", " << texelY << ")";
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
+TEST(AtlasPacker, CopyWithPaddingExtrudesEdgePixels)
+{
+	// 3x2の画像を、パディング2で10x8のページの(3,3)に写す
+	const AtlasPacker::Extent extent = { 3, 2 };
+	std::vector<uint32_t> source(6);
+	for (uint32_t i = 0; i < source.size(); ++i) {
+		source[i] = 0x10101010u * (i + 1);
+	}
+	const uint32_t pageWidth = 10;
+	const uint32_t pageHeight = 8;
+	const uint32_t background = 0xDEADBEEFu;
+	std::vector<uint32_t> page(pageWidth * pageHeight, background);
+	AtlasPacker::CopyWithPadding(reinterpret_cast<const uint8_t *>(source.data()), extent.width * 4, extent,
+		reinterpret_cast<uint8_t *>(page.data()), pageWidth * 4, { 0, 3, 3 }, 2);
+
+	for (uint32_t y = 0; y < pageHeight; ++y) {
+		for (uint32_t x = 0; x < pageWidth; ++x) {
+			uint32_t pixel = page[y * pageWidth + x];
+			bool inBand = x >= 1 && x < 3 + 3 + 2 && y >= 1 && y < 3 + 2 + 2;
+			if (!inBand) {
+				EXPECT_EQ(pixel, background) << "(" << x << ", " << y << ") was written";
+				continue;
+			}
+			// 帯は一番近い画像の画素と同じ
+			int sourceX = std::clamp(int(x) - 3, 0, 2);
+			int sourceY = std::clamp(int(y) - 3, 0, 1);
+			EXPECT_EQ(pixel, source[sourceY * 3 + sourceX]) << "(" << x << ", " << y << ")";
+		}
+	}
+}
\ No newline at end of file
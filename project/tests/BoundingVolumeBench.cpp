@@ -0,0 +1,74 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "BoundingVolume.h"
+#include "MathFunctions.h"
+
+// 視錐台カリング: CullSpheres（SoA・4つずつSIMD）と、1つずつIsVisibleを呼ぶ場合
+// items_per_secondは1秒あたりに判定できるオブジェクト数（1000で割ると1ミリ秒あたり）
+namespace {
+
+	struct Scene
+	{
+		math::Frustum frustum;
+		std::vector<math::Sphere> spheres;
+		math::SphereStreams streams;
+	};
+
+	Scene MakeScene(size_t count)
+	{
+		Scene scene;
+		math::Matrix4x4 view = math::Inverse(math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 0.0f, 4.0f, -10.0f }));
+		scene.frustum = math::MakeFrustum(math::Multiply(view, math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f)));
+
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> radius(0.1f, 3.0f);
+		scene.spheres.resize(count);
+		scene.streams.Resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			scene.spheres[i] = { { position(random), position(random) * 0.5f, position(random) + 30.0f }, radius(random) };
+			scene.streams.Set(i, scene.spheres[i]);
+		}
+		return scene;
+	}
+
+	void SetCounters(benchmark::State &state, size_t count, size_t visibleCount)
+	{
+		state.SetItemsProcessed(state.iterations() * count);
+		state.counters["visible"] = static_cast<double>(visibleCount);
+	}
+
+	void BM_CullSpheres(benchmark::State &state)
+	{
+		size_t count = static_cast<size_t>(state.range(0));
+		Scene scene = MakeScene(count);
+		std::vector<uint8_t> visible(count);
+		size_t visibleCount = 0;
+		for (auto _ : state) {
+			visibleCount = math::CullSpheres(scene.frustum, scene.streams, visible.data());
+			benchmark::DoNotOptimize(visible.data());
+		}
+		SetCounters(state, count, visibleCount);
+	}
+
+	void BM_IsVisiblePerSphere(benchmark::State &state)
+	{
+		size_t count = static_cast<size_t>(state.range(0));
+		Scene scene = MakeScene(count);
+		std::vector<uint8_t> visible(count);
+		size_t visibleCount = 0;
+		for (auto _ : state) {
+			visibleCount = 0;
+			for (size_t i = 0; i < count; ++i) {
+				visible[i] = math::IsVisible(scene.frustum, scene.spheres[i]) ? 1 : 0;
+				visibleCount += visible[i];
+			}
+			benchmark::DoNotOptimize(visible.data());
+		}
+		SetCounters(state, count, visibleCount);
+	}
+}
+
+BENCHMARK(BM_CullSpheres)->ArgName("objects")->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_IsVisiblePerSphere)->ArgName("objects")->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
@@ -0,0 +1,299 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "BoundingVolume.h"
+#include "MathFunctions.h"
+
+// 視錐台の平面の取り出しと、球・AABB・レイの判定
+// 視錐台の判定は「見えるものを見えないとしない」ことを、内部の点を調べて確かめる
+namespace {
+
+	float SignedDistance(const math::Plane &plane, const math::Vector3 &point)
+	{
+		return plane.normal.x * point.x + plane.normal.y * point.y + plane.normal.z * point.z + plane.distance;
+	}
+
+	bool IsPointInside(const math::Frustum &frustum, const math::Vector3 &point)
+	{
+		for (const math::Plane &plane : frustum.planes) {
+			if (SignedDistance(plane, point) < 0.0f) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// 少し傾けたカメラ
+	math::Matrix4x4 MakeView()
+	{
+		return math::Inverse(math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 0.0f, 4.0f, -10.0f }));
+	}
+
+	math::Matrix4x4 MakePerspectiveViewProjection()
+	{
+		return math::Multiply(MakeView(), math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+	}
+
+	math::Matrix4x4 MakeOrthographicViewProjection()
+	{
+		return math::Multiply(MakeView(), math::MakeOrthographicMatrix(-20.0f, 20.0f, 20.0f, -20.0f, 0.1f, 100.0f));
+	}
+
+	// 平面の判定がクリップ座標での判定（-w<=x<=w, -w<=y<=w, 0<=z<=w）と一致するか
+	// 境界のすぐ近くの点は誤差でどちらにもなるので数えない
+	void ExpectPlanesMatchClipSpace(const math::Matrix4x4 &viewProjection)
+	{
+		math::Frustum frustum = math::MakeFrustum(viewProjection);
+		math::Matrix4x4 inverse = math::Inverse(viewProjection);
+		std::mt19937 random(7);
+		std::uniform_real_distribution<float> ndc(-1.2f, 1.2f);
+		std::uniform_real_distribution<float> depth(-0.1f, 1.1f);
+		int checked = 0;
+		for (int i = 0; i < 20000; ++i) {
+			float x = ndc(random);
+			float y = ndc(random);
+			float z = depth(random);
+			float margin = (std::min)({ std::abs(std::abs(x) - 1.0f), std::abs(std::abs(y) - 1.0f), std::abs(z), std::abs(z - 1.0f) });
+			if (margin < 1e-3f) {
+				continue;
+			}
+			bool inside = std::abs(x) <= 1.0f && std::abs(y) <= 1.0f && z >= 0.0f && z <= 1.0f;
+			math::Vector3 point = math::ApplyTransform({ x, y, z }, inverse);
+			ASSERT_EQ(IsPointInside(frustum, point), inside) << "ndc (" << x << ", " << y << ", " << z << ")";
+			++checked;
+		}
+		EXPECT_GT(checked, 15000);
+	}
+
+	std::vector<math::Sphere> RandomSpheres(size_t count, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+		std::uniform_real_distribution<float> radius(0.1f, 3.0f);
+		std::vector<math::Sphere> spheres(count);
+		for (math::Sphere &sphere : spheres) {
+			sphere = { { position(random), position(random) * 0.5f, position(random) + 30.0f }, radius(random) };
+		}
+		return spheres;
+	}
+}
+
+TEST(BoundingVolume, EmptyAABBExpandsToPoints)
+{
+	math::AABB aabb = math::MakeEmptyAABB();
+	math::Expand(aabb, { 1.0f, -2.0f, 3.0f });
+	math::Expand(aabb, { -1.0f, 4.0f, 0.0f });
+	EXPECT_EQ(aabb.min.x, -1.0f);
+	EXPECT_EQ(aabb.min.y, -2.0f);
+	EXPECT_EQ(aabb.min.z, 0.0f);
+	EXPECT_EQ(aabb.max.x, 1.0f);
+	EXPECT_EQ(aabb.max.y, 4.0f);
+	EXPECT_EQ(aabb.max.z, 3.0f);
+
+	math::Vector3 center = math::GetCenter(aabb);
+	EXPECT_EQ(center.x, 0.0f);
+	EXPECT_EQ(center.y, 1.0f);
+	EXPECT_EQ(center.z, 1.5f);
+	EXPECT_FLOAT_EQ(math::GetSurfaceArea(aabb), 2.0f * (2.0f * 6.0f + 6.0f * 3.0f + 3.0f * 2.0f));
+}
+
+TEST(BoundingVolume, OverlapsIncludesTouching)
+{
+	math::AABB a = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+	math::AABB touching = { { 1.0f, 0.0f, 0.0f }, { 2.0f, 1.0f, 1.0f } };
+	math::AABB apart = { { 1.01f, 0.0f, 0.0f }, { 2.0f, 1.0f, 1.0f } };
+	EXPECT_TRUE(math::Overlaps(a, touching));
+	EXPECT_FALSE(math::Overlaps(a, apart));
+
+	math::AABB both = math::Union(a, apart);
+	EXPECT_EQ(both.min.x, 0.0f);
+	EXPECT_EQ(both.max.x, 2.0f);
+}
+
+TEST(BoundingVolume, TransformAABBMatchesTransformedCorners)
+{
+	std::mt19937 random(1);
+	std::uniform_real_distribution<float> value(-3.0f, 3.0f);
+	for (int i = 0; i < 100; ++i) {
+		math::AABB aabb = { { value(random), value(random), value(random) }, {} };
+		aabb.max = { aabb.min.x + 1.0f + std::abs(value(random)), aabb.min.y + 0.5f, aabb.min.z + 2.0f };
+		math::Matrix4x4 matrix = math::MakeAffineMatrix(
+			{ 0.5f + std::abs(value(random)), 1.0f, 2.0f }, { value(random), value(random), value(random) }, { value(random), value(random), value(random) });
+
+		math::AABB expected = math::MakeEmptyAABB();
+		for (int corner = 0; corner < 8; ++corner) {
+			math::Vector3 point = {
+				(corner & 1) ? aabb.max.x : aabb.min.x,
+				(corner & 2) ? aabb.max.y : aabb.min.y,
+				(corner & 4) ? aabb.max.z : aabb.min.z,
+			};
+			math::Expand(expected, math::ApplyTransform(point, matrix));
+		}
+		math::AABB result = math::TransformAABB(aabb, matrix);
+		EXPECT_NEAR(result.min.x, expected.min.x, 1e-4f);
+		EXPECT_NEAR(result.min.y, expected.min.y, 1e-4f);
+		EXPECT_NEAR(result.min.z, expected.min.z, 1e-4f);
+		EXPECT_NEAR(result.max.x, expected.max.x, 1e-4f);
+		EXPECT_NEAR(result.max.y, expected.max.y, 1e-4f);
+		EXPECT_NEAR(result.max.z, expected.max.z, 1e-4f);
+	}
+}
+
+TEST(BoundingVolume, TransformSphereContainsTransformedSurface)
+{
+	math::Sphere sphere = { { 1.0f, 2.0f, 3.0f }, 1.5f };
+	math::Matrix4x4 matrix = math::MakeAffineMatrix({ 1.0f, 3.0f, 0.5f }, { 0.4f, -1.1f, 2.0f }, { 5.0f, 0.0f, -2.0f });
+	math::Sphere result = math::TransformSphere(sphere, matrix);
+	EXPECT_FLOAT_EQ(result.radius, 1.5f * 3.0f);
+
+	std::mt19937 random(2);
+	std::normal_distribution<float> normal;
+	for (int i = 0; i < 1000; ++i) {
+		math::Vector3 direction = math::Normalize({ normal(random), normal(random), normal(random) });
+		math::Vector3 point = { sphere.center.x + direction.x * sphere.radius, sphere.center.y + direction.y * sphere.radius, sphere.center.z + direction.z * sphere.radius };
+		math::Vector3 transformed = math::ApplyTransform(point, matrix);
+		float dx = transformed.x - result.center.x;
+		float dy = transformed.y - result.center.y;
+		float dz = transformed.z - result.center.z;
+		EXPECT_LE(std::sqrt(dx * dx + dy * dy + dz * dz), result.radius * (1.0f + 1e-5f));
+	}
+}
+
+TEST(BoundingVolume, PerspectiveFrustumPlanesMatchClipSpace)
+{
+	ExpectPlanesMatchClipSpace(MakePerspectiveViewProjection());
+}
+
+TEST(BoundingVolume, OrthographicFrustumPlanesMatchClipSpace)
+{
+	ExpectPlanesMatchClipSpace(MakeOrthographicViewProjection());
+}
+
+TEST(BoundingVolume, FrustumPlanesAreNormalized)
+{
+	math::Frustum frustum = math::MakeFrustum(MakePerspectiveViewProjection());
+	for (const math::Plane &plane : frustum.planes) {
+		float length = std::sqrt(plane.normal.x * plane.normal.x + plane.normal.y * plane.normal.y + plane.normal.z * plane.normal.z);
+		EXPECT_NEAR(length, 1.0f, 1e-5f);
+	}
+}
+
+TEST(BoundingVolume, SphereAndAABBTestsHaveNoFalseNegatives)
+{
+	math::Frustum frustum = math::MakeFrustum(MakePerspectiveViewProjection());
+	std::vector<math::Sphere> spheres = RandomSpheres(5000, 3);
+	std::mt19937 random(4);
+	std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> unit01(0.0f, 1.0f);
+	size_t visibleCount = 0;
+	for (const math::Sphere &sphere : spheres) {
+		math::AABB aabb = {
+			{ sphere.center.x - sphere.radius, sphere.center.y - sphere.radius * 0.5f, sphere.center.z - sphere.radius },
+			{ sphere.center.x + sphere.radius, sphere.center.y + sphere.radius * 0.5f, sphere.center.z + sphere.radius },
+		};
+		bool sphereVisible = math::IsVisible(frustum, sphere);
+		bool aabbVisible = math::IsVisible(frustum, aabb);
+		bool aabbInside = math::IsInside(frustum, aabb);
+		visibleCount += sphereVisible;
+
+		for (int k = 0; k < 40; ++k) {
+			math::Vector3 offset = { unit(random), unit(random), unit(random) };
+			if (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= 1.0f) {
+				math::Vector3 point = { sphere.center.x + offset.x * sphere.radius, sphere.center.y + offset.y * sphere.radius, sphere.center.z + offset.z * sphere.radius };
+				if (IsPointInside(frustum, point)) {
+					ASSERT_TRUE(sphereVisible);
+				}
+			}
+			math::Vector3 point = {
+				aabb.min.x + (aabb.max.x - aabb.min.x) * unit01(random),
+				aabb.min.y + (aabb.max.y - aabb.min.y) * unit01(random),
+				aabb.min.z + (aabb.max.z - aabb.min.z) * unit01(random),
+			};
+			bool pointInside = IsPointInside(frustum, point);
+			if (pointInside) {
+				ASSERT_TRUE(aabbVisible);
+			}
+			// 完全に中なら、中のどの点も視錐台の中
+			if (aabbInside) {
+				ASSERT_TRUE(pointInside);
+			}
+		}
+	}
+	// 見えるものと見えないものの両方がある配置になっていること
+	EXPECT_GT(visibleCount, 0u);
+	EXPECT_LT(visibleCount, spheres.size());
+}
+
+TEST(BoundingVolume, SphereTestClassifiesObviousCases)
+{
+	// カメラは原点でZ+を向いている
+	math::Frustum frustum = math::MakeFrustum(math::MakePerspectiveFovMatrix(0.45f, 1.0f, 0.1f, 100.0f));
+	EXPECT_TRUE(math::IsVisible(frustum, math::Sphere { { 0.0f, 0.0f, 10.0f }, 1.0f }));
+	EXPECT_FALSE(math::IsVisible(frustum, math::Sphere { { 0.0f, 0.0f, -10.0f }, 1.0f })); // 後ろ
+	EXPECT_FALSE(math::IsVisible(frustum, math::Sphere { { 0.0f, 0.0f, 110.0f }, 1.0f })); // ファーより奥
+	EXPECT_FALSE(math::IsVisible(frustum, math::Sphere { { 50.0f, 0.0f, 10.0f }, 1.0f })); // 右の外
+	EXPECT_TRUE(math::IsVisible(frustum, math::Sphere { { 0.0f, 0.0f, 100.5f }, 1.0f })); // ファーをまたぐ
+	EXPECT_TRUE(math::IsVisible(frustum, math::Sphere { { 0.0f, 0.0f, -0.5f }, 1.0f })); // ニアをまたぐ
+}
+
+TEST(BoundingVolume, CullSpheresMatchesScalarTest)
+{
+	math::Frustum frustum = math::MakeFrustum(MakePerspectiveViewProjection());
+	// 4の倍数でない数も試す（SIMDの残りの処理）
+	for (size_t count : { size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(10001) }) {
+		std::vector<math::Sphere> spheres = RandomSpheres(count, static_cast<uint32_t>(count));
+		math::SphereStreams streams;
+		streams.Resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			streams.Set(i, spheres[i]);
+		}
+		std::vector<uint8_t> visible(count, 0xFF);
+		size_t visibleCount = math::CullSpheres(frustum, streams, visible.data());
+
+		size_t expectedCount = 0;
+		for (size_t i = 0; i < count; ++i) {
+			bool expected = math::IsVisible(frustum, spheres[i]);
+			expectedCount += expected;
+			ASSERT_EQ(visible[i], expected ? 1 : 0) << "sphere " << i << " of " << count;
+		}
+		EXPECT_EQ(visibleCount, expectedCount);
+	}
+}
+
+TEST(BoundingVolume, IntersectRayReportsEntryDistance)
+{
+	math::AABB aabb = { { -1.0f, -1.0f, 4.0f }, { 1.0f, 1.0f, 6.0f } };
+	math::Ray ray = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	math::Vector3 inverse = math::MakeInverseDirection(ray.direction);
+	float distance = -1.0f;
+	ASSERT_TRUE(math::IntersectRay(ray, inverse, aabb, FLT_MAX, distance));
+	EXPECT_FLOAT_EQ(distance, 4.0f);
+
+	// 届かない長さ
+	EXPECT_FALSE(math::IntersectRay(ray, inverse, aabb, 3.9f, distance));
+
+	// 逆向き
+	math::Ray backward = { { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f } };
+	EXPECT_FALSE(math::IntersectRay(backward, math::MakeInverseDirection(backward.direction), aabb, FLT_MAX, distance));
+
+	// 始点が中なら0
+	math::Ray insideRay = { { 0.0f, 0.0f, 5.0f }, { 1.0f, 0.0f, 0.0f } };
+	ASSERT_TRUE(math::IntersectRay(insideRay, math::MakeInverseDirection(insideRay.direction), aabb, FLT_MAX, distance));
+	EXPECT_EQ(distance, 0.0f);
+}
+
+TEST(BoundingVolume, IntersectRayHandlesAxisParallelRaysOnFaces)
+{
+	// 方向の0の成分で、始点が面の上にあってもNaNにならない
+	math::AABB aabb = { { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 1.0f } };
+	math::Ray onFace = { { 0.0f, 0.5f, -1.0f }, { 0.0f, 0.0f, 1.0f } };
+	float distance = -1.0f;
+	ASSERT_TRUE(math::IntersectRay(onFace, math::MakeInverseDirection(onFace.direction), aabb, FLT_MAX, distance));
+	EXPECT_FLOAT_EQ(distance, 1.0f);
+
+	math::Ray outside = { { -0.01f, 0.5f, -1.0f }, { 0.0f, 0.0f, 1.0f } };
+	EXPECT_FALSE(math::IntersectRay(outside, math::MakeInverseDirection(outside.direction), aabb, FLT_MAX, distance));
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "Camera.h"
+#include "MathFunctions.h"
+
+// 1万個のObject3d::Updateの行列の計算（定数バッファへの書き込みと境界ボリュームは含まない）
+// 以前: オブジェクトごとにワールド行列・カメラ行列・その逆行列・透視投影行列を作り、2回掛けてWVPにする
+// 今: カメラはフレームに1回だけUpdateし、オブジェクトはワールド行列だけ作る（ビュー射影はシェーダーで掛ける）
+// items_per_secondは1秒あたりのオブジェクト数
+namespace {
+
+	constexpr size_t kObjectCount = 10000;
+	constexpr float kScreenWidth = 1280.0f;
+	constexpr float kScreenHeight = 720.0f;
+
+	const std::vector<math::Transform> &GetTransforms()
+	{
+		static const std::vector<math::Transform> transforms = [] {
+			std::vector<math::Transform> result(kObjectCount);
+			std::mt19937 random(11);
+			std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+			for (math::Transform &transform : result) {
+				transform.scale = { 1.0f + unit(random) * 0.5f, 1.0f + unit(random) * 0.5f, 1.0f + unit(random) * 0.5f };
+				transform.rotate = { unit(random) * 3.14f, unit(random) * 3.14f, unit(random) * 3.14f };
+				transform.translate = { unit(random) * 50.0f, unit(random) * 10.0f, unit(random) * 50.0f };
+			}
+			return result;
+			}();
+		return transforms;
+	}
+
+	struct TransformationMatrix
+	{
+		math::Matrix4x4 WVP;
+		math::Matrix4x4 World;
+	};
+
+	// 以前のObject3d::Update（カメラは各オブジェクトが持っていた）
+	void BM_Object3dUpdatePerObjectCamera(benchmark::State &state)
+	{
+		const std::vector<math::Transform> &transforms = GetTransforms();
+		const math::Transform cameraTransform = { { 1.0f, 1.0f, 1.0f }, { 0.3f, 0.0f, 0.0f }, { 0.0f, 4.0f, -10.0f } };
+		std::vector<TransformationMatrix> matrices(kObjectCount);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kObjectCount; ++i) {
+				const math::Transform &transform = transforms[i];
+				math::Matrix4x4 worldMatrix = math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+				math::Matrix4x4 cameraMatrix = math::MakeAffineMatrix(cameraTransform.scale, cameraTransform.rotate, cameraTransform.translate);
+				math::Matrix4x4 viewMatrix = math::Inverse(cameraMatrix);
+				math::Matrix4x4 projectionMatrix = math::MakePerspectiveFovMatrix(0.45f, kScreenWidth / kScreenHeight, 0.1f, 100.0f);
+				matrices[i].WVP = worldMatrix * viewMatrix * projectionMatrix;
+				matrices[i].World = worldMatrix;
+			}
+			benchmark::DoNotOptimize(matrices.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+	}
+
+	// 今のObject3d::Update（カメラが動いたフレームを想定して毎回カメラも作り直す）
+	void BM_Object3dUpdateSharedCamera(benchmark::State &state)
+	{
+		const std::vector<math::Transform> &transforms = GetTransforms();
+		Camera camera(kScreenWidth, kScreenHeight);
+		std::vector<math::Matrix4x4> worldMatrices(kObjectCount);
+		float angle = 0.0f;
+		for (auto _ : state) {
+			angle += 0.001f;
+			camera.SetRotate({ 0.3f, angle, 0.0f });
+			camera.Update();
+			for (size_t i = 0; i < kObjectCount; ++i) {
+				const math::Transform &transform = transforms[i];
+				worldMatrices[i] = math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+			}
+			benchmark::DoNotOptimize(worldMatrices.data());
+			benchmark::DoNotOptimize(camera.GetViewProjectionMatrix());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+	}
+
+	// カメラのUpdate1回（ビュー・射影・ビュー射影を作り直す場合と、何も変わっていない場合）
+	void BM_CameraUpdate(benchmark::State &state)
+	{
+		const bool dirty = state.range(0) != 0;
+		Camera camera(kScreenWidth, kScreenHeight);
+		float angle = 0.0f;
+		for (auto _ : state) {
+			if (dirty) {
+				angle += 0.001f;
+				camera.SetRotate({ 0.3f, angle, 0.0f });
+				camera.SetFovY(0.45f + angle * 0.01f);
+			}
+			camera.Update();
+			benchmark::DoNotOptimize(camera.GetViewProjectionMatrix());
+		}
+	}
+
+}
+
+BENCHMARK(BM_Object3dUpdatePerObjectCamera)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Object3dUpdateSharedCamera)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CameraUpdate)->Arg(0)->Arg(1);
\ No newline at end of file
@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include "Camera.h"
+#include "MathFunctions.h"
+
+// カメラ
+// 変わった行列だけ作り直すことと番号の進み方、行列がMakePerspectiveFovMatrix・MakeOrthographicMatrixで作ったものと一致すること
+// ScreenPointToRayで作ったレイが、ワールドの点を画面に映した位置から逆にたどってその点を通ること
+namespace {
+
+	constexpr float kScreenWidth = 1280.0f;
+	constexpr float kScreenHeight = 720.0f;
+
+	bool SameMatrix(const math::Matrix4x4 &lhs, const math::Matrix4x4 &rhs)
+	{
+		return std::memcmp(&lhs, &rhs, sizeof(math::Matrix4x4)) == 0;
+	}
+
+	// 点からレイ（直線）までの距離
+	float DistanceToRay(const math::Ray &ray, const math::Vector3 &point)
+	{
+		math::Vector3 offset = { point.x - ray.origin.x, point.y - ray.origin.y, point.z - ray.origin.z };
+		float along = offset.x * ray.direction.x + offset.y * ray.direction.y + offset.z * ray.direction.z;
+		math::Vector3 perpendicular = { offset.x - ray.direction.x * along, offset.y - ray.direction.y * along, offset.z - ray.direction.z * along };
+		return std::sqrt(perpendicular.x * perpendicular.x + perpendicular.y * perpendicular.y + perpendicular.z * perpendicular.z);
+	}
+
+	// ワールドの点を画面のピクセル座標へ
+	math::Vector2 WorldToScreen(const Camera &camera, const math::Vector3 &point)
+	{
+		math::Vector3 ndc = math::ApplyTransform(point, camera.GetViewProjectionMatrix());
+		return { (ndc.x + 1.0f) * 0.5f * kScreenWidth, (1.0f - ndc.y) * 0.5f * kScreenHeight };
+	}
+
+	const math::Vector3 kPoints[] = {
+		{ 0.0f, 0.0f, 0.0f },
+		{ 3.0f, 1.0f, 5.0f },
+		{ -4.0f, -2.0f, 20.0f },
+		{ 1.5f, 6.0f, 40.0f },
+	};
+
+}
+
+TEST(Camera, ConstructorUsesScreenAspect)
+{
+	Camera camera(kScreenWidth, kScreenHeight);
+	EXPECT_FLOAT_EQ(camera.GetAspectRatio(), kScreenWidth / kScreenHeight);
+	EXPECT_EQ(camera.GetVersion(), 1u);
+}
+
+TEST(Camera, UpdateRebuildsOnlyWhenDirty)
+{
+	Camera camera(kScreenWidth, kScreenHeight);
+	uint32_t version = camera.GetVersion();
+	camera.Update();
+	EXPECT_EQ(camera.GetVersion(), version);
+
+	// ビューだけ変える: 射影はそのまま
+	math::Matrix4x4 projection = camera.GetProjectionMatrix();
+	camera.SetTranslate({ 1.0f, 2.0f, -5.0f });
+	camera.Update();
+	EXPECT_EQ(camera.GetVersion(), version + 1);
+	EXPECT_TRUE(SameMatrix(camera.GetProjectionMatrix(), projection));
+	camera.Update();
+	EXPECT_EQ(camera.GetVersion(), version + 1);
+
+	// 射影だけ変える: ビューはそのまま
+	math::Matrix4x4 view = camera.GetViewMatrix();
+	camera.SetFovY(0.8f);
+	camera.SetFarClip(500.0f);
+	camera.Update();
+	EXPECT_EQ(camera.GetVersion(), version + 2);
+	EXPECT_TRUE(SameMatrix(camera.GetViewMatrix(), view));
+	EXPECT_FALSE(SameMatrix(camera.GetProjectionMatrix(), projection));
+
+	// 画面の大きさはレイの変換にしか使わないので作り直さない
+	camera.SetScreenSize(640.0f, 360.0f);
+	camera.Update();
+	EXPECT_EQ(camera.GetVersion(), version + 2);
+}
+
+TEST(Camera, PerspectiveMatchesMathFunctions)
+{
+	Camera camera(kScreenWidth, kScreenHeight);
+	camera.SetRotate({ 0.3f, -0.5f, 0.1f });
+	camera.SetTranslate({ 2.0f, 4.0f, -10.0f });
+	camera.SetFovY(0.6f);
+	camera.SetNearClip(0.5f);
+	camera.SetFarClip(300.0f);
+	camera.Update();
+
+	math::Matrix4x4 world = math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, -0.5f, 0.1f }, { 2.0f, 4.0f, -10.0f });
+	math::Matrix4x4 view = math::Inverse(world);
+	math::Matrix4x4 projection = math::MakePerspectiveFovMatrix(0.6f, kScreenWidth / kScreenHeight, 0.5f, 300.0f);
+	EXPECT_TRUE(SameMatrix(camera.GetWorldMatrix(), world));
+	EXPECT_TRUE(SameMatrix(camera.GetViewMatrix(), view));
+	EXPECT_TRUE(SameMatrix(camera.GetProjectionMatrix(), projection));
+	EXPECT_TRUE(SameMatrix(camera.GetViewProjectionMatrix(), view * projection));
+
+	Camera::ViewData viewData = camera.GetViewData();
+	EXPECT_TRUE(SameMatrix(viewData.viewProjection, view * projection));
+	EXPECT_FLOAT_EQ(viewData.worldPosition.z, -10.0f);
+}
+
+TEST(Camera, OrthographicMatchesMathFunctions)
+{
+	Camera camera(kScreenWidth, kScreenHeight);
+	camera.SetProjectionType(Camera::ProjectionType::kOrthographic);
+	camera.SetOrthographicSize(16.0f, 9.0f);
+	camera.Update();
+
+	math::Matrix4x4 projection = math::MakeOrthographicMatrix(-8.0f, 4.5f, 8.0f, -4.5f, 0.1f, 100.0f);
+	EXPECT_TRUE(SameMatrix(camera.GetProjectionMatrix(), projection));
+	EXPECT_TRUE(SameMatrix(camera.GetViewProjectionMatrix(), camera.GetViewMatrix() * projection));
+
+	// 透視投影に戻すと同じ行列に戻る
+	camera.SetProjectionType(Camera::ProjectionType::kPerspective);
+	camera.Update();
+	EXPECT_TRUE(SameMatrix(camera.GetProjectionMatrix(), math::MakePerspectiveFovMatrix(0.45f, kScreenWidth / kScreenHeight, 0.1f, 100.0f)));
+}
+
+TEST(Camera, ScreenPointToRayInvertsProjection)
+{
+	Camera camera(kScreenWidth, kScreenHeight);
+	camera.SetRotate({ 0.2f, 0.3f, 0.0f });
+	camera.SetTranslate({ -1.0f, 3.0f, -12.0f });
+	camera.Update();
+
+	for (const math::Vector3 &point : kPoints) {
+		math::Ray ray = camera.ScreenPointToRay(WorldToScreen(camera, point));
+		EXPECT_NEAR(DistanceToRay(ray, point), 0.0f, 1e-3f);
+		// 方向は正規化され、点はレイの前方にある
+		float length = std::sqrt(ray.direction.x * ray.direction.x + ray.direction.y * ray.direction.y + ray.direction.z * ray.direction.z);
+		EXPECT_NEAR(length, 1.0f, 1e-5f);
+		math::Vector3 offset = { point.x - ray.origin.x, point.y - ray.origin.y, point.z - ray.origin.z };
+		EXPECT_GT(offset.x * ray.direction.x + offset.y * ray.direction.y + offset.z * ray.direction.z, 0.0f);
+		// 始点はニア面（正規化デバイス座標のz=0）
+		EXPECT_NEAR(math::ApplyTransform(ray.origin, camera.GetViewProjectionMatrix()).z, 0.0f, 1e-4f);
+	}
+
+	// 画面の中心はカメラの前方
+	math::Ray center = camera.ScreenPointToRay({ kScreenWidth * 0.5f, kScreenHeight * 0.5f });
+	math::Vector3 forward = math::Normalize(math::TransformNormal({ 0.0f, 0.0f, 1.0f }, camera.GetWorldMatrix()));
+	EXPECT_NEAR(center.direction.x, forward.x, 1e-4f);
+	EXPECT_NEAR(center.direction.y, forward.y, 1e-4f);
+	EXPECT_NEAR(center.direction.z, forward.z, 1e-4f);
+}
+
+TEST(Camera, OrthographicRaysAreParallel)
+{
+	Camera camera(kScreenWidth, kScreenHeight);
+	camera.SetProjectionType(Camera::ProjectionType::kOrthographic);
+	camera.SetOrthographicSize(32.0f, 18.0f);
+	camera.SetRotate({ 0.0f, 0.4f, 0.0f });
+	camera.Update();
+
+	math::Vector3 forward = math::Normalize(math::TransformNormal({ 0.0f, 0.0f, 1.0f }, camera.GetWorldMatrix()));
+	for (const math::Vector3 &point : kPoints) {
+		math::Ray ray = camera.ScreenPointToRay(WorldToScreen(camera, point));
+		EXPECT_NEAR(DistanceToRay(ray, point), 0.0f, 1e-3f);
+		EXPECT_NEAR(ray.direction.x, forward.x, 1e-5f);
+		EXPECT_NEAR(ray.direction.y, forward.y, 1e-5f);
+		EXPECT_NEAR(ray.direction.z, forward.z, 1e-5f);
+	}
+}
+
+TEST(Camera, ScreenSizeScalesPixelCoordinates)
+{
+	// 同じカメラで画面の大きさだけ半分にすると、半分のピクセル座標が同じレイになる
+	Camera camera(kScreenWidth, kScreenHeight);
+	math::Ray full = camera.ScreenPointToRay({ 900.0f, 200.0f });
+	camera.SetScreenSize(kScreenWidth * 0.5f, kScreenHeight * 0.5f);
+	math::Ray half = camera.ScreenPointToRay({ 450.0f, 100.0f });
+	EXPECT_FLOAT_EQ(full.direction.x, half.direction.x);
+	EXPECT_FLOAT_EQ(full.direction.y, half.direction.y);
+	EXPECT_FLOAT_EQ(full.direction.z, half.direction.z);
+}
\ No newline at end of file
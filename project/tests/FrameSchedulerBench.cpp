@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+#include "FrameScheduler.h"
+#include "fakes/FakeFrameFence.h"
+
+// フレームレイテンシごとの1フレームの時間（偽のGPUの仮想時間、CPU 8ms・GPU 10ms）
+// BeginFrame/EndFrameそのものの処理時間と、仮想時間での1フレームの時間・CPUが待った時間を報告する
+namespace {
+
+	constexpr double kCpuFrameTime = 8.0;
+	constexpr double kGpuFrameTime = 10.0;
+
+	void BM_FrameScheduler(benchmark::State &state)
+	{
+		uint32_t latency = static_cast<uint32_t>(state.range(0));
+		FakeFrameFence fence(kGpuFrameTime);
+		FrameScheduler scheduler;
+		scheduler.Initialize(latency);
+
+		for (auto _ : state) {
+			scheduler.BeginFrame(fence);
+			fence.Elapse(kCpuFrameTime);
+			benchmark::DoNotOptimize(scheduler.EndFrame(fence));
+		}
+		scheduler.WaitForIdle(fence);
+
+		double frames = static_cast<double>(state.iterations());
+		state.counters["virtual_ms_per_frame"] = fence.GetNow() / frames;
+		state.counters["cpu_wait_ms_per_frame"] = fence.GetWaitedTime() / frames;
+	}
+}
+
+BENCHMARK(BM_FrameScheduler)->ArgName("latency")->DenseRange(1, FrameScheduler::kMaxFrameLatency);
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include <gtest/gtest.h>
+#include <array>
+#include "FrameScheduler.h"
+#include "fakes/FakeFrameFence.h"
+
+// 偽のフェンスで、コンテキスト（コマンドアロケータなど）をGPUが使い終わる前に再利用しないことを確かめる
+namespace {
+
+	// frames回フレームを回し、BeginFrameで返されたコンテキストの前回のフェンス値が完了していることを確かめる
+	void RunFrames(FrameScheduler &scheduler, FakeFrameFence &fence, int frames, double cpuFrameTime)
+	{
+		std::array<uint64_t, FrameScheduler::kMaxFrameLatency> contextFenceValues {};
+		for (int frame = 0; frame < frames; ++frame) {
+			uint32_t index = scheduler.BeginFrame(fence);
+			ASSERT_LT(index, scheduler.GetFrameLatency());
+			ASSERT_GE(fence.GetCompletedValue(), contextFenceValues[index])
+				<< "context " << index << " reused before its fence completed (frame " << frame << ")";
+
+			fence.Elapse(cpuFrameTime);
+			uint64_t fenceValue = scheduler.EndFrame(fence);
+			contextFenceValues[index] = fenceValue;
+
+			// GPUより先に進めるのはフレームレイテンシ分まで
+			ASSERT_LE(fenceValue - fence.GetCompletedValue(), scheduler.GetFrameLatency());
+		}
+	}
+}
+
+TEST(FrameScheduler, ContextsAreNotReusedBeforeTheirFenceCompletes)
+{
+	for (uint32_t latency = 1; latency <= FrameScheduler::kMaxFrameLatency; ++latency) {
+		SCOPED_TRACE(testing::Message() << "latency " << latency);
+		// GPUが遅い場合と速い場合
+		for (double gpuFrameTime : { 10.0, 3.0 }) {
+			FakeFrameFence fence(gpuFrameTime);
+			FrameScheduler scheduler;
+			scheduler.Initialize(latency);
+			RunFrames(scheduler, fence, 100, 8.0);
+		}
+	}
+}
+
+TEST(FrameScheduler, FrameIndexWrapsAtFrameLatency)
+{
+	FakeFrameFence fence(1.0);
+	FrameScheduler scheduler;
+	scheduler.Initialize(FrameScheduler::kMaxFrameLatency);
+	for (uint32_t frame = 0; frame < FrameScheduler::kMaxFrameLatency * 3; ++frame) {
+		EXPECT_EQ(scheduler.BeginFrame(fence), frame % FrameScheduler::kMaxFrameLatency);
+		EXPECT_EQ(scheduler.GetCurrentFrameFenceValue(), frame + 1u);
+		EXPECT_EQ(scheduler.EndFrame(fence), frame + 1u);
+	}
+}
+
+TEST(FrameScheduler, LatencyIsClampedToMax)
+{
+	FrameScheduler scheduler;
+	scheduler.Initialize(FrameScheduler::kMaxFrameLatency + 5);
+	EXPECT_EQ(scheduler.GetFrameLatency(), FrameScheduler::kMaxFrameLatency);
+}
+
+TEST(FrameScheduler, WaitsOnlyWhenTheReusedContextIsBusy)
+{
+	// GPUが1フレーム30、CPUはすぐに記録し終わる
+	FakeFrameFence fence(30.0);
+	FrameScheduler scheduler;
+	scheduler.Initialize(3);
+
+	// 最初の3フレームはどのコンテキストも未使用なので待たない
+	for (int frame = 0; frame < 3; ++frame) {
+		scheduler.BeginFrame(fence);
+		scheduler.EndFrame(fence);
+	}
+	EXPECT_EQ(fence.GetWaitCount(), 0u);
+
+	// 4フレーム目はコンテキスト0（フェンス値1）の完了を待つ
+	EXPECT_EQ(scheduler.BeginFrame(fence), 0u);
+	EXPECT_EQ(fence.GetWaitCount(), 1u);
+	EXPECT_EQ(fence.GetCompletedValue(), 1u);
+	EXPECT_DOUBLE_EQ(fence.GetNow(), 30.0);
+	scheduler.EndFrame(fence);
+}
+
+TEST(FrameScheduler, LatencyOneWaitsForEveryFrame)
+{
+	FakeFrameFence fence(10.0);
+	FrameScheduler scheduler;
+	scheduler.Initialize(1);
+	for (uint64_t frame = 1; frame <= 5; ++frame) {
+		scheduler.BeginFrame(fence);
+		// 前のフレームは終わっている
+		EXPECT_EQ(fence.GetCompletedValue(), frame - 1);
+		scheduler.EndFrame(fence);
+	}
+}
+
+TEST(FrameScheduler, OverlapHidesGpuTime)
+{
+	// CPU 8・GPU 10のとき、1フレームずつ待つと18かかるが、重ねればGPUの10に近づく
+	const int frames = 200;
+	double frameTimes[FrameScheduler::kMaxFrameLatency + 1] = {};
+	for (uint32_t latency = 1; latency <= FrameScheduler::kMaxFrameLatency; ++latency) {
+		FakeFrameFence fence(10.0);
+		FrameScheduler scheduler;
+		scheduler.Initialize(latency);
+		RunFrames(scheduler, fence, frames, 8.0);
+		scheduler.WaitForIdle(fence);
+		frameTimes[latency] = fence.GetNow() / frames;
+	}
+	EXPECT_NEAR(frameTimes[1], 18.0, 0.1);
+	EXPECT_NEAR(frameTimes[2], 10.0, 0.1);
+	EXPECT_NEAR(frameTimes[3], 10.0, 0.1);
+}
+
+TEST(FrameScheduler, WaitForIdleCompletesAllSignaledFrames)
+{
+	FakeFrameFence fence(10.0);
+	FrameScheduler scheduler;
+	scheduler.Initialize(3);
+	for (int frame = 0; frame < 7; ++frame) {
+		scheduler.BeginFrame(fence);
+		scheduler.EndFrame(fence);
+	}
+	EXPECT_LT(fence.GetCompletedValue(), scheduler.GetLastSignaledValue());
+
+	scheduler.WaitForIdle(fence);
+	EXPECT_EQ(fence.GetCompletedValue(), 7u);
+	EXPECT_EQ(scheduler.GetLastSignaledValue(), 7u);
+
+	// 終わった後はもう待たない
+	uint32_t waits = fence.GetWaitCount();
+	scheduler.WaitForIdle(fence);
+	EXPECT_EQ(fence.GetWaitCount(), waits);
+
+	// 続けて使っても、どのコンテキストも待たずに始められる
+	scheduler.BeginFrame(fence);
+	EXPECT_EQ(fence.GetWaitCount(), waits);
+	scheduler.EndFrame(fence);
+}
+
+TEST(FrameScheduler, WaitForIdleBeforeAnyFrameDoesNotWait)
+{
+	FakeFrameFence fence(10.0);
+	FrameScheduler scheduler;
+	scheduler.Initialize(2);
+	scheduler.WaitForIdle(fence);
+	EXPECT_EQ(fence.GetWaitCount(), 0u);
+}
+
+TEST(FrameScheduler, InitializeResetsState)
+{
+	FakeFrameFence fence(1.0);
+	FrameScheduler scheduler;
+	scheduler.Initialize(2);
+	scheduler.BeginFrame(fence);
+	scheduler.EndFrame(fence);
+	scheduler.Initialize(3);
+	EXPECT_EQ(scheduler.GetFrameIndex(), 0u);
+	EXPECT_EQ(scheduler.GetLastSignaledValue(), 0u);
+}
\ No newline at end of file
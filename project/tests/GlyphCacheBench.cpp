@@ -0,0 +1,158 @@
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+#include "GlyphCache.h"
+#include "TextLayout.h"
+#include "TestSupport.h"
+
+// グリフキャッシュと文字列の配置の速さ（フォントはTestSupport::FindSystemFontで探す）
+// ・ラスタライズする（キャッシュにない）ときと、キャッシュにあるときの glyphs/s
+// ・ダメージの数字やタイマーのような短い文字列と、折り返す段落の strings/s
+namespace {
+
+	// フォントを読み込んだキャッシュを作る（見つからなければfalse）
+	bool LoadFont(benchmark::State &state, GlyphCache &cache, uint32_t atlasSize, uint32_t &font)
+	{
+		std::string path = TestSupport::FindSystemFont();
+		cache.Initialize(atlasSize, atlasSize);
+		int32_t loaded = path.empty() ? -1 : cache.LoadFont(path);
+		if (loaded < 0) {
+			state.SkipWithError("no TrueType font found (set GE3_TEST_FONT)");
+			return false;
+		}
+		font = uint32_t(loaded);
+		return true;
+	}
+
+	// キャッシュにないグリフをラスタライズしてアトラスに置く（ASCII 94文字 × 8通りの大きさ）
+	// 毎回空のキャッシュから始め、Initializeは時間に含めない
+	void BM_GlyphRasterize(benchmark::State &state)
+	{
+		GlyphCache cache;
+		uint32_t font = 0;
+		if (!LoadFont(state, cache, 2048, font)) {
+			return;
+		}
+		const uint32_t heights[] = { 12, 16, 20, 24, 32, 40, 48, 64 };
+		const int64_t glyphCount = int64_t(std::size(heights)) * 94;
+		for (auto _ : state) {
+			cache.Initialize(2048, 4096);
+			auto start = std::chrono::steady_clock::now();
+			for (uint32_t pixelHeight : heights) {
+				for (uint32_t codepoint = 0x21; codepoint < 0x7F; ++codepoint) {
+					benchmark::DoNotOptimize(cache.GetGlyph(font, codepoint, pixelHeight));
+				}
+			}
+			state.SetIterationTime(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+		}
+		state.SetItemsProcessed(state.iterations() * glyphCount);
+		state.counters["overflows"] = static_cast<double>(cache.GetStatistics().overflows);
+	}
+
+	// キャッシュにあるグリフ
+	void BM_GlyphCacheHit(benchmark::State &state)
+	{
+		GlyphCache cache;
+		uint32_t font = 0;
+		if (!LoadFont(state, cache, 1024, font)) {
+			return;
+		}
+		for (uint32_t codepoint = 0x20; codepoint < 0x7F; ++codepoint) {
+			cache.GetGlyph(font, codepoint, 24);
+		}
+		uint32_t codepoint = 0x20;
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(cache.GetGlyph(font, codepoint, 24));
+			codepoint = codepoint == 0x7E ? 0x20 : codepoint + 1;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// オーバーレイに出すような短い文字列
+	std::vector<std::string> MakeOverlayStrings(size_t count)
+	{
+		std::mt19937 random(11);
+		std::vector<std::string> strings(count);
+		char text[64];
+		for (size_t i = 0; i < count; ++i) {
+			switch (i % 4) {
+			case 0: std::snprintf(text, sizeof(text), "%u", uint32_t(random() % 10000)); break;
+			case 1: std::snprintf(text, sizeof(text), "HP %u/%u", uint32_t(random() % 1000), 1000u); break;
+			case 2: std::snprintf(text, sizeof(text), "%02u:%05.2f", uint32_t(random() % 60), double(random() % 6000) / 100.0); break;
+			default: std::snprintf(text, sizeof(text), "Enemy #%u took %u damage", uint32_t(random() % 100), uint32_t(random() % 1000)); break;
+			}
+			strings[i] = text;
+		}
+		return strings;
+	}
+
+	// 1フレームにcount個の短い文字列を配置する（グリフはキャッシュにある）
+	void BM_TextLayoutOverlay(benchmark::State &state)
+	{
+		GlyphCache cache;
+		uint32_t font = 0;
+		if (!LoadFont(state, cache, 1024, font)) {
+			return;
+		}
+		std::vector<std::string> strings = MakeOverlayStrings(static_cast<size_t>(state.range(0)));
+		size_t characters = 0;
+		for (const std::string &text : strings) {
+			characters += text.size();
+		}
+		TextLayout::Style style;
+		style.font = font;
+		style.pixelHeight = 20;
+		std::vector<SpriteBatcher::Quad> quads;
+		for (auto _ : state) {
+			quads.clear();
+			float y = 0.0f;
+			for (const std::string &text : strings) {
+				TextLayout::Layout(cache, text, { 16.0f, y }, style, quads);
+				y = y > 700.0f ? 0.0f : y + 1.0f;
+			}
+			cache.NextFrame();
+			benchmark::DoNotOptimize(quads.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(0));
+		state.counters["glyphs_per_s"] = benchmark::Counter(static_cast<double>(state.iterations() * characters), benchmark::Counter::kIsRate);
+		state.counters["quads"] = static_cast<double>(quads.size());
+	}
+
+	// 幅300ピクセルで折り返す段落（約450文字）
+	void BM_TextLayoutWrapped(benchmark::State &state)
+	{
+		GlyphCache cache;
+		uint32_t font = 0;
+		if (!LoadFont(state, cache, 1024, font)) {
+			return;
+		}
+		std::string paragraph;
+		while (paragraph.size() < 450) {
+			paragraph += "The quick brown fox jumps over the lazy dog. AVATAR Typography, kerning and wrapping. ";
+		}
+		TextLayout::Style style;
+		style.font = font;
+		style.pixelHeight = 18;
+		style.maxWidth = 300.0f;
+		std::vector<SpriteBatcher::Quad> quads;
+		TextLayout::Result result {};
+		for (auto _ : state) {
+			quads.clear();
+			result = TextLayout::Layout(cache, paragraph, { 0.0f, 0.0f }, style, quads);
+			benchmark::DoNotOptimize(quads.data());
+		}
+		state.SetItemsProcessed(state.iterations());
+		state.counters["glyphs_per_s"] = benchmark::Counter(static_cast<double>(state.iterations() * paragraph.size()), benchmark::Counter::kIsRate);
+		state.counters["lines"] = static_cast<double>(result.lineCount);
+	}
+
+}
+
+BENCHMARK(BM_GlyphRasterize)->UseManualTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_GlyphCacheHit);
+BENCHMARK(BM_TextLayoutOverlay)->ArgName("strings")->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TextLayoutWrapped)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
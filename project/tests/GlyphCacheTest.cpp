@@ -0,0 +1,466 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "GlyphCache.h"
+#include "TextLayout.h"
+#include "TestSupport.h"
+
+// 比べる相手としてstb_truetypeを直接呼ぶ（GlyphCache.cppと同じくこのファイルの中だけの実装にする）
+#define STBTT_STATIC
+#define STB_TRUETYPE_IMPLEMENTATION
+#include "externals/imgui/imstb_truetype.h"
+
+// グリフキャッシュと文字列の配置
+// ラスタライズした結果はstbtt_GetCodepointBitmapと1画素ずつ比べ、LRUの追い出しではこのフレームで使ったグリフが動かないことを確かめる
+// フォントはリポジトリに含めていないので、OSのフォントが見つからなければスキップする
+namespace {
+
+	// stb_truetypeで直接ラスタライズしたビットマップ
+	struct Bitmap
+	{
+		int width = 0;
+		int height = 0;
+		int offsetX = 0;
+		int offsetY = 0;
+		std::vector<uint8_t> pixels;
+	};
+
+	class FontOracle
+	{
+	public:
+		bool Load(const std::string &filePath)
+		{
+			std::ifstream file(filePath, std::ios::binary);
+			data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+			return !data.empty() && stbtt_InitFont(&info, data.data(), stbtt_GetFontOffsetForIndex(data.data(), 0));
+		}
+
+		Bitmap Rasterize(uint32_t codepoint, uint32_t pixelHeight) const
+		{
+			Bitmap bitmap;
+			float scale = stbtt_ScaleForPixelHeight(&info, float(pixelHeight));
+			unsigned char *pixels = stbtt_GetCodepointBitmap(&info, scale, scale, int(codepoint), &bitmap.width, &bitmap.height, &bitmap.offsetX, &bitmap.offsetY);
+			if (pixels) {
+				bitmap.pixels.assign(pixels, pixels + size_t(bitmap.width) * bitmap.height);
+				stbtt_FreeBitmap(pixels, nullptr);
+			}
+			return bitmap;
+		}
+
+		float Kerning(uint32_t left, uint32_t right, uint32_t pixelHeight) const
+		{
+			return float(stbtt_GetCodepointKernAdvance(&info, int(left), int(right))) * stbtt_ScaleForPixelHeight(&info, float(pixelHeight));
+		}
+
+	private:
+		std::vector<uint8_t> data;
+		stbtt_fontinfo info {};
+	};
+
+	class GlyphCacheTest : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			fontPath = TestSupport::FindSystemFont();
+			if (fontPath.empty()) {
+				GTEST_SKIP() << "no TrueType font found (set GE3_TEST_FONT)";
+			}
+			ASSERT_TRUE(oracle.Load(fontPath));
+			cache.Initialize(512, 512);
+			int32_t loaded = cache.LoadFont(fontPath);
+			ASSERT_GE(loaded, 0);
+			font = uint32_t(loaded);
+		}
+
+		// アトラスのグリフがstb_truetypeの結果と同じで、まわりの余白が空であること
+		void ExpectMatchesOracle(const GlyphCache::Glyph &glyph, uint32_t codepoint, uint32_t pixelHeight)
+		{
+			Bitmap expected = oracle.Rasterize(codepoint, pixelHeight);
+			ASSERT_EQ(glyph.width, expected.width) << "U+" << std::hex << codepoint;
+			ASSERT_EQ(glyph.height, expected.height) << "U+" << std::hex << codepoint;
+			if (expected.width == 0) {
+				return;
+			}
+			EXPECT_EQ(glyph.offsetX, expected.offsetX);
+			EXPECT_EQ(glyph.offsetY, expected.offsetY);
+			const uint8_t *pixels = cache.GetPixels();
+			const uint32_t atlasWidth = cache.GetWidth();
+			for (int y = -int(GlyphCache::kPadding); y < expected.height + int(GlyphCache::kPadding); ++y) {
+				for (int x = -int(GlyphCache::kPadding); x < expected.width + int(GlyphCache::kPadding); ++x) {
+					bool inside = x >= 0 && y >= 0 && x < expected.width && y < expected.height;
+					uint8_t actual = pixels[size_t(glyph.y + y) * atlasWidth + glyph.x + x];
+					ASSERT_EQ(actual, inside ? expected.pixels[size_t(y) * expected.width + x] : 0)
+						<< "U+" << std::hex << codepoint << std::dec << " at (" << x << ", " << y << ")";
+				}
+			}
+		}
+
+		std::string fontPath;
+		FontOracle oracle;
+		GlyphCache cache;
+		uint32_t font = 0;
+	};
+
+	// 1つの種類（16ピクセルのセル）だけが1シェルフ8個入る小さなアトラス
+	class SmallGlyphCacheTest : public GlyphCacheTest
+	{
+	protected:
+		void SetUp() override
+		{
+			GlyphCacheTest::SetUp();
+			if (IsSkipped()) {
+				return;
+			}
+			cache.Initialize(128, 16);
+			// 12ピクセルの大文字は余白込みで9～16ピクセル（16ピクセルのセル）に入る
+			for (uint32_t codepoint = 'A'; codepoint <= 'J'; ++codepoint) {
+				Bitmap bitmap = oracle.Rasterize(codepoint, kPixelHeight);
+				uint32_t cellSize = uint32_t(std::max(bitmap.width, bitmap.height)) + GlyphCache::kPadding * 2;
+				ASSERT_GT(cellSize, GlyphCache::kMinCellSize);
+				ASSERT_LE(cellSize, GlyphCache::kMinCellSize * 2);
+			}
+		}
+
+		static constexpr uint32_t kPixelHeight = 12;
+		static constexpr uint32_t kCellCount = 8;
+	};
+
+	std::vector<uint32_t> Decode(std::string_view text)
+	{
+		std::vector<uint32_t> codepoints;
+		for (size_t offset = 0; offset < text.size();) {
+			codepoints.push_back(TextLayout::DecodeUtf8(text, offset));
+		}
+		return codepoints;
+	}
+
+}
+
+TEST(GlyphCacheFont, MissingOrInvalidFileFails)
+{
+	GlyphCache cache;
+	cache.Initialize(128, 128);
+	EXPECT_EQ(cache.LoadFont("no/such/font.ttf"), -1);
+	std::string path = TestSupport::WriteTemporaryFile("ge3_not_a_font.ttf", std::string(256, 'x'));
+	EXPECT_EQ(cache.LoadFont(path), -1);
+}
+
+TEST_F(GlyphCacheTest, RasterizedGlyphsMatchStbTrueType)
+{
+	// すべてが1フレームで入る大きさ（追い出さない）
+	cache.Initialize(2048, 2048);
+	for (uint32_t pixelHeight : { 9u, 16u, 33u, 64u }) {
+		for (uint32_t codepoint = 0x21; codepoint < 0x7F; ++codepoint) {
+			const GlyphCache::Glyph glyph = cache.GetGlyph(font, codepoint, pixelHeight);
+			ExpectMatchesOracle(glyph, codepoint, pixelHeight);
+		}
+	}
+	EXPECT_EQ(cache.GetStatistics().rasterized, 4u * 94u);
+	EXPECT_EQ(cache.GetStatistics().evictions, 0u);
+	EXPECT_EQ(cache.GetResidentCount(), 4u * 94u);
+}
+
+TEST_F(GlyphCacheTest, SecondLookupIsAHit)
+{
+	GlyphCache::Glyph first = cache.GetGlyph(font, 'g', 24);
+	cache.ClearDirtyRect();
+	GlyphCache::Glyph second = cache.GetGlyph(font, 'g', 24);
+	EXPECT_EQ(first.x, second.x);
+	EXPECT_EQ(first.y, second.y);
+	EXPECT_EQ(cache.GetStatistics().hits, 1u);
+	EXPECT_EQ(cache.GetStatistics().rasterized, 1u);
+	EXPECT_FALSE(cache.IsDirty());
+	// 大きさが違えば別のグリフ
+	cache.GetGlyph(font, 'g', 25);
+	EXPECT_EQ(cache.GetStatistics().rasterized, 2u);
+}
+
+TEST_F(GlyphCacheTest, SpaceHasAdvanceButNoBitmap)
+{
+	const GlyphCache::Glyph &space = cache.GetGlyph(font, ' ', 32);
+	EXPECT_EQ(space.width, 0u);
+	EXPECT_EQ(space.height, 0u);
+	EXPECT_GT(space.advance, 0.0f);
+}
+
+TEST_F(GlyphCacheTest, DirtyRectCoversNewGlyphs)
+{
+	EXPECT_FALSE(cache.IsDirty());
+	GlyphCache::Glyph a = cache.GetGlyph(font, 'a', 20);
+	GlyphCache::Glyph w = cache.GetGlyph(font, 'W', 60);
+	ASSERT_TRUE(cache.IsDirty());
+	const GlyphCache::Rect &rect = cache.GetDirtyRect();
+	for (const GlyphCache::Glyph &glyph : { a, w }) {
+		EXPECT_LE(rect.left, glyph.x);
+		EXPECT_LE(rect.top, glyph.y);
+		EXPECT_GE(rect.right, uint32_t(glyph.x + glyph.width));
+		EXPECT_GE(rect.bottom, uint32_t(glyph.y + glyph.height));
+	}
+	cache.ClearDirtyRect();
+	EXPECT_FALSE(cache.IsDirty());
+}
+
+TEST_F(GlyphCacheTest, KerningMatchesStbTrueType)
+{
+	// どれかの組にはカーニングが付いているはず
+	const char *pairs[] = { "AV", "AT", "To", "VA", "Ty", "LT", "av", "ab" };
+	int kernedPairs = 0;
+	for (const char *pair : pairs) {
+		uint32_t left = cache.GetGlyph(font, uint32_t(pair[0]), 40).glyphIndex;
+		uint32_t right = cache.GetGlyph(font, uint32_t(pair[1]), 40).glyphIndex;
+		float expected = oracle.Kerning(uint32_t(pair[0]), uint32_t(pair[1]), 40);
+		EXPECT_FLOAT_EQ(cache.GetKerning(font, 40, left, right), expected) << pair;
+		// 2回目は覚えておいた値
+		EXPECT_FLOAT_EQ(cache.GetKerning(font, 40, left, right), expected) << pair;
+		kernedPairs += expected != 0.0f;
+	}
+	EXPECT_GT(kernedPairs, 0);
+}
+
+TEST_F(SmallGlyphCacheTest, EvictsLeastRecentlyUsed)
+{
+	// 1フレーム目: A～Hで8個のセルが埋まる
+	for (uint32_t codepoint = 'A'; codepoint < 'A' + kCellCount; ++codepoint) {
+		cache.GetGlyph(font, codepoint, kPixelHeight);
+	}
+	ASSERT_EQ(cache.GetResidentCount(), kCellCount);
+
+	// 2フレーム目: Aを使い直すと、一番長く使っていないのはB
+	cache.NextFrame();
+	cache.GetGlyph(font, 'A', kPixelHeight);
+	GlyphCache::Glyph i = cache.GetGlyph(font, 'I', kPixelHeight);
+	EXPECT_EQ(cache.GetStatistics().evictions, 1u);
+	EXPECT_EQ(cache.GetResidentCount(), kCellCount);
+	ExpectMatchesOracle(i, 'I', kPixelHeight);
+
+	// Aは残っていて、Bは追い出された
+	uint64_t rasterized = cache.GetStatistics().rasterized;
+	cache.GetGlyph(font, 'A', kPixelHeight);
+	EXPECT_EQ(cache.GetStatistics().rasterized, rasterized);
+	GlyphCache::Glyph b = cache.GetGlyph(font, 'B', kPixelHeight);
+	EXPECT_EQ(cache.GetStatistics().rasterized, rasterized + 1);
+	// 使い直したセルは前のグリフの画素が残っていない
+	ExpectMatchesOracle(b, 'B', kPixelHeight);
+}
+
+TEST_F(SmallGlyphCacheTest, OverflowsWhenEveryCellWasUsedThisFrame)
+{
+	std::vector<GlyphCache::Glyph> resident;
+	for (uint32_t codepoint = 'A'; codepoint < 'A' + kCellCount; ++codepoint) {
+		resident.push_back(cache.GetGlyph(font, codepoint, kPixelHeight));
+	}
+	std::vector<uint8_t> before(cache.GetPixels(), cache.GetPixels() + cache.GetWidth() * cache.GetHeight());
+
+	// 9個目は置けないが、送り幅は正しい（後ろの文字の位置がずれない）
+	const GlyphCache::Glyph overflow = cache.GetGlyph(font, 'I', kPixelHeight);
+	EXPECT_EQ(overflow.width, 0u);
+	EXPECT_EQ(overflow.height, 0u);
+	EXPECT_GT(overflow.advance, 0.0f);
+	EXPECT_EQ(cache.GetStatistics().overflows, 1u);
+	EXPECT_EQ(cache.GetStatistics().evictions, 0u);
+	// このフレームで使ったグリフは動かず、画素も変わらない
+	for (uint32_t index = 0; index < kCellCount; ++index) {
+		GlyphCache::Glyph glyph = cache.GetGlyph(font, 'A' + index, kPixelHeight);
+		EXPECT_EQ(glyph.x, resident[index].x);
+		EXPECT_EQ(glyph.y, resident[index].y);
+	}
+	EXPECT_TRUE(std::equal(before.begin(), before.end(), cache.GetPixels()));
+
+	// 次のフレームなら追い出して置ける
+	cache.NextFrame();
+	const GlyphCache::Glyph placed = cache.GetGlyph(font, 'I', kPixelHeight);
+	EXPECT_GT(placed.width, 0u);
+	EXPECT_EQ(cache.GetStatistics().evictions, 1u);
+	ExpectMatchesOracle(placed, 'I', kPixelHeight);
+}
+
+TEST_F(GlyphCacheTest, StressNeverMovesGlyphsUsedThisFrame)
+{
+	// 小さなアトラスに、入りきらない数のグリフを何フレームも出し入れする
+	cache.Initialize(256, 256);
+	std::mt19937 random(5);
+	const uint32_t heights[] = { 10, 14, 20, 28, 40, 60, 100 };
+	struct Used
+	{
+		uint32_t codepoint;
+		uint32_t pixelHeight;
+		GlyphCache::Glyph glyph;
+	};
+	for (int frame = 0; frame < 200; ++frame) {
+		std::vector<Used> used;
+		for (int i = 0; i < 40; ++i) {
+			uint32_t codepoint = 0x21 + uint32_t(random() % 94);
+			uint32_t pixelHeight = heights[random() % std::size(heights)];
+			GlyphCache::Glyph glyph = cache.GetGlyph(font, codepoint, pixelHeight);
+			if (glyph.width > 0) {
+				used.push_back({ codepoint, pixelHeight, glyph });
+			}
+		}
+		// フレームの終わりまで、使ったグリフは同じ場所に同じ画素のまま
+		for (const Used &entry : used) {
+			GlyphCache::Glyph glyph = cache.GetGlyph(font, entry.codepoint, entry.pixelHeight);
+			ASSERT_EQ(glyph.x, entry.glyph.x) << "frame " << frame;
+			ASSERT_EQ(glyph.y, entry.glyph.y) << "frame " << frame;
+			ExpectMatchesOracle(glyph, entry.codepoint, entry.pixelHeight);
+		}
+		cache.NextFrame();
+	}
+	EXPECT_GT(cache.GetStatistics().evictions, 1000u);
+}
+
+TEST(TextLayoutUtf8, DecodesValidSequences)
+{
+	EXPECT_EQ(Decode("A"), (std::vector<uint32_t> { 'A' }));
+	EXPECT_EQ(Decode("\xC3\xA9"), (std::vector<uint32_t> { 0xE9 })); // é
+	EXPECT_EQ(Decode("\xE3\x81\x82"), (std::vector<uint32_t> { 0x3042 })); // あ
+	EXPECT_EQ(Decode("\xF0\x9F\x98\x80"), (std::vector<uint32_t> { 0x1F600 }));
+	EXPECT_EQ(Decode("\xF4\x8F\xBF\xBF"), (std::vector<uint32_t> { 0x10FFFF }));
+	EXPECT_EQ(Decode("a\xE3\x81\x82z"), (std::vector<uint32_t> { 'a', 0x3042, 'z' }));
+}
+
+TEST(TextLayoutUtf8, MalformedBytesBecomeReplacementCharacters)
+{
+	const uint32_t bad = 0xFFFD;
+	// 続きのバイトだけ・先頭にならないバイト
+	EXPECT_EQ(Decode("\x80"), (std::vector<uint32_t> { bad }));
+	EXPECT_EQ(Decode("\xFF" "A"), (std::vector<uint32_t> { bad, 'A' }));
+	// 途中で切れている（先頭の1byteだけ捨てて、残りも1つずつ不正になる）
+	EXPECT_EQ(Decode("\xE3\x81"), (std::vector<uint32_t> { bad, bad }));
+	// 続きのバイトの形が違う（後ろのASCIIは失わない）
+	EXPECT_EQ(Decode("\xE3" "AB"), (std::vector<uint32_t> { bad, 'A', 'B' }));
+	// 冗長な表現・サロゲート・範囲外は1文字分まとめて不正
+	EXPECT_EQ(Decode("\xC0\xAF" "x"), (std::vector<uint32_t> { bad, 'x' }));
+	EXPECT_EQ(Decode("\xE0\x80\xAF"), (std::vector<uint32_t> { bad }));
+	EXPECT_EQ(Decode("\xED\xA0\x80"), (std::vector<uint32_t> { bad }));
+	EXPECT_EQ(Decode("\xF4\x90\x80\x80"), (std::vector<uint32_t> { bad }));
+}
+
+TEST_F(GlyphCacheTest, LayoutAppliesAdvanceAndKerning)
+{
+	TextLayout::Style style;
+	style.font = font;
+	style.pixelHeight = 40;
+	const math::Vector2 origin = { 100.25f, 50.0f };
+	std::vector<SpriteBatcher::Quad> quads;
+	TextLayout::Result result = TextLayout::Layout(cache, "AVA Ty", origin, style, quads);
+	EXPECT_EQ(result.lineCount, 1u);
+	EXPECT_EQ(result.quadCount, 5u); // 空白は四角形にしない
+	ASSERT_EQ(quads.size(), 5u);
+
+	// ペンを自分で進めて比べる
+	GlyphCache::LineMetrics metrics = cache.GetLineMetrics(font, 40);
+	float pen = 0.0f;
+	uint32_t previous = UINT32_MAX;
+	size_t quadIndex = 0;
+	for (char character : std::string("AVA Ty")) {
+		GlyphCache::Glyph glyph = cache.GetGlyph(font, uint32_t(character), 40);
+		if (previous != UINT32_MAX) {
+			pen += oracle.Kerning(previous, uint32_t(character), 40);
+		}
+		previous = uint32_t(character);
+		if (glyph.width > 0) {
+			const SpriteBatcher::Quad &quad = quads[quadIndex++];
+			EXPECT_FLOAT_EQ(quad.position.x, std::round(origin.x + pen + glyph.offsetX)) << character;
+			EXPECT_FLOAT_EQ(quad.position.y, std::round(origin.y + metrics.ascent + glyph.offsetY)) << character;
+			EXPECT_FLOAT_EQ(quad.size.x, float(glyph.width));
+			EXPECT_FLOAT_EQ(quad.textureLeftTop.x, float(glyph.x));
+			EXPECT_FLOAT_EQ(quad.textureLeftTop.y, float(glyph.y));
+		}
+		pen += glyph.advance;
+	}
+	EXPECT_GT(result.size.x, 0.0f);
+}
+
+TEST_F(GlyphCacheTest, LayoutBreaksLinesOnNewline)
+{
+	TextLayout::Style style;
+	style.font = font;
+	style.pixelHeight = 20;
+	std::vector<SpriteBatcher::Quad> quads;
+	TextLayout::Result result = TextLayout::Layout(cache, "ab\r\ncd\n\nx", { 0.0f, 0.0f }, style, quads);
+	EXPECT_EQ(result.lineCount, 4u);
+	ASSERT_EQ(quads.size(), 5u);
+
+	GlyphCache::LineMetrics metrics = cache.GetLineMetrics(font, 20);
+	float lineHeight = std::round(metrics.ascent - metrics.descent + metrics.lineGap);
+	EXPECT_FLOAT_EQ(result.size.y, lineHeight * 4.0f);
+	// 各行の先頭の文字は、その文字だけを配置したものから行送りの分だけ下にずれる（\rは無視する）
+	const std::pair<size_t, char> lineStarts[] = { { 0, 'a' }, { 2, 'c' }, { 4, 'x' } };
+	const float lineIndices[] = { 0.0f, 1.0f, 3.0f };
+	for (size_t i = 0; i < std::size(lineStarts); ++i) {
+		std::vector<SpriteBatcher::Quad> single;
+		TextLayout::Layout(cache, std::string(1, lineStarts[i].second), { 0.0f, 0.0f }, style, single);
+		ASSERT_EQ(single.size(), 1u);
+		const SpriteBatcher::Quad &quad = quads[lineStarts[i].first];
+		EXPECT_FLOAT_EQ(quad.position.x, single[0].position.x) << lineStarts[i].second;
+		EXPECT_FLOAT_EQ(quad.position.y, single[0].position.y + lineHeight * lineIndices[i]) << lineStarts[i].second;
+	}
+}
+
+TEST_F(GlyphCacheTest, LayoutWrapsAfterSpaces)
+{
+	TextLayout::Style style;
+	style.font = font;
+	style.pixelHeight = 20;
+	std::vector<SpriteBatcher::Quad> quads;
+	// 「aaa bbb」がちょうど入る幅にすると、cccは次の行へ行く
+	TextLayout::Result twoWords = TextLayout::Layout(cache, "aaa bbb", { 0.0f, 0.0f }, style, quads);
+	style.maxWidth = twoWords.size.x + 1.0f;
+	quads.clear();
+	TextLayout::Result result = TextLayout::Layout(cache, "aaa bbb ccc", { 10.0f, 20.0f }, style, quads);
+	EXPECT_EQ(result.lineCount, 2u);
+	ASSERT_EQ(quads.size(), 9u);
+
+	std::vector<SpriteBatcher::Quad> firstLine;
+	TextLayout::Layout(cache, "a", { 10.0f, 20.0f }, style, firstLine);
+	std::vector<SpriteBatcher::Quad> secondLine;
+	TextLayout::Layout(cache, "c", { 10.0f, 20.0f }, style, secondLine);
+	GlyphCache::LineMetrics metrics = cache.GetLineMetrics(font, 20);
+	float lineHeight = std::round(metrics.ascent - metrics.descent + metrics.lineGap);
+	// cccの先頭は2行目の行頭（空白とのカーニングで1ピクセルずれることはある）
+	EXPECT_NEAR(quads[6].position.x, secondLine[0].position.x, 1.0f);
+	EXPECT_NEAR(quads[6].position.y, secondLine[0].position.y + lineHeight, 1.0f);
+	EXPECT_FLOAT_EQ(quads[0].position.x, firstLine[0].position.x);
+	for (const SpriteBatcher::Quad &quad : quads) {
+		EXPECT_LE(quad.position.x + quad.size.x - 10.0f, style.maxWidth + 1.0f);
+	}
+	EXPECT_LE(result.size.x, style.maxWidth + 1.0f);
+}
+
+TEST_F(GlyphCacheTest, LayoutBreaksLongWordBetweenCharacters)
+{
+	TextLayout::Style style;
+	style.font = font;
+	style.pixelHeight = 20;
+	style.maxWidth = 40.0f;
+	std::vector<SpriteBatcher::Quad> quads;
+	TextLayout::Result result = TextLayout::Layout(cache, "abcdefghijklmnop", { 0.0f, 0.0f }, style, quads);
+	EXPECT_GT(result.lineCount, 3u);
+	EXPECT_EQ(quads.size(), 16u);
+	// 行頭の文字以外は幅に収まる
+	for (size_t i = 0; i < quads.size(); ++i) {
+		bool lineStart = i == 0 || quads[i].position.y > quads[i - 1].position.y;
+		if (!lineStart) {
+			EXPECT_LE(quads[i].position.x + quads[i].size.x, style.maxWidth + 1.0f) << "quad " << i;
+		}
+	}
+}
+
+TEST_F(GlyphCacheTest, LayoutDrawsReplacementForMalformedUtf8)
+{
+	TextLayout::Style style;
+	style.font = font;
+	style.pixelHeight = 20;
+	std::vector<SpriteBatcher::Quad> quads;
+	TextLayout::Result result = TextLayout::Layout(cache, "A\xFF" "B\xE3", { 0.0f, 0.0f }, style, quads);
+	EXPECT_EQ(result.lineCount, 1u);
+	// A・U+FFFD・B・U+FFFD（フォントにU+FFFDがなければ.notdefの形になる）
+	EXPECT_EQ(quads.size(), 4u);
+}
\ No newline at end of file
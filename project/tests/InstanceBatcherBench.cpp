@@ -0,0 +1,70 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+#include "InstanceBatcher.h"
+
+// 10000オブジェクトをモデルごとにまとめる: InstanceBatcher（計数ソート）と、stable_sortで詰め直す場合
+// draw_callsはまとめた後のDraw回数（まとめなければオブジェクト数と同じ）
+namespace {
+
+	constexpr size_t kObjectCount = 10000;
+
+	struct Scene
+	{
+		std::vector<uint32_t> keys;
+		std::vector<math::Matrix4x4> worlds;
+	};
+
+	Scene MakeScene(uint32_t models)
+	{
+		std::mt19937 random(1);
+		Scene scene;
+		scene.keys.resize(kObjectCount);
+		scene.worlds.resize(kObjectCount);
+		for (size_t i = 0; i < kObjectCount; ++i) {
+			scene.keys[i] = random() % models;
+			scene.worlds[i] = {};
+			scene.worlds[i].m[3][0] = static_cast<float>(i);
+		}
+		return scene;
+	}
+
+	void BM_InstanceBatcher(benchmark::State &state)
+	{
+		Scene scene = MakeScene(static_cast<uint32_t>(state.range(0)));
+		InstanceBatcher batcher;
+		for (auto _ : state) {
+			batcher.Clear();
+			for (size_t i = 0; i < kObjectCount; ++i) {
+				batcher.Add(scene.keys[i], scene.worlds[i]);
+			}
+			batcher.Build();
+			benchmark::DoNotOptimize(batcher.GetInstances().data());
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+		state.counters["draw_calls"] = static_cast<double>(batcher.GetGroups().size());
+	}
+
+	void BM_StableSortPacking(benchmark::State &state)
+	{
+		Scene scene = MakeScene(static_cast<uint32_t>(state.range(0)));
+		std::vector<std::pair<uint32_t, uint32_t>> order(kObjectCount);
+		std::vector<math::Matrix4x4> instances(kObjectCount);
+		for (auto _ : state) {
+			for (uint32_t i = 0; i < kObjectCount; ++i) {
+				order[i] = { scene.keys[i], i };
+			}
+			std::stable_sort(order.begin(), order.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+			for (size_t i = 0; i < kObjectCount; ++i) {
+				instances[i] = scene.worlds[order[i].second];
+			}
+			benchmark::DoNotOptimize(instances.data());
+		}
+		state.SetItemsProcessed(state.iterations() * kObjectCount);
+	}
+}
+
+BENCHMARK(BM_InstanceBatcher)->ArgName("models")->Arg(1)->Arg(8)->Arg(64)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_StableSortPacking)->ArgName("models")->Arg(1)->Arg(8)->Arg(64)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
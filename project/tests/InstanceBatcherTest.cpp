@@ -0,0 +1,168 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "InstanceBatcher.h"
+
+// キーごとのまとめ方（キーの小さい順・グループ内は追加順）を、安定ソートの結果と比べる
+namespace {
+
+	// 要素の番号をm[3][0]に入れた行列（詰め直した後にどの要素かわかるように）
+	math::Matrix4x4 MakeTagged(uint32_t item)
+	{
+		math::Matrix4x4 matrix {};
+		matrix.m[0][0] = 1.0f;
+		matrix.m[1][1] = 1.0f;
+		matrix.m[2][2] = 1.0f;
+		matrix.m[3][3] = 1.0f;
+		matrix.m[3][0] = static_cast<float>(item);
+		return matrix;
+	}
+
+	uint32_t GetTag(const math::Matrix4x4 &matrix)
+	{
+		return static_cast<uint32_t>(matrix.m[3][0]);
+	}
+
+	// 期待する結果と比べる
+	void ExpectMatchesStableSort(const InstanceBatcher &batcher, const std::vector<uint32_t> &keys)
+	{
+		std::vector<uint32_t> order(keys.size());
+		std::iota(order.begin(), order.end(), 0u);
+		std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+		const std::vector<math::Matrix4x4> &instances = batcher.GetInstances();
+		ASSERT_EQ(instances.size(), keys.size());
+		for (size_t i = 0; i < order.size(); ++i) {
+			ASSERT_EQ(GetTag(instances[i]), order[i]) << "instance " << i;
+		}
+
+		// グループはキーの小さい順で、隙間なく並ぶ
+		uint32_t expectedFirst = 0;
+		uint32_t previousKey = 0;
+		for (size_t g = 0; g < batcher.GetGroups().size(); ++g) {
+			const InstanceBatcher::Group &group = batcher.GetGroups()[g];
+			if (g > 0) {
+				EXPECT_GT(group.key, previousKey);
+			}
+			previousKey = group.key;
+			EXPECT_EQ(group.firstInstance, expectedFirst);
+			EXPECT_GT(group.instanceCount, 0u);
+			for (uint32_t i = 0; i < group.instanceCount; ++i) {
+				EXPECT_EQ(keys[GetTag(instances[group.firstInstance + i])], group.key);
+			}
+			// firstItemはそのキーで最初に追加された要素
+			EXPECT_EQ(keys[group.firstItem], group.key);
+			EXPECT_EQ(std::find(keys.begin(), keys.end(), group.key) - keys.begin(), static_cast<ptrdiff_t>(group.firstItem));
+			expectedFirst += group.instanceCount;
+		}
+		EXPECT_EQ(expectedFirst, keys.size());
+	}
+}
+
+TEST(InstanceBatcher, EmptyBuildHasNoGroups)
+{
+	InstanceBatcher batcher;
+	batcher.Build();
+	EXPECT_TRUE(batcher.GetGroups().empty());
+	EXPECT_TRUE(batcher.GetInstances().empty());
+}
+
+TEST(InstanceBatcher, AddReturnsSequentialItems)
+{
+	InstanceBatcher batcher;
+	EXPECT_EQ(batcher.Add(3, MakeTagged(0)), 0u);
+	EXPECT_EQ(batcher.Add(1, MakeTagged(1)), 1u);
+	EXPECT_EQ(batcher.Add(3, MakeTagged(2)), 2u);
+	EXPECT_EQ(batcher.GetItemCount(), 3u);
+}
+
+TEST(InstanceBatcher, GroupsByKeyKeepingInsertionOrder)
+{
+	std::vector<uint32_t> keys = { 2, 0, 2, 1, 0, 2 };
+	InstanceBatcher batcher;
+	for (uint32_t item = 0; item < keys.size(); ++item) {
+		batcher.Add(keys[item], MakeTagged(item));
+	}
+	batcher.Build();
+
+	ASSERT_EQ(batcher.GetGroups().size(), 3u);
+	const auto &groups = batcher.GetGroups();
+	EXPECT_EQ(groups[0].key, 0u);
+	EXPECT_EQ(groups[0].firstInstance, 0u);
+	EXPECT_EQ(groups[0].instanceCount, 2u);
+	EXPECT_EQ(groups[0].firstItem, 1u);
+	EXPECT_EQ(groups[1].key, 1u);
+	EXPECT_EQ(groups[1].firstInstance, 2u);
+	EXPECT_EQ(groups[1].instanceCount, 1u);
+	EXPECT_EQ(groups[2].key, 2u);
+	EXPECT_EQ(groups[2].firstInstance, 3u);
+	EXPECT_EQ(groups[2].instanceCount, 3u);
+	EXPECT_EQ(groups[2].firstItem, 0u);
+	ExpectMatchesStableSort(batcher, keys);
+}
+
+TEST(InstanceBatcher, SparseKeysOnlyMakeUsedGroups)
+{
+	std::vector<uint32_t> keys = { 1000, 5, 1000, 5, 5 };
+	InstanceBatcher batcher;
+	for (uint32_t item = 0; item < keys.size(); ++item) {
+		batcher.Add(keys[item], MakeTagged(item));
+	}
+	batcher.Build();
+	ASSERT_EQ(batcher.GetGroups().size(), 2u);
+	ExpectMatchesStableSort(batcher, keys);
+}
+
+TEST(InstanceBatcher, RandomKeysMatchStableSort)
+{
+	std::mt19937 random(1);
+	for (uint32_t models : { 1u, 8u, 64u }) {
+		std::vector<uint32_t> keys(10000);
+		for (uint32_t &key : keys) {
+			key = random() % models;
+		}
+		InstanceBatcher batcher;
+		for (uint32_t item = 0; item < keys.size(); ++item) {
+			batcher.Add(keys[item], MakeTagged(item));
+		}
+		batcher.Build();
+		EXPECT_EQ(batcher.GetGroups().size(), models);
+		ExpectMatchesStableSort(batcher, keys);
+	}
+}
+
+TEST(InstanceBatcher, ClearAllowsReuseAcrossFrames)
+{
+	InstanceBatcher batcher;
+	batcher.Add(7, MakeTagged(0));
+	batcher.Add(7, MakeTagged(1));
+	batcher.Build();
+
+	batcher.Clear();
+	EXPECT_EQ(batcher.GetItemCount(), 0u);
+	EXPECT_TRUE(batcher.GetGroups().empty());
+
+	// 前のフレームより小さいキーだけになっても、前の結果が残らない
+	std::vector<uint32_t> keys = { 1, 0, 1 };
+	for (uint32_t item = 0; item < keys.size(); ++item) {
+		batcher.Add(keys[item], MakeTagged(item));
+	}
+	batcher.Build();
+	ASSERT_EQ(batcher.GetGroups().size(), 2u);
+	ExpectMatchesStableSort(batcher, keys);
+}
+
+TEST(InstanceBatcher, BuildTwiceGivesSameResult)
+{
+	std::vector<uint32_t> keys = { 4, 2, 4, 2, 9 };
+	InstanceBatcher batcher;
+	for (uint32_t item = 0; item < keys.size(); ++item) {
+		batcher.Add(keys[item], MakeTagged(item));
+	}
+	batcher.Build();
+	batcher.Build();
+	EXPECT_EQ(batcher.GetGroups().size(), 3u);
+	ExpectMatchesStableSort(batcher, keys);
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "LegacyObjLoader.h"
+#include <fstream>
+#include <sstream>
+#include <cassert>
+
+namespace LegacyObjLoader {
+
+	std::vector<Model::VertexData> LoadObjFile(const std::string &directoryPath, const std::string &filename)
+	{
+		//----必要な変数宣言----
+		std::vector<Model::VertexData> vertices; // 構築する頂点
+		std::vector<math::Vector4> positions; // 位置
+		std::vector<math::Vector3> normals; // 法線
+		std::vector<math::Vector2> texcoords; // テクスチャ座標
+		std::string line; // ファイルから読んだ1行を格納するもの
+
+		//----ファイルを開く----
+		std::ifstream file(directoryPath + "/" + filename); // ファイルを開く
+		assert(file.is_open()); // とりあえず開けなかったら止める
+
+		//----ファイルを読み込んで、頂点を構築していく----
+		while (std::getline(file, line)) {
+			std::string identifier;
+			std::istringstream s(line);
+			s >> identifier; // 先頭の識別子を読む
+
+			// identifierに応じた処理
+			if (identifier == "v") {
+				math::Vector4 position;
+				s >> position.x >> position.y >> position.z;
+				position.x *= 1.0f;
+				position.w = 1.0f;
+				positions.push_back(position);
+			} else if (identifier == "vt") {
+				math::Vector2 texcoord;
+				s >> texcoord.x >> texcoord.y;
+				texcoord.y = 1.0f - texcoord.y;
+				texcoords.push_back(texcoord);
+			} else if (identifier == "vn") {
+				math::Vector3 normal;
+				s >> normal.x >> normal.y >> normal.z;
+				normal.x *= -1.0f;
+				normals.push_back(normal);
+			} else if (identifier == "f") {
+
+				Model::VertexData triangle[3];
+				// 面は三角形限定。その他は未対応
+				for (int32_t faceVertex = 0; faceVertex < 3; ++faceVertex) {
+					std::string vertexDefinition;
+					s >> vertexDefinition;
+					// 頂点の要素へのIndexは「位置/UV/法線」で格納されているので、分解してIndexを取得する
+					std::istringstream v(vertexDefinition);
+					uint32_t elementIndices[3];
+					for (int32_t element = 0; element < 3; ++element) {
+						std::string index;
+						std::getline(v, index, '/'); // /区切りでインデックスを読んでいく
+						elementIndices[element] = std::stoi(index);
+					}
+					// 要素へのIndexから、実際の要素の値を取得して、頂点を構築する
+					math::Vector4 position = positions[elementIndices[0] - 1];
+					math::Vector2 texcoord = texcoords[elementIndices[1] - 1];
+					math::Vector3 normal = normals[elementIndices[2] - 1];
+					triangle[faceVertex] = { position,texcoord,normal };
+				}
+				// 頂点を逆順で登録することで、回り順を逆にする
+				vertices.push_back(triangle[2]);
+				vertices.push_back(triangle[1]);
+				vertices.push_back(triangle[0]);
+			}
+		}
+
+		//----頂点を返す----
+		return vertices;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "Model.h"
+
+// 書き換える前のModel::LoadObjFile（getlineとistringstreamで1行ずつ解析する）
+// ObjLoaderの結果の照合とベンチマークの比較対象に残している
+// 面は三角形で、位置/UV/法線のインデックスがすべて書かれている必要がある
+namespace LegacyObjLoader
+{
+	/// <summary>
+	/// objファイルを読み込み、三角形の頂点を展開した配列を返す（回り順は反転済み）
+	/// </summary>
+	/// <param name="directoryPath">objファイルのあるディレクトリ</param>
+	/// <param name="filename">objファイル名</param>
+	std::vector<Model::VertexData> LoadObjFile(const std::string &directoryPath, const std::string &filename);
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "MathFunctions.h"
+
+// 行列演算: SIMD版（math::）とスカラー版（math::scalar::）の比較
+// 1024個の入力を順に処理し、1回あたりの時間とops/sを報告する
+namespace {
+
+	constexpr size_t kInputCount = 1024;
+
+	struct Inputs
+	{
+		std::vector<math::Matrix4x4> matrices;
+		std::vector<math::Vector3> scales;
+		std::vector<math::Vector3> rotates;
+		std::vector<math::Vector3> translates;
+
+		Inputs()
+		{
+			std::mt19937 random(1);
+			std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+			std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+			std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+			for (size_t i = 0; i < kInputCount; ++i) {
+				scales.push_back({ scale(random), scale(random), scale(random) });
+				rotates.push_back({ angle(random), angle(random), angle(random) });
+				translates.push_back({ position(random), position(random), position(random) });
+				matrices.push_back(math::scalar::MakeAffineMatrix(scales.back(), rotates.back(), translates.back()));
+			}
+		}
+	};
+
+	const Inputs &GetInputs()
+	{
+		static const Inputs inputs;
+		return inputs;
+	}
+
+	template <math::Matrix4x4 (*Function)(const math::Matrix4x4 &, const math::Matrix4x4 &)>
+	void BM_Multiply(benchmark::State &state)
+	{
+		const std::vector<math::Matrix4x4> &matrices = GetInputs().matrices;
+		size_t i = 0;
+		for (auto _ : state) {
+			math::Matrix4x4 result = Function(matrices[i], matrices[(i + 1) % kInputCount]);
+			benchmark::DoNotOptimize(result);
+			i = (i + 1) % kInputCount;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	template <math::Matrix4x4 (*Function)(const math::Matrix4x4 &)>
+	void BM_Inverse(benchmark::State &state)
+	{
+		const std::vector<math::Matrix4x4> &matrices = GetInputs().matrices;
+		size_t i = 0;
+		for (auto _ : state) {
+			math::Matrix4x4 result = Function(matrices[i]);
+			benchmark::DoNotOptimize(result);
+			i = (i + 1) % kInputCount;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	template <math::Matrix4x4 (*Function)(const math::Vector3 &, const math::Vector3 &, const math::Vector3 &)>
+	void BM_MakeAffineMatrix(benchmark::State &state)
+	{
+		const Inputs &inputs = GetInputs();
+		size_t i = 0;
+		for (auto _ : state) {
+			math::Matrix4x4 result = Function(inputs.scales[i], inputs.rotates[i], inputs.translates[i]);
+			benchmark::DoNotOptimize(result);
+			i = (i + 1) % kInputCount;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	template <math::Vector3 (*Function)(const math::Vector3 &, const math::Matrix4x4 &)>
+	void BM_ApplyTransform(benchmark::State &state)
+	{
+		const Inputs &inputs = GetInputs();
+		size_t i = 0;
+		for (auto _ : state) {
+			math::Vector3 result = Function(inputs.translates[i], inputs.matrices[i]);
+			benchmark::DoNotOptimize(result);
+			i = (i + 1) % kInputCount;
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+}
+
+BENCHMARK(BM_Multiply<math::Multiply>)->Name("BM_Multiply/simd");
+BENCHMARK(BM_Multiply<math::scalar::Multiply>)->Name("BM_Multiply/scalar");
+BENCHMARK(BM_Inverse<math::Inverse>)->Name("BM_Inverse/simd");
+BENCHMARK(BM_Inverse<math::scalar::Inverse>)->Name("BM_Inverse/scalar");
+BENCHMARK(BM_MakeAffineMatrix<math::MakeAffineMatrix>)->Name("BM_MakeAffineMatrix/direct");
+BENCHMARK(BM_MakeAffineMatrix<math::scalar::MakeAffineMatrix>)->Name("BM_MakeAffineMatrix/scalar");
+BENCHMARK(BM_ApplyTransform<math::ApplyTransform>)->Name("BM_ApplyTransform/simd");
+BENCHMARK(BM_ApplyTransform<math::scalar::ApplyTransform>)->Name("BM_ApplyTransform/scalar");
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <cmath>
+#include <random>
+#include "MathFunctions.h"
+
+// SIMD版の行列演算を、スカラー版（math::scalar）を正解として比べる
+// 許容誤差はMathFunctions.hに書いたもの（Multiply・ApplyTransformは一致、Inverseは相対1e-5、MakeAffineMatrixは相対1e-6）
+namespace {
+
+	// 変換に使われる範囲の拡大縮小・回転・平行移動
+	struct Transform
+	{
+		math::Vector3 scale;
+		math::Vector3 rotate;
+		math::Vector3 translate;
+	};
+
+	std::vector<Transform> RandomTransforms(size_t count, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+		std::uniform_real_distribution<float> angle(-6.3f, 6.3f);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+		std::vector<Transform> transforms(count);
+		for (Transform &transform : transforms) {
+			transform.scale = { scale(random), scale(random), scale(random) };
+			transform.rotate = { angle(random), angle(random), angle(random) };
+			transform.translate = { position(random), position(random), position(random) };
+		}
+		return transforms;
+	}
+
+	math::Matrix4x4 RandomMatrix(std::mt19937 &random)
+	{
+		std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+		math::Matrix4x4 matrix;
+		for (auto &row : matrix.m) {
+			for (float &value : row) {
+				value = distribution(random);
+			}
+		}
+		return matrix;
+	}
+
+	float MaxAbs(const math::Matrix4x4 &matrix)
+	{
+		float result = 0.0f;
+		for (const auto &row : matrix.m) {
+			for (float value : row) {
+				result = (std::max)(result, std::abs(value));
+			}
+		}
+		return result;
+	}
+
+	// 各要素の差が、行列の最大要素に対する相対誤差以内か
+	void ExpectNearRelative(const math::Matrix4x4 &actual, const math::Matrix4x4 &expected, float relativeTolerance)
+	{
+		float tolerance = relativeTolerance * (std::max)(MaxAbs(expected), 1.0f);
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				ASSERT_NEAR(actual.m[row][col], expected.m[row][col], tolerance) << "m[" << row << "][" << col << "]";
+			}
+		}
+	}
+
+	// 倍精度の掃き出し法で求めた逆行列との差（最大要素に対する相対誤差）
+	double RelativeErrorFromDouble(const math::Matrix4x4 &matrix, const math::Matrix4x4 &inverse)
+	{
+		double a[4][8] = {};
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				a[row][col] = matrix.m[row][col];
+			}
+			a[row][4 + row] = 1.0;
+		}
+		for (int col = 0; col < 4; ++col) {
+			int pivot = col;
+			for (int row = col + 1; row < 4; ++row) {
+				if (std::abs(a[row][col]) > std::abs(a[pivot][col])) {
+					pivot = row;
+				}
+			}
+			std::swap(a[col], a[pivot]);
+			double scale = 1.0 / a[col][col];
+			for (double &value : a[col]) {
+				value *= scale;
+			}
+			for (int row = 0; row < 4; ++row) {
+				if (row != col) {
+					double factor = a[row][col];
+					for (int k = 0; k < 8; ++k) {
+						a[row][k] -= factor * a[col][k];
+					}
+				}
+			}
+		}
+		double maxError = 0.0;
+		double maxValue = 0.0;
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				maxError = (std::max)(maxError, std::abs(inverse.m[row][col] - a[row][4 + col]));
+				maxValue = (std::max)(maxValue, std::abs(a[row][4 + col]));
+			}
+		}
+		return maxError / maxValue;
+	}
+}
+
+// どちらの実装でテストしているか（SIMDを無効にしたビルドではスカラー版どうしの比較になる）
+TEST(MathFunctions, ReportsSimdPath)
+{
+	RecordProperty("MATH_USE_SSE", MATH_USE_SSE);
+	SUCCEED();
+}
+
+// 行列の積はスカラー版と同じ順で足すので一致する
+TEST(MathFunctions, MultiplyMatchesScalar)
+{
+	std::mt19937 random(1);
+	for (int i = 0; i < 10000; ++i) {
+		math::Matrix4x4 a = RandomMatrix(random);
+		math::Matrix4x4 b = RandomMatrix(random);
+		math::Matrix4x4 actual = math::Multiply(a, b);
+		math::Matrix4x4 expected = math::scalar::Multiply(a, b);
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				ASSERT_EQ(actual.m[row][col], expected.m[row][col]) << "case " << i << " m[" << row << "][" << col << "]";
+			}
+		}
+	}
+}
+
+// 直接組み立てたアフィン行列は、行列を掛け合わせたものと相対1e-6以内
+TEST(MathFunctions, MakeAffineMatrixMatchesScalar)
+{
+	for (const Transform &transform : RandomTransforms(10000, 2)) {
+		math::Matrix4x4 actual = math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		math::Matrix4x4 expected = math::scalar::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		ExpectNearRelative(actual, expected, 1.0e-6f);
+		// 平行移動の行はどちらも値をそのまま置く
+		EXPECT_EQ(actual.m[3][0], transform.translate.x);
+		EXPECT_EQ(actual.m[3][1], transform.translate.y);
+		EXPECT_EQ(actual.m[3][2], transform.translate.z);
+		EXPECT_EQ(actual.m[3][3], 1.0f);
+	}
+}
+
+// 逆行列はスカラー版と相対1e-5以内で、元の行列との積は単位行列になる
+TEST(MathFunctions, InverseMatchesScalar)
+{
+	for (const Transform &transform : RandomTransforms(10000, 3)) {
+		math::Matrix4x4 matrix = math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		math::Matrix4x4 actual = math::Inverse(matrix);
+		math::Matrix4x4 expected = math::scalar::Inverse(matrix);
+		ExpectNearRelative(actual, expected, 1.0e-5f);
+	}
+}
+
+// 透視投影とビュー行列の積のような条件数の大きい行列では、どちらも誤差が大きくなる
+// 倍精度で求めた逆行列に対して、SIMD版の誤差がスカラー版と同程度であることを確かめる
+TEST(MathFunctions, InverseOfViewProjectionIsAsAccurateAsScalar)
+{
+	double worstSimd = 0.0;
+	double worstScalar = 0.0;
+	for (const Transform &transform : RandomTransforms(1000, 4)) {
+		math::Matrix4x4 camera = math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, transform.rotate, transform.translate);
+		math::Matrix4x4 viewProjection = math::Multiply(math::Inverse(camera), math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 100.0f));
+		worstSimd = (std::max)(worstSimd, RelativeErrorFromDouble(viewProjection, math::Inverse(viewProjection)));
+		worstScalar = (std::max)(worstScalar, RelativeErrorFromDouble(viewProjection, math::scalar::Inverse(viewProjection)));
+	}
+	RecordProperty("worst_simd", std::to_string(worstSimd));
+	RecordProperty("worst_scalar", std::to_string(worstScalar));
+	EXPECT_LE(worstSimd, worstScalar * 4.0 + 1.0e-6);
+}
+
+// 座標変換はスカラー版と同じ順で計算するので一致する
+TEST(MathFunctions, ApplyTransformMatchesScalar)
+{
+	std::mt19937 random(5);
+	std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+	for (const Transform &transform : RandomTransforms(10000, 6)) {
+		math::Matrix4x4 matrix = math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+		math::Vector3 point = { position(random), position(random), position(random) };
+		math::Vector3 actual = math::ApplyTransform(point, matrix);
+		math::Vector3 expected = math::scalar::ApplyTransform(point, matrix);
+		ASSERT_EQ(actual.x, expected.x);
+		ASSERT_EQ(actual.y, expected.y);
+		ASSERT_EQ(actual.z, expected.z);
+	}
+}
\ No newline at end of file
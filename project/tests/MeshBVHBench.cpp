@@ -0,0 +1,170 @@
+#include <benchmark/benchmark.h>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "MeshBVH.h"
+#include "BoundingVolume.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+// 三角形BVHのレイの判定（最も近い当たり・AnyHit）と、全三角形を調べる場合の rays/s
+// 同梱のモデルと、大きなメッシュの代わりの格子の地形で計測する
+namespace {
+
+	struct BenchMesh
+	{
+		std::string name;
+		std::vector<math::Vector3> positions;
+		std::vector<uint32_t> indices;
+		MeshBVH bvh;
+		std::vector<math::Ray> rays;
+		TestSupport::ModelFile file;
+		uint32_t gridSize = 0;
+	};
+
+	void Prepare(BenchMesh &mesh, const Model::ModelData &modelData)
+	{
+		mesh.indices = modelData.indices;
+		for (const Model::VertexData &vertex : modelData.vertices) {
+			mesh.positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+		}
+		mesh.bvh.Build(mesh.positions, mesh.indices);
+
+		// 外接球の上からメッシュの箱の中の点へ向かうレイ
+		math::AABB bounds = math::MakeEmptyAABB();
+		for (const math::Vector3 &position : mesh.positions) {
+			math::Expand(bounds, position);
+		}
+		math::Vector3 center = math::GetCenter(bounds);
+		math::Vector3 extent = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+		float radius = std::sqrt(extent.x * extent.x + extent.y * extent.y + extent.z * extent.z) + 1.0f;
+		std::mt19937 random(1);
+		std::normal_distribution<float> normal;
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		mesh.rays.resize(1024);
+		for (math::Ray &ray : mesh.rays) {
+			math::Vector3 direction = math::Normalize({ normal(random), normal(random), normal(random) });
+			ray.origin = { center.x + direction.x * radius, center.y + direction.y * radius, center.z + direction.z * radius };
+			math::Vector3 target = { bounds.min.x + extent.x * unit(random), bounds.min.y + extent.y * unit(random), bounds.min.z + extent.z * unit(random) };
+			ray.direction = math::Normalize({ target.x - ray.origin.x, target.y - ray.origin.y, target.z - ray.origin.z });
+		}
+	}
+
+	// 読み込みと構築は重いので、フィルタで選ばれたベンチマークが初めて使うときに行う
+	const BenchMesh *Ensure(BenchMesh *mesh)
+	{
+		if (mesh->positions.empty()) {
+			if (mesh->gridSize != 0) {
+				std::string text = TestSupport::MakeGridObj(mesh->gridSize, mesh->gridSize);
+				Prepare(*mesh, ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 1));
+			} else {
+				Prepare(*mesh, ObjLoader::Load(mesh->file.directoryPath, mesh->file.filename, 1));
+			}
+		}
+		return mesh;
+	}
+
+	void BM_MeshBVHBuild(benchmark::State &state, BenchMesh *source)
+	{
+		const BenchMesh *mesh = Ensure(source);
+		MeshBVH bvh;
+		for (auto _ : state) {
+			bvh.Build(mesh->positions, mesh->indices);
+		}
+		state.counters["triangles"] = static_cast<double>(mesh->indices.size() / 3);
+		state.counters["memory_KiB"] = static_cast<double>(bvh.GetMemorySize()) / 1024.0;
+	}
+
+	void BM_MeshBVHRayCast(benchmark::State &state, BenchMesh *source)
+	{
+		const BenchMesh *mesh = Ensure(source);
+		size_t rayIndex = 0;
+		size_t hits = 0;
+		for (auto _ : state) {
+			MeshBVH::Hit hit;
+			hits += mesh->bvh.RayCast(mesh->rays[rayIndex], FLT_MAX, hit);
+			rayIndex = (rayIndex + 1) % mesh->rays.size();
+		}
+		state.counters["rays_per_s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+		state.counters["hit_rate"] = static_cast<double>(hits) / static_cast<double>(state.iterations());
+	}
+
+	void BM_MeshBVHAnyHit(benchmark::State &state, BenchMesh *source)
+	{
+		const BenchMesh *mesh = Ensure(source);
+		size_t rayIndex = 0;
+		for (auto _ : state) {
+			benchmark::DoNotOptimize(mesh->bvh.AnyHit(mesh->rays[rayIndex], FLT_MAX));
+			rayIndex = (rayIndex + 1) % mesh->rays.size();
+		}
+		state.counters["rays_per_s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+	}
+
+	// 比較: 全三角形をMöller–Trumboreで調べる
+	void BM_BruteForceRayCast(benchmark::State &state, BenchMesh *source)
+	{
+		const BenchMesh *mesh = Ensure(source);
+		size_t rayIndex = 0;
+		for (auto _ : state) {
+			const math::Ray &ray = mesh->rays[rayIndex];
+			float closest = FLT_MAX;
+			for (size_t i = 0; i + 2 < mesh->indices.size(); i += 3) {
+				const math::Vector3 &p0 = mesh->positions[mesh->indices[i]];
+				const math::Vector3 &p1 = mesh->positions[mesh->indices[i + 1]];
+				const math::Vector3 &p2 = mesh->positions[mesh->indices[i + 2]];
+				math::Vector3 edge1 = { p1.x - p0.x, p1.y - p0.y, p1.z - p0.z };
+				math::Vector3 edge2 = { p2.x - p0.x, p2.y - p0.y, p2.z - p0.z };
+				math::Vector3 p = { ray.direction.y * edge2.z - ray.direction.z * edge2.y, ray.direction.z * edge2.x - ray.direction.x * edge2.z, ray.direction.x * edge2.y - ray.direction.y * edge2.x };
+				float det = edge1.x * p.x + edge1.y * p.y + edge1.z * p.z;
+				if (std::fabs(det) <= 1e-12f) {
+					continue;
+				}
+				float inverseDet = 1.0f / det;
+				math::Vector3 t = { ray.origin.x - p0.x, ray.origin.y - p0.y, ray.origin.z - p0.z };
+				float u = (t.x * p.x + t.y * p.y + t.z * p.z) * inverseDet;
+				if (u < 0.0f || u > 1.0f) {
+					continue;
+				}
+				math::Vector3 q = { t.y * edge1.z - t.z * edge1.y, t.z * edge1.x - t.x * edge1.z, t.x * edge1.y - t.y * edge1.x };
+				float v = (ray.direction.x * q.x + ray.direction.y * q.y + ray.direction.z * q.z) * inverseDet;
+				if (v < 0.0f || u + v > 1.0f) {
+					continue;
+				}
+				float distance = (edge2.x * q.x + edge2.y * q.y + edge2.z * q.z) * inverseDet;
+				if (distance >= 0.0f && distance < closest) {
+					closest = distance;
+				}
+			}
+			benchmark::DoNotOptimize(closest);
+			rayIndex = (rayIndex + 1) % mesh->rays.size();
+		}
+		state.counters["rays_per_s"] = benchmark::Counter(static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+	}
+
+	const bool kRegistered = [] {
+		static std::vector<BenchMesh> meshes;
+		std::vector<TestSupport::ModelFile> files = TestSupport::FindBundledModels();
+		// 同梱のモデルは小さいので、大きなメッシュとして格子の地形（8万・200万三角形）も使う
+		meshes.reserve(files.size() + 2);
+		for (const TestSupport::ModelFile &file : files) {
+			BenchMesh &mesh = meshes.emplace_back();
+			mesh.name = file.filename;
+			mesh.file = file;
+		}
+		for (uint32_t size : { 200u, 1000u }) {
+			BenchMesh &mesh = meshes.emplace_back();
+			mesh.name = "grid" + std::to_string(size);
+			mesh.gridSize = size;
+		}
+
+		for (BenchMesh &mesh : meshes) {
+			benchmark::RegisterBenchmark(("BM_MeshBVHBuild/" + mesh.name).c_str(), BM_MeshBVHBuild, &mesh)->Unit(benchmark::kMillisecond);
+			benchmark::RegisterBenchmark(("BM_MeshBVHRayCast/" + mesh.name).c_str(), BM_MeshBVHRayCast, &mesh);
+			benchmark::RegisterBenchmark(("BM_MeshBVHAnyHit/" + mesh.name).c_str(), BM_MeshBVHAnyHit, &mesh);
+			benchmark::RegisterBenchmark(("BM_BruteForceRayCast/" + mesh.name).c_str(), BM_BruteForceRayCast, &mesh)->Unit(benchmark::kMicrosecond);
+		}
+		return true;
+		}();
+}
\ No newline at end of file
@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "MeshBVH.h"
+#include "BoundingVolume.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+// 三角形BVHのレイの判定を、全三角形を調べた結果と比べる
+// 総当たりはMeshBVHのスカラー版と同じ順で計算するので、距離は一致する
+namespace {
+
+	struct Mesh
+	{
+		std::string name;
+		std::vector<math::Vector3> positions;
+		std::vector<uint32_t> indices;
+	};
+
+	Mesh ToMesh(const std::string &name, const Model::ModelData &modelData)
+	{
+		Mesh mesh { name, {}, modelData.indices };
+		for (const Model::VertexData &vertex : modelData.vertices) {
+			mesh.positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+		}
+		return mesh;
+	}
+
+	// 同梱のモデル、格子の地形、ばらばらの三角形
+	std::vector<Mesh> MakeMeshes()
+	{
+		std::vector<Mesh> meshes;
+		for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+			meshes.push_back(ToMesh(file.filename, ObjLoader::Load(file.directoryPath, file.filename, 1)));
+		}
+		std::string grid = TestSupport::MakeGridObj(64, 64);
+		meshes.push_back(ToMesh("grid64", ObjLoader::Parse(grid.data(), grid.data() + grid.size(), ".", 1)));
+
+		Mesh soup { "soup", {}, {} };
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+		std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+		for (uint32_t i = 0; i < 3000; ++i) {
+			math::Vector3 center = { position(random), position(random), position(random) };
+			for (int corner = 0; corner < 3; ++corner) {
+				soup.positions.push_back({ center.x + offset(random), center.y + offset(random), center.z + offset(random) });
+				soup.indices.push_back(i * 3 + corner);
+			}
+		}
+		meshes.push_back(soup);
+		return meshes;
+	}
+
+	// 全三角形を調べる（MeshBVHのスカラー版と同じ式・同じ順）
+	bool BruteForceRayCast(const Mesh &mesh, const math::Ray &ray, float maxDistance, MeshBVH::Hit &hit)
+	{
+		const math::Vector3 &origin = ray.origin;
+		const math::Vector3 &direction = ray.direction;
+		float closest = maxDistance;
+		bool found = false;
+		for (uint32_t triangle = 0; triangle < mesh.indices.size() / 3; ++triangle) {
+			const math::Vector3 &p0 = mesh.positions[mesh.indices[triangle * 3]];
+			const math::Vector3 &p1 = mesh.positions[mesh.indices[triangle * 3 + 1]];
+			const math::Vector3 &p2 = mesh.positions[mesh.indices[triangle * 3 + 2]];
+			float edge1X = p1.x - p0.x, edge1Y = p1.y - p0.y, edge1Z = p1.z - p0.z;
+			float edge2X = p2.x - p0.x, edge2Y = p2.y - p0.y, edge2Z = p2.z - p0.z;
+			float pX = direction.y * edge2Z - direction.z * edge2Y;
+			float pY = direction.z * edge2X - direction.x * edge2Z;
+			float pZ = direction.x * edge2Y - direction.y * edge2X;
+			float det = edge1X * pX + edge1Y * pY + edge1Z * pZ;
+			float inverseDet = 1.0f / det;
+			float tX = origin.x - p0.x;
+			float tY = origin.y - p0.y;
+			float tZ = origin.z - p0.z;
+			float u = (tX * pX + tY * pY + tZ * pZ) * inverseDet;
+			float qX = tY * edge1Z - tZ * edge1Y;
+			float qY = tZ * edge1X - tX * edge1Z;
+			float qZ = tX * edge1Y - tY * edge1X;
+			float v = (direction.x * qX + direction.y * qY + direction.z * qZ) * inverseDet;
+			float distance = (edge2X * qX + edge2Y * qY + edge2Z * qZ) * inverseDet;
+			if (std::fabs(det) > 1e-12f && u >= 0.0f && v >= 0.0f && u + v <= 1.0f && distance >= 0.0f && distance <= closest) {
+				closest = distance;
+				hit = { distance, triangle, u, v };
+				found = true;
+			}
+		}
+		return found;
+	}
+
+	math::AABB ComputeBounds(const Mesh &mesh)
+	{
+		math::AABB bounds = math::MakeEmptyAABB();
+		for (const math::Vector3 &position : mesh.positions) {
+			math::Expand(bounds, position);
+		}
+		return bounds;
+	}
+
+	// メッシュの外側から中の点へ向かうレイ（方向は正規化しない）と、でたらめな向きのレイ
+	std::vector<math::Ray> MakeRays(const Mesh &mesh, size_t count, uint32_t seed)
+	{
+		math::AABB bounds = ComputeBounds(mesh);
+		math::Vector3 center = math::GetCenter(bounds);
+		math::Vector3 extent = { bounds.max.x - bounds.min.x, bounds.max.y - bounds.min.y, bounds.max.z - bounds.min.z };
+		float radius = std::sqrt(extent.x * extent.x + extent.y * extent.y + extent.z * extent.z) + 1.0f;
+
+		std::mt19937 random(seed);
+		std::normal_distribution<float> normal;
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::vector<math::Ray> rays;
+		for (size_t i = 0; i < count; ++i) {
+			math::Vector3 direction = math::Normalize({ normal(random), normal(random), normal(random) });
+			math::Vector3 origin = { center.x + direction.x * radius, center.y + direction.y * radius, center.z + direction.z * radius };
+			if (i % 4 == 3) {
+				rays.push_back({ origin, { normal(random), normal(random), normal(random) } });
+				continue;
+			}
+			math::Vector3 target = {
+				bounds.min.x + extent.x * unit(random),
+				bounds.min.y + extent.y * unit(random),
+				bounds.min.z + extent.z * unit(random),
+			};
+			float scale = 0.5f + unit(random) * 2.0f;
+			rays.push_back({ origin, { (target.x - origin.x) * scale, (target.y - origin.y) * scale, (target.z - origin.z) * scale } });
+		}
+		return rays;
+	}
+
+	void ExpectMatchesBruteForce(const Mesh &mesh, const MeshBVH &bvh, const std::vector<math::Ray> &rays, float maxDistance)
+	{
+		size_t hits = 0;
+		for (size_t i = 0; i < rays.size(); ++i) {
+			const math::Ray &ray = rays[i];
+			MeshBVH::Hit expected;
+			bool expectedHit = BruteForceRayCast(mesh, ray, maxDistance, expected);
+			MeshBVH::Hit actual;
+			ASSERT_EQ(bvh.RayCast(ray, maxDistance, actual), expectedHit) << mesh.name << " ray " << i;
+			ASSERT_EQ(bvh.AnyHit(ray, maxDistance), expectedHit) << mesh.name << " ray " << i;
+			if (!expectedHit) {
+				continue;
+			}
+			++hits;
+			ASSERT_FLOAT_EQ(actual.distance, expected.distance) << mesh.name << " ray " << i;
+
+			// 重心座標で求めた点が、レイの上の当たった位置になる
+			ASSERT_LT(actual.triangle, mesh.indices.size() / 3);
+			const math::Vector3 &p0 = mesh.positions[mesh.indices[actual.triangle * 3]];
+			const math::Vector3 &p1 = mesh.positions[mesh.indices[actual.triangle * 3 + 1]];
+			const math::Vector3 &p2 = mesh.positions[mesh.indices[actual.triangle * 3 + 2]];
+			float w = 1.0f - actual.u - actual.v;
+			math::Vector3 onTriangle = {
+				p0.x * w + p1.x * actual.u + p2.x * actual.v,
+				p0.y * w + p1.y * actual.u + p2.y * actual.v,
+				p0.z * w + p1.z * actual.u + p2.z * actual.v,
+			};
+			math::Vector3 onRay = {
+				ray.origin.x + ray.direction.x * actual.distance,
+				ray.origin.y + ray.direction.y * actual.distance,
+				ray.origin.z + ray.direction.z * actual.distance,
+			};
+			float tolerance = 1e-3f * (1.0f + std::abs(onRay.x) + std::abs(onRay.y) + std::abs(onRay.z));
+			EXPECT_NEAR(onTriangle.x, onRay.x, tolerance);
+			EXPECT_NEAR(onTriangle.y, onRay.y, tolerance);
+			EXPECT_NEAR(onTriangle.z, onRay.z, tolerance);
+		}
+		// 当たるレイと外れるレイの両方を試している
+		EXPECT_GT(hits, 0u) << mesh.name;
+		EXPECT_LT(hits, rays.size()) << mesh.name;
+	}
+}
+
+TEST(MeshBVH, EmptyMeshNeverHits)
+{
+	MeshBVH bvh;
+	bvh.Build({}, {});
+	EXPECT_TRUE(bvh.IsEmpty());
+	MeshBVH::Hit hit;
+	EXPECT_FALSE(bvh.RayCast({ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX, hit));
+	EXPECT_FALSE(bvh.AnyHit({ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX));
+}
+
+TEST(MeshBVH, SingleTriangle)
+{
+	MeshBVH bvh;
+	bvh.Build({ { -1.0f, -1.0f, 5.0f }, { 1.0f, -1.0f, 5.0f }, { -1.0f, 1.0f, 5.0f } }, { 0, 1, 2 });
+	EXPECT_EQ(bvh.GetTriangleCount(), 1u);
+	EXPECT_EQ(bvh.GetNodeCount(), 1u);
+
+	MeshBVH::Hit hit;
+	ASSERT_TRUE(bvh.RayCast({ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX, hit));
+	EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+	EXPECT_EQ(hit.triangle, 0u);
+	EXPECT_FLOAT_EQ(hit.u, 0.25f);
+	EXPECT_FLOAT_EQ(hit.v, 0.25f);
+
+	// 裏側からも当たる
+	ASSERT_TRUE(bvh.RayCast({ { -0.5f, -0.5f, 10.0f }, { 0.0f, 0.0f, -2.0f } }, FLT_MAX, hit));
+	EXPECT_FLOAT_EQ(hit.distance, 2.5f);
+
+	// 斜辺の外・届かない長さ・平行なレイ
+	EXPECT_FALSE(bvh.RayCast({ { 0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX, hit));
+	EXPECT_FALSE(bvh.RayCast({ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, 4.9f, hit));
+	EXPECT_FALSE(bvh.RayCast({ { -2.0f, -0.5f, 5.0f }, { 1.0f, 0.0f, 0.0f } }, FLT_MAX, hit));
+}
+
+TEST(MeshBVH, ClosestOfStackedTrianglesWins)
+{
+	// 同じ形の三角形を奥から手前へ重ねる（葉のブロックの中と、別の葉の両方で比べる）
+	std::vector<math::Vector3> positions;
+	std::vector<uint32_t> indices;
+	for (uint32_t i = 0; i < 37; ++i) {
+		float z = 100.0f - static_cast<float>(i);
+		positions.push_back({ -1.0f, -1.0f, z });
+		positions.push_back({ 1.0f, -1.0f, z });
+		positions.push_back({ -1.0f, 1.0f, z });
+		indices.insert(indices.end(), { i * 3, i * 3 + 1, i * 3 + 2 });
+	}
+	MeshBVH bvh;
+	bvh.Build(positions, indices);
+
+	MeshBVH::Hit hit;
+	ASSERT_TRUE(bvh.RayCast({ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX, hit));
+	EXPECT_EQ(hit.triangle, 36u);
+	EXPECT_FLOAT_EQ(hit.distance, 64.0f);
+}
+
+TEST(MeshBVH, IdenticalTrianglesStillBuild)
+{
+	// 中心がすべて同じ位置（SAHで分けられない）でも、中央で分けて作れる
+	Mesh mesh { "identical", { { -1.0f, -1.0f, 5.0f }, { 1.0f, -1.0f, 5.0f }, { -1.0f, 1.0f, 5.0f } }, {} };
+	for (uint32_t i = 0; i < 500; ++i) {
+		mesh.indices.insert(mesh.indices.end(), { 0, 1, 2 });
+	}
+	MeshBVH bvh;
+	bvh.Build(mesh.positions, mesh.indices);
+	EXPECT_EQ(bvh.GetTriangleCount(), 500u);
+
+	MeshBVH::Hit hit;
+	ASSERT_TRUE(bvh.RayCast({ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX, hit));
+	EXPECT_FLOAT_EQ(hit.distance, 5.0f);
+	EXPECT_TRUE(bvh.AnyHit({ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX));
+	EXPECT_FALSE(bvh.AnyHit({ { 0.5f, 0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX));
+}
+
+TEST(MeshBVH, RayCastMatchesBruteForce)
+{
+	for (const Mesh &mesh : MakeMeshes()) {
+		SCOPED_TRACE(mesh.name);
+		MeshBVH bvh;
+		bvh.Build(mesh.positions, mesh.indices);
+		EXPECT_EQ(bvh.GetTriangleCount(), mesh.indices.size() / 3);
+		ExpectMatchesBruteForce(mesh, bvh, MakeRays(mesh, 1000, 1), FLT_MAX);
+	}
+}
+
+TEST(MeshBVH, MaxDistanceLimitsHits)
+{
+	for (const Mesh &mesh : MakeMeshes()) {
+		SCOPED_TRACE(mesh.name);
+		MeshBVH bvh;
+		bvh.Build(mesh.positions, mesh.indices);
+		// レイの始点はメッシュの外接球の外なので、方向の長さ1つ分では届かないものが多い
+		ExpectMatchesBruteForce(mesh, bvh, MakeRays(mesh, 500, 2), 1.2f);
+	}
+}
+
+TEST(MeshBVH, RebuildReplacesPreviousMesh)
+{
+	MeshBVH bvh;
+	bvh.Build({ { -1.0f, -1.0f, 5.0f }, { 1.0f, -1.0f, 5.0f }, { -1.0f, 1.0f, 5.0f } }, { 0, 1, 2 });
+	bvh.Build({ { -1.0f, -1.0f, 9.0f }, { 1.0f, -1.0f, 9.0f }, { -1.0f, 1.0f, 9.0f } }, { 0, 1, 2 });
+	MeshBVH::Hit hit;
+	ASSERT_TRUE(bvh.RayCast({ { -0.5f, -0.5f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, FLT_MAX, hit));
+	EXPECT_FLOAT_EQ(hit.distance, 9.0f);
+
+	bvh.Clear();
+	EXPECT_TRUE(bvh.IsEmpty());
+	EXPECT_EQ(bvh.GetTriangleCount(), 0u);
+}
\ No newline at end of file
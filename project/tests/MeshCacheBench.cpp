@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+// メッシュキャッシュ: objを解析する場合（キャッシュが無い初回起動）と、キャッシュをメモリマップで読む場合（2回目以降）の比較
+// resources/にキャッシュを作らないよう、一時ディレクトリに複製したファイルを使う
+namespace {
+
+	struct BenchFile
+	{
+		std::string name;
+		std::string directoryPath;
+		std::string filename;
+	};
+
+	// 格子の大きさ（ObjLoaderBenchと同じ約200万三角形）
+	constexpr uint32_t kGridSize = 1024;
+
+	// objと、それを解析して書き出したキャッシュを一時ディレクトリに用意する
+	BenchFile PrepareModel(const TestSupport::ModelFile &model)
+	{
+		std::string modelName = std::filesystem::path(model.directoryPath).filename().string();
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / ("MeshCacheBench_" + modelName);
+		std::filesystem::remove_all(directory);
+		std::filesystem::copy(model.directoryPath, directory, std::filesystem::copy_options::recursive);
+		BenchFile file { model.filename, directory.string(), model.filename };
+		MeshCache::Save(file.directoryPath + "/" + file.filename, ObjLoader::Load(file.directoryPath, file.filename, 1));
+		return file;
+	}
+
+	const BenchFile &GetGridFile()
+	{
+		static const BenchFile file = [] {
+			std::string path = TestSupport::WriteTemporaryFile("MeshCacheBench_grid.obj", TestSupport::MakeGridObj(kGridSize, kGridSize));
+			std::filesystem::path fullPath(path);
+			BenchFile grid { "grid" + std::to_string(kGridSize), fullPath.parent_path().string(), fullPath.filename().string() };
+			MeshCache::Save(path, ObjLoader::Load(grid.directoryPath, grid.filename, 1));
+			return grid;
+			}();
+		return file;
+	}
+
+	// キャッシュ無し: objを解析する（1スレッド）
+	void BM_ColdObjLoad(benchmark::State &state, const BenchFile *file)
+	{
+		size_t triangles = 0;
+		for (auto _ : state) {
+			Model::ModelData modelData = ObjLoader::Load(file->directoryPath, file->filename, 1);
+			triangles = modelData.indices.size() / 3;
+			benchmark::DoNotOptimize(modelData.vertices.data());
+		}
+		state.counters["faces/s"] = benchmark::Counter(static_cast<double>(triangles), benchmark::Counter::kIsIterationInvariantRate);
+	}
+
+	// キャッシュ有り: 元ファイルの更新判定を含めてキャッシュから読む
+	void BM_WarmCacheLoad(benchmark::State &state, const BenchFile *file)
+	{
+		std::string sourceFilePath = file->directoryPath + "/" + file->filename;
+		size_t cacheBytes = std::filesystem::file_size(MeshCache::GetCacheFilePath(sourceFilePath));
+		size_t triangles = 0;
+		for (auto _ : state) {
+			Model::ModelData modelData;
+			if (!MeshCache::Load(sourceFilePath, modelData)) {
+				state.SkipWithError("cache miss");
+				break;
+			}
+			triangles = modelData.indices.size() / 3;
+			benchmark::DoNotOptimize(modelData.vertices.data());
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * cacheBytes));
+		state.counters["faces/s"] = benchmark::Counter(static_cast<double>(triangles), benchmark::Counter::kIsIterationInvariantRate);
+	}
+
+	const bool kRegistered = [] {
+		static std::vector<BenchFile> files;
+		for (const TestSupport::ModelFile &model : TestSupport::FindBundledModels()) {
+			files.push_back(PrepareModel(model));
+		}
+		for (const BenchFile &file : files) {
+			benchmark::RegisterBenchmark(("BM_ColdObjLoad/" + file.name).c_str(), BM_ColdObjLoad, &file)->Unit(benchmark::kMicrosecond);
+			benchmark::RegisterBenchmark(("BM_WarmCacheLoad/" + file.name).c_str(), BM_WarmCacheLoad, &file)->Unit(benchmark::kMicrosecond);
+		}
+		return true;
+		}();
+
+	void BM_ColdObjLoadGrid(benchmark::State &state) { BM_ColdObjLoad(state, &GetGridFile()); }
+	void BM_WarmCacheLoadGrid(benchmark::State &state) { BM_WarmCacheLoad(state, &GetGridFile()); }
+}
+
+BENCHMARK(BM_ColdObjLoadGrid)->Unit(benchmark::kMillisecond)->Iterations(3);
+BENCHMARK(BM_WarmCacheLoadGrid)->Unit(benchmark::kMillisecond)->Iterations(3);
\ No newline at end of file
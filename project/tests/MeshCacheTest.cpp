@@ -0,0 +1,203 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "MeshCache.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+namespace {
+
+	// 同梱のモデルのディレクトリを一時ディレクトリに複製する（resources/にキャッシュを作らないため）
+	// ctest -jで並列に動いても重ならないよう、テスト名ごとのディレクトリにする
+	std::string CopyModelToTemporaryDirectory(const std::string &modelName)
+	{
+		std::string testName = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+		std::filesystem::path directory = std::filesystem::temp_directory_path() / ("MeshCacheTest_" + testName + "_" + modelName);
+		std::filesystem::remove_all(directory);
+		std::filesystem::copy(TestSupport::ResourcePath("models/" + modelName), directory, std::filesystem::copy_options::recursive);
+		return directory.string();
+	}
+
+	// ファイルの末尾に文字列を追加する
+	void AppendToFile(const std::string &filePath, const std::string &text)
+	{
+		std::ofstream file(filePath, std::ios::binary | std::ios::app);
+		file << text;
+	}
+
+	// キャッシュファイルのバイト列を読む
+	std::string ReadFile(const std::string &filePath)
+	{
+		std::ifstream file(filePath, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	// キャッシュファイルを書き換える
+	void WriteFile(const std::string &filePath, const std::string &contents)
+	{
+		std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+		file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+	}
+
+	// 読み込み結果が完全に一致する
+	void ExpectSameModelData(const Model::ModelData &actual, const Model::ModelData &expected)
+	{
+		ASSERT_EQ(actual.vertices.size(), expected.vertices.size());
+		for (size_t i = 0; i < actual.vertices.size(); ++i) {
+			ASSERT_TRUE(TestSupport::SameVertex(actual.vertices[i], expected.vertices[i])) << "vertex " << i;
+		}
+		EXPECT_EQ(actual.indices, expected.indices);
+		ASSERT_EQ(actual.materials.size(), expected.materials.size());
+		for (size_t i = 0; i < actual.materials.size(); ++i) {
+			EXPECT_EQ(actual.materials[i].name, expected.materials[i].name);
+			EXPECT_EQ(actual.materials[i].textureFilePath, expected.materials[i].textureFilePath);
+		}
+		ASSERT_EQ(actual.subMeshes.size(), expected.subMeshes.size());
+		for (size_t i = 0; i < actual.subMeshes.size(); ++i) {
+			EXPECT_EQ(actual.subMeshes[i].materialIndex, expected.subMeshes[i].materialIndex);
+			EXPECT_EQ(actual.subMeshes[i].indexStart, expected.subMeshes[i].indexStart);
+			EXPECT_EQ(actual.subMeshes[i].indexCount, expected.subMeshes[i].indexCount);
+		}
+		EXPECT_EQ(actual.materialLibraryPath, expected.materialLibraryPath);
+	}
+
+	// 複数マテリアルのモデルを複製して読み込み、キャッシュを書き出す
+	class MeshCacheTest : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			directory_ = CopyModelToTemporaryDirectory("multiMaterial");
+			sourceFilePath_ = directory_ + "/multiMaterial.obj";
+			modelData_ = ObjLoader::Load(directory_, "multiMaterial.obj", 1);
+			ASSERT_FALSE(modelData_.materialLibraryPath.empty());
+			ASSERT_TRUE(MeshCache::Save(sourceFilePath_, modelData_));
+		}
+
+		void TearDown() override
+		{
+			std::filesystem::remove_all(directory_);
+		}
+
+		std::string directory_;
+		std::string sourceFilePath_;
+		Model::ModelData modelData_;
+	};
+}
+
+// 書き出したキャッシュから、解析結果と同じデータが読める
+TEST_F(MeshCacheTest, RoundTripsModelData)
+{
+	Model::ModelData cached;
+	ASSERT_TRUE(MeshCache::Load(sourceFilePath_, cached));
+	ExpectSameModelData(cached, modelData_);
+	EXPECT_FALSE(std::filesystem::exists(MeshCache::GetCacheFilePath(sourceFilePath_) + ".tmp"));
+}
+
+// 同梱のモデルはすべて往復できる
+TEST(MeshCache, RoundTripsBundledModels)
+{
+	for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+		SCOPED_TRACE(file.filename);
+		std::string modelName = std::filesystem::path(file.directoryPath).filename().string();
+		std::string directory = CopyModelToTemporaryDirectory(modelName);
+		std::string sourceFilePath = directory + "/" + file.filename;
+		Model::ModelData modelData = ObjLoader::Load(directory, file.filename, 1);
+		ASSERT_TRUE(MeshCache::Save(sourceFilePath, modelData));
+		Model::ModelData cached;
+		ASSERT_TRUE(MeshCache::Load(sourceFilePath, cached));
+		ExpectSameModelData(cached, modelData);
+		std::filesystem::remove_all(directory);
+	}
+}
+
+// キャッシュが無ければ読み込まない
+TEST_F(MeshCacheTest, MissingCacheIsRejected)
+{
+	std::filesystem::remove(MeshCache::GetCacheFilePath(sourceFilePath_));
+	Model::ModelData cached;
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+}
+
+// objが更新されたらキャッシュは無効
+TEST_F(MeshCacheTest, StaleWhenSourceChanges)
+{
+	AppendToFile(sourceFilePath_, "# edited\n");
+	Model::ModelData cached;
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+}
+
+// サイズが同じでも更新日時が変わったら無効
+TEST_F(MeshCacheTest, StaleWhenSourceIsTouched)
+{
+	std::filesystem::last_write_time(sourceFilePath_, std::filesystem::last_write_time(sourceFilePath_) + std::chrono::seconds(2));
+	Model::ModelData cached;
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+}
+
+// mtlが更新されたらキャッシュは無効
+TEST_F(MeshCacheTest, StaleWhenMaterialLibraryChanges)
+{
+	AppendToFile(modelData_.materialLibraryPath, "# edited\n");
+	Model::ModelData cached;
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+}
+
+// 途中で切れたキャッシュは読まない
+TEST_F(MeshCacheTest, TruncatedCacheIsRejected)
+{
+	std::string cacheFilePath = MeshCache::GetCacheFilePath(sourceFilePath_);
+	std::string contents = ReadFile(cacheFilePath);
+	for (size_t length : { size_t(0), size_t(16), contents.size() / 2, contents.size() - 1 }) {
+		SCOPED_TRACE(length);
+		WriteFile(cacheFilePath, contents.substr(0, length));
+		Model::ModelData cached;
+		EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+	}
+}
+
+// 識別子・バージョンが違うキャッシュは読まない
+TEST_F(MeshCacheTest, WrongMagicOrVersionIsRejected)
+{
+	std::string cacheFilePath = MeshCache::GetCacheFilePath(sourceFilePath_);
+	const std::string contents = ReadFile(cacheFilePath);
+
+	std::string wrongMagic = contents;
+	wrongMagic[0] = 'X';
+	WriteFile(cacheFilePath, wrongMagic);
+	Model::ModelData cached;
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+
+	// バージョンは識別子の直後の4バイト
+	std::string wrongVersion = contents;
+	uint32_t version = 0;
+	std::memcpy(&version, wrongVersion.data() + 4, sizeof(version));
+	++version;
+	std::memcpy(wrongVersion.data() + 4, &version, sizeof(version));
+	WriteFile(cacheFilePath, wrongVersion);
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+
+	// 元に戻せば読める（書き換えた箇所以外は有効なキャッシュだった）
+	WriteFile(cacheFilePath, contents);
+	EXPECT_TRUE(MeshCache::Load(sourceFilePath_, cached));
+}
+
+// 頂点の範囲外を指すインデックスを含むキャッシュは読まない
+TEST_F(MeshCacheTest, OutOfRangeIndexIsRejected)
+{
+	std::string cacheFilePath = MeshCache::GetCacheFilePath(sourceFilePath_);
+	std::string contents = ReadFile(cacheFilePath);
+
+	// インデックスの列を探して、最初の要素を頂点数にする
+	std::string indexBytes(reinterpret_cast<const char *>(modelData_.indices.data()), modelData_.indices.size() * sizeof(uint32_t));
+	size_t indexOffset = contents.find(indexBytes);
+	ASSERT_NE(indexOffset, std::string::npos);
+	uint32_t outOfRange = static_cast<uint32_t>(modelData_.vertices.size());
+	std::memcpy(contents.data() + indexOffset, &outOfRange, sizeof(outOfRange));
+	WriteFile(cacheFilePath, contents);
+
+	Model::ModelData cached;
+	EXPECT_FALSE(MeshCache::Load(sourceFilePath_, cached));
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <random>
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+// メッシュの最適化: 最適化にかかる時間と、前後のACMR/ATVR/オーバーフェッチを報告する
+// 格子は読み込んだままの行順と、三角形の順をばらばらにしたもの（エクスポーターが順序を保証しない場合）の両方を測る
+namespace {
+
+	// 格子の大きさ（256x256で約13万三角形）
+	constexpr uint32_t kGridSize = 256;
+
+	void ReportStatistics(benchmark::State &state, const MeshOptimizer::Report &report)
+	{
+		state.counters["acmr_before"] = report.cacheBefore.acmr;
+		state.counters["acmr_after"] = report.cacheAfter.acmr;
+		state.counters["atvr_before"] = report.cacheBefore.atvr;
+		state.counters["atvr_after"] = report.cacheAfter.atvr;
+		state.counters["overfetch_before"] = report.fetchBefore.overfetch;
+		state.counters["overfetch_after"] = report.fetchAfter.overfetch;
+	}
+
+	void BM_MeshOptimize(benchmark::State &state, const Model::ModelData *source)
+	{
+		MeshOptimizer::Report report;
+		for (auto _ : state) {
+			state.PauseTiming();
+			Model::ModelData modelData = *source;
+			state.ResumeTiming();
+			report = MeshOptimizer::Optimize(modelData);
+			benchmark::DoNotOptimize(modelData.indices.data());
+		}
+		state.counters["triangles/s"] = benchmark::Counter(static_cast<double>(source->indices.size() / 3), benchmark::Counter::kIsIterationInvariantRate);
+		ReportStatistics(state, report);
+	}
+
+	Model::ModelData LoadGrid(bool shuffle)
+	{
+		std::string text = TestSupport::MakeGridObj(kGridSize, kGridSize);
+		Model::ModelData modelData = ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 1);
+		if (shuffle) {
+			// 三角形単位で並びを崩す（頂点の並びはそのまま）
+			size_t triangleCount = modelData.indices.size() / 3;
+			std::vector<uint32_t> order(triangleCount);
+			for (uint32_t i = 0; i < triangleCount; ++i) {
+				order[i] = i;
+			}
+			std::shuffle(order.begin(), order.end(), std::mt19937(12345));
+			std::vector<uint32_t> indices;
+			indices.reserve(modelData.indices.size());
+			for (uint32_t triangle : order) {
+				indices.insert(indices.end(), modelData.indices.begin() + triangle * 3, modelData.indices.begin() + triangle * 3 + 3);
+			}
+			modelData.indices = std::move(indices);
+		}
+		return modelData;
+	}
+
+	const bool kRegistered = [] {
+		static std::vector<std::pair<std::string, Model::ModelData>> models;
+		for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+			models.emplace_back(file.filename, ObjLoader::Load(file.directoryPath, file.filename, 1));
+		}
+		models.emplace_back("grid" + std::to_string(kGridSize), LoadGrid(false));
+		models.emplace_back("grid" + std::to_string(kGridSize) + "_shuffled", LoadGrid(true));
+		for (const auto &[name, modelData] : models) {
+			benchmark::RegisterBenchmark(("BM_MeshOptimize/" + name).c_str(), BM_MeshOptimize, &modelData)->Unit(benchmark::kMicrosecond);
+		}
+		return true;
+		}();
+}
\ No newline at end of file
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include "MeshOptimizer.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+namespace {
+
+	using Triangle = std::array<uint32_t, 3>;
+
+	// 巻き順を保ったまま、最小のインデックスが先頭に来るよう回す
+	Triangle CanonicalTriangle(uint32_t a, uint32_t b, uint32_t c)
+	{
+		if (b < a && b < c) {
+			return { b, c, a };
+		}
+		if (c < a && c < b) {
+			return { c, a, b };
+		}
+		return { a, b, c };
+	}
+
+	// 三角形の集合（並び順を無視して比べるためにソートする）
+	std::vector<Triangle> SortedTriangles(const std::vector<uint32_t> &indices, size_t begin, size_t count)
+	{
+		std::vector<Triangle> triangles;
+		for (size_t i = begin; i < begin + count; i += 3) {
+			triangles.push_back(CanonicalTriangle(indices[i], indices[i + 1], indices[i + 2]));
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	// 頂点の中身で三角形を表す（頂点の並べ替えの前後で比べるため）
+	std::vector<std::string> SortedTriangleVertices(const Model::ModelData &modelData, const Model::SubMesh &subMesh)
+	{
+		std::vector<std::string> triangles;
+		for (uint32_t i = subMesh.indexStart; i < subMesh.indexStart + subMesh.indexCount; i += 3) {
+			// 巻き順を保つため、頂点の中身で最小のものを先頭にする
+			std::array<std::string, 3> corners;
+			for (uint32_t corner = 0; corner < 3; ++corner) {
+				const Model::VertexData &vertex = modelData.vertices[modelData.indices[i + corner]];
+				corners[corner].assign(reinterpret_cast<const char *>(&vertex), sizeof(vertex));
+			}
+			size_t first = std::min_element(corners.begin(), corners.end()) - corners.begin();
+			triangles.push_back(corners[first] + corners[(first + 1) % 3] + corners[(first + 2) % 3]);
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	// 格子を三角形の順をばらばらにして読み込む（最適化の効果が出るように）
+	Model::ModelData LoadShuffledGrid(uint32_t size)
+	{
+		std::string text = TestSupport::MakeGridObj(size, size);
+		Model::ModelData modelData = ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 1);
+		std::vector<Triangle> triangles;
+		for (size_t i = 0; i < modelData.indices.size(); i += 3) {
+			triangles.push_back({ modelData.indices[i], modelData.indices[i + 1], modelData.indices[i + 2] });
+		}
+		std::shuffle(triangles.begin(), triangles.end(), std::mt19937(12345));
+		modelData.indices.clear();
+		for (const Triangle &triangle : triangles) {
+			modelData.indices.insert(modelData.indices.end(), triangle.begin(), triangle.end());
+		}
+		return modelData;
+	}
+}
+
+// 2枚の三角形が共有する頂点は1回だけ変換される
+TEST(MeshOptimizer, AnalyzeVertexCacheCountsMisses)
+{
+	std::vector<uint32_t> indices = { 0, 1, 2, 2, 1, 3 };
+	MeshOptimizer::VertexCacheStatistics statistics = MeshOptimizer::AnalyzeVertexCache(indices, 4);
+	EXPECT_EQ(statistics.vertexTransforms, 4u);
+	EXPECT_FLOAT_EQ(statistics.acmr, 2.0f);
+	EXPECT_FLOAT_EQ(statistics.atvr, 1.0f);
+
+	// キャッシュに収まらないほど離れると再び変換される
+	std::vector<uint32_t> farApart = { 0, 1, 2 };
+	for (uint32_t i = 0; i < 8; ++i) {
+		farApart.insert(farApart.end(), { 3 + i * 3, 4 + i * 3, 5 + i * 3 });
+	}
+	farApart.insert(farApart.end(), { 0, 1, 2 });
+	statistics = MeshOptimizer::AnalyzeVertexCache(farApart, 27, 16);
+	EXPECT_EQ(statistics.vertexTransforms, 30u);
+}
+
+// 頂点キャッシュの最適化は三角形の並べ替えだけで、集合と巻き順は変わらず、ACMRは悪くならない
+TEST(MeshOptimizer, OptimizeVertexCacheKeepsTrianglesAndImprovesAcmr)
+{
+	Model::ModelData modelData = LoadShuffledGrid(48);
+	std::vector<uint32_t> indices = modelData.indices;
+	MeshOptimizer::OptimizeVertexCache(indices, modelData.vertices.size());
+
+	ASSERT_EQ(indices.size(), modelData.indices.size());
+	EXPECT_EQ(SortedTriangles(indices, 0, indices.size()), SortedTriangles(modelData.indices, 0, modelData.indices.size()));
+	float before = MeshOptimizer::AnalyzeVertexCache(modelData.indices, modelData.vertices.size()).acmr;
+	float after = MeshOptimizer::AnalyzeVertexCache(indices, modelData.vertices.size()).acmr;
+	EXPECT_LT(after, before);
+	// 格子はよく並べれば1.0に近づく（ばらばらの順では約3.0）
+	EXPECT_LT(after, 1.0f);
+}
+
+// オーバードローの最適化も三角形の集合を変えない
+TEST(MeshOptimizer, OptimizeOverdrawKeepsTriangles)
+{
+	Model::ModelData modelData = LoadShuffledGrid(32);
+	std::vector<uint32_t> indices = modelData.indices;
+	MeshOptimizer::OptimizeVertexCache(indices, modelData.vertices.size());
+	float acmrAfterCache = MeshOptimizer::AnalyzeVertexCache(indices, modelData.vertices.size()).acmr;
+	MeshOptimizer::OptimizeOverdraw(indices, modelData.vertices);
+
+	EXPECT_EQ(SortedTriangles(indices, 0, indices.size()), SortedTriangles(modelData.indices, 0, modelData.indices.size()));
+	// クラスタの切れ目でしか並べ替えないので、ACMRは大きく悪化しない
+	EXPECT_LT(MeshOptimizer::AnalyzeVertexCache(indices, modelData.vertices.size()).acmr, acmrAfterCache * 1.05f);
+}
+
+// 頂点フェッチの最適化は、頂点を最初に参照される順に並べ直し、使われない頂点を取り除く
+TEST(MeshOptimizer, OptimizeVertexFetchReordersByFirstUse)
+{
+	std::vector<Model::VertexData> vertices(5);
+	for (uint32_t i = 0; i < vertices.size(); ++i) {
+		vertices[i].position = { static_cast<float>(i), 0.0f, 0.0f, 1.0f };
+	}
+	std::vector<uint32_t> indices = { 4, 2, 0, 0, 2, 3 };
+	MeshOptimizer::OptimizeVertexFetch(vertices, indices);
+
+	// 頂点1は使われていない
+	ASSERT_EQ(vertices.size(), 4u);
+	EXPECT_EQ(indices, (std::vector<uint32_t> { 0, 1, 2, 2, 1, 3 }));
+	EXPECT_EQ(vertices[0].position.x, 4.0f);
+	EXPECT_EQ(vertices[1].position.x, 2.0f);
+	EXPECT_EQ(vertices[2].position.x, 0.0f);
+	EXPECT_EQ(vertices[3].position.x, 3.0f);
+}
+
+// モデル全体の最適化: サブメッシュごとに同じ三角形（頂点の中身で比べる）が残り、キャッシュとフェッチの指標は悪くならない
+TEST(MeshOptimizer, OptimizeKeepsSubMeshTrianglesOnBundledModels)
+{
+	for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+		SCOPED_TRACE(file.filename);
+		Model::ModelData original = ObjLoader::Load(file.directoryPath, file.filename, 1);
+		Model::ModelData optimized = original;
+		MeshOptimizer::Report report = MeshOptimizer::Optimize(optimized);
+
+		ASSERT_EQ(optimized.subMeshes.size(), original.subMeshes.size());
+		ASSERT_EQ(optimized.indices.size(), original.indices.size());
+		EXPECT_LE(optimized.vertices.size(), original.vertices.size());
+		for (size_t i = 0; i < original.subMeshes.size(); ++i) {
+			EXPECT_EQ(SortedTriangleVertices(optimized, optimized.subMeshes[i]), SortedTriangleVertices(original, original.subMeshes[i])) << "subMesh " << i;
+		}
+		for (uint32_t index : optimized.indices) {
+			ASSERT_LT(index, optimized.vertices.size());
+		}
+		EXPECT_LE(report.cacheAfter.acmr, report.cacheBefore.acmr);
+		EXPECT_LE(report.fetchAfter.overfetch, report.fetchBefore.overfetch);
+	}
+}
+
+// 空のメッシュでも動く
+TEST(MeshOptimizer, HandlesEmptyMesh)
+{
+	Model::ModelData modelData;
+	MeshOptimizer::Report report = MeshOptimizer::Optimize(modelData);
+	EXPECT_TRUE(modelData.indices.empty());
+	EXPECT_EQ(report.cacheAfter.vertexTransforms, 0u);
+}
\ No newline at end of file
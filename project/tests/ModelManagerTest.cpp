@@ -0,0 +1,246 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "ModelManager.h"
+#include "fakes/ModelFakes.h"
+#include "TestSupport.h"
+
+// ModelManagerの非同期読み込み
+// ModelのGPUリソースの作成はfakes/ModelFakes.cppで置き換え、どのスレッドで何が呼ばれたかを調べる
+namespace {
+
+	// 大きさの違う格子（読み込み結果の取り違えが分かるよう、すべて三角形数が違う）
+	constexpr uint32_t kGridSizes[] = { 4, 8, 16, 32 };
+
+	class ModelManagerTest : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			// テストごとに空のディレクトリに置く（前のテストのキャッシュを使わず、ctest -jでも重ならない）
+			std::string testName = ::testing::UnitTest::GetInstance()->current_test_info()->name();
+			directory_ = std::filesystem::temp_directory_path() / ("ModelManagerTest_" + testName);
+			std::filesystem::remove_all(directory_);
+			std::filesystem::create_directories(directory_);
+			for (uint32_t size : kGridSizes) {
+				std::string filePath = (directory_ / ("grid" + std::to_string(size) + ".obj")).string();
+				std::ofstream file(filePath, std::ios::binary);
+				file << TestSupport::MakeGridObj(size, size);
+				filePaths_.push_back(filePath);
+			}
+
+			ModelManager::GetInstance()->Initialize(nullptr);
+			// 代わりに描く箱の初期化は記録に含めない
+			ModelFakes::Reset();
+		}
+
+		void TearDown() override
+		{
+			ModelManager::GetInstance()->Finalize();
+			std::filesystem::remove_all(directory_);
+		}
+
+		// すべて描画できるようになるまでUpdateを呼ぶ
+		void UpdateUntilReady(const std::vector<AssetHandle> &handles, double budgetMilliseconds = 2.0)
+		{
+			ModelManager *modelManager = ModelManager::GetInstance();
+			std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+			while (CountReady(handles) < handles.size()) {
+				ASSERT_LT(std::chrono::steady_clock::now(), deadline) << "loads did not finish";
+				modelManager->Update(budgetMilliseconds);
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+
+		static size_t CountReady(const std::vector<AssetHandle> &handles)
+		{
+			size_t count = 0;
+			for (AssetHandle handle : handles) {
+				if (ModelManager::GetInstance()->GetModelState(handle) == ModelManager::ModelState::kReady) {
+					++count;
+				}
+			}
+			return count;
+		}
+
+		static uint32_t TriangleCount(uint32_t gridSize) { return gridSize * gridSize * 2; }
+
+		std::filesystem::path directory_;
+		std::vector<std::string> filePaths_;
+	};
+}
+
+// 解析とBVHの構築はワーカースレッドで行い、呼び出し元のスレッドはUpdateでGPUリソースを作るだけ
+TEST_F(ModelManagerTest, AsyncLoadParsesOffTheCallingThread)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	AssetHandle handle = modelManager->LoadModelAsync(filePaths_[0], false, true);
+	ASSERT_TRUE(handle.IsValid());
+	// 初期化はUpdateでしか行わないので、まだ描画できない
+	EXPECT_EQ(modelManager->GetModelState(handle), ModelManager::ModelState::kPending);
+
+	UpdateUntilReady({ handle });
+
+	ModelFakes::Calls calls = ModelFakes::GetCalls();
+	const std::thread::id mainThread = std::this_thread::get_id();
+	ASSERT_EQ(calls.loadObjFileThreads.size(), 1u);
+	EXPECT_NE(calls.loadObjFileThreads[0], mainThread);
+	ASSERT_EQ(calls.buildTriangleBVHThreads.size(), 1u);
+	EXPECT_NE(calls.buildTriangleBVHThreads[0], mainThread);
+	ASSERT_EQ(calls.initializeThreads.size(), 1u);
+	EXPECT_EQ(calls.initializeThreads[0], mainThread);
+
+	Model *model = modelManager->GetModel(handle);
+	EXPECT_TRUE(model->HasTriangleBVH());
+	EXPECT_EQ(model->GetModelData().indices.size(), TriangleCount(kGridSizes[0]) * 3u);
+}
+
+// 何度依頼しても読み込みは1回で、同じハンドルが返る
+TEST_F(ModelManagerTest, RepeatedRequestsShareOneLoad)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	AssetHandle first = modelManager->LoadModelAsync(filePaths_[1]);
+	AssetHandle second = modelManager->LoadModelAsync(filePaths_[1]);
+	EXPECT_EQ(first, second);
+
+	UpdateUntilReady({ first });
+	EXPECT_EQ(modelManager->LoadModelAsync(filePaths_[1]), first);
+	EXPECT_EQ(ModelFakes::GetCalls().loadObjFileThreads.size(), 1u);
+}
+
+// 読み込み済みのモデルを違う指定で読み込んでも作り直さず、指定が無視されたことをログに出す
+TEST_F(ModelManagerTest, DifferentOptionsKeepFirstLoadAndWarn)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	AssetHandle handle = modelManager->LoadModel(filePaths_[2], false, false);
+	ASSERT_FALSE(modelManager->GetModel(handle)->HasTriangleBVH());
+
+	// 同じ指定ならログは出ない
+	testing::internal::CaptureStderr();
+	EXPECT_EQ(modelManager->LoadModel(filePaths_[2], false, false), handle);
+	EXPECT_EQ(testing::internal::GetCapturedStderr().find("ignoring"), std::string::npos);
+
+	testing::internal::CaptureStderr();
+	EXPECT_EQ(modelManager->LoadModel(filePaths_[2], false, true), handle);
+	EXPECT_EQ(modelManager->LoadModelAsync(filePaths_[2], true, false), handle);
+	std::string log = testing::internal::GetCapturedStderr();
+	EXPECT_NE(log.find("buildTriangleBVH=false, ignoring quantizeVertices=false buildTriangleBVH=true"), std::string::npos) << log;
+	EXPECT_NE(log.find("ignoring quantizeVertices=true"), std::string::npos) << log;
+
+	// 最初の読み込みのまま
+	EXPECT_FALSE(modelManager->GetModel(handle)->HasTriangleBVH());
+	EXPECT_FALSE(modelManager->GetModel(handle)->IsQuantized());
+	EXPECT_EQ(ModelFakes::GetCalls().loadObjFileThreads.size(), 1u);
+}
+
+// ハンドルとModelのポインタは読み込みの前後で変わらず、どの順で終わっても依頼したファイルの結果が入る
+TEST_F(ModelManagerTest, EachHandleReceivesItsOwnResult)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	std::vector<AssetHandle> handles;
+	std::vector<Model *> models;
+	for (const std::string &filePath : filePaths_) {
+		handles.push_back(modelManager->LoadModelAsync(filePath));
+		models.push_back(modelManager->GetModel(handles.back()));
+		ASSERT_NE(models.back(), nullptr);
+	}
+
+	UpdateUntilReady(handles);
+
+	for (size_t i = 0; i < handles.size(); ++i) {
+		EXPECT_EQ(modelManager->GetModel(handles[i]), models[i]);
+		EXPECT_EQ(modelManager->FindModel(filePaths_[i]), models[i]);
+		EXPECT_EQ(models[i]->GetModelData().indices.size(), TriangleCount(kGridSizes[i]) * 3u) << filePaths_[i];
+	}
+	// GPUリソースの作成は1つにつき1回
+	ModelFakes::Calls calls = ModelFakes::GetCalls();
+	EXPECT_EQ(calls.initializeOrder.size(), handles.size());
+}
+
+// 予算が0でも1フレームに1つは初期化し、それ以上はしない
+TEST_F(ModelManagerTest, ZeroBudgetUpdateFinalizesOneLoadPerFrame)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	std::vector<AssetHandle> handles;
+	for (const std::string &filePath : filePaths_) {
+		handles.push_back(modelManager->LoadModelAsync(filePath));
+	}
+
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+	size_t ready = 0;
+	while (ready < handles.size()) {
+		ASSERT_LT(std::chrono::steady_clock::now(), deadline) << "loads did not finish";
+		modelManager->Update(0.0);
+		size_t nowReady = CountReady(handles);
+		EXPECT_LE(nowReady, ready + 1);
+		ready = nowReady;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+// 非同期読み込み中のモデルを同期読み込みすると、終わるのを待ってその場で初期化する
+TEST_F(ModelManagerTest, SyncLoadWaitsForPendingAsyncLoad)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	AssetHandle asyncHandle = modelManager->LoadModelAsync(filePaths_[3]);
+	AssetHandle syncHandle = modelManager->LoadModel(filePaths_[3]);
+
+	EXPECT_EQ(syncHandle, asyncHandle);
+	EXPECT_EQ(modelManager->GetModelState(syncHandle), ModelManager::ModelState::kReady);
+	ModelFakes::Calls calls = ModelFakes::GetCalls();
+	EXPECT_EQ(calls.loadObjFileThreads.size(), 1u);
+	ASSERT_EQ(calls.initializeThreads.size(), 1u);
+	EXPECT_EQ(calls.initializeThreads[0], std::this_thread::get_id());
+}
+
+// 2回目の起動ではキャッシュから読み、objは解析しない
+TEST_F(ModelManagerTest, SecondRunLoadsFromCache)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	AssetHandle handle = modelManager->LoadModel(filePaths_[2]);
+	size_t indexCount = modelManager->GetModel(handle)->GetModelData().indices.size();
+	EXPECT_EQ(ModelFakes::GetCalls().loadObjFileThreads.size(), 1u);
+
+	modelManager->Finalize();
+	ModelManager::GetInstance()->Initialize(nullptr);
+	ModelFakes::Reset();
+
+	modelManager = ModelManager::GetInstance();
+	handle = modelManager->LoadModelAsync(filePaths_[2]);
+	UpdateUntilReady({ handle });
+	EXPECT_TRUE(ModelFakes::GetCalls().loadObjFileThreads.empty());
+	EXPECT_EQ(modelManager->GetModel(handle)->GetModelData().indices.size(), indexCount);
+}
+
+// 依頼していないモデル
+// 開けないファイルは例外を出さず（ワーカースレッドでも）、読み込み中と同じ箱になる。キャッシュも作らない
+TEST_F(ModelManagerTest, MissingFileFallsBackToPlaceholder)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	const size_t placeholderIndexCount = modelManager->GetPlaceholderModel()->GetModelData().indices.size();
+	ASSERT_GT(placeholderIndexCount, 0u);
+
+	std::string syncPath = (directory_ / "missingSync.obj").string();
+	AssetHandle syncHandle = modelManager->LoadModel(syncPath);
+	EXPECT_EQ(modelManager->GetModelState(syncHandle), ModelManager::ModelState::kReady);
+	EXPECT_EQ(modelManager->GetModel(syncHandle)->GetModelData().indices.size(), placeholderIndexCount);
+
+	std::string asyncPath = (directory_ / "missingAsync.obj").string();
+	AssetHandle asyncHandle = modelManager->LoadModelAsync(asyncPath, false, true);
+	UpdateUntilReady({ asyncHandle });
+	EXPECT_EQ(modelManager->GetModel(asyncHandle)->GetModelData().indices.size(), placeholderIndexCount);
+
+	for (const std::filesystem::directory_entry &entry : std::filesystem::directory_iterator(directory_)) {
+		EXPECT_EQ(entry.path().filename().string().rfind("missing", 0), std::string::npos) << entry.path();
+	}
+}
+
+TEST_F(ModelManagerTest, UnknownModelIsNotFound)
+{
+	ModelManager *modelManager = ModelManager::GetInstance();
+	EXPECT_EQ(modelManager->GetModelState(filePaths_[0]), ModelManager::ModelState::kNotFound);
+	EXPECT_EQ(modelManager->FindModel(filePaths_[0]), nullptr);
+	EXPECT_FALSE(modelManager->FindModelHandle(filePaths_[0]).IsValid());
+}
\ No newline at end of file
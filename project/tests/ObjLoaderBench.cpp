@@ -0,0 +1,145 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include "ObjLoader.h"
+#include "LegacyObjLoader.h"
+#include "TestSupport.h"
+
+// objの読み込み: 書き換える前の読み込み（getline/istringstream）と、バッファ上で直接解析するObjLoaderの比較
+// ObjLoaderは1スレッドで測る（スレッド数ごとの計測はBM_ObjLoaderParallel）
+namespace {
+
+	// 同梱のモデルと、数百万面の格子
+	struct BenchFile
+	{
+		std::string name;
+		std::string directoryPath;
+		std::string filename;
+	};
+
+	// 格子の大きさ（1024x1024で約200万三角形、約130MB）
+	constexpr uint32_t kGridSize = 1024;
+
+	const BenchFile &GetGridFile()
+	{
+		static const BenchFile file = [] {
+			std::string path = TestSupport::WriteTemporaryFile("ObjLoaderBench_grid.obj", TestSupport::MakeGridObj(kGridSize, kGridSize));
+			std::filesystem::path fullPath(path);
+			return BenchFile { "grid" + std::to_string(kGridSize), fullPath.parent_path().string(), fullPath.filename().string() };
+			}();
+		return file;
+	}
+
+	void BM_LegacyLoadObj(benchmark::State &state, const BenchFile *file)
+	{
+		size_t bytes = std::filesystem::file_size(file->directoryPath + "/" + file->filename);
+		size_t triangles = 0;
+		for (auto _ : state) {
+			std::vector<Model::VertexData> vertices = LegacyObjLoader::LoadObjFile(file->directoryPath, file->filename);
+			triangles = vertices.size() / 3;
+			benchmark::DoNotOptimize(vertices.data());
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+		state.counters["faces/s"] = benchmark::Counter(static_cast<double>(triangles), benchmark::Counter::kIsIterationInvariantRate);
+	}
+
+	void BM_ObjLoader(benchmark::State &state, const BenchFile *file)
+	{
+		size_t bytes = std::filesystem::file_size(file->directoryPath + "/" + file->filename);
+		size_t triangles = 0;
+		for (auto _ : state) {
+			Model::ModelData modelData = ObjLoader::Load(file->directoryPath, file->filename, 1);
+			triangles = modelData.indices.size() / 3;
+			benchmark::DoNotOptimize(modelData.vertices.data());
+		}
+		state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+		state.counters["faces/s"] = benchmark::Counter(static_cast<double>(triangles), benchmark::Counter::kIsIterationInvariantRate);
+	}
+
+	// 同梱のモデルはファイルが見つかった分だけ登録する
+	const bool kRegistered = [] {
+		static std::vector<BenchFile> files;
+		for (const TestSupport::ModelFile &model : TestSupport::FindBundledModels()) {
+			files.push_back({ model.filename, model.directoryPath, model.filename });
+		}
+		for (const BenchFile &file : files) {
+			benchmark::RegisterBenchmark(("BM_LegacyLoadObj/" + file.name).c_str(), BM_LegacyLoadObj, &file)->Unit(benchmark::kMicrosecond);
+			benchmark::RegisterBenchmark(("BM_ObjLoader/" + file.name).c_str(), BM_ObjLoader, &file)->Unit(benchmark::kMicrosecond);
+		}
+		return true;
+		}();
+
+	void BM_LegacyLoadObjGrid(benchmark::State &state) { BM_LegacyLoadObj(state, &GetGridFile()); }
+	void BM_ObjLoaderGrid(benchmark::State &state) { BM_ObjLoader(state, &GetGridFile()); }
+}
+
+BENCHMARK(BM_LegacyLoadObjGrid)->Unit(benchmark::kMillisecond)->Iterations(1);
+BENCHMARK(BM_ObjLoaderGrid)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+// ===== 並列読み込み =====
+// 格子をスレッド数ごとに読み込み、MB/sと三角形/sを報告する（ファイル読み込みは含めず、メモリ上のテキストを解析する）
+// parse_ms: チャンクの解析、resolve_ms: 配列の連結と面の変換・頂点の重複除去
+static void BM_ObjLoaderParallel(benchmark::State &state)
+{
+	static const std::string text = TestSupport::MakeGridObj(kGridSize, kGridSize);
+	const uint32_t threadCount = static_cast<uint32_t>(state.range(0));
+	ObjLoader::LoadStats stats;
+	double parseSeconds = 0.0;
+	double resolveSeconds = 0.0;
+	for (auto _ : state) {
+		Model::ModelData modelData = ObjLoader::Parse(text.data(), text.data() + text.size(), ".", threadCount, &stats);
+		benchmark::DoNotOptimize(modelData.vertices.data());
+		parseSeconds += stats.parseSeconds;
+		resolveSeconds += stats.resolveSeconds;
+	}
+	state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * text.size()));
+	state.counters["threads"] = stats.threadCount;
+	state.counters["faces/s"] = benchmark::Counter(static_cast<double>(stats.triangles), benchmark::Counter::kIsIterationInvariantRate);
+	state.counters["parse_ms"] = parseSeconds * 1000.0 / static_cast<double>(state.iterations());
+	state.counters["resolve_ms"] = resolveSeconds * 1000.0 / static_cast<double>(state.iterations());
+}
+BENCHMARK(BM_ObjLoaderParallel)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime()->Iterations(3);
+
+// ===== インデックス化によるメモリ削減 =====
+// 三角形の頂点をすべて展開した場合（書き換える前）と、重複を除いた頂点＋インデックスのバイト数を報告する
+// 時間は読み込み（1スレッド）にかかった時間
+static void ReportIndexedMemory(benchmark::State &state, const Model::ModelData &modelData)
+{
+	double expandedBytes = static_cast<double>(sizeof(Model::VertexData) * modelData.indices.size());
+	double indexedBytes = static_cast<double>(sizeof(Model::VertexData) * modelData.vertices.size() +
+		Model::GetIndexSize(modelData.vertices.size()) * modelData.indices.size());
+	state.counters["vertices"] = static_cast<double>(modelData.vertices.size());
+	state.counters["indices"] = static_cast<double>(modelData.indices.size());
+	state.counters["expanded_KB"] = expandedBytes / 1024.0;
+	state.counters["indexed_KB"] = indexedBytes / 1024.0;
+	state.counters["saved_%"] = expandedBytes > 0.0 ? (1.0 - indexedBytes / expandedBytes) * 100.0 : 0.0;
+}
+
+static void BM_IndexedMemory(benchmark::State &state, const TestSupport::ModelFile *file)
+{
+	Model::ModelData modelData;
+	for (auto _ : state) {
+		modelData = ObjLoader::Load(file->directoryPath, file->filename, 1);
+		benchmark::DoNotOptimize(modelData.vertices.data());
+	}
+	ReportIndexedMemory(state, modelData);
+}
+
+static const bool kIndexedMemoryRegistered = [] {
+	static std::vector<TestSupport::ModelFile> files = TestSupport::FindBundledModels();
+	for (const TestSupport::ModelFile &file : files) {
+		benchmark::RegisterBenchmark(("BM_IndexedMemory/" + file.filename).c_str(), BM_IndexedMemory, &file)->Unit(benchmark::kMicrosecond);
+	}
+	return true;
+	}();
+
+static void BM_IndexedMemoryGrid(benchmark::State &state)
+{
+	static const std::string text = TestSupport::MakeGridObj(kGridSize, kGridSize);
+	Model::ModelData modelData;
+	for (auto _ : state) {
+		modelData = ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 1);
+		benchmark::DoNotOptimize(modelData.vertices.data());
+	}
+	ReportIndexedMemory(state, modelData);
+}
+BENCHMARK(BM_IndexedMemoryGrid)->Unit(benchmark::kMillisecond)->Iterations(1);
\ No newline at end of file
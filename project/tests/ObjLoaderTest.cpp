@@ -0,0 +1,389 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include "ObjLoader.h"
+#include "LegacyObjLoader.h"
+#include "TestSupport.h"
+
+namespace {
+
+	// テキストを1スレッドで解析する
+	Model::ModelData ParseText(const std::string &text, ObjLoader::LoadStats *stats = nullptr)
+	{
+		return ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 1, stats);
+	}
+
+	// 三角形1枚分の位置（x, y, z）を調べる
+	void ExpectTrianglePositions(const std::vector<Model::VertexData> &vertices, size_t triangle, const float expected[3][3])
+	{
+		for (size_t corner = 0; corner < 3; ++corner) {
+			const math::Vector4 &position = vertices[triangle * 3 + corner].position;
+			EXPECT_EQ(position.x, expected[corner][0]) << "triangle " << triangle << " corner " << corner;
+			EXPECT_EQ(position.y, expected[corner][1]) << "triangle " << triangle << " corner " << corner;
+			EXPECT_EQ(position.z, expected[corner][2]) << "triangle " << triangle << " corner " << corner;
+			EXPECT_EQ(position.w, 1.0f);
+		}
+	}
+}
+
+// 同梱のモデルは、書き換える前の読み込みと頂点がビット単位で一致する
+// （複数マテリアルのモデルは面の並びがマテリアル順に変わるので、usemtlが1種類のものだけ比べる）
+TEST(ObjLoader, MatchesLegacyLoaderOnBundledModels)
+{
+	for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+		Model::ModelData modelData = ObjLoader::Load(file.directoryPath, file.filename, 1);
+		if (modelData.subMeshes.size() != 1) {
+			continue;
+		}
+		SCOPED_TRACE(file.filename);
+		std::vector<Model::VertexData> expected = LegacyObjLoader::LoadObjFile(file.directoryPath, file.filename);
+		std::vector<Model::VertexData> actual = TestSupport::ExpandTriangles(modelData);
+		ASSERT_EQ(actual.size(), expected.size());
+		for (size_t i = 0; i < actual.size(); ++i) {
+			ASSERT_TRUE(TestSupport::SameVertex(actual[i], expected[i])) << "vertex " << i;
+		}
+	}
+}
+
+// 大きな格子でも一致する（数値の書式と行数が多い場合）
+TEST(ObjLoader, MatchesLegacyLoaderOnSyntheticGrid)
+{
+	std::string path = TestSupport::WriteTemporaryFile("ObjLoaderTest_grid.obj", TestSupport::MakeGridObj(64, 48));
+	std::string directory = path.substr(0, path.find_last_of('/'));
+	std::string filename = path.substr(path.find_last_of('/') + 1);
+
+	std::vector<Model::VertexData> expected = LegacyObjLoader::LoadObjFile(directory, filename);
+	std::vector<Model::VertexData> actual = TestSupport::ExpandTriangles(ObjLoader::Load(directory, filename, 1));
+	ASSERT_EQ(actual.size(), expected.size());
+	for (size_t i = 0; i < actual.size(); ++i) {
+		ASSERT_TRUE(TestSupport::SameVertex(actual[i], expected[i])) << "vertex " << i;
+	}
+}
+
+// 負のインデックスは直前までに定義された要素からの相対位置
+TEST(ObjLoader, NegativeIndicesAreRelativeToPrecedingElements)
+{
+	const std::string absolute =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\n"
+		"f 1/1/1 2/2/1 3/3/1\n"
+		"v 5 5 5\nv 6 5 5\nv 5 6 5\n"
+		"f 4/1/1 5/2/1 6/3/1\n";
+	const std::string relative =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvn 0 0 1\n"
+		"f -3/-3/-1 -2/-2/-1 -1/-1/-1\n"
+		"v 5 5 5\nv 6 5 5\nv 5 6 5\n"
+		"f -3/-3/-1 -2/-2/-1 -1/-1/-1\n";
+
+	std::vector<Model::VertexData> expected = TestSupport::ExpandTriangles(ParseText(absolute));
+	std::vector<Model::VertexData> actual = TestSupport::ExpandTriangles(ParseText(relative));
+	ASSERT_EQ(actual.size(), 6u);
+	ASSERT_EQ(actual.size(), expected.size());
+	for (size_t i = 0; i < actual.size(); ++i) {
+		EXPECT_TRUE(TestSupport::SameVertex(actual[i], expected[i])) << "vertex " << i;
+	}
+}
+
+// "v//vn"はUVが無いので(0, 0)、法線はvnの値（xは反転）
+TEST(ObjLoader, PositionNormalForm)
+{
+	Model::ModelData modelData = ParseText("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0.5 0 1\nf 1//1 2//1 3//1\n");
+	std::vector<Model::VertexData> vertices = TestSupport::ExpandTriangles(modelData);
+	ASSERT_EQ(vertices.size(), 3u);
+	for (const Model::VertexData &vertex : vertices) {
+		EXPECT_EQ(vertex.texcoord.x, 0.0f);
+		EXPECT_EQ(vertex.texcoord.y, 0.0f);
+		EXPECT_EQ(vertex.normal.x, -0.5f);
+		EXPECT_EQ(vertex.normal.y, 0.0f);
+		EXPECT_EQ(vertex.normal.z, 1.0f);
+	}
+	// 同じ組の頂点は1つにまとまる
+	EXPECT_EQ(modelData.vertices.size(), 3u);
+}
+
+// "v/vt"は法線が無いので面法線を使う（vは上下反転）
+TEST(ObjLoader, PositionTexcoordFormUsesFaceNormal)
+{
+	std::vector<Model::VertexData> vertices = TestSupport::ExpandTriangles(
+		ParseText("v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0.25 0.75\nf 1/1 2/1 3/1\n"));
+	ASSERT_EQ(vertices.size(), 3u);
+	for (const Model::VertexData &vertex : vertices) {
+		EXPECT_EQ(vertex.texcoord.x, 0.25f);
+		EXPECT_EQ(vertex.texcoord.y, 0.25f);
+		// objでは+z向きの面。読み込み時と同じくxを反転した座標系での法線
+		EXPECT_FLOAT_EQ(vertex.normal.x, 0.0f);
+		EXPECT_FLOAT_EQ(vertex.normal.y, 0.0f);
+		EXPECT_FLOAT_EQ(vertex.normal.z, 1.0f);
+	}
+}
+
+// 多角形は扇状に三角形へ分割し、回り順を反転する
+TEST(ObjLoader, PolygonsAreTriangulatedAsFan)
+{
+	std::vector<Model::VertexData> vertices = TestSupport::ExpandTriangles(
+		ParseText("v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3//1 4//1\n"));
+	ASSERT_EQ(vertices.size(), 6u);
+	const float first[3][3] = { { 1, 1, 0 }, { 1, 0, 0 }, { 0, 0, 0 } };
+	const float second[3][3] = { { 0, 1, 0 }, { 1, 1, 0 }, { 0, 0, 0 } };
+	ExpectTrianglePositions(vertices, 0, first);
+	ExpectTrianglePositions(vertices, 1, second);
+}
+
+// CRLFの改行、コメント、前後の空白、未対応の行は読み飛ばす
+TEST(ObjLoader, IgnoresCommentsAndCarriageReturns)
+{
+	const std::string text =
+		"# comment\r\n"
+		"o Object\r\n"
+		"s off\r\n"
+		"  v 0 0 0\r\n"
+		"v\t1 0 0\r\n"
+		"v 0 1 0   \r\n"
+		"vn 0 0 1\r\n"
+		"\r\n"
+		"f 1//1 2//1 3//1\r\n";
+	std::vector<Model::VertexData> vertices = TestSupport::ExpandTriangles(ParseText(text));
+	ASSERT_EQ(vertices.size(), 3u);
+	const float expected[3][3] = { { 0, 1, 0 }, { 1, 0, 0 }, { 0, 0, 0 } };
+	ExpectTrianglePositions(vertices, 0, expected);
+}
+
+// 数値の書式（符号、指数、整数、長い桁）はstrtofと同じ値になる
+TEST(ObjLoader, ParsesFloatFormats)
+{
+	const char *values[] = {
+		"1", "-2.5", "+3.25", "0.000001", "-0.0", "1e3", "2.5E-3", "-7.125e+2", ".5", "123456.789",
+		"3.14159265358979323846", "0.1", "1.17549435e-38", "3.4e38", "100000000000000000000000",
+	};
+	for (const char *value : values) {
+		std::string text = std::string("v ") + value + " 0 0\nv 0 1 0\nv 0 0 1\nvn 0 0 1\nf 1//1 2//1 3//1\n";
+		Model::ModelData modelData = ParseText(text);
+		ASSERT_EQ(modelData.indices.size(), 3u);
+		float expected = std::strtof(value, nullptr);
+		float actual = modelData.vertices[modelData.indices[2]].position.x;
+		// 桁の多い値はdoubleを経由するため最下位ビットが丸めで1つずれることがある
+		EXPECT_NEAR(actual, expected, std::fabs(expected) * 1e-7f) << value;
+		EXPECT_EQ(std::signbit(actual), std::signbit(expected)) << value;
+	}
+}
+
+// 位置のインデックスが無い・範囲外の面は読み飛ばし、範囲外を読まない
+TEST(ObjLoader, SkipsFacesWithInvalidPositionIndices)
+{
+	const std::string text =
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\n"
+		"f 1//1 2//1 3//1\n"
+		"f 1//1 2//1 9//1\n" // 範囲外
+		"f 1//1 2//1 0//1\n" // 0は無効
+		"f -1//1 -2//1 -7//1\n" // 相対で先頭より前
+		"f 1//1 2//1 99999999999999999999//1\n" // int32に収まらない
+		"f //1 2//1 3//1\n" // 位置が無い
+		"f 1//1 2//1\n" // 三角形にならない
+		"f 3//1 2//1 1//1\n";
+	ObjLoader::LoadStats stats;
+	Model::ModelData modelData = ParseText(text, &stats);
+	EXPECT_EQ(stats.triangles, 2u);
+	EXPECT_EQ(stats.skippedTriangles, 5u);
+	ASSERT_EQ(modelData.indices.size(), 6u);
+	ASSERT_EQ(modelData.subMeshes.size(), 1u);
+	EXPECT_EQ(modelData.subMeshes[0].indexCount, 6u);
+	for (uint32_t index : modelData.indices) {
+		EXPECT_LT(index, modelData.vertices.size());
+	}
+}
+
+// UVと法線のインデックスが範囲外なら、その要素だけ無いものとして扱う
+TEST(ObjLoader, OutOfRangeTexcoordAndNormalFallBack)
+{
+	std::vector<Model::VertexData> vertices = TestSupport::ExpandTriangles(
+		ParseText("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/5/5 2/5/5 3/5/5\n"));
+	ASSERT_EQ(vertices.size(), 3u);
+	for (const Model::VertexData &vertex : vertices) {
+		EXPECT_EQ(vertex.texcoord.x, 0.0f);
+		EXPECT_EQ(vertex.texcoord.y, 0.0f);
+		EXPECT_FLOAT_EQ(vertex.normal.z, 1.0f);
+	}
+}
+
+// 面が1つも無くても空のモデルになる
+TEST(ObjLoader, EmptyInput)
+{
+	ObjLoader::LoadStats stats;
+	Model::ModelData modelData = ParseText("", &stats);
+	EXPECT_TRUE(modelData.vertices.empty());
+	EXPECT_TRUE(modelData.indices.empty());
+	EXPECT_TRUE(modelData.subMeshes.empty());
+	// 描画できるようにマテリアルは1つ用意される
+	EXPECT_EQ(modelData.materials.size(), 1u);
+	EXPECT_EQ(stats.triangles, 0u);
+}
+
+// 開けないファイルは例外を投げずに空のモデルになる（ModelManagerが代わりの箱を使う）
+TEST(ObjLoader, MissingFileGivesEmptyModel)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "ObjLoaderTest_MissingFile";
+	std::filesystem::remove_all(directory);
+	Model::ModelData modelData;
+	EXPECT_NO_THROW(modelData = ObjLoader::Load(directory.string(), "missing.obj", 1));
+	EXPECT_TRUE(modelData.vertices.empty());
+	EXPECT_TRUE(modelData.indices.empty());
+	EXPECT_TRUE(modelData.subMeshes.empty());
+}
+
+// mtlファイルが開けなければ、マテリアルが無いときと同じく既定のマテリアルを1つ使う
+TEST(ObjLoader, MissingMaterialFileUsesDefaultMaterial)
+{
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "ObjLoaderTest_MissingMaterial";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+	{
+		std::ofstream file(directory / "triangle.obj", std::ios::binary);
+		file << "mtllib missing.mtl\nv 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl a\nf 1 2 3\n";
+	}
+	Model::ModelData modelData = ObjLoader::Load(directory.string(), "triangle.obj", 1);
+	EXPECT_EQ(modelData.indices.size(), 3u);
+	ASSERT_EQ(modelData.materials.size(), 1u);
+	EXPECT_TRUE(modelData.materials[0].textureFilePath.empty());
+	std::filesystem::remove_all(directory);
+}
+
+// ===== 並列読み込み =====
+
+namespace {
+
+	// 2つのモデルデータが完全に一致するか
+	void ExpectSameModelData(const Model::ModelData &actual, const Model::ModelData &expected)
+	{
+		ASSERT_EQ(actual.vertices.size(), expected.vertices.size());
+		ASSERT_EQ(actual.indices, expected.indices);
+		for (size_t i = 0; i < actual.vertices.size(); ++i) {
+			ASSERT_TRUE(TestSupport::SameVertex(actual.vertices[i], expected.vertices[i])) << "vertex " << i;
+		}
+		ASSERT_EQ(actual.subMeshes.size(), expected.subMeshes.size());
+		for (size_t i = 0; i < actual.subMeshes.size(); ++i) {
+			EXPECT_EQ(actual.subMeshes[i].indexStart, expected.subMeshes[i].indexStart);
+			EXPECT_EQ(actual.subMeshes[i].indexCount, expected.subMeshes[i].indexCount);
+			EXPECT_EQ(actual.subMeshes[i].materialIndex, expected.subMeshes[i].materialIndex);
+		}
+	}
+
+	// 負のインデックスだけで書かれた三角形を並べたテキスト（チャンクをまたぐ相対参照の確認用）
+	std::string MakeRelativeIndexObj(uint32_t triangleCount)
+	{
+		std::string text;
+		for (uint32_t i = 0; i < triangleCount; ++i) {
+			std::string x = std::to_string(i);
+			text += "v " + x + " 0 0\nv " + x + " 1 0\nv " + x + " 0 1\nvt 0 0\nvt 1 0\nvn 0 0 1\n";
+			// 前の三角形の頂点も参照する
+			text += (i == 0) ? "f -3/-2/-1 -2/-1/-1 -1/-2/-1\n" : "f -4/-2/-1 -2/-1/-1 -1/-2/-1\n";
+		}
+		return text;
+	}
+}
+
+// スレッド数を変えても、1スレッドのときと同じ結果になる
+TEST(ObjLoaderParallel, SameResultForAnyThreadCount)
+{
+	// 1スレッドあたり256KB以上でないと分割しないので、8分割できる大きさにする
+	const std::string text = TestSupport::MakeGridObj(160, 160);
+	ASSERT_GT(text.size(), 8u * 256 * 1024);
+
+	ObjLoader::LoadStats singleStats;
+	Model::ModelData single = ParseText(text, &singleStats);
+	EXPECT_EQ(singleStats.threadCount, 1u);
+	for (uint32_t threadCount : { 2u, 3u, 4u, 7u, 8u }) {
+		SCOPED_TRACE(threadCount);
+		ObjLoader::LoadStats stats;
+		Model::ModelData parallel = ObjLoader::Parse(text.data(), text.data() + text.size(), ".", threadCount, &stats);
+		EXPECT_EQ(stats.threadCount, threadCount);
+		EXPECT_EQ(stats.triangles, singleStats.triangles);
+		ExpectSameModelData(parallel, single);
+	}
+}
+
+// 負のインデックスがチャンクの境界をまたいでも、ファイル全体での位置に直される
+TEST(ObjLoaderParallel, RelativeIndicesAcrossChunks)
+{
+	const std::string text = MakeRelativeIndexObj(40000);
+	ObjLoader::LoadStats stats;
+	Model::ModelData single = ParseText(text);
+	Model::ModelData parallel = ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 4, &stats);
+	ASSERT_EQ(stats.threadCount, 4u);
+	EXPECT_EQ(stats.skippedTriangles, 0u);
+	ExpectSameModelData(parallel, single);
+
+	// 2つ目以降の三角形の1頂点目は、1つ前の三角形の3頂点目（x座標が1つ小さい）
+	std::vector<Model::VertexData> vertices = TestSupport::ExpandTriangles(parallel);
+	ASSERT_EQ(vertices.size(), 40000u * 3);
+	for (size_t triangle = 1; triangle < 40000; ++triangle) {
+		ASSERT_EQ(vertices[triangle * 3 + 2].position.x, static_cast<float>(triangle - 1)) << "triangle " << triangle;
+		ASSERT_EQ(vertices[triangle * 3 + 1].position.x, static_cast<float>(triangle)) << "triangle " << triangle;
+	}
+}
+
+// 小さいファイルは分割しない
+TEST(ObjLoaderParallel, SmallFilesUseOneThread)
+{
+	ObjLoader::LoadStats stats;
+	std::string text = TestSupport::MakeGridObj(4, 4);
+	ObjLoader::Parse(text.data(), text.data() + text.size(), ".", 8, &stats);
+	EXPECT_EQ(stats.threadCount, 1u);
+}
+
+// ===== インデックス化 =====
+
+// 位置/UV/法線の組が同じ頂点は1つにまとまり、展開すると元の三角形に戻る
+TEST(ObjLoaderIndexed, DeduplicatesSharedCorners)
+{
+	const uint32_t columns = 32;
+	const uint32_t rows = 24;
+	std::string text = TestSupport::MakeGridObj(columns, rows);
+	Model::ModelData modelData = ParseText(text);
+
+	// 格子の頂点はすべて隣の四角形と共有される
+	EXPECT_EQ(modelData.vertices.size(), size_t(columns + 1) * (rows + 1));
+	EXPECT_EQ(modelData.indices.size(), size_t(columns) * rows * 6);
+	for (uint32_t index : modelData.indices) {
+		ASSERT_LT(index, modelData.vertices.size());
+	}
+
+	// 展開した頂点は書き換える前の読み込みとビット単位で一致する
+	std::string path = TestSupport::WriteTemporaryFile("ObjLoaderIndexedTest_grid.obj", text);
+	std::vector<Model::VertexData> expected = LegacyObjLoader::LoadObjFile(path.substr(0, path.find_last_of('/')), path.substr(path.find_last_of('/') + 1));
+	std::vector<Model::VertexData> actual = TestSupport::ExpandTriangles(modelData);
+	ASSERT_EQ(actual.size(), expected.size());
+	for (size_t i = 0; i < actual.size(); ++i) {
+		ASSERT_TRUE(TestSupport::SameVertex(actual[i], expected[i])) << "vertex " << i;
+	}
+}
+
+// 位置が同じでもUVか法線が違えば別の頂点になる
+TEST(ObjLoaderIndexed, KeepsCornersWithDifferentAttributes)
+{
+	Model::ModelData modelData = ParseText(
+		"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 1\nvn 0 0 1\nvn 0 1 0\n"
+		"f 1/1/1 2/1/1 3/1/1\n"
+		"f 1/2/1 2/1/1 3/1/1\n"
+		"f 1/1/2 2/1/1 3/1/1\n");
+	// 2と3は3つの三角形で共有、1は3通り
+	EXPECT_EQ(modelData.vertices.size(), 5u);
+	EXPECT_EQ(modelData.indices.size(), 9u);
+}
+
+// 法線の無い頂点は面法線が面ごとに異なるので共有しない
+TEST(ObjLoaderIndexed, FacesWithoutNormalsDoNotShareVertices)
+{
+	Model::ModelData modelData = ParseText("v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 1\nf 1 2 3\nf 2 4 3\n");
+	EXPECT_EQ(modelData.vertices.size(), 6u);
+}
+
+// インデックスの大きさは頂点数で決まる
+TEST(ObjLoaderIndexed, IndexSizeFollowsVertexCount)
+{
+	EXPECT_EQ(Model::GetIndexSize(0), 2u);
+	EXPECT_EQ(Model::GetIndexSize(65535), 2u);
+	EXPECT_EQ(Model::GetIndexSize(65536), 4u);
+	EXPECT_EQ(Model::GetIndexSize(1u << 24), 4u);
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "OcclusionBuffer.h"
+#include "BoundingVolume.h"
+#include "MathFunctions.h"
+
+// 合成した街（24x24区画の建物と地面、道路に小物2万個）でのソフトウェアオクルージョンカリング
+// 通りに立つ視点3つと上空の視点1つから16方向ずつ見て、オクルーダーを描く時間と、
+// 視錐台に入った小物のうち何%を隠れているとして捨てられたか（rejected_percent）を測る
+namespace {
+
+	struct City
+	{
+		std::vector<math::Vector3> positions; // 建物ごとに8頂点、最後に地面の4頂点
+		std::vector<math::AABB> buildings;
+		std::vector<math::AABB> props;
+		std::vector<math::Matrix4x4> viewProjections;
+		std::vector<math::Frustum> frustums;
+	};
+
+	const uint32_t kBoxIndices[36] = {
+		0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+		2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3,
+	};
+	const uint32_t kGroundIndices[6] = { 0, 1, 2, 0, 2, 3 };
+
+	const City &GetCity()
+	{
+		static const City city = [] {
+			const int blocks = 24;
+			const float pitch = 20.0f;
+			const float footprint = 14.0f;
+			City result;
+			std::mt19937 random(7);
+			std::uniform_real_distribution<float> height(8.0f, 40.0f);
+			for (int i = 0; i < blocks; ++i) {
+				for (int j = 0; j < blocks; ++j) {
+					float x = static_cast<float>(i) * pitch;
+					float z = static_cast<float>(j) * pitch;
+					math::AABB box = { { x, 0.0f, z }, { x + footprint, height(random), z + footprint } };
+					result.buildings.push_back(box);
+					for (uint32_t k = 0; k < 8; ++k) {
+						result.positions.push_back({ (k & 1) ? box.max.x : box.min.x, (k & 2) ? box.max.y : box.min.y, (k & 4) ? box.max.z : box.min.z });
+					}
+				}
+			}
+			float length = blocks * pitch;
+			result.positions.insert(result.positions.end(), { { -10.0f, 0.0f, -10.0f }, { length, 0.0f, -10.0f }, { length, 0.0f, length }, { -10.0f, 0.0f, length } });
+
+			// 人・車・街灯くらいの大きさの物を道路に置く
+			std::uniform_real_distribution<float> place(-5.0f, length);
+			std::uniform_real_distribution<float> size(0.5f, 2.5f);
+			std::uniform_real_distribution<float> propHeight(1.0f, 4.0f);
+			while (result.props.size() < 20000) {
+				float x = place(random);
+				float z = place(random);
+				float localX = std::fmod(x + pitch, pitch);
+				float localZ = std::fmod(z + pitch, pitch);
+				if (localX < footprint + 0.5f && localZ < footprint + 0.5f) {
+					continue;
+				}
+				float halfSize = size(random) * 0.5f;
+				result.props.push_back({ { x - halfSize, 0.01f, z - halfSize }, { x + halfSize, propHeight(random), z + halfSize } });
+			}
+
+			math::Matrix4x4 projection = math::MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 1000.0f);
+			const math::Vector3 eyes[] = {
+				{ 10.0f * pitch + 17.0f, 1.7f, 10.0f * pitch + 17.0f },
+				{ 3.0f * pitch + 17.0f, 1.7f, 5.0f * pitch + 17.0f },
+				{ 20.0f * pitch + 17.0f, 1.7f, 2.0f * pitch + 17.0f },
+				{ 12.0f * pitch + 17.0f, 30.0f, 12.0f * pitch + 17.0f },
+			};
+			for (const math::Vector3 &eye : eyes) {
+				for (int direction = 0; direction < 16; ++direction) {
+					math::Vector3 rotation = { eye.y > 10.0f ? 0.35f : 0.02f, static_cast<float>(direction) * 0.3926991f + 0.1f, 0.0f };
+					math::Matrix4x4 view = math::Inverse(math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotation, eye));
+					result.viewProjections.push_back(math::Multiply(view, projection));
+					result.frustums.push_back(math::MakeFrustum(result.viewProjections.back()));
+				}
+			}
+			return result;
+			}();
+		return city;
+	}
+
+	// 視錐台に入っている建物と地面を描く（エンジンでもカリングの結果から描く）
+	void RenderCity(OcclusionBuffer &buffer, const City &city, size_t view)
+	{
+		math::Matrix4x4 identity = math::MakeScaleMatrix({ 1.0f, 1.0f, 1.0f });
+		buffer.BeginFrame(city.viewProjections[view]);
+		for (size_t i = 0; i < city.buildings.size(); ++i) {
+			if (math::IsVisible(city.frustums[view], city.buildings[i])) {
+				buffer.RenderOccluder(&city.positions[i * 8].x, sizeof(math::Vector3), 8, kBoxIndices, 36, identity);
+			}
+		}
+		buffer.RenderOccluder(&city.positions[city.buildings.size() * 8].x, sizeof(math::Vector3), 4, kGroundIndices, 6, identity);
+		buffer.EndFrame();
+	}
+
+	// オクルーダーを描く時間（解像度ごと）。1回の反復で1視点
+	void BM_OcclusionRaster(benchmark::State &state)
+	{
+		const City &city = GetCity();
+		uint32_t width = static_cast<uint32_t>(state.range(0));
+		OcclusionBuffer buffer;
+		buffer.Initialize(width, width * 9 / 16);
+		size_t view = 0;
+		uint64_t triangles = 0;
+		for (auto _ : state) {
+			RenderCity(buffer, city, view);
+			triangles += buffer.GetStatistics().rasterizedTriangles;
+			view = (view + 1) % city.viewProjections.size();
+		}
+		state.counters["rasterized_triangles"] = static_cast<double>(triangles) / static_cast<double>(state.iterations());
+	}
+
+	// 視錐台に入った小物をすべて調べる時間と、捨てられた割合。1回の反復で1視点
+	void BM_OcclusionTest(benchmark::State &state)
+	{
+		const City &city = GetCity();
+		uint32_t width = static_cast<uint32_t>(state.range(0));
+		OcclusionBuffer buffer;
+		buffer.Initialize(width, width * 9 / 16);
+
+		// 視点ごとに視錐台に入る小物を選び、深度バッファを描いておく
+		std::vector<std::vector<math::AABB>> visibleProps(city.viewProjections.size());
+		std::vector<OcclusionBuffer> buffers(city.viewProjections.size(), buffer);
+		for (size_t view = 0; view < visibleProps.size(); ++view) {
+			for (const math::AABB &prop : city.props) {
+				if (math::IsVisible(city.frustums[view], prop)) {
+					visibleProps[view].push_back(prop);
+				}
+			}
+			RenderCity(buffers[view], city, view);
+		}
+
+		size_t view = 0;
+		uint64_t tested = 0;
+		uint64_t rejected = 0;
+		for (auto _ : state) {
+			for (const math::AABB &prop : visibleProps[view]) {
+				rejected += buffers[view].IsOccluded(prop);
+			}
+			tested += visibleProps[view].size();
+			view = (view + 1) % visibleProps.size();
+		}
+		state.SetItemsProcessed(static_cast<int64_t>(tested));
+		state.counters["tested_per_view"] = static_cast<double>(tested) / static_cast<double>(state.iterations());
+		state.counters["rejected_percent"] = 100.0 * static_cast<double>(rejected) / static_cast<double>(tested);
+	}
+
+}
+
+BENCHMARK(BM_OcclusionRaster)->ArgName("width")->Arg(128)->Arg(256)->Arg(512)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OcclusionTest)->ArgName("width")->Arg(128)->Arg(256)->Arg(512)->Unit(benchmark::kMicrosecond);
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include <gtest/gtest.h>
+#include <cfloat>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "OcclusionBuffer.h"
+#include "BoundingVolume.h"
+#include "MathFunctions.h"
+#include "MeshBVH.h"
+
+// ソフトウェアオクルージョンカリングの深度バッファ
+// 隠れている物は消し、一部でも見えている物・ニア面をまたぐ物は決して消さないことを確かめる
+// 街のシーンでは、消した物の表面の点がカメラから見通せないことを三角形BVHのレイで確かめる
+namespace {
+
+	void AddBox(std::vector<math::Vector3> &positions, std::vector<uint32_t> &indices, const math::AABB &box)
+	{
+		uint32_t base = static_cast<uint32_t>(positions.size());
+		for (uint32_t i = 0; i < 8; ++i) {
+			positions.push_back({ (i & 1) ? box.max.x : box.min.x, (i & 2) ? box.max.y : box.min.y, (i & 4) ? box.max.z : box.min.z });
+		}
+		static const uint32_t kFaces[36] = {
+			0, 1, 3, 0, 3, 2, 4, 6, 7, 4, 7, 5, 0, 4, 5, 0, 5, 1,
+			2, 3, 7, 2, 7, 6, 0, 2, 6, 0, 6, 4, 1, 5, 7, 1, 7, 3,
+		};
+		for (uint32_t index : kFaces) {
+			indices.push_back(base + index);
+		}
+	}
+
+	math::Matrix4x4 MakeIdentity()
+	{
+		return math::MakeScaleMatrix({ 1.0f, 1.0f, 1.0f });
+	}
+
+	math::Matrix4x4 MakeProjection()
+	{
+		return math::MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 1000.0f);
+	}
+
+	void RenderOccluder(OcclusionBuffer &buffer, const std::vector<math::Vector3> &positions, const std::vector<uint32_t> &indices)
+	{
+		buffer.RenderOccluder(&positions[0].x, sizeof(math::Vector3), positions.size(), indices.data(), indices.size(), MakeIdentity());
+	}
+
+	// 原点から+zを見るカメラと、z=10にある10x10の壁
+	class OcclusionBufferWallTest : public ::testing::Test
+	{
+	protected:
+		void SetUp() override
+		{
+			buffer.Initialize(256, 144);
+			viewProjection = MakeProjection();
+			AddBox(positions, indices, { { -5.0f, -5.0f, 10.0f }, { 5.0f, 5.0f, 11.0f } });
+			buffer.BeginFrame(viewProjection);
+			RenderOccluder(buffer, positions, indices);
+			buffer.EndFrame();
+		}
+
+		OcclusionBuffer buffer;
+		math::Matrix4x4 viewProjection;
+		std::vector<math::Vector3> positions;
+		std::vector<uint32_t> indices;
+	};
+
+}
+
+TEST(OcclusionBuffer, InitializeRoundsUpToTiles)
+{
+	OcclusionBuffer buffer;
+	buffer.Initialize(250, 140);
+	EXPECT_EQ(buffer.GetWidth(), 256u);
+	EXPECT_EQ(buffer.GetHeight(), 144u);
+	EXPECT_EQ(buffer.GetDepth(0, 0), FLT_MAX);
+	EXPECT_EQ(buffer.GetDepth(255, 143), FLT_MAX);
+}
+
+TEST(OcclusionBuffer, EmptyBufferOccludesNothing)
+{
+	OcclusionBuffer buffer;
+	buffer.Initialize(256, 144);
+	buffer.BeginFrame(MakeProjection());
+	buffer.EndFrame();
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, 20.0f }, { 1.0f, 1.0f, 22.0f } }));
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, 900.0f }, { 1.0f, 1.0f, 910.0f } }));
+	EXPECT_EQ(buffer.GetStatistics().testedObjects, 2u);
+	EXPECT_EQ(buffer.GetStatistics().occludedObjects, 0u);
+}
+
+TEST_F(OcclusionBufferWallTest, FullyHiddenBoxIsOccluded)
+{
+	EXPECT_TRUE(buffer.IsOccluded({ { -1.0f, -1.0f, 20.0f }, { 1.0f, 1.0f, 22.0f } }));
+	EXPECT_TRUE(buffer.IsOccluded({ { -3.0f, -3.0f, 11.5f }, { 3.0f, 3.0f, 100.0f } }));
+	EXPECT_EQ(buffer.GetStatistics().testedObjects, 2u);
+	EXPECT_EQ(buffer.GetStatistics().occludedObjects, 2u);
+}
+
+TEST_F(OcclusionBufferWallTest, PartiallyVisibleBoxIsNotOccluded)
+{
+	// 壁より手前
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, 5.0f }, { 1.0f, 1.0f, 6.0f } }));
+	// 壁の前面を突き抜ける
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, 9.5f }, { 1.0f, 1.0f, 12.0f } }));
+	// 壁の端からはみ出す
+	EXPECT_FALSE(buffer.IsOccluded({ { 4.0f, -1.0f, 20.0f }, { 12.0f, 1.0f, 22.0f } }));
+	EXPECT_FALSE(buffer.IsOccluded({ { -20.0f, -1.0f, 30.0f }, { -12.0f, 1.0f, 32.0f } }));
+	// 画面外（隠れているとは言えない）
+	EXPECT_FALSE(buffer.IsOccluded({ { 100.0f, -1.0f, 20.0f }, { 101.0f, 1.0f, 22.0f } }));
+	// カメラの後ろ
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, -22.0f }, { 1.0f, 1.0f, -20.0f } }));
+	EXPECT_EQ(buffer.GetStatistics().occludedObjects, 0u);
+}
+
+TEST_F(OcclusionBufferWallTest, BoxCrossingNearPlaneIsNotOccluded)
+{
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, -5.0f }, { 1.0f, 1.0f, 5.0f } }));
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, 0.05f }, { 1.0f, 1.0f, 30.0f } }));
+}
+
+TEST_F(OcclusionBufferWallTest, WallDepthIsNeverNearerThanTrueDepth)
+{
+	// 前面z=10の真の深度より手前の値を書くと、壁のすぐ後ろの物が見えているのに消える
+	float trueDepth = math::ApplyTransform({ 0.0f, 0.0f, 10.0f }, viewProjection).z;
+	float depth = buffer.GetDepth(128, 72);
+	EXPECT_GE(depth, trueDepth - 1e-6f);
+	EXPECT_LT(depth, 1.0f);
+	EXPECT_EQ(buffer.GetDepth(0, 0), FLT_MAX);
+}
+
+TEST(OcclusionBuffer, GroundCrossingNearPlaneIsClipped)
+{
+	// カメラの足元から奥まで続く地面（ニア面で切らないと描けない）
+	OcclusionBuffer buffer;
+	buffer.Initialize(256, 144);
+	math::Matrix4x4 viewProjection = MakeProjection();
+	std::vector<math::Vector3> ground = { { -100.0f, -1.0f, -100.0f }, { 100.0f, -1.0f, -100.0f }, { 100.0f, -1.0f, 100.0f }, { -100.0f, -1.0f, 100.0f } };
+	std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+	buffer.BeginFrame(viewProjection);
+	RenderOccluder(buffer, ground, indices);
+	buffer.EndFrame();
+	EXPECT_EQ(buffer.GetStatistics().occluderTriangles, 2u);
+	EXPECT_GE(buffer.GetStatistics().rasterizedTriangles, 2u);
+
+	// 画面の一番下の行はすべて地面で埋まる
+	for (uint32_t x = 0; x < buffer.GetWidth(); ++x) {
+		EXPECT_LT(buffer.GetDepth(x, buffer.GetHeight() - 1), 1.0f) << "x=" << x;
+	}
+
+	EXPECT_TRUE(buffer.IsOccluded({ { -1.0f, -3.0f, 20.0f }, { 1.0f, -2.0f, 22.0f } }));
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, 0.0f, 20.0f }, { 1.0f, 1.0f, 22.0f } }));
+	// 地面に半分埋まっている
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -2.0f, 20.0f }, { 1.0f, 0.0f, 22.0f } }));
+
+	// 書いた深度は、ピクセルの中心を通るレイと地面の交点の深度より手前にならない
+	math::Matrix4x4 inverse = math::Inverse(viewProjection);
+	float width = static_cast<float>(buffer.GetWidth());
+	float height = static_cast<float>(buffer.GetHeight());
+	int checked = 0;
+	for (uint32_t y = 80; y < buffer.GetHeight(); ++y) {
+		for (uint32_t x = 0; x < buffer.GetWidth(); ++x) {
+			float depth = buffer.GetDepth(x, y);
+			if (depth == FLT_MAX) {
+				continue;
+			}
+			float ndcX = (static_cast<float>(x) + 0.5f) / width * 2.0f - 1.0f;
+			float ndcY = 1.0f - (static_cast<float>(y) + 0.5f) / height * 2.0f;
+			math::Vector3 nearPoint = math::ApplyTransform({ ndcX, ndcY, 0.0f }, inverse);
+			math::Vector3 farPoint = math::ApplyTransform({ ndcX, ndcY, 0.5f }, inverse);
+			float t = (-1.0f - nearPoint.y) / (farPoint.y - nearPoint.y);
+			math::Vector3 hit = { nearPoint.x + (farPoint.x - nearPoint.x) * t, -1.0f, nearPoint.z + (farPoint.z - nearPoint.z) * t };
+			EXPECT_GE(depth, math::ApplyTransform(hit, viewProjection).z - 1e-6f) << "x=" << x << " y=" << y;
+			++checked;
+		}
+	}
+	EXPECT_GT(checked, 1000);
+}
+
+TEST(OcclusionBuffer, BeginFrameClearsPreviousOccluders)
+{
+	OcclusionBuffer buffer;
+	buffer.Initialize(256, 144);
+	std::vector<math::Vector3> positions;
+	std::vector<uint32_t> indices;
+	AddBox(positions, indices, { { -5.0f, -5.0f, 10.0f }, { 5.0f, 5.0f, 11.0f } });
+	buffer.BeginFrame(MakeProjection());
+	RenderOccluder(buffer, positions, indices);
+	buffer.EndFrame();
+	ASSERT_TRUE(buffer.IsOccluded({ { -1.0f, -1.0f, 20.0f }, { 1.0f, 1.0f, 22.0f } }));
+
+	buffer.BeginFrame(MakeProjection());
+	buffer.EndFrame();
+	EXPECT_FALSE(buffer.IsOccluded({ { -1.0f, -1.0f, 20.0f }, { 1.0f, 1.0f, 22.0f } }));
+	EXPECT_EQ(buffer.GetStatistics().occluderTriangles, 0u);
+	EXPECT_EQ(buffer.GetStatistics().testedObjects, 1u);
+}
+
+TEST(OcclusionBuffer, CityNeverRejectsVisibleProps)
+{
+	// 8x8区画の建物と、道路に置いた小物。建物をオクルーダーにして小物を調べる
+	const int blocks = 8;
+	const float pitch = 20.0f;
+	const float footprint = 14.0f;
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> buildingHeight(8.0f, 40.0f);
+	std::vector<math::Vector3> positions;
+	std::vector<uint32_t> indices;
+	for (int i = 0; i < blocks; ++i) {
+		for (int j = 0; j < blocks; ++j) {
+			float x = static_cast<float>(i) * pitch;
+			float z = static_cast<float>(j) * pitch;
+			AddBox(positions, indices, { { x, 0.0f, z }, { x + footprint, buildingHeight(random), z + footprint } });
+		}
+	}
+	MeshBVH bvh;
+	bvh.Build(positions, indices);
+
+	std::uniform_real_distribution<float> place(-5.0f, blocks * pitch);
+	std::uniform_real_distribution<float> size(0.5f, 2.5f);
+	std::vector<math::AABB> props;
+	while (props.size() < 2000) {
+		float x = place(random);
+		float z = place(random);
+		float localX = std::fmod(x + pitch, pitch);
+		float localZ = std::fmod(z + pitch, pitch);
+		if (localX < footprint + 0.5f && localZ < footprint + 0.5f) {
+			continue;
+		}
+		float halfSize = size(random) * 0.5f;
+		props.push_back({ { x - halfSize, 0.01f, z - halfSize }, { x + halfSize, 1.0f + 2.0f * halfSize, z + halfSize } });
+	}
+
+	OcclusionBuffer buffer;
+	buffer.Initialize(256, 144);
+	size_t rejected = 0;
+	size_t tested = 0;
+	for (int direction = 0; direction < 8; ++direction) {
+		math::Vector3 eye = { 3.0f * pitch + 17.0f, 1.7f, 4.0f * pitch + 17.0f };
+		math::Vector3 rotation = { 0.02f, static_cast<float>(direction) * 0.785398f + 0.1f, 0.0f };
+		math::Matrix4x4 view = math::Inverse(math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, rotation, eye));
+		math::Matrix4x4 viewProjection = math::Multiply(view, MakeProjection());
+		math::Frustum frustum = math::MakeFrustum(viewProjection);
+		buffer.BeginFrame(viewProjection);
+		RenderOccluder(buffer, positions, indices);
+		buffer.EndFrame();
+
+		for (const math::AABB &prop : props) {
+			if (!math::IsVisible(frustum, prop)) {
+				continue;
+			}
+			++tested;
+			if (!buffer.IsOccluded(prop)) {
+				continue;
+			}
+			++rejected;
+			// 消した小物の表面の点（各面5x5）が画面内でカメラから見通せてはいけない
+			for (int face = 0; face < 6; ++face) {
+				int axis = face / 2;
+				for (int u = 0; u < 5; ++u) {
+					for (int v = 0; v < 5; ++v) {
+						const float *minimum = &prop.min.x;
+						const float *maximum = &prop.max.x;
+						float point[3];
+						int axisU = (axis + 1) % 3;
+						int axisV = (axis + 2) % 3;
+						point[axis] = (face & 1) ? maximum[axis] : minimum[axis];
+						point[axisU] = minimum[axisU] + (maximum[axisU] - minimum[axisU]) * static_cast<float>(u) / 4.0f;
+						point[axisV] = minimum[axisV] + (maximum[axisV] - minimum[axisV]) * static_cast<float>(v) / 4.0f;
+						math::Vector3 target = { point[0], point[1], point[2] };
+						math::Vector3 viewPoint = math::ApplyTransform(target, view);
+						math::Vector3 ndc = math::ApplyTransform(target, viewProjection);
+						if (viewPoint.z < 0.1f || std::fabs(ndc.x) > 1.0f || std::fabs(ndc.y) > 1.0f) {
+							continue;
+						}
+						math::Ray ray = { eye, { target.x - eye.x, target.y - eye.y, target.z - eye.z } };
+						EXPECT_TRUE(bvh.AnyHit(ray, 0.999f)) << "prop at (" << target.x << ", " << target.y << ", " << target.z << ") is visible but was rejected";
+					}
+				}
+			}
+		}
+	}
+	// 通りに立っているので、ほとんどの小物は建物に隠れる
+	EXPECT_GT(tested, 500u);
+	EXPECT_GT(rejected, tested / 4);
+}
\ No newline at end of file
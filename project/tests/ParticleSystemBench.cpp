@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <vector>
+#include "ParticleSystem.h"
+#include "ThreadPool.h"
+
+// 約100万個のパーティクルの1フレーム（16エミッター x 容量70000、定常状態まで回してから計る）
+// 比較: 1パーティクルを構造体で持ち、std::remove_ifで死んだものを消す素直なAoSの更新
+// SSEとスカラーの比較は engine_bench_scalar（MATH_DISABLE_SIMDでビルドした同じベンチマーク）と見比べる
+// items_per_secondは1秒あたりのパーティクル数
+namespace {
+
+	constexpr uint32_t kEmitterCount = 16;
+	constexpr uint32_t kCapacity = 70000;
+	constexpr float kDeltaTime = 1.0f / 60.0f;
+
+	ParticleSystem::EmitterSettings MakeSettings(uint32_t index)
+	{
+		ParticleSystem::EmitterSettings settings;
+		settings.position = { float(index) * 4.0f, 0.0f, 0.0f };
+		settings.spawnExtent = { 0.5f, 0.5f, 0.5f };
+		settings.rate = 32768.0f;
+		settings.capacity = kCapacity;
+		settings.lifetimeMin = 1.0f;
+		settings.lifetimeMax = 3.0f;
+		settings.drag = 0.5f;
+		settings.startSize = 0.3f;
+		settings.endSize = 0.05f;
+		settings.startColor = { 1.0f, 0.5f, 0.2f, 1.0f };
+		settings.endColor = { 0.2f, 0.2f, 1.0f, 0.0f };
+		return settings;
+	}
+
+	// 容量いっぱい（発生数が寿命で死ぬ数を上回るので、毎フレーム空いた分だけ補充される）まで回す
+	void WarmUp(ParticleSystem &system)
+	{
+		for (uint32_t i = 0; i < kEmitterCount; ++i) {
+			system.AddEmitter(MakeSettings(i));
+		}
+		for (int frame = 0; frame < 240; ++frame) {
+			system.Update(kDeltaTime);
+		}
+	}
+
+	uint32_t GetThreadCount(benchmark::State &state) { return uint32_t(state.range(0)); }
+
+	void BM_ParticleUpdate(benchmark::State &state)
+	{
+		ParticleSystem system;
+		WarmUp(system);
+		ThreadPool threadPool(GetThreadCount(state));
+		ThreadPool *pool = GetThreadCount(state) > 1 ? &threadPool : nullptr;
+		for (auto _ : state) {
+			system.Update(kDeltaTime, pool);
+		}
+		state.SetItemsProcessed(state.iterations() * system.GetAliveCount());
+		state.counters["particles"] = double(system.GetAliveCount());
+		state.counters["died/frame"] = double(system.GetStatistics().diedCount);
+	}
+
+	void BM_ParticleWriteInstances(benchmark::State &state)
+	{
+		ParticleSystem system;
+		WarmUp(system);
+		ThreadPool threadPool(GetThreadCount(state));
+		ThreadPool *pool = GetThreadCount(state) > 1 ? &threadPool : nullptr;
+		std::vector<ParticleSystem::Instance> instances(system.GetAliveCount());
+		for (auto _ : state) {
+			system.WriteInstances(instances.data(), pool);
+			benchmark::DoNotOptimize(instances.data());
+		}
+		state.SetItemsProcessed(state.iterations() * system.GetAliveCount());
+		state.SetBytesProcessed(state.iterations() * system.GetAliveCount() * sizeof(ParticleSystem::Instance));
+	}
+
+	// 比較用: AoSで1つずつ更新し、remove_ifで詰める
+	struct NaiveParticle
+	{
+		float position[3];
+		float velocity[3];
+		float life;
+		float lifetime;
+	};
+
+	void BM_NaiveParticleUpdate(benchmark::State &state)
+	{
+		// 同じ状態から始める
+		ParticleSystem system;
+		WarmUp(system);
+		std::vector<std::vector<NaiveParticle>> emitters(kEmitterCount);
+		{
+			std::vector<ParticleSystem::Instance> instances(system.GetAliveCount());
+			system.WriteInstances(instances.data());
+			uint32_t cursor = 0;
+			for (uint32_t i = 0; i < kEmitterCount; ++i) {
+				emitters[i].reserve(kCapacity);
+				for (uint32_t n = 0; n < kCapacity && cursor < instances.size(); ++n, ++cursor) {
+					const ParticleSystem::Instance &instance = instances[cursor];
+					float lifetime = 1.0f + 2.0f * float(n) / float(kCapacity);
+					emitters[i].push_back({ { instance.position.x, instance.position.y, instance.position.z }, { 0.0f, 3.0f, 0.0f }, lifetime * float(n % 97) / 97.0f + kDeltaTime, lifetime });
+				}
+			}
+		}
+		uint32_t randomState = 0x9E3779B9u;
+		auto random = [&randomState](float minimum, float maximum) {
+			randomState ^= randomState << 13;
+			randomState ^= randomState >> 17;
+			randomState ^= randomState << 5;
+			return minimum + (maximum - minimum) * (float(randomState >> 8) * (1.0f / 16777216.0f));
+			};
+		const float damping = 1.0f - 0.5f * kDeltaTime;
+		const float accelerationY = -9.8f * kDeltaTime;
+		size_t particleCount = 0;
+		for (auto _ : state) {
+			particleCount = 0;
+			for (std::vector<NaiveParticle> &particles : emitters) {
+				for (NaiveParticle &particle : particles) {
+					particle.velocity[0] *= damping;
+					particle.velocity[1] = (particle.velocity[1] + accelerationY) * damping;
+					particle.velocity[2] *= damping;
+					for (int axis = 0; axis < 3; ++axis) {
+						particle.position[axis] += particle.velocity[axis] * kDeltaTime;
+					}
+					particle.life -= kDeltaTime;
+				}
+				particles.erase(std::remove_if(particles.begin(), particles.end(), [](const NaiveParticle &particle) { return particle.life <= 0.0f; }), particles.end());
+				while (particles.size() < kCapacity) {
+					NaiveParticle particle;
+					for (int axis = 0; axis < 3; ++axis) {
+						particle.position[axis] = random(-0.5f, 0.5f);
+					}
+					particle.velocity[0] = random(-1.0f, 1.0f);
+					particle.velocity[1] = random(2.0f, 4.0f);
+					particle.velocity[2] = random(-1.0f, 1.0f);
+					particle.lifetime = particle.life = random(1.0f, 3.0f);
+					particles.push_back(particle);
+				}
+				particleCount += particles.size();
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * particleCount);
+		state.counters["particles"] = double(particleCount);
+	}
+
+}
+
+BENCHMARK(BM_ParticleUpdate)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_ParticleWriteInstances)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(BM_NaiveParticleUpdate)->Unit(benchmark::kMillisecond);
\ No newline at end of file
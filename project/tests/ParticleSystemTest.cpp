@@ -0,0 +1,364 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "ParticleSystem.h"
+#include "ThreadPool.h"
+
+// パーティクルシステム
+// 1パーティクルずつ構造体で持つ素直なスカラーの実装（同じ乱数・同じ式・同じ詰め方）と、書き出したInstanceをバイト単位で比べる
+// engine_tests_scalarではMATH_DISABLE_SIMDでビルドした同じテストが走るので、SSE版とスカラー版はどちらもこの実装と一致する
+namespace {
+
+	// 比べる相手: AoSのスカラー実装
+	class ReferenceParticles
+	{
+	public:
+		void AddEmitter(const ParticleSystem::EmitterSettings &settings)
+		{
+			Emitter emitter;
+			emitter.settings = settings;
+			emitter.randomState = 0x9E3779B9u * uint32_t(emitters.size() + 1);
+			emitters.push_back(emitter);
+		}
+
+		void Burst(uint32_t emitter, uint32_t count) { emitters[emitter].pendingBurst += count; }
+
+		void Update(float deltaTime)
+		{
+			alive = spawned = died = 0;
+			for (Emitter &emitter : emitters) {
+				const ParticleSystem::EmitterSettings &settings = emitter.settings;
+				const float damping = std::max(0.0f, 1.0f - settings.drag * deltaTime);
+				const float accelerationX = settings.acceleration.x * deltaTime;
+				const float accelerationY = settings.acceleration.y * deltaTime;
+				const float accelerationZ = settings.acceleration.z * deltaTime;
+				for (Particle &particle : emitter.particles) {
+					particle.velocityX = (particle.velocityX + accelerationX) * damping;
+					particle.velocityY = (particle.velocityY + accelerationY) * damping;
+					particle.velocityZ = (particle.velocityZ + accelerationZ) * damping;
+					particle.positionX += particle.velocityX * deltaTime;
+					particle.positionY += particle.velocityY * deltaTime;
+					particle.positionZ += particle.velocityZ * deltaTime;
+					particle.life -= deltaTime;
+				}
+
+				// 死んだものは末尾の要素で埋める
+				size_t count = emitter.particles.size();
+				for (size_t i = 0; i < count;) {
+					if (emitter.particles[i].life > 0.0f) {
+						++i;
+						continue;
+					}
+					emitter.particles[i] = emitter.particles[--count];
+				}
+				died += uint32_t(emitter.particles.size() - count);
+				emitter.particles.resize(count);
+
+				emitter.accumulator += settings.rate * deltaTime;
+				uint32_t spawnCount = uint32_t(emitter.accumulator);
+				emitter.accumulator -= float(spawnCount);
+				spawnCount += emitter.pendingBurst;
+				emitter.pendingBurst = 0;
+				spawnCount = std::min<uint32_t>(spawnCount, settings.capacity - uint32_t(emitter.particles.size()));
+				for (uint32_t n = 0; n < spawnCount; ++n) {
+					Particle particle;
+					particle.positionX = settings.position.x + Range(emitter, -settings.spawnExtent.x, settings.spawnExtent.x);
+					particle.positionY = settings.position.y + Range(emitter, -settings.spawnExtent.y, settings.spawnExtent.y);
+					particle.positionZ = settings.position.z + Range(emitter, -settings.spawnExtent.z, settings.spawnExtent.z);
+					particle.velocityX = Range(emitter, settings.velocityMin.x, settings.velocityMax.x);
+					particle.velocityY = Range(emitter, settings.velocityMin.y, settings.velocityMax.y);
+					particle.velocityZ = Range(emitter, settings.velocityMin.z, settings.velocityMax.z);
+					float lifetime = std::max(Range(emitter, settings.lifetimeMin, settings.lifetimeMax), 1e-3f);
+					particle.life = lifetime;
+					particle.inverseLifetime = 1.0f / lifetime;
+					emitter.particles.push_back(particle);
+				}
+				spawned += spawnCount;
+				alive += uint32_t(emitter.particles.size());
+			}
+		}
+
+		std::vector<ParticleSystem::Instance> WriteInstances() const
+		{
+			std::vector<ParticleSystem::Instance> instances;
+			for (const Emitter &emitter : emitters) {
+				const ParticleSystem::EmitterSettings &settings = emitter.settings;
+				const float start[4] = { settings.startColor.x, settings.startColor.y, settings.startColor.z, settings.startColor.w };
+				const float end[4] = { settings.endColor.x, settings.endColor.y, settings.endColor.z, settings.endColor.w };
+				for (const Particle &particle : emitter.particles) {
+					const float t = std::clamp(1.0f - particle.life * particle.inverseLifetime, 0.0f, 1.0f);
+					ParticleSystem::Instance instance {};
+					instance.position = { particle.positionX, particle.positionY, particle.positionZ };
+					instance.size = settings.startSize + (settings.endSize - settings.startSize) * t;
+					for (int channel = 0; channel < 4; ++channel) {
+						const float from = std::clamp(start[channel], 0.0f, 1.0f) * 255.0f;
+						const float to = std::clamp(end[channel], 0.0f, 1.0f) * 255.0f;
+						instance.color |= uint32_t((from + 0.5f) + (to - from) * t) << (channel * 8);
+					}
+					instances.push_back(instance);
+				}
+			}
+			return instances;
+		}
+
+		uint32_t alive = 0;
+		uint32_t spawned = 0;
+		uint32_t died = 0;
+
+	private:
+		struct Particle
+		{
+			float positionX, positionY, positionZ;
+			float velocityX, velocityY, velocityZ;
+			float life;
+			float inverseLifetime;
+		};
+
+		struct Emitter
+		{
+			ParticleSystem::EmitterSettings settings;
+			std::vector<Particle> particles;
+			float accumulator = 0.0f;
+			uint32_t pendingBurst = 0;
+			uint32_t randomState = 1;
+		};
+
+		// xorshift32で[minimum, maximum)
+		static float Range(Emitter &emitter, float minimum, float maximum)
+		{
+			uint32_t &state = emitter.randomState;
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return minimum + (maximum - minimum) * (float(state >> 8) * (1.0f / 16777216.0f));
+		}
+
+		std::vector<Emitter> emitters;
+	};
+
+	// 寿命・抵抗・発生範囲・色がそれぞれ違うエミッター（容量は4の倍数でないものを混ぜる）
+	std::vector<ParticleSystem::EmitterSettings> MakeEmitters(size_t count)
+	{
+		std::vector<ParticleSystem::EmitterSettings> emitters(count);
+		for (size_t i = 0; i < count; ++i) {
+			ParticleSystem::EmitterSettings &settings = emitters[i];
+			float f = float(i);
+			settings.position = { f, 0.5f * f, -f };
+			settings.spawnExtent = { 0.5f, 0.1f * f, 0.25f };
+			settings.rate = 300.0f + 170.0f * f;
+			settings.capacity = 257 + uint32_t(i) * 131;
+			settings.velocityMin = { -1.0f - f, 1.0f, -0.5f };
+			settings.velocityMax = { 1.0f, 3.0f + f, 0.5f };
+			settings.acceleration = { 0.1f * f, -9.8f, 0.0f };
+			settings.drag = 0.3f * float(i % 3);
+			settings.lifetimeMin = 0.2f + 0.1f * f;
+			settings.lifetimeMax = 1.0f + 0.3f * f;
+			settings.startSize = 0.1f + 0.05f * f;
+			settings.endSize = 0.02f * f;
+			settings.startColor = { 1.0f, 0.5f, 0.1f * f, 1.0f };
+			settings.endColor = { 0.0f, 0.25f, 1.0f, 0.0f };
+		}
+		return emitters;
+	}
+
+	std::vector<ParticleSystem::Instance> Write(const ParticleSystem &system, ThreadPool *threadPool = nullptr)
+	{
+		std::vector<ParticleSystem::Instance> instances(system.GetAliveCount());
+		system.WriteInstances(instances.data(), threadPool);
+		return instances;
+	}
+
+	bool SameBytes(const std::vector<ParticleSystem::Instance> &lhs, const std::vector<ParticleSystem::Instance> &rhs)
+	{
+		return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(ParticleSystem::Instance)) == 0;
+	}
+
+	// 1パーティクルだけの、動かないエミッター
+	ParticleSystem::EmitterSettings StillEmitter()
+	{
+		ParticleSystem::EmitterSettings settings;
+		settings.rate = 0.0f;
+		settings.capacity = 16;
+		settings.velocityMin = settings.velocityMax = { 0.0f, 0.0f, 0.0f };
+		settings.acceleration = { 0.0f, 0.0f, 0.0f };
+		settings.lifetimeMin = settings.lifetimeMax = 1.0f;
+		settings.startSize = 2.0f;
+		settings.endSize = 0.0f;
+		settings.startColor = { 1.0f, 0.0f, 1.0f, 1.0f };
+		settings.endColor = { 0.0f, 1.0f, 1.0f, 0.0f };
+		return settings;
+	}
+
+}
+
+TEST(ParticleSystem, InstanceMatchesShaderLayout)
+{
+	EXPECT_EQ(sizeof(ParticleSystem::Instance), 20u);
+}
+
+TEST(ParticleSystem, MatchesScalarReference)
+{
+	ParticleSystem system;
+	ReferenceParticles reference;
+	for (const ParticleSystem::EmitterSettings &settings : MakeEmitters(5)) {
+		system.AddEmitter(settings);
+		reference.AddEmitter(settings);
+	}
+	for (int frame = 0; frame < 180; ++frame) {
+		// 途中で爆発を起こし、容量で打ち切られる分も作る
+		if (frame % 50 == 7) {
+			system.Burst(frame % 5, 400);
+			reference.Burst(frame % 5, 400);
+		}
+		float deltaTime = frame % 3 == 0 ? 1.0f / 30.0f : 1.0f / 60.0f;
+		system.Update(deltaTime);
+		reference.Update(deltaTime);
+		ASSERT_EQ(system.GetAliveCount(), reference.alive) << "frame " << frame;
+		ASSERT_EQ(system.GetStatistics().spawnedCount, reference.spawned) << "frame " << frame;
+		ASSERT_EQ(system.GetStatistics().diedCount, reference.died) << "frame " << frame;
+		ASSERT_TRUE(SameBytes(Write(system), reference.WriteInstances())) << "frame " << frame;
+	}
+	EXPECT_GT(system.GetAliveCount(), 1000u);
+}
+
+TEST(ParticleSystem, ThreadedUpdateMatchesSerial)
+{
+	ThreadPool threadPool(4);
+	ParticleSystem serial;
+	ParticleSystem threaded;
+	for (const ParticleSystem::EmitterSettings &settings : MakeEmitters(16)) {
+		serial.AddEmitter(settings);
+		threaded.AddEmitter(settings);
+	}
+	for (int frame = 0; frame < 120; ++frame) {
+		if (frame == 30) {
+			serial.Burst(3, 1000);
+			threaded.Burst(3, 1000);
+		}
+		serial.Update(1.0f / 60.0f);
+		threaded.Update(1.0f / 60.0f, &threadPool);
+		ASSERT_EQ(serial.GetAliveCount(), threaded.GetAliveCount());
+		std::vector<ParticleSystem::Instance> expected = Write(serial);
+		ASSERT_TRUE(SameBytes(Write(threaded), expected)) << "frame " << frame;
+		ASSERT_TRUE(SameBytes(Write(threaded, &threadPool), expected)) << "frame " << frame;
+	}
+}
+
+TEST(ParticleSystem, RateAccumulatesFractions)
+{
+	ParticleSystem system;
+	ParticleSystem::EmitterSettings settings = StillEmitter();
+	settings.rate = 10.0f;
+	settings.lifetimeMin = settings.lifetimeMax = 100.0f;
+	system.AddEmitter(settings);
+	uint32_t spawned = 0;
+	for (int frame = 0; frame < 60; ++frame) {
+		system.Update(1.0f / 60.0f);
+		spawned += system.GetStatistics().spawnedCount;
+		EXPECT_LE(system.GetStatistics().spawnedCount, 1u);
+	}
+	// 1秒で10個（端数の積み残しで1個ずれることはある）
+	EXPECT_GE(spawned, 9u);
+	EXPECT_LE(spawned, 10u);
+	EXPECT_EQ(system.GetAliveCount(), spawned);
+}
+
+TEST(ParticleSystem, BurstIsCappedByCapacity)
+{
+	ParticleSystem system;
+	uint32_t emitter = system.AddEmitter(StillEmitter());
+	system.Burst(emitter, 10);
+	system.Update(0.0f);
+	EXPECT_EQ(system.GetAliveCount(), 10u);
+	EXPECT_EQ(system.GetStatistics().spawnedCount, 10u);
+	// 容量16なので残り6個しか入らず、入らなかった分は持ち越さない
+	system.Burst(emitter, 100);
+	system.Update(0.0f);
+	EXPECT_EQ(system.GetAliveCount(), 16u);
+	EXPECT_EQ(system.GetStatistics().spawnedCount, 6u);
+	system.Update(0.0f);
+	EXPECT_EQ(system.GetStatistics().spawnedCount, 0u);
+}
+
+TEST(ParticleSystem, DeadParticlesAreRemoved)
+{
+	ParticleSystem system;
+	ParticleSystem::EmitterSettings settings = StillEmitter();
+	settings.capacity = 1003;
+	settings.lifetimeMin = 0.1f;
+	settings.lifetimeMax = 1.0f;
+	uint32_t emitter = system.AddEmitter(settings);
+	system.Burst(emitter, 1003);
+	system.Update(0.0f);
+	ASSERT_EQ(system.GetAliveCount(), 1003u);
+
+	uint32_t died = 0;
+	for (int frame = 0; frame < 12; ++frame) {
+		system.Update(0.1f);
+		died += system.GetStatistics().diedCount;
+		// 残っているものはすべて寿命が残っている（経過の割合が1未満なので、大きさが0より大きい）
+		for (const ParticleSystem::Instance &instance : Write(system)) {
+			ASSERT_GT(instance.size, 0.0f);
+		}
+	}
+	EXPECT_EQ(system.GetAliveCount(), 0u);
+	EXPECT_EQ(died, 1003u);
+}
+
+TEST(ParticleSystem, SizeAndColorFollowLife)
+{
+	ParticleSystem system;
+	uint32_t emitter = system.AddEmitter(StillEmitter());
+	system.Burst(emitter, 1);
+	system.Update(0.0f);
+	std::vector<ParticleSystem::Instance> instances = Write(system);
+	ASSERT_EQ(instances.size(), 1u);
+	EXPECT_FLOAT_EQ(instances[0].size, 2.0f);
+	EXPECT_EQ(instances[0].color, 0xFFFF00FFu);
+
+	// 寿命の半分: 大きさ1、色は各成分の中間（127.5 + 0.5を切り捨てて128）
+	system.Update(0.5f);
+	instances = Write(system);
+	ASSERT_EQ(instances.size(), 1u);
+	EXPECT_FLOAT_EQ(instances[0].size, 1.0f);
+	EXPECT_EQ(instances[0].color, 0x80FF8080u);
+	EXPECT_FLOAT_EQ(instances[0].position.x, 0.0f);
+}
+
+TEST(ParticleSystem, ParticlesMoveUnderAcceleration)
+{
+	ParticleSystem system;
+	ParticleSystem::EmitterSettings settings = StillEmitter();
+	settings.velocityMin = settings.velocityMax = { 2.0f, 0.0f, 0.0f };
+	settings.acceleration = { 0.0f, -10.0f, 0.0f };
+	settings.lifetimeMin = settings.lifetimeMax = 10.0f;
+	uint32_t emitter = system.AddEmitter(settings);
+	system.Burst(emitter, 5);
+	system.Update(0.0f);
+	for (int frame = 0; frame < 4; ++frame) {
+		system.Update(0.25f);
+	}
+	// 半陰的オイラー: x = 2 * 1.0、y = -10 * 0.25^2 * (1+2+3+4)
+	for (const ParticleSystem::Instance &instance : Write(system)) {
+		EXPECT_NEAR(instance.position.x, 2.0f, 1e-5f);
+		EXPECT_NEAR(instance.position.y, -6.25f, 1e-5f);
+	}
+}
+
+TEST(ParticleSystem, ClearRemovesEverything)
+{
+	ParticleSystem system;
+	ParticleSystem::EmitterSettings settings = StillEmitter();
+	settings.rate = 1000.0f;
+	uint32_t emitter = system.AddEmitter(settings);
+	system.Update(0.1f);
+	system.Burst(emitter, 5);
+	ASSERT_GT(system.GetAliveCount(), 0u);
+	system.Clear();
+	EXPECT_EQ(system.GetAliveCount(), 0u);
+	// 保留していた爆発も消える
+	system.GetEmitterSettings(emitter).rate = 0.0f;
+	system.Update(0.1f);
+	EXPECT_EQ(system.GetAliveCount(), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,194 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "RenderQueue.h"
+
+// ソートキーの作り方、基数ソートの順番（安定ソートと比較）、Executeでのパスの設定とステートの省略
+namespace {
+
+	// テスト用の描画対象（描いた順と、セットが必要だったステートを記録する）
+	struct FakeDrawable
+	{
+		uint32_t id;
+		uintptr_t pipeline;
+		uint32_t texture;
+		uintptr_t mesh;
+	};
+
+	std::vector<uint32_t> drawnIds;
+
+	void DrawFake(const void *object, RenderStateCache &stateCache)
+	{
+		const FakeDrawable *drawable = static_cast<const FakeDrawable *>(object);
+		stateCache.SetPipeline(drawable->pipeline);
+		stateCache.SetTexture(drawable->texture);
+		stateCache.SetMesh(drawable->mesh);
+		drawnIds.push_back(drawable->id);
+	}
+
+	void DrawNothing(const void *, RenderStateCache &) {}
+}
+
+TEST(RenderStateCache, SkipsRepeatedStates)
+{
+	RenderStateCache cache;
+	EXPECT_TRUE(cache.SetPipeline(1));
+	EXPECT_FALSE(cache.SetPipeline(1));
+	EXPECT_TRUE(cache.SetTexture(3));
+	EXPECT_TRUE(cache.SetPipeline(2));
+	EXPECT_FALSE(cache.SetTexture(3));
+	EXPECT_EQ(cache.GetIssuedCount(), 3u);
+	EXPECT_EQ(cache.GetAvoidedCount(), 2u);
+
+	// Resetの後は必ずセットし直す
+	cache.Reset();
+	EXPECT_TRUE(cache.SetPipeline(2));
+	EXPECT_TRUE(cache.SetTexture(3));
+	EXPECT_TRUE(cache.SetMesh(0));
+
+	cache.ResetCounters();
+	EXPECT_EQ(cache.GetIssuedCount(), 0u);
+	EXPECT_EQ(cache.GetAvoidedCount(), 0u);
+}
+
+TEST(RenderQueue, SortKeyFieldsArePackedFromTheTop)
+{
+	uint64_t key = RenderQueue::MakeSortKey(RenderPass::kSprite, 0xA, 0x1234, 0x5678, 0x9ABCDE);
+	EXPECT_EQ(key, 0x2A123456789ABCDEull);
+	EXPECT_EQ(RenderQueue::GetPass(key), RenderPass::kSprite);
+
+	// ビット数に収まらない分は切り捨てる
+	uint64_t truncated = RenderQueue::MakeSortKey(RenderPass::kObject3d, 0x1F, 0x1FFFF, 0x1FFFF, 0x1FFFFFF);
+	EXPECT_EQ(truncated, 0x0FFFFFFFFFFFFFFFull);
+	EXPECT_EQ(RenderQueue::GetPass(truncated), RenderPass::kObject3d);
+}
+
+TEST(RenderQueue, SortKeyOrdersPassThenPipelineThenTextureThenMeshThenDepth)
+{
+	auto key = [](RenderPass pass, uint32_t pipeline, uint32_t texture, uint32_t mesh, uint32_t depth) {
+		return RenderQueue::MakeSortKey(pass, pipeline, texture, mesh, depth);
+		};
+	EXPECT_LT(key(RenderPass::kObject3d, 15, 65535, 65535, 0xFFFFFF), key(RenderPass::kParticle, 0, 0, 0, 0));
+	EXPECT_LT(key(RenderPass::kParticle, 15, 0, 0, 0), key(RenderPass::kSprite, 0, 0, 0, 0));
+	EXPECT_LT(key(RenderPass::kObject3d, 0, 65535, 65535, 0xFFFFFF), key(RenderPass::kObject3d, 1, 0, 0, 0));
+	EXPECT_LT(key(RenderPass::kObject3d, 0, 0, 65535, 0xFFFFFF), key(RenderPass::kObject3d, 0, 1, 0, 0));
+	EXPECT_LT(key(RenderPass::kObject3d, 0, 0, 0, 0xFFFFFF), key(RenderPass::kObject3d, 0, 0, 1, 0));
+	EXPECT_LT(key(RenderPass::kObject3d, 0, 0, 0, 0), key(RenderPass::kObject3d, 0, 0, 0, 1));
+}
+
+TEST(RenderQueue, QuantizeDepthClampsAndKeepsOrder)
+{
+	EXPECT_EQ(RenderQueue::QuantizeDepth(-1.0f), 0u);
+	EXPECT_EQ(RenderQueue::QuantizeDepth(0.0f), 0u);
+	EXPECT_EQ(RenderQueue::QuantizeDepth(1.0f), (1u << RenderQueue::kDepthBits) - 1);
+	EXPECT_EQ(RenderQueue::QuantizeDepth(2.0f), (1u << RenderQueue::kDepthBits) - 1);
+	EXPECT_LT(RenderQueue::QuantizeDepth(0.25f), RenderQueue::QuantizeDepth(0.5f));
+}
+
+TEST(RenderQueue, SortMatchesStableSort)
+{
+	std::mt19937_64 random(3);
+	for (size_t count : { size_t(0), size_t(1), size_t(2), size_t(1000), size_t(20000) }) {
+		std::vector<uint64_t> keys(count);
+		for (uint64_t &key : keys) {
+			// 重複するキーも混ぜる（安定性の確認）
+			key = (random() % 4 == 0) ? random() % 8 : random();
+		}
+
+		RenderQueue queue;
+		for (const uint64_t &key : keys) {
+			queue.Submit(key, DrawNothing, &key);
+		}
+		queue.Sort();
+
+		std::vector<size_t> order(count);
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return keys[a] < keys[b]; });
+		ASSERT_EQ(queue.GetPacketCount(), count);
+		for (size_t i = 0; i < count; ++i) {
+			ASSERT_EQ(queue.GetSortedPacket(i).object, &keys[order[i]]) << "count " << count << " position " << i;
+		}
+	}
+}
+
+TEST(RenderQueue, SortKeepsSubmissionOrderForEqualKeys)
+{
+	RenderQueue queue;
+	int objects[4] = {};
+	uint64_t key = RenderQueue::MakeSortKey(RenderPass::kSprite, 1, 2, 3, 4);
+	for (int &object : objects) {
+		queue.Submit(key, DrawNothing, &object);
+	}
+	queue.Sort();
+	for (size_t i = 0; i < 4; ++i) {
+		EXPECT_EQ(queue.GetSortedPacket(i).object, &objects[i]);
+	}
+}
+
+TEST(RenderQueue, ExecuteDrawsInKeyOrderAndFiltersStates)
+{
+	// 2つのパスに、パイプライン・テクスチャ・メッシュがばらばらの順で積む
+	std::vector<FakeDrawable> drawables = {
+		{ 0, 1, 7, 100 },
+		{ 1, 0, 7, 100 },
+		{ 2, 1, 7, 100 },
+		{ 3, 0, 5, 101 },
+		{ 4, 0, 7, 100 },
+	};
+	std::vector<RenderPass> passes = { RenderPass::kSprite, RenderPass::kObject3d, RenderPass::kObject3d, RenderPass::kObject3d, RenderPass::kObject3d };
+
+	RenderQueue queue;
+	std::vector<RenderPass> setupCalls;
+	for (RenderPass pass : { RenderPass::kObject3d, RenderPass::kSprite }) {
+		queue.SetPassSetup(pass, [&setupCalls, pass](RenderStateCache &) { setupCalls.push_back(pass); });
+	}
+	for (size_t i = 0; i < drawables.size(); ++i) {
+		const FakeDrawable &drawable = drawables[i];
+		uint64_t key = RenderQueue::MakeSortKey(passes[i], uint32_t(drawable.pipeline), drawable.texture, uint32_t(drawable.mesh), 0);
+		queue.Submit(key, DrawFake, &drawable);
+	}
+
+	drawnIds.clear();
+	queue.Execute();
+
+	// Object3d: (p0,t5,m101) (p0,t7,m100)x2 (p1,t7,m100)、Sprite: (p1,t7,m100)
+	EXPECT_EQ(drawnIds, (std::vector<uint32_t> { 3, 1, 4, 2, 0 }));
+	EXPECT_EQ(setupCalls, (std::vector<RenderPass> { RenderPass::kObject3d, RenderPass::kSprite }));
+
+	const RenderQueue::Statistics &statistics = queue.GetStatistics();
+	EXPECT_EQ(statistics.packetCount, 5u);
+	EXPECT_EQ(statistics.passChangeCount, 2u);
+	// Object3d: 3 + 2 + 0 + 1、Sprite: パスでリセットされるので3
+	EXPECT_EQ(statistics.stateChangesIssued, 9u);
+	EXPECT_EQ(statistics.stateChangesAvoided, 15u - 9u);
+
+	// Executeの後は空になる
+	EXPECT_EQ(queue.GetPacketCount(), 0u);
+}
+
+TEST(RenderQueue, PassSetupStatesCountAsBound)
+{
+	// パスの共通設定でセットしたパイプラインは、パケットでセットし直さない
+	RenderQueue queue;
+	queue.SetPassSetup(RenderPass::kObject3d, [](RenderStateCache &stateCache) { stateCache.SetPipeline(3); });
+	FakeDrawable drawable { 0, 3, 1, 1 };
+	queue.Submit(RenderQueue::MakeSortKey(RenderPass::kObject3d, 3, 1, 1, 0), DrawFake, &drawable);
+	drawnIds.clear();
+	queue.Execute();
+	EXPECT_EQ(queue.GetStatistics().stateChangesAvoided, 1u);
+	EXPECT_EQ(queue.GetStatistics().stateChangesIssued, 3u);
+}
+
+TEST(RenderQueue, ClearDiscardsPackets)
+{
+	RenderQueue queue;
+	FakeDrawable drawable {};
+	queue.Submit(0, DrawFake, &drawable);
+	queue.Clear();
+	drawnIds.clear();
+	queue.Execute();
+	EXPECT_TRUE(drawnIds.empty());
+	EXPECT_EQ(queue.GetStatistics().packetCount, 0u);
+}
\ No newline at end of file
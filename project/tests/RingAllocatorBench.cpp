@@ -0,0 +1,43 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "RingAllocator.h"
+
+// アップロード用リングの割り当て: 1フレームで定数バッファ（256byteアライメント）をobjects個取り、
+// GPUが2フレーム遅れて追いかける（DirectXCommon::AllocateUploadと同じ使い方）
+namespace {
+
+	constexpr size_t kUploadRingSize = 4 * 1024 * 1024;
+	constexpr uint64_t kFramesInFlight = 2;
+
+	void BM_RingAllocatorFrame(benchmark::State &state)
+	{
+		size_t objects = static_cast<size_t>(state.range(0));
+
+		// 定数バッファの大きさ（TransformationMatrix・Material・DirectionalLightなど）
+		std::mt19937 random(1);
+		std::vector<size_t> sizes(objects);
+		for (size_t &size : sizes) {
+			size = 16 * (1 + random() % 12);
+		}
+
+		RingAllocator ring(kUploadRingSize);
+		uint64_t fenceValue = 0;
+		size_t failures = 0;
+		for (auto _ : state) {
+			for (size_t size : sizes) {
+				size_t offset = ring.Allocate(size, 256);
+				failures += offset == RingAllocator::kInvalidOffset;
+				benchmark::DoNotOptimize(offset);
+			}
+			ring.FinishFrame(++fenceValue);
+			if (fenceValue > kFramesInFlight) {
+				ring.Retire(fenceValue - kFramesInFlight);
+			}
+		}
+		state.SetItemsProcessed(state.iterations() * objects);
+		state.counters["failures"] = static_cast<double>(failures);
+	}
+}
+
+BENCHMARK(BM_RingAllocatorFrame)->ArgName("objects")->Arg(100)->Arg(1000)->Arg(4000);
\ No newline at end of file
@@ -0,0 +1,211 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "RingAllocator.h"
+
+// リングアロケータのオフセット管理（折り返し・フェンスでの解放・アライメント）
+namespace {
+
+	constexpr size_t kInvalid = RingAllocator::kInvalidOffset;
+}
+
+TEST(RingAllocator, AllocatesFromTheStartWithAlignment)
+{
+	RingAllocator ring(1024);
+	EXPECT_EQ(ring.Allocate(100, 256), 0u);
+	EXPECT_EQ(ring.Allocate(10, 256), 256u);
+	EXPECT_EQ(ring.Allocate(1, 1), 266u);
+	EXPECT_EQ(ring.Allocate(4, 4), 268u);
+	// アライメントで飛ばした分も使用中に数える
+	EXPECT_EQ(ring.GetUsedSize(), 272u);
+}
+
+TEST(RingAllocator, RejectsZeroAndOversizedRequests)
+{
+	RingAllocator ring(1024);
+	EXPECT_EQ(ring.Allocate(0, 16), kInvalid);
+	EXPECT_EQ(ring.Allocate(1025, 16), kInvalid);
+	EXPECT_EQ(ring.Allocate(1024, 16), 0u);
+	EXPECT_EQ(ring.GetUsedSize(), 1024u);
+}
+
+TEST(RingAllocator, FullUntilFenceCompletes)
+{
+	RingAllocator ring(1024);
+	for (size_t i = 0; i < 4; ++i) {
+		EXPECT_EQ(ring.Allocate(256, 256), i * 256);
+	}
+	EXPECT_EQ(ring.Allocate(1, 1), kInvalid);
+	ring.FinishFrame(5);
+	EXPECT_EQ(ring.GetPendingFrameCount(), 1u);
+
+	// フェンスが届くまでは解放されない
+	ring.Retire(4);
+	EXPECT_EQ(ring.GetPendingFrameCount(), 1u);
+	EXPECT_EQ(ring.Allocate(1, 1), kInvalid);
+
+	ring.Retire(5);
+	EXPECT_EQ(ring.GetPendingFrameCount(), 0u);
+	EXPECT_EQ(ring.GetUsedSize(), 0u);
+	EXPECT_EQ(ring.Allocate(1024, 256), 0u);
+}
+
+TEST(RingAllocator, RetiresFramesInFenceOrder)
+{
+	RingAllocator ring(1024);
+	ring.Allocate(100, 1);
+	ring.FinishFrame(1);
+	ring.Allocate(200, 1);
+	ring.FinishFrame(2);
+	ring.Allocate(300, 1);
+	ring.FinishFrame(3);
+	EXPECT_EQ(ring.GetUsedSize(), 600u);
+
+	ring.Retire(2);
+	EXPECT_EQ(ring.GetPendingFrameCount(), 1u);
+	EXPECT_EQ(ring.GetUsedSize(), 300u);
+	ring.Retire(3);
+	EXPECT_EQ(ring.GetUsedSize(), 0u);
+}
+
+TEST(RingAllocator, EmptyFrameIsNotRecorded)
+{
+	RingAllocator ring(1024);
+	ring.FinishFrame(1);
+	EXPECT_EQ(ring.GetPendingFrameCount(), 0u);
+}
+
+TEST(RingAllocator, WrapsAroundWhenTheEndDoesNotFit)
+{
+	RingAllocator ring(1024);
+	EXPECT_EQ(ring.Allocate(400, 1), 0u);
+	ring.FinishFrame(1);
+	EXPECT_EQ(ring.Allocate(400, 1), 400u);
+	ring.FinishFrame(2);
+	ring.Retire(1);
+
+	// 末尾の224byteには収まらないので、空いた先頭に戻る
+	EXPECT_EQ(ring.Allocate(300, 1), 0u);
+	// 飛ばした末尾も使用中に数える
+	EXPECT_EQ(ring.GetUsedSize(), 400u + 224u + 300u);
+
+	// 先頭側の空き [300, 400) を超える割り当ては、フレーム2が終わるまで入らない
+	EXPECT_EQ(ring.Allocate(101, 1), kInvalid);
+	EXPECT_EQ(ring.Allocate(100, 1), 300u);
+	ring.FinishFrame(3);
+
+	// フレーム3は飛ばした末尾と先頭の400byteを持っているので、空くのはフレーム2の分だけ
+	ring.Retire(2);
+	EXPECT_EQ(ring.GetUsedSize(), 224u + 400u);
+	EXPECT_EQ(ring.Allocate(401, 1), kInvalid);
+	EXPECT_EQ(ring.Allocate(400, 1), 400u);
+
+	// フレーム3が終われば、飛ばした末尾もまとめて空く
+	ring.FinishFrame(4);
+	ring.Retire(3);
+	EXPECT_EQ(ring.GetUsedSize(), 400u);
+	EXPECT_EQ(ring.Allocate(224, 1), 800u);
+}
+
+TEST(RingAllocator, WrapRequiresSpaceBeforeTail)
+{
+	RingAllocator ring(1024);
+	ring.Allocate(200, 1);
+	ring.FinishFrame(1);
+	ring.Allocate(700, 1);
+	ring.FinishFrame(2);
+	ring.Retire(1);
+
+	// 末尾は124byte、先頭は200byte空いている
+	EXPECT_EQ(ring.Allocate(201, 1), kInvalid);
+	EXPECT_EQ(ring.Allocate(200, 1), 0u);
+}
+
+TEST(RingAllocator, RestartsFromTheStartWhenEmpty)
+{
+	RingAllocator ring(1024);
+	ring.Allocate(1000, 1);
+	ring.FinishFrame(1);
+	ring.Retire(1);
+	// 空になったら先頭から割り当て直す（末尾の24byteで折り返さない）
+	EXPECT_EQ(ring.Allocate(1024, 1), 0u);
+}
+
+TEST(RingAllocator, ResetDiscardsPendingFrames)
+{
+	RingAllocator ring(256);
+	ring.Allocate(128, 1);
+	ring.FinishFrame(1);
+	ring.Reset(512);
+	EXPECT_EQ(ring.GetCapacity(), 512u);
+	EXPECT_EQ(ring.GetPendingFrameCount(), 0u);
+	EXPECT_EQ(ring.GetUsedSize(), 0u);
+	EXPECT_EQ(ring.Allocate(512, 1), 0u);
+}
+
+TEST(RingAllocator, RandomFramesNeverOverlapLiveAllocations)
+{
+	// GPUが数フレーム遅れて追いかける状況で、使用中の領域と重ならないこと
+	struct Live
+	{
+		size_t offset;
+		size_t size;
+		uint64_t fenceValue;
+	};
+
+	std::mt19937 random(42);
+	for (size_t capacity : { size_t(1000), size_t(4096), size_t(65536) }) {
+		RingAllocator ring(capacity);
+		std::vector<Live> live;
+		uint64_t fenceValue = 1;
+		uint64_t completed = 0;
+		size_t allocations = 0;
+		size_t wraps = 0;
+		size_t lastOffset = 0;
+
+		for (int step = 0; step < 50000; ++step) {
+			uint32_t operation = random() % 10;
+			if (operation < 7) {
+				size_t size = 1 + random() % 300;
+				size_t alignment = size_t(1) << (random() % 9);
+				size_t offset = ring.Allocate(size, alignment);
+				if (offset == kInvalid) {
+					continue;
+				}
+				ASSERT_EQ(offset % alignment, 0u);
+				ASSERT_LE(offset + size, capacity);
+				for (const Live &other : live) {
+					ASSERT_TRUE(offset + size <= other.offset || other.offset + other.size <= offset)
+						<< "[" << offset << ", " << offset + size << ") overlaps [" << other.offset << ", " << other.offset + other.size << ")";
+				}
+				if (offset < lastOffset) {
+					++wraps;
+				}
+				lastOffset = offset;
+				live.push_back({ offset, size, fenceValue });
+				++allocations;
+			} else if (operation < 9) {
+				ring.FinishFrame(fenceValue);
+				++fenceValue;
+			} else {
+				uint64_t lag = random() % 4;
+				uint64_t target = fenceValue - 1 > lag ? fenceValue - 1 - lag : 0;
+				if (target > completed) {
+					completed = target;
+					ring.Retire(completed);
+					std::erase_if(live, [&](const Live &allocation) { return allocation.fenceValue <= completed; });
+				}
+			}
+
+			size_t liveSize = 0;
+			for (const Live &allocation : live) {
+				liveSize += allocation.size;
+			}
+			ASSERT_GE(ring.GetUsedSize(), liveSize);
+			ASSERT_LE(ring.GetUsedSize(), capacity);
+		}
+		EXPECT_GT(allocations, 0u);
+		EXPECT_GT(wraps, 0u) << "capacity " << capacity;
+	}
+}
\ No newline at end of file
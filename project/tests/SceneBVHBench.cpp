@@ -0,0 +1,198 @@
+#include <benchmark/benchmark.h>
+#include <cfloat>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+#include "SceneBVH.h"
+#include "MathFunctions.h"
+
+// SceneBVHの問い合わせと、全オブジェクトを調べる場合の比較（1000～1000000オブジェクト）
+// オブジェクトの密度が同じになるよう、数に合わせて広さを変える
+namespace {
+
+	struct Scene
+	{
+		std::vector<math::AABB> boxes;
+		std::vector<SceneBVH::ProxyId> proxies;
+		SceneBVH bvh;
+		math::Frustum frustum;
+		std::vector<math::Ray> rays;
+	};
+
+	// 数ごとに1回だけ作る（100万個の木を作るのに数秒かかるので）
+	const Scene &GetScene(size_t count)
+	{
+		static std::map<size_t, std::unique_ptr<Scene>> scenes;
+		std::unique_ptr<Scene> &scene = scenes[count];
+		if (scene) {
+			return *scene;
+		}
+		scene = std::make_unique<Scene>();
+
+		std::mt19937 random(3);
+		auto uniform = [&](float minimum, float maximum) { return std::uniform_real_distribution<float>(minimum, maximum)(random); };
+		float world = std::sqrt(static_cast<float>(count)) * 6.0f;
+		scene->boxes.resize(count);
+		scene->proxies.resize(count);
+		for (size_t i = 0; i < count; ++i) {
+			math::Vector3 center = { uniform(-world, world), uniform(-world * 0.2f, world * 0.2f), uniform(-world, world) };
+			float size = uniform(0.2f, 2.0f);
+			scene->boxes[i] = { { center.x - size, center.y - size, center.z - size }, { center.x + size, center.y + size, center.z + size } };
+			scene->proxies[i] = scene->bvh.CreateProxy(scene->boxes[i], nullptr);
+		}
+		scene->bvh.Rebuild();
+
+		math::Matrix4x4 view = math::Inverse(math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, 0.5f, 0.0f }, { 0.0f, 20.0f, -world }));
+		scene->frustum = math::MakeFrustum(math::Multiply(view, math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, world * 0.5f)));
+
+		scene->rays.resize(256);
+		for (math::Ray &ray : scene->rays) {
+			ray.origin = { uniform(-world, world), uniform(-5.0f, 5.0f), uniform(-world, world) };
+			ray.direction = math::Normalize({ uniform(-1.0f, 1.0f), uniform(-0.3f, 0.3f), uniform(-1.0f, 1.0f) });
+		}
+		return *scene;
+	}
+
+	// ===== 視錐台 =====
+
+	void BM_FrustumBVH(benchmark::State &state)
+	{
+		const Scene &scene = GetScene(static_cast<size_t>(state.range(0)));
+		std::vector<SceneBVH::ProxyId> results;
+		for (auto _ : state) {
+			scene.bvh.QueryFrustum(scene.frustum, results);
+			benchmark::DoNotOptimize(results.data());
+		}
+		state.counters["visible"] = static_cast<double>(results.size());
+	}
+
+	void BM_FrustumBruteForce(benchmark::State &state)
+	{
+		const Scene &scene = GetScene(static_cast<size_t>(state.range(0)));
+		std::vector<size_t> results;
+		for (auto _ : state) {
+			results.clear();
+			for (size_t i = 0; i < scene.boxes.size(); ++i) {
+				if (math::IsVisible(scene.frustum, scene.boxes[i])) {
+					results.push_back(i);
+				}
+			}
+			benchmark::DoNotOptimize(results.data());
+		}
+		state.counters["visible"] = static_cast<double>(results.size());
+	}
+
+	// ===== レイ（最も近い当たり） =====
+
+	void BM_RayCastBVH(benchmark::State &state)
+	{
+		const Scene &scene = GetScene(static_cast<size_t>(state.range(0)));
+		size_t rayIndex = 0;
+		for (auto _ : state) {
+			SceneBVH::RayHit hit;
+			benchmark::DoNotOptimize(scene.bvh.RayCast(scene.rays[rayIndex], 1e9f, hit));
+			rayIndex = (rayIndex + 1) % scene.rays.size();
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	void BM_RayCastBruteForce(benchmark::State &state)
+	{
+		const Scene &scene = GetScene(static_cast<size_t>(state.range(0)));
+		size_t rayIndex = 0;
+		for (auto _ : state) {
+			const math::Ray &ray = scene.rays[rayIndex];
+			math::Vector3 inverseDirection = math::MakeInverseDirection(ray.direction);
+			float closest = 1e9f;
+			for (const math::AABB &box : scene.boxes) {
+				float distance = 0.0f;
+				if (math::IntersectRay(ray, inverseDirection, box, closest, distance)) {
+					closest = distance;
+				}
+			}
+			benchmark::DoNotOptimize(closest);
+			rayIndex = (rayIndex + 1) % scene.rays.size();
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// ===== AABBとの重なり =====
+
+	const math::AABB kOverlapQuery = { { -10.0f, -10.0f, -10.0f }, { 10.0f, 10.0f, 10.0f } };
+
+	void BM_OverlapBVH(benchmark::State &state)
+	{
+		const Scene &scene = GetScene(static_cast<size_t>(state.range(0)));
+		std::vector<SceneBVH::ProxyId> results;
+		for (auto _ : state) {
+			scene.bvh.QueryOverlap(kOverlapQuery, results);
+			benchmark::DoNotOptimize(results.data());
+		}
+	}
+
+	void BM_OverlapBruteForce(benchmark::State &state)
+	{
+		const Scene &scene = GetScene(static_cast<size_t>(state.range(0)));
+		std::vector<size_t> results;
+		for (auto _ : state) {
+			results.clear();
+			for (size_t i = 0; i < scene.boxes.size(); ++i) {
+				if (math::Overlaps(kOverlapQuery, scene.boxes[i])) {
+					results.push_back(i);
+				}
+			}
+			benchmark::DoNotOptimize(results.data());
+		}
+	}
+
+	// ===== 木の更新 =====
+
+	// 1割のオブジェクトを動かして付け直す
+	void BM_Refit10Percent(benchmark::State &state)
+	{
+		size_t count = static_cast<size_t>(state.range(0));
+		const Scene &scene = GetScene(count);
+		SceneBVH bvh;
+		for (const math::AABB &box : scene.boxes) {
+			bvh.CreateProxy(box, nullptr);
+		}
+		bvh.Rebuild();
+
+		float offset = 0.0f;
+		for (auto _ : state) {
+			offset = offset > 0.0f ? -0.1f : 0.1f;
+			for (size_t i = 0; i < count; i += 10) {
+				math::AABB box = scene.boxes[i];
+				box.min.x += offset;
+				box.max.x += offset;
+				bvh.MoveProxy(scene.proxies[i], box);
+			}
+			bvh.Refit();
+		}
+	}
+
+	void BM_Rebuild(benchmark::State &state)
+	{
+		size_t count = static_cast<size_t>(state.range(0));
+		const Scene &scene = GetScene(count);
+		SceneBVH bvh;
+		for (const math::AABB &box : scene.boxes) {
+			bvh.CreateProxy(box, nullptr);
+		}
+		for (auto _ : state) {
+			bvh.Rebuild();
+		}
+		state.counters["height"] = static_cast<double>(bvh.ComputeHeight());
+	}
+}
+
+BENCHMARK(BM_FrustumBVH)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FrustumBruteForce)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RayCastBVH)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_RayCastBruteForce)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OverlapBVH)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OverlapBruteForce)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Refit10Percent)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Rebuild)->ArgName("objects")->RangeMultiplier(10)->Range(1000, 1000000)->Unit(benchmark::kMillisecond);
\ No newline at end of file
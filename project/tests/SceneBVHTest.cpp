@@ -0,0 +1,367 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "SceneBVH.h"
+#include "MathFunctions.h"
+
+// 登録・削除・移動・付け直し・作り直しをしても、問い合わせの結果が全オブジェクトを調べた場合と一致すること
+namespace {
+
+	// 登録したオブジェクトを木と別に持っておき、全部調べた結果と比べる
+	class SceneBVHTest : public ::testing::Test
+	{
+	protected:
+
+		static constexpr float kWorld = 200.0f;
+
+		math::AABB RandomBox()
+		{
+			math::Vector3 center = { Uniform(-kWorld, kWorld), Uniform(-kWorld * 0.2f, kWorld * 0.2f), Uniform(-kWorld, kWorld) };
+			float size = Uniform(0.2f, 2.0f);
+			return { { center.x - size, center.y - size, center.z - size }, { center.x + size, center.y + size, center.z + size } };
+		}
+
+		math::Ray RandomRay()
+		{
+			math::Vector3 origin = { Uniform(-kWorld, kWorld), Uniform(-5.0f, 5.0f), Uniform(-kWorld, kWorld) };
+			math::Vector3 direction = math::Normalize({ Uniform(-1.0f, 1.0f), Uniform(-0.3f, 0.3f), Uniform(-1.0f, 1.0f) });
+			return { origin, direction };
+		}
+
+		float Uniform(float minimum, float maximum)
+		{
+			return std::uniform_real_distribution<float>(minimum, maximum)(random);
+		}
+
+		// オブジェクトを追加する（userDataにはオブジェクトの番号を入れる）
+		void Add(const math::AABB &aabb)
+		{
+			size_t object = boxes.size();
+			boxes.push_back(aabb);
+			alive.push_back(true);
+			proxies.push_back(bvh.CreateProxy(aabb, reinterpret_cast<void *>(object)));
+		}
+
+		void AddRandom(size_t count)
+		{
+			for (size_t i = 0; i < count; ++i) {
+				Add(RandomBox());
+			}
+		}
+
+		// 問い合わせの結果をオブジェクトの番号にして並べる
+		std::vector<size_t> ToObjects(const std::vector<SceneBVH::ProxyId> &results) const
+		{
+			std::vector<size_t> objects;
+			for (SceneBVH::ProxyId proxy : results) {
+				objects.push_back(reinterpret_cast<size_t>(bvh.GetUserData(proxy)));
+			}
+			std::sort(objects.begin(), objects.end());
+			return objects;
+		}
+
+		void ExpectFrustumMatchesBruteForce(const math::Frustum &frustum)
+		{
+			std::vector<SceneBVH::ProxyId> results;
+			bvh.QueryFrustum(frustum, results);
+			std::vector<size_t> expected;
+			for (size_t i = 0; i < boxes.size(); ++i) {
+				if (alive[i] && math::IsVisible(frustum, boxes[i])) {
+					expected.push_back(i);
+				}
+			}
+			EXPECT_EQ(ToObjects(results), expected);
+		}
+
+		void ExpectOverlapMatchesBruteForce(const math::AABB &query)
+		{
+			std::vector<SceneBVH::ProxyId> results;
+			bvh.QueryOverlap(query, results);
+			std::vector<size_t> expected;
+			for (size_t i = 0; i < boxes.size(); ++i) {
+				if (alive[i] && math::Overlaps(query, boxes[i])) {
+					expected.push_back(i);
+				}
+			}
+			EXPECT_EQ(ToObjects(results), expected);
+		}
+
+		void ExpectRayCastMatchesBruteForce(const math::Ray &ray, const SceneBVH::RayTest &rayTest = nullptr)
+		{
+			const float maxDistance = 1000.0f;
+			math::Vector3 inverseDirection = math::MakeInverseDirection(ray.direction);
+			float closest = FLT_MAX;
+			bool expectedHit = false;
+			for (size_t i = 0; i < boxes.size(); ++i) {
+				if (!alive[i]) {
+					continue;
+				}
+				float distance = 0.0f;
+				bool hit = rayTest ? rayTest(proxies[i], ray, maxDistance, distance)
+					: math::IntersectRay(ray, inverseDirection, boxes[i], maxDistance, distance);
+				if (hit && distance < closest) {
+					closest = distance;
+					expectedHit = true;
+				}
+			}
+
+			SceneBVH::RayHit hit;
+			ASSERT_EQ(bvh.RayCast(ray, maxDistance, hit, rayTest), expectedHit);
+			if (expectedHit) {
+				EXPECT_NEAR(hit.distance, closest, 1e-4f);
+				EXPECT_TRUE(alive[reinterpret_cast<size_t>(bvh.GetUserData(hit.proxy))]);
+			}
+		}
+
+		math::Frustum MakeCameraFrustum() const
+		{
+			math::Matrix4x4 view = math::Inverse(math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.2f, 0.7f, 0.0f }, { 0.0f, 10.0f, -150.0f }));
+			return math::MakeFrustum(math::Multiply(view, math::MakePerspectiveFovMatrix(0.8f, 16.0f / 9.0f, 0.1f, 300.0f)));
+		}
+
+		std::mt19937 random { 3 };
+		SceneBVH bvh;
+		std::vector<math::AABB> boxes;
+		std::vector<bool> alive;
+		std::vector<SceneBVH::ProxyId> proxies;
+	};
+}
+
+TEST_F(SceneBVHTest, EmptyTreeReturnsNothing)
+{
+	std::vector<SceneBVH::ProxyId> results = { 1, 2, 3 };
+	bvh.QueryFrustum(MakeCameraFrustum(), results);
+	EXPECT_TRUE(results.empty());
+	bvh.QueryOverlap({ { -1.0f, -1.0f, -1.0f }, { 1.0f, 1.0f, 1.0f } }, results);
+	EXPECT_TRUE(results.empty());
+	SceneBVH::RayHit hit;
+	EXPECT_FALSE(bvh.RayCast(RandomRay(), 1000.0f, hit));
+	EXPECT_EQ(bvh.ComputeHeight(), 0u);
+	EXPECT_EQ(bvh.ComputeCost(), 0.0f);
+	bvh.Update();
+	bvh.Rebuild();
+	EXPECT_EQ(bvh.GetProxyCount(), 0u);
+}
+
+TEST_F(SceneBVHTest, SingleProxy)
+{
+	Add({ { -1.0f, -1.0f, 9.0f }, { 1.0f, 1.0f, 11.0f } });
+	EXPECT_EQ(bvh.GetProxyCount(), 1u);
+	EXPECT_EQ(bvh.ComputeHeight(), 1u);
+
+	SceneBVH::RayHit hit;
+	ASSERT_TRUE(bvh.RayCast({ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, 1000.0f, hit));
+	EXPECT_EQ(hit.proxy, proxies[0]);
+	EXPECT_FLOAT_EQ(hit.distance, 9.0f);
+	EXPECT_FALSE(bvh.RayCast({ { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }, 8.0f, hit));
+}
+
+TEST_F(SceneBVHTest, InsertedProxiesMatchBruteForce)
+{
+	AddRandom(3000);
+	EXPECT_EQ(bvh.GetProxyCount(), 3000u);
+	ExpectFrustumMatchesBruteForce(MakeCameraFrustum());
+	for (int i = 0; i < 20; ++i) {
+		math::AABB query = RandomBox();
+		query.min.x -= 20.0f;
+		query.max.x += 20.0f;
+		ExpectOverlapMatchesBruteForce(query);
+	}
+	for (int i = 0; i < 200; ++i) {
+		ExpectRayCastMatchesBruteForce(RandomRay());
+	}
+}
+
+TEST_F(SceneBVHTest, DestroyedProxiesAreNotReturned)
+{
+	AddRandom(1000);
+	for (size_t i = 0; i < boxes.size(); i += 3) {
+		bvh.DestroyProxy(proxies[i]);
+		alive[i] = false;
+	}
+	EXPECT_EQ(bvh.GetProxyCount(), 1000u - 334u);
+	ExpectFrustumMatchesBruteForce(MakeCameraFrustum());
+	ExpectOverlapMatchesBruteForce({ { -kWorld, -kWorld, -kWorld }, { kWorld, kWorld, kWorld } });
+	for (int i = 0; i < 100; ++i) {
+		ExpectRayCastMatchesBruteForce(RandomRay());
+	}
+
+	// 空いた番号は再利用されるが、既存の登録番号は変わらない
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		if (alive[i]) {
+			EXPECT_EQ(reinterpret_cast<size_t>(bvh.GetUserData(proxies[i])), i);
+		}
+	}
+}
+
+TEST_F(SceneBVHTest, DestroyingEveryProxyEmptiesTheTree)
+{
+	AddRandom(50);
+	for (SceneBVH::ProxyId proxy : proxies) {
+		bvh.DestroyProxy(proxy);
+	}
+	std::fill(alive.begin(), alive.end(), false);
+	EXPECT_EQ(bvh.GetProxyCount(), 0u);
+	EXPECT_EQ(bvh.ComputeHeight(), 0u);
+	ExpectOverlapMatchesBruteForce({ { -kWorld, -kWorld, -kWorld }, { kWorld, kWorld, kWorld } });
+}
+
+TEST_F(SceneBVHTest, RefitAfterMoveMatchesBruteForce)
+{
+	AddRandom(2000);
+	// 遠くへ動かす（付け直さないと親の箱からはみ出す）
+	for (size_t i = 0; i < boxes.size(); i += 4) {
+		math::AABB &box = boxes[i];
+		box.min.x += 150.0f;
+		box.max.x += 150.0f;
+		bvh.MoveProxy(proxies[i], box);
+	}
+	bvh.Refit();
+	ExpectFrustumMatchesBruteForce(MakeCameraFrustum());
+	for (int i = 0; i < 20; ++i) {
+		ExpectOverlapMatchesBruteForce(RandomBox());
+	}
+	for (int i = 0; i < 200; ++i) {
+		ExpectRayCastMatchesBruteForce(RandomRay());
+	}
+	// 登録番号から引く箱も新しいもの
+	EXPECT_EQ(bvh.GetAABB(proxies[0]).min.x, boxes[0].min.x);
+}
+
+TEST_F(SceneBVHTest, RandomEditsMatchBruteForce)
+{
+	AddRandom(3000);
+	math::Frustum frustum = MakeCameraFrustum();
+	for (int round = 0; round < 30; ++round) {
+		for (int k = 0; k < 300; ++k) {
+			size_t i = random() % boxes.size();
+			if (!alive[i]) {
+				continue;
+			}
+			float dx = Uniform(-3.0f, 3.0f);
+			float dz = Uniform(-3.0f, 3.0f);
+			boxes[i].min.x += dx;
+			boxes[i].max.x += dx;
+			boxes[i].min.z += dz;
+			boxes[i].max.z += dz;
+			bvh.MoveProxy(proxies[i], boxes[i]);
+		}
+		for (int k = 0; k < 20; ++k) {
+			size_t i = random() % boxes.size();
+			if (alive[i]) {
+				bvh.DestroyProxy(proxies[i]);
+				alive[i] = false;
+			} else {
+				boxes[i] = RandomBox();
+				proxies[i] = bvh.CreateProxy(boxes[i], reinterpret_cast<void *>(i));
+				alive[i] = true;
+			}
+		}
+		bvh.Update();
+		if (round % 7 == 0) {
+			bvh.Rebuild();
+		}
+
+		ExpectFrustumMatchesBruteForce(frustum);
+		math::AABB query = RandomBox();
+		query.min.z -= 20.0f;
+		query.max.z += 20.0f;
+		ExpectOverlapMatchesBruteForce(query);
+		for (int k = 0; k < 20; ++k) {
+			ExpectRayCastMatchesBruteForce(RandomRay());
+		}
+		if (HasFailure()) {
+			FAIL() << "round " << round;
+		}
+	}
+}
+
+TEST_F(SceneBVHTest, RayCastUsesLeafTest)
+{
+	AddRandom(2000);
+	// 葉の箱に内接する球で判定する
+	SceneBVH::RayTest sphereTest = [this](SceneBVH::ProxyId proxy, const math::Ray &ray, float maxDistance, float &distance) {
+		const math::AABB &box = bvh.GetAABB(proxy);
+		math::Vector3 center = math::GetCenter(box);
+		float radius = (box.max.x - box.min.x) * 0.5f;
+		math::Vector3 offset = { ray.origin.x - center.x, ray.origin.y - center.y, ray.origin.z - center.z };
+		float b = offset.x * ray.direction.x + offset.y * ray.direction.y + offset.z * ray.direction.z;
+		float c = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z - radius * radius;
+		float discriminant = b * b - c;
+		if (discriminant < 0.0f) {
+			return false;
+		}
+		float root = std::sqrt(discriminant);
+		if (-b + root < 0.0f) {
+			return false;
+		}
+		float t = (std::max)(-b - root, 0.0f);
+		if (t > maxDistance) {
+			return false;
+		}
+		distance = t;
+		return true;
+		};
+	for (int i = 0; i < 300; ++i) {
+		ExpectRayCastMatchesBruteForce(RandomRay(), sphereTest);
+	}
+}
+
+TEST_F(SceneBVHTest, RebuildKeepsProxiesAndLowersCost)
+{
+	// 1列に並べて入れると、挿入だけの木は質が悪くなりやすい
+	for (int i = 0; i < 2000; ++i) {
+		float x = static_cast<float>(i) * 3.0f - 3000.0f;
+		Add({ { x, 0.0f, 0.0f }, { x + 1.0f, 1.0f, 1.0f } });
+	}
+	float insertedCost = bvh.ComputeCost();
+	bvh.Rebuild();
+	EXPECT_EQ(bvh.GetRebuildCount(), 1u);
+	EXPECT_LE(bvh.ComputeCost(), insertedCost);
+	// 2000個なら log2(2000) ≒ 11 段に近くなる
+	EXPECT_LE(bvh.ComputeHeight(), 16u);
+
+	EXPECT_EQ(bvh.GetProxyCount(), 2000u);
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		EXPECT_EQ(reinterpret_cast<size_t>(bvh.GetUserData(proxies[i])), i);
+		EXPECT_EQ(bvh.GetAABB(proxies[i]).min.x, boxes[i].min.x);
+	}
+	ExpectOverlapMatchesBruteForce({ { -100.0f, -1.0f, -1.0f }, { 100.0f, 1.0f, 1.0f } });
+}
+
+TEST_F(SceneBVHTest, UpdateRebuildsWhenQualityDrops)
+{
+	AddRandom(500);
+	bvh.SetRebuildCheckInterval(1);
+	bvh.SetRebuildThreshold(1.5f);
+
+	// 最初の確認で作り直し、その時のコストを覚える
+	bvh.Update();
+	EXPECT_EQ(bvh.GetRebuildCount(), 1u);
+
+	// 動かさなければ作り直さない
+	bvh.Update();
+	EXPECT_EQ(bvh.GetRebuildCount(), 1u);
+
+	// 全オブジェクトを混ぜるように動かすと、付け直しだけでは箱が大きく重なる
+	for (size_t i = 0; i < boxes.size(); ++i) {
+		boxes[i] = RandomBox();
+		bvh.MoveProxy(proxies[i], boxes[i]);
+	}
+	bvh.Update();
+	EXPECT_EQ(bvh.GetRebuildCount(), 2u);
+	ExpectFrustumMatchesBruteForce(MakeCameraFrustum());
+}
+
+TEST_F(SceneBVHTest, ClearRemovesEverything)
+{
+	AddRandom(100);
+	bvh.Clear();
+	std::fill(alive.begin(), alive.end(), false);
+	EXPECT_EQ(bvh.GetProxyCount(), 0u);
+	ExpectOverlapMatchesBruteForce({ { -kWorld, -kWorld, -kWorld }, { kWorld, kWorld, kWorld } });
+}
\ No newline at end of file
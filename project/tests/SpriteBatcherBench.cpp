@@ -0,0 +1,133 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "SpriteBatcher.h"
+#include "MathFunctions.h"
+
+// 1フレームに10万枚のスプライトの頂点作り（Add→Build。GPUへの書き込みと描画は含まない）
+// 比較: これまでのSpriteのように1枚ずつ頂点とワールド・WVP行列を作る場合（Sprite::Updateと同じ計算）
+// items_per_secondは1秒あたりのスプライト数、drawsはランの数（＝Drawの回数）
+namespace {
+
+	constexpr size_t kSpriteCount = 100000;
+
+	struct SceneSprite
+	{
+		uint32_t texture;
+		int32_t layer;
+		SpriteBatcher::Quad quad;
+	};
+
+	// 16枚のテクスチャ（512x512のアトラスから64x64を切り出す）、半分は回転している
+	const std::vector<SceneSprite> &GetScene()
+	{
+		static const std::vector<SceneSprite> scene = [] {
+			std::vector<SceneSprite> result(kSpriteCount);
+			std::mt19937 random(3);
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			for (size_t i = 0; i < result.size(); ++i) {
+				SpriteBatcher::Quad &quad = result[i].quad;
+				quad.position = { unit(random) * 1280.0f, unit(random) * 720.0f };
+				quad.size = { 4.0f + unit(random) * 60.0f, 4.0f + unit(random) * 60.0f };
+				quad.rotation = (i % 2) ? (unit(random) - 0.5f) * 6.28f : 0.0f;
+				quad.anchorPoint = { 0.5f, 0.5f };
+				quad.textureLeftTop = { float(random() % 8) * 64.0f, float(random() % 8) * 64.0f };
+				quad.textureSize = { 64.0f, 64.0f };
+				quad.color = { 1.0f, 1.0f, 1.0f, 0.5f + unit(random) * 0.5f };
+				result[i].texture = uint32_t(random() % 16);
+				result[i].layer = int32_t(random() % 4);
+			}
+			return result;
+			}();
+		return scene;
+	}
+
+	// Add→Build（レイヤー数: 1なら全部レイヤー0）
+	void BM_SpriteBatcher(benchmark::State &state)
+	{
+		const std::vector<SceneSprite> &scene = GetScene();
+		const bool useLayers = state.range(0) > 1;
+		SpriteBatcher batcher;
+		std::vector<SpriteBatcher::Vertex> vertices(kSpriteCount * 4);
+		for (auto _ : state) {
+			batcher.Clear();
+			for (const SceneSprite &sprite : scene) {
+				batcher.Add(sprite.texture, { 512.0f, 512.0f }, useLayers ? sprite.layer : 0, sprite.quad);
+			}
+			batcher.Build(vertices.data());
+			benchmark::DoNotOptimize(vertices.data());
+		}
+		state.SetItemsProcessed(state.iterations() * kSpriteCount);
+		state.counters["draws"] = static_cast<double>(batcher.GetRuns().size());
+		state.counters["vertex_MiB"] = static_cast<double>(vertices.size() * sizeof(SpriteBatcher::Vertex)) / (1024.0 * 1024.0);
+	}
+
+	// Buildだけ（並べ替えと頂点の書き出し）
+	void BM_SpriteBatcherBuild(benchmark::State &state)
+	{
+		const std::vector<SceneSprite> &scene = GetScene();
+		SpriteBatcher batcher;
+		std::vector<SpriteBatcher::Vertex> vertices(kSpriteCount * 4);
+		for (const SceneSprite &sprite : scene) {
+			batcher.Add(sprite.texture, { 512.0f, 512.0f }, sprite.layer, sprite.quad);
+		}
+		for (auto _ : state) {
+			batcher.Build(vertices.data());
+			benchmark::DoNotOptimize(vertices.data());
+		}
+		state.SetItemsProcessed(state.iterations() * kSpriteCount);
+	}
+
+	// これまでのSpriteの頂点と定数バッファの中身
+	struct SpriteVertexData
+	{
+		math::Vector4 position;
+		math::Vector2 texcoord;
+		math::Vector3 normal;
+	};
+	struct SpriteTransformationMatrix
+	{
+		math::Matrix4x4 WVP;
+		math::Matrix4x4 World;
+	};
+
+	// 1枚ずつSprite::Updateと同じ計算をする（これに加えて1枚ごとにバッファを設定してDrawしていた）
+	void BM_PerSpriteUpdate(benchmark::State &state)
+	{
+		const std::vector<SceneSprite> &scene = GetScene();
+		std::vector<SpriteVertexData> vertices(kSpriteCount * 4);
+		std::vector<SpriteTransformationMatrix> transforms(kSpriteCount);
+		math::Matrix4x4 projection = math::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+		for (auto _ : state) {
+			for (size_t i = 0; i < kSpriteCount; ++i) {
+				const SpriteBatcher::Quad &quad = scene[i].quad;
+				float left = 0.0f - quad.anchorPoint.x;
+				float right = 1.0f - quad.anchorPoint.x;
+				float top = 0.0f - quad.anchorPoint.y;
+				float bottom = 1.0f - quad.anchorPoint.y;
+				float texLeft = quad.textureLeftTop.x / 512.0f;
+				float texRight = (quad.textureLeftTop.x + quad.textureSize.x) / 512.0f;
+				float texTop = quad.textureLeftTop.y / 512.0f;
+				float texBottom = (quad.textureLeftTop.y + quad.textureSize.y) / 512.0f;
+				SpriteVertexData *vertex = &vertices[i * 4];
+				vertex[0] = { { left, bottom, 0.0f, 1.0f }, { texLeft, texBottom }, { 0.0f, 0.0f, -1.0f } };
+				vertex[1] = { { left, top, 0.0f, 1.0f }, { texLeft, texTop }, { 0.0f, 0.0f, -1.0f } };
+				vertex[2] = { { right, bottom, 0.0f, 1.0f }, { texRight, texBottom }, { 0.0f, 0.0f, -1.0f } };
+				vertex[3] = { { right, top, 0.0f, 1.0f }, { texRight, texTop }, { 0.0f, 0.0f, -1.0f } };
+
+				math::Matrix4x4 world = math::MakeAffineMatrix({ quad.size.x, quad.size.y, 1.0f }, { 0.0f, 0.0f, quad.rotation }, { quad.position.x, quad.position.y, 0.0f });
+				transforms[i].WVP = math::Multiply(world, projection);
+				transforms[i].World = world;
+			}
+			benchmark::DoNotOptimize(vertices.data());
+			benchmark::DoNotOptimize(transforms.data());
+		}
+		state.SetItemsProcessed(state.iterations() * kSpriteCount);
+		state.counters["draws"] = static_cast<double>(kSpriteCount);
+	}
+
+}
+
+BENCHMARK(BM_SpriteBatcher)->ArgName("layers")->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SpriteBatcherBuild)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PerSpriteUpdate)->Unit(benchmark::kMillisecond);
\ No newline at end of file
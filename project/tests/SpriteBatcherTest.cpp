@@ -0,0 +1,245 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <vector>
+#include "SpriteBatcher.h"
+#include "MathFunctions.h"
+
+// スプライトの頂点作り
+// 頂点の位置はSpriteと同じ行列（拡縮→回転→移動）で計算したものと比べ、並びはレイヤー→テクスチャ→追加順の安定ソートと比べる
+namespace {
+
+	struct Added
+	{
+		uint32_t texture;
+		int32_t layer;
+		SpriteBatcher::Quad quad;
+	};
+
+	std::vector<SpriteBatcher::Vertex> Build(SpriteBatcher &batcher)
+	{
+		std::vector<SpriteBatcher::Vertex> vertices(batcher.GetQuadCount() * 4);
+		batcher.Build(vertices.data());
+		return vertices;
+	}
+
+	// レイヤー→テクスチャ→追加した順
+	std::vector<size_t> ExpectedOrder(const std::vector<Added> &added)
+	{
+		std::vector<size_t> order(added.size());
+		std::iota(order.begin(), order.end(), size_t(0));
+		std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+			if (added[a].layer != added[b].layer) {
+				return added[a].layer < added[b].layer;
+			}
+			return added[a].texture < added[b].texture;
+			});
+		return order;
+	}
+
+	float ToFloat(uint16_t unorm)
+	{
+		return static_cast<float>(unorm) / 65535.0f;
+	}
+
+}
+
+TEST(SpriteBatcher, VertexIs16Bytes)
+{
+	EXPECT_EQ(sizeof(SpriteBatcher::Vertex), 16u);
+}
+
+TEST(SpriteBatcher, EmptyBuildHasNoRuns)
+{
+	SpriteBatcher batcher;
+	batcher.Build(nullptr);
+	EXPECT_EQ(batcher.GetQuadCount(), 0u);
+	EXPECT_TRUE(batcher.GetRuns().empty());
+}
+
+TEST(SpriteBatcher, MatchesSpriteTransformAndStableOrder)
+{
+	std::mt19937 random(3);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	auto range = [&](float minimum, float maximum) { return minimum + (maximum - minimum) * unit(random); };
+	const math::Vector2 textureSize = { 512.0f, 512.0f };
+
+	SpriteBatcher batcher;
+	std::vector<Added> added;
+	for (int i = 0; i < 5000; ++i) {
+		SpriteBatcher::Quad quad;
+		quad.position = { range(0.0f, 1280.0f), range(0.0f, 720.0f) };
+		quad.size = { range(1.0f, 300.0f), range(1.0f, 300.0f) };
+		quad.rotation = (i % 3 == 0) ? 0.0f : range(-3.14f, 3.14f);
+		quad.anchorPoint = { unit(random), unit(random) };
+		quad.textureLeftTop = { range(0.0f, 100.0f), range(0.0f, 100.0f) };
+		quad.textureSize = { (i % 5 == 0) ? 0.0f : range(1.0f, 400.0f), range(1.0f, 400.0f) };
+		quad.color = { unit(random), unit(random), unit(random), unit(random) };
+		quad.isFlipX = (i & 1) != 0;
+		quad.isFlipY = (i & 2) != 0;
+		Added entry = { uint32_t(random() % 6), int32_t(random() % 5) - 2, quad };
+		added.push_back(entry);
+		batcher.Add(entry.texture, textureSize, entry.layer, entry.quad);
+	}
+	std::vector<SpriteBatcher::Vertex> vertices = Build(batcher);
+	std::vector<size_t> order = ExpectedOrder(added);
+
+	for (size_t k = 0; k < order.size(); ++k) {
+		const SpriteBatcher::Quad &quad = added[order[k]].quad;
+		// Sprite::Updateと同じ頂点と行列
+		float left = 0.0f - quad.anchorPoint.x;
+		float right = 1.0f - quad.anchorPoint.x;
+		float top = 0.0f - quad.anchorPoint.y;
+		float bottom = 1.0f - quad.anchorPoint.y;
+		if (quad.isFlipX) {
+			left = -left;
+			right = -right;
+		}
+		if (quad.isFlipY) {
+			top = -top;
+			bottom = -bottom;
+		}
+		math::Matrix4x4 world = math::MakeAffineMatrix({ quad.size.x, quad.size.y, 1.0f }, { 0.0f, 0.0f, quad.rotation }, { quad.position.x, quad.position.y, 0.0f });
+		const math::Vector3 corners[4] = { { left, bottom, 0.0f }, { left, top, 0.0f }, { right, bottom, 0.0f }, { right, top, 0.0f } };
+
+		math::Vector2 clip = quad.textureSize.x <= 0.0f ? textureSize : quad.textureSize;
+		float u0 = quad.textureLeftTop.x / textureSize.x;
+		float v0 = quad.textureLeftTop.y / textureSize.y;
+		float u1 = std::min((quad.textureLeftTop.x + clip.x) / textureSize.x, 1.0f);
+		float v1 = std::min((quad.textureLeftTop.y + clip.y) / textureSize.y, 1.0f);
+		const float texcoords[4][2] = { { u0, v1 }, { u0, v0 }, { u1, v1 }, { u1, v0 } };
+		const float color[4] = { quad.color.x, quad.color.y, quad.color.z, quad.color.w };
+
+		for (int corner = 0; corner < 4; ++corner) {
+			const SpriteBatcher::Vertex &vertex = vertices[k * 4 + corner];
+			math::Vector3 expected = math::ApplyTransform(corners[corner], world);
+			ASSERT_NEAR(vertex.position.x, expected.x, 0.01f) << "quad " << k << " corner " << corner;
+			ASSERT_NEAR(vertex.position.y, expected.y, 0.01f) << "quad " << k << " corner " << corner;
+			ASSERT_NEAR(ToFloat(vertex.texcoord[0]), texcoords[corner][0], 1.0f / 65535.0f);
+			ASSERT_NEAR(ToFloat(vertex.texcoord[1]), texcoords[corner][1], 1.0f / 65535.0f);
+			for (int channel = 0; channel < 4; ++channel) {
+				ASSERT_EQ((vertex.color >> (8 * channel)) & 0xFF, static_cast<uint32_t>(color[channel] * 255.0f + 0.5f));
+			}
+		}
+	}
+
+	// ランは隙間なく並び、中の四角形はすべてランのテクスチャを使う
+	uint32_t covered = 0;
+	for (const SpriteBatcher::Run &run : batcher.GetRuns()) {
+		ASSERT_EQ(run.firstQuad, covered);
+		ASSERT_GT(run.quadCount, 0u);
+		for (uint32_t i = 0; i < run.quadCount; ++i) {
+			ASSERT_EQ(added[order[run.firstQuad + i]].texture, run.texture);
+		}
+		covered += run.quadCount;
+	}
+	EXPECT_EQ(covered, added.size());
+	// 5レイヤー×6テクスチャ
+	EXPECT_EQ(batcher.GetRuns().size(), 30u);
+}
+
+TEST(SpriteBatcher, SameTextureInDifferentLayersSplitsRuns)
+{
+	SpriteBatcher batcher;
+	SpriteBatcher::Quad quad;
+	// 追加した順: (テクスチャ, レイヤー) = (1,0) (2,0) (1,0) (1,1) (1,-1)
+	batcher.Add(1, { 64.0f, 64.0f }, 0, quad);
+	batcher.Add(2, { 64.0f, 64.0f }, 0, quad);
+	batcher.Add(1, { 64.0f, 64.0f }, 0, quad);
+	batcher.Add(1, { 64.0f, 64.0f }, 1, quad);
+	batcher.Add(1, { 64.0f, 64.0f }, -1, quad);
+	Build(batcher);
+
+	const std::vector<SpriteBatcher::Run> &runs = batcher.GetRuns();
+	ASSERT_EQ(runs.size(), 4u);
+	EXPECT_EQ(runs[0].texture, 1u); // レイヤー-1
+	EXPECT_EQ(runs[0].quadCount, 1u);
+	EXPECT_EQ(runs[1].texture, 1u); // レイヤー0のテクスチャ1（2枚が1回で描ける）
+	EXPECT_EQ(runs[1].quadCount, 2u);
+	EXPECT_EQ(runs[2].texture, 2u);
+	EXPECT_EQ(runs[2].quadCount, 1u);
+	EXPECT_EQ(runs[3].texture, 1u); // レイヤー1
+	EXPECT_EQ(runs[3].quadCount, 1u);
+}
+
+TEST(SpriteBatcher, LayersOutsideInt16AreClamped)
+{
+	SpriteBatcher batcher;
+	SpriteBatcher::Quad quad;
+	quad.color = { 1.0f, 0.0f, 0.0f, 1.0f };
+	batcher.Add(3, { 64.0f, 64.0f }, 100000, quad);
+	quad.color = { 0.0f, 1.0f, 0.0f, 1.0f };
+	batcher.Add(3, { 64.0f, 64.0f }, -100000, quad);
+	quad.color = { 0.0f, 0.0f, 1.0f, 1.0f };
+	batcher.Add(3, { 64.0f, 64.0f }, 0, quad);
+	std::vector<SpriteBatcher::Vertex> vertices = Build(batcher);
+	EXPECT_EQ(vertices[0].color, 0xFF00FF00u);
+	EXPECT_EQ(vertices[4].color, 0xFFFF0000u);
+	EXPECT_EQ(vertices[8].color, 0xFF0000FFu);
+	EXPECT_EQ(batcher.GetRuns().size(), 3u);
+}
+
+TEST(SpriteBatcher, FlipMirrorsAroundAnchorPoint)
+{
+	SpriteBatcher batcher;
+	SpriteBatcher::Quad quad;
+	quad.position = { 100.0f, 200.0f };
+	quad.size = { 40.0f, 20.0f };
+	quad.anchorPoint = { 0.25f, 0.5f };
+	batcher.Add(0, { 64.0f, 64.0f }, 0, quad);
+	quad.isFlipX = true;
+	batcher.Add(0, { 64.0f, 64.0f }, 0, quad);
+	std::vector<SpriteBatcher::Vertex> vertices = Build(batcher);
+
+	// 左下: 反転なしは左に10、反転すると右に10（アンカーポイントの位置は変わらない）
+	EXPECT_FLOAT_EQ(vertices[0].position.x, 90.0f);
+	EXPECT_FLOAT_EQ(vertices[0].position.y, 210.0f);
+	EXPECT_FLOAT_EQ(vertices[2].position.x, 130.0f);
+	EXPECT_FLOAT_EQ(vertices[4].position.x, 110.0f);
+	EXPECT_FLOAT_EQ(vertices[6].position.x, 70.0f);
+	EXPECT_FLOAT_EQ(vertices[4].position.y, 210.0f);
+	// UVは反転しない（四角形が裏返るので見た目が反転する）
+	EXPECT_EQ(vertices[0].texcoord[0], vertices[4].texcoord[0]);
+}
+
+TEST(SpriteBatcher, ZeroClipSizeUsesWholeTexture)
+{
+	SpriteBatcher batcher;
+	SpriteBatcher::Quad quad;
+	batcher.Add(0, { 256.0f, 128.0f }, 0, quad);
+	quad.textureLeftTop = { 64.0f, 32.0f };
+	quad.textureSize = { 128.0f, 64.0f };
+	batcher.Add(0, { 256.0f, 128.0f }, 0, quad);
+	std::vector<SpriteBatcher::Vertex> vertices = Build(batcher);
+
+	EXPECT_EQ(vertices[1].texcoord[0], 0u);
+	EXPECT_EQ(vertices[1].texcoord[1], 0u);
+	EXPECT_EQ(vertices[2].texcoord[0], 65535u);
+	EXPECT_EQ(vertices[2].texcoord[1], 65535u);
+	EXPECT_NEAR(ToFloat(vertices[5].texcoord[0]), 0.25f, 1.0f / 65535.0f);
+	EXPECT_NEAR(ToFloat(vertices[5].texcoord[1]), 0.25f, 1.0f / 65535.0f);
+	EXPECT_NEAR(ToFloat(vertices[6].texcoord[0]), 0.75f, 1.0f / 65535.0f);
+	EXPECT_NEAR(ToFloat(vertices[6].texcoord[1]), 0.75f, 1.0f / 65535.0f);
+}
+
+TEST(SpriteBatcher, ClearStartsNextFrame)
+{
+	SpriteBatcher batcher;
+	SpriteBatcher::Quad quad;
+	batcher.Add(5, { 64.0f, 64.0f }, 2, quad);
+	batcher.Add(6, { 64.0f, 64.0f }, 2, quad);
+	Build(batcher);
+	ASSERT_EQ(batcher.GetRuns().size(), 2u);
+
+	batcher.Clear();
+	EXPECT_EQ(batcher.GetQuadCount(), 0u);
+	EXPECT_TRUE(batcher.GetRuns().empty());
+	batcher.Add(7, { 64.0f, 64.0f }, 0, quad);
+	Build(batcher);
+	ASSERT_EQ(batcher.GetRuns().size(), 1u);
+	EXPECT_EQ(batcher.GetRuns()[0].texture, 7u);
+	EXPECT_EQ(batcher.GetRuns()[0].firstQuad, 0u);
+	EXPECT_EQ(batcher.GetRuns()[0].quadCount, 1u);
+}
\ No newline at end of file
@@ -0,0 +1,134 @@
+#include <benchmark/benchmark.h>
+#include <random>
+#include <vector>
+#include "SpriteGeometry.h"
+#include "MathFunctions.h"
+
+// 1フレーム分のSprite::Update（頂点と行列。GPUへのコピーと描画は含まない）
+// 動かないスプライトと、毎フレーム位置と回転が変わるスプライトを混ぜる（引数: 動かない数, 動く数）
+// 比較: 以前のSprite::Updateと同じく、毎回すべての頂点・UVと、正射影・ビュー行列・2回のMultiplyを作り直す場合
+// （テクスチャのメタデータはTextureManagerの代わりに配列から引く）
+// items_per_secondは1秒あたりのスプライト数、skippedは省いた数
+namespace {
+
+	constexpr float kClientWidth = 1280.0f;
+	constexpr float kClientHeight = 720.0f;
+
+	struct Scene
+	{
+		std::vector<SpriteGeometry> sprites;
+		std::vector<uint32_t> textures;
+		size_t staticCount = 0;
+	};
+
+	Scene MakeScene(size_t staticCount, size_t animatedCount)
+	{
+		Scene scene;
+		scene.staticCount = staticCount;
+		scene.sprites.resize(staticCount + animatedCount);
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		for (SpriteGeometry &sprite : scene.sprites) {
+			sprite.SetPosition({ unit(random) * kClientWidth, unit(random) * kClientHeight });
+			sprite.SetSize({ 8.0f + unit(random) * 56.0f, 8.0f + unit(random) * 56.0f });
+			sprite.SetAnchorPoint({ 0.5f, 0.5f });
+			sprite.SetTextureDimensions({ 512.0f, 512.0f });
+			sprite.SetTextureLeftTop({ float(random() % 8) * 64.0f, float(random() % 8) * 64.0f });
+			sprite.SetTextureSize({ 64.0f, 64.0f });
+			scene.textures.push_back(uint32_t(random() % 16));
+		}
+		return scene;
+	}
+
+	// 動くスプライトを1フレーム分進める
+	void Animate(Scene &scene, int frame)
+	{
+		for (size_t i = scene.staticCount; i < scene.sprites.size(); ++i) {
+			SpriteGeometry &sprite = scene.sprites[i];
+			math::Vector2 position = sprite.GetPosition();
+			sprite.SetPosition({ position.x + 0.5f, position.y + ((frame & 1) ? 0.25f : -0.25f) });
+			sprite.SetRotation(sprite.GetRotation() + 0.01f);
+		}
+	}
+
+	void BM_SpriteUpdate(benchmark::State &state)
+	{
+		Scene scene = MakeScene(size_t(state.range(0)), size_t(state.range(1)));
+		const math::Matrix4x4 projection = math::MakeOrthographicMatrix(0.0f, 0.0f, kClientWidth, kClientHeight, 0.0f, 100.0f);
+		SpriteGeometry::UpdateStatistics statistics;
+		int frame = 0;
+		for (auto _ : state) {
+			Animate(scene, frame++);
+			statistics = {};
+			for (SpriteGeometry &sprite : scene.sprites) {
+				statistics.Count(sprite.Update(projection));
+			}
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * scene.sprites.size());
+		state.counters["skipped"] = double(statistics.skippedUpdates);
+	}
+
+	// 比較用: 以前のSprite::Updateと同じ計算
+	void BM_SpriteUpdateEveryFrame(benchmark::State &state)
+	{
+		Scene scene = MakeScene(size_t(state.range(0)), size_t(state.range(1)));
+		struct Metadata
+		{
+			size_t width;
+			size_t height;
+		};
+		std::vector<Metadata> metadata(16, Metadata { 512, 512 });
+		struct Output
+		{
+			SpriteGeometry::Vertex vertices[4];
+			math::Matrix4x4 wvp;
+			math::Matrix4x4 world;
+		};
+		std::vector<Output> outputs(scene.sprites.size());
+		int frame = 0;
+		for (auto _ : state) {
+			Animate(scene, frame++);
+			for (size_t i = 0; i < scene.sprites.size(); ++i) {
+				const SpriteGeometry &sprite = scene.sprites[i];
+				Output &output = outputs[i];
+				float left = 0.0f - sprite.GetAnchorPoint().x;
+				float right = 1.0f - sprite.GetAnchorPoint().x;
+				float top = 0.0f - sprite.GetAnchorPoint().y;
+				float bottom = 1.0f - sprite.GetAnchorPoint().y;
+				if (sprite.GetIsFlipX()) {
+					left = -left;
+					right = -right;
+				}
+				if (sprite.GetIsFlipY()) {
+					top = -top;
+					bottom = -bottom;
+				}
+				const Metadata &textureMetadata = metadata[scene.textures[i]];
+				const math::Vector2 &leftTop = sprite.GetTextureLeftTop();
+				const math::Vector2 &textureSize = sprite.GetTextureSize();
+				float tex_left = leftTop.x / textureMetadata.width;
+				float tex_right = (leftTop.x + textureSize.x) / textureMetadata.width;
+				float tex_top = leftTop.y / textureMetadata.height;
+				float tex_bottom = (leftTop.y + textureSize.y) / textureMetadata.height;
+				output.vertices[0] = { { left,bottom,0.0f,1.0f }, { tex_left,tex_bottom }, { 0.0f,0.0f,-1.0f } };
+				output.vertices[1] = { { left,top,0.0f,1.0f }, { tex_left,tex_top }, { 0.0f,0.0f,-1.0f } };
+				output.vertices[2] = { { right,bottom,0.0f,1.0f }, { tex_right,tex_bottom }, { 0.0f,0.0f,-1.0f } };
+				output.vertices[3] = { { right,top,0.0f,1.0f }, { tex_right,tex_top }, { 0.0f,0.0f,-1.0f } };
+
+				math::Matrix4x4 worldMatrix = math::MakeAffineMatrix({ sprite.GetSize().x,sprite.GetSize().y,1.0f }, { 0.0f,0.0f,sprite.GetRotation() }, { sprite.GetPosition().x,sprite.GetPosition().y,0.0f });
+				math::Matrix4x4 viewMatrix = math::MakeIdentity4x4();
+				math::Matrix4x4 projectionMatrix = math::MakeOrthographicMatrix(0.0f, 0.0f, kClientWidth, kClientHeight, 0.0f, 100.0f);
+				output.wvp = math::Multiply(worldMatrix, math::Multiply(viewMatrix, projectionMatrix));
+				output.world = worldMatrix;
+			}
+			benchmark::DoNotOptimize(outputs.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * scene.sprites.size());
+	}
+
+}
+
+BENCHMARK(BM_SpriteUpdate)->Args({ 10000, 10000 })->Args({ 20000, 0 })->Args({ 0, 20000 })->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SpriteUpdateEveryFrame)->Args({ 10000, 10000 })->Unit(benchmark::kMicrosecond);
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "SpriteGeometry.h"
+#include "MathFunctions.h"
+
+// スプライトの頂点と行列の作り直し
+// 変わったものだけ作り直した結果が、毎回すべて作り直した結果（新しいSpriteGeometryで1回Updateしたもの）とバイト単位で一致するか
+// 省いた数の数え方（SpriteCommon::GetUpdateStatisticsでImGuiに出している数）
+namespace {
+
+	const math::Matrix4x4 &GetProjection()
+	{
+		static const math::Matrix4x4 projection = math::MakeOrthographicMatrix(0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 100.0f);
+		return projection;
+	}
+
+	// 同じ設定で作り直したもの
+	SpriteGeometry Rebuild(const SpriteGeometry &source)
+	{
+		SpriteGeometry geometry;
+		geometry.SetPosition(source.GetPosition());
+		geometry.SetRotation(source.GetRotation());
+		geometry.SetSize(source.GetSize());
+		geometry.SetAnchorPoint(source.GetAnchorPoint());
+		geometry.SetIsFlipX(source.GetIsFlipX());
+		geometry.SetIsFlipY(source.GetIsFlipY());
+		geometry.SetTextureLeftTop(source.GetTextureLeftTop());
+		geometry.SetTextureSize(source.GetTextureSize());
+		geometry.SetTextureDimensions(source.GetTextureDimensions());
+		geometry.Update(GetProjection());
+		return geometry;
+	}
+
+	void ExpectSameOutput(const SpriteGeometry &actual, const SpriteGeometry &expected)
+	{
+		EXPECT_EQ(std::memcmp(actual.GetVertices(), expected.GetVertices(), sizeof(SpriteGeometry::Vertex) * 4), 0);
+		EXPECT_EQ(std::memcmp(&actual.GetWorldMatrix(), &expected.GetWorldMatrix(), sizeof(math::Matrix4x4)), 0);
+		EXPECT_EQ(std::memcmp(&actual.GetWVPMatrix(), &expected.GetWVPMatrix(), sizeof(math::Matrix4x4)), 0);
+	}
+
+}
+
+TEST(SpriteGeometry, FirstUpdateBuildsBoth)
+{
+	SpriteGeometry geometry;
+	SpriteGeometry::UpdateResult result = geometry.Update(GetProjection());
+	EXPECT_TRUE(result.vertexUpdated);
+	EXPECT_TRUE(result.transformUpdated);
+
+	result = geometry.Update(GetProjection());
+	EXPECT_FALSE(result.vertexUpdated);
+	EXPECT_FALSE(result.transformUpdated);
+}
+
+TEST(SpriteGeometry, SettersMarkOnlyWhatTheyAffect)
+{
+	SpriteGeometry geometry;
+	geometry.Update(GetProjection());
+
+	struct Case
+	{
+		const char *name;
+		void (*change)(SpriteGeometry &);
+		bool vertex;
+		bool transform;
+	};
+	const Case cases[] = {
+		{ "position", [](SpriteGeometry &g) { g.SetPosition({ 10.0f, 20.0f }); }, false, true },
+		{ "rotation", [](SpriteGeometry &g) { g.SetRotation(0.5f); }, false, true },
+		{ "size", [](SpriteGeometry &g) { g.SetSize({ 64.0f, 32.0f }); }, false, true },
+		{ "anchor", [](SpriteGeometry &g) { g.SetAnchorPoint({ 0.5f, 0.5f }); }, true, false },
+		{ "flipX", [](SpriteGeometry &g) { g.SetIsFlipX(true); }, true, false },
+		{ "flipY", [](SpriteGeometry &g) { g.SetIsFlipY(true); }, true, false },
+		{ "leftTop", [](SpriteGeometry &g) { g.SetTextureLeftTop({ 32.0f, 0.0f }); }, true, false },
+		{ "textureSize", [](SpriteGeometry &g) { g.SetTextureSize({ 64.0f, 64.0f }); }, true, false },
+		{ "texture", [](SpriteGeometry &g) { g.SetTextureDimensions({ 256.0f, 128.0f }); }, true, false },
+	};
+	for (const Case &c : cases) {
+		c.change(geometry);
+		SpriteGeometry::UpdateResult result = geometry.Update(GetProjection());
+		EXPECT_EQ(result.vertexUpdated, c.vertex) << c.name;
+		EXPECT_EQ(result.transformUpdated, c.transform) << c.name;
+		ExpectSameOutput(geometry, Rebuild(geometry));
+	}
+}
+
+TEST(SpriteGeometry, VerticesFollowAnchorFlipAndTextureRect)
+{
+	SpriteGeometry geometry;
+	geometry.SetAnchorPoint({ 0.25f, 0.5f });
+	geometry.SetIsFlipX(true);
+	geometry.SetTextureDimensions({ 256.0f, 128.0f });
+	geometry.SetTextureLeftTop({ 64.0f, 32.0f });
+	geometry.SetTextureSize({ 128.0f, 64.0f });
+	geometry.Update(GetProjection());
+
+	// 左下・左上・右下・右上（左右反転でアンカーポイントを軸に裏返る）
+	const SpriteGeometry::Vertex *vertices = geometry.GetVertices();
+	EXPECT_FLOAT_EQ(vertices[0].position.x, 0.25f);
+	EXPECT_FLOAT_EQ(vertices[0].position.y, 0.5f);
+	EXPECT_FLOAT_EQ(vertices[1].position.y, -0.5f);
+	EXPECT_FLOAT_EQ(vertices[2].position.x, -0.75f);
+	EXPECT_FLOAT_EQ(vertices[0].texcoord.x, 0.25f);
+	EXPECT_FLOAT_EQ(vertices[0].texcoord.y, 0.75f);
+	EXPECT_FLOAT_EQ(vertices[3].texcoord.x, 0.75f);
+	EXPECT_FLOAT_EQ(vertices[3].texcoord.y, 0.25f);
+	EXPECT_FLOAT_EQ(vertices[3].normal.z, -1.0f);
+}
+
+TEST(SpriteGeometry, TransformMatchesAffineTimesProjection)
+{
+	SpriteGeometry geometry;
+	geometry.SetPosition({ 300.0f, 200.0f });
+	geometry.SetRotation(0.7f);
+	geometry.SetSize({ 50.0f, 80.0f });
+	geometry.Update(GetProjection());
+
+	math::Matrix4x4 world = math::MakeAffineMatrix({ 50.0f, 80.0f, 1.0f }, { 0.0f, 0.0f, 0.7f }, { 300.0f, 200.0f, 0.0f });
+	math::Matrix4x4 wvp = math::Multiply(world, GetProjection());
+	EXPECT_EQ(std::memcmp(&geometry.GetWorldMatrix(), &world, sizeof(world)), 0);
+	EXPECT_EQ(std::memcmp(&geometry.GetWVPMatrix(), &wvp, sizeof(wvp)), 0);
+}
+
+TEST(SpriteGeometry, IncrementalUpdatesMatchFullRebuild)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<SpriteGeometry> sprites(64);
+	for (int frame = 0; frame < 100; ++frame) {
+		for (SpriteGeometry &sprite : sprites) {
+			// 何も変えないフレームが多くなるよう、ときどき1つだけ変える
+			switch (random() % 12) {
+			case 0: sprite.SetPosition({ unit(random) * 1280.0f, unit(random) * 720.0f }); break;
+			case 1: sprite.SetRotation(unit(random) * 6.28f); break;
+			case 2: sprite.SetSize({ 1.0f + unit(random) * 200.0f, 1.0f + unit(random) * 200.0f }); break;
+			case 3: sprite.SetAnchorPoint({ unit(random), unit(random) }); break;
+			case 4: sprite.SetIsFlipX(!sprite.GetIsFlipX()); break;
+			case 5: sprite.SetIsFlipY(!sprite.GetIsFlipY()); break;
+			case 6: sprite.SetTextureLeftTop({ unit(random) * 256.0f, unit(random) * 256.0f }); break;
+			case 7: sprite.SetTextureSize({ unit(random) * 256.0f, unit(random) * 256.0f }); break;
+			case 8: sprite.SetTextureDimensions({ 64.0f + float(random() % 4) * 256.0f, 64.0f + float(random() % 4) * 256.0f }); break;
+			default: break;
+			}
+			sprite.Update(GetProjection());
+		}
+		for (const SpriteGeometry &sprite : sprites) {
+			ExpectSameOutput(sprite, Rebuild(sprite));
+		}
+		if (testing::Test::HasFailure()) {
+			FAIL() << "frame " << frame;
+		}
+	}
+}
+
+TEST(SpriteGeometry, StatisticsCountSkippedUpdates)
+{
+	// 10枚は動かず、10枚は毎フレーム位置が変わり、うち5枚は2フレームに1回切り出し範囲も変わる
+	std::vector<SpriteGeometry> staticSprites(10);
+	std::vector<SpriteGeometry> animatedSprites(10);
+	const int kFrames = 8;
+	SpriteGeometry::UpdateStatistics total;
+	for (int frame = 0; frame < kFrames; ++frame) {
+		SpriteGeometry::UpdateStatistics statistics;
+		for (SpriteGeometry &sprite : staticSprites) {
+			statistics.Count(sprite.Update(GetProjection()));
+		}
+		for (size_t i = 0; i < animatedSprites.size(); ++i) {
+			animatedSprites[i].SetPosition({ float(frame), float(i) });
+			if (i < 5 && frame % 2 == 1) {
+				animatedSprites[i].SetTextureLeftTop({ float(frame) * 16.0f, 0.0f });
+			}
+			statistics.Count(animatedSprites[i].Update(GetProjection()));
+		}
+
+		if (frame == 0) {
+			EXPECT_EQ(statistics.vertexUpdates, 20u);
+			EXPECT_EQ(statistics.transformUpdates, 20u);
+			EXPECT_EQ(statistics.skippedUpdates, 0u);
+		} else {
+			EXPECT_EQ(statistics.vertexUpdates, frame % 2 == 1 ? 5u : 0u) << "frame " << frame;
+			EXPECT_EQ(statistics.transformUpdates, 10u) << "frame " << frame;
+			EXPECT_EQ(statistics.skippedUpdates, 10u) << "frame " << frame;
+		}
+		total.vertexUpdates += statistics.vertexUpdates;
+		total.transformUpdates += statistics.transformUpdates;
+		total.skippedUpdates += statistics.skippedUpdates;
+	}
+	EXPECT_EQ(total.skippedUpdates, 10u * (kFrames - 1));
+	EXPECT_EQ(total.transformUpdates, 20u + 10u * (kFrames - 1));
+	EXPECT_EQ(total.vertexUpdates, 20u + 5u * (kFrames / 2));
+}
\ No newline at end of file
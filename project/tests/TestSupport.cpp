@@ -0,0 +1,110 @@
+#include "TestSupport.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace TestSupport {
+
+	std::string ResourcePath(const std::string &relativePath)
+	{
+		return std::string(GE3_RESOURCE_DIR) + "/" + relativePath;
+	}
+
+	std::vector<ModelFile> FindBundledModels()
+	{
+		std::vector<ModelFile> files;
+		for (const auto &entry : std::filesystem::recursive_directory_iterator(ResourcePath("models"))) {
+			if (entry.is_regular_file() && entry.path().extension() == ".obj") {
+				files.push_back({ entry.path().parent_path().string(), entry.path().filename().string() });
+			}
+		}
+		// ディレクトリの列挙順は環境で変わるので名前順にする
+		std::sort(files.begin(), files.end(), [](const ModelFile &lhs, const ModelFile &rhs) { return lhs.filename < rhs.filename; });
+		return files;
+	}
+
+	std::string MakeGridObj(uint32_t columns, uint32_t rows)
+	{
+		std::string text;
+		text.reserve(size_t(columns + 1) * (rows + 1) * 64 + size_t(columns) * rows * 96);
+		char line[128];
+		for (uint32_t z = 0; z <= rows; ++z) {
+			for (uint32_t x = 0; x <= columns; ++x) {
+				// なだらかな起伏を付ける
+				float height = 0.25f * static_cast<float>((x * 7 + z * 13) % 17) / 17.0f;
+				int length = std::snprintf(line, sizeof(line), "v %.6f %.6f %.6f\n", x * 0.5f, height, z * 0.5f);
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		for (uint32_t z = 0; z <= rows; ++z) {
+			for (uint32_t x = 0; x <= columns; ++x) {
+				int length = std::snprintf(line, sizeof(line), "vt %.6f %.6f\n",
+					static_cast<float>(x) / columns, static_cast<float>(z) / rows);
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		text += "vn 0.0000 1.0000 0.0000\n";
+		for (uint32_t z = 0; z < rows; ++z) {
+			for (uint32_t x = 0; x < columns; ++x) {
+				uint32_t v0 = z * (columns + 1) + x + 1;
+				uint32_t v1 = v0 + 1;
+				uint32_t v2 = v0 + columns + 1;
+				uint32_t v3 = v2 + 1;
+				int length = std::snprintf(line, sizeof(line), "f %u/%u/1 %u/%u/1 %u/%u/1\nf %u/%u/1 %u/%u/1 %u/%u/1\n",
+					v0, v0, v2, v2, v1, v1, v1, v1, v2, v2, v3, v3);
+				text.append(line, static_cast<size_t>(length));
+			}
+		}
+		return text;
+	}
+
+	std::string FindSystemFont()
+	{
+		// フォントはリポジトリに含めないので、どの環境にもありそうなものを探す
+		if (const char *path = std::getenv("GE3_TEST_FONT"); path && std::filesystem::is_regular_file(path)) {
+			return path;
+		}
+		const char *candidates[] = {
+			"C:/Windows/Fonts/arial.ttf",
+			"/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+			"/usr/share/fonts/TTF/DejaVuSans.ttf",
+			"/usr/share/fonts/dejavu/DejaVuSans.ttf",
+			"/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf",
+			"/Library/Fonts/Arial.ttf",
+			"/System/Library/Fonts/Supplemental/Arial.ttf",
+		};
+		for (const char *path : candidates) {
+			if (std::filesystem::is_regular_file(path)) {
+				return path;
+			}
+		}
+		return {};
+	}
+
+	std::string WriteTemporaryFile(const std::string &filename, const std::string &contents)
+	{
+		std::filesystem::path path = std::filesystem::temp_directory_path() / filename;
+		std::ofstream file(path, std::ios::binary);
+		file.write(contents.data(), static_cast<std::streamsize>(contents.size()));
+		return path.string();
+	}
+
+	std::vector<Model::VertexData> ExpandTriangles(const Model::ModelData &modelData)
+	{
+		std::vector<Model::VertexData> vertices;
+		vertices.reserve(modelData.indices.size());
+		for (uint32_t index : modelData.indices) {
+			vertices.push_back(modelData.vertices[index]);
+		}
+		return vertices;
+	}
+
+	bool SameVertex(const Model::VertexData &lhs, const Model::VertexData &rhs)
+	{
+		// VertexDataは隙間の無いfloatの並びなのでバイト列で比べられる
+		return std::memcmp(&lhs, &rhs, sizeof(Model::VertexData)) == 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Model.h"
+
+// テストとベンチマークで共有する補助
+namespace TestSupport
+{
+	// resources/からの相対パスを絶対パスにする
+	std::string ResourcePath(const std::string &relativePath);
+
+	// resources/models/にあるobjファイル（ディレクトリとファイル名の組）
+	struct ModelFile
+	{
+		std::string directoryPath;
+		std::string filename;
+	};
+	std::vector<ModelFile> FindBundledModels();
+
+	/// <summary>
+	/// 格子状の地形のobjテキストを作る（大きなメッシュの読み込みの計測用）
+	/// </summary>
+	/// <param name="columns">横の分割数</param>
+	/// <param name="rows">縦の分割数</param>
+	/// <returns>(columns+1)*(rows+1)頂点、columns*rows*2三角形（位置/UV/法線つき）</returns>
+	std::string MakeGridObj(uint32_t columns, uint32_t rows);
+
+	// テキストの描画に使えるTrueTypeフォントのパス（環境変数GE3_TEST_FONTか、OSに入っているフォント。見つからなければ空）
+	std::string FindSystemFont();
+
+	// 一時ディレクトリにファイルを書き出し、そのパスを返す
+	std::string WriteTemporaryFile(const std::string &filename, const std::string &contents);
+
+	// インデックスをたどって、三角形の頂点を展開する
+	std::vector<Model::VertexData> ExpandTriangles(const Model::ModelData &modelData);
+
+	// 2つの頂点が全要素でビット単位まで等しいか
+	bool SameVertex(const Model::VertexData &lhs, const Model::VertexData &rhs);
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <vector>
+#include "TransformBatch.h"
+#include "MathFunctions.h"
+#include "ThreadPool.h"
+
+// ワールド行列とWVP行列: オブジェクトごとにMakeAffineMatrix・Multiplyを呼ぶ場合と、TransformStreamsでまとめて作る場合
+namespace {
+
+	struct TransformationMatrix
+	{
+		math::Matrix4x4 WVP;
+		math::Matrix4x4 World;
+	};
+
+	math::TransformStreams RandomStreams(size_t count)
+	{
+		std::mt19937 random(1);
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+		std::uniform_real_distribution<float> angle(-3.14f, 3.14f);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+		math::TransformStreams streams;
+		for (size_t i = 0; i < count; ++i) {
+			streams.PushBack({
+				{ scale(random), scale(random), scale(random) },
+				{ angle(random), angle(random), angle(random) },
+				{ position(random), position(random), position(random) },
+				});
+		}
+		return streams;
+	}
+
+	math::Matrix4x4 MakeViewProjection()
+	{
+		math::Matrix4x4 camera = math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, -0.7f, 0.0f }, { 10.0f, 50.0f, -200.0f });
+		return math::Multiply(math::Inverse(camera), math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 5000.0f));
+	}
+
+	// オブジェクトごとに作る（これまでのObject3d::Updateと同じ計算）
+	void BM_PerObject(benchmark::State &state)
+	{
+		size_t count = static_cast<size_t>(state.range(0));
+		math::TransformStreams streams = RandomStreams(count);
+		std::vector<math::Transform> transforms(count);
+		for (size_t i = 0; i < count; ++i) {
+			transforms[i] = streams.Get(i);
+		}
+		math::Matrix4x4 viewProjection = MakeViewProjection();
+		std::vector<TransformationMatrix> data(count);
+
+		for (auto _ : state) {
+			for (size_t i = 0; i < count; ++i) {
+				const math::Transform &transform = transforms[i];
+				math::Matrix4x4 world = math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+				data[i].World = world;
+				data[i].WVP = math::Multiply(world, viewProjection);
+			}
+			benchmark::DoNotOptimize(data.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+
+	// まとめて作る（threadsが0ならスレッドプールを使わない）
+	void BM_Batched(benchmark::State &state)
+	{
+		size_t count = static_cast<size_t>(state.range(0));
+		uint32_t threads = static_cast<uint32_t>(state.range(1));
+		math::TransformStreams streams = RandomStreams(count);
+		math::Matrix4x4 viewProjection = MakeViewProjection();
+		std::vector<TransformationMatrix> data(count);
+		std::unique_ptr<ThreadPool> threadPool = threads ? std::make_unique<ThreadPool>(threads) : nullptr;
+
+		for (auto _ : state) {
+			math::MakeWorldViewProjectionMatrices(streams, viewProjection, &data[0].World, &data[0].WVP,
+				sizeof(TransformationMatrix), threadPool.get());
+			benchmark::DoNotOptimize(data.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetItemsProcessed(state.iterations() * count);
+	}
+}
+
+BENCHMARK(BM_PerObject)->ArgName("objects")->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_Batched)->ArgNames({ "objects", "threads" })
+	->Args({ 1000, 0 })->Args({ 10000, 0 })->Args({ 100000, 0 })
+	->Args({ 100000, 4 })->Unit(benchmark::kMicrosecond)->UseRealTime();
\ No newline at end of file
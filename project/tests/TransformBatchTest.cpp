@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "TransformBatch.h"
+#include "MathFunctions.h"
+#include "ThreadPool.h"
+
+// まとめて作った行列を、オブジェクトごとにMakeAffineMatrix・Multiplyを呼んだ結果と比べる
+// SinCosの近似（2e-7程度）があるので一致ではなく、行列の最大要素に対する相対誤差で比べる
+namespace {
+
+	math::TransformStreams RandomStreams(size_t count, uint32_t seed, float maxAngle = 6.3f)
+	{
+		std::mt19937 random(seed);
+		std::uniform_real_distribution<float> scale(0.1f, 10.0f);
+		std::uniform_real_distribution<float> angle(-maxAngle, maxAngle);
+		std::uniform_real_distribution<float> position(-1000.0f, 1000.0f);
+		math::TransformStreams streams;
+		for (size_t i = 0; i < count; ++i) {
+			streams.PushBack({
+				{ scale(random), scale(random), scale(random) },
+				{ angle(random), angle(random), angle(random) },
+				{ position(random), position(random), position(random) },
+				});
+		}
+		return streams;
+	}
+
+	math::Matrix4x4 MakeWorld(const math::TransformStreams &streams, size_t index)
+	{
+		math::Transform transform = streams.Get(index);
+		return math::MakeAffineMatrix(transform.scale, transform.rotate, transform.translate);
+	}
+
+	// 透視投影のカメラ（ビュー行列×射影行列）
+	math::Matrix4x4 MakeViewProjection()
+	{
+		math::Matrix4x4 camera = math::MakeAffineMatrix({ 1.0f, 1.0f, 1.0f }, { 0.3f, -0.7f, 0.0f }, { 10.0f, 50.0f, -200.0f });
+		return math::Multiply(math::Inverse(camera), math::MakePerspectiveFovMatrix(0.45f, 16.0f / 9.0f, 0.1f, 5000.0f));
+	}
+
+	void ExpectNearRelative(const math::Matrix4x4 &actual, const math::Matrix4x4 &expected, float relativeTolerance, size_t index)
+	{
+		float maxAbs = 1.0f;
+		for (const auto &row : expected.m) {
+			for (float value : row) {
+				maxAbs = (std::max)(maxAbs, std::abs(value));
+			}
+		}
+		for (int row = 0; row < 4; ++row) {
+			for (int col = 0; col < 4; ++col) {
+				ASSERT_NEAR(actual.m[row][col], expected.m[row][col], relativeTolerance * maxAbs)
+					<< "object " << index << " m[" << row << "][" << col << "]";
+			}
+		}
+	}
+
+	// 構造体の配列のメンバへ直接書くとき（定数バッファの形）
+	struct TransformationMatrix
+	{
+		math::Matrix4x4 WVP;
+		math::Matrix4x4 World;
+	};
+}
+
+TEST(TransformBatch, ResizeFillsIdentityTransform)
+{
+	math::TransformStreams streams;
+	streams.Resize(3);
+	ASSERT_EQ(streams.GetCount(), 3u);
+	for (size_t i = 0; i < streams.GetCount(); ++i) {
+		math::Transform transform = streams.Get(i);
+		EXPECT_EQ(transform.scale.x, 1.0f);
+		EXPECT_EQ(transform.scale.y, 1.0f);
+		EXPECT_EQ(transform.scale.z, 1.0f);
+		EXPECT_EQ(transform.rotate.x, 0.0f);
+		EXPECT_EQ(transform.rotate.y, 0.0f);
+		EXPECT_EQ(transform.rotate.z, 0.0f);
+		EXPECT_EQ(transform.translate.x, 0.0f);
+		EXPECT_EQ(transform.translate.y, 0.0f);
+		EXPECT_EQ(transform.translate.z, 0.0f);
+	}
+}
+
+TEST(TransformBatch, SetAndGetRoundTrip)
+{
+	math::TransformStreams streams;
+	streams.Resize(2);
+	math::Transform transform { { 2.0f, 3.0f, 4.0f }, { 0.1f, 0.2f, 0.3f }, { 5.0f, 6.0f, 7.0f } };
+	streams.Set(1, transform);
+	math::Transform result = streams.Get(1);
+	EXPECT_EQ(std::memcmp(&result, &transform, sizeof(transform)), 0);
+	EXPECT_EQ(streams.Get(0).scale.x, 1.0f);
+}
+
+TEST(TransformBatch, WorldMatricesMatchPerObjectPath)
+{
+	// 4の倍数でない数も試す（端数のレーンの扱い）
+	for (size_t count : { 1u, 3u, 4u, 5u, 1023u, 2049u }) {
+		math::TransformStreams streams = RandomStreams(count, static_cast<uint32_t>(count));
+		std::vector<math::Matrix4x4> world(count);
+		math::MakeAffineMatrices(streams, world.data());
+		for (size_t i = 0; i < count; ++i) {
+			ExpectNearRelative(world[i], MakeWorld(streams, i), 1e-5f, i);
+		}
+	}
+}
+
+TEST(TransformBatch, WorldMatricesMatchForLargeAngles)
+{
+	// 何周もした角度でも範囲の折り返しで精度が落ちない
+	const size_t count = 1000;
+	math::TransformStreams streams = RandomStreams(count, 7, 100.0f);
+	std::vector<math::Matrix4x4> world(count);
+	math::MakeAffineMatrices(streams, world.data());
+	for (size_t i = 0; i < count; ++i) {
+		ExpectNearRelative(world[i], MakeWorld(streams, i), 2e-5f, i);
+	}
+}
+
+TEST(TransformBatch, WorldViewProjectionMatchesPerObjectPath)
+{
+	const size_t count = 1001;
+	math::TransformStreams streams = RandomStreams(count, 11);
+	math::Matrix4x4 viewProjection = MakeViewProjection();
+	std::vector<math::Matrix4x4> world(count);
+	std::vector<math::Matrix4x4> wvp(count);
+	math::MakeWorldViewProjectionMatrices(streams, viewProjection, world.data(), wvp.data());
+	for (size_t i = 0; i < count; ++i) {
+		math::Matrix4x4 expectedWorld = MakeWorld(streams, i);
+		ExpectNearRelative(world[i], expectedWorld, 1e-5f, i);
+		ExpectNearRelative(wvp[i], math::Multiply(expectedWorld, viewProjection), 1e-5f, i);
+	}
+}
+
+TEST(TransformBatch, StrideWritesIntoStructMembers)
+{
+	const size_t count = 7;
+	math::TransformStreams streams = RandomStreams(count, 3);
+	math::Matrix4x4 viewProjection = MakeViewProjection();
+
+	// 配列の外に書いていないか確かめるため、1つ多く確保して番兵にする
+	TransformationMatrix sentinel {};
+	std::memset(&sentinel, 0xCD, sizeof(sentinel));
+	std::vector<TransformationMatrix> data(count + 1, sentinel);
+	math::MakeWorldViewProjectionMatrices(streams, viewProjection, &data[0].World, &data[0].WVP, sizeof(TransformationMatrix));
+
+	for (size_t i = 0; i < count; ++i) {
+		math::Matrix4x4 expectedWorld = MakeWorld(streams, i);
+		ExpectNearRelative(data[i].World, expectedWorld, 1e-5f, i);
+		ExpectNearRelative(data[i].WVP, math::Multiply(expectedWorld, viewProjection), 1e-5f, i);
+	}
+	EXPECT_EQ(std::memcmp(&data[count], &sentinel, sizeof(sentinel)), 0);
+}
+
+TEST(TransformBatch, EmptyStreamsWriteNothing)
+{
+	math::TransformStreams streams;
+	math::MakeAffineMatrices(streams, nullptr);
+	ThreadPool threadPool(2);
+	math::MakeWorldViewProjectionMatrices(streams, MakeViewProjection(), nullptr, nullptr, sizeof(math::Matrix4x4), &threadPool);
+}
+
+TEST(TransformBatch, ThreadPoolResultIsIdenticalToSerial)
+{
+	// チャンクの境界をまたぐ数
+	const size_t count = math::kTransformBatchChunkSize * 5 + 3;
+	math::TransformStreams streams = RandomStreams(count, 5);
+	math::Matrix4x4 viewProjection = MakeViewProjection();
+
+	std::vector<math::Matrix4x4> serialWorld(count);
+	std::vector<math::Matrix4x4> serialWvp(count);
+	math::MakeWorldViewProjectionMatrices(streams, viewProjection, serialWorld.data(), serialWvp.data());
+
+	ThreadPool threadPool(4);
+	std::vector<math::Matrix4x4> parallelWorld(count);
+	std::vector<math::Matrix4x4> parallelWvp(count);
+	math::MakeWorldViewProjectionMatrices(streams, viewProjection, parallelWorld.data(), parallelWvp.data(),
+		sizeof(math::Matrix4x4), &threadPool);
+
+	EXPECT_EQ(std::memcmp(serialWorld.data(), parallelWorld.data(), sizeof(math::Matrix4x4) * count), 0);
+	EXPECT_EQ(std::memcmp(serialWvp.data(), parallelWvp.data(), sizeof(math::Matrix4x4) * count), 0);
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include "VertexQuantization.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+// 頂点の量子化: 量子化にかかる時間と、モデルごとの頂点バッファのサイズ（36byte→16byte）と誤差を報告する
+// pos_err_%はAABBの大きさに対する最大の位置誤差、normal_err_degは法線の最大の角度誤差
+namespace {
+
+	// 格子の大きさ（256x256で約6.6万頂点）
+	constexpr uint32_t kGridSize = 256;
+
+	void ReportQuantization(benchmark::State &state, const std::vector<Model::VertexData> &vertices,
+		const std::vector<Model::QuantizedVertexData> &quantized, const Model::VertexDecode &decode)
+	{
+		double maxPositionError = 0.0;
+		double maxNormalError = 0.0;
+		double maxTexcoordError = 0.0;
+		double extent = (std::max)({ decode.positionScale.x, decode.positionScale.y, decode.positionScale.z, 1.0e-6f });
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			Model::VertexData decoded = VertexQuantization::Decode(quantized[i], decode);
+			const Model::VertexData &vertex = vertices[i];
+			maxPositionError = (std::max)({ maxPositionError,
+				std::abs(double(decoded.position.x) - vertex.position.x),
+				std::abs(double(decoded.position.y) - vertex.position.y),
+				std::abs(double(decoded.position.z) - vertex.position.z) });
+			maxTexcoordError = (std::max)({ maxTexcoordError,
+				std::abs(double(decoded.texcoord.x) - vertex.texcoord.x),
+				std::abs(double(decoded.texcoord.y) - vertex.texcoord.y) });
+			double dot = double(decoded.normal.x) * vertex.normal.x + double(decoded.normal.y) * vertex.normal.y + double(decoded.normal.z) * vertex.normal.z;
+			double length = std::sqrt(double(vertex.normal.x) * vertex.normal.x + double(vertex.normal.y) * vertex.normal.y + double(vertex.normal.z) * vertex.normal.z);
+			if (length > 0.0) {
+				maxNormalError = (std::max)(maxNormalError, std::acos((std::min)(dot / length, 1.0)) * 180.0 / 3.14159265358979);
+			}
+		}
+		double fullBytes = static_cast<double>(vertices.size() * sizeof(Model::VertexData));
+		double quantizedBytes = static_cast<double>(vertices.size() * sizeof(Model::QuantizedVertexData));
+		state.counters["vertices"] = static_cast<double>(vertices.size());
+		state.counters["full_KB"] = fullBytes / 1024.0;
+		state.counters["quantized_KB"] = quantizedBytes / 1024.0;
+		state.counters["saved_%"] = fullBytes > 0.0 ? (1.0 - quantizedBytes / fullBytes) * 100.0 : 0.0;
+		state.counters["pos_err_%"] = maxPositionError / extent * 100.0;
+		state.counters["uv_err"] = maxTexcoordError;
+		state.counters["normal_err_deg"] = maxNormalError;
+	}
+
+	void BM_QuantizeVertices(benchmark::State &state, const std::vector<Model::VertexData> *vertices)
+	{
+		Model::VertexDecode decode {};
+		std::vector<Model::QuantizedVertexData> quantized;
+		for (auto _ : state) {
+			quantized = VertexQuantization::EncodeVertices(*vertices, decode);
+			benchmark::DoNotOptimize(quantized.data());
+		}
+		state.counters["vertices/s"] = benchmark::Counter(static_cast<double>(vertices->size()), benchmark::Counter::kIsIterationInvariantRate);
+		ReportQuantization(state, *vertices, quantized, decode);
+	}
+
+	const bool kRegistered = [] {
+		static std::vector<std::pair<std::string, std::vector<Model::VertexData>>> models;
+		for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+			models.emplace_back(file.filename, ObjLoader::Load(file.directoryPath, file.filename, 1).vertices);
+		}
+		std::string grid = TestSupport::MakeGridObj(kGridSize, kGridSize);
+		models.emplace_back("grid" + std::to_string(kGridSize), ObjLoader::Parse(grid.data(), grid.data() + grid.size(), ".", 1).vertices);
+		for (const auto &[name, vertices] : models) {
+			benchmark::RegisterBenchmark(("BM_QuantizeVertices/" + name).c_str(), BM_QuantizeVertices, &vertices)->Unit(benchmark::kMicrosecond);
+		}
+		return true;
+		}();
+}
\ No newline at end of file
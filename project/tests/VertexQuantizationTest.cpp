@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include "VertexQuantization.h"
+#include "ObjLoader.h"
+#include "TestSupport.h"
+
+namespace {
+
+	// 16bitの八面体エンコードの角度誤差の上限（ラジアン）
+	// 格子の間隔は2/32767で、球面上に戻すと最大でもその数倍に収まる
+	constexpr float kMaxNormalAngle = 1.0e-4f;
+
+	// 小さな角度はacosでは桁落ちするので、外積の長さと内積から求める
+	float AngleBetween(const math::Vector3 &lhs, const math::Vector3 &rhs)
+	{
+		double cross[3] = {
+			double(lhs.y) * rhs.z - double(lhs.z) * rhs.y,
+			double(lhs.z) * rhs.x - double(lhs.x) * rhs.z,
+			double(lhs.x) * rhs.y - double(lhs.y) * rhs.x };
+		double dot = double(lhs.x) * rhs.x + double(lhs.y) * rhs.y + double(lhs.z) * rhs.z;
+		return static_cast<float>(std::atan2(std::sqrt(cross[0] * cross[0] + cross[1] * cross[1] + cross[2] * cross[2]), dot));
+	}
+
+	math::Vector3 RandomUnitVector(std::mt19937 &random)
+	{
+		std::normal_distribution<float> distribution;
+		math::Vector3 v;
+		float length = 0.0f;
+		do {
+			v = { distribution(random), distribution(random), distribution(random) };
+			length = std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z);
+		} while (length < 1.0e-3f);
+		return { v.x / length, v.y / length, v.z / length };
+	}
+
+	// 量子化した頂点を展開したときの誤差が上限に収まるか調べる
+	void ExpectWithinErrorBounds(const std::vector<Model::VertexData> &vertices)
+	{
+		Model::VertexDecode decode {};
+		std::vector<Model::QuantizedVertexData> quantized = VertexQuantization::EncodeVertices(vertices, decode);
+		ASSERT_EQ(quantized.size(), vertices.size());
+
+		// 位置はAABBを65535等分した間隔の半分（と、floatの計算誤差）まで
+		const float scale[3] = { decode.positionScale.x, decode.positionScale.y, decode.positionScale.z };
+		const float offset[3] = { decode.positionOffset.x, decode.positionOffset.y, decode.positionOffset.z };
+		for (size_t i = 0; i < vertices.size(); ++i) {
+			Model::VertexData decoded = VertexQuantization::Decode(quantized[i], decode);
+			const float original[3] = { vertices[i].position.x, vertices[i].position.y, vertices[i].position.z };
+			const float restored[3] = { decoded.position.x, decoded.position.y, decoded.position.z };
+			for (uint32_t axis = 0; axis < 3; ++axis) {
+				float bound = scale[axis] / 65535.0f * 0.5f + (std::abs(offset[axis]) + scale[axis]) * 4.0f * std::numeric_limits<float>::epsilon();
+				ASSERT_LE(std::abs(restored[axis] - original[axis]), bound) << "vertex " << i << " axis " << axis;
+			}
+			EXPECT_EQ(decoded.position.w, 1.0f);
+
+			// UVは半精度の丸め（相対2^-11）まで
+			EXPECT_LE(std::abs(decoded.texcoord.x - vertices[i].texcoord.x), std::abs(vertices[i].texcoord.x) * 0x1.0p-11f + 0x1.0p-25f) << "vertex " << i;
+			EXPECT_LE(std::abs(decoded.texcoord.y - vertices[i].texcoord.y), std::abs(vertices[i].texcoord.y) * 0x1.0p-11f + 0x1.0p-25f) << "vertex " << i;
+
+			// 法線は正規化されたものだけ比べる（objの法線は概ね単位長だが念のため）
+			const math::Vector3 &normal = vertices[i].normal;
+			float length = std::sqrt(normal.x * normal.x + normal.y * normal.y + normal.z * normal.z);
+			if (length > 0.0f) {
+				math::Vector3 unit = { normal.x / length, normal.y / length, normal.z / length };
+				EXPECT_LE(AngleBetween(decoded.normal, unit), kMaxNormalAngle) << "vertex " << i;
+			}
+		}
+	}
+}
+
+// シェーダーの入力レイアウトと合わせて16byte
+TEST(VertexQuantization, QuantizedVertexIs16Bytes)
+{
+	EXPECT_EQ(sizeof(Model::QuantizedVertexData), 16u);
+}
+
+// NaN以外のすべての半精度の値は、floatを経由しても同じ値に戻る
+TEST(VertexQuantization, HalfRoundTripsEveryValue)
+{
+	for (uint32_t bits = 0; bits <= 0xFFFFu; ++bits) {
+		uint16_t half = static_cast<uint16_t>(bits);
+		bool isNaN = (half & 0x7C00u) == 0x7C00u && (half & 0x3FFu) != 0;
+		if (isNaN) {
+			EXPECT_TRUE(std::isnan(VertexQuantization::HalfToFloat(half))) << std::hex << bits;
+			continue;
+		}
+		ASSERT_EQ(VertexQuantization::FloatToHalf(VertexQuantization::HalfToFloat(half)), half) << std::hex << bits;
+	}
+}
+
+// floatから半精度への変換は最近接偶数丸めで、範囲外は無限大になる
+TEST(VertexQuantization, FloatToHalfRoundsToNearestEven)
+{
+	EXPECT_EQ(VertexQuantization::FloatToHalf(0.0f), 0x0000u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(-0.0f), 0x8000u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(1.0f), 0x3C00u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(-2.0f), 0xC000u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(65504.0f), 0x7BFFu);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(70000.0f), 0x7C00u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(std::numeric_limits<float>::infinity()), 0x7C00u);
+	// 最小の非正規化数
+	EXPECT_EQ(VertexQuantization::FloatToHalf(0x1.0p-24f), 0x0001u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(0x1.0p-26f), 0x0000u);
+	// 1と次の値(1+2^-10)のちょうど中間は偶数側（1）へ、少しでも超えたら次の値へ
+	EXPECT_EQ(VertexQuantization::FloatToHalf(1.0f + 0x1.0p-11f), 0x3C00u);
+	EXPECT_EQ(VertexQuantization::FloatToHalf(1.0f + 0x1.0p-11f + 0x1.0p-20f), 0x3C01u);
+	// 1+2^-10と1+2^-9の中間は偶数側（1+2^-9）へ
+	EXPECT_EQ(VertexQuantization::FloatToHalf(1.0f + 0x1.0p-10f + 0x1.0p-11f), 0x3C02u);
+}
+
+// 八面体エンコードの誤差はどの向きでも上限に収まる（軸方向と下半球の折り返しを含む）
+TEST(VertexQuantization, OctahedralNormalErrorIsBounded)
+{
+	std::vector<math::Vector3> normals = {
+		{ 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+		{ 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f },
+	};
+	std::mt19937 random(42);
+	for (uint32_t i = 0; i < 100000; ++i) {
+		normals.push_back(RandomUnitVector(random));
+	}
+
+	std::vector<Model::VertexData> vertices(normals.size());
+	for (size_t i = 0; i < normals.size(); ++i) {
+		vertices[i].position = { 0.0f, 0.0f, 0.0f, 1.0f };
+		vertices[i].normal = normals[i];
+	}
+	ExpectWithinErrorBounds(vertices);
+}
+
+// 位置はAABBの中で量子化され、AABBの角は正確に戻る
+TEST(VertexQuantization, PositionErrorIsBoundedByAabbStep)
+{
+	std::mt19937 random(7);
+	std::uniform_real_distribution<float> distribution(-250.0f, 1000.0f);
+	std::vector<Model::VertexData> vertices(20000);
+	for (Model::VertexData &vertex : vertices) {
+		vertex.position = { distribution(random), distribution(random) * 0.01f, distribution(random) + 5000.0f, 1.0f };
+		vertex.texcoord = { distribution(random) / 1000.0f, distribution(random) / 250.0f };
+		vertex.normal = RandomUnitVector(random);
+	}
+	ExpectWithinErrorBounds(vertices);
+
+	Model::VertexDecode decode = VertexQuantization::ComputeVertexDecode(vertices);
+	Model::VertexData corner = vertices[0];
+	corner.position = { decode.positionOffset.x, decode.positionOffset.y, decode.positionOffset.z, 1.0f };
+	Model::QuantizedVertexData quantized = VertexQuantization::Encode(corner, decode);
+	EXPECT_EQ(quantized.position[0], 0u);
+	EXPECT_EQ(quantized.position[1], 0u);
+	EXPECT_EQ(quantized.position[2], 0u);
+	EXPECT_EQ(quantized.position[3], UINT16_MAX);
+}
+
+// 平面のように厚みの無い軸があっても0除算にならず、その軸は正確に戻る
+TEST(VertexQuantization, FlatAxisIsExact)
+{
+	std::vector<Model::VertexData> vertices(3);
+	vertices[0].position = { 0.0f, 2.5f, 0.0f, 1.0f };
+	vertices[1].position = { 1.0f, 2.5f, 0.0f, 1.0f };
+	vertices[2].position = { 0.0f, 2.5f, 1.0f, 1.0f };
+	Model::VertexDecode decode {};
+	std::vector<Model::QuantizedVertexData> quantized = VertexQuantization::EncodeVertices(vertices, decode);
+	EXPECT_EQ(decode.positionScale.y, 0.0f);
+	for (size_t i = 0; i < vertices.size(); ++i) {
+		EXPECT_EQ(VertexQuantization::Decode(quantized[i], decode).position.y, 2.5f);
+	}
+}
+
+// 同梱のモデルもすべて上限に収まる
+TEST(VertexQuantization, BundledModelsAreWithinErrorBounds)
+{
+	for (const TestSupport::ModelFile &file : TestSupport::FindBundledModels()) {
+		SCOPED_TRACE(file.filename);
+		ExpectWithinErrorBounds(ObjLoader::Load(file.directoryPath, file.filename, 1).vertices);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include "FrameScheduler.h"
+
+// テスト用: 仮想時間で動く偽のGPU
+// Signalされたフレームを順に1つずつ、gpuFrameTimeずつかけて処理する（実際には待たない）
+class FakeFrameFence : public FrameFence
+{
+public:
+
+	explicit FakeFrameFence(double gpuFrameTime) : gpuFrameTime(gpuFrameTime) {}
+
+	void Signal(uint64_t value) override
+	{
+		double start = (std::max)(now, gpuFreeTime);
+		gpuFreeTime = start + gpuFrameTime;
+		queue.push_back({ value, gpuFreeTime });
+		++signalCount;
+	}
+
+	uint64_t GetCompletedValue() override
+	{
+		Advance();
+		return completedValue;
+	}
+
+	void Wait(uint64_t value) override
+	{
+		++waitCount;
+		Advance();
+		while (completedValue < value && !queue.empty()) {
+			waitedTime += queue.front().second - now;
+			now = queue.front().second;
+			Advance();
+		}
+	}
+
+	// CPUの処理で時間を進める
+	void Elapse(double time) { now += time; }
+
+	double GetNow() const { return now; }
+	double GetWaitedTime() const { return waitedTime; }
+	uint32_t GetWaitCount() const { return waitCount; }
+	uint32_t GetSignalCount() const { return signalCount; }
+
+private:
+
+	// 今の時刻までに終わったフレームを完了にする
+	void Advance()
+	{
+		while (!queue.empty() && queue.front().second <= now) {
+			completedValue = queue.front().first;
+			queue.pop_front();
+		}
+	}
+
+	double gpuFrameTime;
+	double now = 0.0;
+	double gpuFreeTime = 0.0;
+	double waitedTime = 0.0;
+	uint32_t waitCount = 0;
+	uint32_t signalCount = 0;
+	uint64_t completedValue = 0;
+	std::deque<std::pair<uint64_t, double>> queue; // Signalされた値と終わる時刻
+};
\ No newline at end of file
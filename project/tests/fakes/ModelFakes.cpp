@@ -0,0 +1,70 @@
+#include "ModelFakes.h"
+#include "ModelCommon.h"
+#include "ObjLoader.h"
+
+namespace {
+
+	std::mutex callsMutex;
+	ModelFakes::Calls calls;
+}
+
+namespace ModelFakes {
+
+	void Reset()
+	{
+		std::lock_guard<std::mutex> lock(callsMutex);
+		calls = Calls {};
+	}
+
+	Calls GetCalls()
+	{
+		std::lock_guard<std::mutex> lock(callsMutex);
+		return calls;
+	}
+}
+
+// ===== ModelCommon =====
+void ModelCommon::Initialize(DirectXCommon *dxCommon)
+{
+	dxCommon_ = dxCommon;
+}
+
+// ===== Model =====
+// GPUリソースは作らず、モデルデータを持って描画できる状態にだけする
+void Model::Initialize(ModelCommon *modelCommon, ModelData modelData, bool quantizeVertices)
+{
+	{
+		std::lock_guard<std::mutex> lock(callsMutex);
+		calls.initializeThreads.push_back(std::this_thread::get_id());
+		calls.initializeOrder.push_back(this);
+	}
+	modelCommon_ = modelCommon;
+	modelData_ = std::move(modelData);
+	quantized_ = quantizeVertices;
+	ready_ = true;
+}
+
+Model::ModelData Model::LoadObjFile(const std::string &directoryPath, const std::string &filename)
+{
+	{
+		std::lock_guard<std::mutex> lock(callsMutex);
+		calls.loadObjFileThreads.push_back(std::this_thread::get_id());
+	}
+	return ObjLoader::Load(directoryPath, filename);
+}
+
+MeshBVH Model::BuildTriangleBVH(const ModelData &modelData)
+{
+	{
+		std::lock_guard<std::mutex> lock(callsMutex);
+		calls.buildTriangleBVHThreads.push_back(std::this_thread::get_id());
+	}
+	std::vector<math::Vector3> positions;
+	positions.reserve(modelData.vertices.size());
+	for (const VertexData &vertex : modelData.vertices) {
+		positions.push_back({ vertex.position.x, vertex.position.y, vertex.position.z });
+	}
+	MeshBVH triangleBVH;
+	triangleBVH.Build(positions, modelData.indices);
+	return triangleBVH;
+}
\ No newline at end of file
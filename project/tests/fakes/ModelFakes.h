@@ -0,0 +1,25 @@
+#pragma once
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Model.h"
+
+// テスト用: GPUを使うModel/ModelCommonの関数の代わり（リンク時に本物と入れ替える）
+// ModelManagerのテストで、どのスレッドで何が呼ばれたかを記録する
+namespace ModelFakes
+{
+	// 呼び出しの記録
+	struct Calls
+	{
+		std::vector<std::thread::id> loadObjFileThreads; // Model::LoadObjFile（objの解析）を呼んだスレッド
+		std::vector<std::thread::id> buildTriangleBVHThreads; // Model::BuildTriangleBVHを呼んだスレッド
+		std::vector<std::thread::id> initializeThreads; // Model::Initialize（GPUリソースの作成）を呼んだスレッド
+		std::vector<const Model *> initializeOrder; // Model::Initializeされた順
+	};
+
+	// 記録を消す
+	void Reset();
+
+	// 記録のコピーを取る（ワーカースレッドが書き込み中でも安全に読めるように）
+	Calls GetCalls();
+}
\ No newline at end of file
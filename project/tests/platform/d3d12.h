@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+// テスト用: Linuxで<d3d12.h>の代わりに読み込まれる
+// GPUのリソースをメンバに持つヘッダー（Model.hなど）をコンパイルするためだけの宣言で、GPUの処理はテストしない
+struct ID3D12Resource;
+
+using D3D12_GPU_VIRTUAL_ADDRESS = uint64_t;
+
+enum DXGI_FORMAT : uint32_t
+{
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R32_UINT = 42,
+	DXGI_FORMAT_R16_UINT = 57,
+};
+
+struct D3D12_VERTEX_BUFFER_VIEW
+{
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	uint32_t SizeInBytes;
+	uint32_t StrideInBytes;
+};
+
+struct D3D12_INDEX_BUFFER_VIEW
+{
+	D3D12_GPU_VIRTUAL_ADDRESS BufferLocation;
+	uint32_t SizeInBytes;
+	DXGI_FORMAT Format;
+};
\ No newline at end of file
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+// テスト用: Linuxで<wrl.h>の代わりに読み込まれる
+// GPUのリソースをメンバに持つヘッダー（Model.hなど）をコンパイルするためだけの宣言で、参照カウントは持たない
+namespace Microsoft::WRL
+{
+	template <class T>
+	class ComPtr
+	{
+	public:
+		ComPtr() = default;
+		ComPtr(std::nullptr_t) {}
+
+		T *Get() const { return ptr_; }
+		T *operator->() const { return ptr_; }
+		explicit operator bool() const { return ptr_ != nullptr; }
+
+	private:
+		T *ptr_ = nullptr;
+	};
+}
\ No newline at end of file